@@ -33,6 +33,45 @@
 #include "core/math/geometry_3d.h"
 #include "core/object/script_language.h"
 
+void AStarSearchState::begin(uint32_t p_point_count) {
+	if (prev_point.size() != p_point_count) {
+		// The passes of the new points must be older than the current pass.
+		prev_point.resize(p_point_count);
+		g_score.resize(p_point_count);
+		open_pass.resize(p_point_count);
+		closed_pass.resize(p_point_count);
+		for (uint32_t i = 0; i < p_point_count; i++) {
+			open_pass[i] = 0;
+			closed_pass[i] = 0;
+		}
+	}
+	open_list.clear();
+	pass++;
+}
+
+AStarSearchState *AStarSearchStatePool::acquire() {
+	MutexLock lock(mutex);
+	if (free_states.is_empty()) {
+		return memnew(AStarSearchState);
+	}
+	AStarSearchState *state = free_states[free_states.size() - 1];
+	free_states.resize(free_states.size() - 1);
+	return state;
+}
+
+void AStarSearchStatePool::release(AStarSearchState *p_state) {
+	MutexLock lock(mutex);
+	free_states.push_back(p_state);
+}
+
+AStarSearchStatePool::~AStarSearchStatePool() {
+	for (uint32_t i = 0; i < free_states.size(); i++) {
+		memdelete(free_states[i]);
+	}
+}
+
+/////////////////////////////////////////////////////////////
+
 int AStar::get_available_point_id() const {
 	if (points.has(last_free_id)) {
 		int cur_new_id = last_free_id + 1;
@@ -57,14 +96,32 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
 		pt->enabled = true;
 		points.set(p_id, pt);
+		compact_dirty = true;
 	} else {
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
+		if (!compact_dirty) {
+			compact_weight_scales[found_pt->index] = p_weight_scale;
+		}
+	}
+}
+
+void AStar::add_points(const PackedInt32Array &p_ids, const PackedVector3Array &p_positions, const PackedFloat32Array &p_weight_scales) {
+	ERR_FAIL_COND_MSG(p_ids.size() != p_positions.size(), vformat("Can't add points. There are %d ids for %d positions.", p_ids.size(), p_positions.size()));
+	ERR_FAIL_COND_MSG(!p_weight_scales.is_empty() && p_weight_scales.size() != p_ids.size(), vformat("Can't add points. There are %d ids for %d weight scales.", p_ids.size(), p_weight_scales.size()));
+
+	const uint32_t count = points.get_num_elements() + p_ids.size();
+	if (count > points.get_capacity()) {
+		points.reserve(count);
+	}
+
+	const int *ids = p_ids.ptr();
+	const Vector3 *positions = p_positions.ptr();
+	const float *weight_scales = p_weight_scales.ptr();
+	for (int i = 0; i < p_ids.size(); i++) {
+		add_point(ids[i], positions[i], weight_scales ? weight_scales[i] : 1.0);
 	}
 }
 
@@ -99,6 +156,9 @@ void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(p_weight_scale < 1, vformat("Can't set point's weight scale less than one: %f.", p_weight_scale));
 
 	p->weight_scale = p_weight_scale;
+	if (!compact_dirty) {
+		compact_weight_scales[p->index] = p_weight_scale;
+	}
 }
 
 void AStar::remove_point(int p_id) {
@@ -125,6 +185,7 @@ void AStar::remove_point(int p_id) {
 	memdelete(p);
 	points.remove(p_id);
 	last_free_id = p_id;
+	compact_dirty = true;
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
@@ -163,6 +224,16 @@ void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 	}
 
 	segments.insert(s);
+	compact_dirty = true;
+}
+
+void AStar::connect_point_pairs(const PackedInt32Array &p_pairs, bool p_bidirectional) {
+	ERR_FAIL_COND_MSG(p_pairs.size() % 2 != 0, vformat("Can't connect points. The pairs array has an odd size: %d.", p_pairs.size()));
+
+	const int *pairs = p_pairs.ptr();
+	for (int i = 0; i < p_pairs.size(); i += 2) {
+		connect_points(pairs[i], pairs[i + 1], p_bidirectional);
+	}
 }
 
 void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
@@ -202,6 +273,7 @@ void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
 		if (s.direction != Segment::NONE) {
 			segments.insert(s);
 		}
+		compact_dirty = true;
 	}
 }
 
@@ -248,6 +320,7 @@ void AStar::clear() {
 	}
 	segments.clear();
 	points.clear();
+	compact_dirty = true;
 }
 
 int AStar::get_point_count() const {
@@ -318,65 +391,128 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar::_solve(Point *begin_point, Point *end_point) {
-	pass++;
+void AStar::_update_compact() {
+	MutexLock lock(compact_mutex);
+	if (!compact_dirty) {
+		return;
+	}
 
-	if (!end_point->enabled) {
+	const uint32_t point_count = points.get_num_elements();
+	compact_points.resize(point_count);
+	compact_ids.resize(point_count);
+	compact_weight_scales.resize(point_count);
+	compact_enabled.resize(point_count);
+	compact_offsets.resize(point_count + 1);
+	compact_neighbours.clear();
+
+	uint32_t index = 0;
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		Point *p = *(it.value);
+		p->index = index;
+		compact_points[index] = p;
+		compact_ids[index] = p->id;
+		compact_weight_scales[index] = p->weight_scale;
+		compact_enabled[index] = p->enabled;
+		index++;
+	}
+
+	for (uint32_t i = 0; i < point_count; i++) {
+		compact_offsets[i] = compact_neighbours.size();
+		const Point *p = compact_points[i];
+		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
+			compact_neighbours.push_back((*it.value)->index);
+		}
+	}
+	compact_offsets[point_count] = compact_neighbours.size();
+
+	compact_dirty = false;
+}
+
+template <class T>
+bool AStar::_solve(T *p_cost_owner, AStarSearchState &r_state, uint32_t p_begin, uint32_t p_end) const {
+	if (!compact_enabled[p_end]) {
 		return false;
 	}
 
-	bool found_route = false;
+	r_state.begin(compact_ids.size());
+	const uint64_t pass = r_state.pass;
+	const int end_id = compact_ids[p_end];
 
-	Vector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	LocalVector<AStarSearchState::OpenPoint> &open_list = r_state.open_list;
+	SortArray<AStarSearchState::OpenPoint, AStarSearchState::SortOpenPoints> sorter;
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
+	AStarSearchState::OpenPoint begin_point;
+	begin_point.index = p_begin;
+	begin_point.f_score = p_cost_owner->_estimate_cost(compact_ids[p_begin], end_id);
+	r_state.g_score[p_begin] = 0;
+	r_state.open_pass[p_begin] = pass;
 	open_list.push_back(begin_point);
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point
+		const uint32_t p = open_list[0].index; // The currently processed point
 
-		if (p == end_point) {
-			found_route = true;
-			break;
+		if (p == p_end) {
+			return true;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed
+		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list
+		open_list.resize(open_list.size() - 1);
 
-		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
-			Point *e = *(it.value); // The neighbour point
+		if (r_state.closed_pass[p] == pass) {
+			continue; // Outdated entry, the point was reached with a lower score.
+		}
+		r_state.closed_pass[p] = pass; // Mark the point as closed
+
+		const int p_id = compact_ids[p];
+		for (uint32_t i = compact_offsets[p]; i < compact_offsets[p + 1]; i++) {
+			const uint32_t e = compact_neighbours[i]; // The neighbour point
 
-			if (!e->enabled || e->closed_pass == pass) {
+			if (!compact_enabled[e] || r_state.closed_pass[e] == pass) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			const int e_id = compact_ids[e];
+			real_t tentative_g_score = r_state.g_score[p] + p_cost_owner->_compute_cost(p_id, e_id) * compact_weight_scales[e];
 
-			bool new_point = false;
-
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
-				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			if (r_state.open_pass[e] == pass && tentative_g_score >= r_state.g_score[e]) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
+			r_state.open_pass[e] = pass;
+			r_state.prev_point[e] = p;
+			r_state.g_score[e] = tentative_g_score;
+
+			// The point is pushed again instead of moved up the heap, the previous entry is skipped once closed.
+			AStarSearchState::OpenPoint open_point;
+			open_point.index = e;
+			open_point.g_score = tentative_g_score;
+			open_point.f_score = tentative_g_score + p_cost_owner->_estimate_cost(e_id, end_id);
+			open_list.push_back(open_point);
+			sorter.push_heap(0, open_list.size() - 1, 0, open_point, open_list.ptr());
+		}
+	}
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
-			}
+	return false;
+}
+
+template <class T>
+bool AStar::_find_path(T *p_cost_owner, Point *p_begin, Point *p_end, LocalVector<uint32_t> &r_path) {
+	_update_compact();
+
+	AStarSearchState *state = search_states.acquire();
+	bool found_route = _solve(p_cost_owner, *state, p_begin->index, p_end->index);
+
+	if (found_route) {
+		uint32_t p = p_end->index;
+		r_path.push_back(p);
+		while (p != p_begin->index) {
+			p = state->prev_point[p];
+			r_path.push_back(p);
 		}
+		r_path.invert();
 	}
 
+	search_states.release(state);
 	return found_route;
 }
 
@@ -429,35 +565,20 @@ Vector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	LocalVector<uint32_t> route;
+	bool found_route = _find_path(this, a, b, route);
 	if (!found_route) {
 		return Vector<Vector3>();
 	}
 
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
 	Vector<Vector3> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		Vector3 *w = path.ptrw();
-
-		Point *p2 = end_point;
-		int idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = compact_points[route[i]]->pos;
 		}
-
-		w[0] = p2->pos; // Assign first
 	}
 
 	return path;
@@ -478,35 +599,20 @@ Vector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	LocalVector<uint32_t> route;
+	bool found_route = _find_path(this, a, b, route);
 	if (!found_route) {
 		return Vector<int>();
 	}
 
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
 	Vector<int> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		int *w = path.ptrw();
-
-		p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = compact_ids[route[i]];
 		}
-
-		w[0] = p->id; // Assign first
 	}
 
 	return path;
@@ -518,6 +624,9 @@ void AStar::set_point_disabled(int p_id, bool p_disabled) {
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set if point is disabled. Point with id: %d doesn't exist.", p_id));
 
 	p->enabled = !p_disabled;
+	if (!compact_dirty) {
+		compact_enabled[p->index] = p->enabled;
+	}
 }
 
 bool AStar::is_point_disabled(int p_id) const {
@@ -531,6 +640,7 @@ bool AStar::is_point_disabled(int p_id) const {
 void AStar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar::get_available_point_id);
 	ClassDB::bind_method(D_METHOD("add_point", "id", "position", "weight_scale"), &AStar::add_point, DEFVAL(1.0));
+	ClassDB::bind_method(D_METHOD("add_points", "ids", "positions", "weight_scales"), &AStar::add_points, DEFVAL(PackedFloat32Array()));
 	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStar::get_point_position);
 	ClassDB::bind_method(D_METHOD("set_point_position", "id", "position"), &AStar::set_point_position);
 	ClassDB::bind_method(D_METHOD("get_point_weight_scale", "id"), &AStar::get_point_weight_scale);
@@ -544,6 +654,7 @@ void AStar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_point_disabled", "id"), &AStar::is_point_disabled);
 
 	ClassDB::bind_method(D_METHOD("connect_points", "id", "to_id", "bidirectional"), &AStar::connect_points, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("connect_point_pairs", "pairs", "bidirectional"), &AStar::connect_point_pairs, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("disconnect_points", "id", "to_id", "bidirectional"), &AStar::disconnect_points, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("are_points_connected", "id", "to_id", "bidirectional"), &AStar::are_points_connected, DEFVAL(true));
 
@@ -576,6 +687,17 @@ void AStar2D::add_point(int p_id, const Vector2 &p_pos, real_t p_weight_scale) {
 	astar.add_point(p_id, Vector3(p_pos.x, p_pos.y, 0), p_weight_scale);
 }
 
+void AStar2D::add_points(const PackedInt32Array &p_ids, const PackedVector2Array &p_positions, const PackedFloat32Array &p_weight_scales) {
+	PackedVector3Array positions;
+	positions.resize(p_positions.size());
+	Vector3 *w = positions.ptrw();
+	const Vector2 *r = p_positions.ptr();
+	for (int i = 0; i < p_positions.size(); i++) {
+		w[i] = Vector3(r[i].x, r[i].y, 0);
+	}
+	astar.add_points(p_ids, positions, p_weight_scales);
+}
+
 Vector2 AStar2D::get_point_position(int p_id) const {
 	Vector3 p = astar.get_point_position(p_id);
 	return Vector2(p.x, p.y);
@@ -621,6 +743,10 @@ void AStar2D::connect_points(int p_id, int p_with_id, bool p_bidirectional) {
 	astar.connect_points(p_id, p_with_id, p_bidirectional);
 }
 
+void AStar2D::connect_point_pairs(const PackedInt32Array &p_pairs, bool p_bidirectional) {
+	astar.connect_point_pairs(p_pairs, p_bidirectional);
+}
+
 void AStar2D::disconnect_points(int p_id, int p_with_id) {
 	astar.disconnect_points(p_id, p_with_id);
 }
@@ -702,35 +828,21 @@ Vector<Vector2> AStar2D::get_point_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
-	AStar::Point *begin_point = a;
-	AStar::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	LocalVector<uint32_t> route;
+	bool found_route = astar._find_path(this, a, b, route);
 	if (!found_route) {
 		return Vector<Vector2>();
 	}
 
-	AStar::Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
 	Vector<Vector2> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		Vector2 *w = path.ptrw();
-
-		AStar::Point *p2 = end_point;
-		int idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			const Vector3 &pos = astar.compact_points[route[i]]->pos;
+			w[i] = Vector2(pos.x, pos.y);
 		}
-
-		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
 	}
 
 	return path;
@@ -751,105 +863,29 @@ Vector<int> AStar2D::get_id_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
-	AStar::Point *begin_point = a;
-	AStar::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	LocalVector<uint32_t> route;
+	bool found_route = astar._find_path(this, a, b, route);
 	if (!found_route) {
 		return Vector<int>();
 	}
 
-	AStar::Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
 	Vector<int> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		int *w = path.ptrw();
-
-		p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = astar.compact_ids[route[i]];
 		}
-
-		w[0] = p->id; // Assign first
 	}
 
 	return path;
 }
 
-bool AStar2D::_solve(AStar::Point *begin_point, AStar::Point *end_point) {
-	astar.pass++;
-
-	if (!end_point->enabled) {
-		return false;
-	}
-
-	bool found_route = false;
-
-	Vector<AStar::Point *> open_list;
-	SortArray<AStar::Point *, AStar::SortPoints> sorter;
-
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
-
-	while (!open_list.is_empty()) {
-		AStar::Point *p = open_list[0]; // The currently processed point
-
-		if (p == end_point) {
-			found_route = true;
-			break;
-		}
-
-		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed
-
-		for (OAHashMap<int, AStar::Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
-			AStar::Point *e = *(it.value); // The neighbour point
-
-			if (!e->enabled || e->closed_pass == astar.pass) {
-				continue;
-			}
-
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
-
-			bool new_point = false;
-
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
-				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
-				continue;
-			}
-
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
-			}
-		}
-	}
-
-	return found_route;
-}
-
 void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar2D::get_available_point_id);
 	ClassDB::bind_method(D_METHOD("add_point", "id", "position", "weight_scale"), &AStar2D::add_point, DEFVAL(1.0));
+	ClassDB::bind_method(D_METHOD("add_points", "ids", "positions", "weight_scales"), &AStar2D::add_points, DEFVAL(PackedFloat32Array()));
 	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStar2D::get_point_position);
 	ClassDB::bind_method(D_METHOD("set_point_position", "id", "position"), &AStar2D::set_point_position);
 	ClassDB::bind_method(D_METHOD("get_point_weight_scale", "id"), &AStar2D::get_point_weight_scale);
@@ -863,6 +899,7 @@ void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_point_disabled", "id"), &AStar2D::is_point_disabled);
 
 	ClassDB::bind_method(D_METHOD("connect_points", "id", "to_id", "bidirectional"), &AStar2D::connect_points, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("connect_point_pairs", "pairs", "bidirectional"), &AStar2D::connect_point_pairs, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("disconnect_points", "id", "to_id"), &AStar2D::disconnect_points);
 	ClassDB::bind_method(D_METHOD("are_points_connected", "id", "to_id"), &AStar2D::are_points_connected);
 
@@ -34,12 +34,58 @@
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 
 /**
 	A* pathfinding algorithm.
 */
 
+// Scratch data of a path search, indexed like the points of the searched graph.
+// It is kept out of the points so several searches can run at the same time.
+struct AStarSearchState {
+	struct OpenPoint {
+		uint32_t index = 0;
+		real_t f_score = 0;
+		real_t g_score = 0;
+	};
+
+	struct SortOpenPoints {
+		_FORCE_INLINE_ bool operator()(const OpenPoint &A, const OpenPoint &B) const { // Returns true when the point A is worse than point B.
+			if (A.f_score > B.f_score) {
+				return true;
+			} else if (A.f_score < B.f_score) {
+				return false;
+			} else {
+				return A.g_score < B.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+			}
+		}
+	};
+
+	LocalVector<uint32_t> prev_point;
+	LocalVector<real_t> g_score;
+	LocalVector<uint64_t> open_pass;
+	LocalVector<uint64_t> closed_pass;
+	LocalVector<OpenPoint> open_list; // Binary heap, may hold outdated entries of the closed points.
+	uint64_t pass = 0;
+
+	// Starts a new search over `p_point_count` points.
+	void begin(uint32_t p_point_count);
+};
+
+// Search states reused between the queries of a graph.
+class AStarSearchStatePool {
+	Mutex mutex;
+	LocalVector<AStarSearchState *> free_states;
+
+public:
+	AStarSearchState *acquire();
+	void release(AStarSearchState *p_state);
+
+	~AStarSearchStatePool();
+};
+
 class AStar : public RefCounted {
 	GDCLASS(AStar, RefCounted);
 	friend class AStar2D;
@@ -55,24 +101,8 @@ class AStar : public RefCounted {
 		OAHashMap<int, Point *> neighbours = 4u;
 		OAHashMap<int, Point *> unlinked_neighbours = 4u;
 
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
-	};
-
-	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
-				return true;
-			} else if (A->f_score < B->f_score) {
-				return false;
-			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
-			}
-		}
+		// Index of the point in the compact graph.
+		uint32_t index = 0;
 	};
 
 	struct Segment {
@@ -109,12 +139,30 @@ class AStar : public RefCounted {
 	};
 
 	int last_free_id = 0;
-	uint64_t pass = 1;
 
 	OAHashMap<int, Point *> points;
 	Set<Segment> segments;
 
-	bool _solve(Point *begin_point, Point *end_point);
+	// Compact copy of the graph the searches run on, the neighbours of the
+	// point `i` are `compact_neighbours[compact_offsets[i]..compact_offsets[i + 1]]`.
+	// It is rebuilt by the first search after the points or connections change.
+	LocalVector<Point *> compact_points;
+	LocalVector<int> compact_ids;
+	LocalVector<real_t> compact_weight_scales;
+	LocalVector<bool> compact_enabled;
+	LocalVector<uint32_t> compact_offsets;
+	LocalVector<uint32_t> compact_neighbours;
+	bool compact_dirty = true;
+	Mutex compact_mutex;
+
+	AStarSearchStatePool search_states;
+
+	void _update_compact();
+
+	template <class T>
+	bool _solve(T *p_cost_owner, AStarSearchState &r_state, uint32_t p_begin, uint32_t p_end) const;
+	template <class T>
+	bool _find_path(T *p_cost_owner, Point *p_begin, Point *p_end, LocalVector<uint32_t> &r_path);
 
 protected:
 	static void _bind_methods();
@@ -129,6 +177,7 @@ public:
 	int get_available_point_id() const;
 
 	void add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale = 1);
+	void add_points(const PackedInt32Array &p_ids, const PackedVector3Array &p_positions, const PackedFloat32Array &p_weight_scales = PackedFloat32Array());
 	Vector3 get_point_position(int p_id) const;
 	void set_point_position(int p_id, const Vector3 &p_pos);
 	real_t get_point_weight_scale(int p_id) const;
@@ -142,6 +191,7 @@ public:
 	bool is_point_disabled(int p_id) const;
 
 	void connect_points(int p_id, int p_with_id, bool bidirectional = true);
+	void connect_point_pairs(const PackedInt32Array &p_pairs, bool p_bidirectional = true);
 	void disconnect_points(int p_id, int p_with_id, bool bidirectional = true);
 	bool are_points_connected(int p_id, int p_with_id, bool bidirectional = true) const;
 
@@ -162,10 +212,9 @@ public:
 
 class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
+	friend class AStar;
 	AStar astar;
 
-	bool _solve(AStar::Point *begin_point, AStar::Point *end_point);
-
 protected:
 	static void _bind_methods();
 
@@ -179,6 +228,7 @@ public:
 	int get_available_point_id() const;
 
 	void add_point(int p_id, const Vector2 &p_pos, real_t p_weight_scale = 1);
+	void add_points(const PackedInt32Array &p_ids, const PackedVector2Array &p_positions, const PackedFloat32Array &p_weight_scales = PackedFloat32Array());
 	Vector2 get_point_position(int p_id) const;
 	void set_point_position(int p_id, const Vector2 &p_pos);
 	real_t get_point_weight_scale(int p_id) const;
@@ -192,6 +242,7 @@ public:
 	bool is_point_disabled(int p_id) const;
 
 	void connect_points(int p_id, int p_with_id, bool p_bidirectional = true);
+	void connect_point_pairs(const PackedInt32Array &p_pairs, bool p_bidirectional = true);
 	void disconnect_points(int p_id, int p_with_id);
 	bool are_points_connected(int p_id, int p_with_id) const;
 
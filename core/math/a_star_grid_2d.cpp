@@ -0,0 +1,465 @@
+/*************************************************************************/
+/*  a_star_grid_2d.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "a_star_grid_2d.h"
+
+static const int64_t directions[8][2] = {
+	{ 1, 0 },
+	{ -1, 0 },
+	{ 0, 1 },
+	{ 0, -1 },
+	{ 1, 1 },
+	{ -1, 1 },
+	{ 1, -1 },
+	{ -1, -1 },
+};
+
+void AStarGrid2D::set_size(const Size2i &p_size) {
+	ERR_FAIL_COND_MSG(p_size.x < 0 || p_size.y < 0, vformat("Can't set a negative grid size: %s.", p_size));
+	ERR_FAIL_COND_MSG(int64_t(p_size.x) * p_size.y > INT32_MAX, vformat("Can't set a grid size with more than %d cells: %s.", INT32_MAX, p_size));
+
+	size = p_size;
+	solid.resize(size.x * size.y);
+	for (uint32_t i = 0; i < solid.size(); i++) {
+		solid[i] = false;
+	}
+}
+
+Size2i AStarGrid2D::get_size() const {
+	return size;
+}
+
+void AStarGrid2D::set_offset(const Vector2 &p_offset) {
+	offset = p_offset;
+}
+
+Vector2 AStarGrid2D::get_offset() const {
+	return offset;
+}
+
+void AStarGrid2D::set_cell_size(const Size2 &p_cell_size) {
+	ERR_FAIL_COND_MSG(p_cell_size.x <= 0 || p_cell_size.y <= 0, vformat("Can't set a cell size that isn't positive: %s.", p_cell_size));
+	cell_size = p_cell_size;
+}
+
+Size2 AStarGrid2D::get_cell_size() const {
+	return cell_size;
+}
+
+void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
+	ERR_FAIL_INDEX(int(p_diagonal_mode), int(DIAGONAL_MODE_MAX));
+	diagonal_mode = p_diagonal_mode;
+}
+
+AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
+	return diagonal_mode;
+}
+
+void AStarGrid2D::set_jumping_enabled(bool p_enabled) {
+	jumping_enabled = p_enabled;
+}
+
+bool AStarGrid2D::is_jumping_enabled() const {
+	return jumping_enabled;
+}
+
+bool AStarGrid2D::is_in_bounds(const Vector2i &p_id) const {
+	return p_id.x >= 0 && p_id.y >= 0 && p_id.x < size.x && p_id.y < size.y;
+}
+
+Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
+	return offset + Vector2(p_id) * cell_size;
+}
+
+void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
+	ERR_FAIL_COND_MSG(!is_in_bounds(p_id), vformat("Can't set if point is solid. Point out of bounds: %s.", p_id));
+	solid[_get_index(p_id.x, p_id.y)] = p_solid;
+}
+
+bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_id), false, vformat("Can't get if point is solid. Point out of bounds: %s.", p_id));
+	return solid[_get_index(p_id.x, p_id.y)];
+}
+
+void AStarGrid2D::clear() {
+	size = Size2i();
+	solid.clear();
+}
+
+bool AStarGrid2D::_can_move(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy) const {
+	if (!_is_walkable(p_x + p_dx, p_y + p_dy)) {
+		return false;
+	}
+	if (p_dx == 0 || p_dy == 0) {
+		return true;
+	}
+
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_ALWAYS:
+			return true;
+		case DIAGONAL_MODE_NEVER:
+			return false;
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE:
+			return _is_walkable(p_x + p_dx, p_y) || _is_walkable(p_x, p_y + p_dy);
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES:
+			return _is_walkable(p_x + p_dx, p_y) && _is_walkable(p_x, p_y + p_dy);
+		default:
+			return false;
+	}
+}
+
+// A neighbour is forced when the shortest path to it goes through this point,
+// because an obstacle next to the previous point blocks the other paths.
+bool AStarGrid2D::_has_forced_neighbour(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy) const {
+	if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
+		// Obstacles beside the point, the cells behind them are reached by cutting their corner.
+		if (p_dx != 0 && p_dy != 0) {
+			return (_is_walkable(p_x - p_dx, p_y + p_dy) && !_is_walkable(p_x - p_dx, p_y)) ||
+					(_is_walkable(p_x + p_dx, p_y - p_dy) && !_is_walkable(p_x, p_y - p_dy));
+		} else if (p_dx != 0) {
+			return (_is_walkable(p_x + p_dx, p_y + 1) && !_is_walkable(p_x, p_y + 1)) ||
+					(_is_walkable(p_x + p_dx, p_y - 1) && !_is_walkable(p_x, p_y - 1));
+		} else {
+			return (_is_walkable(p_x + 1, p_y + p_dy) && !_is_walkable(p_x + 1, p_y)) ||
+					(_is_walkable(p_x - 1, p_y + p_dy) && !_is_walkable(p_x - 1, p_y));
+		}
+	}
+
+	// Obstacles beside the previous point, the cells beside this point open up.
+	if (p_dx != 0 && p_dy != 0) {
+		return false;
+	} else if (p_dx != 0) {
+		return (_is_walkable(p_x, p_y - 1) && !_is_walkable(p_x - p_dx, p_y - 1)) ||
+				(_is_walkable(p_x, p_y + 1) && !_is_walkable(p_x - p_dx, p_y + 1));
+	} else {
+		return (_is_walkable(p_x - 1, p_y) && !_is_walkable(p_x - 1, p_y - p_dy)) ||
+				(_is_walkable(p_x + 1, p_y) && !_is_walkable(p_x + 1, p_y - p_dy));
+	}
+}
+
+// Directions worth searching from a jump point reached in the direction,
+// the others are reached as well by paths avoiding the point.
+int AStarGrid2D::_get_pruned_directions(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy, int64_t (*r_directions)[2]) const {
+	int count = 0;
+	auto add = [&](int64_t p_dir_x, int64_t p_dir_y) {
+		r_directions[count][0] = p_dir_x;
+		r_directions[count][1] = p_dir_y;
+		count++;
+	};
+
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_ALWAYS:
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+			if (p_dx != 0 && p_dy != 0) {
+				add(0, p_dy);
+				add(p_dx, 0);
+				add(p_dx, p_dy);
+				if (!_is_walkable(p_x - p_dx, p_y)) {
+					add(-p_dx, p_dy);
+				}
+				if (!_is_walkable(p_x, p_y - p_dy)) {
+					add(p_dx, -p_dy);
+				}
+			} else if (p_dx != 0) {
+				add(p_dx, 0);
+				if (!_is_walkable(p_x, p_y + 1)) {
+					add(p_dx, 1);
+				}
+				if (!_is_walkable(p_x, p_y - 1)) {
+					add(p_dx, -1);
+				}
+			} else {
+				add(0, p_dy);
+				if (!_is_walkable(p_x + 1, p_y)) {
+					add(1, p_dy);
+				}
+				if (!_is_walkable(p_x - 1, p_y)) {
+					add(-1, p_dy);
+				}
+			}
+		} break;
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+			if (p_dx != 0 && p_dy != 0) {
+				add(0, p_dy);
+				add(p_dx, 0);
+				add(p_dx, p_dy);
+			} else if (p_dx != 0) {
+				add(p_dx, 0);
+				add(p_dx, 1);
+				add(p_dx, -1);
+				add(0, 1);
+				add(0, -1);
+			} else {
+				add(0, p_dy);
+				add(1, p_dy);
+				add(-1, p_dy);
+				add(1, 0);
+				add(-1, 0);
+			}
+		} break;
+		default: {
+			if (p_dx != 0) {
+				add(p_dx, 0);
+				add(0, 1);
+				add(0, -1);
+			} else {
+				add(0, p_dy);
+				add(1, 0);
+				add(-1, 0);
+			}
+		} break;
+	}
+
+	return count;
+}
+
+// Moves from the point in the direction until reaching a point where the
+// search has to branch. The first move is expected to be valid.
+bool AStarGrid2D::_jump(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy, const Vector2i &p_end, Vector2i &r_jump_point) const {
+	int64_t x = p_x;
+	int64_t y = p_y;
+	Vector2i unused;
+
+	while (true) {
+		x += p_dx;
+		y += p_dy;
+
+		if (!_is_walkable(x, y)) {
+			return false;
+		}
+
+		bool is_jump_point = (x == p_end.x && y == p_end.y) || _has_forced_neighbour(x, y, p_dx, p_dy);
+		if (!is_jump_point && p_dx != 0 && p_dy != 0) {
+			// The diagonal moves stop where a straight move finds something.
+			is_jump_point = _jump(x, y, p_dx, 0, p_end, unused) || _jump(x, y, 0, p_dy, p_end, unused);
+		} else if (!is_jump_point && p_dy != 0 && diagonal_mode == DIAGONAL_MODE_NEVER) {
+			// Without diagonals, the vertical moves play their role.
+			is_jump_point = _jump(x, y, 1, 0, p_end, unused) || _jump(x, y, -1, 0, p_end, unused);
+		}
+
+		if (is_jump_point) {
+			r_jump_point = Vector2i(x, y);
+			return true;
+		}
+
+		if (!_can_move(x, y, p_dx, p_dy)) {
+			return false;
+		}
+	}
+}
+
+bool AStarGrid2D::_solve(AStarSearchState &r_state, const Vector2i &p_from, const Vector2i &p_to) const {
+	if (!_is_walkable(p_to.x, p_to.y)) {
+		return false;
+	}
+
+	r_state.begin(solid.size());
+	const uint64_t pass = r_state.pass;
+	const uint32_t end = _get_index(p_to.x, p_to.y);
+	const Vector2 end_position = get_point_position(p_to);
+
+	LocalVector<AStarSearchState::OpenPoint> &open_list = r_state.open_list;
+	SortArray<AStarSearchState::OpenPoint, AStarSearchState::SortOpenPoints> sorter;
+
+	AStarSearchState::OpenPoint begin_point;
+	begin_point.index = _get_index(p_from.x, p_from.y);
+	begin_point.f_score = get_point_position(p_from).distance_to(end_position);
+	r_state.g_score[begin_point.index] = 0;
+	r_state.open_pass[begin_point.index] = pass;
+	open_list.push_back(begin_point);
+
+	while (!open_list.is_empty()) {
+		const uint32_t p = open_list[0].index; // The currently processed point
+
+		if (p == end) {
+			return true;
+		}
+
+		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list
+		open_list.resize(open_list.size() - 1);
+
+		if (r_state.closed_pass[p] == pass) {
+			continue; // Outdated entry, the point was reached with a lower score.
+		}
+		r_state.closed_pass[p] = pass; // Mark the point as closed
+
+		const Vector2i p_id = _get_id(p);
+		const Vector2 p_position = get_point_position(p_id);
+
+		int64_t pruned_directions[8][2];
+		const int64_t(*search_directions)[2] = directions;
+		int search_direction_count = 8;
+		if (jumping_enabled && p != begin_point.index) {
+			const Vector2i parent_id = _get_id(r_state.prev_point[p]);
+			search_direction_count = _get_pruned_directions(p_id.x, p_id.y, SIGN(p_id.x - parent_id.x), SIGN(p_id.y - parent_id.y), pruned_directions);
+			search_directions = pruned_directions;
+		}
+
+		for (int i = 0; i < search_direction_count; i++) {
+			const int64_t dx = search_directions[i][0];
+			const int64_t dy = search_directions[i][1];
+			if (!_can_move(p_id.x, p_id.y, dx, dy)) {
+				continue;
+			}
+
+			Vector2i e_id = Vector2i(p_id.x + dx, p_id.y + dy); // The neighbour point
+			if (jumping_enabled && !_jump(p_id.x, p_id.y, dx, dy, p_to, e_id)) {
+				continue;
+			}
+
+			const uint32_t e = _get_index(e_id.x, e_id.y);
+			if (r_state.closed_pass[e] == pass) {
+				continue;
+			}
+
+			const Vector2 e_position = get_point_position(e_id);
+			real_t tentative_g_score = r_state.g_score[p] + p_position.distance_to(e_position);
+
+			if (r_state.open_pass[e] == pass && tentative_g_score >= r_state.g_score[e]) { // The new path is worse than the previous.
+				continue;
+			}
+
+			r_state.open_pass[e] = pass;
+			r_state.prev_point[e] = p;
+			r_state.g_score[e] = tentative_g_score;
+
+			AStarSearchState::OpenPoint open_point;
+			open_point.index = e;
+			open_point.g_score = tentative_g_score;
+			open_point.f_score = tentative_g_score + e_position.distance_to(end_position);
+			open_list.push_back(open_point);
+			sorter.push_heap(0, open_list.size() - 1, 0, open_point, open_list.ptr());
+		}
+	}
+
+	return false;
+}
+
+bool AStarGrid2D::_find_path(const Vector2i &p_from, const Vector2i &p_to, LocalVector<Vector2i> &r_path) {
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_from), false, vformat("Can't get path. Point out of bounds: %s.", p_from));
+	ERR_FAIL_COND_V_MSG(!is_in_bounds(p_to), false, vformat("Can't get path. Point out of bounds: %s.", p_to));
+
+	if (p_from == p_to) {
+		r_path.push_back(p_from);
+		return true;
+	}
+
+	AStarSearchState *state = search_states.acquire();
+	bool found_route = _solve(*state, p_from, p_to);
+
+	if (found_route) {
+		// With jumps, the consecutive points of the route are on a straight or diagonal line.
+		const uint32_t begin = _get_index(p_from.x, p_from.y);
+		uint32_t p = _get_index(p_to.x, p_to.y);
+		r_path.push_back(p_to);
+		while (p != begin) {
+			const Vector2i to = _get_id(p);
+			p = state->prev_point[p];
+			const Vector2i from = _get_id(p);
+			const Vector2i step = Vector2i(SIGN(from.x - to.x), SIGN(from.y - to.y));
+			for (Vector2i id = to + step; id != from; id += step) {
+				r_path.push_back(id);
+			}
+			r_path.push_back(from);
+		}
+		r_path.invert();
+	}
+
+	search_states.release(state);
+	return found_route;
+}
+
+Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from, const Vector2i &p_to) {
+	LocalVector<Vector2i> route;
+	if (!_find_path(p_from, p_to, route)) {
+		return Vector<Vector2>();
+	}
+
+	Vector<Vector2> path;
+	path.resize(route.size());
+
+	{
+		Vector2 *w = path.ptrw();
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = get_point_position(route[i]);
+		}
+	}
+
+	return path;
+}
+
+TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from, const Vector2i &p_to) {
+	LocalVector<Vector2i> route;
+	if (!_find_path(p_from, p_to, route)) {
+		return TypedArray<Vector2i>();
+	}
+
+	TypedArray<Vector2i> path;
+	path.resize(route.size());
+	for (uint32_t i = 0; i < route.size(); i++) {
+		path[i] = route[i];
+	}
+
+	return path;
+}
+
+void AStarGrid2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_size", "size"), &AStarGrid2D::set_size);
+	ClassDB::bind_method(D_METHOD("get_size"), &AStarGrid2D::get_size);
+	ClassDB::bind_method(D_METHOD("set_offset", "offset"), &AStarGrid2D::set_offset);
+	ClassDB::bind_method(D_METHOD("get_offset"), &AStarGrid2D::get_offset);
+	ClassDB::bind_method(D_METHOD("set_cell_size", "cell_size"), &AStarGrid2D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &AStarGrid2D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+
+	ClassDB::bind_method(D_METHOD("is_in_bounds", "id"), &AStarGrid2D::is_in_bounds);
+	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStarGrid2D::get_point_position);
+	ClassDB::bind_method(D_METHOD("set_point_solid", "id", "solid"), &AStarGrid2D::set_point_solid, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_point_solid", "id"), &AStarGrid2D::is_point_solid);
+	ClassDB::bind_method(D_METHOD("clear"), &AStarGrid2D::clear);
+
+	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStarGrid2D::get_point_path);
+	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStarGrid2D::get_id_path);
+
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "size"), "set_size", "get_size");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "offset"), "set_offset", "get_offset");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "cell_size"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Always,Never,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ALWAYS);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_NEVER);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_MAX);
+}
@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  a_star_grid_2d.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef A_STAR_GRID_2D_H
+#define A_STAR_GRID_2D_H
+
+#include "core/math/a_star.h"
+#include "core/variant/typed_array.h"
+
+/**
+	A* pathfinding on a uniform 2D grid, with optional jump point search.
+*/
+
+class AStarGrid2D : public RefCounted {
+	GDCLASS(AStarGrid2D, RefCounted);
+
+public:
+	enum DiagonalMode {
+		DIAGONAL_MODE_ALWAYS,
+		DIAGONAL_MODE_NEVER,
+		DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE,
+		DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES,
+		DIAGONAL_MODE_MAX,
+	};
+
+private:
+	Size2i size;
+	Vector2 offset;
+	Size2 cell_size = Size2(1, 1);
+	DiagonalMode diagonal_mode = DIAGONAL_MODE_ALWAYS;
+	bool jumping_enabled = false;
+
+	LocalVector<bool> solid; // Row major, `size.x * size.y` cells.
+
+	AStarSearchStatePool search_states;
+
+	_FORCE_INLINE_ bool _is_walkable(int64_t p_x, int64_t p_y) const {
+		return p_x >= 0 && p_y >= 0 && p_x < size.x && p_y < size.y && !solid[p_y * size.x + p_x];
+	}
+	_FORCE_INLINE_ uint32_t _get_index(int64_t p_x, int64_t p_y) const {
+		return p_y * size.x + p_x;
+	}
+	_FORCE_INLINE_ Vector2i _get_id(uint32_t p_index) const {
+		return Vector2i(p_index % size.x, p_index / size.x);
+	}
+
+	bool _can_move(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy) const;
+	bool _has_forced_neighbour(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy) const;
+	int _get_pruned_directions(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy, int64_t (*r_directions)[2]) const;
+	bool _jump(int64_t p_x, int64_t p_y, int64_t p_dx, int64_t p_dy, const Vector2i &p_end, Vector2i &r_jump_point) const;
+
+	bool _solve(AStarSearchState &r_state, const Vector2i &p_from, const Vector2i &p_to) const;
+	bool _find_path(const Vector2i &p_from, const Vector2i &p_to, LocalVector<Vector2i> &r_path);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_size(const Size2i &p_size);
+	Size2i get_size() const;
+	void set_offset(const Vector2 &p_offset);
+	Vector2 get_offset() const;
+	void set_cell_size(const Size2 &p_cell_size);
+	Size2 get_cell_size() const;
+	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
+	DiagonalMode get_diagonal_mode() const;
+	void set_jumping_enabled(bool p_enabled);
+	bool is_jumping_enabled() const;
+
+	bool is_in_bounds(const Vector2i &p_id) const;
+	Vector2 get_point_position(const Vector2i &p_id) const;
+	void set_point_solid(const Vector2i &p_id, bool p_solid = true);
+	bool is_point_solid(const Vector2i &p_id) const;
+	void clear();
+
+	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to);
+	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to);
+
+	AStarGrid2D() {}
+	~AStarGrid2D() {}
+};
+
+VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
+
+#endif // A_STAR_GRID_2D_H
@@ -30,6 +30,8 @@
 
 #include "dynamic_bvh.h"
 
+#include "core/templates/thread_work_pool.h"
+
 void DynamicBVH::_delete_node(Node *p_node) {
 	node_allocator.free(p_node);
 }
@@ -289,6 +291,7 @@ void DynamicBVH::clear() {
 	}
 	lkhd = -1;
 	opath = 0;
+	refit_leaves.clear();
 }
 
 void DynamicBVH::optimize_bottom_up() {
@@ -386,9 +389,104 @@ bool DynamicBVH::update(const ID &p_id, const AABB &p_box) {
 	return true;
 }
 
+bool DynamicBVH::update_deferred(const ID &p_id, const AABB &p_box) {
+	ERR_FAIL_COND_V(!p_id.is_valid(), false);
+	Node *leaf = p_id.node;
+
+	Volume volume;
+	volume.min = p_box.position;
+	volume.max = p_box.position + p_box.size;
+
+	if (leaf->volume.min.is_equal_approx(volume.min) && leaf->volume.max.is_equal_approx(volume.max)) {
+		// noop
+		return false;
+	}
+
+	if (!leaf->volume.intersects(volume)) {
+		// Moved too far, refitting would stretch the parents over the whole path.
+		return update(p_id, p_box);
+	}
+
+	leaf->volume = volume;
+	if (leaf->refit_index == UINT32_MAX) {
+		leaf->refit_index = refit_leaves.size();
+		refit_leaves.push_back(leaf);
+	}
+	return true;
+}
+
+void DynamicBVH::_collect_refit_roots(Node *p_node, int p_depth) {
+	if (p_depth == REFIT_SPLIT_DEPTH) {
+		refit_roots.push_back(p_node);
+		return;
+	}
+	for (int i = 0; i < 2; i++) {
+		Node *child = p_node->childs[i];
+		if (child->is_internal() && child->refit_pass == refit_pass) {
+			_collect_refit_roots(child, p_depth + 1);
+		}
+	}
+}
+
+void DynamicBVH::_refit_subtree(Node *p_node, int p_depth, int p_stop_depth) {
+	if (p_depth == p_stop_depth) {
+		return; // Already refitted by the threads.
+	}
+	for (int i = 0; i < 2; i++) {
+		Node *child = p_node->childs[i];
+		if (child->is_internal() && child->refit_pass == refit_pass) {
+			_refit_subtree(child, p_depth + 1, p_stop_depth);
+		}
+	}
+	p_node->volume = p_node->childs[0]->volume.merge(p_node->childs[1]->volume);
+}
+
+void DynamicBVH::_refit_root_threaded(uint32_t p_index, void *p_userdata) {
+	_refit_subtree(refit_roots[p_index], 0, -1);
+}
+
+void DynamicBVH::refit(ThreadWorkPool *p_thread_pool) {
+	if (refit_leaves.is_empty()) {
+		return;
+	}
+
+	// Mark the parents of all the changed leaves, they are recomputed from the children afterwards.
+	refit_pass++;
+	for (uint32_t i = 0; i < refit_leaves.size(); i++) {
+		Node *node = refit_leaves[i];
+		node->refit_index = UINT32_MAX;
+		for (node = node->parent; node && node->refit_pass != refit_pass; node = node->parent) {
+			node->refit_pass = refit_pass;
+		}
+	}
+
+	if (bvh_root->is_internal() && bvh_root->refit_pass == refit_pass) {
+		if (p_thread_pool && p_thread_pool->get_thread_count() > 1 && refit_leaves.size() >= REFIT_THREAD_THRESHOLD) {
+			// The marked subtrees at the split depth don't share nodes, so they can be refitted in parallel.
+			refit_roots.clear();
+			_collect_refit_roots(bvh_root, 0);
+			p_thread_pool->do_work(refit_roots.size(), this, &DynamicBVH::_refit_root_threaded, (void *)nullptr);
+			_refit_subtree(bvh_root, 0, REFIT_SPLIT_DEPTH);
+		} else {
+			_refit_subtree(bvh_root, 0, -1);
+		}
+	}
+
+	// Refitting keeps the topology, which gets worse as the leaves move. Reinsert some to compensate.
+	optimize_incremental(refit_leaves.size() / REFIT_REINSERT_RATIO);
+
+	refit_leaves.clear();
+}
+
 void DynamicBVH::remove(const ID &p_id) {
 	ERR_FAIL_COND(!p_id.is_valid());
 	Node *leaf = p_id.node;
+	if (leaf->refit_index != UINT32_MAX) {
+		refit_leaves.remove_at_unordered(leaf->refit_index);
+		if (leaf->refit_index < refit_leaves.size()) {
+			refit_leaves[leaf->refit_index]->refit_index = leaf->refit_index;
+		}
+	}
 	_remove_leaf(leaf);
 	_delete_node(leaf);
 	--total_leaves;
@@ -54,6 +54,8 @@ subject to the following restrictions:
 3. This notice may not be removed or altered from any source distribution.
 */
 
+class ThreadWorkPool;
+
 ///DynamicBVH implementation by Nathanael Presson
 // The DynamicBVH class implements a fast dynamic bounding volume tree based on axis aligned bounding boxes (aabb tree).
 
@@ -185,6 +187,8 @@ private:
 			Node *childs[2];
 			void *data;
 		};
+		uint32_t refit_pass = 0; // Internal nodes, last refit() that has to recompute the volume.
+		uint32_t refit_index = UINT32_MAX; // Leaves, position in refit_leaves if the volume changed since the last refit().
 
 		_FORCE_INLINE_ bool is_leaf() const { return childs[1] == nullptr; }
 		_FORCE_INLINE_ bool is_internal() const { return (!is_leaf()); }
@@ -229,8 +233,15 @@ private:
 	uint32_t opath = 0;
 	uint32_t index = 0;
 
+	LocalVector<Node *> refit_leaves;
+	LocalVector<Node *> refit_roots;
+	uint32_t refit_pass = 0;
+
 	enum {
-		ALLOCA_STACK_SIZE = 128
+		ALLOCA_STACK_SIZE = 128,
+		REFIT_SPLIT_DEPTH = 6, // Subtrees below this depth are refitted in parallel.
+		REFIT_THREAD_THRESHOLD = 2048, // Don't bother with threads for fewer leaves.
+		REFIT_REINSERT_RATIO = 8, // One leaf reinserted for every N refitted, to keep the tree quality.
 	};
 
 	_FORCE_INLINE_ void _delete_node(Node *p_node);
@@ -248,6 +259,10 @@ private:
 
 	_FORCE_INLINE_ void _update(Node *leaf, int lookahead = -1);
 
+	void _collect_refit_roots(Node *p_node, int p_depth);
+	void _refit_subtree(Node *p_node, int p_depth, int p_stop_depth);
+	void _refit_root_threaded(uint32_t p_index, void *p_userdata);
+
 	void _extract_leaves(Node *p_node, List<ID> *r_elements);
 
 	_FORCE_INLINE_ bool _ray_aabb(const Vector3 &rayFrom, const Vector3 &rayInvDirection, const unsigned int raySign[3], const Vector3 bounds[2], real_t &tmin, real_t lambda_min, real_t lambda_max) {
@@ -293,6 +308,11 @@ public:
 	void optimize_incremental(int passes);
 	ID insert(const AABB &p_box, void *p_userdata);
 	bool update(const ID &p_id, const AABB &p_box);
+	// Like update(), but only changes the leaf and leaves fixing the parents to refit(),
+	// which does it for all the changed leaves at once. Queries are not reliable until then.
+	bool update_deferred(const ID &p_id, const AABB &p_box);
+	void refit(ThreadWorkPool *p_thread_pool = nullptr);
+	uint32_t get_refit_pending_count() const { return refit_leaves.size(); }
 	void remove(const ID &p_id);
 	void get_elements(List<ID> *r_elements);
 
@@ -63,6 +63,7 @@
 #include "core/io/udp_server.h"
 #include "core/io/xml_parser.h"
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
 #include "core/math/expression.h"
 #include "core/math/geometry_2d.h"
 #include "core/math/geometry_3d.h"
@@ -227,6 +228,7 @@ void register_core_types() {
 	GDREGISTER_VIRTUAL_CLASS(PackedDataContainerRef);
 	GDREGISTER_CLASS(AStar);
 	GDREGISTER_CLASS(AStar2D);
+	GDREGISTER_CLASS(AStarGrid2D);
 	GDREGISTER_CLASS(EncodedObjectAsID);
 	GDREGISTER_CLASS(RandomNumberGenerator);
 
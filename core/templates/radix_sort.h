@@ -0,0 +1,128 @@
+/*************************************************************************/
+/*  radix_sort.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/sort_array.h"
+
+// Stable radix sort on 128-bit keys, least significant byte first.
+// KeyGetter gives the most significant half of the key of an element in r_high and the other half in r_low.
+// Keys are read once and copied next to their element, so the passes don't go through the elements.
+template <class T, class KeyGetter>
+class RadixSort {
+	struct Entry {
+		uint64_t low;
+		uint64_t high;
+		T value;
+	};
+
+	struct KeyCompare {
+		KeyGetter get_key;
+
+		_FORCE_INLINE_ bool operator()(const T &p_a, const T &p_b) const {
+			uint64_t a_high, a_low, b_high, b_low;
+			get_key(p_a, a_high, a_low);
+			get_key(p_b, b_high, b_low);
+			return (a_high == b_high) ? (a_low < b_low) : (a_high < b_high);
+		}
+	};
+
+	// Kept between sorts.
+	LocalVector<Entry> entries;
+	LocalVector<Entry> entries_swap;
+
+public:
+	enum {
+		// Shorter arrays are insertion sorted, it's not worth clearing and scanning the histograms.
+		INSERTION_SORT_THRESHOLD = 128
+	};
+
+	KeyGetter get_key;
+
+	void sort(T *p_array, uint32_t p_size) {
+		if (p_size < INSERTION_SORT_THRESHOLD) {
+			SortArray<T, KeyCompare> sorter;
+			sorter.compare.get_key = get_key;
+			sorter.insertion_sort(0, p_size, p_array);
+			return;
+		}
+
+		entries.resize(p_size);
+		entries_swap.resize(p_size);
+
+		// All histograms are built in one read.
+		uint32_t histograms[16][256] = {};
+		for (uint32_t i = 0; i < p_size; i++) {
+			Entry &entry = entries[i];
+			get_key(p_array[i], entry.high, entry.low);
+			entry.value = p_array[i];
+			for (uint32_t j = 0; j < 8; j++) {
+				histograms[j][(entry.low >> (j * 8)) & 0xFF]++;
+				histograms[j + 8][(entry.high >> (j * 8)) & 0xFF]++;
+			}
+		}
+
+		Entry *src = entries.ptr();
+		Entry *dst = entries_swap.ptr();
+		for (uint32_t pass = 0; pass < 16; pass++) {
+			uint32_t *histogram = histograms[pass];
+			uint32_t shift = (pass % 8) * 8;
+			bool high = pass >= 8;
+
+			// Skip bytes that are the same in every key.
+			uint64_t first_key = high ? src[0].high : src[0].low;
+			if (histogram[(first_key >> shift) & 0xFF] == p_size) {
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t count = histogram[i];
+				histogram[i] = offset;
+				offset += count;
+			}
+
+			for (uint32_t i = 0; i < p_size; i++) {
+				uint64_t key = high ? src[i].high : src[i].low;
+				dst[histogram[(key >> shift) & 0xFF]++] = src[i];
+			}
+
+			SWAP(src, dst);
+		}
+
+		for (uint32_t i = 0; i < p_size; i++) {
+			p_array[i] = src[i].value;
+		}
+	}
+};
+
+#endif // RADIX_SORT_H
@@ -2172,6 +2172,9 @@ Color RasterizerStorageGLES3::multimesh_instance_get_custom_data(RID p_multimesh
 void RasterizerStorageGLES3::multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) {
 }
 
+void RasterizerStorageGLES3::multimesh_set_buffer_range(RID p_multimesh, int p_instance_offset, int p_instance_count, const Vector<float> &p_buffer) {
+}
+
 Vector<float> RasterizerStorageGLES3::multimesh_get_buffer(RID p_multimesh) const {
 	return Vector<float>();
 }
@@ -844,6 +844,7 @@ public:
 	Color multimesh_instance_get_color(RID p_multimesh, int p_index) const override;
 	Color multimesh_instance_get_custom_data(RID p_multimesh, int p_index) const override;
 	void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) override;
+	void multimesh_set_buffer_range(RID p_multimesh, int p_instance_offset, int p_instance_count, const Vector<float> &p_buffer) override;
 	Vector<float> multimesh_get_buffer(RID p_multimesh) const override;
 
 	void multimesh_set_visible_instances(RID p_multimesh, int p_visible) override;
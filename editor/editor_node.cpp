@@ -149,6 +149,7 @@
 #include "editor/plugins/gpu_particles_3d_editor_plugin.h"
 #include "editor/plugins/gpu_particles_collision_sdf_editor_plugin.h"
 #include "editor/plugins/gradient_editor_plugin.h"
+#include "editor/plugins/hlod_group_3d_editor_plugin.h"
 #include "editor/plugins/input_event_editor_plugin.h"
 #include "editor/plugins/light_occluder_2d_editor_plugin.h"
 #include "editor/plugins/lightmap_gi_editor_plugin.h"
@@ -7005,6 +7006,7 @@ EditorNode::EditorNode() {
 	add_editor_plugin(memnew(VoxelGIEditorPlugin));
 	add_editor_plugin(memnew(LightmapGIEditorPlugin));
 	add_editor_plugin(memnew(OccluderInstance3DEditorPlugin));
+	add_editor_plugin(memnew(HLODGroup3DEditorPlugin));
 	add_editor_plugin(memnew(Path2DEditorPlugin));
 	add_editor_plugin(memnew(Path3DEditorPlugin));
 	add_editor_plugin(memnew(Line2DEditorPlugin));
@@ -30,8 +30,10 @@
 
 #include "resource_importer_scene.h"
 
+#include "core/config/project_settings.h"
 #include "core/error/error_macros.h"
 #include "core/io/resource_saver.h"
+#include "core/templates/thread_work_pool.h"
 #include "editor/editor_node.h"
 #include "editor/import/scene_import_settings.h"
 #include "scene/3d/area_3d.h"
@@ -1540,6 +1542,7 @@ void ResourceImporterScene::get_import_options(const String &p_path, List<Import
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "nodes/root_scale", PROPERTY_HINT_RANGE, "0.001,1000,0.001"), 1.0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/ensure_tangents"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/generate_lods"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/optimize_surfaces"), false));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/create_shadow_meshes"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/light_baking", PROPERTY_HINT_ENUM, "Disabled,Static (VoxelGI/SDFGI),Static Lightmaps (VoxelGI/SDFGI/LightmapGI),Dynamic (VoxelGI only)", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 1));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "meshes/lightmap_texel_size", PROPERTY_HINT_RANGE, "0.001,100,0.001"), 0.1));
@@ -1570,94 +1573,113 @@ void ResourceImporterScene::_replace_owner(Node *p_node, Node *p_scene, Node *p_
 	}
 }
 
-void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_mesh_data, bool p_generate_lods, bool p_create_shadow_meshes, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches) {
+void ResourceImporterScene::_gather_mesh_tasks(Node *p_node, const Dictionary &p_mesh_data, const MeshTask &p_defaults, Map<Ref<ImporterMesh>, int> &r_task_indices, LocalVector<MeshTask> &r_tasks) {
 	ImporterMeshInstance3D *src_mesh_node = Object::cast_to<ImporterMeshInstance3D>(p_node);
-	if (src_mesh_node) {
-		//is mesh
-		MeshInstance3D *mesh_node = memnew(MeshInstance3D);
-		mesh_node->set_name(src_mesh_node->get_name());
-		mesh_node->set_transform(src_mesh_node->get_transform());
-		mesh_node->set_skin(src_mesh_node->get_skin());
-		mesh_node->set_skeleton_path(src_mesh_node->get_skeleton_path());
-		if (src_mesh_node->get_mesh().is_valid()) {
-			Ref<ArrayMesh> mesh;
-			if (!src_mesh_node->get_mesh()->has_mesh()) {
-				//do mesh processing
+	if (src_mesh_node && src_mesh_node->get_mesh().is_valid() && !src_mesh_node->get_mesh()->has_mesh() && !r_task_indices.has(src_mesh_node->get_mesh())) {
+		MeshTask task = p_defaults;
+		task.mesh = src_mesh_node->get_mesh();
 
-				bool generate_lods = p_generate_lods;
-				float split_angle = 25.0f;
-				float merge_angle = 60.0f;
-				bool create_shadow_meshes = p_create_shadow_meshes;
-				bool bake_lightmaps = p_light_bake_mode == LIGHT_BAKE_STATIC_LIGHTMAPS;
-				String save_to_file;
+		String mesh_id;
 
-				String mesh_id;
+		if (src_mesh_node->get_mesh()->has_meta("import_id")) {
+			mesh_id = src_mesh_node->get_mesh()->get_meta("import_id");
+		} else {
+			mesh_id = src_mesh_node->get_mesh()->get_name();
+		}
 
-				if (src_mesh_node->get_mesh()->has_meta("import_id")) {
-					mesh_id = src_mesh_node->get_mesh()->get_meta("import_id");
-				} else {
-					mesh_id = src_mesh_node->get_mesh()->get_name();
+		if (!mesh_id.is_empty() && p_mesh_data.has(mesh_id)) {
+			Dictionary mesh_settings = p_mesh_data[mesh_id];
+
+			if (mesh_settings.has("generate/shadow_meshes")) {
+				int shadow_meshes = mesh_settings["generate/shadow_meshes"];
+				if (shadow_meshes == MESH_OVERRIDE_ENABLE) {
+					task.create_shadow_meshes = true;
+				} else if (shadow_meshes == MESH_OVERRIDE_DISABLE) {
+					task.create_shadow_meshes = false;
 				}
+			}
 
-				if (!mesh_id.is_empty() && p_mesh_data.has(mesh_id)) {
-					Dictionary mesh_settings = p_mesh_data[mesh_id];
+			if (mesh_settings.has("generate/lightmap_uv")) {
+				int lightmap_uv = mesh_settings["generate/lightmap_uv"];
+				if (lightmap_uv == MESH_OVERRIDE_ENABLE) {
+					task.bake_lightmaps = true;
+				} else if (lightmap_uv == MESH_OVERRIDE_DISABLE) {
+					task.bake_lightmaps = false;
+				}
+			}
 
-					if (mesh_settings.has("generate/shadow_meshes")) {
-						int shadow_meshes = mesh_settings["generate/shadow_meshes"];
-						if (shadow_meshes == MESH_OVERRIDE_ENABLE) {
-							create_shadow_meshes = true;
-						} else if (shadow_meshes == MESH_OVERRIDE_DISABLE) {
-							create_shadow_meshes = false;
-						}
-					}
+			if (mesh_settings.has("generate/lods")) {
+				int lods = mesh_settings["generate/lods"];
+				if (lods == MESH_OVERRIDE_ENABLE) {
+					task.generate_lods = true;
+				} else if (lods == MESH_OVERRIDE_DISABLE) {
+					task.generate_lods = false;
+				}
+			}
 
-					if (mesh_settings.has("generate/lightmap_uv")) {
-						int lightmap_uv = mesh_settings["generate/lightmap_uv"];
-						if (lightmap_uv == MESH_OVERRIDE_ENABLE) {
-							bake_lightmaps = true;
-						} else if (lightmap_uv == MESH_OVERRIDE_DISABLE) {
-							bake_lightmaps = false;
-						}
-					}
+			if (mesh_settings.has("lods/normal_split_angle")) {
+				task.split_angle = mesh_settings["lods/normal_split_angle"];
+			}
 
-					if (mesh_settings.has("generate/lods")) {
-						int lods = mesh_settings["generate/lods"];
-						if (lods == MESH_OVERRIDE_ENABLE) {
-							generate_lods = true;
-						} else if (lods == MESH_OVERRIDE_DISABLE) {
-							generate_lods = false;
-						}
-					}
+			if (mesh_settings.has("lods/normal_merge_angle")) {
+				task.merge_angle = mesh_settings["lods/normal_merge_angle"];
+			}
 
-					if (mesh_settings.has("lods/normal_split_angle")) {
-						split_angle = mesh_settings["lods/normal_split_angle"];
-					}
+			if (mesh_settings.has("save_to_file/enabled") && bool(mesh_settings["save_to_file/enabled"]) && mesh_settings.has("save_to_file/path")) {
+				task.save_to_file = mesh_settings["save_to_file/path"];
+				if (!task.save_to_file.is_resource_file()) {
+					task.save_to_file = "";
+				}
+			}
 
-					if (mesh_settings.has("lods/normal_merge_angle")) {
-						merge_angle = mesh_settings["lods/normal_merge_angle"];
-					}
+			for (int i = 0; i < post_importer_plugins.size(); i++) {
+				post_importer_plugins.write[i]->internal_process(EditorScenePostImportPlugin::INTERNAL_IMPORT_CATEGORY_MESH, nullptr, src_mesh_node, src_mesh_node->get_mesh(), mesh_settings);
+			}
+		}
 
-					if (mesh_settings.has("save_to_file/enabled") && bool(mesh_settings["save_to_file/enabled"]) && mesh_settings.has("save_to_file/path")) {
-						save_to_file = mesh_settings["save_to_file/path"];
-						if (!save_to_file.is_resource_file()) {
-							save_to_file = "";
-						}
-					}
+		r_task_indices[task.mesh] = r_tasks.size();
+		r_tasks.push_back(task);
+	}
 
-					for (int i = 0; i < post_importer_plugins.size(); i++) {
-						post_importer_plugins.write[i]->internal_process(EditorScenePostImportPlugin::INTERNAL_IMPORT_CATEGORY_MESH, nullptr, src_mesh_node, src_mesh_node->get_mesh(), mesh_settings);
-					}
-				}
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_gather_mesh_tasks(p_node->get_child(i), p_mesh_data, p_defaults, r_task_indices, r_tasks);
+	}
+}
 
-				if (generate_lods) {
-					src_mesh_node->get_mesh()->generate_lods(merge_angle, split_angle);
-				}
+void ResourceImporterScene::_process_mesh_task(MeshTask &p_task, ThreadWorkPool *p_thread_pool) {
+	if (p_task.optimize) {
+		p_task.mesh->optimize_surfaces(p_thread_pool);
+	}
 
-				if (create_shadow_meshes) {
-					src_mesh_node->get_mesh()->create_shadow_mesh();
-				}
+	if (p_task.generate_lods) {
+		p_task.mesh->generate_lods(p_task.merge_angle, p_task.split_angle, p_thread_pool);
+	}
+
+	if (p_task.create_shadow_meshes) {
+		p_task.mesh->create_shadow_mesh();
+	}
+}
+
+void ResourceImporterScene::_process_mesh_task_threaded(uint32_t p_index, MeshTask *p_tasks) {
+	_process_mesh_task(p_tasks[p_index], nullptr);
+}
+
+void ResourceImporterScene::_generate_meshes(Node *p_node, const Map<Ref<ImporterMesh>, int> &p_task_indices, const LocalVector<MeshTask> &p_tasks, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches) {
+	ImporterMeshInstance3D *src_mesh_node = Object::cast_to<ImporterMeshInstance3D>(p_node);
+	if (src_mesh_node) {
+		//is mesh
+		MeshInstance3D *mesh_node = memnew(MeshInstance3D);
+		mesh_node->set_name(src_mesh_node->get_name());
+		mesh_node->set_transform(src_mesh_node->get_transform());
+		mesh_node->set_skin(src_mesh_node->get_skin());
+		mesh_node->set_skeleton_path(src_mesh_node->get_skeleton_path());
+		if (src_mesh_node->get_mesh().is_valid()) {
+			Ref<ArrayMesh> mesh;
+			if (!src_mesh_node->get_mesh()->has_mesh() && p_task_indices.has(src_mesh_node->get_mesh())) {
+				// Meshes were optimized and got their LODs and shadow meshes in _process_mesh_task().
+				const MeshTask &task = p_tasks[p_task_indices[src_mesh_node->get_mesh()]];
 
-				if (bake_lightmaps) {
+				if (task.bake_lightmaps) {
 					Transform3D xf;
 					Node3D *n = src_mesh_node;
 					while (n) {
@@ -1689,17 +1711,17 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_m
 					}
 				}
 
-				if (!save_to_file.is_empty()) {
-					Ref<Mesh> existing = Ref<Resource>(ResourceCache::get(save_to_file));
+				if (!task.save_to_file.is_empty()) {
+					Ref<Mesh> existing = Ref<Resource>(ResourceCache::get(task.save_to_file));
 					if (existing.is_valid()) {
 						//if somehow an existing one is useful, create
 						existing->reset_state();
 					}
 					mesh = src_mesh_node->get_mesh()->get_mesh(existing);
 
-					ResourceSaver::save(save_to_file, mesh); //override
+					ResourceSaver::save(task.save_to_file, mesh); //override
 
-					mesh->set_path(save_to_file, true); //takeover existing, if needed
+					mesh->set_path(task.save_to_file, true); //takeover existing, if needed
 
 				} else {
 					mesh = src_mesh_node->get_mesh()->get_mesh();
@@ -1735,7 +1757,7 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, const Dictionary &p_m
 	}
 
 	for (int i = 0; i < p_node->get_child_count(); i++) {
-		_generate_meshes(p_node->get_child(i), p_mesh_data, p_generate_lods, p_create_shadow_meshes, p_light_bake_mode, p_lightmap_texel_size, p_src_lightmap_cache, r_lightmap_caches);
+		_generate_meshes(p_node->get_child(i), p_task_indices, p_tasks, p_light_bake_mode, p_lightmap_texel_size, p_src_lightmap_cache, r_lightmap_caches);
 	}
 }
 
@@ -2063,8 +2085,6 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 		occluder_instance->set_owner(scene);
 	}
 
-	bool gen_lods = bool(p_options["meshes/generate_lods"]);
-	bool create_shadow_meshes = bool(p_options["meshes/create_shadow_meshes"]);
 	int light_bake_mode = p_options["meshes/light_baking"];
 	float texel_size = p_options["meshes/lightmap_texel_size"];
 	float lightmap_texel_size = MAX(0.001, texel_size);
@@ -2083,7 +2103,41 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 	if (subresources.has("meshes")) {
 		mesh_data = subresources["meshes"];
 	}
-	_generate_meshes(scene, mesh_data, gen_lods, create_shadow_meshes, LightBakeMode(light_bake_mode), lightmap_texel_size, src_lightmap_cache, mesh_lightmap_caches);
+
+	MeshTask mesh_defaults;
+	mesh_defaults.optimize = bool(p_options["meshes/optimize_surfaces"]);
+	mesh_defaults.generate_lods = bool(p_options["meshes/generate_lods"]);
+	mesh_defaults.create_shadow_meshes = bool(p_options["meshes/create_shadow_meshes"]);
+	mesh_defaults.bake_lightmaps = LightBakeMode(light_bake_mode) == LIGHT_BAKE_STATIC_LIGHTMAPS;
+
+	Map<Ref<ImporterMesh>, int> mesh_task_indices;
+	LocalVector<MeshTask> mesh_tasks;
+	_gather_mesh_tasks(scene, mesh_data, mesh_defaults, mesh_task_indices, mesh_tasks);
+
+	// Optimizing the meshes and generating LODs only touches each mesh's own data, so it can be spread over all cores.
+	// A single mesh spreads its surfaces and LOD levels instead.
+	if (mesh_tasks.size() > 0) {
+		ThreadWorkPool mesh_thread_pool;
+		if (GLOBAL_GET("editor/import/use_multiple_threads")) {
+			mesh_thread_pool.init();
+		} else {
+			mesh_thread_pool.init(1);
+		}
+
+		if (mesh_tasks.size() == 1) {
+			_process_mesh_task(mesh_tasks[0], &mesh_thread_pool);
+		} else if (mesh_thread_pool.get_thread_count() > 1) {
+			mesh_thread_pool.do_work(mesh_tasks.size(), this, &ResourceImporterScene::_process_mesh_task_threaded, mesh_tasks.ptr());
+		} else {
+			for (uint32_t i = 0; i < mesh_tasks.size(); i++) {
+				_process_mesh_task(mesh_tasks[i], nullptr);
+			}
+		}
+
+		mesh_thread_pool.finish();
+	}
+
+	_generate_meshes(scene, mesh_task_indices, mesh_tasks, LightBakeMode(light_bake_mode), lightmap_texel_size, src_lightmap_cache, mesh_lightmap_caches);
 
 	if (mesh_lightmap_caches.size()) {
 		FileAccessRef f = FileAccess::open(p_source_file + ".unwrap_cache", FileAccess::WRITE);
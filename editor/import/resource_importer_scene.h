@@ -33,6 +33,7 @@
 
 #include "core/error/error_macros.h"
 #include "core/io/resource_importer.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/dictionary.h"
 #include "scene/3d/node_3d.h"
 #include "scene/resources/animation.h"
@@ -44,6 +45,7 @@ class Material;
 class AnimationPlayer;
 
 class ImporterMesh;
+class ThreadWorkPool;
 class EditorSceneFormatImporter : public RefCounted {
 	GDCLASS(EditorSceneFormatImporter, RefCounted);
 
@@ -207,7 +209,22 @@ class ResourceImporterScene : public ResourceImporter {
 	};
 
 	void _replace_owner(Node *p_node, Node *p_scene, Node *p_new_owner);
-	void _generate_meshes(Node *p_node, const Dictionary &p_mesh_data, bool p_generate_lods, bool p_create_shadow_meshes, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches);
+
+	struct MeshTask {
+		Ref<ImporterMesh> mesh;
+		bool optimize = false;
+		bool generate_lods = false;
+		bool create_shadow_meshes = false;
+		bool bake_lightmaps = false;
+		float split_angle = 25.0f;
+		float merge_angle = 60.0f;
+		String save_to_file;
+	};
+
+	void _gather_mesh_tasks(Node *p_node, const Dictionary &p_mesh_data, const MeshTask &p_defaults, Map<Ref<ImporterMesh>, int> &r_task_indices, LocalVector<MeshTask> &r_tasks);
+	void _process_mesh_task(MeshTask &p_task, ThreadWorkPool *p_thread_pool);
+	void _process_mesh_task_threaded(uint32_t p_index, MeshTask *p_tasks);
+	void _generate_meshes(Node *p_node, const Map<Ref<ImporterMesh>, int> &p_task_indices, const LocalVector<MeshTask> &p_tasks, LightBakeMode p_light_bake_mode, float p_lightmap_texel_size, const Vector<uint8_t> &p_src_lightmap_cache, Vector<Vector<uint8_t>> &r_lightmap_caches);
 	void _add_shapes(Node *p_node, const Vector<Ref<Shape3D>> &p_shapes);
 
 	enum AnimationImportTracks {
@@ -281,6 +298,8 @@ public:
 	virtual bool has_advanced_options() const override;
 	virtual void show_advanced_options(const String &p_path) override;
 
+	// Post-import plugins are shared and keep the options of the call in progress, and post-import scripts and errors
+	// go through the editor, so scenes are imported one at a time. import() spreads mesh processing over a thread pool instead.
 	virtual bool can_import_threaded() const override { return false; }
 
 	ResourceImporterScene();
@@ -0,0 +1,75 @@
+/*************************************************************************/
+/*  hlod_group_3d_editor_plugin.cpp                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "hlod_group_3d_editor_plugin.h"
+
+#include "editor/editor_node.h"
+
+void HLODGroup3DEditorPlugin::_bake() {
+	if (!hlod_group) {
+		return;
+	}
+
+	HLODGroup3D::BakeError err = hlod_group->bake();
+	if (err == HLODGroup3D::BAKE_ERROR_NO_MESHES) {
+		EditorNode::get_singleton()->show_warning(TTR("No meshes to bake.\nMake sure there are enough static MeshInstance3D nodes below the HLODGroup3D to fill a cluster, and that their visual layers are part of its Bake Mask property."));
+	}
+}
+
+void HLODGroup3DEditorPlugin::edit(Object *p_object) {
+	HLODGroup3D *s = Object::cast_to<HLODGroup3D>(p_object);
+	if (!s) {
+		return;
+	}
+
+	hlod_group = s;
+}
+
+bool HLODGroup3DEditorPlugin::handles(Object *p_object) const {
+	return p_object->is_class("HLODGroup3D");
+}
+
+void HLODGroup3DEditorPlugin::make_visible(bool p_visible) {
+	if (p_visible) {
+		bake->show();
+	} else {
+		bake->hide();
+	}
+}
+
+HLODGroup3DEditorPlugin::HLODGroup3DEditorPlugin() {
+	bake = memnew(Button);
+	bake->set_flat(true);
+	bake->set_icon(EditorNode::get_singleton()->get_gui_base()->get_theme_icon(SNAME("Bake"), SNAME("EditorIcons")));
+	bake->set_text(TTR("Bake HLOD"));
+	bake->hide();
+	bake->connect("pressed", callable_mp(this, &HLODGroup3DEditorPlugin::_bake));
+	add_control_to_container(CONTAINER_SPATIAL_EDITOR_MENU, bake);
+}
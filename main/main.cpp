@@ -69,6 +69,7 @@
 #include "servers/physics_server_2d.h"
 #include "servers/physics_server_3d.h"
 #include "servers/register_server_types.h"
+#include "servers/rendering/rendering_device_recorder.h"
 #include "servers/rendering/rendering_server_default.h"
 #include "servers/text_server.h"
 #include "servers/xr_server.h"
@@ -176,6 +177,7 @@ static int frame_delay = 0;
 static bool disable_render_loop = false;
 static int fixed_fps = -1;
 static bool print_fps = false;
+static String rd_trace_report_path;
 #ifdef TOOLS_ENABLED
 static bool dump_extension_api = false;
 #endif
@@ -357,11 +359,13 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  --fixed-fps <fps>                            Force a fixed number of frames per second. This setting disables real-time synchronization.\n");
 	OS::get_singleton()->print("  --print-fps                                  Print the frames per second to the stdout.\n");
 	OS::get_singleton()->print("  --profile-gpu                                Show a simple profile of the tasks that took more time during frame rendering.\n");
+	OS::get_singleton()->print("  --rd-trace <file>                            Save every RenderingDevice command to <file> (use with '--headless --rendering-driver recorder').\n");
 	OS::get_singleton()->print("\n");
 
 	OS::get_singleton()->print("Standalone tools:\n");
 	OS::get_singleton()->print("  -s, --script <script>                        Run a script.\n");
 	OS::get_singleton()->print("  --check-only                                 Only parse for errors and quit (use with --script).\n");
+	OS::get_singleton()->print("  --rd-trace-report <file>                     Replay a RenderingDevice trace and print its draw, state change, barrier and CPU time statistics.\n");
 #ifdef TOOLS_ENABLED
 	OS::get_singleton()->print("  --export <preset> <path>                     Export the project using the given preset and matching release template. The preset name should match one defined in export_presets.cfg.\n");
 	OS::get_singleton()->print("                                               <path> should be absolute or relative to the project directory, and include the filename for the binary (e.g. 'builds/game.exe'). The target directory should exist.\n");
@@ -401,6 +405,7 @@ Error Main::test_setup() {
 	GLOBAL_DEF("debug/settings/crash_handler/message",
 			String("Please include this when reporting the bug on https://github.com/godotengine/godot/issues"));
 	GLOBAL_DEF_RST("rendering/occlusion_culling/bvh_build_quality", 2);
+	GLOBAL_DEF_RST("rendering/occlusion_culling/use_software_rasterizer", false);
 
 	translation_server = memnew(TranslationServer);
 	tsman = memnew(TextServerManager);
@@ -1097,6 +1102,26 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			print_fps = true;
 		} else if (I->get() == "--profile-gpu") {
 			profile_gpu = true;
+		} else if (I->get() == "--rd-trace") {
+			if (I->next()) {
+				RenderingDeviceRecorder::set_trace_path(I->next()->get());
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing RenderingDevice trace file argument, aborting.\n");
+				goto error;
+			}
+		} else if (I->get() == "--rd-trace-report") {
+			if (I->next()) {
+				// Actually handling is done in start(), headless as nothing is rendered.
+				rd_trace_report_path = I->next()->get();
+				cmdline_tool = true;
+				audio_driver = "Dummy";
+				display_driver = "headless";
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing RenderingDevice trace file argument, aborting.\n");
+				goto error;
+			}
 		} else if (I->get() == "--disable-crash-handler") {
 			OS::get_singleton()->disable_crash_handler();
 		} else if (I->get() == "--skip-breakpoints") {
@@ -2151,6 +2176,20 @@ bool Main::start() {
 	}
 #endif
 
+	if (!rd_trace_report_path.is_empty()) {
+		LocalVector<RenderingDeviceRecorder::Command> trace;
+		if (RenderingDeviceRecorder::load_trace(rd_trace_report_path, trace) != OK) {
+			return false; // The error was already printed, exit code stays EXIT_FAILURE.
+		}
+
+		RenderingDeviceRecorder::Stats stats;
+		RenderingDeviceRecorder::replay_trace(trace, stats);
+		RenderingDeviceRecorder::print_stats(stats);
+
+		OS::get_singleton()->set_exit_code(EXIT_SUCCESS);
+		return false;
+	}
+
 	if (script.is_empty() && game_path.is_empty() && String(GLOBAL_GET("application/run/main_scene")) != "") {
 		game_path = GLOBAL_GET("application/run/main_scene");
 	}
@@ -31,6 +31,7 @@
 #include "godot_navigation_server.h"
 
 #include "core/os/mutex.h"
+#include "core/os/os.h"
 
 #ifndef _3D_DISABLED
 #include "navigation_mesh_generator.h"
@@ -109,12 +110,19 @@
 	}                                                                              \
 	void GodotNavigationServer::MERGE(_cmd_, F_NAME)(T_0 D_0, T_1 D_1, T_2 D_2, T_3 D_3)
 
+// Path queries given to each worker thread at once.
+#define PATH_QUERY_BATCH_PER_THREAD 4
+// Number of `process` calls the results of the path queries are kept for, if they aren't polled.
+#define PATH_QUERY_RESULT_LIFETIME 600
+
 GodotNavigationServer::GodotNavigationServer() :
 		NavigationServer3D() {
+	path_query_pool.init();
 }
 
 GodotNavigationServer::~GodotNavigationServer() {
 	flush_queries();
+	path_query_pool.finish();
 }
 
 void GodotNavigationServer::add_command(SetCommand *command) const {
@@ -200,6 +208,34 @@ real_t GodotNavigationServer::map_get_edge_connection_margin(RID p_map) const {
 	return map->get_edge_connection_margin();
 }
 
+COMMAND_2(map_set_use_hierarchical_paths, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_COND(map == nullptr);
+
+	map->set_use_hierarchical_paths(p_enabled);
+}
+
+bool GodotNavigationServer::map_get_use_hierarchical_paths(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_COND_V(map == nullptr, false);
+
+	return map->get_use_hierarchical_paths();
+}
+
+COMMAND_2(map_set_avoidance_callback, RID, p_map, Callable, p_callback) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_COND(map == nullptr);
+
+	map->set_avoidance_callback(p_callback);
+}
+
+Callable GodotNavigationServer::map_get_avoidance_callback(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_COND_V(map == nullptr, Callable());
+
+	return map->get_avoidance_callback();
+}
+
 Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector<Vector3>());
@@ -207,6 +243,74 @@ Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin,
 	return map->get_path(p_origin, p_destination, p_optimize, p_layers);
 }
 
+int GodotNavigationServer::map_get_path_async(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, const Callable &p_callback, uint32_t p_layers) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+
+	PathQuery query;
+	query.id = ++mut_this->last_path_query_id;
+	query.map = p_map;
+	query.origin = p_origin;
+	query.destination = p_destination;
+	query.optimize = p_optimize;
+	query.layers = p_layers;
+	query.callback = p_callback;
+	mut_this->pending_path_queries.push_back(query);
+
+	return query.id;
+}
+
+bool GodotNavigationServer::path_query_is_done(int p_query) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+
+	return path_query_results.has(p_query);
+}
+
+Vector<Vector3> GodotNavigationServer::path_query_get_result(int p_query) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+
+	const PathQueryResult *result = path_query_results.getptr(p_query);
+	ERR_FAIL_COND_V_MSG(result == nullptr, Vector<Vector3>(), "The path query isn't done, or its result was already taken, cancelled or expired.");
+
+	Vector<Vector3> path = result->path;
+	mut_this->path_query_results.erase(p_query);
+	return path;
+}
+
+void GodotNavigationServer::path_query_cancel(int p_query) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+
+	if (mut_this->path_query_results.erase(p_query)) {
+		return;
+	}
+
+	for (List<PathQuery>::Element *E = mut_this->pending_path_queries.front(); E; E = E->next()) {
+		if (E->get().id == p_query) {
+			mut_this->pending_path_queries.erase(E);
+			return;
+		}
+	}
+
+	// The query may be in the batch being processed or waiting for its callback, it's dropped once it's done.
+	if (path_queries_in_flight) {
+		mut_this->cancelled_path_queries.insert(p_query);
+	}
+}
+
+void GodotNavigationServer::set_path_query_time_budget(real_t p_msec) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+
+	mut_this->path_query_time_budget_usec = MAX(p_msec, 0.0) * 1000.0;
+}
+
+real_t GodotNavigationServer::get_path_query_time_budget() const {
+	return path_query_time_budget_usec / 1000.0;
+}
+
 Vector3 GodotNavigationServer::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
@@ -304,6 +408,15 @@ void GodotNavigationServer::region_bake_navmesh(Ref<NavigationMesh> r_mesh, Node
 #endif
 }
 
+void GodotNavigationServer::region_bake_navmesh_tiles(Ref<NavigationMesh> r_mesh, Node *p_node, const AABB &p_area) const {
+	ERR_FAIL_COND(r_mesh.is_null());
+	ERR_FAIL_COND(p_node == nullptr);
+
+#ifndef _3D_DISABLED
+	NavigationMeshGenerator::get_singleton()->bake_tiles(r_mesh, p_node, p_area);
+#endif
+}
+
 int GodotNavigationServer::region_get_connections_count(RID p_region) const {
 	NavRegion *region = region_owner.get_or_null(p_region);
 	ERR_FAIL_COND_V(!region, 0);
@@ -354,10 +467,7 @@ COMMAND_2(agent_set_map, RID, p_agent, RID, p_map) {
 
 		agent->set_map(map);
 		map->add_agent(agent);
-
-		if (agent->has_callback()) {
-			map->set_agent_as_controlled(agent);
-		}
+		map->update_agent_control(agent);
 	}
 }
 
@@ -438,11 +548,18 @@ COMMAND_4(agent_set_callback, RID, p_agent, Object *, p_receiver, StringName, p_
 	agent->set_callback(p_receiver == nullptr ? ObjectID() : p_receiver->get_instance_id(), p_method, p_udata);
 
 	if (agent->get_map()) {
-		if (p_receiver == nullptr) {
-			agent->get_map()->remove_agent_as_controlled(agent);
-		} else {
-			agent->get_map()->set_agent_as_controlled(agent);
-		}
+		agent->get_map()->update_agent_control(agent);
+	}
+}
+
+COMMAND_2(agent_set_avoidance_batched, RID, p_agent, bool, p_batched) {
+	RvoAgent *agent = agent_owner.get_or_null(p_agent);
+	ERR_FAIL_COND(agent == nullptr);
+
+	agent->set_batched(p_batched);
+
+	if (agent->get_map()) {
+		agent->get_map()->update_agent_control(agent);
 	}
 }
 
@@ -464,6 +581,8 @@ COMMAND_1(free, RID, p_object) {
 			agents[i]->set_map(nullptr);
 		}
 
+		_erase_map_path_queries(p_object);
+
 		int map_index = active_maps.find(map);
 		active_maps.remove_at(map_index);
 		active_maps_update_id.remove_at(map_index);
@@ -514,6 +633,134 @@ void GodotNavigationServer::flush_queries() {
 	commands.clear();
 }
 
+void GodotNavigationServer::_process_path_query(uint32_t p_index, void *p_userdata) {
+	PathQuery &query = path_query_batch[p_index];
+	if (query.map_ptr) {
+		query.path = query.map_ptr->get_path(query.origin, query.destination, query.optimize, query.layers);
+	}
+}
+
+void GodotNavigationServer::_erase_map_path_queries(RID p_map) {
+	MutexLock lock(path_queries_mutex);
+
+	List<PathQuery>::Element *E = pending_path_queries.front();
+	while (E) {
+		List<PathQuery>::Element *N = E->next();
+		if (E->get().map == p_map) {
+			pending_path_queries.erase(E);
+		}
+		E = N;
+	}
+
+	LocalVector<int> erased;
+	for (const int *K = path_query_results.next(nullptr); K; K = path_query_results.next(K)) {
+		if (path_query_results[*K].map == p_map) {
+			erased.push_back(*K);
+		}
+	}
+	for (uint32_t i = 0; i < erased.size(); i++) {
+		path_query_results.erase(erased[i]);
+	}
+}
+
+void GodotNavigationServer::process_path_queries() {
+	// The maps are synced and the operations are locked, so the queries all see the same maps.
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	const uint32_t batch_size = MAX(path_query_pool.get_thread_count(), 1) * PATH_QUERY_BATCH_PER_THREAD;
+
+	{
+		MutexLock lock(path_queries_mutex);
+		path_query_frame++;
+
+		LocalVector<int> expired;
+		for (const int *K = path_query_results.next(nullptr); K; K = path_query_results.next(K)) {
+			if (path_query_results[*K].expire_frame < path_query_frame) {
+				expired.push_back(*K);
+			}
+		}
+		for (uint32_t i = 0; i < expired.size(); i++) {
+			path_query_results.erase(expired[i]);
+		}
+	}
+
+	while (true) {
+		path_query_batch.clear();
+		{
+			MutexLock lock(path_queries_mutex);
+			while (path_query_batch.size() < batch_size && !pending_path_queries.is_empty()) {
+				path_query_batch.push_back(pending_path_queries.front()->get());
+				pending_path_queries.pop_front();
+			}
+			path_queries_in_flight = !path_query_batch.is_empty() || !path_query_callbacks.is_empty();
+		}
+
+		if (path_query_batch.is_empty()) {
+			break;
+		}
+
+		for (uint32_t i = 0; i < path_query_batch.size(); i++) {
+			path_query_batch[i].map_ptr = map_owner.get_or_null(path_query_batch[i].map);
+			ERR_CONTINUE_MSG(path_query_batch[i].map_ptr == nullptr, "The map of the path query doesn't exist.");
+		}
+
+		path_query_pool.do_work(path_query_batch.size(), this, &GodotNavigationServer::_process_path_query, nullptr);
+
+		{
+			MutexLock lock(path_queries_mutex);
+			for (uint32_t i = 0; i < path_query_batch.size(); i++) {
+				PathQuery &query = path_query_batch[i];
+				if (cancelled_path_queries.erase(query.id)) {
+					continue;
+				}
+				if (query.callback.is_null()) {
+					PathQueryResult &result = path_query_results[query.id];
+					result.map = query.map;
+					result.path = query.path;
+					result.expire_frame = path_query_frame + PATH_QUERY_RESULT_LIFETIME;
+				} else {
+					path_query_callbacks.push_back(query);
+				}
+			}
+			path_queries_in_flight = !path_query_callbacks.is_empty();
+			if (!path_queries_in_flight) {
+				cancelled_path_queries.clear();
+			}
+		}
+
+		// The rest of the queries wait for the next frame.
+		if (OS::get_singleton()->get_ticks_usec() - begin_usec >= path_query_time_budget_usec) {
+			break;
+		}
+	}
+
+	path_query_batch.clear();
+}
+
+void GodotNavigationServer::dispatch_path_query_callbacks() {
+	for (uint32_t i = 0; i < path_query_callbacks.size(); i++) {
+		const PathQuery &query = path_query_callbacks[i];
+		{
+			// An earlier callback, or another thread, may have cancelled it.
+			MutexLock lock(path_queries_mutex);
+			if (cancelled_path_queries.erase(query.id)) {
+				continue;
+			}
+		}
+
+		Variant id = query.id;
+		Variant path = query.path;
+		const Variant *args[2] = { &id, &path };
+		Callable::CallError ce;
+		Variant ret;
+		query.callback.call(args, 2, ret, ce);
+	}
+	path_query_callbacks.clear();
+
+	MutexLock lock(path_queries_mutex);
+	cancelled_path_queries.clear();
+	path_queries_in_flight = false;
+}
+
 void GodotNavigationServer::process(real_t p_delta_time) {
 	flush_queries();
 
@@ -521,21 +768,28 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 		return;
 	}
 
-	// In c++ we can't be sure that this is performed in the main thread
-	// even with mutable functions.
-	MutexLock lock(operations_mutex);
-	for (uint32_t i(0); i < active_maps.size(); i++) {
-		active_maps[i]->sync();
-		active_maps[i]->step(p_delta_time);
-		active_maps[i]->dispatch_callbacks();
-
-		// Emit a signal if a map changed.
-		const uint32_t new_map_update_id = active_maps[i]->get_map_update_id();
-		if (new_map_update_id != active_maps_update_id[i]) {
-			emit_signal(SNAME("map_changed"), active_maps[i]->get_self());
-			active_maps_update_id[i] = new_map_update_id;
+	{
+		// In c++ we can't be sure that this is performed in the main thread
+		// even with mutable functions.
+		MutexLock lock(operations_mutex);
+		for (uint32_t i(0); i < active_maps.size(); i++) {
+			active_maps[i]->sync();
+			active_maps[i]->step(p_delta_time);
+			active_maps[i]->dispatch_callbacks();
+
+			// Emit a signal if a map changed.
+			const uint32_t new_map_update_id = active_maps[i]->get_map_update_id();
+			if (new_map_update_id != active_maps_update_id[i]) {
+				emit_signal(SNAME("map_changed"), active_maps[i]->get_self());
+				active_maps_update_id[i] = new_map_update_id;
+			}
 		}
+
+		process_path_queries();
 	}
+
+	// Without the lock, so the callbacks can call back into the server, from any thread.
+	dispatch_path_query_callbacks();
 }
 
 #undef COMMAND_1
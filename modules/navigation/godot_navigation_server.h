@@ -31,9 +31,13 @@
 #ifndef GODOT_NAVIGATION_SERVER_H
 #define GODOT_NAVIGATION_SERVER_H
 
+#include "core/templates/hash_map.h"
+#include "core/templates/list.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
+#include "core/templates/set.h"
+#include "core/templates/thread_work_pool.h"
 #include "servers/navigation_server_3d.h"
 
 #include "nav_map.h"
@@ -79,6 +83,50 @@ class GodotNavigationServer : public NavigationServer3D {
 	LocalVector<NavMap *> active_maps;
 	LocalVector<uint32_t> active_maps_update_id;
 
+	struct PathQuery {
+		int id = 0;
+		RID map;
+		Vector3 origin;
+		Vector3 destination;
+		bool optimize = false;
+		uint32_t layers = 1;
+		Callable callback;
+
+		// Set when the query is processed.
+		const NavMap *map_ptr = nullptr;
+		Vector<Vector3> path;
+	};
+
+	struct PathQueryResult {
+		RID map;
+		Vector<Vector3> path;
+		/// Path query frame after which the result is dropped if it wasn't polled.
+		uint64_t expire_frame = 0;
+	};
+
+	/// Mutex used to queue and poll the path queries from any thread.
+	Mutex path_queries_mutex;
+	int last_path_query_id = 0;
+	List<PathQuery> pending_path_queries;
+	/// Paths of the processed queries without callback, until they are polled or expire.
+	HashMap<int, PathQueryResult> path_query_results;
+	/// Queries cancelled while their batch was being processed or their callback was pending.
+	Set<int> cancelled_path_queries;
+	bool path_queries_in_flight = false;
+	uint64_t path_query_frame = 0;
+	uint64_t path_query_time_budget_usec = 2000;
+
+	/// Only used by `process`.
+	LocalVector<PathQuery> path_query_batch;
+	/// Processed queries with a callback, called once `operations_mutex` is released.
+	LocalVector<PathQuery> path_query_callbacks;
+	ThreadWorkPool path_query_pool;
+
+	void _process_path_query(uint32_t p_index, void *p_userdata);
+	void _erase_map_path_queries(RID p_map);
+	void process_path_queries();
+	void dispatch_path_query_callbacks();
+
 public:
 	GodotNavigationServer();
 	virtual ~GodotNavigationServer();
@@ -98,7 +146,18 @@ public:
 	COMMAND_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin);
 	virtual real_t map_get_edge_connection_margin(RID p_map) const;
 
+	COMMAND_2(map_set_use_hierarchical_paths, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_hierarchical_paths(RID p_map) const;
+	COMMAND_2(map_set_avoidance_callback, RID, p_map, Callable, p_callback);
+	virtual Callable map_get_avoidance_callback(RID p_map) const;
+
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
+	virtual int map_get_path_async(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, const Callable &p_callback = Callable(), uint32_t p_layers = 1) const;
+	virtual bool path_query_is_done(int p_query) const;
+	virtual void path_query_cancel(int p_query) const;
+	virtual Vector<Vector3> path_query_get_result(int p_query) const;
+	virtual void set_path_query_time_budget(real_t p_msec) const;
+	virtual real_t get_path_query_time_budget() const;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const;
@@ -112,6 +171,7 @@ public:
 	COMMAND_2(region_set_transform, RID, p_region, Transform3D, p_transform);
 	COMMAND_2(region_set_navmesh, RID, p_region, Ref<NavigationMesh>, p_nav_mesh);
 	virtual void region_bake_navmesh(Ref<NavigationMesh> r_mesh, Node *p_node) const;
+	virtual void region_bake_navmesh_tiles(Ref<NavigationMesh> r_mesh, Node *p_node, const AABB &p_area) const;
 	virtual int region_get_connections_count(RID p_region) const;
 	virtual Vector3 region_get_connection_pathway_start(RID p_region, int p_connection_id) const;
 	virtual Vector3 region_get_connection_pathway_end(RID p_region, int p_connection_id) const;
@@ -129,6 +189,7 @@ public:
 	COMMAND_2(agent_set_ignore_y, RID, p_agent, bool, p_ignore);
 	virtual bool agent_is_map_changed(RID p_agent) const;
 	COMMAND_4_DEF(agent_set_callback, RID, p_agent, Object *, p_receiver, StringName, p_method, Variant, p_udata, Variant());
+	COMMAND_2(agent_set_avoidance_batched, RID, p_agent, bool, p_batched);
 
 	COMMAND_1(free, RID, p_object);
 
@@ -0,0 +1,172 @@
+/*************************************************************************/
+/*  nav_agent_grid.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "nav_agent_grid.h"
+
+#include "rvo_agent.h"
+
+uint64_t NavAgentGrid::get_cell_key(int64_t p_x, int64_t p_z) const {
+	return (uint64_t(uint32_t(p_x)) << 32) | uint64_t(uint32_t(p_z));
+}
+
+uint64_t NavAgentGrid::get_agent_cell_key(const RvoAgent *p_agent) const {
+	const RVO::Vector3 &position = p_agent->get_agent()->position_;
+	return get_cell_key(int64_t(Math::floor(position.x() / cell_size)), int64_t(Math::floor(position.z() / cell_size)));
+}
+
+void NavAgentGrid::_insert(RvoAgent *p_agent, uint64_t p_cell) {
+	LocalVector<RvoAgent *> *cell = cells.getptr(p_cell);
+	if (!cell) {
+		cells.set(p_cell, LocalVector<RvoAgent *>());
+		cell = cells.getptr(p_cell);
+	}
+	p_agent->set_grid_location(p_cell, cell->size());
+	cell->push_back(p_agent);
+}
+
+void NavAgentGrid::_remove(RvoAgent *p_agent) {
+	LocalVector<RvoAgent *> *cell = cells.getptr(p_agent->get_grid_cell());
+	ERR_FAIL_COND(!cell);
+
+	const uint32_t slot = p_agent->get_grid_slot();
+	ERR_FAIL_COND(slot >= cell->size() || (*cell)[slot] != p_agent);
+
+	// Fill the hole with the last agent of the cell.
+	RvoAgent *last = (*cell)[cell->size() - 1];
+	(*cell)[slot] = last;
+	last->set_grid_location(p_agent->get_grid_cell(), slot);
+	cell->resize(cell->size() - 1);
+
+	if (cell->is_empty()) {
+		cells.erase(p_agent->get_grid_cell());
+	}
+	p_agent->clear_grid_location();
+}
+
+void NavAgentGrid::update(const std::vector<RvoAgent *> &p_agents) {
+	real_t max_neighbor_dist = 0.0;
+	for (size_t i = 0; i < p_agents.size(); i++) {
+		max_neighbor_dist = MAX(max_neighbor_dist, p_agents[i]->get_agent()->neighborDist_);
+	}
+	// Agents that don't look for neighbors still need sensible cells to be found by others.
+	max_neighbor_dist = MAX(max_neighbor_dist, real_t(0.1));
+
+	// Shrinking cells only pays off once they are far too large, this avoids
+	// rebuilding the grid back and forth when a neighbor distance changes a bit.
+	if (max_neighbor_dist > cell_size || max_neighbor_dist < cell_size * 0.5) {
+		clear();
+		cell_size = max_neighbor_dist;
+	}
+
+	for (size_t i = 0; i < p_agents.size(); i++) {
+		RvoAgent *agent = p_agents[i];
+		const uint64_t cell = get_agent_cell_key(agent);
+		if (!agent->is_in_grid()) {
+			_insert(agent, cell);
+		} else if (agent->get_grid_cell() != cell) {
+			_remove(agent);
+			_insert(agent, cell);
+		}
+	}
+}
+
+void NavAgentGrid::remove(RvoAgent *p_agent) {
+	if (p_agent->is_in_grid()) {
+		_remove(p_agent);
+	}
+}
+
+void NavAgentGrid::clear() {
+	const uint64_t *key = nullptr;
+	while ((key = cells.next(key))) {
+		const LocalVector<RvoAgent *> &cell = *cells.getptr(*key);
+		for (uint32_t i = 0; i < cell.size(); i++) {
+			cell[i]->clear_grid_location();
+		}
+	}
+	cells.clear();
+}
+
+void NavAgentGrid::compute_neighbors(RVO::Agent *p_agent) const {
+	p_agent->agentNeighbors_.clear();
+	if (p_agent->maxNeighbors_ == 0 || cells.is_empty()) {
+		return;
+	}
+
+	const float range = p_agent->neighborDist_;
+	float range_sq = range * range;
+
+	const RVO::Vector3 &position = p_agent->position_;
+	const int64_t begin_x = int64_t(Math::floor((position.x() - range) / cell_size));
+	const int64_t end_x = int64_t(Math::floor((position.x() + range) / cell_size));
+	const int64_t begin_z = int64_t(Math::floor((position.z() - range) / cell_size));
+	const int64_t end_z = int64_t(Math::floor((position.z() + range) / cell_size));
+
+	// The range is never larger than the cells, so it covers at most 3x3 cells.
+	struct CellQuery {
+		const LocalVector<RvoAgent *> *agents;
+		float distance_sq;
+	};
+	CellQuery queries[9];
+	uint32_t query_count = 0;
+
+	for (int64_t z = begin_z; z <= end_z; z++) {
+		for (int64_t x = begin_x; x <= end_x; x++) {
+			const LocalVector<RvoAgent *> *cell = cells.getptr(get_cell_key(x, z));
+			if (!cell || query_count == 9) {
+				continue;
+			}
+
+			// Distance from the agent to the closest point of the cell.
+			const float dx = MAX(MAX(x * cell_size - position.x(), position.x() - (x + 1) * cell_size), 0.0f);
+			const float dz = MAX(MAX(z * cell_size - position.z(), position.z() - (z + 1) * cell_size), 0.0f);
+			CellQuery query = { cell, dx * dx + dz * dz };
+
+			// Closest cells first, so `range_sq` shrinks before the far cells are visited.
+			uint32_t i = query_count++;
+			while (i > 0 && queries[i - 1].distance_sq > query.distance_sq) {
+				queries[i] = queries[i - 1];
+				i--;
+			}
+			queries[i] = query;
+		}
+	}
+
+	for (uint32_t i = 0; i < query_count; i++) {
+		if (queries[i].distance_sq >= range_sq) {
+			break;
+		}
+		const LocalVector<RvoAgent *> &cell = *queries[i].agents;
+		for (uint32_t j = 0; j < cell.size(); j++) {
+			// Skips itself, and narrows `range_sq` once `maxNeighbors_` are found.
+			p_agent->insertAgentNeighbor(cell[j]->get_agent(), range_sq);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+/*************************************************************************/
+/*  nav_agent_grid.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NAV_AGENT_GRID_H
+#define NAV_AGENT_GRID_H
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+#include <vector>
+
+class RvoAgent;
+
+namespace RVO {
+class Agent;
+}
+
+/// Uniform grid over the horizontal plane used to find the avoidance
+/// neighbors of the agents.
+///
+/// The cells are at least as large as the biggest neighbor distance, so a
+/// query only visits the cells next to the agent. The grid is updated in place
+/// every step: only the agents that crossed into another cell are moved.
+class NavAgentGrid {
+	HashMap<uint64_t, LocalVector<RvoAgent *>, HashMapHasherDefault, HashMapComparatorDefault<uint64_t>, 3, 1> cells;
+	real_t cell_size = 0.0;
+
+	uint64_t get_cell_key(int64_t p_x, int64_t p_z) const;
+	uint64_t get_agent_cell_key(const RvoAgent *p_agent) const;
+
+	void _insert(RvoAgent *p_agent, uint64_t p_cell);
+	void _remove(RvoAgent *p_agent);
+
+public:
+	/// Moves the agents that changed cell since the last update, and rebuilds
+	/// the grid when the neighbor distances outgrew the cells.
+	void update(const std::vector<RvoAgent *> &p_agents);
+	void remove(RvoAgent *p_agent);
+	void clear();
+
+	/// Fills the neighbors of the agent, same as `RVO::Agent::computeNeighbors()`.
+	void compute_neighbors(RVO::Agent *p_agent) const;
+};
+
+#endif // NAV_AGENT_GRID_H
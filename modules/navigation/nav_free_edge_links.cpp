@@ -0,0 +1,402 @@
+/*************************************************************************/
+/*  nav_free_edge_links.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "nav_free_edge_links.h"
+
+#include "core/math/aabb.h"
+#include "nav_region.h"
+
+uint64_t NavFreeEdgeLinks::get_cell_key(int64_t p_x, int64_t p_y, int64_t p_z) const {
+	return (uint64_t(p_x & 0x1FFFFF) << 42) | (uint64_t(p_y & 0x1FFFFF) << 21) | uint64_t(p_z & 0x1FFFFF);
+}
+
+uint64_t NavFreeEdgeLinks::get_point_cell_key(const Vector3 &p_point) const {
+	return get_cell_key(int64_t(Math::floor(p_point.x / cell_size)), int64_t(Math::floor(p_point.y / cell_size)), int64_t(Math::floor(p_point.z / cell_size)));
+}
+
+void NavFreeEdgeLinks::_insert_in_cell(uint32_t p_free_edge) {
+	FreeEdge &free_edge = free_edges[p_free_edge];
+	free_edge.cell = get_point_cell_key((free_edge.p1 + free_edge.p2) * 0.5);
+
+	LocalVector<uint32_t> *cell = cells.getptr(free_edge.cell);
+	if (!cell) {
+		cells.set(free_edge.cell, LocalVector<uint32_t>());
+		cell = cells.getptr(free_edge.cell);
+	}
+	free_edge.cell_slot = cell->size();
+	cell->push_back(p_free_edge);
+}
+
+void NavFreeEdgeLinks::_remove_from_cell(uint32_t p_free_edge) {
+	FreeEdge &free_edge = free_edges[p_free_edge];
+	LocalVector<uint32_t> *cell = cells.getptr(free_edge.cell);
+	ERR_FAIL_COND(!cell);
+	ERR_FAIL_COND(free_edge.cell_slot >= cell->size() || (*cell)[free_edge.cell_slot] != p_free_edge);
+
+	// Fill the hole with the last edge of the cell.
+	const uint32_t last = (*cell)[cell->size() - 1];
+	(*cell)[free_edge.cell_slot] = last;
+	free_edges[last].cell_slot = free_edge.cell_slot;
+	cell->resize(cell->size() - 1);
+
+	if (cell->is_empty()) {
+		cells.erase(free_edge.cell);
+	}
+	free_edge.cell_slot = UINT32_MAX;
+}
+
+void NavFreeEdgeLinks::_mark_relink(uint32_t p_free_edge) {
+	FreeEdge &free_edge = free_edges[p_free_edge];
+	if (!free_edge.relink) {
+		free_edge.relink = true;
+		relink_free_edges.push_back(p_free_edge);
+	}
+}
+
+void NavFreeEdgeLinks::_link_near_edge(uint32_t p_free_edge, uint32_t p_other_free_edge) {
+	const FreeEdge &free_edge = free_edges[p_free_edge];
+	const FreeEdge &other_edge = free_edges[p_other_free_edge];
+
+	const Vector3 &edge_p1 = free_edge.p1;
+	const Vector3 &edge_p2 = free_edge.p2;
+	const Vector3 &other_edge_p1 = other_edge.p1;
+	const Vector3 &other_edge_p2 = other_edge.p2;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > margin) {
+		return;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > margin) {
+		return;
+	}
+
+	// The edges can now be connected.
+	EdgeLink link;
+	link.from = p_free_edge;
+	link.to = p_other_free_edge;
+	link.pathway_start = (self1 + other1) / 2.0;
+	link.pathway_end = (self2 + other2) / 2.0;
+	links.push_back(link);
+}
+
+void NavFreeEdgeLinks::set_margin(real_t p_margin) {
+	if (margin == p_margin) {
+		return;
+	}
+	clear();
+	margin = p_margin;
+}
+
+void NavFreeEdgeLinks::add_region(const NavRegion *p_region) {
+	ERR_FAIL_COND_MSG(region_free_edges.has(p_region), "The free edges of the region were already added.");
+	const LocalVector<gd::Edge::Connection> &region_free_edges_list = p_region->get_free_edges();
+
+	const gd::Polygon *region_polygons = p_region->get_polygons().data();
+	LocalVector<uint32_t> ids;
+	ids.resize(region_free_edges_list.size());
+
+	for (uint32_t i = 0; i < region_free_edges_list.size(); i++) {
+		const gd::Edge::Connection &connection = region_free_edges_list[i];
+		const gd::Point &point_a = connection.polygon->points[connection.edge];
+		const gd::Point &point_b = connection.polygon->points[(connection.edge + 1) % connection.polygon->points.size()];
+
+		uint32_t id;
+		if (unused_free_edges.is_empty()) {
+			id = free_edges.size();
+			free_edges.push_back(FreeEdge());
+		} else {
+			id = unused_free_edges[unused_free_edges.size() - 1];
+			unused_free_edges.resize(unused_free_edges.size() - 1);
+			free_edges[id] = FreeEdge();
+		}
+
+		FreeEdge &free_edge = free_edges[id];
+		free_edge.region = p_region;
+		free_edge.polygon = connection.polygon - region_polygons;
+		free_edge.edge = connection.edge;
+		free_edge.key = gd::EdgeKey(point_a.key, point_b.key);
+		free_edge.p1 = point_a.pos;
+		free_edge.p2 = point_b.pos;
+		// Put in a cell by the update, once the cell size fits the longest edge.
+		free_edge.cell_slot = UINT32_MAX;
+		free_edge.alive = true;
+		max_edge_length = MAX(max_edge_length, point_a.pos.distance_to(point_b.pos));
+
+		LocalVector<uint32_t> *group = exact_groups.getptr(free_edge.key);
+		if (!group) {
+			exact_groups.set(free_edge.key, LocalVector<uint32_t>());
+			group = exact_groups.getptr(free_edge.key);
+		}
+		group->push_back(id);
+
+		ids[i] = id;
+		_mark_relink(id);
+	}
+
+	region_free_edges.insert(p_region, ids);
+}
+
+void NavFreeEdgeLinks::remove_region(const NavRegion *p_region) {
+	const Map<const NavRegion *, LocalVector<uint32_t>>::Element *region_element = region_free_edges.find(p_region);
+	if (!region_element) {
+		return;
+	}
+	const LocalVector<uint32_t> *ids = &region_element->get();
+
+	for (uint32_t i = 0; i < ids->size(); i++) {
+		const uint32_t id = (*ids)[i];
+		FreeEdge &free_edge = free_edges[id];
+		if (free_edge.cell_slot != UINT32_MAX) {
+			_remove_from_cell(id);
+		}
+
+		LocalVector<uint32_t> *group = exact_groups.getptr(free_edge.key);
+		ERR_CONTINUE(!group);
+		group->erase(id);
+
+		// The edge it matched, or the ones it conflicted with, may now be matched with others.
+		for (uint32_t j = 0; j < group->size(); j++) {
+			FreeEdge &other_edge = free_edges[(*group)[j]];
+			if (other_edge.exact_match == id || other_edge.exact_conflict) {
+				other_edge.exact_match = UINT32_MAX;
+				other_edge.exact_conflict = false;
+				_mark_relink((*group)[j]);
+			}
+		}
+		if (group->is_empty()) {
+			exact_groups.erase(free_edge.key);
+		}
+
+		// The links are removed by the next update, the id is reused after that.
+		free_edge.alive = false;
+		removed_free_edges.push_back(id);
+	}
+
+	region_free_edges.erase(p_region);
+}
+
+void NavFreeEdgeLinks::update() {
+	if (relink_free_edges.is_empty() && removed_free_edges.is_empty()) {
+		return;
+	}
+
+	// Each edge is only in the cell of its midpoint, so the cells must be as large as the longest edge.
+	const real_t min_cell_size = MAX(MAX(margin, max_edge_length), CMP_EPSILON);
+	if (min_cell_size > cell_size) {
+		cells.clear();
+		cell_size = min_cell_size;
+		for (uint32_t i = 0; i < free_edges.size(); i++) {
+			if (free_edges[i].alive) {
+				_insert_in_cell(i);
+			}
+		}
+	} else {
+		for (uint32_t i = 0; i < relink_free_edges.size(); i++) {
+			const uint32_t id = relink_free_edges[i];
+			if (free_edges[id].alive && free_edges[id].cell_slot == UINT32_MAX) {
+				_insert_in_cell(id);
+			}
+		}
+	}
+
+	// Match the edges shared by polygons of different regions. The edges
+	// matched this way are not connected to the near edges.
+	// Note: The list grows while it's iterated, with the edges whose match changed.
+	for (uint32_t i = 0; i < relink_free_edges.size(); i++) {
+		const uint32_t id = relink_free_edges[i];
+		FreeEdge &free_edge = free_edges[id];
+		if (!free_edge.alive || free_edge.exact_match != UINT32_MAX || free_edge.exact_conflict) {
+			continue;
+		}
+
+		const LocalVector<uint32_t> &group = *exact_groups.getptr(free_edge.key);
+		if (group.size() == 2) {
+			const uint32_t other = group[0] == id ? group[1] : group[0];
+			free_edge.exact_match = other;
+			free_edges[other].exact_match = id;
+			_mark_relink(other);
+		} else if (group.size() > 2) {
+			// The edge is already connected with another edge, skip.
+			// Only the first two edges are matched, the other ones aren't connected.
+			ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
+			for (uint32_t j = 0; j < group.size(); j++) {
+				free_edges[group[j]].exact_match = UINT32_MAX;
+				free_edges[group[j]].exact_conflict = true;
+				_mark_relink(group[j]);
+			}
+			free_edges[group[0]].exact_match = group[1];
+			free_edges[group[1]].exact_match = group[0];
+		}
+	}
+
+	// Drop the links of the removed edges and of the ones linked again.
+	uint32_t link_count = 0;
+	for (uint32_t i = 0; i < links.size(); i++) {
+		const FreeEdge &from = free_edges[links[i].from];
+		const FreeEdge &to = free_edges[links[i].to];
+		if (from.alive && to.alive && !from.relink && !to.relink) {
+			links[link_count++] = links[i];
+		}
+	}
+	links.resize(link_count);
+
+	for (uint32_t i = 0; i < relink_free_edges.size(); i++) {
+		const uint32_t id = relink_free_edges[i];
+		const FreeEdge &free_edge = free_edges[id];
+		if (!free_edge.alive || free_edge.exact_match == UINT32_MAX) {
+			continue;
+		}
+
+		// Note: The pathway_start/end are full for those connection and do not need to be modified.
+		const FreeEdge &other_edge = free_edges[free_edge.exact_match];
+		EdgeLink link;
+		link.from = id;
+		link.to = free_edge.exact_match;
+		link.pathway_start = other_edge.p1;
+		link.pathway_end = other_edge.p2;
+		link.exact = true;
+		links.push_back(link);
+	}
+
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	//
+	// An edge is near if it has points closer than the margin, so its
+	// midpoint is closer than the margin plus half its length.
+	const real_t query_margin = margin + max_edge_length * 0.5;
+	for (uint32_t i = 0; i < relink_free_edges.size(); i++) {
+		const uint32_t id = relink_free_edges[i];
+		const FreeEdge &free_edge = free_edges[id];
+		if (!free_edge.alive || free_edge.exact_match != UINT32_MAX || free_edge.exact_conflict) {
+			continue;
+		}
+
+		AABB query(free_edge.p1, Vector3());
+		query.expand_to(free_edge.p2);
+		query = query.grow(query_margin);
+		const Vector3 query_end = query.position + query.size;
+
+		const int64_t begin[3] = { int64_t(Math::floor(query.position.x / cell_size)), int64_t(Math::floor(query.position.y / cell_size)), int64_t(Math::floor(query.position.z / cell_size)) };
+		const int64_t end[3] = { int64_t(Math::floor(query_end.x / cell_size)), int64_t(Math::floor(query_end.y / cell_size)), int64_t(Math::floor(query_end.z / cell_size)) };
+
+		for (int64_t x = begin[0]; x <= end[0]; x++) {
+			for (int64_t y = begin[1]; y <= end[1]; y++) {
+				for (int64_t z = begin[2]; z <= end[2]; z++) {
+					const LocalVector<uint32_t> *cell = cells.getptr(get_cell_key(x, y, z));
+					if (cell == nullptr) {
+						continue;
+					}
+					for (uint32_t k = 0; k < cell->size(); k++) {
+						const uint32_t other = (*cell)[k];
+						const FreeEdge &other_edge = free_edges[other];
+						if (other_edge.region == free_edge.region || other_edge.exact_match != UINT32_MAX || other_edge.exact_conflict) {
+							continue;
+						}
+
+						_link_near_edge(id, other);
+						// The links from the other edge are made when it's relinked too.
+						if (!other_edge.relink) {
+							_link_near_edge(other, id);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < relink_free_edges.size(); i++) {
+		free_edges[relink_free_edges[i]].relink = false;
+	}
+	relink_free_edges.clear();
+
+	for (uint32_t i = 0; i < removed_free_edges.size(); i++) {
+		unused_free_edges.push_back(removed_free_edges[i]);
+	}
+	removed_free_edges.clear();
+}
+
+void NavFreeEdgeLinks::clear() {
+	cell_size = 0.0;
+	max_edge_length = 0.0;
+	free_edges.clear();
+	unused_free_edges.clear();
+	removed_free_edges.clear();
+	relink_free_edges.clear();
+	region_free_edges.clear();
+	cells.clear();
+	exact_groups.clear();
+	links.clear();
+}
+
+NavFreeEdgeLinks::Link NavFreeEdgeLinks::get_link(uint32_t p_index) const {
+	const EdgeLink &edge_link = links[p_index];
+	const FreeEdge &from = free_edges[edge_link.from];
+	const FreeEdge &to = free_edges[edge_link.to];
+
+	Link link;
+	link.region = from.region;
+	link.polygon = from.polygon;
+	link.edge = from.edge;
+	link.other_region = to.region;
+	link.other_polygon = to.polygon;
+	link.other_edge = to.edge;
+	link.pathway_start = edge_link.pathway_start;
+	link.pathway_end = edge_link.pathway_end;
+	link.exact = edge_link.exact;
+	return link;
+}
@@ -0,0 +1,150 @@
+/*************************************************************************/
+/*  nav_free_edge_links.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NAV_FREE_EDGE_LINKS_H
+#define NAV_FREE_EDGE_LINKS_H
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/map.h"
+#include "nav_utils.h"
+
+class NavRegion;
+
+/// Connections between the free edges of different regions.
+///
+/// The free edges and their links are kept between the syncs of the map, so
+/// only the free edges of the regions that changed are connected again.
+/// Edges with the same points are linked exactly, the other ones are matched
+/// with the edges closer than the margin using a grid where each edge is only
+/// in the cell of its midpoint.
+class NavFreeEdgeLinks {
+public:
+	/// Link from a free edge to the free edge of another region, the polygons
+	/// are indices in the polygons of their region.
+	struct Link {
+		const NavRegion *region = nullptr;
+		uint32_t polygon = 0;
+		uint32_t edge = 0;
+		const NavRegion *other_region = nullptr;
+		uint32_t other_polygon = 0;
+		uint32_t other_edge = 0;
+		Vector3 pathway_start;
+		Vector3 pathway_end;
+		/// Exact links join edges with the same points, they aren't region connections.
+		bool exact = false;
+	};
+
+private:
+	struct FreeEdge {
+		const NavRegion *region = nullptr;
+		uint32_t polygon = 0;
+		uint32_t edge = 0;
+		gd::EdgeKey key;
+		Vector3 p1;
+		Vector3 p2;
+		uint64_t cell = 0;
+		uint32_t cell_slot = UINT32_MAX;
+		/// Free edge with the same points, if any.
+		uint32_t exact_match = UINT32_MAX;
+		/// More than two edges have the same points, only the first two are matched.
+		bool exact_conflict = false;
+		bool alive = false;
+		/// Set while the links of the edge are being made again.
+		bool relink = false;
+	};
+
+	struct EdgeLink {
+		uint32_t from = 0;
+		uint32_t to = 0;
+		Vector3 pathway_start;
+		Vector3 pathway_end;
+		bool exact = false;
+	};
+
+	struct EdgeKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const gd::EdgeKey &p_key) {
+			return hash_djb2_one_64(p_key.b.key, hash_one_uint64(p_key.a.key));
+		}
+	};
+
+	real_t margin = -1.0;
+	/// At least as large as the margin and the longest edge, so a query only visits the cells next to the edge.
+	real_t cell_size = 0.0;
+	real_t max_edge_length = 0.0;
+
+	LocalVector<FreeEdge> free_edges;
+	LocalVector<uint32_t> unused_free_edges;
+	/// Removed edges, their ids are reused once their links are gone.
+	LocalVector<uint32_t> removed_free_edges;
+	/// Edges whose links are made again on the next update.
+	LocalVector<uint32_t> relink_free_edges;
+
+	Map<const NavRegion *, LocalVector<uint32_t>> region_free_edges;
+	HashMap<uint64_t, LocalVector<uint32_t>> cells;
+	HashMap<gd::EdgeKey, LocalVector<uint32_t>, EdgeKeyHasher> exact_groups;
+
+	LocalVector<EdgeLink> links;
+
+	uint64_t get_cell_key(int64_t p_x, int64_t p_y, int64_t p_z) const;
+	uint64_t get_point_cell_key(const Vector3 &p_point) const;
+
+	void _insert_in_cell(uint32_t p_free_edge);
+	void _remove_from_cell(uint32_t p_free_edge);
+	void _mark_relink(uint32_t p_free_edge);
+	void _link_near_edge(uint32_t p_free_edge, uint32_t p_other_free_edge);
+
+public:
+	real_t get_margin() const {
+		return margin;
+	}
+
+	/// Changing the margin removes all the free edges.
+	void set_margin(real_t p_margin);
+
+	/// Adds the free edges of the region, they are linked on the next update.
+	void add_region(const NavRegion *p_region);
+	/// Removes the free edges of the region and their links.
+	void remove_region(const NavRegion *p_region);
+	bool has_region(const NavRegion *p_region) const {
+		return region_free_edges.has(p_region);
+	}
+
+	/// Links the free edges added since the last update, and the ones that lost their exact match.
+	void update();
+	void clear();
+
+	uint32_t get_link_count() const {
+		return links.size();
+	}
+	Link get_link(uint32_t p_index) const;
+};
+
+#endif // NAV_FREE_EDGE_LINKS_H
@@ -31,6 +31,7 @@
 #include "nav_map.h"
 
 #include "core/os/threaded_array_processor.h"
+#include "core/templates/hash_map.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
 
@@ -38,6 +39,56 @@
 
 #define THREE_POINTS_CROSS_PRODUCT(m_a, m_b, m_c) (((m_c) - (m_a)).cross((m_b) - (m_a)))
 
+// State of a path search, kept per thread so the path queries reuse its memory.
+struct PathSearchState {
+	static const uint32_t INVALID_ID = UINT32_MAX;
+
+	std::vector<gd::NavigationPoly> navigation_polys;
+	gd::NavigationPolyHeap to_visit;
+
+	// Navigation poly id of each map polygon, valid when the polygon's search id is the current one.
+	// This avoids clearing the whole array for each search.
+	std::vector<uint32_t> polygon_navigation_ids;
+	std::vector<uint32_t> polygon_search_ids;
+	uint32_t search_id = 0;
+
+	// Clusters of the region graph the path goes through, when planned hierarchically.
+	// A cluster is in the corridor when its search id is the current one.
+	LocalVector<uint32_t> corridor;
+	std::vector<uint32_t> cluster_search_ids;
+
+	void begin(uint32_t p_polygon_count) {
+		navigation_polys.clear();
+		to_visit.clear();
+
+		if (polygon_search_ids.size() < p_polygon_count) {
+			polygon_navigation_ids.resize(p_polygon_count);
+			polygon_search_ids.resize(p_polygon_count, 0);
+		}
+
+		search_id++;
+		if (search_id == 0) {
+			// Wrapped around, forget the old searches.
+			std::fill(polygon_search_ids.begin(), polygon_search_ids.end(), 0);
+			search_id = 1;
+		}
+	}
+
+	uint32_t get_navigation_id(uint32_t p_polygon_index) const {
+		if (polygon_search_ids[p_polygon_index] != search_id) {
+			return INVALID_ID;
+		}
+		return polygon_navigation_ids[p_polygon_index];
+	}
+
+	void set_navigation_id(uint32_t p_polygon_index, uint32_t p_navigation_id) {
+		polygon_navigation_ids[p_polygon_index] = p_navigation_id;
+		polygon_search_ids[p_polygon_index] = search_id;
+	}
+};
+
+static thread_local PathSearchState path_search_state;
+
 void NavMap::set_up(Vector3 p_up) {
 	up = p_up;
 	regenerate_polygons = true;
@@ -48,6 +99,14 @@ void NavMap::set_cell_size(float p_cell_size) {
 	regenerate_polygons = true;
 }
 
+void NavMap::set_use_hierarchical_paths(bool p_enabled) {
+	if (use_hierarchical_paths == p_enabled) {
+		return;
+	}
+	use_hierarchical_paths = p_enabled;
+	regenerate_links = true;
+}
+
 void NavMap::set_edge_connection_margin(float p_edge_connection_margin) {
 	edge_connection_margin = p_edge_connection_margin;
 	regenerate_links = true;
@@ -68,42 +127,10 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 
 Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
 	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
 	Vector3 begin_point;
 	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_layers & p.owner->get_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			float distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
+	const gd::Polygon *begin_poly = get_closest_polygon(p_origin, p_layers, begin_point);
+	const gd::Polygon *end_poly = get_closest_polygon(p_destination, p_layers, end_point);
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
@@ -117,9 +144,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	PathSearchState &state = path_search_state;
+	state.begin(polygons.size());
+
 	// List of all reachable navigation polys.
-	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	std::vector<gd::NavigationPoly> &navigation_polys = state.navigation_polys;
 
 	// Add the start polygon to the reachable navigation polygons.
 	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
@@ -128,10 +157,27 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
 	navigation_polys.push_back(begin_navigation_poly);
+	state.set_navigation_id(begin_poly - polygons.data(), 0);
+
+	// Plan the path over the regions first, then only search the polygons of the regions on the way.
+	bool use_corridor = false;
+	if (use_hierarchical_paths && !region_graph.is_empty()) {
+		const uint32_t begin_polygon_index = begin_poly - polygons.data();
+		const uint32_t end_polygon_index = end_poly - polygons.data();
+		if (region_graph.get_polygon_cluster(begin_polygon_index) != region_graph.get_polygon_cluster(end_polygon_index) &&
+				region_graph.find_corridor(polygons, begin_polygon_index, end_polygon_index, end_point, p_layers, state.corridor)) {
+			if (state.cluster_search_ids.size() < region_graph.get_cluster_count()) {
+				state.cluster_search_ids.resize(region_graph.get_cluster_count(), 0);
+			}
+			for (uint32_t i = 0; i < state.corridor.size(); i++) {
+				state.cluster_search_ids[state.corridor[i]] = state.search_id;
+			}
+			use_corridor = true;
+		}
+	}
 
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
+	// Polygon IDs to visit, ordered by cost. The start polygon is visited first.
+	gd::NavigationPolyHeap &to_visit = state.to_visit;
 
 	// This is an implementation of the A* algorithm.
 	int least_cost_id = 0;
@@ -142,11 +188,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	bool is_reachable = true;
 
 	while (true) {
-		gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-
-		// Takes the current least_cost_poly neighbors (iterating over its edges) and compute the traveled_distance.
-		for (size_t i = 0; i < least_cost_poly->poly->edges.size(); i++) {
-			const gd::Edge &edge = least_cost_poly->poly->edges[i];
+		// Takes the current least cost poly neighbors (iterating over its edges) and compute the traveled_distance.
+		// Note: navigation_polys grows in the loop, so the least cost poly is accessed by id.
+		const gd::Polygon *least_cost_polygon = navigation_polys[least_cost_id].poly;
+		for (size_t i = 0; i < least_cost_polygon->edges.size(); i++) {
+			const gd::Edge &edge = least_cost_polygon->edges[i];
 
 			// Iterate over connections in this edge, then compute the new optimized travel distance assigned to this polygon.
 			for (int connection_index = 0; connection_index < edge.connections.size(); connection_index++) {
@@ -157,24 +203,33 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					continue;
 				}
 
+				// Stay in the regions planned on the region graph.
+				const uint32_t polygon_index = connection.polygon - polygons.data();
+				if (use_corridor && state.cluster_search_ids[region_graph.get_polygon_cluster(polygon_index)] != state.search_id) {
+					continue;
+				}
+
+				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
-				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly->entry, pathway);
-				const float new_distance = least_cost_poly->entry.distance_to(new_entry) + least_cost_poly->traveled_distance;
+				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
+				const float new_distance = least_cost_poly.entry.distance_to(new_entry) + least_cost_poly.traveled_distance;
 
-				const std::vector<gd::NavigationPoly>::iterator it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(connection.polygon));
+				const uint32_t navigation_id = state.get_navigation_id(polygon_index);
 
-				if (it != navigation_polys.end()) {
+				if (navigation_id != PathSearchState::INVALID_ID) {
 					// Polygon already visited, check if we can reduce the travel cost.
-					if (new_distance < it->traveled_distance) {
-						it->back_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = connection.edge;
-						it->back_navigation_edge_pathway_start = connection.pathway_start;
-						it->back_navigation_edge_pathway_end = connection.pathway_end;
-						it->traveled_distance = new_distance;
-						it->entry = new_entry;
+					gd::NavigationPoly &visited = navigation_polys[navigation_id];
+					if (new_distance < visited.traveled_distance) {
+						visited.back_navigation_poly_id = least_cost_id;
+						visited.back_navigation_edge = connection.edge;
+						visited.back_navigation_edge_pathway_start = connection.pathway_start;
+						visited.back_navigation_edge_pathway_end = connection.pathway_end;
+						visited.traveled_distance = new_distance;
+						visited.entry = new_entry;
+
+						if (to_visit.has(navigation_id)) {
+							to_visit.update(navigation_id, new_distance + new_entry.distance_to(end_point));
+						}
 					}
 				} else {
 					// Add the neighbour polygon to the reachable ones.
@@ -187,18 +242,32 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					new_navigation_poly.traveled_distance = new_distance;
 					new_navigation_poly.entry = new_entry;
 					navigation_polys.push_back(new_navigation_poly);
+					state.set_navigation_id(polygon_index, new_navigation_poly.self_id);
 
 					// Add the neighbour polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
+					to_visit.push(new_navigation_poly.self_id, new_distance + new_entry.distance_to(end_point));
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
-
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
+		if (to_visit.is_empty()) {
+			if (use_corridor) {
+				// The end isn't reachable in the planned regions, search the whole map.
+				use_corridor = false;
+
+				gd::NavigationPoly np = navigation_polys[0];
+				state.begin(polygons.size());
+				navigation_polys.push_back(np);
+				state.set_navigation_id(np.poly - polygons.data(), 0);
+				least_cost_id = 0;
+
+				reachable_end = nullptr;
+				reachable_d = 1e30;
+
+				continue;
+			}
+
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -209,7 +278,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Set as end point the furthest reachable point.
 			end_poly = reachable_end;
-			end_d = 1e20;
+			float end_d = 1e20;
 			for (size_t point_id = 2; point_id < end_poly->points.size(); point_id++) {
 				Face3 f(end_poly->points[0].pos, end_poly->points[point_id - 1].pos, end_poly->points[point_id].pos);
 				Vector3 spoint = f.get_closest_point_to(p_destination);
@@ -222,28 +291,18 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Reset open and navigation_polys
 			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
+			state.begin(polygons.size());
 			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
+			state.set_navigation_id(np.poly - polygons.data(), 0);
+			least_cost_id = 0;
 
 			reachable_end = nullptr;
 
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-			cost += np->entry.distance_to(end_point);
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
+		// Take the polygon with the minimum cost from the polygons to visit.
+		least_cost_id = to_visit.pop();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -254,8 +313,6 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			found_route = true;
@@ -363,50 +420,69 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
-	bool use_collision = p_use_collision;
-	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
+	// The polygons are flat, give their boxes some thickness so the segment can't slip past them.
+	const real_t margin = cell_size * 0.5;
 
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	// Find the intersection with the navigation mesh closest to the start of the segment.
+	Vector3 closest_point;
+	real_t closest_point_ds = 1e20;
 
-		// For each face check the distance to the segment
+	const auto intersection_lower_bound = [&](const AABB &p_aabb) -> real_t {
+		Vector3 clip;
+		if (p_aabb.grow(margin).intersects_segment(p_from, p_to, &clip)) {
+			return clip.distance_squared_to(p_from);
+		}
+		return 1e30;
+	};
+	auto visit_intersections = [&](const gd::Polygon &p) {
 		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
 			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
 			Vector3 inters;
 			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
+				const real_t ds = p_from.distance_squared_to(inters);
+				if (ds < closest_point_ds) {
 					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
+					closest_point_ds = ds;
 				}
 			}
 		}
+	};
+	query_polygons(intersection_lower_bound, visit_intersections, closest_point_ds);
 
-		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
-				Vector3 a, b;
-
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
-						a,
-						b);
-
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_d) {
-					closest_point_d = d;
-					closest_point = b;
-				}
+	if (closest_point_ds < 1e20 || p_use_collision) {
+		return closest_point;
+	}
+
+	// No intersection, find the point of the polygon outlines closest to the segment.
+	real_t closest_point_d = 1e20;
+
+	const Vector3 segment[2] = { p_from, p_to };
+	const auto edge_lower_bound = [&](const AABB &p_aabb) -> real_t {
+		// Distance to the bounding sphere of the box.
+		const Vector3 center = p_aabb.get_center();
+		const real_t d = center.distance_to(Geometry3D::get_closest_point_to_segment(center, segment)) - p_aabb.size.length() * 0.5;
+		return MAX(d, 0.0);
+	};
+	auto visit_edges = [&](const gd::Polygon &p) {
+		for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
+			Vector3 a, b;
+
+			Geometry3D::get_closest_points_between_segments(
+					p_from,
+					p_to,
+					p.points[point_id].pos,
+					p.points[(point_id + 1) % p.points.size()].pos,
+					a,
+					b);
+
+			const real_t d = a.distance_to(b);
+			if (d < closest_point_d) {
+				closest_point_d = d;
+				closest_point = b;
 			}
 		}
-	}
+	};
+	query_polygons(edge_lower_bound, visit_edges, closest_point_d);
 
 	return closest_point;
 }
@@ -430,9 +506,10 @@ gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_poin
 	gd::ClosestPointQueryResult result;
 	real_t closest_point_ds = 1e20;
 
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
+	const auto lower_bound = [&](const AABB &p_aabb) {
+		return NavPolygonTree::get_aabb_distance_squared(p_aabb, p_point);
+	};
+	auto visit = [&](const gd::Polygon &p) {
 		// For each face check the distance to the point
 		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
 			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
@@ -445,11 +522,72 @@ gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_poin
 				closest_point_ds = ds;
 			}
 		}
-	}
+	};
+	query_polygons(lower_bound, visit, closest_point_ds);
 
 	return result;
 }
 
+template <class LowerBound, class Visit>
+void NavMap::query_polygons(const LowerBound &p_lower_bound, Visit &p_visit, real_t &r_best) const {
+	auto visit_region = [&](uint32_t p_region_index) {
+		const uint32_t offset = tree_region_offsets[p_region_index];
+		auto visit_polygon = [&](uint32_t p_polygon_index) {
+			p_visit(polygons[offset + p_polygon_index]);
+		};
+		tree_regions[p_region_index]->get_polygon_tree().query_nearest(p_lower_bound, visit_polygon, r_best);
+	};
+	region_tree.query_nearest(p_lower_bound, visit_region, r_best);
+}
+
+const gd::Polygon *NavMap::get_closest_polygon(const Vector3 &p_point, uint32_t p_layers, Vector3 &r_closest_point) const {
+	const gd::Polygon *closest_polygon = nullptr;
+	real_t closest_point_ds = 1e20;
+
+	const auto lower_bound = [&](const AABB &p_aabb) {
+		return NavPolygonTree::get_aabb_distance_squared(p_aabb, p_point);
+	};
+	auto visit = [&](const gd::Polygon &p) {
+		// Only consider the polygon if it in a region with compatible layers.
+		if ((p_layers & p.owner->get_layers()) == 0) {
+			return;
+		}
+
+		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
+			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+			const Vector3 point = face.get_closest_point_to(p_point);
+			const real_t ds = point.distance_squared_to(p_point);
+			if (ds < closest_point_ds) {
+				closest_point_ds = ds;
+				closest_polygon = &p;
+				r_closest_point = point;
+			}
+		}
+	};
+	query_polygons(lower_bound, visit, closest_point_ds);
+
+	return closest_polygon;
+}
+
+void NavMap::update_region_tree() {
+	tree_regions.clear();
+	tree_region_offsets.clear();
+
+	LocalVector<AABB> region_aabbs;
+	uint32_t offset = 0;
+	for (size_t r(0); r < regions.size(); r++) {
+		const NavPolygonTree &polygon_tree = regions[r]->get_polygon_tree();
+		if (!polygon_tree.is_empty()) {
+			tree_regions.push_back(regions[r]);
+			tree_region_offsets.push_back(offset);
+			region_aabbs.push_back(polygon_tree.get_bounds());
+		}
+		offset += regions[r]->get_polygons().size();
+	}
+
+	region_tree.build(region_aabbs);
+}
+
 void NavMap::add_region(NavRegion *p_region) {
 	regions.push_back(p_region);
 	regenerate_links = true;
@@ -459,6 +597,7 @@ void NavMap::remove_region(NavRegion *p_region) {
 	const std::vector<NavRegion *>::iterator it = std::find(regions.begin(), regions.end(), p_region);
 	if (it != regions.end()) {
 		regions.erase(it);
+		free_edge_links.remove_region(p_region);
 		regenerate_links = true;
 	}
 }
@@ -470,7 +609,6 @@ bool NavMap::has_agent(RvoAgent *agent) const {
 void NavMap::add_agent(RvoAgent *agent) {
 	if (!has_agent(agent)) {
 		agents.push_back(agent);
-		agents_dirty = true;
 	}
 }
 
@@ -479,7 +617,7 @@ void NavMap::remove_agent(RvoAgent *agent) {
 	const std::vector<RvoAgent *>::iterator it = std::find(agents.begin(), agents.end(), agent);
 	if (it != agents.end()) {
 		agents.erase(it);
-		agents_dirty = true;
+		agent_grid.remove(agent);
 	}
 }
 
@@ -488,6 +626,7 @@ void NavMap::set_agent_as_controlled(RvoAgent *agent) {
 	if (!exist) {
 		ERR_FAIL_COND(!has_agent(agent));
 		controlled_agents.push_back(agent);
+		batched_agents_dirty = true;
 	}
 }
 
@@ -495,7 +634,21 @@ void NavMap::remove_agent_as_controlled(RvoAgent *agent) {
 	const std::vector<RvoAgent *>::iterator it = std::find(controlled_agents.begin(), controlled_agents.end(), agent);
 	if (it != controlled_agents.end()) {
 		controlled_agents.erase(it);
+		batched_agents_dirty = true;
+	}
+}
+
+void NavMap::update_agent_control(RvoAgent *agent) {
+	if (agent->is_controlled()) {
+		set_agent_as_controlled(agent);
+	} else {
+		remove_agent_as_controlled(agent);
 	}
+	batched_agents_dirty = true;
+}
+
+void NavMap::set_avoidance_callback(const Callable &p_callback) {
+	avoidance_callback = p_callback;
 }
 
 void NavMap::sync() {
@@ -507,9 +660,25 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	// The free edges of all the regions are linked again when their points
+	// or the margin changed, otherwise only the ones of the changed regions.
+	const bool relink_free_edges = regenerate_polygons || free_edge_links.get_margin() != edge_connection_margin;
+	if (relink_free_edges) {
+		free_edge_links.clear();
+		free_edge_links.set_margin(edge_connection_margin);
+	}
+
+	LocalVector<const NavRegion *> changed_regions;
 	for (size_t r(0); r < regions.size(); r++) {
-		if (regions[r]->sync()) {
+		if (regions[r]->sync() || !free_edge_links.has_region(regions[r])) {
+			changed_regions.push_back(regions[r]);
 			regenerate_links = true;
+			if (!relink_free_edges) {
+				free_edge_links.remove_region(regions[r]);
+			}
+			free_edge_links.add_region(regions[r]);
+		} else if (relink_free_edges) {
+			free_edge_links.add_region(regions[r]);
 		}
 	}
 
@@ -527,142 +696,72 @@ void NavMap::sync() {
 		polygons.resize(count);
 
 		// Copy all region polygons in the map.
+		// The polygons of a region are already connected to each other, only
+		// their connections are moved to the map polygons.
+		Map<const NavRegion *, uint32_t> region_offsets;
 		count = 0;
 		for (size_t r(0); r < regions.size(); r++) {
+			const std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
 			std::copy(
-					regions[r]->get_polygons().data(),
-					regions[r]->get_polygons().data() + regions[r]->get_polygons().size(),
+					region_polygons.data(),
+					region_polygons.data() + region_polygons.size(),
 					polygons.begin() + count);
-			count += regions[r]->get_polygons().size();
-		}
-
-		// Group all edges per key.
-		Map<gd::EdgeKey, Vector<gd::Edge::Connection>> connections;
-		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
-			gd::Polygon &poly(polygons[poly_id]);
 
-			for (size_t p(0); p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
-
-				Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
+			for (size_t poly_id(0); poly_id < region_polygons.size(); poly_id++) {
+				gd::Polygon &poly = polygons[count + poly_id];
+				for (size_t e(0); e < poly.edges.size(); e++) {
+					Vector<gd::Edge::Connection> &edge_connections = poly.edges[e].connections;
+					for (int c = 0; c < edge_connections.size(); c++) {
+						gd::Edge::Connection &connection = edge_connections.write[c];
+						connection.polygon = &polygons[count + (connection.polygon - region_polygons.data())];
+					}
 				}
 			}
-		}
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				free_edges.push_back(E.value[0]);
-			}
+			region_offsets[regions[r]] = count;
+			count += region_polygons.size();
 		}
 
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
-
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
-
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
-
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
+		update_region_tree();
 
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
+		// Connect the free edges of the different regions.
+		free_edge_links.update();
+		for (uint32_t i = 0; i < free_edge_links.get_link_count(); i++) {
+			const NavFreeEdgeLinks::Link link = free_edge_links.get_link(i);
+			gd::Polygon &poly = polygons[region_offsets[link.region] + link.polygon];
 
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+			gd::Edge::Connection connection;
+			connection.polygon = &polygons[region_offsets[link.other_region] + link.other_polygon];
+			connection.edge = link.other_edge;
+			connection.pathway_start = link.pathway_start;
+			connection.pathway_end = link.pathway_end;
+			poly.edges[link.edge].connections.push_back(connection);
 
-				// Add the connection to the region_connection map.
-				free_edge.polygon->owner->get_connections().push_back(new_connection);
+			// Add the connection of the near edges to the region_connection map.
+			if (!link.exact) {
+				poly.owner->get_connections().push_back(connection);
 			}
 		}
 
+		if (use_hierarchical_paths) {
+			region_graph.update(polygons, changed_regions);
+		} else {
+			region_graph.clear();
+		}
+
 		// Update the update ID.
 		map_update_id = (map_update_id + 1) % 9999999;
 	}
 
-	// Update agents tree.
-	if (agents_dirty) {
-		std::vector<RVO::Agent *> raw_agents;
-		raw_agents.reserve(agents.size());
-		for (size_t i(0); i < agents.size(); i++) {
-			raw_agents.push_back(agents[i]->get_agent());
-		}
-		rvo.buildAgentTree(raw_agents);
-	}
+	// The agents move every frame, only the ones that changed cell are moved in the grid.
+	agent_grid.update(agents);
 
 	regenerate_polygons = false;
 	regenerate_links = false;
-	agents_dirty = false;
 }
 
 void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
-	(*(agent + index))->get_agent()->computeNeighbors(&rvo);
+	agent_grid.compute_neighbors((*(agent + index))->get_agent());
 	(*(agent + index))->get_agent()->computeNewVelocity(deltatime);
 }
 
@@ -681,6 +780,41 @@ void NavMap::dispatch_callbacks() {
 	for (int i(0); i < static_cast<int>(controlled_agents.size()); i++) {
 		controlled_agents[i]->dispatch_callback();
 	}
+
+	if (avoidance_callback.is_null()) {
+		return;
+	}
+
+	if (batched_agents_dirty) {
+		// The previous array may be kept by the callback, don't modify it.
+		batched_agents.clear();
+		batched_agent_rids = Array();
+		for (size_t i(0); i < controlled_agents.size(); i++) {
+			if (controlled_agents[i]->is_batched()) {
+				batched_agents.push_back(controlled_agents[i]);
+				batched_agent_rids.push_back(controlled_agents[i]->get_self());
+			}
+		}
+		batched_agents_dirty = false;
+	}
+
+	if (batched_agents.is_empty()) {
+		return;
+	}
+
+	batched_velocities.resize(batched_agents.size());
+	Vector3 *velocities_ptrw = batched_velocities.ptrw();
+	for (uint32_t i = 0; i < batched_agents.size(); i++) {
+		const RVO::Vector3 &velocity = batched_agents[i]->get_agent()->newVelocity_;
+		velocities_ptrw[i] = Vector3(velocity.x(), velocity.y(), velocity.z());
+	}
+
+	Variant agents_variant = batched_agent_rids;
+	Variant velocities_variant = batched_velocities;
+	const Variant *args[2] = { &agents_variant, &velocities_variant };
+	Callable::CallError ce;
+	Variant ret;
+	avoidance_callback.call(args, 2, ret, ce);
 }
 
 void NavMap::clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const {
@@ -34,11 +34,16 @@
 #include "nav_rid.h"
 
 #include "core/math/math_defs.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/map.h"
+#include "core/variant/array.h"
+#include "core/variant/callable.h"
+#include "nav_agent_grid.h"
+#include "nav_free_edge_links.h"
+#include "nav_polygon_tree.h"
+#include "nav_region_graph.h"
 #include "nav_utils.h"
 
-#include <KdTree.h>
-
 class NavRegion;
 class RvoAgent;
 class NavRegion;
@@ -54,6 +59,9 @@ class NavMap : public NavRid {
 	/// This value is used to detect the near edges to connect.
 	real_t edge_connection_margin = 5.0;
 
+	/// Plan the paths between regions on the region graph first.
+	bool use_hierarchical_paths = false;
+
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
 
@@ -62,11 +70,21 @@ class NavMap : public NavRid {
 	/// Map polygons
 	std::vector<gd::Polygon> polygons;
 
-	/// Rvo world
-	RVO::KdTree rvo;
+	/// Links between the free edges of the regions, kept between the syncs.
+	NavFreeEdgeLinks free_edge_links;
+
+	/// Tree over the regions that have polygons, the items are indices in `tree_regions`.
+	/// Each region has its own tree over its polygons, so only the changed regions rebuild theirs.
+	NavPolygonTree region_tree;
+	LocalVector<const NavRegion *> tree_regions;
+	/// Index in `polygons` of the first polygon of each region in `tree_regions`.
+	LocalVector<uint32_t> tree_region_offsets;
 
-	/// Is agent array modified?
-	bool agents_dirty = false;
+	/// Abstract graph of the regions, only built when `use_hierarchical_paths` is set.
+	NavRegionGraph region_graph;
+
+	/// Grid used to find the avoidance neighbors of the agents.
+	NavAgentGrid agent_grid;
 
 	/// All the Agents (even the controlled one)
 	std::vector<RvoAgent *> agents;
@@ -74,6 +92,13 @@ class NavMap : public NavRid {
 	/// Controlled agents
 	std::vector<RvoAgent *> controlled_agents;
 
+	/// Called once per step with the new velocities of all the batched agents.
+	Callable avoidance_callback;
+	bool batched_agents_dirty = false;
+	LocalVector<RvoAgent *> batched_agents;
+	Array batched_agent_rids;
+	Vector<Vector3> batched_velocities;
+
 	/// Physics delta time
 	real_t deltatime = 0.0;
 
@@ -98,6 +123,11 @@ public:
 		return edge_connection_margin;
 	}
 
+	void set_use_hierarchical_paths(bool p_enabled);
+	bool get_use_hierarchical_paths() const {
+		return use_hierarchical_paths;
+	}
+
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
 	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
@@ -122,6 +152,13 @@ public:
 
 	void set_agent_as_controlled(RvoAgent *agent);
 	void remove_agent_as_controlled(RvoAgent *agent);
+	/// Controls the agent or not, depending on its callback and batching.
+	void update_agent_control(RvoAgent *agent);
+
+	void set_avoidance_callback(const Callable &p_callback);
+	Callable get_avoidance_callback() const {
+		return avoidance_callback;
+	}
 
 	uint32_t get_map_update_id() const {
 		return map_update_id;
@@ -132,6 +169,11 @@ public:
 	void dispatch_callbacks();
 
 private:
+	template <class LowerBound, class Visit>
+	void query_polygons(const LowerBound &p_lower_bound, Visit &p_visit, real_t &r_best) const;
+	const gd::Polygon *get_closest_polygon(const Vector3 &p_point, uint32_t p_layers, Vector3 &r_closest_point) const;
+	void update_region_tree();
+
 	void compute_single_step(uint32_t index, RvoAgent **agent);
 	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
@@ -0,0 +1,118 @@
+/*************************************************************************/
+/*  nav_polygon_tree.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "nav_polygon_tree.h"
+
+#include "core/templates/sort_array.h"
+
+void NavPolygonTree::clear() {
+	nodes.clear();
+	items.clear();
+}
+
+void NavPolygonTree::build(const LocalVector<AABB> &p_item_aabbs) {
+	clear();
+
+	const uint32_t item_count = p_item_aabbs.size();
+	if (item_count == 0) {
+		return;
+	}
+
+	LocalVector<Vector3> item_centers;
+	item_centers.resize(item_count);
+	items.resize(item_count);
+	for (uint32_t i = 0; i < item_count; i++) {
+		item_centers[i] = p_item_aabbs[i].get_center();
+		items[i] = i;
+	}
+
+	// A binary tree with at least one item per leaf never has more than 2n - 1 nodes.
+	nodes.reserve(item_count * 2);
+	nodes.push_back(Node());
+	_build(p_item_aabbs, item_centers, 0, 0, item_count, 0);
+}
+
+struct ItemCenterCompare {
+	const Vector3 *centers = nullptr;
+	int axis = 0;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return centers[p_a][axis] < centers[p_b][axis];
+	}
+};
+
+void NavPolygonTree::_build(const LocalVector<AABB> &p_item_aabbs, const LocalVector<Vector3> &p_item_centers, uint32_t p_node, uint32_t p_first, uint32_t p_count, uint32_t p_depth) {
+	AABB aabb = p_item_aabbs[items[p_first]];
+	AABB center_bounds(p_item_centers[items[p_first]], Vector3());
+	for (uint32_t i = p_first + 1; i < p_first + p_count; i++) {
+		aabb.merge_with(p_item_aabbs[items[i]]);
+		center_bounds.expand_to(p_item_centers[items[i]]);
+	}
+	nodes[p_node].aabb = aabb;
+
+	// The query stack grows by one entry per level, keep the depth bounded.
+	if (p_count <= MAX_LEAF_ITEMS || p_depth >= MAX_STACK_DEPTH / 2 - 1) {
+		nodes[p_node].first = p_first;
+		nodes[p_node].count = p_count;
+		return;
+	}
+
+	// Median split along the longest axis of the item centers.
+	const int axis = center_bounds.get_longest_axis_index();
+	const uint32_t half = p_count / 2;
+	SortArray<uint32_t, ItemCenterCompare> sorter;
+	sorter.compare.centers = p_item_centers.ptr();
+	sorter.compare.axis = axis;
+	sorter.nth_element(0, p_count, half, items.ptr() + p_first);
+
+	const uint32_t children = nodes.size();
+	nodes[p_node].first = children;
+	nodes[p_node].count = 0;
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+
+	_build(p_item_aabbs, p_item_centers, children, p_first, half, p_depth + 1);
+	_build(p_item_aabbs, p_item_centers, children + 1, p_first + half, p_count - half, p_depth + 1);
+}
+
+real_t NavPolygonTree::get_aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	real_t distance_squared = 0.0;
+	for (int i = 0; i < 3; i++) {
+		if (p_point[i] < p_aabb.position[i]) {
+			const real_t d = p_aabb.position[i] - p_point[i];
+			distance_squared += d * d;
+		} else if (p_point[i] > end[i]) {
+			const real_t d = p_point[i] - end[i];
+			distance_squared += d * d;
+		}
+	}
+	return distance_squared;
+}
@@ -0,0 +1,119 @@
+/*************************************************************************/
+/*  nav_polygon_tree.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NAV_POLYGON_TREE_H
+#define NAV_POLYGON_TREE_H
+
+#include "core/math/aabb.h"
+#include "core/templates/local_vector.h"
+
+/// Static bounding volume tree used to find the navigation polygons near a
+/// point or a segment without visiting all of them.
+///
+/// The tree stores item indices only, the owner keeps the items and tests them
+/// with the callbacks given to `query_nearest()`.
+class NavPolygonTree {
+	static const uint32_t MAX_LEAF_ITEMS = 4;
+	static const uint32_t MAX_STACK_DEPTH = 64;
+
+	struct Node {
+		AABB aabb;
+		/// First item of a leaf, or first of the two children of an internal node.
+		uint32_t first = 0;
+		/// Item count of a leaf, zero for internal nodes.
+		uint32_t count = 0;
+	};
+
+	LocalVector<Node> nodes;
+	LocalVector<uint32_t> items;
+
+	void _build(const LocalVector<AABB> &p_item_aabbs, const LocalVector<Vector3> &p_item_centers, uint32_t p_node, uint32_t p_first, uint32_t p_count, uint32_t p_depth);
+
+public:
+	void build(const LocalVector<AABB> &p_item_aabbs);
+	void clear();
+
+	bool is_empty() const { return nodes.is_empty(); }
+	AABB get_bounds() const { return nodes.is_empty() ? AABB() : nodes[0].aabb; }
+
+	/// Visits the items in increasing order of the lower bound returned by
+	/// `p_lower_bound(aabb)`, and stops once it reaches `r_best`.
+	/// `p_visit(item)` is expected to lower `r_best` when it finds a better result.
+	template <class LowerBound, class Visit>
+	void query_nearest(const LowerBound &p_lower_bound, Visit &p_visit, real_t &r_best) const;
+
+	/// Squared distance between a point and a box, zero if the point is inside.
+	static real_t get_aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point);
+};
+
+template <class LowerBound, class Visit>
+void NavPolygonTree::query_nearest(const LowerBound &p_lower_bound, Visit &p_visit, real_t &r_best) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	struct StackEntry {
+		uint32_t node;
+		real_t bound;
+	};
+	StackEntry stack[MAX_STACK_DEPTH];
+
+	uint32_t stack_size = 0;
+	stack[stack_size++] = { 0, p_lower_bound(nodes[0].aabb) };
+
+	while (stack_size > 0) {
+		const StackEntry entry = stack[--stack_size];
+		if (entry.bound >= r_best) {
+			continue;
+		}
+
+		const Node &node = nodes[entry.node];
+		if (node.count > 0) {
+			for (uint32_t i = node.first; i < node.first + node.count; i++) {
+				p_visit(items[i]);
+			}
+			continue;
+		}
+
+		const real_t bound_a = p_lower_bound(nodes[node.first].aabb);
+		const real_t bound_b = p_lower_bound(nodes[node.first + 1].aabb);
+
+		// Push the farthest child first so the nearest one is visited first.
+		if (bound_a < bound_b) {
+			stack[stack_size++] = { node.first + 1, bound_b };
+			stack[stack_size++] = { node.first, bound_a };
+		} else {
+			stack[stack_size++] = { node.first, bound_a };
+			stack[stack_size++] = { node.first + 1, bound_b };
+		}
+	}
+}
+
+#endif // NAV_POLYGON_TREE_H
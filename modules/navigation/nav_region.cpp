@@ -32,6 +32,8 @@
 
 #include "nav_map.h"
 
+#include <algorithm>
+
 void NavRegion::set_map(NavMap *p_map) {
 	map = p_map;
 	polygons_dirty = true;
@@ -90,6 +92,8 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	polygon_tree.clear();
+	free_edges.clear();
 	polygons_dirty = false;
 
 	if (map == nullptr) {
@@ -154,4 +158,87 @@ void NavRegion::update_polygons() {
 			p.center = center / float(mesh_poly.size());
 		}
 	}
+
+	LocalVector<AABB> polygon_aabbs;
+	polygon_aabbs.resize(polygons.size());
+	for (size_t i(0); i < polygons.size(); i++) {
+		const gd::Polygon &p = polygons[i];
+		AABB aabb;
+		if (!p.points.empty()) {
+			aabb.position = p.points[0].pos;
+			for (size_t j(1); j < p.points.size(); j++) {
+				aabb.expand_to(p.points[j].pos);
+			}
+		}
+		polygon_aabbs[i] = aabb;
+	}
+	polygon_tree.build(polygon_aabbs);
+
+	update_connections();
+}
+
+void NavRegion::update_connections() {
+	// Connect the edges shared by the polygons of this region here, so the map
+	// only has to connect the free edges when another region changes.
+	struct EdgeEntry {
+		gd::EdgeKey key;
+		uint32_t polygon;
+		uint32_t edge;
+
+		bool operator<(const EdgeEntry &p_other) const {
+			return key < p_other.key;
+		}
+	};
+
+	LocalVector<EdgeEntry> entries;
+	for (size_t i(0); i < polygons.size(); i++) {
+		const gd::Polygon &p = polygons[i];
+		for (size_t j(0); j < p.points.size(); j++) {
+			const size_t next_point = (j + 1) % p.points.size();
+			entries.push_back({ gd::EdgeKey(p.points[j].key, p.points[next_point].key), uint32_t(i), uint32_t(j) });
+		}
+	}
+	std::stable_sort(entries.ptr(), entries.ptr() + entries.size());
+
+	uint32_t group_begin = 0;
+	while (group_begin < entries.size()) {
+		uint32_t group_end = group_begin + 1;
+		while (group_end < entries.size() && !(entries[group_begin] < entries[group_end])) {
+			group_end++;
+		}
+
+		const EdgeEntry &entry = entries[group_begin];
+		gd::Polygon &poly = polygons[entry.polygon];
+
+		gd::Edge::Connection connection;
+		connection.polygon = &poly;
+		connection.edge = entry.edge;
+		connection.pathway_start = poly.points[entry.edge].pos;
+		connection.pathway_end = poly.points[(entry.edge + 1) % poly.points.size()].pos;
+
+		if (group_end - group_begin == 1) {
+			free_edges.push_back(connection);
+		} else {
+			// Connect edge that are shared in different polygons.
+			// Note: The pathway_start/end are full for those connection and do not need to be modified.
+			const EdgeEntry &other_entry = entries[group_begin + 1];
+			gd::Polygon &other_poly = polygons[other_entry.polygon];
+
+			gd::Edge::Connection other_connection;
+			other_connection.polygon = &other_poly;
+			other_connection.edge = other_entry.edge;
+			other_connection.pathway_start = other_poly.points[other_entry.edge].pos;
+			other_connection.pathway_end = other_poly.points[(other_entry.edge + 1) % other_poly.points.size()].pos;
+
+			poly.edges[entry.edge].connections.push_back(other_connection);
+			other_poly.edges[other_entry.edge].connections.push_back(connection);
+
+			if (group_end - group_begin > 2) {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
+			}
+		}
+
+		group_begin = group_end;
+	}
 }
@@ -33,6 +33,7 @@
 
 #include "scene/resources/navigation_mesh.h"
 
+#include "nav_polygon_tree.h"
 #include "nav_rid.h"
 #include "nav_utils.h"
 
@@ -53,6 +54,13 @@ class NavRegion : public NavRid {
 	/// Cache
 	std::vector<gd::Polygon> polygons;
 
+	/// Tree over the polygons, the items are indices in `polygons`.
+	NavPolygonTree polygon_tree;
+
+	/// Edges not shared by two polygons of this region, the map connects them
+	/// to the other regions. The polygons are the ones in `polygons`.
+	LocalVector<gd::Edge::Connection> free_edges;
+
 public:
 	NavRegion() {}
 
@@ -89,10 +97,19 @@ public:
 		return polygons;
 	}
 
+	const NavPolygonTree &get_polygon_tree() const {
+		return polygon_tree;
+	}
+
+	const LocalVector<gd::Edge::Connection> &get_free_edges() const {
+		return free_edges;
+	}
+
 	bool sync();
 
 private:
 	void update_polygons();
+	void update_connections();
 };
 
 #endif // NAV_REGION_H
@@ -0,0 +1,386 @@
+/*************************************************************************/
+/*  nav_region_graph.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "nav_region_graph.h"
+
+#include "core/templates/map.h"
+#include "nav_region.h"
+
+static const real_t UNREACHABLE_COST = 1e30;
+
+void NavRegionGraph::clear() {
+	clusters.clear();
+	portals.clear();
+	polygon_clusters.clear();
+	portal_polygons.clear();
+}
+
+void NavRegionGraph::update(const std::vector<gd::Polygon> &p_polygons, const LocalVector<const NavRegion *> &p_changed_regions) {
+	// Keep the previous costs around, most regions don't change between updates.
+	const LocalVector<Cluster> previous_clusters = clusters;
+	const LocalVector<Portal> previous_portals = portals;
+	Map<const NavRegion *, uint32_t> previous_cluster_ids;
+	for (uint32_t i = 0; i < previous_clusters.size(); i++) {
+		previous_cluster_ids[previous_clusters[i].region] = i;
+	}
+
+	clear();
+
+	const uint32_t polygon_count = p_polygons.size();
+	polygon_clusters.resize(polygon_count);
+	portal_polygons.resize(polygon_count);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		const NavRegion *owner = p_polygons[i].owner;
+		if (clusters.is_empty() || clusters[clusters.size() - 1].region != owner) {
+			Cluster cluster;
+			cluster.region = owner;
+			cluster.first_polygon = i;
+			clusters.push_back(cluster);
+		}
+		clusters[clusters.size() - 1].polygon_count++;
+		polygon_clusters[i] = clusters.size() - 1;
+		portal_polygons[i] = false;
+	}
+
+	// Place the portals, one for each neighbor cluster.
+	struct Boundary {
+		uint32_t neighbor_cluster;
+		uint32_t polygon;
+
+		bool operator<(const Boundary &p_other) const {
+			return neighbor_cluster == p_other.neighbor_cluster ? polygon < p_other.polygon : neighbor_cluster < p_other.neighbor_cluster;
+		}
+		bool operator==(const Boundary &p_other) const {
+			return neighbor_cluster == p_other.neighbor_cluster && polygon == p_other.polygon;
+		}
+	};
+	LocalVector<Boundary> boundaries;
+	LocalVector<uint32_t> portal_neighbor_clusters;
+
+	for (uint32_t cluster_id = 0; cluster_id < clusters.size(); cluster_id++) {
+		Cluster &cluster = clusters[cluster_id];
+
+		boundaries.clear();
+		for (uint32_t i = cluster.first_polygon; i < cluster.first_polygon + cluster.polygon_count; i++) {
+			const gd::Polygon &polygon = p_polygons[i];
+			for (size_t edge = 0; edge < polygon.edges.size(); edge++) {
+				const Vector<gd::Edge::Connection> &connections = polygon.edges[edge].connections;
+				for (int connection = 0; connection < connections.size(); connection++) {
+					const uint32_t neighbor_cluster = polygon_clusters[connections[connection].polygon - p_polygons.data()];
+					if (neighbor_cluster != cluster_id) {
+						boundaries.push_back({ neighbor_cluster, i });
+					}
+				}
+			}
+		}
+		boundaries.sort();
+		uint32_t boundary_count = 0;
+		for (uint32_t i = 0; i < boundaries.size(); i++) {
+			if (boundary_count == 0 || !(boundaries[i] == boundaries[boundary_count - 1])) {
+				boundaries[boundary_count++] = boundaries[i];
+			}
+		}
+
+		cluster.first_portal = portals.size();
+		uint32_t group_begin = 0;
+		while (group_begin < boundary_count) {
+			const uint32_t neighbor_cluster = boundaries[group_begin].neighbor_cluster;
+			uint32_t group_end = group_begin + 1;
+			AABB group_bounds(p_polygons[boundaries[group_begin].polygon].center, Vector3());
+			while (group_end < boundary_count && boundaries[group_end].neighbor_cluster == neighbor_cluster) {
+				group_bounds.expand_to(p_polygons[boundaries[group_end].polygon].center);
+				group_end++;
+			}
+
+			// Long connections get several portals, so the paths aren't all planned through their middle.
+			const int axis = group_bounds.get_longest_axis_index();
+			const real_t extent = group_bounds.size[axis];
+			const uint32_t part_count = extent > CMP_EPSILON ? MIN(group_end - group_begin, MAX_PORTALS_PER_NEIGHBOR) : 1;
+
+			for (uint32_t part = 0; part < part_count; part++) {
+				const real_t part_begin = group_bounds.position[axis] + extent * part / part_count;
+				const real_t part_end = group_bounds.position[axis] + extent * (part + 1) / part_count;
+				auto is_in_part = [&](uint32_t p_polygon) {
+					const real_t position = p_polygons[p_polygon].center[axis];
+					return position >= part_begin && (position < part_end || part == part_count - 1);
+				};
+
+				Vector3 centroid;
+				uint32_t part_size = 0;
+				for (uint32_t i = group_begin; i < group_end; i++) {
+					if (is_in_part(boundaries[i].polygon)) {
+						centroid += p_polygons[boundaries[i].polygon].center;
+						part_size++;
+					}
+				}
+				if (part_size == 0) {
+					continue;
+				}
+				centroid /= real_t(part_size);
+
+				// The portal is the connected polygon nearest to the middle of the part.
+				uint32_t portal_polygon = 0;
+				real_t portal_distance = UNREACHABLE_COST;
+				for (uint32_t i = group_begin; i < group_end; i++) {
+					if (!is_in_part(boundaries[i].polygon)) {
+						continue;
+					}
+					const real_t distance = p_polygons[boundaries[i].polygon].center.distance_squared_to(centroid);
+					if (distance < portal_distance) {
+						portal_distance = distance;
+						portal_polygon = boundaries[i].polygon;
+					}
+				}
+
+				Portal portal;
+				portal.cluster = cluster_id;
+				portal.polygon = portal_polygon;
+				portals.push_back(portal);
+				portal_neighbor_clusters.push_back(neighbor_cluster);
+
+				if (!portal_polygons[portal_polygon]) {
+					portal_polygons[portal_polygon] = true;
+					cluster.portal_polygon_count++;
+				}
+			}
+
+			group_begin = group_end;
+		}
+		cluster.portal_count = portals.size() - cluster.first_portal;
+	}
+
+	// Link the portals with the nearest ones on the other side.
+	for (uint32_t i = 0; i < portals.size(); i++) {
+		const Vector3 &center = p_polygons[portals[i].polygon].center;
+		const Cluster &neighbor = clusters[portal_neighbor_clusters[i]];
+		real_t linked_cost = UNREACHABLE_COST;
+		for (uint32_t j = neighbor.first_portal; j < neighbor.first_portal + neighbor.portal_count; j++) {
+			if (portal_neighbor_clusters[j] != portals[i].cluster) {
+				continue;
+			}
+			const real_t cost = center.distance_to(p_polygons[portals[j].polygon].center);
+			if (cost < linked_cost) {
+				portals[i].linked_portal = j;
+				portals[i].linked_cost = cost;
+				linked_cost = cost;
+			}
+		}
+	}
+
+	// Compute the costs between the portals of each cluster.
+	for (uint32_t cluster_id = 0; cluster_id < clusters.size(); cluster_id++) {
+		Cluster &cluster = clusters[cluster_id];
+
+		const Map<const NavRegion *, uint32_t>::Element *previous_id = previous_cluster_ids.find(cluster.region);
+		if (previous_id && p_changed_regions.find(cluster.region) == -1) {
+			const Cluster &previous = previous_clusters[previous_id->get()];
+			bool same_portals = previous.portal_count == cluster.portal_count;
+			for (uint32_t i = 0; same_portals && i < cluster.portal_count; i++) {
+				same_portals = previous_portals[previous.first_portal + i].polygon - previous.first_polygon == portals[cluster.first_portal + i].polygon - cluster.first_polygon;
+			}
+			if (same_portals) {
+				cluster.portal_costs = previous.portal_costs;
+				continue;
+			}
+		}
+
+		cluster.portal_costs.resize(cluster.portal_count * cluster.portal_count);
+		for (uint32_t i = 0; i < cluster.portal_count; i++) {
+			_compute_portal_costs(p_polygons, cluster, portals[cluster.first_portal + i].polygon, update_search, cluster.portal_costs.ptr() + i * cluster.portal_count);
+		}
+	}
+}
+
+void NavRegionGraph::_compute_portal_costs(const std::vector<gd::Polygon> &p_polygons, const Cluster &p_cluster, uint32_t p_polygon, ClusterSearch &r_search, real_t *r_costs) const {
+	// Dijkstra over the polygon centers of the cluster, until all the portals are reached.
+	LocalVector<real_t> &costs = r_search.costs;
+	gd::NavigationPolyHeap &to_visit = r_search.to_visit;
+
+	costs.resize(p_cluster.polygon_count);
+	for (uint32_t i = 0; i < p_cluster.polygon_count; i++) {
+		costs[i] = UNREACHABLE_COST;
+	}
+	to_visit.clear();
+
+	costs[p_polygon - p_cluster.first_polygon] = 0.0;
+	to_visit.push(p_polygon - p_cluster.first_polygon, 0.0);
+
+	uint32_t reached_portal_polygons = 0;
+	while (!to_visit.is_empty()) {
+		const uint32_t id = to_visit.pop();
+		const uint32_t index = p_cluster.first_polygon + id;
+		if (portal_polygons[index]) {
+			reached_portal_polygons++;
+			if (reached_portal_polygons == p_cluster.portal_polygon_count) {
+				break;
+			}
+		}
+
+		const gd::Polygon &polygon = p_polygons[index];
+		for (size_t edge = 0; edge < polygon.edges.size(); edge++) {
+			const Vector<gd::Edge::Connection> &connections = polygon.edges[edge].connections;
+			for (int connection = 0; connection < connections.size(); connection++) {
+				const gd::Polygon *neighbor = connections[connection].polygon;
+				const uint32_t neighbor_index = neighbor - p_polygons.data();
+				if (neighbor_index < p_cluster.first_polygon || neighbor_index >= p_cluster.first_polygon + p_cluster.polygon_count) {
+					continue;
+				}
+
+				const uint32_t neighbor_id = neighbor_index - p_cluster.first_polygon;
+				const real_t cost = costs[id] + polygon.center.distance_to(neighbor->center);
+				if (cost < costs[neighbor_id]) {
+					costs[neighbor_id] = cost;
+					if (to_visit.has(neighbor_id)) {
+						to_visit.update(neighbor_id, cost);
+					} else {
+						to_visit.push(neighbor_id, cost);
+					}
+				}
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < p_cluster.portal_count; i++) {
+		r_costs[i] = costs[portals[p_cluster.first_portal + i].polygon - p_cluster.first_polygon];
+	}
+}
+
+bool NavRegionGraph::find_corridor(const std::vector<gd::Polygon> &p_polygons, uint32_t p_begin_polygon, uint32_t p_end_polygon, const Vector3 &p_end_point, uint32_t p_layers, LocalVector<uint32_t> &r_clusters) const {
+	r_clusters.clear();
+	ERR_FAIL_COND_V(p_polygons.size() != polygon_clusters.size(), false);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_begin_polygon, polygon_clusters.size(), false);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_end_polygon, polygon_clusters.size(), false);
+
+	const uint32_t begin_cluster_id = polygon_clusters[p_begin_polygon];
+	const uint32_t end_cluster_id = polygon_clusters[p_end_polygon];
+	if (begin_cluster_id == end_cluster_id) {
+		r_clusters.push_back(begin_cluster_id);
+		return true;
+	}
+
+	// Kept per thread, so the queries can run in parallel and reuse the memory.
+	struct CorridorSearch {
+		ClusterSearch cluster_search;
+		LocalVector<real_t> begin_costs;
+		LocalVector<real_t> end_costs;
+
+		/// Indexed by portal, the goal is the last node.
+		LocalVector<real_t> node_costs;
+		LocalVector<uint32_t> node_back;
+		gd::NavigationPolyHeap to_visit;
+	};
+	static thread_local CorridorSearch search;
+
+	// Costs from the begin polygon and to the end polygon, through their own cluster.
+	const Cluster &begin_cluster = clusters[begin_cluster_id];
+	const Cluster &end_cluster = clusters[end_cluster_id];
+	search.begin_costs.resize(begin_cluster.portal_count);
+	search.end_costs.resize(end_cluster.portal_count);
+	_compute_portal_costs(p_polygons, begin_cluster, p_begin_polygon, search.cluster_search, search.begin_costs.ptr());
+	_compute_portal_costs(p_polygons, end_cluster, p_end_polygon, search.cluster_search, search.end_costs.ptr());
+
+	const uint32_t goal = portals.size();
+	search.node_costs.resize(goal + 1);
+	search.node_back.resize(goal + 1);
+	for (uint32_t i = 0; i <= goal; i++) {
+		search.node_costs[i] = UNREACHABLE_COST;
+		search.node_back[i] = INVALID_INDEX;
+	}
+	gd::NavigationPolyHeap &to_visit = search.to_visit;
+	to_visit.clear();
+
+	const auto reach = [&](uint32_t p_node, uint32_t p_from, real_t p_cost) {
+		if (p_cost >= search.node_costs[p_node]) {
+			return;
+		}
+		search.node_costs[p_node] = p_cost;
+		search.node_back[p_node] = p_from;
+
+		const real_t estimate = p_node == goal ? p_cost : p_cost + p_polygons[portals[p_node].polygon].center.distance_to(p_end_point);
+		if (to_visit.has(p_node)) {
+			to_visit.update(p_node, estimate);
+		} else {
+			to_visit.push(p_node, estimate);
+		}
+	};
+
+	for (uint32_t i = 0; i < begin_cluster.portal_count; i++) {
+		if (search.begin_costs[i] < UNREACHABLE_COST) {
+			reach(begin_cluster.first_portal + i, INVALID_INDEX, search.begin_costs[i]);
+		}
+	}
+
+	// A* over the portals.
+	while (!to_visit.is_empty()) {
+		const uint32_t node = to_visit.pop();
+		if (node == goal) {
+			break;
+		}
+
+		const Portal &portal = portals[node];
+		const Cluster &cluster = clusters[portal.cluster];
+		const real_t cost = search.node_costs[node];
+
+		if (portal.cluster == end_cluster_id) {
+			const real_t end_cost = search.end_costs[node - end_cluster.first_portal];
+			if (end_cost < UNREACHABLE_COST) {
+				reach(goal, node, cost + end_cost);
+			}
+		}
+
+		if (portal.linked_portal != INVALID_INDEX) {
+			const Cluster &neighbor = clusters[portals[portal.linked_portal].cluster];
+			if (p_layers & neighbor.region->get_layers()) {
+				reach(portal.linked_portal, node, cost + portal.linked_cost);
+			}
+		}
+
+		const real_t *portal_costs = cluster.portal_costs.ptr() + (node - cluster.first_portal) * cluster.portal_count;
+		for (uint32_t i = 0; i < cluster.portal_count; i++) {
+			if (cluster.first_portal + i != node && portal_costs[i] < UNREACHABLE_COST) {
+				reach(cluster.first_portal + i, node, cost + portal_costs[i]);
+			}
+		}
+	}
+
+	if (search.node_back[goal] == INVALID_INDEX) {
+		return false;
+	}
+
+	r_clusters.push_back(end_cluster_id);
+	for (uint32_t node = search.node_back[goal]; node != INVALID_INDEX; node = search.node_back[node]) {
+		if (r_clusters[r_clusters.size() - 1] != portals[node].cluster) {
+			r_clusters.push_back(portals[node].cluster);
+		}
+	}
+	r_clusters.invert();
+
+	return true;
+}
@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  nav_region_graph.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NAV_REGION_GRAPH_H
+#define NAV_REGION_GRAPH_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/rid.h"
+#include "nav_utils.h"
+
+/// Abstract graph of the regions of a map, used to plan long paths
+/// hierarchically (HPA*).
+///
+/// Each region is a cluster. Where two clusters are connected there are portals
+/// on each side: the connected polygons are split in a few parts along the
+/// connection, and the polygon in the middle of each part is a portal. The
+/// costs between the portals of a cluster are precomputed, so a search at this
+/// level only visits a few nodes per region. The path search then refines the
+/// path in the regions on the way only.
+class NavRegionGraph {
+public:
+	static const uint32_t INVALID_INDEX = UINT32_MAX;
+
+private:
+	/// Portals on each side of the connection between two clusters, at most.
+	static const uint32_t MAX_PORTALS_PER_NEIGHBOR = 4;
+
+	struct Portal {
+		uint32_t cluster = 0;
+		/// Index of the polygon in the map polygons.
+		uint32_t polygon = 0;
+		/// Portal on the other side, in the neighbor cluster.
+		uint32_t linked_portal = INVALID_INDEX;
+		real_t linked_cost = 0.0;
+	};
+
+	struct Cluster {
+		const NavRegion *region = nullptr;
+		uint32_t first_polygon = 0;
+		uint32_t polygon_count = 0;
+		uint32_t first_portal = 0;
+		uint32_t portal_count = 0;
+		/// Distinct polygons among the portals, to stop the cost searches early.
+		uint32_t portal_polygon_count = 0;
+		/// Travel cost between each pair of portals of this cluster, row major.
+		/// `UNREACHABLE_COST` (1e30) when the portals aren't connected inside the cluster.
+		LocalVector<real_t> portal_costs;
+	};
+
+	/// Scratch memory of the searches inside a cluster.
+	struct ClusterSearch {
+		LocalVector<real_t> costs;
+		gd::NavigationPolyHeap to_visit;
+	};
+
+	LocalVector<Cluster> clusters;
+	LocalVector<Portal> portals;
+	/// Cluster of each map polygon.
+	LocalVector<uint32_t> polygon_clusters;
+	/// True for the map polygons that are portals.
+	LocalVector<bool> portal_polygons;
+
+	ClusterSearch update_search;
+
+	void _compute_portal_costs(const std::vector<gd::Polygon> &p_polygons, const Cluster &p_cluster, uint32_t p_polygon, ClusterSearch &r_search, real_t *r_costs) const;
+
+public:
+	/// Rebuilds the graph from the map polygons and their connections.
+	/// The polygons of a region must be contiguous. The portal costs of the
+	/// regions not in `p_changed_regions` are kept when their portals didn't move.
+	void update(const std::vector<gd::Polygon> &p_polygons, const LocalVector<const NavRegion *> &p_changed_regions);
+	void clear();
+
+	bool is_empty() const { return clusters.is_empty(); }
+	uint32_t get_cluster_count() const { return clusters.size(); }
+	uint32_t get_portal_count() const { return portals.size(); }
+	uint32_t get_polygon_cluster(uint32_t p_polygon) const { return polygon_clusters[p_polygon]; }
+
+	/// Finds the clusters a path from `p_begin_polygon` to `p_end_polygon` goes
+	/// through, in order. Only the regions with compatible layers are crossed.
+	/// Returns false if the end isn't reachable at this level.
+	bool find_corridor(const std::vector<gd::Polygon> &p_polygons, uint32_t p_begin_polygon, uint32_t p_end_polygon, const Vector3 &p_end_point, uint32_t p_layers, LocalVector<uint32_t> &r_clusters) const;
+};
+
+#endif // NAV_REGION_GRAPH_H
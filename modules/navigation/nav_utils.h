@@ -59,6 +59,10 @@ struct EdgeKey {
 		return (a.key == p_key.a.key) ? (b.key < p_key.b.key) : (a.key < p_key.a.key);
 	}
 
+	bool operator==(const EdgeKey &p_key) const {
+		return a.key == p_key.a.key && b.key == p_key.b.key;
+	}
+
 	EdgeKey(const PointKey &p_a = PointKey(), const PointKey &p_b = PointKey()) :
 			a(p_a),
 			b(p_b) {
@@ -131,6 +135,105 @@ struct NavigationPoly {
 	}
 };
 
+/// Binary min-heap of `NavigationPoly` ids ordered by cost.
+/// The position of each id is tracked, so its cost can be changed in place.
+class NavigationPolyHeap {
+	static const uint32_t INVALID_POSITION = UINT32_MAX;
+
+	std::vector<uint32_t> heap;
+	/// Indexed by id.
+	std::vector<uint32_t> positions;
+	std::vector<float> costs;
+
+	void sift_up(uint32_t p_position) {
+		const uint32_t id = heap[p_position];
+		while (p_position > 0) {
+			const uint32_t parent = (p_position - 1) / 2;
+			if (costs[heap[parent]] <= costs[id]) {
+				break;
+			}
+			heap[p_position] = heap[parent];
+			positions[heap[p_position]] = p_position;
+			p_position = parent;
+		}
+		heap[p_position] = id;
+		positions[id] = p_position;
+	}
+
+	void sift_down(uint32_t p_position) {
+		const uint32_t id = heap[p_position];
+		const uint32_t count = heap.size();
+		while (true) {
+			uint32_t child = p_position * 2 + 1;
+			if (child >= count) {
+				break;
+			}
+			if (child + 1 < count && costs[heap[child + 1]] < costs[heap[child]]) {
+				child++;
+			}
+			if (costs[id] <= costs[heap[child]]) {
+				break;
+			}
+			heap[p_position] = heap[child];
+			positions[heap[p_position]] = p_position;
+			p_position = child;
+		}
+		heap[p_position] = id;
+		positions[id] = p_position;
+	}
+
+public:
+	void clear() {
+		for (size_t i(0); i < heap.size(); i++) {
+			positions[heap[i]] = INVALID_POSITION;
+		}
+		heap.clear();
+	}
+
+	bool is_empty() const {
+		return heap.empty();
+	}
+
+	bool has(uint32_t p_id) const {
+		return p_id < positions.size() && positions[p_id] != INVALID_POSITION;
+	}
+
+	void push(uint32_t p_id, float p_cost) {
+		if (p_id >= positions.size()) {
+			const uint32_t invalid_position = INVALID_POSITION;
+			positions.resize(p_id + 1, invalid_position);
+			costs.resize(p_id + 1);
+		}
+		costs[p_id] = p_cost;
+		heap.push_back(p_id);
+		sift_up(heap.size() - 1);
+	}
+
+	/// Changes the cost of an id already in the heap.
+	void update(uint32_t p_id, float p_cost) {
+		const float previous_cost = costs[p_id];
+		costs[p_id] = p_cost;
+		if (p_cost < previous_cost) {
+			sift_up(positions[p_id]);
+		} else {
+			sift_down(positions[p_id]);
+		}
+	}
+
+	/// Removes and returns the id with the lowest cost.
+	uint32_t pop() {
+		const uint32_t id = heap[0];
+		positions[id] = INVALID_POSITION;
+		const uint32_t last = heap.back();
+		heap.pop_back();
+		if (!heap.empty()) {
+			heap[0] = last;
+			sift_down(0);
+		}
+		return id;
+	}
+};
+
 struct ClosestPointQueryResult {
 	Vector3 point;
 	Vector3 normal;
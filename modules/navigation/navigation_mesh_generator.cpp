@@ -34,6 +34,8 @@
 
 #include "core/math/convex_hull.h"
 #include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/3d/collision_shape_3d.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/3d/multimesh_instance_3d.h"
@@ -370,14 +372,47 @@ void NavigationMeshGenerator::_parse_geometry(const Transform3D &p_navmesh_trans
 	}
 }
 
-void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh) {
-	Vector<Vector3> nav_vertices;
+void NavigationMeshGenerator::_parse_source_geometry(Ref<NavigationMesh> p_nav_mesh, Node *p_node, Vector<float> &r_vertices, Vector<int> &r_indices) {
+	List<Node *> parse_nodes;
 
+	if (p_nav_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_NAVMESH_CHILDREN) {
+		parse_nodes.push_back(p_node);
+	} else {
+		p_node->get_tree()->get_nodes_in_group(p_nav_mesh->get_source_group_name(), &parse_nodes);
+	}
+
+	Transform3D navmesh_xform = Object::cast_to<Node3D>(p_node)->get_global_transform().affine_inverse();
+	for (Node *E : parse_nodes) {
+		NavigationMesh::ParsedGeometryType geometry_type = p_nav_mesh->get_parsed_geometry_type();
+		uint32_t collision_mask = p_nav_mesh->get_collision_mask();
+		bool recurse_children = p_nav_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
+		_parse_geometry(navmesh_xform, E, r_vertices, r_indices, geometry_type, collision_mask, recurse_children);
+	}
+}
+
+void NavigationMeshGenerator::_init_recast_config(Ref<NavigationMesh> p_nav_mesh, rcConfig &r_cfg) {
+	memset(&r_cfg, 0, sizeof(r_cfg));
+
+	r_cfg.cs = p_nav_mesh->get_cell_size();
+	r_cfg.ch = p_nav_mesh->get_cell_height();
+	r_cfg.walkableSlopeAngle = p_nav_mesh->get_agent_max_slope();
+	r_cfg.walkableHeight = (int)Math::ceil(p_nav_mesh->get_agent_height() / r_cfg.ch);
+	r_cfg.walkableClimb = (int)Math::floor(p_nav_mesh->get_agent_max_climb() / r_cfg.ch);
+	r_cfg.walkableRadius = (int)Math::ceil(p_nav_mesh->get_agent_radius() / r_cfg.cs);
+	r_cfg.maxEdgeLen = (int)(p_nav_mesh->get_edge_max_length() / p_nav_mesh->get_cell_size());
+	r_cfg.maxSimplificationError = p_nav_mesh->get_edge_max_error();
+	r_cfg.minRegionArea = (int)(p_nav_mesh->get_region_min_size() * p_nav_mesh->get_region_min_size());
+	r_cfg.mergeRegionArea = (int)(p_nav_mesh->get_region_merge_size() * p_nav_mesh->get_region_merge_size());
+	r_cfg.maxVertsPerPoly = (int)p_nav_mesh->get_verts_per_poly();
+	r_cfg.detailSampleDist = p_nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : p_nav_mesh->get_cell_size() * p_nav_mesh->get_detail_sample_distance();
+	r_cfg.detailSampleMaxError = p_nav_mesh->get_cell_height() * p_nav_mesh->get_detail_sample_max_error();
+}
+
+void NavigationMeshGenerator::_convert_detail_mesh(const rcPolyMeshDetail *p_detail_mesh, Vector<Vector3> &r_vertices, Vector<Vector<int>> &r_polygons) {
 	for (int i = 0; i < p_detail_mesh->nverts; i++) {
 		const float *v = &p_detail_mesh->verts[i * 3];
-		nav_vertices.push_back(Vector3(v[0], v[1], v[2]));
+		r_vertices.push_back(Vector3(v[0], v[1], v[2]));
 	}
-	p_nav_mesh->set_vertices(nav_vertices);
 
 	for (int i = 0; i < p_detail_mesh->nmeshes; i++) {
 		const unsigned int *m = &p_detail_mesh->meshes[i * 4];
@@ -392,11 +427,22 @@ void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(con
 			nav_indices.write[0] = ((int)(bverts + tris[j * 4 + 0]));
 			nav_indices.write[1] = ((int)(bverts + tris[j * 4 + 2]));
 			nav_indices.write[2] = ((int)(bverts + tris[j * 4 + 1]));
-			p_nav_mesh->add_polygon(nav_indices);
+			r_polygons.push_back(nav_indices);
 		}
 	}
 }
 
+void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh) {
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+	_convert_detail_mesh(p_detail_mesh, nav_vertices, nav_polygons);
+
+	p_nav_mesh->set_vertices(nav_vertices);
+	for (int i = 0; i < nav_polygons.size(); i++) {
+		p_nav_mesh->add_polygon(nav_polygons[i]);
+	}
+}
+
 void NavigationMeshGenerator::_build_recast_navigation_mesh(
 		Ref<NavigationMesh> p_nav_mesh,
 #ifdef TOOLS_ENABLED
@@ -426,21 +472,7 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	rcCalcBounds(verts, nverts, bmin, bmax);
 
 	rcConfig cfg;
-	memset(&cfg, 0, sizeof(cfg));
-
-	cfg.cs = p_nav_mesh->get_cell_size();
-	cfg.ch = p_nav_mesh->get_cell_height();
-	cfg.walkableSlopeAngle = p_nav_mesh->get_agent_max_slope();
-	cfg.walkableHeight = (int)Math::ceil(p_nav_mesh->get_agent_height() / cfg.ch);
-	cfg.walkableClimb = (int)Math::floor(p_nav_mesh->get_agent_max_climb() / cfg.ch);
-	cfg.walkableRadius = (int)Math::ceil(p_nav_mesh->get_agent_radius() / cfg.cs);
-	cfg.maxEdgeLen = (int)(p_nav_mesh->get_edge_max_length() / p_nav_mesh->get_cell_size());
-	cfg.maxSimplificationError = p_nav_mesh->get_edge_max_error();
-	cfg.minRegionArea = (int)(p_nav_mesh->get_region_min_size() * p_nav_mesh->get_region_min_size());
-	cfg.mergeRegionArea = (int)(p_nav_mesh->get_region_merge_size() * p_nav_mesh->get_region_merge_size());
-	cfg.maxVertsPerPoly = (int)p_nav_mesh->get_verts_per_poly();
-	cfg.detailSampleDist = p_nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : p_nav_mesh->get_cell_size() * p_nav_mesh->get_detail_sample_distance();
-	cfg.detailSampleMaxError = p_nav_mesh->get_cell_height() * p_nav_mesh->get_detail_sample_max_error();
+	_init_recast_config(p_nav_mesh, cfg);
 
 	cfg.bmin[0] = bmin[0];
 	cfg.bmin[1] = bmin[1];
@@ -574,6 +606,498 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	detail_mesh = nullptr;
 }
 
+bool NavigationMeshGenerator::_build_recast_tile_mesh(const RecastTileBake &p_bake, RecastTile &r_tile, rcContext &r_ctx, rcHeightfield *&r_hf, rcCompactHeightfield *&r_chf, rcContourSet *&r_cset, rcPolyMesh *&r_poly_mesh, rcPolyMeshDetail *&r_detail_mesh) {
+	const rcConfig &cfg = r_tile.cfg;
+	const int *tris = r_tile.indices.ptr();
+	const int ntris = r_tile.indices.size() / 3;
+
+	r_hf = rcAllocHeightfield();
+	ERR_FAIL_COND_V(!r_hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&r_ctx, *r_hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch), false);
+
+	{
+		LocalVector<unsigned char> tri_areas;
+		tri_areas.resize(ntris);
+		memset(tri_areas.ptr(), 0, ntris * sizeof(unsigned char));
+		rcMarkWalkableTriangles(&r_ctx, cfg.walkableSlopeAngle, p_bake.vertices, p_bake.vertex_count, tris, ntris, tri_areas.ptr());
+
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&r_ctx, p_bake.vertices, p_bake.vertex_count, tris, tri_areas.ptr(), ntris, *r_hf, cfg.walkableClimb), false);
+	}
+
+	if (p_bake.filter_low_hanging_obstacles) {
+		rcFilterLowHangingWalkableObstacles(&r_ctx, cfg.walkableClimb, *r_hf);
+	}
+	if (p_bake.filter_ledge_spans) {
+		rcFilterLedgeSpans(&r_ctx, cfg.walkableHeight, cfg.walkableClimb, *r_hf);
+	}
+	if (p_bake.filter_walkable_low_height_spans) {
+		rcFilterWalkableLowHeightSpans(&r_ctx, cfg.walkableHeight, *r_hf);
+	}
+
+	r_chf = rcAllocCompactHeightfield();
+	ERR_FAIL_COND_V(!r_chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&r_ctx, cfg.walkableHeight, cfg.walkableClimb, *r_hf, *r_chf), false);
+
+	rcFreeHeightField(r_hf);
+	r_hf = nullptr;
+
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&r_ctx, cfg.walkableRadius, *r_chf), false);
+
+	// The border regions are left out of the contours, which trims the mesh back to the tile bounds.
+	if (p_bake.partition_type == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&r_ctx, *r_chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&r_ctx, *r_chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
+	} else if (p_bake.partition_type == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&r_ctx, *r_chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
+	} else {
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&r_ctx, *r_chf, cfg.borderSize, cfg.minRegionArea), false);
+	}
+
+	r_cset = rcAllocContourSet();
+	ERR_FAIL_COND_V(!r_cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&r_ctx, *r_chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *r_cset), false);
+
+	if (r_cset->nconts == 0) {
+		// Nothing walkable inside this tile.
+		return true;
+	}
+
+	r_poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_COND_V(!r_poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&r_ctx, *r_cset, cfg.maxVertsPerPoly, *r_poly_mesh), false);
+
+	r_detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_COND_V(!r_detail_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&r_ctx, *r_poly_mesh, *r_chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *r_detail_mesh), false);
+
+	_convert_detail_mesh(r_detail_mesh, r_tile.vertices, r_tile.polygons);
+	return true;
+}
+
+void NavigationMeshGenerator::_build_recast_tile(uint32_t p_index, RecastTileBake *p_bake) {
+	RecastTile &tile = p_bake->tiles[p_index];
+
+	rcContext ctx;
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
+
+	if (!_build_recast_tile_mesh(*p_bake, tile, ctx, hf, chf, cset, poly_mesh, detail_mesh)) {
+		tile.vertices.clear();
+		tile.polygons.clear();
+	}
+
+	rcFreeHeightField(hf);
+	rcFreeCompactHeightfield(chf);
+	rcFreeContourSet(cset);
+	rcFreePolyMesh(poly_mesh);
+	rcFreePolyMeshDetail(detail_mesh);
+}
+
+void NavigationMeshGenerator::_weld_tile_seams(Vector<Vector3> &r_vertices, LocalVector<Vector<int>> &r_polygons, real_t p_tile_world_size, real_t p_tolerance, real_t p_max_climb) {
+	// Every tile simplifies its contours on its own, so both sides of a seam rarely end up with the same vertices.
+	// Snap the seam vertices onto the seam, merge the duplicates and split the seam edges at the vertices of the
+	// other side, so that polygons of neighboring tiles share their edges and get connected like any other polygons.
+	struct SeamVertex {
+		real_t offset = 0.0;
+		int index = 0;
+
+		bool operator<(const SeamVertex &p_other) const { return offset < p_other.offset; }
+	};
+
+	const int vertex_count = r_vertices.size();
+	Vector3 *vertices = r_vertices.ptrw();
+	HashMap<int64_t, LocalVector<SeamVertex>> seams;
+
+	for (int i = 0; i < vertex_count; i++) {
+		Vector3 &vertex = vertices[i];
+		for (int axis = 0; axis <= 2; axis += 2) {
+			const real_t line = Math::round(vertex[axis] / p_tile_world_size);
+			if (Math::abs(vertex[axis] - line * p_tile_world_size) > p_tolerance) {
+				continue;
+			}
+			vertex[axis] = line * p_tile_world_size;
+
+			SeamVertex seam_vertex;
+			seam_vertex.offset = vertex[2 - axis];
+			seam_vertex.index = i;
+			const int64_t key = (int64_t)line * 2 + (axis == 0 ? 0 : 1);
+			LocalVector<SeamVertex> *seam = seams.getptr(key);
+			if (!seam) {
+				seams.set(key, LocalVector<SeamVertex>());
+				seam = seams.getptr(key);
+			}
+			seam->push_back(seam_vertex);
+		}
+	}
+
+	if (seams.is_empty()) {
+		return;
+	}
+
+	LocalVector<int> remap;
+	remap.resize(vertex_count);
+	for (int i = 0; i < vertex_count; i++) {
+		remap[i] = i;
+	}
+
+	auto find_vertex = [&remap](int p_index) {
+		while (remap[p_index] != p_index) {
+			p_index = remap[p_index];
+		}
+		return p_index;
+	};
+
+	// Merge the vertices both sides of a seam have in common.
+	const int64_t *key = nullptr;
+	while ((key = seams.next(key))) {
+		LocalVector<SeamVertex> &seam = *seams.getptr(*key);
+		seam.sort();
+		for (uint32_t i = 1; i < seam.size(); i++) {
+			const int index = find_vertex(seam[i].index);
+			for (int j = (int)i - 1; j >= 0 && seam[i].offset - seam[j].offset <= p_tolerance; j--) {
+				const int other = find_vertex(seam[j].index);
+				if (other != index && Math::abs(vertices[other].y - vertices[index].y) <= p_max_climb) {
+					remap[index] = other;
+					break;
+				}
+			}
+		}
+	}
+
+	key = nullptr;
+	while ((key = seams.next(key))) {
+		LocalVector<SeamVertex> &seam = *seams.getptr(*key);
+		LocalVector<SeamVertex> merged;
+		for (uint32_t i = 0; i < seam.size(); i++) {
+			SeamVertex seam_vertex = seam[i];
+			seam_vertex.index = find_vertex(seam_vertex.index);
+			bool duplicate = false;
+			for (int j = (int)merged.size() - 1; j >= 0 && seam_vertex.offset - merged[j].offset <= p_tolerance; j--) {
+				if (merged[j].index == seam_vertex.index) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (!duplicate) {
+				merged.push_back(seam_vertex);
+			}
+		}
+		seam = merged;
+	}
+
+	LocalVector<Vector<int>> welded_polygons;
+	welded_polygons.reserve(r_polygons.size());
+
+	for (uint32_t i = 0; i < r_polygons.size(); i++) {
+		const Vector<int> &polygon = r_polygons[i];
+
+		LocalVector<int> points;
+		for (int j = 0; j < polygon.size(); j++) {
+			const int index = find_vertex(polygon[j]);
+			if (points.is_empty() || points[points.size() - 1] != index) {
+				points.push_back(index);
+			}
+		}
+		while (points.size() > 1 && points[0] == points[points.size() - 1]) {
+			points.resize(points.size() - 1);
+		}
+		if (points.size() < 3) {
+			continue;
+		}
+
+		Vector<int> welded;
+		for (uint32_t j = 0; j < points.size(); j++) {
+			const Vector3 &from = vertices[points[j]];
+			const Vector3 &to = vertices[points[(j + 1) % points.size()]];
+			welded.push_back(points[j]);
+
+			for (int axis = 0; axis <= 2; axis += 2) {
+				const real_t line = Math::round(from[axis] / p_tile_world_size);
+				if (from[axis] != to[axis] || from[axis] != line * p_tile_world_size) {
+					continue;
+				}
+				const LocalVector<SeamVertex> *seam = seams.getptr((int64_t)line * 2 + (axis == 0 ? 0 : 1));
+				if (!seam) {
+					break;
+				}
+
+				const real_t from_offset = from[2 - axis];
+				const real_t to_offset = to[2 - axis];
+				const real_t min_offset = MIN(from_offset, to_offset) + p_tolerance;
+				const real_t max_offset = MAX(from_offset, to_offset) - p_tolerance;
+
+				// Binary search for the first seam vertex past the start of the edge.
+				uint32_t begin = 0;
+				uint32_t end = seam->size();
+				while (begin < end) {
+					const uint32_t middle = (begin + end) / 2;
+					if ((*seam)[middle].offset < min_offset) {
+						begin = middle + 1;
+					} else {
+						end = middle;
+					}
+				}
+
+				LocalVector<int> splits;
+				for (uint32_t k = begin; k < seam->size() && (*seam)[k].offset <= max_offset; k++) {
+					const SeamVertex &seam_vertex = (*seam)[k];
+					const real_t weight = (seam_vertex.offset - from_offset) / (to_offset - from_offset);
+					if (Math::abs(vertices[seam_vertex.index].y - Math::lerp(from.y, to.y, weight)) <= p_max_climb) {
+						splits.push_back(seam_vertex.index);
+					}
+				}
+				if (from_offset > to_offset) {
+					splits.invert();
+				}
+				for (uint32_t k = 0; k < splits.size(); k++) {
+					welded.push_back(splits[k]);
+				}
+				break;
+			}
+		}
+		welded_polygons.push_back(welded);
+	}
+
+	// Drop the vertices merged into others, so no two vertices of the mesh are on the same point of a seam.
+	Vector<Vector3> welded_vertices;
+	for (int i = 0; i < vertex_count; i++) {
+		remap[i] = -1;
+	}
+	for (uint32_t i = 0; i < welded_polygons.size(); i++) {
+		int *indices = welded_polygons[i].ptrw();
+		for (int j = 0; j < welded_polygons[i].size(); j++) {
+			if (remap[indices[j]] < 0) {
+				remap[indices[j]] = welded_vertices.size();
+				welded_vertices.push_back(vertices[indices[j]]);
+			}
+			indices[j] = remap[indices[j]];
+		}
+	}
+
+	r_vertices = welded_vertices;
+	r_polygons = welded_polygons;
+}
+
+void NavigationMeshGenerator::_build_recast_navigation_mesh_tiles(Ref<NavigationMesh> p_nav_mesh, const Vector<float> &p_vertices, const Vector<int> &p_indices, const AABB *p_dirty_area) {
+	rcConfig tile_cfg;
+	_init_recast_config(p_nav_mesh, tile_cfg);
+	tile_cfg.tileSize = (int)p_nav_mesh->get_tile_size();
+	tile_cfg.borderSize = tile_cfg.walkableRadius + 3;
+	tile_cfg.width = tile_cfg.tileSize + tile_cfg.borderSize * 2;
+	tile_cfg.height = tile_cfg.width;
+
+	const float tile_world_size = tile_cfg.tileSize * tile_cfg.cs;
+	const float border_world_size = tile_cfg.borderSize * tile_cfg.cs;
+
+	const float *verts = p_vertices.ptr();
+	const int nverts = p_vertices.size() / 3;
+	const int *tris = p_indices.ptr();
+	const int ntris = p_indices.size() / 3;
+
+	float bmin[3], bmax[3];
+	rcCalcBounds(verts, nverts, bmin, bmax);
+
+	// The tile grid is aligned to the navigation mesh origin, so a partial rebake lands on the tiles of the full bake.
+	int dirty_begin_x = (int)Math::floor(bmin[0] / tile_world_size);
+	int dirty_begin_z = (int)Math::floor(bmin[2] / tile_world_size);
+	int dirty_end_x = (int)Math::floor(bmax[0] / tile_world_size);
+	int dirty_end_z = (int)Math::floor(bmax[2] / tile_world_size);
+
+	if (p_dirty_area) {
+		// Geometry within the border of a tile changes how that tile is eroded, so the neighbors are rebuilt too.
+		dirty_begin_x = (int)Math::floor((p_dirty_area->position.x - border_world_size) / tile_world_size);
+		dirty_begin_z = (int)Math::floor((p_dirty_area->position.z - border_world_size) / tile_world_size);
+		dirty_end_x = (int)Math::floor((p_dirty_area->position.x + p_dirty_area->size.x + border_world_size) / tile_world_size);
+		dirty_end_z = (int)Math::floor((p_dirty_area->position.z + p_dirty_area->size.z + border_world_size) / tile_world_size);
+	}
+
+	const int begin_x = MAX(dirty_begin_x, (int)Math::floor(bmin[0] / tile_world_size));
+	const int begin_z = MAX(dirty_begin_z, (int)Math::floor(bmin[2] / tile_world_size));
+	const int end_x = MIN(dirty_end_x, (int)Math::floor(bmax[0] / tile_world_size));
+	const int end_z = MIN(dirty_end_z, (int)Math::floor(bmax[2] / tile_world_size));
+	const int tiles_x = MAX(end_x - begin_x + 1, 0);
+	const int tiles_z = MAX(end_z - begin_z + 1, 0);
+	ERR_FAIL_COND_MSG((int64_t)tiles_x * tiles_z > (1 << 20), "Too many navigation mesh tiles to bake, increase the tile size.");
+
+	RecastTileBake bake;
+	bake.vertices = verts;
+	bake.vertex_count = nverts;
+	bake.partition_type = p_nav_mesh->get_sample_partition_type();
+	bake.filter_low_hanging_obstacles = p_nav_mesh->get_filter_low_hanging_obstacles();
+	bake.filter_ledge_spans = p_nav_mesh->get_filter_ledge_spans();
+	bake.filter_walkable_low_height_spans = p_nav_mesh->get_filter_walkable_low_height_spans();
+
+	bake.tiles.resize(tiles_x * tiles_z);
+	for (int z = 0; z < tiles_z; z++) {
+		for (int x = 0; x < tiles_x; x++) {
+			RecastTile &tile = bake.tiles[z * tiles_x + x];
+			tile.x = begin_x + x;
+			tile.z = begin_z + z;
+			tile.cfg = tile_cfg;
+			tile.cfg.bmin[0] = tile.x * tile_world_size - border_world_size;
+			tile.cfg.bmin[1] = bmin[1];
+			tile.cfg.bmin[2] = tile.z * tile_world_size - border_world_size;
+			tile.cfg.bmax[0] = (tile.x + 1) * tile_world_size + border_world_size;
+			tile.cfg.bmax[1] = bmax[1];
+			tile.cfg.bmax[2] = (tile.z + 1) * tile_world_size + border_world_size;
+		}
+	}
+
+	// Bin the triangles into every tile their bounds overlap, border included.
+	for (int i = 0; i < ntris; i++) {
+		const int *tri = &tris[i * 3];
+		float tri_min[2] = { verts[tri[0] * 3], verts[tri[0] * 3 + 2] };
+		float tri_max[2] = { tri_min[0], tri_min[1] };
+		for (int j = 1; j < 3; j++) {
+			const float *v = &verts[tri[j] * 3];
+			tri_min[0] = MIN(tri_min[0], v[0]);
+			tri_min[1] = MIN(tri_min[1], v[2]);
+			tri_max[0] = MAX(tri_max[0], v[0]);
+			tri_max[1] = MAX(tri_max[1], v[2]);
+		}
+
+		const int tri_begin_x = MAX((int)Math::floor((tri_min[0] - border_world_size) / tile_world_size), begin_x);
+		const int tri_begin_z = MAX((int)Math::floor((tri_min[1] - border_world_size) / tile_world_size), begin_z);
+		const int tri_end_x = MIN((int)Math::floor((tri_max[0] + border_world_size) / tile_world_size), end_x);
+		const int tri_end_z = MIN((int)Math::floor((tri_max[1] + border_world_size) / tile_world_size), end_z);
+		for (int z = tri_begin_z; z <= tri_end_z; z++) {
+			for (int x = tri_begin_x; x <= tri_end_x; x++) {
+				LocalVector<int> &tile_indices = bake.tiles[(z - begin_z) * tiles_x + (x - begin_x)].indices;
+				tile_indices.push_back(tri[0]);
+				tile_indices.push_back(tri[1]);
+				tile_indices.push_back(tri[2]);
+			}
+		}
+	}
+
+	uint32_t tile_count = 0;
+	for (uint32_t i = 0; i < bake.tiles.size(); i++) {
+		if (bake.tiles[i].indices.is_empty()) {
+			continue;
+		}
+		if (i != tile_count) {
+			bake.tiles[tile_count] = bake.tiles[i];
+		}
+		tile_count++;
+	}
+	bake.tiles.resize(tile_count);
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	work_pool.do_work(bake.tiles.size(), this, &NavigationMeshGenerator::_build_recast_tile, &bake);
+	work_pool.finish();
+
+	Vector<Vector3> nav_vertices;
+	LocalVector<Vector<int>> nav_polygons;
+
+	if (p_dirty_area) {
+		const float seam_tolerance = tile_cfg.cs * 0.1f;
+		auto is_dirty_tile = [&](int p_x, int p_z) {
+			return p_x >= dirty_begin_x && p_x <= dirty_end_x && p_z >= dirty_begin_z && p_z <= dirty_end_z;
+		};
+		// The seam of the edge when it lies on a side of the tile that is shared with a rebuilt tile, -1 otherwise.
+		auto get_dirty_seam = [&](const Vector3 &p_from, const Vector3 &p_to, int p_x, int p_z) -> int64_t {
+			for (int axis = 0; axis <= 2; axis += 2) {
+				const real_t line = Math::round(p_from[axis] / tile_world_size);
+				if (Math::abs(p_from[axis] - line * tile_world_size) > seam_tolerance || Math::abs(p_to[axis] - line * tile_world_size) > seam_tolerance) {
+					continue;
+				}
+				const int tile = axis == 0 ? p_x : p_z;
+				const int neighbor = (int)line == tile ? tile - 1 : tile + 1;
+				if (axis == 0 ? is_dirty_tile(neighbor, p_z) : is_dirty_tile(p_x, neighbor)) {
+					return ((int64_t)line - INT32_MIN) * 2 + (axis == 0 ? 0 : 1);
+				}
+			}
+			return -1;
+		};
+
+		// Keep the polygons of every tile that was not rebuilt.
+		const Vector<Vector3> old_vertices = p_nav_mesh->get_vertices();
+		LocalVector<int> remap;
+		remap.resize(old_vertices.size());
+		for (uint32_t i = 0; i < remap.size(); i++) {
+			remap[i] = -1;
+		}
+
+		for (int i = 0; i < p_nav_mesh->get_polygon_count(); i++) {
+			Vector<int> polygon = p_nav_mesh->get_polygon(i);
+			if (polygon.is_empty()) {
+				continue;
+			}
+
+			Vector3 center;
+			bool valid = true;
+			for (int j = 0; j < polygon.size(); j++) {
+				if (polygon[j] < 0 || polygon[j] >= old_vertices.size()) {
+					valid = false;
+					break;
+				}
+				center += old_vertices[polygon[j]];
+			}
+			ERR_CONTINUE_MSG(!valid, "Navigation mesh polygon references an invalid vertex.");
+			center /= polygon.size();
+
+			const int x = (int)Math::floor(center.x / tile_world_size);
+			const int z = (int)Math::floor(center.z / tile_world_size);
+			if (is_dirty_tile(x, z)) {
+				continue;
+			}
+
+			// The previous weld split the edges on the seams with the rebuilt tiles at the vertices of the old
+			// polygons there. Remove those splits, the weld below splits the edges again at the new vertices.
+			// A vertex between two edges on the same seam can only be such a split.
+			Vector<int> kept;
+			for (int j = 0; j < polygon.size(); j++) {
+				const Vector3 &previous = old_vertices[polygon[(j + polygon.size() - 1) % polygon.size()]];
+				const Vector3 &vertex = old_vertices[polygon[j]];
+				const Vector3 &next = old_vertices[polygon[(j + 1) % polygon.size()]];
+				const int64_t seam = get_dirty_seam(previous, vertex, x, z);
+				if (seam < 0 || seam != get_dirty_seam(vertex, next, x, z)) {
+					kept.push_back(polygon[j]);
+				}
+			}
+			if (kept.size() < 3) {
+				continue;
+			}
+
+			int *indices = kept.ptrw();
+			for (int j = 0; j < kept.size(); j++) {
+				if (remap[indices[j]] < 0) {
+					remap[indices[j]] = nav_vertices.size();
+					nav_vertices.push_back(old_vertices[indices[j]]);
+				}
+				indices[j] = remap[indices[j]];
+			}
+			nav_polygons.push_back(kept);
+		}
+	}
+
+	for (uint32_t i = 0; i < bake.tiles.size(); i++) {
+		const RecastTile &tile = bake.tiles[i];
+		const int base = nav_vertices.size();
+		nav_vertices.append_array(tile.vertices);
+		for (int j = 0; j < tile.polygons.size(); j++) {
+			Vector<int> polygon = tile.polygons[j];
+			int *indices = polygon.ptrw();
+			for (int k = 0; k < polygon.size(); k++) {
+				indices[k] += base;
+			}
+			nav_polygons.push_back(polygon);
+		}
+	}
+
+	_weld_tile_seams(nav_vertices, nav_polygons, tile_world_size, tile_cfg.cs * 0.1f, p_nav_mesh->get_agent_max_climb());
+
+	p_nav_mesh->clear_polygons();
+	p_nav_mesh->set_vertices(nav_vertices);
+	for (uint32_t i = 0; i < nav_polygons.size(); i++) {
+		p_nav_mesh->add_polygon(nav_polygons[i]);
+	}
+}
+
 NavigationMeshGenerator *NavigationMeshGenerator::get_singleton() {
 	return singleton;
 }
@@ -601,21 +1125,25 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 
 	Vector<float> vertices;
 	Vector<int> indices;
+	_parse_source_geometry(p_nav_mesh, p_node, vertices, indices);
 
-	List<Node *> parse_nodes;
-
-	if (p_nav_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_NAVMESH_CHILDREN) {
-		parse_nodes.push_back(p_node);
-	} else {
-		p_node->get_tree()->get_nodes_in_group(p_nav_mesh->get_source_group_name(), &parse_nodes);
-	}
+	if (p_nav_mesh->get_tile_size() >= 1.0f) {
+		if (vertices.size() > 0 && indices.size() > 0) {
+#ifdef TOOLS_ENABLED
+			if (ep) {
+				ep->step(TTR("Building tiles..."), 1);
+			}
+#endif
+			_build_recast_navigation_mesh_tiles(p_nav_mesh, vertices, indices, nullptr);
+		}
 
-	Transform3D navmesh_xform = Object::cast_to<Node3D>(p_node)->get_global_transform().affine_inverse();
-	for (Node *E : parse_nodes) {
-		NavigationMesh::ParsedGeometryType geometry_type = p_nav_mesh->get_parsed_geometry_type();
-		uint32_t collision_mask = p_nav_mesh->get_collision_mask();
-		bool recurse_children = p_nav_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
-		_parse_geometry(navmesh_xform, E, vertices, indices, geometry_type, collision_mask, recurse_children);
+#ifdef TOOLS_ENABLED
+		if (ep) {
+			ep->step(TTR("Done!"), 11);
+			memdelete(ep);
+		}
+#endif
+		return;
 	}
 
 	if (vertices.size() > 0 && indices.size() > 0) {
@@ -665,6 +1193,27 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 #endif
 }
 
+void NavigationMeshGenerator::bake_tiles(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_area) {
+	ERR_FAIL_COND_MSG(!p_nav_mesh.is_valid(), "Invalid navigation mesh.");
+
+	if (p_nav_mesh->get_tile_size() < 1.0f) {
+		// Without tiles there is nothing to keep, bake everything.
+		clear(p_nav_mesh);
+		bake(p_nav_mesh, p_node);
+		return;
+	}
+
+	Vector<float> vertices;
+	Vector<int> indices;
+	_parse_source_geometry(p_nav_mesh, p_node, vertices, indices);
+
+	if (vertices.size() > 0 && indices.size() > 0) {
+		_build_recast_navigation_mesh_tiles(p_nav_mesh, vertices, indices, &p_area);
+	} else {
+		clear(p_nav_mesh);
+	}
+}
+
 void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 	if (p_nav_mesh.is_valid()) {
 		p_nav_mesh->clear_polygons();
@@ -674,6 +1223,7 @@ void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 
 void NavigationMeshGenerator::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bake", "nav_mesh", "root_node"), &NavigationMeshGenerator::bake);
+	ClassDB::bind_method(D_METHOD("bake_tiles", "nav_mesh", "root_node", "area"), &NavigationMeshGenerator::bake_tiles);
 	ClassDB::bind_method(D_METHOD("clear", "nav_mesh"), &NavigationMeshGenerator::clear);
 }
 
@@ -33,6 +33,7 @@
 
 #ifndef _3D_DISABLED
 
+#include "core/templates/local_vector.h"
 #include "scene/3d/navigation_region_3d.h"
 
 #include <Recast.h>
@@ -46,6 +47,28 @@ class NavigationMeshGenerator : public Object {
 
 	static NavigationMeshGenerator *singleton;
 
+	struct RecastTile {
+		int x = 0;
+		int z = 0;
+		rcConfig cfg;
+		LocalVector<int> indices;
+
+		Vector<Vector3> vertices;
+		Vector<Vector<int>> polygons;
+	};
+
+	struct RecastTileBake {
+		const float *vertices = nullptr;
+		int vertex_count = 0;
+		NavigationMesh::SamplePartitionType partition_type = NavigationMesh::SAMPLE_PARTITION_WATERSHED;
+		bool filter_low_hanging_obstacles = false;
+		bool filter_ledge_spans = false;
+		bool filter_walkable_low_height_spans = false;
+		LocalVector<RecastTile> tiles;
+	};
+
+	void _build_recast_tile(uint32_t p_index, RecastTileBake *p_bake);
+
 protected:
 	static void _bind_methods();
 
@@ -54,6 +77,10 @@ protected:
 	static void _add_faces(const PackedVector3Array &p_faces, const Transform3D &p_xform, Vector<float> &p_vertices, Vector<int> &p_indices);
 	static void _parse_geometry(const Transform3D &p_navmesh_transform, Node *p_node, Vector<float> &p_vertices, Vector<int> &p_indices, NavigationMesh::ParsedGeometryType p_generate_from, uint32_t p_collision_mask, bool p_recurse_children);
 
+	static void _parse_source_geometry(Ref<NavigationMesh> p_nav_mesh, Node *p_node, Vector<float> &r_vertices, Vector<int> &r_indices);
+	static void _init_recast_config(Ref<NavigationMesh> p_nav_mesh, rcConfig &r_cfg);
+
+	static void _convert_detail_mesh(const rcPolyMeshDetail *p_detail_mesh, Vector<Vector3> &r_vertices, Vector<Vector<int>> &r_polygons);
 	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh);
 	static void _build_recast_navigation_mesh(
 			Ref<NavigationMesh> p_nav_mesh,
@@ -68,6 +95,10 @@ protected:
 			Vector<float> &vertices,
 			Vector<int> &indices);
 
+	static bool _build_recast_tile_mesh(const RecastTileBake &p_bake, RecastTile &r_tile, rcContext &r_ctx, rcHeightfield *&r_hf, rcCompactHeightfield *&r_chf, rcContourSet *&r_cset, rcPolyMesh *&r_poly_mesh, rcPolyMeshDetail *&r_detail_mesh);
+	static void _weld_tile_seams(Vector<Vector3> &r_vertices, LocalVector<Vector<int>> &r_polygons, real_t p_tile_world_size, real_t p_tolerance, real_t p_max_climb);
+	void _build_recast_navigation_mesh_tiles(Ref<NavigationMesh> p_nav_mesh, const Vector<float> &p_vertices, const Vector<int> &p_indices, const AABB *p_dirty_area);
+
 public:
 	static NavigationMeshGenerator *get_singleton();
 
@@ -75,6 +106,7 @@ public:
 	~NavigationMeshGenerator();
 
 	void bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node);
+	void bake_tiles(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_area);
 	void clear(Ref<NavigationMesh> p_nav_mesh);
 };
 
@@ -51,6 +51,13 @@ class RvoAgent : public NavRid {
 	AvoidanceComputedCallback callback;
 	uint32_t map_update_id = 0;
 
+	/// The new velocity is delivered with the batched results of the map.
+	bool batched = false;
+
+	/// Cell and slot of the agent in the avoidance grid of its map.
+	uint64_t grid_cell = 0;
+	uint32_t grid_slot = UINT32_MAX;
+
 public:
 	RvoAgent();
 
@@ -63,12 +70,45 @@ public:
 		return &agent;
 	}
 
+	const RVO::Agent *get_agent() const {
+		return &agent;
+	}
+
 	bool is_map_changed();
 
 	void set_callback(ObjectID p_id, const StringName p_method, const Variant p_udata = Variant());
 	bool has_callback() const;
 
 	void dispatch_callback();
+
+	void set_batched(bool p_batched) {
+		batched = p_batched;
+	}
+	bool is_batched() const {
+		return batched;
+	}
+
+	/// The avoidance is computed when the agent has a callback or batched results.
+	bool is_controlled() const {
+		return batched || has_callback();
+	}
+
+	void set_grid_location(uint64_t p_cell, uint32_t p_slot) {
+		grid_cell = p_cell;
+		grid_slot = p_slot;
+	}
+	void clear_grid_location() {
+		grid_slot = UINT32_MAX;
+	}
+	bool is_in_grid() const {
+		return grid_slot != UINT32_MAX;
+	}
+	uint64_t get_grid_cell() const {
+		return grid_cell;
+	}
+	uint32_t get_grid_slot() const {
+		return grid_slot;
+	}
 };
 
 #endif // RVO_AGENT_H
@@ -0,0 +1,291 @@
+/*************************************************************************/
+/*  test_godot_navigation_server.h                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_GODOT_NAVIGATION_SERVER_H
+#define TEST_GODOT_NAVIGATION_SERVER_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/thread.h"
+#include "modules/navigation/godot_navigation_server.h"
+#include "scene/resources/navigation_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotNavigationServer {
+
+// Grid of unit quads with a wall in the middle, so the paths have to go around it.
+static Ref<NavigationMesh> make_grid_navmesh(int p_size) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Ref<NavigationMesh> navmesh;
+	navmesh.instantiate();
+	navmesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			if (x == p_size / 2 && z > 0 && z < p_size - 1) {
+				continue;
+			}
+			Vector<int> polygon;
+			polygon.push_back(z * (p_size + 1) + x);
+			polygon.push_back((z + 1) * (p_size + 1) + x);
+			polygon.push_back((z + 1) * (p_size + 1) + x + 1);
+			polygon.push_back(z * (p_size + 1) + x + 1);
+			navmesh->add_polygon(polygon);
+		}
+	}
+	return navmesh;
+}
+
+struct TestMap {
+	GodotNavigationServer server;
+	RID map;
+	RID region;
+
+	TestMap() {
+		map = server.map_create();
+		server.map_set_active(map, true);
+		region = server.region_create();
+		server.region_set_map(region, map);
+		server.region_set_navmesh(region, make_grid_navmesh(16));
+		// Runs the commands and syncs the map.
+		server.process(0.0);
+	}
+
+	~TestMap() {
+		server.free(region);
+		server.free(map);
+		server.flush_queries();
+	}
+};
+
+static Vector3 random_point(RandomPCG &p_rng) {
+	return Vector3(p_rng.random(0.0, 16.0), 0, p_rng.random(0.0, 16.0));
+}
+
+TEST_CASE("[GodotNavigationServer] Asynchronous path queries match map_get_path") {
+	TestMap test;
+	RandomPCG rng(7);
+
+	LocalVector<int> queries;
+	LocalVector<Vector3> origins;
+	LocalVector<Vector3> destinations;
+	for (int i = 0; i < 100; i++) {
+		origins.push_back(random_point(rng));
+		destinations.push_back(random_point(rng));
+		queries.push_back(test.server.map_get_path_async(test.map, origins[i], destinations[i], i % 2 == 0));
+		CHECK_FALSE(test.server.path_query_is_done(queries[i]));
+	}
+
+	// A large budget, so the whole batch is done in a single call.
+	test.server.set_path_query_time_budget(1000000.0);
+	test.server.process(0.0);
+
+	int mismatches = 0;
+	for (uint32_t i = 0; i < queries.size(); i++) {
+		REQUIRE(test.server.path_query_is_done(queries[i]));
+		Vector<Vector3> path = test.server.path_query_get_result(queries[i]);
+		CHECK(path.size() > 0);
+		if (path != test.server.map_get_path(test.map, origins[i], destinations[i], i % 2 == 0)) {
+			mismatches++;
+		}
+		// The result is released once it's polled.
+		CHECK_FALSE(test.server.path_query_is_done(queries[i]));
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("[GodotNavigationServer] Path query time budget") {
+	TestMap test;
+	RandomPCG rng(11);
+
+	// Enough queries for several batches, whatever the number of worker threads.
+	const int query_count = OS::get_singleton()->get_processor_count() * 64;
+	LocalVector<int> queries;
+	for (int i = 0; i < query_count; i++) {
+		queries.push_back(test.server.map_get_path_async(test.map, random_point(rng), random_point(rng), true));
+	}
+
+	// Without budget, each call processes a single batch.
+	test.server.set_path_query_time_budget(0.0);
+	CHECK(test.server.get_path_query_time_budget() == 0.0);
+
+	int done = 0;
+	int calls = 0;
+	while (done < query_count && calls < query_count) {
+		test.server.process(0.0);
+		calls++;
+
+		int now_done = 0;
+		for (int i = 0; i < query_count; i++) {
+			now_done += test.server.path_query_is_done(queries[i]) ? 1 : 0;
+		}
+		CHECK(now_done > done);
+		done = now_done;
+	}
+
+	CHECK(done == query_count);
+	CHECK(calls > 1);
+}
+
+TEST_CASE("[GodotNavigationServer] Cancelled and expired path queries") {
+	TestMap test;
+
+	const int queued = test.server.map_get_path_async(test.map, Vector3(1, 0, 1), Vector3(15, 0, 15), true);
+	const int polled = test.server.map_get_path_async(test.map, Vector3(1, 0, 1), Vector3(15, 0, 1), true);
+	const int expired = test.server.map_get_path_async(test.map, Vector3(1, 0, 15), Vector3(15, 0, 15), true);
+
+	// Cancelled before it's processed.
+	test.server.path_query_cancel(queued);
+	test.server.process(0.0);
+	CHECK_FALSE(test.server.path_query_is_done(queued));
+
+	// Cancelled after it's done, but before it's polled.
+	CHECK(test.server.path_query_is_done(polled));
+	test.server.path_query_cancel(polled);
+	CHECK_FALSE(test.server.path_query_is_done(polled));
+
+	// Kept for a while, then released if it's never polled.
+	for (int i = 0; i < 10; i++) {
+		test.server.process(0.0);
+	}
+	CHECK(test.server.path_query_is_done(expired));
+
+	for (int i = 0; i < 1000 && test.server.path_query_is_done(expired); i++) {
+		test.server.process(0.0);
+	}
+	CHECK_FALSE(test.server.path_query_is_done(expired));
+}
+
+TEST_CASE("[GodotNavigationServer] Path queries are released with their map") {
+	TestMap test;
+
+	RID other_map = test.server.map_create();
+	test.server.map_set_active(other_map, true);
+	test.server.process(0.0);
+
+	const int done = test.server.map_get_path_async(other_map, Vector3(), Vector3(1, 0, 1), true);
+	test.server.process(0.0);
+	CHECK(test.server.path_query_is_done(done));
+
+	const int queued = test.server.map_get_path_async(other_map, Vector3(), Vector3(1, 0, 1), true);
+	const int kept = test.server.map_get_path_async(test.map, Vector3(1, 0, 1), Vector3(15, 0, 15), true);
+
+	test.server.free(other_map);
+	test.server.process(0.0);
+
+	CHECK_FALSE(test.server.path_query_is_done(done));
+	CHECK_FALSE(test.server.path_query_is_done(queued));
+	CHECK(test.server.path_query_is_done(kept));
+}
+
+// Calls back into the server, from another thread, and waits for the answer.
+// That deadlocks if the callback is called while the server is locked.
+class PathQueryCallback : public CallableCustom {
+	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return p_a == p_b;
+	}
+
+	static bool compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return p_a < p_b;
+	}
+
+	static void server_thread(void *p_userdata) {
+		PathQueryCallback *self = (PathQueryCallback *)p_userdata;
+		// Creating a resource locks the server.
+		self->thread_region = self->test->server.region_create();
+		self->thread_path = self->test->server.map_get_path(self->test->map, self->origin, self->destination, true);
+	}
+
+public:
+	TestMap *test = nullptr;
+	Vector3 origin;
+	Vector3 destination;
+	int cancelled_query = 0;
+	mutable RID thread_region;
+	mutable Vector<Vector3> thread_path;
+	mutable LocalVector<int> called_queries;
+	mutable int mismatches = 0;
+	mutable int queued_query = 0;
+
+	virtual uint32_t hash() const override { return hash_djb2_one_64((uint64_t)this); }
+	virtual String get_as_text() const override { return "PathQueryCallback"; }
+	virtual CompareEqualFunc get_compare_equal_func() const override { return compare_equal; }
+	virtual CompareLessFunc get_compare_less_func() const override { return compare_less; }
+	virtual ObjectID get_object() const override { return ObjectID(); }
+
+	virtual void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const override {
+		r_call_error.error = Callable::CallError::CALL_OK;
+		called_queries.push_back(*p_arguments[0]);
+
+		Thread thread;
+		thread.start(server_thread, const_cast<PathQueryCallback *>(this));
+		thread.wait_to_finish();
+		test->server.free(thread_region);
+		if (thread_path != Vector<Vector3>(*p_arguments[1])) {
+			mismatches++;
+		}
+
+		test->server.path_query_cancel(cancelled_query);
+		queued_query = test->server.map_get_path_async(test->map, origin, destination, true);
+	}
+};
+
+TEST_CASE("[GodotNavigationServer] Path query callbacks can call back into the server") {
+	TestMap test;
+	test.server.set_path_query_time_budget(1000000.0);
+
+	PathQueryCallback *callback = memnew(PathQueryCallback);
+	callback->test = &test;
+	callback->origin = Vector3(1, 0, 1);
+	callback->destination = Vector3(15, 0, 15);
+	Callable callable(callback);
+
+	const int called = test.server.map_get_path_async(test.map, callback->origin, callback->destination, true, callable);
+	// Done in the same batch, but cancelled by the first callback before its own is called.
+	callback->cancelled_query = test.server.map_get_path_async(test.map, callback->origin, callback->destination, true, callable);
+	test.server.process(0.0);
+
+	REQUIRE(callback->called_queries.size() == 1);
+	CHECK(callback->called_queries[0] == called);
+	CHECK(callback->mismatches == 0);
+
+	// Queries queued from a callback are processed on the next call.
+	CHECK_FALSE(test.server.path_query_is_done(callback->queued_query));
+	test.server.process(0.0);
+	CHECK(test.server.path_query_is_done(callback->queued_query));
+}
+} // namespace TestGodotNavigationServer
+
+#endif // TEST_GODOT_NAVIGATION_SERVER_H
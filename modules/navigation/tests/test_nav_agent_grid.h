@@ -0,0 +1,129 @@
+/*************************************************************************/
+/*  test_nav_region_graph.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAV_AGENT_GRID_H
+#define TEST_NAV_AGENT_GRID_H
+
+#include "core/math/random_pcg.h"
+#include "modules/navigation/nav_agent_grid.h"
+#include "modules/navigation/rvo_agent.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavAgentGrid {
+
+// Same search as the grid, but going through all the agents.
+static void compute_neighbors_brute_force(RVO::Agent *p_agent, const std::vector<RvoAgent *> &p_agents) {
+	p_agent->agentNeighbors_.clear();
+	if (p_agent->maxNeighbors_ == 0) {
+		return;
+	}
+	float range_sq = p_agent->neighborDist_ * p_agent->neighborDist_;
+	for (size_t i = 0; i < p_agents.size(); i++) {
+		p_agent->insertAgentNeighbor(p_agents[i]->get_agent(), range_sq);
+	}
+}
+
+static bool check_neighbors(const NavAgentGrid &p_grid, const std::vector<RvoAgent *> &p_agents) {
+	for (size_t i = 0; i < p_agents.size(); i++) {
+		RVO::Agent *agent = p_agents[i]->get_agent();
+		compute_neighbors_brute_force(agent, p_agents);
+		const std::vector<std::pair<float, const RVO::Agent *>> expected = agent->agentNeighbors_;
+		p_grid.compute_neighbors(agent);
+		if (agent->agentNeighbors_.size() != expected.size()) {
+			return false;
+		}
+		for (size_t j = 0; j < expected.size(); j++) {
+			// Neighbors at the same distance can be found in any order.
+			if (agent->agentNeighbors_[j].first != expected[j].first) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void randomize_positions(std::vector<RvoAgent *> &p_agents, RandomPCG &p_rng, float p_extent) {
+	for (size_t i = 0; i < p_agents.size(); i++) {
+		p_agents[i]->get_agent()->position_ = RVO::Vector3(p_rng.random(-p_extent, p_extent), 0, p_rng.random(-p_extent, p_extent));
+	}
+}
+
+TEST_CASE("[NavAgentGrid] Neighbors match an exhaustive search") {
+	RandomPCG rng(7);
+	std::vector<RvoAgent *> agents;
+	for (int i = 0; i < 200; i++) {
+		RvoAgent *agent = memnew(RvoAgent);
+		agent->get_agent()->neighborDist_ = rng.random(1.0f, 4.0f);
+		agent->get_agent()->maxNeighbors_ = i % 2 ? 10 : 3;
+		agents.push_back(agent);
+	}
+	randomize_positions(agents, rng, 20.0);
+
+	NavAgentGrid grid;
+	grid.update(agents);
+	for (size_t i = 0; i < agents.size(); i++) {
+		CHECK(agents[i]->is_in_grid());
+	}
+	CHECK(check_neighbors(grid, agents));
+
+	SUBCASE("Moved agents are found in their new cells") {
+		randomize_positions(agents, rng, 20.0);
+		grid.update(agents);
+		CHECK(check_neighbors(grid, agents));
+	}
+
+	SUBCASE("Larger neighbor distances rebuild the grid") {
+		agents[0]->get_agent()->neighborDist_ = 12.0;
+		agents[0]->get_agent()->maxNeighbors_ = 100;
+		grid.update(agents);
+		CHECK(check_neighbors(grid, agents));
+	}
+
+	SUBCASE("Removed agents are no longer neighbors") {
+		for (int i = 0; i < 100; i++) {
+			grid.remove(agents.back());
+			CHECK_FALSE(agents.back()->is_in_grid());
+			memdelete(agents.back());
+			agents.pop_back();
+		}
+		CHECK(check_neighbors(grid, agents));
+	}
+
+	grid.clear();
+	for (size_t i = 0; i < agents.size(); i++) {
+		CHECK_FALSE(agents[i]->is_in_grid());
+		memdelete(agents[i]);
+	}
+}
+
+} // namespace TestNavAgentGrid
+
+#endif // TEST_NAV_AGENT_GRID_H
@@ -0,0 +1,198 @@
+/*************************************************************************/
+/*  test_nav_free_edge_links.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAV_FREE_EDGE_LINKS_H
+#define TEST_NAV_FREE_EDGE_LINKS_H
+
+#include "modules/navigation/nav_free_edge_links.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+#include "scene/resources/navigation_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavFreeEdgeLinks {
+
+// Grid of unit quads.
+static Ref<NavigationMesh> make_quad_navmesh(int p_size) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Ref<NavigationMesh> navmesh;
+	navmesh.instantiate();
+	navmesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector<int> polygon;
+			polygon.push_back(z * (p_size + 1) + x);
+			polygon.push_back((z + 1) * (p_size + 1) + x);
+			polygon.push_back((z + 1) * (p_size + 1) + x + 1);
+			polygon.push_back(z * (p_size + 1) + x + 1);
+			navmesh->add_polygon(polygon);
+		}
+	}
+	return navmesh;
+}
+
+static void add_region(NavMap &p_map, NavRegion &p_region, const Ref<NavigationMesh> &p_navmesh, const Vector3 &p_origin) {
+	p_region.set_map(&p_map);
+	p_region.set_mesh(p_navmesh);
+	p_region.set_transform(Transform3D(Basis(), p_origin));
+	p_map.add_region(&p_region);
+}
+
+// The links as sorted strings, so links made in any order can be compared.
+static Vector<String> get_links(const NavFreeEdgeLinks &p_links, const NavRegion *p_regions, int p_region_count) {
+	Vector<String> links;
+	for (uint32_t i = 0; i < p_links.get_link_count(); i++) {
+		const NavFreeEdgeLinks::Link link = p_links.get_link(i);
+		const int region = link.region - p_regions;
+		const int other_region = link.other_region - p_regions;
+		CHECK(region >= 0);
+		CHECK(region < p_region_count);
+		CHECK(other_region >= 0);
+		CHECK(other_region < p_region_count);
+		CHECK(region != other_region);
+		links.push_back(vformat("%d %d %d -> ", region, link.polygon, link.edge) + vformat("%d %d %d ", other_region, link.other_polygon, link.other_edge) + vformat("%s %s %s", link.pathway_start, link.pathway_end, link.exact));
+	}
+	links.sort();
+	return links;
+}
+
+TEST_CASE("[NavFreeEdgeLinks] Adjacent regions are connected") {
+	NavMap map;
+	// Smaller than the quads, so the edges along the borders of the regions aren't linked.
+	map.set_edge_connection_margin(0.75);
+	Ref<NavigationMesh> navmesh = make_quad_navmesh(4);
+
+	// The second region shares its edge with the first one, the third is
+	// separated from the second by a gap smaller than the margin.
+	NavRegion regions[3];
+	add_region(map, regions[0], navmesh, Vector3());
+	add_region(map, regions[1], navmesh, Vector3(4, 0, 0));
+	add_region(map, regions[2], navmesh, Vector3(8.5, 0, 0));
+	map.sync();
+
+	// The shared edges are connected to each other, they aren't region connections.
+	CHECK(regions[0].get_connections_count() == 0);
+	CHECK(regions[1].get_connections_count() >= 4);
+	CHECK(regions[1].get_connections_count() == regions[2].get_connections_count());
+
+	const Vector3 origin(0.5, 0, 2.5);
+	const Vector3 destination(12.0, 0, 1.5);
+	const Vector<Vector3> path = map.get_path(origin, destination, true);
+	REQUIRE(path.size() >= 2);
+	CHECK(path[0].distance_to(origin) < 0.01);
+	CHECK(path[path.size() - 1].distance_to(destination) < 0.01);
+
+	// Without the links, the path stops in the first region.
+	map.set_edge_connection_margin(0.1);
+	regions[1].set_transform(Transform3D(Basis(), Vector3(0, 0, 8)));
+	map.sync();
+	const Vector<Vector3> split_path = map.get_path(origin, destination, true);
+	REQUIRE(split_path.size() >= 1);
+	CHECK(split_path[split_path.size() - 1].x <= 4.0 + CMP_EPSILON);
+}
+
+TEST_CASE("[NavFreeEdgeLinks] Updating changed regions matches linking all of them") {
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+	Ref<NavigationMesh> navmesh = make_quad_navmesh(4);
+	Ref<NavigationMesh> large_navmesh = make_quad_navmesh(8);
+
+	const int region_count = 4;
+	NavRegion regions[region_count];
+	add_region(map, regions[0], navmesh, Vector3());
+	add_region(map, regions[1], navmesh, Vector3(4, 0, 0));
+	add_region(map, regions[2], navmesh, Vector3(8.5, 0, 0));
+	add_region(map, regions[3], navmesh, Vector3(0, 0, 4.25));
+	map.sync();
+
+	NavFreeEdgeLinks links;
+	links.set_margin(1.0);
+	for (int i = 0; i < region_count; i++) {
+		links.add_region(&regions[i]);
+	}
+	links.update();
+	CHECK(links.get_link_count() > 0);
+
+	const auto check_relinked = [&](const LocalVector<int> &p_changed) {
+		map.sync();
+		for (uint32_t i = 0; i < p_changed.size(); i++) {
+			links.remove_region(&regions[p_changed[i]]);
+			links.add_region(&regions[p_changed[i]]);
+		}
+		links.update();
+
+		NavFreeEdgeLinks all_links;
+		all_links.set_margin(1.0);
+		for (int i = 0; i < region_count; i++) {
+			all_links.add_region(&regions[i]);
+		}
+		all_links.update();
+
+		CHECK(get_links(links, regions, region_count) == get_links(all_links, regions, region_count));
+	};
+
+	// Moved next to another region.
+	regions[2].set_transform(Transform3D(Basis(), Vector3(8.25, 0, 1)));
+	check_relinked({ 2 });
+
+	// Moved away from all the regions.
+	regions[1].set_transform(Transform3D(Basis(), Vector3(40, 0, 0)));
+	check_relinked({ 1 });
+
+	// Moved back, with longer edges than the cells were sized for.
+	regions[1].set_mesh(large_navmesh);
+	regions[1].set_transform(Transform3D(Basis(), Vector3(4, 0, -2)));
+	check_relinked({ 1 });
+
+	// Several regions at once.
+	regions[0].set_transform(Transform3D(Basis(), Vector3(0, 0, 0.5)));
+	regions[3].set_transform(Transform3D(Basis(), Vector3(-4, 0, 0.5)));
+	check_relinked({ 0, 3 });
+
+	// Removed.
+	links.remove_region(&regions[2]);
+	links.update();
+	for (uint32_t i = 0; i < links.get_link_count(); i++) {
+		const NavFreeEdgeLinks::Link link = links.get_link(i);
+		CHECK(link.region != &regions[2]);
+		CHECK(link.other_region != &regions[2]);
+	}
+}
+
+} // namespace TestNavFreeEdgeLinks
+
+#endif // TEST_NAV_FREE_EDGE_LINKS_H
@@ -0,0 +1,122 @@
+/*************************************************************************/
+/*  test_nav_polygon_tree.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAV_POLYGON_TREE_H
+#define TEST_NAV_POLYGON_TREE_H
+
+#include "core/math/random_pcg.h"
+#include "modules/navigation/nav_polygon_tree.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavPolygonTree {
+
+static LocalVector<AABB> make_grid_aabbs(int p_size, real_t p_cell_size) {
+	LocalVector<AABB> aabbs;
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			// Flat boxes, like navigation polygons.
+			aabbs.push_back(AABB(Vector3(x * p_cell_size, (x + z) * 0.1, z * p_cell_size), Vector3(p_cell_size, 0, p_cell_size)));
+		}
+	}
+	return aabbs;
+}
+
+TEST_CASE("[NavPolygonTree] Empty tree") {
+	NavPolygonTree tree;
+	CHECK(tree.is_empty());
+
+	tree.build(LocalVector<AABB>());
+	CHECK(tree.is_empty());
+
+	int visits = 0;
+	real_t best = 1e20;
+	auto lower_bound = [](const AABB &p_aabb) { return real_t(0.0); };
+	auto visit = [&](uint32_t p_item) { visits++; };
+	tree.query_nearest(lower_bound, visit, best);
+	CHECK(visits == 0);
+}
+
+TEST_CASE("[NavPolygonTree] Bounds") {
+	NavPolygonTree tree;
+	tree.build(make_grid_aabbs(10, 2.0));
+
+	CHECK_FALSE(tree.is_empty());
+	const AABB bounds = tree.get_bounds();
+	CHECK(bounds.position.is_equal_approx(Vector3(0, 0, 0)));
+	CHECK(bounds.size.is_equal_approx(Vector3(20, 1.8, 20)));
+
+	tree.clear();
+	CHECK(tree.is_empty());
+}
+
+TEST_CASE("[NavPolygonTree] Nearest item matches a linear search") {
+	const LocalVector<AABB> aabbs = make_grid_aabbs(40, 1.5);
+
+	NavPolygonTree tree;
+	tree.build(aabbs);
+
+	RandomPCG rng(42);
+
+	for (int i = 0; i < 100; i++) {
+		const Vector3 point(rng.random(-10.0f, 70.0f), rng.random(-5.0f, 10.0f), rng.random(-10.0f, 70.0f));
+
+		real_t expected = 1e20;
+		for (uint32_t j = 0; j < aabbs.size(); j++) {
+			expected = MIN(expected, aabbs[j].get_center().distance_squared_to(point));
+		}
+
+		int visits = 0;
+		real_t best = 1e20;
+		auto lower_bound = [&](const AABB &p_aabb) {
+			return NavPolygonTree::get_aabb_distance_squared(p_aabb, point);
+		};
+		auto visit = [&](uint32_t p_item) {
+			visits++;
+			best = MIN(best, aabbs[p_item].get_center().distance_squared_to(point));
+		};
+		tree.query_nearest(lower_bound, visit, best);
+
+		CHECK(best == doctest::Approx(expected));
+		// The search must not degrade to visiting every item.
+		CHECK(visits < int(aabbs.size() / 10));
+	}
+}
+
+TEST_CASE("[NavPolygonTree] Box distance") {
+	const AABB aabb(Vector3(0, 0, 0), Vector3(2, 0, 2));
+	CHECK(NavPolygonTree::get_aabb_distance_squared(aabb, Vector3(1, 0, 1)) == doctest::Approx(0));
+	CHECK(NavPolygonTree::get_aabb_distance_squared(aabb, Vector3(1, 3, 1)) == doctest::Approx(9));
+	CHECK(NavPolygonTree::get_aabb_distance_squared(aabb, Vector3(-1, 0, 4)) == doctest::Approx(5));
+}
+
+} // namespace TestNavPolygonTree
+
+#endif // TEST_NAV_POLYGON_TREE_H
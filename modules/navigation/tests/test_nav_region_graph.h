@@ -0,0 +1,170 @@
+/*************************************************************************/
+/*  test_nav_region_graph.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAV_REGION_GRAPH_H
+#define TEST_NAV_REGION_GRAPH_H
+
+#include "modules/navigation/nav_region.h"
+#include "modules/navigation/nav_region_graph.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavRegionGraph {
+
+// Grid of unit quads, split in regions of `p_region_size` columns, with all the neighbor quads connected.
+static void make_grid_polygons(std::vector<gd::Polygon> &r_polygons, NavRegion *p_regions, int p_region_count, int p_region_size, int p_height) {
+	const int width = p_region_count * p_region_size;
+	r_polygons.clear();
+	r_polygons.resize(width * p_height);
+
+	// The polygons of a region must be contiguous, so they are sorted by region.
+	auto polygon_index = [&](int p_x, int p_z) {
+		const int region = p_x / p_region_size;
+		return region * p_region_size * p_height + p_z * p_region_size + p_x % p_region_size;
+	};
+
+	for (int z = 0; z < p_height; z++) {
+		for (int x = 0; x < width; x++) {
+			gd::Polygon &polygon = r_polygons[polygon_index(x, z)];
+			polygon.owner = &p_regions[x / p_region_size];
+			polygon.center = Vector3(x + 0.5, 0, z + 0.5);
+			polygon.edges.resize(4);
+
+			const int neighbors[4][2] = { { x - 1, z }, { x + 1, z }, { x, z - 1 }, { x, z + 1 } };
+			for (int i = 0; i < 4; i++) {
+				if (neighbors[i][0] < 0 || neighbors[i][0] >= width || neighbors[i][1] < 0 || neighbors[i][1] >= p_height) {
+					continue;
+				}
+				gd::Edge::Connection connection;
+				connection.polygon = &r_polygons[polygon_index(neighbors[i][0], neighbors[i][1])];
+				connection.edge = i;
+				polygon.edges[i].connections.push_back(connection);
+			}
+		}
+	}
+}
+
+TEST_CASE("[NavRegionGraph] Clusters and portals") {
+	NavRegion regions[3];
+	std::vector<gd::Polygon> polygons;
+	make_grid_polygons(polygons, regions, 3, 4, 4);
+
+	NavRegionGraph graph;
+	CHECK(graph.is_empty());
+
+	graph.update(polygons, LocalVector<const NavRegion *>());
+	CHECK(graph.get_cluster_count() == 3);
+	// Each side of the two connections has a portal per connected polygon, 4 at most.
+	CHECK(graph.get_portal_count() == 4 * 4);
+
+	// A narrow connection has a single portal on each side.
+	make_grid_polygons(polygons, regions, 3, 4, 1);
+
+	graph.update(polygons, LocalVector<const NavRegion *>());
+	CHECK_FALSE(graph.is_empty());
+	CHECK(graph.get_cluster_count() == 3);
+	CHECK(graph.get_portal_count() == 4);
+	CHECK(graph.get_polygon_cluster(0) == 0);
+	CHECK(graph.get_polygon_cluster(polygons.size() - 1) == 2);
+
+	graph.clear();
+	CHECK(graph.is_empty());
+}
+
+TEST_CASE("[NavRegionGraph] Corridor") {
+	NavRegion regions[3];
+	std::vector<gd::Polygon> polygons;
+	make_grid_polygons(polygons, regions, 3, 4, 4);
+
+	NavRegionGraph graph;
+	graph.update(polygons, LocalVector<const NavRegion *>());
+
+	LocalVector<uint32_t> corridor;
+	const uint32_t end_polygon = polygons.size() - 1;
+	CHECK(graph.find_corridor(polygons, 0, end_polygon, polygons[end_polygon].center, 1, corridor));
+	REQUIRE(corridor.size() == 3);
+	CHECK(corridor[0] == 0);
+	CHECK(corridor[1] == 1);
+	CHECK(corridor[2] == 2);
+
+	CHECK(graph.find_corridor(polygons, end_polygon, 0, polygons[0].center, 1, corridor));
+	REQUIRE(corridor.size() == 3);
+	CHECK(corridor[0] == 2);
+	CHECK(corridor[2] == 0);
+
+	// Both ends in the same region.
+	CHECK(graph.find_corridor(polygons, 0, 1, polygons[1].center, 1, corridor));
+	REQUIRE(corridor.size() == 1);
+	CHECK(corridor[0] == 0);
+}
+
+TEST_CASE("[NavRegionGraph] Corridor with incompatible layers") {
+	NavRegion regions[3];
+	regions[1].set_layers(2);
+	std::vector<gd::Polygon> polygons;
+	make_grid_polygons(polygons, regions, 3, 4, 4);
+
+	NavRegionGraph graph;
+	graph.update(polygons, LocalVector<const NavRegion *>());
+
+	LocalVector<uint32_t> corridor;
+	const uint32_t end_polygon = polygons.size() - 1;
+	CHECK_FALSE(graph.find_corridor(polygons, 0, end_polygon, polygons[end_polygon].center, 1, corridor));
+	CHECK(graph.find_corridor(polygons, 0, end_polygon, polygons[end_polygon].center, 3, corridor));
+}
+
+TEST_CASE("[NavRegionGraph] Update after a region change") {
+	NavRegion regions[3];
+	std::vector<gd::Polygon> polygons;
+	make_grid_polygons(polygons, regions, 3, 4, 4);
+
+	NavRegionGraph graph;
+	graph.update(polygons, LocalVector<const NavRegion *>());
+
+	// Cut the last region in two, its portal isn't connected to the far side anymore.
+	for (int z = 0; z < 4; z++) {
+		gd::Polygon &polygon = polygons[2 * 16 + z * 4 + 1];
+		gd::Polygon &neighbor = polygons[2 * 16 + z * 4 + 2];
+		polygon.edges[1].connections.clear();
+		neighbor.edges[0].connections.clear();
+	}
+	LocalVector<const NavRegion *> changed_regions;
+	changed_regions.push_back(&regions[2]);
+	graph.update(polygons, changed_regions);
+
+	LocalVector<uint32_t> corridor;
+	const uint32_t end_polygon = polygons.size() - 1;
+	CHECK_FALSE(graph.find_corridor(polygons, 0, end_polygon, polygons[end_polygon].center, 1, corridor));
+	CHECK(graph.find_corridor(polygons, 0, 2 * 16, polygons[2 * 16].center, 1, corridor));
+}
+
+} // namespace TestNavRegionGraph
+
+#endif // TEST_NAV_REGION_GRAPH_H
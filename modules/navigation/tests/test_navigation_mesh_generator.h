@@ -0,0 +1,233 @@
+/*************************************************************************/
+/*  test_navigation_mesh_generator.h                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_MESH_GENERATOR_H
+#define TEST_NAVIGATION_MESH_GENERATOR_H
+
+#ifndef _3D_DISABLED
+
+#include "modules/navigation/navigation_mesh_generator.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/primitive_meshes.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationMeshGenerator {
+
+// The tiles are 19.2 units wide.
+static const float CELL_SIZE = 0.3;
+static const float TILE_SIZE = 64.0;
+static const float TILE_WORLD_SIZE = CELL_SIZE * TILE_SIZE;
+
+// Floor of 3x3 tiles with a box on the middle tile.
+struct TestScene {
+	Node3D *root = nullptr;
+	MeshInstance3D *box = nullptr;
+
+	TestScene() {
+		root = memnew(Node3D);
+		SceneTree::get_singleton()->get_root()->add_child(root);
+
+		Ref<PlaneMesh> plane_mesh;
+		plane_mesh.instantiate();
+		plane_mesh->set_size(Size2(TILE_WORLD_SIZE * 3, TILE_WORLD_SIZE * 3));
+		MeshInstance3D *floor = memnew(MeshInstance3D);
+		floor->set_mesh(plane_mesh);
+		floor->set_position(Vector3(TILE_WORLD_SIZE * 1.5, 0, TILE_WORLD_SIZE * 1.5));
+		root->add_child(floor);
+
+		Ref<BoxMesh> box_mesh;
+		box_mesh.instantiate();
+		box_mesh->set_size(Vector3(3, 2, 3));
+		box = memnew(MeshInstance3D);
+		box->set_mesh(box_mesh);
+		box->set_position(Vector3(28, 1, 28));
+		root->add_child(box);
+	}
+
+	~TestScene() {
+		memdelete(root);
+	}
+
+	Ref<NavigationMesh> bake(float p_tile_size) {
+		Ref<NavigationMesh> navmesh;
+		navmesh.instantiate();
+		navmesh->set_cell_size(CELL_SIZE);
+		navmesh->set_tile_size(p_tile_size);
+		NavigationMeshGenerator::get_singleton()->bake(navmesh, root);
+		return navmesh;
+	}
+};
+
+static real_t get_area(Ref<NavigationMesh> p_navmesh) {
+	const Vector<Vector3> vertices = p_navmesh->get_vertices();
+	real_t area = 0.0;
+	for (int i = 0; i < p_navmesh->get_polygon_count(); i++) {
+		const Vector<int> polygon = p_navmesh->get_polygon(i);
+		for (int j = 0; j < polygon.size(); j++) {
+			const Vector3 &from = vertices[polygon[j]];
+			const Vector3 &to = vertices[polygon[(j + 1) % polygon.size()]];
+			area += from.x * to.z - to.x * from.z;
+		}
+	}
+	return Math::abs(area) * 0.5;
+}
+
+// Checks that every vertex is used, that no two vertices of a seam are on the same point and that the vertices
+// on a seam are used by the polygons of both sides.
+static void check_seam_vertices(Ref<NavigationMesh> p_navmesh) {
+	const Vector<Vector3> vertices = p_navmesh->get_vertices();
+	LocalVector<int> polygon_count;
+	LocalVector<uint8_t> seam_sides;
+	polygon_count.resize(vertices.size());
+	seam_sides.resize(vertices.size() * 2);
+	for (int i = 0; i < vertices.size(); i++) {
+		polygon_count[i] = 0;
+		seam_sides[i * 2] = 0;
+		seam_sides[i * 2 + 1] = 0;
+	}
+
+	auto get_seam_line = [](real_t p_coordinate) {
+		return Math::round(p_coordinate / TILE_WORLD_SIZE) * TILE_WORLD_SIZE;
+	};
+
+	for (int i = 0; i < p_navmesh->get_polygon_count(); i++) {
+		const Vector<int> polygon = p_navmesh->get_polygon(i);
+		Vector3 center;
+		for (int j = 0; j < polygon.size(); j++) {
+			center += vertices[polygon[j]];
+		}
+		center /= polygon.size();
+
+		for (int j = 0; j < polygon.size(); j++) {
+			const Vector3 &vertex = vertices[polygon[j]];
+			polygon_count[polygon[j]]++;
+			for (int axis = 0; axis <= 2; axis += 2) {
+				const real_t line = get_seam_line(vertex[axis]);
+				if (Math::is_equal_approx(vertex[axis], line)) {
+					seam_sides[polygon[j] * 2 + axis / 2] |= center[axis] < line ? 1 : 2;
+				}
+			}
+		}
+	}
+
+	int unused = 0;
+	int one_sided = 0;
+	int duplicates = 0;
+	for (int i = 0; i < vertices.size(); i++) {
+		if (polygon_count[i] == 0) {
+			unused++;
+		}
+		if (seam_sides[i * 2] == 1 || seam_sides[i * 2] == 2 || seam_sides[i * 2 + 1] == 1 || seam_sides[i * 2 + 1] == 2) {
+			one_sided++;
+		}
+		if (seam_sides[i * 2] == 0 && seam_sides[i * 2 + 1] == 0) {
+			continue;
+		}
+		for (int j = i + 1; j < vertices.size(); j++) {
+			if (vertices[i].is_equal_approx(vertices[j])) {
+				duplicates++;
+			}
+		}
+	}
+	CHECK(unused == 0);
+	CHECK(one_sided == 0);
+	CHECK(duplicates == 0);
+}
+
+TEST_CASE("[SceneTree][NavigationMeshGenerator] Tiled bake covers the same area as a single bake") {
+	TestScene scene;
+	const Ref<NavigationMesh> single = scene.bake(0.0);
+	const Ref<NavigationMesh> tiled = scene.bake(TILE_SIZE);
+
+	REQUIRE(single->get_polygon_count() > 0);
+	REQUIRE(tiled->get_polygon_count() > 0);
+	// The tiles are eroded along the bounds of the geometry a bit differently.
+	CHECK(Math::abs(get_area(tiled) - get_area(single)) < get_area(single) * 0.02);
+	check_seam_vertices(tiled);
+}
+
+TEST_CASE("[SceneTree][NavigationMeshGenerator] Partial rebake matches a full bake") {
+	TestScene scene;
+	Ref<NavigationMesh> navmesh = scene.bake(TILE_SIZE);
+
+	// Split a seam edge of a polygon next to the middle tile, like an older weld with other
+	// vertices on the middle tile would have.
+	Vector<Vector3> vertices = navmesh->get_vertices();
+	Vector<Vector<int>> polygons;
+	bool split = false;
+	for (int i = 0; i < navmesh->get_polygon_count(); i++) {
+		Vector<int> polygon = navmesh->get_polygon(i);
+		Vector3 center;
+		for (int j = 0; j < polygon.size(); j++) {
+			center += vertices[polygon[j]];
+		}
+		center /= polygon.size();
+
+		if (!split && center.x < TILE_WORLD_SIZE && center.z > TILE_WORLD_SIZE && center.z < TILE_WORLD_SIZE * 2) {
+			for (int j = 0; j < polygon.size(); j++) {
+				const Vector3 &from = vertices[polygon[j]];
+				const Vector3 &to = vertices[polygon[(j + 1) % polygon.size()]];
+				if (Math::is_equal_approx(from.x, TILE_WORLD_SIZE) && Math::is_equal_approx(to.x, TILE_WORLD_SIZE)) {
+					vertices.push_back((from + to) * 0.5);
+					polygon.insert(j + 1, vertices.size() - 1);
+					split = true;
+					break;
+				}
+			}
+		}
+		polygons.push_back(polygon);
+	}
+	REQUIRE(split);
+	navmesh->clear_polygons();
+	navmesh->set_vertices(vertices);
+	for (int i = 0; i < polygons.size(); i++) {
+		navmesh->add_polygon(polygons[i]);
+	}
+
+	// Only the middle tile is rebuilt.
+	const AABB previous_box(scene.box->get_position() - Vector3(1.5, 1, 1.5), Vector3(3, 2, 3));
+	scene.box->set_position(Vector3(30, 1, 32));
+	const AABB box(scene.box->get_position() - Vector3(1.5, 1, 1.5), Vector3(3, 2, 3));
+	NavigationMeshGenerator::get_singleton()->bake_tiles(navmesh, scene.root, previous_box.merge(box));
+
+	const Ref<NavigationMesh> full = scene.bake(TILE_SIZE);
+	CHECK(navmesh->get_vertices().size() == full->get_vertices().size());
+	CHECK(navmesh->get_polygon_count() == full->get_polygon_count());
+	CHECK(get_area(navmesh) == doctest::Approx(get_area(full)));
+	check_seam_vertices(navmesh);
+}
+
+} // namespace TestNavigationMeshGenerator
+
+#endif // _3D_DISABLED
+
+#endif // TEST_NAVIGATION_MESH_GENERATOR_H
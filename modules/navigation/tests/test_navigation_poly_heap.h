@@ -0,0 +1,114 @@
+/*************************************************************************/
+/*  test_navigation_poly_heap.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_POLY_HEAP_H
+#define TEST_NAVIGATION_POLY_HEAP_H
+
+#include "core/math/random_pcg.h"
+#include "modules/navigation/nav_utils.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationPolyHeap {
+
+TEST_CASE("[NavigationPolyHeap] Pops in cost order") {
+	gd::NavigationPolyHeap heap;
+	CHECK(heap.is_empty());
+
+	const float costs[] = { 5, 1, 4, 2, 3, 0.5 };
+	for (uint32_t i = 0; i < 6; i++) {
+		heap.push(i, costs[i]);
+	}
+	CHECK(heap.has(3));
+	CHECK_FALSE(heap.has(6));
+
+	CHECK(heap.pop() == 5);
+	CHECK(heap.pop() == 1);
+	CHECK(heap.pop() == 3);
+	CHECK_FALSE(heap.has(3));
+	CHECK(heap.pop() == 4);
+	CHECK(heap.pop() == 2);
+	CHECK(heap.pop() == 0);
+	CHECK(heap.is_empty());
+}
+
+TEST_CASE("[NavigationPolyHeap] Update") {
+	gd::NavigationPolyHeap heap;
+	for (uint32_t i = 0; i < 10; i++) {
+		heap.push(i, 10 + i);
+	}
+
+	heap.update(7, 1);
+	heap.update(0, 100);
+	CHECK(heap.pop() == 7);
+	CHECK(heap.pop() == 1);
+
+	const uint32_t remaining[] = { 2, 3, 4, 5, 6, 8, 9 };
+	for (uint32_t id : remaining) {
+		CHECK(heap.pop() == id);
+	}
+	CHECK(heap.pop() == 0);
+	CHECK(heap.is_empty());
+}
+
+TEST_CASE("[NavigationPolyHeap] Clear and reuse") {
+	gd::NavigationPolyHeap heap;
+	RandomPCG rng(7);
+	float costs[200];
+
+	for (int round = 0; round < 3; round++) {
+		heap.clear();
+		CHECK(heap.is_empty());
+		CHECK_FALSE(heap.has(0));
+
+		for (uint32_t i = 0; i < 200; i++) {
+			costs[i] = rng.randf();
+			heap.push(i, costs[i]);
+		}
+		for (uint32_t i = 0; i < 200; i += 3) {
+			costs[i] = rng.randf();
+			heap.update(i, costs[i]);
+		}
+
+		// Leave some ids in the heap for the next round to clear.
+		float previous_cost = -1.0;
+		bool ordered = true;
+		for (int i = 0; i < 150; i++) {
+			const uint32_t id = heap.pop();
+			ordered = ordered && costs[id] >= previous_cost;
+			previous_cost = costs[id];
+		}
+		CHECK(ordered);
+	}
+}
+
+} // namespace TestNavigationPolyHeap
+
+#endif // TEST_NAVIGATION_POLY_HEAP_H
@@ -30,6 +30,8 @@
 
 #include "register_types.h"
 
+#include "core/config/project_settings.h"
+
 #include "lightmap_raycaster.h"
 #include "raycast_occlusion_cull.h"
 #include "static_raycaster.h"
@@ -41,7 +43,9 @@ void register_raycast_types() {
 	LightmapRaycasterEmbree::make_default_raycaster();
 	StaticRaycasterEmbree::make_default_raycaster();
 #endif
-	raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	if (!GLOBAL_GET("rendering/occlusion_culling/use_software_rasterizer")) {
+		raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	}
 }
 
 void unregister_raycast_types() {
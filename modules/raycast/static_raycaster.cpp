@@ -37,6 +37,7 @@
 #endif
 
 RTCDevice StaticRaycasterEmbree::embree_device;
+Mutex StaticRaycasterEmbree::embree_device_mutex;
 
 StaticRaycaster *StaticRaycasterEmbree::create_embree_raycaster() {
 	return memnew(StaticRaycasterEmbree);
@@ -60,6 +61,12 @@ bool StaticRaycasterEmbree::intersect(Ray &r_ray) {
 }
 
 void StaticRaycasterEmbree::intersect(Vector<Ray> &r_rays) {
+#ifdef __SSE2__
+	// The raycaster can be used from other threads than the one that created it, Embree expects these modes in each thread.
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+	_MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+#endif
+
 	Ray *rays = r_rays.ptrw();
 	for (int i = 0; i < r_rays.size(); ++i) {
 		intersect(rays[i]);
@@ -120,9 +127,13 @@ StaticRaycasterEmbree::StaticRaycasterEmbree() {
 	_MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
 #endif
 
-	if (!embree_device) {
-		embree_device = rtcNewDevice(nullptr);
-		rtcSetDeviceErrorFunction(embree_device, &embree_error_handler, nullptr);
+	{
+		// Importers create raycasters from worker threads.
+		MutexLock lock(embree_device_mutex);
+		if (!embree_device) {
+			embree_device = rtcNewDevice(nullptr);
+			rtcSetDeviceErrorFunction(embree_device, &embree_error_handler, nullptr);
+		}
 	}
 
 	embree_scene = rtcNewScene(embree_device);
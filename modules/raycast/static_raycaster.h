@@ -31,6 +31,7 @@
 #ifdef TOOLS_ENABLED
 
 #include "core/math/static_raycaster.h"
+#include "core/os/mutex.h"
 
 #include <embree3/rtcore.h>
 
@@ -39,6 +40,7 @@ class StaticRaycasterEmbree : public StaticRaycaster {
 
 private:
 	static RTCDevice embree_device;
+	static Mutex embree_device_mutex;
 	RTCScene embree_scene;
 
 	Set<int> filter_meshes;
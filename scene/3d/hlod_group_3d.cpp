@@ -0,0 +1,576 @@
+/*************************************************************************/
+/*  hlod_group_3d.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "hlod_group_3d.h"
+
+#include "core/templates/thread_work_pool.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/resources/skin.h"
+#include "scene/resources/surface_tool.h"
+
+static const char *proxy_root_name = "HLODProxies";
+
+void HLODGroup3D::set_cell_size(float p_size) {
+	cell_size = MAX(0.01, p_size);
+	update_configuration_warnings();
+}
+
+float HLODGroup3D::get_cell_size() const {
+	return cell_size;
+}
+
+void HLODGroup3D::set_visibility_range(float p_range) {
+	visibility_range = MAX(0.0, p_range);
+	update_configuration_warnings();
+}
+
+float HLODGroup3D::get_visibility_range() const {
+	return visibility_range;
+}
+
+void HLODGroup3D::set_simplification_ratio(float p_ratio) {
+	simplification_ratio = CLAMP(p_ratio, 0.0, 1.0);
+}
+
+float HLODGroup3D::get_simplification_ratio() const {
+	return simplification_ratio;
+}
+
+void HLODGroup3D::set_simplification_error(float p_error) {
+	simplification_error = MAX(0.0, p_error);
+}
+
+float HLODGroup3D::get_simplification_error() const {
+	return simplification_error;
+}
+
+void HLODGroup3D::set_min_cluster_instances(int p_count) {
+	min_cluster_instances = MAX(1, p_count);
+}
+
+int HLODGroup3D::get_min_cluster_instances() const {
+	return min_cluster_instances;
+}
+
+void HLODGroup3D::set_bake_mask(uint32_t p_mask) {
+	bake_mask = p_mask;
+	update_configuration_warnings();
+}
+
+uint32_t HLODGroup3D::get_bake_mask() const {
+	return bake_mask;
+}
+
+void HLODGroup3D::set_bake_mask_value(int p_layer_number, bool p_value) {
+	ERR_FAIL_COND_MSG(p_layer_number < 1, "Render layer number must be between 1 and 20 inclusive.");
+	ERR_FAIL_COND_MSG(p_layer_number > 20, "Render layer number must be between 1 and 20 inclusive.");
+	uint32_t mask = get_bake_mask();
+	if (p_value) {
+		mask |= 1 << (p_layer_number - 1);
+	} else {
+		mask &= ~(1 << (p_layer_number - 1));
+	}
+	set_bake_mask(mask);
+}
+
+bool HLODGroup3D::get_bake_mask_value(int p_layer_number) const {
+	ERR_FAIL_COND_V_MSG(p_layer_number < 1, false, "Render layer number must be between 1 and 20 inclusive.");
+	ERR_FAIL_COND_V_MSG(p_layer_number > 20, false, "Render layer number must be between 1 and 20 inclusive.");
+	return bake_mask & (1 << (p_layer_number - 1));
+}
+
+Array HLODGroup3D::merge_surfaces(const LocalVector<SourceSurface> &p_sources, float p_simplification_ratio, float p_simplification_error) {
+	// Attributes are only kept when all the merged surfaces have them.
+	bool has_normals = true;
+	bool has_tangents = true;
+	bool has_colors = true;
+	bool has_uvs = true;
+	bool has_uv2s = true;
+	for (uint32_t i = 0; i < p_sources.size(); i++) {
+		const Array &arrays = p_sources[i].arrays;
+		ERR_FAIL_COND_V(arrays.size() != Mesh::ARRAY_MAX, Array());
+		has_normals = has_normals && arrays[Mesh::ARRAY_NORMAL].get_type() != Variant::NIL;
+		has_tangents = has_tangents && arrays[Mesh::ARRAY_TANGENT].get_type() != Variant::NIL;
+		has_colors = has_colors && arrays[Mesh::ARRAY_COLOR].get_type() != Variant::NIL;
+		has_uvs = has_uvs && arrays[Mesh::ARRAY_TEX_UV].get_type() != Variant::NIL;
+		has_uv2s = has_uv2s && arrays[Mesh::ARRAY_TEX_UV2].get_type() != Variant::NIL;
+	}
+
+	LocalVector<Vector3> vertices;
+	LocalVector<Vector3> normals;
+	LocalVector<float> tangents;
+	LocalVector<Color> colors;
+	LocalVector<Vector2> uvs;
+	LocalVector<Vector2> uv2s;
+	LocalVector<int> indices;
+
+	for (uint32_t i = 0; i < p_sources.size(); i++) {
+		const Array &arrays = p_sources[i].arrays;
+		const Transform3D &xform = p_sources[i].transform;
+		const Basis normal_basis = xform.basis.inverse().transposed();
+		const bool mirrored = xform.basis.determinant() < 0.0;
+
+		PackedVector3Array src_vertices = arrays[Mesh::ARRAY_VERTEX];
+		PackedInt32Array src_indices = arrays[Mesh::ARRAY_INDEX];
+		const int vertex_count = src_vertices.size();
+		if (vertex_count == 0) {
+			continue;
+		}
+
+		const uint32_t vertex_offset = vertices.size();
+		for (int j = 0; j < vertex_count; j++) {
+			vertices.push_back(xform.xform(src_vertices[j]));
+		}
+
+		if (has_normals) {
+			PackedVector3Array src_normals = arrays[Mesh::ARRAY_NORMAL];
+			ERR_FAIL_COND_V(src_normals.size() != vertex_count, Array());
+			for (int j = 0; j < vertex_count; j++) {
+				normals.push_back(normal_basis.xform(src_normals[j]).normalized());
+			}
+		}
+		if (has_tangents) {
+			PackedFloat32Array src_tangents = arrays[Mesh::ARRAY_TANGENT];
+			ERR_FAIL_COND_V(src_tangents.size() != vertex_count * 4, Array());
+			for (int j = 0; j < vertex_count; j++) {
+				Vector3 tangent = xform.basis.xform(Vector3(src_tangents[j * 4 + 0], src_tangents[j * 4 + 1], src_tangents[j * 4 + 2])).normalized();
+				tangents.push_back(tangent.x);
+				tangents.push_back(tangent.y);
+				tangents.push_back(tangent.z);
+				tangents.push_back(mirrored ? -src_tangents[j * 4 + 3] : src_tangents[j * 4 + 3]);
+			}
+		}
+		if (has_colors) {
+			PackedColorArray src_colors = arrays[Mesh::ARRAY_COLOR];
+			ERR_FAIL_COND_V(src_colors.size() != vertex_count, Array());
+			for (int j = 0; j < vertex_count; j++) {
+				colors.push_back(src_colors[j]);
+			}
+		}
+		if (has_uvs) {
+			PackedVector2Array src_uvs = arrays[Mesh::ARRAY_TEX_UV];
+			ERR_FAIL_COND_V(src_uvs.size() != vertex_count, Array());
+			for (int j = 0; j < vertex_count; j++) {
+				uvs.push_back(src_uvs[j]);
+			}
+		}
+		if (has_uv2s) {
+			PackedVector2Array src_uv2s = arrays[Mesh::ARRAY_TEX_UV2];
+			ERR_FAIL_COND_V(src_uv2s.size() != vertex_count, Array());
+			for (int j = 0; j < vertex_count; j++) {
+				uv2s.push_back(src_uv2s[j]);
+			}
+		}
+
+		const int index_count = src_indices.size() ? src_indices.size() : vertex_count;
+		ERR_FAIL_COND_V(index_count % 3 != 0, Array());
+		for (int j = 0; j < index_count; j += 3) {
+			int triangle[3];
+			for (int k = 0; k < 3; k++) {
+				triangle[k] = src_indices.size() ? src_indices[j + k] : j + k;
+				ERR_FAIL_INDEX_V(triangle[k], vertex_count, Array());
+			}
+			// Mirrored instances flip the winding order, flip it back.
+			if (mirrored) {
+				SWAP(triangle[1], triangle[2]);
+			}
+			for (int k = 0; k < 3; k++) {
+				indices.push_back(vertex_offset + triangle[k]);
+			}
+		}
+	}
+
+	if (indices.is_empty()) {
+		return Array();
+	}
+
+	if (SurfaceTool::simplify_func && p_simplification_ratio < 1.0) {
+		LocalVector<float> positions;
+		positions.resize(vertices.size() * 3);
+		for (uint32_t i = 0; i < vertices.size(); i++) {
+			positions[i * 3 + 0] = vertices[i].x;
+			positions[i * 3 + 1] = vertices[i].y;
+			positions[i * 3 + 2] = vertices[i].z;
+		}
+
+		const float error_scale = SurfaceTool::simplify_scale_func(positions.ptr(), vertices.size(), sizeof(float) * 3);
+		const float target_error = error_scale > 0.0 ? p_simplification_error / error_scale : 0.0;
+		const uint32_t target_index_count = MAX(3u, uint32_t(indices.size() * p_simplification_ratio) / 3 * 3);
+
+		LocalVector<int> simplified;
+		simplified.resize(indices.size());
+		float result_error = 0.0;
+		size_t index_count = SurfaceTool::simplify_func((unsigned int *)simplified.ptr(), (const unsigned int *)indices.ptr(), indices.size(), positions.ptr(), vertices.size(), sizeof(float) * 3, target_index_count, target_error, &result_error);
+
+		// Merged objects are usually disconnected, and the borders of open meshes can't be collapsed.
+		// When that stops the simplifier far from the target, ignore the topology.
+		if (index_count > target_index_count * 2 && SurfaceTool::simplify_sloppy_func) {
+			index_count = SurfaceTool::simplify_sloppy_func((unsigned int *)simplified.ptr(), (const unsigned int *)indices.ptr(), indices.size(), positions.ptr(), vertices.size(), sizeof(float) * 3, target_index_count, target_error, &result_error);
+		}
+
+		if (index_count > 0) {
+			simplified.resize(index_count);
+			indices = simplified;
+		}
+	}
+
+	if (SurfaceTool::optimize_vertex_cache_func) {
+		LocalVector<int> optimized;
+		optimized.resize(indices.size());
+		SurfaceTool::optimize_vertex_cache_func((unsigned int *)optimized.ptr(), (const unsigned int *)indices.ptr(), indices.size(), vertices.size());
+		indices = optimized;
+	}
+
+	// Drop the vertices the simplification removed, and store the rest in the order they are used.
+	LocalVector<int> remap;
+	remap.resize(vertices.size());
+	for (uint32_t i = 0; i < remap.size(); i++) {
+		remap[i] = -1;
+	}
+
+	PackedVector3Array out_vertices;
+	PackedVector3Array out_normals;
+	PackedFloat32Array out_tangents;
+	PackedColorArray out_colors;
+	PackedVector2Array out_uvs;
+	PackedVector2Array out_uv2s;
+	PackedInt32Array out_indices;
+	out_indices.resize(indices.size());
+	int *out_indices_ptr = out_indices.ptrw();
+
+	for (uint32_t i = 0; i < indices.size(); i++) {
+		const int index = indices[i];
+		if (remap[index] == -1) {
+			remap[index] = out_vertices.size();
+			out_vertices.push_back(vertices[index]);
+			if (has_normals) {
+				out_normals.push_back(normals[index]);
+			}
+			if (has_tangents) {
+				for (int k = 0; k < 4; k++) {
+					out_tangents.push_back(tangents[index * 4 + k]);
+				}
+			}
+			if (has_colors) {
+				out_colors.push_back(colors[index]);
+			}
+			if (has_uvs) {
+				out_uvs.push_back(uvs[index]);
+			}
+			if (has_uv2s) {
+				out_uv2s.push_back(uv2s[index]);
+			}
+		}
+		out_indices_ptr[i] = remap[index];
+	}
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = out_vertices;
+	if (has_normals) {
+		arrays[Mesh::ARRAY_NORMAL] = out_normals;
+	}
+	if (has_tangents) {
+		arrays[Mesh::ARRAY_TANGENT] = out_tangents;
+	}
+	if (has_colors) {
+		arrays[Mesh::ARRAY_COLOR] = out_colors;
+	}
+	if (has_uvs) {
+		arrays[Mesh::ARRAY_TEX_UV] = out_uvs;
+	}
+	if (has_uv2s) {
+		arrays[Mesh::ARRAY_TEX_UV2] = out_uv2s;
+	}
+	arrays[Mesh::ARRAY_INDEX] = out_indices;
+	return arrays;
+}
+
+Node3D *HLODGroup3D::_get_proxy_root() const {
+	return Object::cast_to<Node3D>(get_node_or_null(NodePath(proxy_root_name)));
+}
+
+bool HLODGroup3D::_can_bake_instance(MeshInstance3D *p_instance) const {
+	if (!p_instance->is_visible_in_tree() || (p_instance->get_layer_mask() & bake_mask) == 0) {
+		return false;
+	}
+
+	Ref<Mesh> mesh = p_instance->get_mesh();
+	if (mesh.is_null() || mesh->get_blend_shape_count() > 0 || p_instance->get_skin().is_valid()) {
+		return false; // Only static meshes can be merged.
+	}
+
+	if (mesh->get_surface_count() == 0) {
+		return false;
+	}
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+		if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
+			return false; // The proxy would be missing the lines or points.
+		}
+	}
+
+	if (!p_instance->get_visibility_parent().is_empty()) {
+		return false; // Already part of a visibility hierarchy, don't override it.
+	}
+
+	if (p_instance->get_visibility_range_end() > 0.0 && p_instance->get_visibility_range_end() < visibility_range) {
+		return false; // Hidden before the proxy shows up, the proxy would show it again.
+	}
+
+	return true;
+}
+
+void HLODGroup3D::_find_instances(Node *p_node, LocalVector<MeshInstance3D *> &r_instances) const {
+	MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(p_node);
+	if (mi && _can_bake_instance(mi)) {
+		r_instances.push_back(mi);
+	}
+
+	// The proxies of this group and of nested groups.
+	HLODGroup3D *group = Object::cast_to<HLODGroup3D>(p_node);
+	Node *proxy_root = group ? group->_get_proxy_root() : nullptr;
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		Node *child = p_node->get_child(i);
+		if (child == proxy_root || !child->get_owner()) {
+			continue; // Proxies, or helpers.
+		}
+
+		_find_instances(child, r_instances);
+	}
+}
+
+void HLODGroup3D::_bake_surface(uint32_t p_index, ClusterSurface *p_surfaces) {
+	p_surfaces[p_index].result = merge_surfaces(p_surfaces[p_index].sources, simplification_ratio, simplification_error);
+}
+
+HLODGroup3D::BakeError HLODGroup3D::bake() {
+	ERR_FAIL_COND_V(!is_inside_tree(), BAKE_ERROR_NOT_IN_TREE);
+
+	clear();
+
+	LocalVector<MeshInstance3D *> instances;
+	_find_instances(this, instances);
+
+	// Cluster instances by the cell that contains the center of their bounds, in local space of this node.
+	const Transform3D global_to_local = get_global_transform().affine_inverse();
+	Map<Vector3i, uint32_t> cluster_map;
+	LocalVector<Cluster> clusters;
+
+	for (uint32_t i = 0; i < instances.size(); i++) {
+		const Transform3D transform = global_to_local * instances[i]->get_global_transform();
+		const Vector3 center = transform.xform(instances[i]->get_aabb()).get_center();
+		const Vector3i cell = Vector3i((center / cell_size).floor());
+
+		Map<Vector3i, uint32_t>::Element *E = cluster_map.find(cell);
+		if (!E) {
+			E = cluster_map.insert(cell, clusters.size());
+			clusters.push_back(Cluster());
+		}
+		clusters[E->get()].instances.push_back(instances[i]);
+		clusters[E->get()].transforms.push_back(transform);
+	}
+
+	// One merged surface per cluster and material. Gathering the arrays talks to the rendering server,
+	// so it happens here, merging and simplifying is done on all cores.
+	LocalVector<ClusterSurface> surfaces;
+	for (uint32_t i = 0; i < clusters.size(); i++) {
+		Cluster &cluster = clusters[i];
+		if (cluster.instances.size() < (uint32_t)min_cluster_instances) {
+			cluster.instances.clear();
+			continue;
+		}
+
+		for (uint32_t j = 0; j < cluster.instances.size(); j++) {
+			MeshInstance3D *mi = cluster.instances[j];
+			Ref<Mesh> mesh = mi->get_mesh();
+			bool merged = false;
+
+			for (int k = 0; k < mesh->get_surface_count(); k++) {
+				Array arrays = mesh->surface_get_arrays(k);
+				if (PackedVector3Array(arrays[Mesh::ARRAY_VERTEX]).is_empty()) {
+					continue;
+				}
+
+				Ref<Material> material = mi->get_active_material(k);
+				uint32_t surface = 0;
+				for (; surface < cluster.surfaces.size(); surface++) {
+					if (surfaces[cluster.surfaces[surface]].material == material) {
+						break;
+					}
+				}
+				if (surface == cluster.surfaces.size()) {
+					cluster.surfaces.push_back(surfaces.size());
+					surfaces.push_back(ClusterSurface());
+					surfaces[surfaces.size() - 1].material = material;
+				}
+
+				SourceSurface source;
+				source.arrays = arrays;
+				source.transform = cluster.transforms[j];
+				surfaces[cluster.surfaces[surface]].sources.push_back(source);
+				merged = true;
+			}
+
+			if (merged) {
+				cluster.merged_instances.push_back(mi);
+			}
+		}
+	}
+
+	if (surfaces.is_empty()) {
+		return BAKE_ERROR_NO_MESHES;
+	}
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	work_pool.do_work(surfaces.size(), this, &HLODGroup3D::_bake_surface, surfaces.ptr());
+	work_pool.finish();
+
+	Node *owner = get_owner() ? get_owner() : this;
+	Node3D *proxy_root = memnew(Node3D);
+	proxy_root->set_name(proxy_root_name);
+	add_child(proxy_root);
+	proxy_root->set_owner(owner);
+
+	for (uint32_t i = 0; i < clusters.size(); i++) {
+		const Cluster &cluster = clusters[i];
+
+		Ref<ArrayMesh> mesh;
+		mesh.instantiate();
+		for (uint32_t j = 0; j < cluster.surfaces.size(); j++) {
+			const ClusterSurface &surface = surfaces[cluster.surfaces[j]];
+			if (surface.result.is_empty()) {
+				continue;
+			}
+			mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, surface.result);
+			mesh->surface_set_material(mesh->get_surface_count() - 1, surface.material);
+		}
+		if (mesh->get_surface_count() == 0) {
+			continue;
+		}
+
+		MeshInstance3D *proxy = memnew(MeshInstance3D);
+		proxy->set_name("Cluster" + itos(proxy_root->get_child_count()));
+		proxy->set_mesh(mesh);
+		proxy->set_visibility_range_begin(visibility_range);
+		proxy_root->add_child(proxy);
+		proxy->set_owner(owner);
+
+		// The instances are only visible while the proxy is hidden, closer than the visibility range.
+		for (uint32_t j = 0; j < cluster.merged_instances.size(); j++) {
+			cluster.merged_instances[j]->set_visibility_parent(cluster.merged_instances[j]->get_path_to(proxy));
+		}
+	}
+
+	return BAKE_ERROR_OK;
+}
+
+void HLODGroup3D::clear() {
+	Node3D *proxy_root = _get_proxy_root();
+	if (!proxy_root) {
+		return;
+	}
+
+	LocalVector<MeshInstance3D *> instances;
+	List<Node *> nodes;
+	nodes.push_back(this);
+	while (!nodes.is_empty()) {
+		Node *node = nodes.front()->get();
+		nodes.pop_front();
+
+		MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(node);
+		if (mi && !mi->get_visibility_parent().is_empty()) {
+			Node *visibility_parent = mi->get_node_or_null(mi->get_visibility_parent());
+			if (visibility_parent && proxy_root->is_ancestor_of(visibility_parent)) {
+				mi->set_visibility_parent(NodePath());
+			}
+		}
+
+		for (int i = 0; i < node->get_child_count(); i++) {
+			if (node->get_child(i) != proxy_root) {
+				nodes.push_back(node->get_child(i));
+			}
+		}
+	}
+
+	remove_child(proxy_root);
+	memdelete(proxy_root);
+}
+
+TypedArray<String> HLODGroup3D::get_configuration_warnings() const {
+	TypedArray<String> warnings = Node::get_configuration_warnings();
+
+	if (bake_mask == 0) {
+		warnings.push_back(TTR("The Bake Mask has no bits enabled, which means baking will not produce any proxy meshes for this HLODGroup3D.\nTo resolve this, enable at least one bit in the Bake Mask property."));
+	}
+
+	if (Math::is_zero_approx(visibility_range)) {
+		warnings.push_back(TTR("The Visibility Range is zero, which means the proxy meshes will always be drawn instead of the original meshes."));
+	}
+
+	return warnings;
+}
+
+void HLODGroup3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_cell_size", "size"), &HLODGroup3D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &HLODGroup3D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("set_visibility_range", "range"), &HLODGroup3D::set_visibility_range);
+	ClassDB::bind_method(D_METHOD("get_visibility_range"), &HLODGroup3D::get_visibility_range);
+	ClassDB::bind_method(D_METHOD("set_simplification_ratio", "ratio"), &HLODGroup3D::set_simplification_ratio);
+	ClassDB::bind_method(D_METHOD("get_simplification_ratio"), &HLODGroup3D::get_simplification_ratio);
+	ClassDB::bind_method(D_METHOD("set_simplification_error", "error"), &HLODGroup3D::set_simplification_error);
+	ClassDB::bind_method(D_METHOD("get_simplification_error"), &HLODGroup3D::get_simplification_error);
+	ClassDB::bind_method(D_METHOD("set_min_cluster_instances", "count"), &HLODGroup3D::set_min_cluster_instances);
+	ClassDB::bind_method(D_METHOD("get_min_cluster_instances"), &HLODGroup3D::get_min_cluster_instances);
+	ClassDB::bind_method(D_METHOD("set_bake_mask", "mask"), &HLODGroup3D::set_bake_mask);
+	ClassDB::bind_method(D_METHOD("get_bake_mask"), &HLODGroup3D::get_bake_mask);
+	ClassDB::bind_method(D_METHOD("set_bake_mask_value", "layer_number", "value"), &HLODGroup3D::set_bake_mask_value);
+	ClassDB::bind_method(D_METHOD("get_bake_mask_value", "layer_number"), &HLODGroup3D::get_bake_mask_value);
+
+	ClassDB::bind_method(D_METHOD("bake"), &HLODGroup3D::bake);
+	ClassDB::bind_method(D_METHOD("clear"), &HLODGroup3D::clear);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cell_size", PROPERTY_HINT_RANGE, "0.01,1024,0.01,or_greater,suffix:m"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "visibility_range", PROPERTY_HINT_RANGE, "0,4096,0.01,or_greater,suffix:m"), "set_visibility_range", "get_visibility_range");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "min_cluster_instances", PROPERTY_HINT_RANGE, "1,64,1,or_greater"), "set_min_cluster_instances", "get_min_cluster_instances");
+	ADD_GROUP("Simplification", "simplification_");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "simplification_ratio", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_simplification_ratio", "get_simplification_ratio");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "simplification_error", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater,suffix:m"), "set_simplification_error", "get_simplification_error");
+	ADD_GROUP("Bake", "bake_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "bake_mask", PROPERTY_HINT_LAYERS_3D_RENDER), "set_bake_mask", "get_bake_mask");
+
+	BIND_ENUM_CONSTANT(BAKE_ERROR_OK);
+	BIND_ENUM_CONSTANT(BAKE_ERROR_NO_MESHES);
+	BIND_ENUM_CONSTANT(BAKE_ERROR_NOT_IN_TREE);
+}
+
+HLODGroup3D::HLODGroup3D() {
+}
@@ -0,0 +1,118 @@
+/*************************************************************************/
+/*  hlod_group_3d.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef HLOD_GROUP_3D_H
+#define HLOD_GROUP_3D_H
+
+#include "core/templates/local_vector.h"
+#include "scene/3d/node_3d.h"
+
+class MeshInstance3D;
+
+class HLODGroup3D : public Node3D {
+	GDCLASS(HLODGroup3D, Node3D);
+
+public:
+	enum BakeError {
+		BAKE_ERROR_OK,
+		BAKE_ERROR_NO_MESHES,
+		BAKE_ERROR_NOT_IN_TREE,
+	};
+
+	struct SourceSurface {
+		Array arrays;
+		Transform3D transform;
+	};
+
+private:
+	float cell_size = 32.0;
+	float visibility_range = 100.0;
+	float simplification_ratio = 0.1;
+	float simplification_error = 0.25;
+	int min_cluster_instances = 2;
+	uint32_t bake_mask = 0xFFFFFFFF;
+
+	struct ClusterSurface {
+		Ref<Material> material;
+		LocalVector<SourceSurface> sources;
+		Array result;
+	};
+
+	struct Cluster {
+		LocalVector<MeshInstance3D *> instances;
+		LocalVector<Transform3D> transforms;
+		LocalVector<uint32_t> surfaces;
+		// The instances that added geometry to the proxy, only these are hidden by it.
+		LocalVector<MeshInstance3D *> merged_instances;
+	};
+
+	Node3D *_get_proxy_root() const;
+	bool _can_bake_instance(MeshInstance3D *p_instance) const;
+	void _find_instances(Node *p_node, LocalVector<MeshInstance3D *> &r_instances) const;
+	void _bake_surface(uint32_t p_index, ClusterSurface *p_surfaces);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_cell_size(float p_size);
+	float get_cell_size() const;
+
+	void set_visibility_range(float p_range);
+	float get_visibility_range() const;
+
+	void set_simplification_ratio(float p_ratio);
+	float get_simplification_ratio() const;
+
+	void set_simplification_error(float p_error);
+	float get_simplification_error() const;
+
+	void set_min_cluster_instances(int p_count);
+	int get_min_cluster_instances() const;
+
+	void set_bake_mask(uint32_t p_mask);
+	uint32_t get_bake_mask() const;
+
+	void set_bake_mask_value(int p_layer_number, bool p_enable);
+	bool get_bake_mask_value(int p_layer_number) const;
+
+	BakeError bake();
+	void clear();
+
+	static Array merge_surfaces(const LocalVector<SourceSurface> &p_sources, float p_simplification_ratio, float p_simplification_error);
+
+	virtual TypedArray<String> get_configuration_warnings() const override;
+
+	HLODGroup3D();
+};
+
+VARIANT_ENUM_CAST(HLODGroup3D::BakeError);
+
+#endif // HLOD_GROUP_3D_H
@@ -143,6 +143,8 @@ Ref<NavigationMesh> NavigationRegion3D::get_navigation_mesh() const {
 
 struct BakeThreadsArgs {
 	NavigationRegion3D *nav_region = nullptr;
+	bool tiles_only = false;
+	AABB area;
 };
 
 void _bake_navigation_mesh(void *p_user_data) {
@@ -151,7 +153,11 @@ void _bake_navigation_mesh(void *p_user_data) {
 	if (args->nav_region->get_navigation_mesh().is_valid()) {
 		Ref<NavigationMesh> nav_mesh = args->nav_region->get_navigation_mesh()->duplicate();
 
-		NavigationServer3D::get_singleton()->region_bake_navmesh(nav_mesh, args->nav_region);
+		if (args->tiles_only) {
+			NavigationServer3D::get_singleton()->region_bake_navmesh_tiles(nav_mesh, args->nav_region, args->area);
+		} else {
+			NavigationServer3D::get_singleton()->region_bake_navmesh(nav_mesh, args->nav_region);
+		}
 		args->nav_region->call_deferred(SNAME("_bake_finished"), nav_mesh);
 		memdelete(args);
 	} else {
@@ -170,6 +176,17 @@ void NavigationRegion3D::bake_navigation_mesh() {
 	bake_thread.start(_bake_navigation_mesh, args);
 }
 
+void NavigationRegion3D::bake_navigation_mesh_tiles(const AABB &p_area) {
+	ERR_FAIL_COND_MSG(bake_thread.is_started(), "Unable to start another bake request. The navigation mesh bake thread is already baking a navigation mesh.");
+
+	BakeThreadsArgs *args = memnew(BakeThreadsArgs);
+	args->nav_region = this;
+	args->tiles_only = true;
+	args->area = get_global_transform().affine_inverse().xform(p_area);
+
+	bake_thread.start(_bake_navigation_mesh, args);
+}
+
 void NavigationRegion3D::_bake_finished(Ref<NavigationMesh> p_nav_mesh) {
 	set_navigation_mesh(p_nav_mesh);
 	bake_thread.wait_to_finish();
@@ -199,6 +216,7 @@ void NavigationRegion3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_layers"), &NavigationRegion3D::get_layers);
 
 	ClassDB::bind_method(D_METHOD("bake_navigation_mesh"), &NavigationRegion3D::bake_navigation_mesh);
+	ClassDB::bind_method(D_METHOD("bake_navigation_mesh_tiles", "area"), &NavigationRegion3D::bake_navigation_mesh_tiles);
 	ClassDB::bind_method(D_METHOD("_bake_finished", "nav_mesh"), &NavigationRegion3D::_bake_finished);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "navmesh", PROPERTY_HINT_RESOURCE_TYPE, "NavigationMesh"), "set_navigation_mesh", "get_navigation_mesh");
@@ -63,6 +63,9 @@ public:
 	/// Bakes the navigation mesh in a dedicated thread; once done, automatically
 	/// sets the new navigation mesh and emits a signal
 	void bake_navigation_mesh();
+	/// Same as bake_navigation_mesh(), but only rebuilds the tiles of a tiled
+	/// navigation mesh that intersect the given global area
+	void bake_navigation_mesh_tiles(const AABB &p_area);
 	void _bake_finished(Ref<NavigationMesh> p_nav_mesh);
 
 	TypedArray<String> get_configuration_warnings() const override;
@@ -78,12 +78,42 @@ void SoftDynamicBodyRenderingServerHandler::commit_changes() {
 	RS::get_singleton()->mesh_surface_update_vertex_region(mesh, surface, 0, buffer);
 }
 
+// Vertex positions are stored as three floats, normals are packed in 10:10:10 like RenderingServer does.
+static _FORCE_INLINE_ void _write_vertex(uint8_t *p_dst, const Vector3 &p_vertex) {
+	const float vertex[3] = { float(p_vertex.x), float(p_vertex.y), float(p_vertex.z) };
+	memcpy(p_dst, vertex, sizeof(float) * 3);
+}
+
+static _FORCE_INLINE_ void _write_normal(uint8_t *p_dst, const Vector3 &p_normal) {
+	const Vector3 n = p_normal * Vector3(0.5, 0.5, 0.5) + Vector3(0.5, 0.5, 0.5);
+
+	uint32_t value = 0;
+	value |= CLAMP(int(n.x * 1023.0), 0, 1023);
+	value |= CLAMP(int(n.y * 1023.0), 0, 1023) << 10;
+	value |= CLAMP(int(n.z * 1023.0), 0, 1023) << 20;
+
+	memcpy(p_dst, &value, sizeof(uint32_t));
+}
+
 void SoftDynamicBodyRenderingServerHandler::set_vertex(int p_vertex_id, const void *p_vector3) {
-	memcpy(&write_buffer[p_vertex_id * stride + offset_vertices], p_vector3, sizeof(float) * 3);
+	_write_vertex(&write_buffer[p_vertex_id * stride + offset_vertices], *(const Vector3 *)p_vector3);
 }
 
 void SoftDynamicBodyRenderingServerHandler::set_normal(int p_vertex_id, const void *p_vector3) {
-	memcpy(&write_buffer[p_vertex_id * stride + offset_normal], p_vector3, sizeof(float) * 3);
+	_write_normal(&write_buffer[p_vertex_id * stride + offset_normal], *(const Vector3 *)p_vector3);
+}
+
+void SoftDynamicBodyRenderingServerHandler::set_vertices(int p_vertex_count, const Vector3 *p_vertices, const Vector3 *p_normals) {
+	ERR_FAIL_COND(int64_t(p_vertex_count) * stride > buffer.size());
+
+	uint8_t *vertex_dst = write_buffer + offset_vertices;
+	uint8_t *normal_dst = write_buffer + offset_normal;
+	for (int i = 0; i < p_vertex_count; ++i) {
+		_write_vertex(vertex_dst, p_vertices[i]);
+		_write_normal(normal_dst, p_normals[i]);
+		vertex_dst += stride;
+		normal_dst += stride;
+	}
 }
 
 void SoftDynamicBodyRenderingServerHandler::set_aabb(const AABB &p_aabb) {
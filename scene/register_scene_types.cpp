@@ -223,6 +223,7 @@
 #include "scene/3d/fog_volume.h"
 #include "scene/3d/gpu_particles_3d.h"
 #include "scene/3d/gpu_particles_collision_3d.h"
+#include "scene/3d/hlod_group_3d.h"
 #include "scene/3d/importer_mesh_instance_3d.h"
 #include "scene/3d/joint_3d.h"
 #include "scene/3d/light_3d.h"
@@ -470,6 +471,7 @@ void register_scene_types() {
 	GDREGISTER_CLASS(XROrigin3D);
 	GDREGISTER_CLASS(MeshInstance3D);
 	GDREGISTER_CLASS(OccluderInstance3D);
+	GDREGISTER_CLASS(HLODGroup3D);
 	GDREGISTER_VIRTUAL_CLASS(Occluder3D);
 	GDREGISTER_CLASS(ArrayOccluder3D);
 	GDREGISTER_CLASS(QuadOccluder3D);
@@ -178,6 +178,36 @@ Vector<real_t> HeightMapShape3D::get_map_data() const {
 	return map_data;
 }
 
+void HeightMapShape3D::set_map_data_region(const Rect2i &p_region, const Vector<real_t> &p_data) {
+	ERR_FAIL_COND(p_region.size.x <= 0 || p_region.size.y <= 0);
+	ERR_FAIL_COND_MSG(p_region.position.x < 0 || p_region.position.y < 0 || p_region.position.x + p_region.size.x > map_width || p_region.position.y + p_region.size.y > map_depth, "Region is outside of the map.");
+	ERR_FAIL_COND(p_data.size() != p_region.size.x * p_region.size.y);
+
+	// copy the region only, heights outside of it keep their current range
+	real_t *w = map_data.ptrw();
+	const real_t *r = p_data.ptr();
+	for (int z = 0; z < p_region.size.y; z++) {
+		real_t *row = &w[(p_region.position.y + z) * map_width + p_region.position.x];
+		for (int x = 0; x < p_region.size.x; x++) {
+			real_t val = *r++;
+			row[x] = val;
+			if (min_height > val) {
+				min_height = val;
+			}
+
+			if (max_height < val) {
+				max_height = val;
+			}
+		}
+	}
+
+	// don't send the whole map again, only the modified region
+	PhysicsServer3D::get_singleton()->heightmap_shape_update_region(get_shape(), p_region, p_data);
+
+	Shape3D::_update_shape();
+	notify_change_to_owners();
+}
+
 void HeightMapShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_map_width", "width"), &HeightMapShape3D::set_map_width);
 	ClassDB::bind_method(D_METHOD("get_map_width"), &HeightMapShape3D::get_map_width);
@@ -185,6 +215,7 @@ void HeightMapShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_map_depth"), &HeightMapShape3D::get_map_depth);
 	ClassDB::bind_method(D_METHOD("set_map_data", "data"), &HeightMapShape3D::set_map_data);
 	ClassDB::bind_method(D_METHOD("get_map_data"), &HeightMapShape3D::get_map_data);
+	ClassDB::bind_method(D_METHOD("set_map_data_region", "region", "data"), &HeightMapShape3D::set_map_data_region);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "map_width", PROPERTY_HINT_RANGE, "1,4096,1"), "set_map_width", "get_map_width");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "map_depth", PROPERTY_HINT_RANGE, "1,4096,1"), "set_map_depth", "get_map_depth");
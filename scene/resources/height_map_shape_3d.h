@@ -53,6 +53,7 @@ public:
 	int get_map_depth() const;
 	void set_map_data(Vector<real_t> p_new);
 	Vector<real_t> get_map_data() const;
+	void set_map_data_region(const Rect2i &p_region, const Vector<real_t> &p_data);
 
 	virtual Vector<Vector3> get_debug_mesh_lines() const override;
 	virtual real_t get_enclosing_radius() const override;
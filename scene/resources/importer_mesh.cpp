@@ -32,6 +32,7 @@
 
 #include "core/math/random_pcg.h"
 #include "core/math/static_raycaster.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/resources/surface_tool.h"
 
 #include <cstdint>
@@ -254,101 +255,234 @@ void ImporterMesh::set_surface_material(int p_surface, const Ref<Material> &p_ma
 	mesh.unref();
 }
 
-void ImporterMesh::generate_lods(float p_normal_merge_angle, float p_normal_split_angle) {
-	if (!SurfaceTool::simplify_scale_func) {
-		return;
+template <class T>
+static Vector<T> _remap_vertex_array(const Vector<T> &p_array, const LocalVector<uint32_t> &p_remap) {
+	const int vertex_count = p_remap.size();
+	ERR_FAIL_COND_V(p_array.size() % vertex_count != 0, p_array);
+
+	// Bones, weights and custom arrays store several elements per vertex.
+	const int stride = p_array.size() / vertex_count;
+	Vector<T> result;
+	result.resize(p_array.size());
+	const T *src = p_array.ptr();
+	T *dst = result.ptrw();
+	for (int i = 0; i < vertex_count; i++) {
+		for (int j = 0; j < stride; j++) {
+			dst[p_remap[i] * stride + j] = src[i * stride + j];
+		}
 	}
-	if (!SurfaceTool::simplify_with_attrib_func) {
+	return result;
+}
+
+static void _remap_vertex_arrays(Array &r_arrays, const LocalVector<uint32_t> &p_remap) {
+	for (int i = 0; i < r_arrays.size(); i++) {
+		if (i == RS::ARRAY_INDEX) {
+			continue;
+		}
+
+		const Variant &array = r_arrays[i];
+		switch (array.get_type()) {
+			case Variant::PACKED_BYTE_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<uint8_t>(array, p_remap);
+			} break;
+			case Variant::PACKED_INT32_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<int32_t>(array, p_remap);
+			} break;
+			case Variant::PACKED_FLOAT32_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<float>(array, p_remap);
+			} break;
+			case Variant::PACKED_FLOAT64_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<double>(array, p_remap);
+			} break;
+			case Variant::PACKED_VECTOR2_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<Vector2>(array, p_remap);
+			} break;
+			case Variant::PACKED_VECTOR3_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<Vector3>(array, p_remap);
+			} break;
+			case Variant::PACKED_COLOR_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<Color>(array, p_remap);
+			} break;
+			default: {
+			}
+		}
+	}
+}
+
+void ImporterMesh::_optimize_surface(uint32_t p_surface, Surface *p_surfaces) {
+	Surface &surface = p_surfaces[p_surface];
+	if (surface.primitive != Mesh::PRIMITIVE_TRIANGLES) {
 		return;
 	}
-	if (!SurfaceTool::optimize_vertex_cache_func) {
+
+	PackedInt32Array indices = surface.arrays[RS::ARRAY_INDEX];
+	Vector<Vector3> vertices = surface.arrays[RS::ARRAY_VERTEX];
+	const int index_count = indices.size();
+	const int vertex_count = vertices.size();
+	if (index_count == 0 || vertex_count == 0) {
 		return;
 	}
 
-	for (int i = 0; i < surfaces.size(); i++) {
-		if (surfaces[i].primitive != Mesh::PRIMITIVE_TRIANGLES) {
-			continue;
+	// Triangle order first, so the vertex order below follows it.
+	unsigned int *indices_ptr = (unsigned int *)indices.ptrw();
+	SurfaceTool::optimize_vertex_cache_func(indices_ptr, indices_ptr, index_count, vertex_count);
+	SurfaceTool::optimize_overdraw_func(indices_ptr, indices_ptr, index_count, (const float *)vertices.ptr(), vertex_count, sizeof(Vector3), 1.05);
+
+	// Store vertices in the order they are first used. Vertices the surface doesn't use may still be used by blend shapes or
+	// imported LODs, keep them at the end.
+	LocalVector<uint32_t> remap;
+	remap.resize(vertex_count);
+	uint32_t used_vertex_count = SurfaceTool::optimize_vertex_fetch_remap_func(remap.ptr(), indices_ptr, index_count, vertex_count);
+	for (int i = 0; i < vertex_count; i++) {
+		if (remap[i] == ~0u) {
+			remap[i] = used_vertex_count++;
 		}
+	}
 
-		surfaces.write[i].lods.clear();
-		Vector<Vector3> vertices = surfaces[i].arrays[RS::ARRAY_VERTEX];
-		PackedInt32Array indices = surfaces[i].arrays[RS::ARRAY_INDEX];
-		Vector<Vector3> normals = surfaces[i].arrays[RS::ARRAY_NORMAL];
-		Vector<Vector2> uvs = surfaces[i].arrays[RS::ARRAY_TEX_UV];
+	for (int i = 0; i < index_count; i++) {
+		indices_ptr[i] = remap[indices_ptr[i]];
+	}
+	surface.arrays[RS::ARRAY_INDEX] = indices;
+	_remap_vertex_arrays(surface.arrays, remap);
 
-		unsigned int index_count = indices.size();
-		unsigned int vertex_count = vertices.size();
+	for (int i = 0; i < surface.blend_shape_data.size(); i++) {
+		_remap_vertex_arrays(surface.blend_shape_data.write[i].arrays, remap);
+	}
 
-		if (index_count == 0) {
-			continue; //no lods if no indices
+	for (int i = 0; i < surface.lods.size(); i++) {
+		int *lod_indices_ptr = surface.lods.write[i].indices.ptrw();
+		for (int j = 0; j < surface.lods[i].indices.size(); j++) {
+			lod_indices_ptr[j] = remap[lod_indices_ptr[j]];
 		}
+	}
+}
 
-		const Vector3 *vertices_ptr = vertices.ptr();
-		const int *indices_ptr = indices.ptr();
-
-		if (normals.is_empty()) {
-			normals.resize(vertices.size());
-			Vector3 *n_ptr = normals.ptrw();
-			for (unsigned int j = 0; j < index_count; j += 3) {
-				const Vector3 &v0 = vertices_ptr[indices_ptr[j + 0]];
-				const Vector3 &v1 = vertices_ptr[indices_ptr[j + 1]];
-				const Vector3 &v2 = vertices_ptr[indices_ptr[j + 2]];
-				Vector3 n = vec3_cross(v0 - v2, v0 - v1).normalized();
-				n_ptr[j + 0] = n;
-				n_ptr[j + 1] = n;
-				n_ptr[j + 2] = n;
-			}
+void ImporterMesh::optimize_surfaces(ThreadWorkPool *p_thread_pool) {
+	if (!SurfaceTool::optimize_vertex_cache_func || !SurfaceTool::optimize_overdraw_func || !SurfaceTool::optimize_vertex_fetch_remap_func) {
+		return;
+	}
+
+	if (p_thread_pool && p_thread_pool->get_thread_count() > 1) {
+		p_thread_pool->do_work(surfaces.size(), this, &ImporterMesh::_optimize_surface, surfaces.ptrw());
+	} else {
+		for (int i = 0; i < surfaces.size(); i++) {
+			_optimize_surface(i, surfaces.ptrw());
 		}
+	}
+}
 
-		float normal_merge_threshold = Math::cos(Math::deg2rad(p_normal_merge_angle));
-		float normal_pre_split_threshold = Math::cos(Math::deg2rad(MIN(180.0f, p_normal_split_angle * 2.0f)));
-		float normal_split_threshold = Math::cos(Math::deg2rad(p_normal_split_angle));
-		const Vector3 *normals_ptr = normals.ptr();
+// LOD generation runs in three passes over all the surfaces of the mesh. Each pass can be spread over a thread pool:
+// 1. Per surface, merge vertices and simplify down to each LOD level. Each level's target depends on the previous result.
+// 2. Per LOD level of any surface, raycast the original surface to find where the simplified normals must be split.
+// 3. Per surface, number the split vertices in LOD order and add them to the surface.
+struct ImporterMesh::LODGenerationData {
+	struct LOD {
+		PackedInt32Array indices;
+		float error = 0.0f;
+		uint32_t seed = 0;
+		// Split vertices are numbered from the surface vertex count, the final numbers are only known after all levels are done.
+		LocalVector<int> split_vertex_indices;
+		LocalVector<Vector3> split_vertex_normals;
+	};
+
+	struct SurfaceData {
+		Vector<Vector3> vertices;
+		PackedInt32Array indices;
+		Vector<Vector3> normals;
+		float scale = 0.0f;
+		Ref<StaticRaycaster> raycaster;
+		LocalVector<LOD> lods;
+	};
+
+	struct LODJob {
+		uint32_t surface = 0;
+		uint32_t lod = 0;
+	};
+
+	Surface *surfaces = nullptr;
+	LocalVector<SurfaceData> surface_data;
+	LocalVector<LODJob> lod_jobs;
+
+	float normal_merge_threshold = 0.0f;
+	float normal_pre_split_threshold = 0.0f;
+	float normal_split_threshold = 0.0f;
+};
 
-		Map<Vector3, LocalVector<Pair<int, int>>> unique_vertices;
+void ImporterMesh::_generate_surface_lods(uint32_t p_surface, LODGenerationData *p_data) {
+	Surface &surface = p_data->surfaces[p_surface];
+	LODGenerationData::SurfaceData &data = p_data->surface_data[p_surface];
 
-		LocalVector<int> vertex_remap;
-		LocalVector<int> vertex_inverse_remap;
-		LocalVector<Vector3> merged_vertices;
-		LocalVector<Vector3> merged_normals;
-		LocalVector<int> merged_normals_counts;
-		const Vector2 *uvs_ptr = uvs.ptr();
-
-		for (unsigned int j = 0; j < vertex_count; j++) {
-			const Vector3 &v = vertices_ptr[j];
-			const Vector3 &n = normals_ptr[j];
-
-			Map<Vector3, LocalVector<Pair<int, int>>>::Element *E = unique_vertices.find(v);
-
-			if (E) {
-				const LocalVector<Pair<int, int>> &close_verts = E->get();
-
-				bool found = false;
-				for (unsigned int k = 0; k < close_verts.size(); k++) {
-					const Pair<int, int> &idx = close_verts[k];
-
-					// TODO check more attributes?
-					if ((!uvs_ptr || uvs_ptr[j].distance_squared_to(uvs_ptr[idx.second]) < CMP_EPSILON2) && normals[idx.second].dot(n) > normal_merge_threshold) {
-						vertex_remap.push_back(idx.first);
-						merged_normals[idx.first] += normals[idx.second];
-						merged_normals_counts[idx.first]++;
-						found = true;
-						break;
-					}
-				}
+	if (surface.primitive != Mesh::PRIMITIVE_TRIANGLES) {
+		return;
+	}
+	surface.lods.clear();
 
-				if (!found) {
-					int vcount = merged_vertices.size();
-					unique_vertices[v].push_back(Pair<int, int>(vcount, j));
-					vertex_inverse_remap.push_back(j);
-					merged_vertices.push_back(v);
-					vertex_remap.push_back(vcount);
-					merged_normals.push_back(normals_ptr[j]);
-					merged_normals_counts.push_back(1);
+	data.vertices = surface.arrays[RS::ARRAY_VERTEX];
+	data.indices = surface.arrays[RS::ARRAY_INDEX];
+	data.normals = surface.arrays[RS::ARRAY_NORMAL];
+	Vector<Vector2> uvs = surface.arrays[RS::ARRAY_TEX_UV];
+
+	unsigned int index_count = data.indices.size();
+	unsigned int vertex_count = data.vertices.size();
+
+	if (index_count == 0) {
+		return; //no lods if no indices
+	}
+
+	const Vector3 *vertices_ptr = data.vertices.ptr();
+	const int *indices_ptr = data.indices.ptr();
+
+	if (data.normals.is_empty()) {
+		data.normals.resize(data.vertices.size());
+		Vector3 *n_ptr = data.normals.ptrw();
+		for (unsigned int j = 0; j < index_count; j += 3) {
+			const Vector3 &v0 = vertices_ptr[indices_ptr[j + 0]];
+			const Vector3 &v1 = vertices_ptr[indices_ptr[j + 1]];
+			const Vector3 &v2 = vertices_ptr[indices_ptr[j + 2]];
+			Vector3 n = vec3_cross(v0 - v2, v0 - v1).normalized();
+			n_ptr[j + 0] = n;
+			n_ptr[j + 1] = n;
+			n_ptr[j + 2] = n;
+		}
+	}
+
+	const float normal_merge_threshold = p_data->normal_merge_threshold;
+	const Vector3 *normals_ptr = data.normals.ptr();
+
+	Map<Vector3, LocalVector<Pair<int, int>>> unique_vertices;
+
+	LocalVector<int> vertex_remap;
+	LocalVector<int> vertex_inverse_remap;
+	LocalVector<Vector3> merged_vertices;
+	LocalVector<Vector3> merged_normals;
+	LocalVector<int> merged_normals_counts;
+	const Vector2 *uvs_ptr = uvs.ptr();
+
+	for (unsigned int j = 0; j < vertex_count; j++) {
+		const Vector3 &v = vertices_ptr[j];
+		const Vector3 &n = normals_ptr[j];
+
+		Map<Vector3, LocalVector<Pair<int, int>>>::Element *E = unique_vertices.find(v);
+
+		if (E) {
+			const LocalVector<Pair<int, int>> &close_verts = E->get();
+
+			bool found = false;
+			for (unsigned int k = 0; k < close_verts.size(); k++) {
+				const Pair<int, int> &idx = close_verts[k];
+
+				// TODO check more attributes?
+				if ((!uvs_ptr || uvs_ptr[j].distance_squared_to(uvs_ptr[idx.second]) < CMP_EPSILON2) && normals_ptr[idx.second].dot(n) > normal_merge_threshold) {
+					vertex_remap.push_back(idx.first);
+					merged_normals[idx.first] += normals_ptr[idx.second];
+					merged_normals_counts[idx.first]++;
+					found = true;
+					break;
 				}
-			} else {
+			}
+
+			if (!found) {
 				int vcount = merged_vertices.size();
-				unique_vertices[v] = LocalVector<Pair<int, int>>();
 				unique_vertices[v].push_back(Pair<int, int>(vcount, j));
 				vertex_inverse_remap.push_back(j);
 				merged_vertices.push_back(v);
@@ -356,259 +490,377 @@ void ImporterMesh::generate_lods(float p_normal_merge_angle, float p_normal_spli
 				merged_normals.push_back(normals_ptr[j]);
 				merged_normals_counts.push_back(1);
 			}
+		} else {
+			int vcount = merged_vertices.size();
+			unique_vertices[v] = LocalVector<Pair<int, int>>();
+			unique_vertices[v].push_back(Pair<int, int>(vcount, j));
+			vertex_inverse_remap.push_back(j);
+			merged_vertices.push_back(v);
+			vertex_remap.push_back(vcount);
+			merged_normals.push_back(normals_ptr[j]);
+			merged_normals_counts.push_back(1);
 		}
+	}
 
-		LocalVector<int> merged_indices;
-		merged_indices.resize(index_count);
-		for (unsigned int j = 0; j < index_count; j++) {
-			merged_indices[j] = vertex_remap[indices[j]];
+	LocalVector<int> merged_indices;
+	merged_indices.resize(index_count);
+	for (unsigned int j = 0; j < index_count; j++) {
+		merged_indices[j] = vertex_remap[indices_ptr[j]];
+	}
+
+	unsigned int merged_vertex_count = merged_vertices.size();
+	const Vector3 *merged_vertices_ptr = merged_vertices.ptr();
+	const int32_t *merged_indices_ptr = merged_indices.ptr();
+
+	{
+		const int *counts_ptr = merged_normals_counts.ptr();
+		Vector3 *merged_normals_ptrw = merged_normals.ptr();
+		for (unsigned int j = 0; j < merged_vertex_count; j++) {
+			merged_normals_ptrw[j] /= counts_ptr[j];
 		}
+	}
+
+	LocalVector<float> normal_weights;
+	normal_weights.resize(merged_vertex_count);
+	for (unsigned int j = 0; j < merged_vertex_count; j++) {
+		normal_weights[j] = 2.0; // Give some weight to normal preservation, may be worth exposing as an import setting
+	}
+
+	const float max_mesh_error = FLT_MAX; // We don't want to limit by error, just by index target
+	data.scale = SurfaceTool::simplify_scale_func((const float *)merged_vertices_ptr, merged_vertex_count, sizeof(Vector3));
+	float mesh_error = 0.0f;
+
+	unsigned int index_target = 12; // Start with the smallest target, 4 triangles
+	unsigned int last_index_count = 0;
+
+	while (index_target < index_count) {
+		PackedInt32Array new_indices;
+		new_indices.resize(index_count);
 
-		unsigned int merged_vertex_count = merged_vertices.size();
-		const Vector3 *merged_vertices_ptr = merged_vertices.ptr();
-		const int32_t *merged_indices_ptr = merged_indices.ptr();
+		size_t new_index_count = SurfaceTool::simplify_with_attrib_func((unsigned int *)new_indices.ptrw(), (const uint32_t *)merged_indices_ptr, index_count, (const float *)merged_vertices_ptr, merged_vertex_count, sizeof(Vector3), index_target, max_mesh_error, &mesh_error, (float *)merged_normals.ptr(), normal_weights.ptr(), 3);
 
+		if (new_index_count < last_index_count * 1.5f) {
+			index_target = index_target * 1.5f;
+			continue;
+		}
+
+		if (new_index_count <= 0 || (new_index_count >= (index_count * 0.75f))) {
+			break;
+		}
+
+		new_indices.resize(new_index_count);
 		{
-			const int *counts_ptr = merged_normals_counts.ptr();
-			Vector3 *merged_normals_ptrw = merged_normals.ptr();
-			for (unsigned int j = 0; j < merged_vertex_count; j++) {
-				merged_normals_ptrw[j] /= counts_ptr[j];
+			int *ptrw = new_indices.ptrw();
+			for (unsigned int j = 0; j < new_index_count; j++) {
+				ptrw[j] = vertex_inverse_remap[ptrw[j]];
 			}
 		}
 
-		LocalVector<float> normal_weights;
-		normal_weights.resize(merged_vertex_count);
-		for (unsigned int j = 0; j < merged_vertex_count; j++) {
-			normal_weights[j] = 2.0; // Give some weight to normal preservation, may be worth exposing as an import setting
+		LODGenerationData::LOD lod;
+		lod.indices = new_indices;
+		lod.error = mesh_error;
+		lod.seed = 123456789 + data.lods.size(); // Keep seed constant across imports
+		data.lods.push_back(lod);
+
+		index_target = MAX(new_index_count, index_target) * 2;
+		last_index_count = new_index_count;
+
+		if (mesh_error == 0.0f) {
+			break;
 		}
+	}
 
-		const float max_mesh_error = FLT_MAX; // We don't want to limit by error, just by index target
-		float scale = SurfaceTool::simplify_scale_func((const float *)merged_vertices_ptr, merged_vertex_count, sizeof(Vector3));
-		float mesh_error = 0.0f;
+	if (!data.lods.is_empty()) {
+		data.raycaster = StaticRaycaster::create();
+		if (data.raycaster.is_valid()) {
+			data.raycaster->add_mesh(data.vertices, data.indices, 0);
+			data.raycaster->commit();
+		}
+	}
+}
 
-		unsigned int index_target = 12; // Start with the smallest target, 4 triangles
-		unsigned int last_index_count = 0;
+void ImporterMesh::_split_lod_normals(uint32_t p_job, LODGenerationData *p_data) {
+	const LODGenerationData::LODJob &job = p_data->lod_jobs[p_job];
+	LODGenerationData::SurfaceData &data = p_data->surface_data[job.surface];
+	LODGenerationData::LOD &lod = data.lods[job.lod];
 
-		int split_vertex_count = vertex_count;
-		LocalVector<Vector3> split_vertex_normals;
-		LocalVector<int> split_vertex_indices;
-		split_vertex_normals.reserve(index_count / 3);
-		split_vertex_indices.reserve(index_count / 3);
+	if (data.raycaster.is_null()) {
+		return;
+	}
 
-		RandomPCG pcg;
-		pcg.seed(123456789); // Keep seed constant across imports
+	const unsigned int vertex_count = data.vertices.size();
+	const unsigned int new_index_count = lod.indices.size();
+	const Vector3 *vertices_ptr = data.vertices.ptr();
+	const int *indices_ptr = data.indices.ptr();
+	const Vector3 *normals_ptr = data.normals.ptr();
+	const float scale = data.scale;
+	const float mesh_error = lod.error;
+	const float normal_pre_split_threshold = p_data->normal_pre_split_threshold;
+	const float normal_split_threshold = p_data->normal_split_threshold;
 
-		Ref<StaticRaycaster> raycaster = StaticRaycaster::create();
-		if (raycaster.is_valid()) {
-			raycaster->add_mesh(vertices, indices, 0);
-			raycaster->commit();
-		}
+	int split_vertex_count = vertex_count;
 
-		while (index_target < index_count) {
-			PackedInt32Array new_indices;
-			new_indices.resize(index_count);
+	RandomPCG pcg;
+	pcg.seed(lod.seed);
 
-			size_t new_index_count = SurfaceTool::simplify_with_attrib_func((unsigned int *)new_indices.ptrw(), (const uint32_t *)merged_indices_ptr, index_count, (const float *)merged_vertices_ptr, merged_vertex_count, sizeof(Vector3), index_target, max_mesh_error, &mesh_error, (float *)merged_normals.ptr(), normal_weights.ptr(), 3);
+	int32_t *new_indices_ptr = lod.indices.ptrw();
 
-			if (new_index_count < last_index_count * 1.5f) {
-				index_target = index_target * 1.5f;
-				continue;
-			}
+	LocalVector<LocalVector<int>> vertex_corners;
+	vertex_corners.resize(vertex_count);
+	for (unsigned int j = 0; j < new_index_count; j++) {
+		vertex_corners[new_indices_ptr[j]].push_back(j);
+	}
 
-			if (new_index_count <= 0 || (new_index_count >= (index_count * 0.75f))) {
-				break;
-			}
+	float error_factor = 1.0f / (scale * MAX(mesh_error, 0.15));
+	const float ray_bias = 0.05;
+	float ray_length = ray_bias + mesh_error * scale * 3.0f;
 
-			new_indices.resize(new_index_count);
+	Vector<StaticRaycaster::Ray> rays;
+	LocalVector<Vector2> ray_uvs;
 
-			LocalVector<LocalVector<int>> vertex_corners;
-			vertex_corners.resize(vertex_count);
-			{
-				int *ptrw = new_indices.ptrw();
-				for (unsigned int j = 0; j < new_index_count; j++) {
-					const int &remapped = vertex_inverse_remap[ptrw[j]];
-					vertex_corners[remapped].push_back(j);
-					ptrw[j] = remapped;
-				}
-			}
+	int current_ray_count = 0;
+	for (unsigned int j = 0; j < new_index_count; j += 3) {
+		const Vector3 &v0 = vertices_ptr[new_indices_ptr[j + 0]];
+		const Vector3 &v1 = vertices_ptr[new_indices_ptr[j + 1]];
+		const Vector3 &v2 = vertices_ptr[new_indices_ptr[j + 2]];
+		Vector3 face_normal = vec3_cross(v0 - v2, v0 - v1);
+		float face_area = face_normal.length(); // Actually twice the face area, since it's the same error_factor on all faces, we don't care
 
-			if (raycaster.is_valid()) {
-				float error_factor = 1.0f / (scale * MAX(mesh_error, 0.15));
-				const float ray_bias = 0.05;
-				float ray_length = ray_bias + mesh_error * scale * 3.0f;
+		Vector3 dir = face_normal / face_area;
+		int ray_count = CLAMP(5.0 * face_area * error_factor, 16, 64);
 
-				Vector<StaticRaycaster::Ray> rays;
-				LocalVector<Vector2> ray_uvs;
+		rays.resize(current_ray_count + ray_count);
+		StaticRaycaster::Ray *rays_ptr = rays.ptrw();
 
-				int32_t *new_indices_ptr = new_indices.ptrw();
+		ray_uvs.resize(current_ray_count + ray_count);
+		Vector2 *ray_uvs_ptr = ray_uvs.ptr();
 
-				int current_ray_count = 0;
-				for (unsigned int j = 0; j < new_index_count; j += 3) {
-					const Vector3 &v0 = vertices_ptr[new_indices_ptr[j + 0]];
-					const Vector3 &v1 = vertices_ptr[new_indices_ptr[j + 1]];
-					const Vector3 &v2 = vertices_ptr[new_indices_ptr[j + 2]];
-					Vector3 face_normal = vec3_cross(v0 - v2, v0 - v1);
-					float face_area = face_normal.length(); // Actually twice the face area, since it's the same error_factor on all faces, we don't care
+		for (int k = 0; k < ray_count; k++) {
+			float u = pcg.randf();
+			float v = pcg.randf();
 
-					Vector3 dir = face_normal / face_area;
-					int ray_count = CLAMP(5.0 * face_area * error_factor, 16, 64);
+			if (u + v >= 1.0f) {
+				u = 1.0f - u;
+				v = 1.0f - v;
+			}
 
-					rays.resize(current_ray_count + ray_count);
-					StaticRaycaster::Ray *rays_ptr = rays.ptrw();
+			u = 0.9f * u + 0.05f / 3.0f; // Give barycentric coordinates some padding, we don't want to sample right on the edge
+			v = 0.9f * v + 0.05f / 3.0f; // v = (v - one_third) * 0.95f + one_third;
+			float w = 1.0f - u - v;
 
-					ray_uvs.resize(current_ray_count + ray_count);
-					Vector2 *ray_uvs_ptr = ray_uvs.ptr();
+			Vector3 org = v0 * w + v1 * u + v2 * v;
+			org -= dir * ray_bias;
+			rays_ptr[current_ray_count + k] = StaticRaycaster::Ray(org, dir, 0.0f, ray_length);
+			rays_ptr[current_ray_count + k].id = j / 3;
+			ray_uvs_ptr[current_ray_count + k] = Vector2(u, v);
+		}
 
-					for (int k = 0; k < ray_count; k++) {
-						float u = pcg.randf();
-						float v = pcg.randf();
+		current_ray_count += ray_count;
+	}
 
-						if (u + v >= 1.0f) {
-							u = 1.0f - u;
-							v = 1.0f - v;
-						}
+	data.raycaster->intersect(rays);
 
-						u = 0.9f * u + 0.05f / 3.0f; // Give barycentric coordinates some padding, we don't want to sample right on the edge
-						v = 0.9f * v + 0.05f / 3.0f; // v = (v - one_third) * 0.95f + one_third;
-						float w = 1.0f - u - v;
+	LocalVector<Vector3> ray_normals;
+	LocalVector<real_t> ray_normal_weights;
 
-						Vector3 org = v0 * w + v1 * u + v2 * v;
-						org -= dir * ray_bias;
-						rays_ptr[current_ray_count + k] = StaticRaycaster::Ray(org, dir, 0.0f, ray_length);
-						rays_ptr[current_ray_count + k].id = j / 3;
-						ray_uvs_ptr[current_ray_count + k] = Vector2(u, v);
-					}
+	ray_normals.resize(new_index_count);
+	ray_normal_weights.resize(new_index_count);
 
-					current_ray_count += ray_count;
-				}
+	for (unsigned int j = 0; j < new_index_count; j++) {
+		ray_normal_weights[j] = 0.0f;
+	}
 
-				raycaster->intersect(rays);
+	const StaticRaycaster::Ray *rp = rays.ptr();
+	for (int j = 0; j < rays.size(); j++) {
+		if (rp[j].geomID != 0) { // Ray missed
+			continue;
+		}
 
-				LocalVector<Vector3> ray_normals;
-				LocalVector<real_t> ray_normal_weights;
+		if (rp[j].normal.normalized().dot(rp[j].dir) > 0.0f) { // Hit a back face.
+			continue;
+		}
 
-				ray_normals.resize(new_index_count);
-				ray_normal_weights.resize(new_index_count);
+		const float &u = rp[j].u;
+		const float &v = rp[j].v;
+		const float w = 1.0f - u - v;
+
+		const unsigned int &hit_tri_id = rp[j].primID;
+		const unsigned int &orig_tri_id = rp[j].id;
+
+		const Vector3 &n0 = normals_ptr[indices_ptr[hit_tri_id * 3 + 0]];
+		const Vector3 &n1 = normals_ptr[indices_ptr[hit_tri_id * 3 + 1]];
+		const Vector3 &n2 = normals_ptr[indices_ptr[hit_tri_id * 3 + 2]];
+		Vector3 normal = n0 * w + n1 * u + n2 * v;
+
+		Vector2 orig_uv = ray_uvs[j];
+		real_t orig_bary[3] = { 1.0f - orig_uv.x - orig_uv.y, orig_uv.x, orig_uv.y };
+		for (int k = 0; k < 3; k++) {
+			int idx = orig_tri_id * 3 + k;
+			real_t weight = orig_bary[k];
+			ray_normals[idx] += normal * weight;
+			ray_normal_weights[idx] += weight;
+		}
+	}
 
-				for (unsigned int j = 0; j < new_index_count; j++) {
-					ray_normal_weights[j] = 0.0f;
-				}
+	for (unsigned int j = 0; j < new_index_count; j++) {
+		if (ray_normal_weights[j] < 1.0f) { // Not enough data, the new normal would be just a bad guess
+			ray_normals[j] = Vector3();
+		} else {
+			ray_normals[j] /= ray_normal_weights[j];
+		}
+	}
 
-				const StaticRaycaster::Ray *rp = rays.ptr();
-				for (int j = 0; j < rays.size(); j++) {
-					if (rp[j].geomID != 0) { // Ray missed
-						continue;
-					}
+	LocalVector<LocalVector<int>> normal_group_indices;
+	LocalVector<Vector3> normal_group_averages;
+	normal_group_indices.reserve(24);
+	normal_group_averages.reserve(24);
 
-					if (rp[j].normal.normalized().dot(rp[j].dir) > 0.0f) { // Hit a back face.
-						continue;
-					}
+	for (unsigned int j = 0; j < vertex_count; j++) {
+		const LocalVector<int> &corners = vertex_corners[j];
+		const Vector3 &vertex_normal = normals_ptr[j];
 
-					const float &u = rp[j].u;
-					const float &v = rp[j].v;
-					const float w = 1.0f - u - v;
-
-					const unsigned int &hit_tri_id = rp[j].primID;
-					const unsigned int &orig_tri_id = rp[j].id;
-
-					const Vector3 &n0 = normals_ptr[indices_ptr[hit_tri_id * 3 + 0]];
-					const Vector3 &n1 = normals_ptr[indices_ptr[hit_tri_id * 3 + 1]];
-					const Vector3 &n2 = normals_ptr[indices_ptr[hit_tri_id * 3 + 2]];
-					Vector3 normal = n0 * w + n1 * u + n2 * v;
-
-					Vector2 orig_uv = ray_uvs[j];
-					real_t orig_bary[3] = { 1.0f - orig_uv.x - orig_uv.y, orig_uv.x, orig_uv.y };
-					for (int k = 0; k < 3; k++) {
-						int idx = orig_tri_id * 3 + k;
-						real_t weight = orig_bary[k];
-						ray_normals[idx] += normal * weight;
-						ray_normal_weights[idx] += weight;
-					}
-				}
+		for (unsigned int k = 0; k < corners.size(); k++) {
+			const int &corner_idx = corners[k];
+			const Vector3 &ray_normal = ray_normals[corner_idx];
 
-				for (unsigned int j = 0; j < new_index_count; j++) {
-					if (ray_normal_weights[j] < 1.0f) { // Not enough data, the new normal would be just a bad guess
-						ray_normals[j] = Vector3();
-					} else {
-						ray_normals[j] /= ray_normal_weights[j];
-					}
+			if (ray_normal.length_squared() < CMP_EPSILON2) {
+				continue;
+			}
+
+			bool found = false;
+			for (unsigned int l = 0; l < normal_group_indices.size(); l++) {
+				LocalVector<int> &group_indices = normal_group_indices[l];
+				Vector3 n = normal_group_averages[l] / group_indices.size();
+				if (n.dot(ray_normal) > normal_pre_split_threshold) {
+					found = true;
+					group_indices.push_back(corner_idx);
+					normal_group_averages[l] += ray_normal;
+					break;
 				}
+			}
 
-				LocalVector<LocalVector<int>> normal_group_indices;
-				LocalVector<Vector3> normal_group_averages;
-				normal_group_indices.reserve(24);
-				normal_group_averages.reserve(24);
-
-				for (unsigned int j = 0; j < vertex_count; j++) {
-					const LocalVector<int> &corners = vertex_corners[j];
-					const Vector3 &vertex_normal = normals_ptr[j];
-
-					for (unsigned int k = 0; k < corners.size(); k++) {
-						const int &corner_idx = corners[k];
-						const Vector3 &ray_normal = ray_normals[corner_idx];
-
-						if (ray_normal.length_squared() < CMP_EPSILON2) {
-							continue;
-						}
-
-						bool found = false;
-						for (unsigned int l = 0; l < normal_group_indices.size(); l++) {
-							LocalVector<int> &group_indices = normal_group_indices[l];
-							Vector3 n = normal_group_averages[l] / group_indices.size();
-							if (n.dot(ray_normal) > normal_pre_split_threshold) {
-								found = true;
-								group_indices.push_back(corner_idx);
-								normal_group_averages[l] += ray_normal;
-								break;
-							}
-						}
-
-						if (!found) {
-							LocalVector<int> new_group;
-							new_group.push_back(corner_idx);
-							normal_group_indices.push_back(new_group);
-							normal_group_averages.push_back(ray_normal);
-						}
-					}
+			if (!found) {
+				LocalVector<int> new_group;
+				new_group.push_back(corner_idx);
+				normal_group_indices.push_back(new_group);
+				normal_group_averages.push_back(ray_normal);
+			}
+		}
 
-					for (unsigned int k = 0; k < normal_group_indices.size(); k++) {
-						LocalVector<int> &group_indices = normal_group_indices[k];
-						Vector3 n = normal_group_averages[k] / group_indices.size();
-
-						if (vertex_normal.dot(n) < normal_split_threshold) {
-							split_vertex_indices.push_back(j);
-							split_vertex_normals.push_back(n);
-							int new_idx = split_vertex_count++;
-							for (unsigned int l = 0; l < group_indices.size(); l++) {
-								new_indices_ptr[group_indices[l]] = new_idx;
-							}
-						}
-					}
+		for (unsigned int k = 0; k < normal_group_indices.size(); k++) {
+			LocalVector<int> &group_indices = normal_group_indices[k];
+			Vector3 n = normal_group_averages[k] / group_indices.size();
 
-					normal_group_indices.clear();
-					normal_group_averages.clear();
+			if (vertex_normal.dot(n) < normal_split_threshold) {
+				lod.split_vertex_indices.push_back(j);
+				lod.split_vertex_normals.push_back(n);
+				int new_idx = split_vertex_count++;
+				for (unsigned int l = 0; l < group_indices.size(); l++) {
+					new_indices_ptr[group_indices[l]] = new_idx;
 				}
 			}
+		}
 
-			Surface::LOD lod;
-			lod.distance = MAX(mesh_error * scale, CMP_EPSILON2);
-			lod.indices = new_indices;
-			surfaces.write[i].lods.push_back(lod);
-			index_target = MAX(new_index_count, index_target) * 2;
-			last_index_count = new_index_count;
+		normal_group_indices.clear();
+		normal_group_averages.clear();
+	}
+}
 
-			if (mesh_error == 0.0f) {
-				break;
+void ImporterMesh::_finish_surface_lods(uint32_t p_surface, LODGenerationData *p_data) {
+	Surface &surface = p_data->surfaces[p_surface];
+	LODGenerationData::SurfaceData &data = p_data->surface_data[p_surface];
+	if (data.lods.is_empty()) {
+		return;
+	}
+
+	const int vertex_count = data.vertices.size();
+	int split_vertex_count = vertex_count;
+	LocalVector<Vector3> split_vertex_normals;
+	LocalVector<int> split_vertex_indices;
+
+	for (uint32_t j = 0; j < data.lods.size(); j++) {
+		LODGenerationData::LOD &lod = data.lods[j];
+
+		// Move this level's split vertices after the ones of the previous levels.
+		const int offset = split_vertex_count - vertex_count;
+		if (offset > 0 && !lod.split_vertex_indices.is_empty()) {
+			int *ptrw = lod.indices.ptrw();
+			for (int k = 0; k < lod.indices.size(); k++) {
+				if (ptrw[k] >= vertex_count) {
+					ptrw[k] += offset;
+				}
 			}
 		}
+		for (uint32_t k = 0; k < lod.split_vertex_indices.size(); k++) {
+			split_vertex_indices.push_back(lod.split_vertex_indices[k]);
+			split_vertex_normals.push_back(lod.split_vertex_normals[k]);
+		}
+		split_vertex_count += lod.split_vertex_indices.size();
+
+		Surface::LOD surface_lod;
+		surface_lod.distance = MAX(lod.error * data.scale, CMP_EPSILON2);
+		surface_lod.indices = lod.indices;
+		surface.lods.push_back(surface_lod);
+	}
+
+	surface.split_normals(split_vertex_indices, split_vertex_normals);
+	surface.lods.sort_custom<Surface::LODComparator>();
+
+	for (int j = 0; j < surface.lods.size(); j++) {
+		Surface::LOD &lod = surface.lods.write[j];
+		unsigned int *lod_indices_ptr = (unsigned int *)lod.indices.ptrw();
+		SurfaceTool::optimize_vertex_cache_func(lod_indices_ptr, lod_indices_ptr, lod.indices.size(), split_vertex_count);
+	}
+
+	data.raycaster.unref();
+}
+
+void ImporterMesh::generate_lods(float p_normal_merge_angle, float p_normal_split_angle, ThreadWorkPool *p_thread_pool) {
+	if (!SurfaceTool::simplify_scale_func) {
+		return;
+	}
+	if (!SurfaceTool::simplify_with_attrib_func) {
+		return;
+	}
+	if (!SurfaceTool::optimize_vertex_cache_func) {
+		return;
+	}
+
+	LODGenerationData data;
+	data.surfaces = surfaces.ptrw();
+	data.surface_data.resize(surfaces.size());
+	data.normal_merge_threshold = Math::cos(Math::deg2rad(p_normal_merge_angle));
+	data.normal_pre_split_threshold = Math::cos(Math::deg2rad(MIN(180.0f, p_normal_split_angle * 2.0f)));
+	data.normal_split_threshold = Math::cos(Math::deg2rad(p_normal_split_angle));
+
+	const bool use_threads = p_thread_pool && p_thread_pool->get_thread_count() > 1;
+
+	if (use_threads) {
+		p_thread_pool->do_work(data.surface_data.size(), this, &ImporterMesh::_generate_surface_lods, &data);
+	} else {
+		for (uint32_t i = 0; i < data.surface_data.size(); i++) {
+			_generate_surface_lods(i, &data);
+		}
+	}
 
-		surfaces.write[i].split_normals(split_vertex_indices, split_vertex_normals);
-		surfaces.write[i].lods.sort_custom<Surface::LODComparator>();
+	for (uint32_t i = 0; i < data.surface_data.size(); i++) {
+		for (uint32_t j = 0; j < data.surface_data[i].lods.size(); j++) {
+			LODGenerationData::LODJob job;
+			job.surface = i;
+			job.lod = j;
+			data.lod_jobs.push_back(job);
+		}
+	}
 
-		for (int j = 0; j < surfaces.write[i].lods.size(); j++) {
-			Surface::LOD &lod = surfaces.write[i].lods.write[j];
-			unsigned int *lod_indices_ptr = (unsigned int *)lod.indices.ptrw();
-			SurfaceTool::optimize_vertex_cache_func(lod_indices_ptr, lod_indices_ptr, lod.indices.size(), split_vertex_count);
+	if (use_threads) {
+		p_thread_pool->do_work(data.lod_jobs.size(), this, &ImporterMesh::_split_lod_normals, &data);
+		p_thread_pool->do_work(data.surface_data.size(), this, &ImporterMesh::_finish_surface_lods, &data);
+	} else {
+		for (uint32_t i = 0; i < data.lod_jobs.size(); i++) {
+			_split_lod_normals(i, &data);
+		}
+		for (uint32_t i = 0; i < data.surface_data.size(); i++) {
+			_finish_surface_lods(i, &data);
 		}
 	}
 }
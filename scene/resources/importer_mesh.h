@@ -40,6 +40,8 @@
 
 #include <cstdint>
 
+class ThreadWorkPool;
+
 // The following classes are used by importers instead of ArrayMesh and MeshInstance3D
 // so the data is not registered (hence, quality loss), importing happens faster and
 // its easier to modify before saving
@@ -82,6 +84,12 @@ class ImporterMesh : public Resource {
 
 	Size2i lightmap_size_hint;
 
+	struct LODGenerationData;
+	void _generate_surface_lods(uint32_t p_surface, LODGenerationData *p_data);
+	void _split_lod_normals(uint32_t p_job, LODGenerationData *p_data);
+	void _finish_surface_lods(uint32_t p_surface, LODGenerationData *p_data);
+	void _optimize_surface(uint32_t p_surface, Surface *p_surfaces);
+
 protected:
 	void _set_data(const Dictionary &p_data);
 	Dictionary _get_data() const;
@@ -112,7 +120,8 @@ public:
 
 	void set_surface_material(int p_surface, const Ref<Material> &p_material);
 
-	void generate_lods(float p_normal_merge_angle, float p_normal_split_angle);
+	void optimize_surfaces(ThreadWorkPool *p_thread_pool = nullptr);
+	void generate_lods(float p_normal_merge_angle, float p_normal_split_angle, ThreadWorkPool *p_thread_pool = nullptr);
 
 	void create_shadow_mesh();
 	Ref<ImporterMesh> get_shadow_mesh() const;
@@ -34,6 +34,8 @@
 #include "servers/display_server.h"
 
 #include "servers/rendering/rasterizer_dummy.h"
+#include "servers/rendering/renderer_rd/renderer_compositor_rd.h"
+#include "servers/rendering/rendering_device_recorder.h"
 
 class DisplayServerHeadless : public DisplayServer {
 private:
@@ -42,15 +44,24 @@ private:
 	static Vector<String> get_rendering_drivers_func() {
 		Vector<String> drivers;
 		drivers.push_back("dummy");
+		drivers.push_back("recorder");
 		return drivers;
 	}
 
 	static DisplayServer *create_func(const String &p_rendering_driver, DisplayServer::WindowMode p_mode, DisplayServer::VSyncMode p_vsync_mode, uint32_t p_flags, const Vector2i &p_resolution, Error &r_error) {
 		r_error = OK;
+		if (p_rendering_driver == "recorder") {
+			return memnew(DisplayServerHeadless(p_resolution));
+		}
 		RasterizerDummy::make_current();
 		return memnew(DisplayServerHeadless());
 	}
 
+	// Only used by the "recorder" rendering driver, which runs the RD renderers
+	// on a device that records the commands instead of executing them.
+	RenderingDeviceRecorder *rendering_device_recorder = nullptr;
+	Size2i window_size;
+
 public:
 	bool has_feature(Feature p_feature) const override { return false; }
 	String get_name() const override { return "headless"; }
@@ -101,8 +112,8 @@ public:
 	Size2i window_get_min_size(WindowID p_window = MAIN_WINDOW_ID) const override { return Size2i(); }
 
 	void window_set_size(const Size2i p_size, WindowID p_window = MAIN_WINDOW_ID) override {}
-	Size2i window_get_size(WindowID p_window = MAIN_WINDOW_ID) const override { return Size2i(); }
-	Size2i window_get_real_size(WindowID p_window = MAIN_WINDOW_ID) const override { return Size2i(); }
+	Size2i window_get_size(WindowID p_window = MAIN_WINDOW_ID) const override { return window_size; }
+	Size2i window_get_real_size(WindowID p_window = MAIN_WINDOW_ID) const override { return window_size; }
 
 	void window_set_mode(WindowMode p_mode, WindowID p_window = MAIN_WINDOW_ID) override {}
 	WindowMode window_get_mode(WindowID p_window = MAIN_WINDOW_ID) const override { return WINDOW_MODE_MINIMIZED; }
@@ -118,9 +129,9 @@ public:
 	void window_request_attention(WindowID p_window = MAIN_WINDOW_ID) override {}
 	void window_move_to_foreground(WindowID p_window = MAIN_WINDOW_ID) override {}
 
-	bool window_can_draw(WindowID p_window = MAIN_WINDOW_ID) const override { return false; }
+	bool window_can_draw(WindowID p_window = MAIN_WINDOW_ID) const override { return rendering_device_recorder != nullptr; }
 
-	bool can_any_window_draw() const override { return false; }
+	bool can_any_window_draw() const override { return rendering_device_recorder != nullptr; }
 
 	void window_set_ime_active(const bool p_active, WindowID p_window = MAIN_WINDOW_ID) override {}
 	void window_set_ime_position(const Point2i &p_pos, WindowID p_window = MAIN_WINDOW_ID) override {}
@@ -130,7 +141,21 @@ public:
 	void set_icon(const Ref<Image> &p_icon) override {}
 
 	DisplayServerHeadless() {}
-	~DisplayServerHeadless() {}
+
+	DisplayServerHeadless(const Size2i &p_resolution) {
+		window_size = p_resolution;
+		rendering_device_recorder = memnew(RenderingDeviceRecorder);
+		rendering_device_recorder->initialize(window_size);
+		RendererCompositorRD::make_current();
+	}
+
+	~DisplayServerHeadless() {
+		if (rendering_device_recorder) {
+			rendering_device_recorder->finalize();
+			RenderingDeviceRecorder::print_stats(rendering_device_recorder->get_stats());
+			memdelete(rendering_device_recorder);
+		}
+	}
 };
 
 #endif // DISPLAY_SERVER_HEADLESS_H
@@ -74,6 +74,12 @@ public:
 	/// Returns the edge connection margin of this map.
 	virtual real_t map_get_edge_connection_margin(RID p_map) const;
 
+	/// Set if the paths between regions are planned on the region graph first.
+	virtual void map_set_use_hierarchical_paths(RID p_map, bool p_enabled) const;
+
+	/// Returns true if the paths between regions are planned on the region graph first.
+	virtual bool map_get_use_hierarchical_paths(RID p_map) const;
+
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector2> map_get_path(RID p_map, Vector2 p_origin, Vector2 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
 
@@ -42,12 +42,23 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_cell_size", "map"), &NavigationServer3D::map_get_cell_size);
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer3D::map_set_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer3D::map_get_edge_connection_margin);
+	ClassDB::bind_method(D_METHOD("map_set_use_hierarchical_paths", "map", "enabled"), &NavigationServer3D::map_set_use_hierarchical_paths);
+	ClassDB::bind_method(D_METHOD("map_get_use_hierarchical_paths", "map"), &NavigationServer3D::map_get_use_hierarchical_paths);
+	ClassDB::bind_method(D_METHOD("map_set_avoidance_callback", "map", "callback"), &NavigationServer3D::map_set_avoidance_callback);
+	ClassDB::bind_method(D_METHOD("map_get_avoidance_callback", "map"), &NavigationServer3D::map_get_avoidance_callback);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize", "layers"), &NavigationServer3D::map_get_path, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("map_get_path_async", "map", "origin", "destination", "optimize", "callback", "layers"), &NavigationServer3D::map_get_path_async, DEFVAL(Callable()), DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer3D::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer3D::map_get_closest_point_normal);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_owner", "map", "to_point"), &NavigationServer3D::map_get_closest_point_owner);
 
+	ClassDB::bind_method(D_METHOD("path_query_is_done", "query"), &NavigationServer3D::path_query_is_done);
+	ClassDB::bind_method(D_METHOD("path_query_get_result", "query"), &NavigationServer3D::path_query_get_result);
+	ClassDB::bind_method(D_METHOD("path_query_cancel", "query"), &NavigationServer3D::path_query_cancel);
+	ClassDB::bind_method(D_METHOD("set_path_query_time_budget", "msec"), &NavigationServer3D::set_path_query_time_budget);
+	ClassDB::bind_method(D_METHOD("get_path_query_time_budget"), &NavigationServer3D::get_path_query_time_budget);
+
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_map", "region", "map"), &NavigationServer3D::region_set_map);
 	ClassDB::bind_method(D_METHOD("region_set_layers", "region", "layers"), &NavigationServer3D::region_set_layers);
@@ -55,6 +66,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("region_set_transform", "region", "transform"), &NavigationServer3D::region_set_transform);
 	ClassDB::bind_method(D_METHOD("region_set_navmesh", "region", "nav_mesh"), &NavigationServer3D::region_set_navmesh);
 	ClassDB::bind_method(D_METHOD("region_bake_navmesh", "mesh", "node"), &NavigationServer3D::region_bake_navmesh);
+	ClassDB::bind_method(D_METHOD("region_bake_navmesh_tiles", "mesh", "node", "area"), &NavigationServer3D::region_bake_navmesh_tiles);
 	ClassDB::bind_method(D_METHOD("region_get_connections_count", "region"), &NavigationServer3D::region_get_connections_count);
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_start", "region", "connection"), &NavigationServer3D::region_get_connection_pathway_start);
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_end", "region", "connection"), &NavigationServer3D::region_get_connection_pathway_end);
@@ -71,6 +83,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("agent_set_position", "agent", "position"), &NavigationServer3D::agent_set_position);
 	ClassDB::bind_method(D_METHOD("agent_is_map_changed", "agent"), &NavigationServer3D::agent_is_map_changed);
 	ClassDB::bind_method(D_METHOD("agent_set_callback", "agent", "receiver", "method", "userdata"), &NavigationServer3D::agent_set_callback, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("agent_set_avoidance_batched", "agent", "batched"), &NavigationServer3D::agent_set_avoidance_batched);
 
 	ClassDB::bind_method(D_METHOD("free", "object"), &NavigationServer3D::free);
 
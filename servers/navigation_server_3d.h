@@ -83,9 +83,39 @@ public:
 	/// Returns the edge connection margin of this map.
 	virtual real_t map_get_edge_connection_margin(RID p_map) const = 0;
 
+	/// Set if the paths between regions are planned on the region graph first.
+	virtual void map_set_use_hierarchical_paths(RID p_map, bool p_enabled) const = 0;
+
+	/// Returns true if the paths between regions are planned on the region graph first.
+	virtual bool map_get_use_hierarchical_paths(RID p_map) const = 0;
+
+	/// Set the callback receiving the velocities of all the batched agents of the map at the end of the RVO process.
+	virtual void map_set_avoidance_callback(RID p_map, Callable p_callback) const = 0;
+
+	/// Returns the callback receiving the velocities of the batched agents.
+	virtual Callable map_get_avoidance_callback(RID p_map) const = 0;
+
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigable_layers = 1) const = 0;
 
+	/// Queues a path query, it's processed during the next `process` calls.
+	/// Returns the query id, which is passed to the callback with the path, if
+	/// the callback is valid, otherwise the path can be polled with `path_query_get_result`.
+	virtual int map_get_path_async(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, const Callable &p_callback = Callable(), uint32_t p_navigable_layers = 1) const = 0;
+
+	/// Returns true if the path of a polled query is ready.
+	virtual bool path_query_is_done(int p_query) const = 0;
+
+	/// Returns the path of a polled query and forgets the query.
+	virtual Vector<Vector3> path_query_get_result(int p_query) const = 0;
+
+	/// Forgets a query, whether it's still queued or done but not polled.
+	virtual void path_query_cancel(int p_query) const = 0;
+
+	/// Time the queued path queries can take each `process` call, in milliseconds.
+	virtual void set_path_query_time_budget(real_t p_msec) const = 0;
+	virtual real_t get_path_query_time_budget() const = 0;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const = 0;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
@@ -110,6 +140,9 @@ public:
 	/// Bake the navigation mesh.
 	virtual void region_bake_navmesh(Ref<NavigationMesh> r_mesh, Node *p_node) const = 0;
 
+	/// Rebake the tiles of the navigation mesh that intersect the area.
+	virtual void region_bake_navmesh_tiles(Ref<NavigationMesh> r_mesh, Node *p_node, const AABB &p_area) const = 0;
+
 	/// Get a list of a region's connection to other regions.
 	virtual int region_get_connections_count(RID p_region) const = 0;
 	virtual Vector3 region_get_connection_pathway_start(RID p_region, int p_connection_id) const = 0;
@@ -174,6 +207,9 @@ public:
 	/// Callback called at the end of the RVO process
 	virtual void agent_set_callback(RID p_agent, Object *p_receiver, StringName p_method, Variant p_udata = Variant()) const = 0;
 
+	/// Deliver the agent velocity through the map avoidance callback instead of a per-agent call.
+	virtual void agent_set_avoidance_batched(RID p_agent, bool p_batched) const = 0;
+
 	/// Destroy the `RID`
 	virtual void free(RID p_object) const = 0;
 
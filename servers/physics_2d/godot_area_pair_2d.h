@@ -45,6 +45,8 @@ class GodotAreaPair2D : public GodotConstraint2D {
 	bool process_collision = false;
 
 public:
+	virtual uint64_t get_solve_order() const override { return area->get_self().get_id(); }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
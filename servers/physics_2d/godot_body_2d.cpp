@@ -604,12 +604,23 @@ void GodotBody2D::integrate_forces(real_t p_step) {
 	biased_linear_velocity = Vector2();
 
 	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+		pending_motion = motion;
+		pending_motion_update = true;
 	}
 
 	contact_count = 0;
 }
 
+void GodotBody2D::update_motion_shapes() {
+	if (!pending_motion_update) {
+		return;
+	}
+
+	// The broadphase isn't thread-safe, so this is done after all the bodies are integrated.
+	_update_shapes_with_motion(pending_motion);
+	pending_motion_update = false;
+}
+
 void GodotBody2D::integrate_velocities(real_t p_step) {
 	if (mode == PhysicsServer2D::BODY_MODE_STATIC) {
 		return;
@@ -713,6 +724,45 @@ bool GodotBody2D::sleep_test(real_t p_step) {
 	}
 }
 
+void GodotBody2D::get_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.self = get_self();
+	r_snapshot.transform = get_transform();
+	r_snapshot.inv_transform = get_inv_transform();
+	r_snapshot.new_transform = new_transform;
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.prev_linear_velocity = prev_linear_velocity;
+	r_snapshot.prev_angular_velocity = prev_angular_velocity;
+	r_snapshot.constant_linear_velocity = constant_linear_velocity;
+	r_snapshot.constant_angular_velocity = constant_angular_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+}
+
+void GodotBody2D::set_snapshot(const Snapshot &p_snapshot) {
+	// Moves the broadphase proxies too, pairs are refreshed by the space afterwards.
+	_set_transform(p_snapshot.transform);
+	// Stepping uses inverse() and setting the state affine_inverse(), so the inverse can't be computed again here.
+	_set_inv_transform(p_snapshot.inv_transform);
+	_update_transform_dependent();
+
+	new_transform = p_snapshot.new_transform;
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	prev_linear_velocity = p_snapshot.prev_linear_velocity;
+	prev_angular_velocity = p_snapshot.prev_angular_velocity;
+	constant_linear_velocity = p_snapshot.constant_linear_velocity;
+	constant_angular_velocity = p_snapshot.constant_angular_velocity;
+	applied_force = p_snapshot.applied_force;
+	applied_torque = p_snapshot.applied_torque;
+	biased_linear_velocity = Vector2();
+	biased_angular_velocity = 0.0;
+	still_time = p_snapshot.still_time;
+	set_active(p_snapshot.active);
+}
+
 void GodotBody2D::set_state_sync_callback(void *p_instance, PhysicsServer2D::BodyStateCallback p_callback) {
 	body_state_callback_instance = p_instance;
 	body_state_callback = p_callback;
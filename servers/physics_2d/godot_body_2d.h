@@ -106,6 +106,10 @@ class GodotBody2D : public GodotCollisionObject2D {
 	virtual void _shapes_changed();
 	Transform2D new_transform;
 
+	// Broadphase update deferred by integrate_forces(), which can run on worker threads.
+	Vector2 pending_motion;
+	bool pending_motion_update = false;
+
 	List<Pair<GodotConstraint2D *, int>> constraint_list;
 
 	struct AreaCMP {
@@ -156,6 +160,27 @@ class GodotBody2D : public GodotCollisionObject2D {
 	friend class GodotPhysicsDirectBodyState2D; // i give up, too many functions to expose
 
 public:
+	// Internal simulation state, saved field by field by GodotSpace2D snapshots.
+	struct Snapshot {
+		RID self;
+		Transform2D transform;
+		Transform2D inv_transform;
+		Transform2D new_transform;
+		Vector2 linear_velocity;
+		real_t angular_velocity = 0.0;
+		Vector2 prev_linear_velocity;
+		real_t prev_angular_velocity = 0.0;
+		Vector2 constant_linear_velocity;
+		real_t constant_angular_velocity = 0.0;
+		Vector2 applied_force;
+		real_t applied_torque = 0.0;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void get_snapshot(Snapshot &r_snapshot) const;
+	void set_snapshot(const Snapshot &p_snapshot);
+
 	void set_state_sync_callback(void *p_instance, PhysicsServer2D::BodyStateCallback p_callback);
 	void set_force_integration_callback(const Callable &p_callable, const Variant &p_udata = Variant());
 
@@ -316,6 +341,7 @@ public:
 
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
+	void update_motion_shapes();
 
 	_FORCE_INLINE_ Vector2 get_velocity_in_local_point(const Vector2 &rel_pos) const {
 		return linear_velocity + Vector2(-angular_velocity * rel_pos.y, angular_velocity * rel_pos.x);
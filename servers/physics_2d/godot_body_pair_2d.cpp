@@ -571,8 +571,55 @@ void GodotBodyPair2D::solve(real_t p_step) {
 	}
 }
 
+void GodotBodyPair2D::get_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.body_A = A->get_self();
+	r_snapshot.body_B = B->get_self();
+	r_snapshot.shape_A = shape_A;
+	r_snapshot.shape_B = shape_B;
+	r_snapshot.offset_B = offset_B;
+	r_snapshot.sep_axis = sep_axis;
+	for (int i = 0; i < contact_count; i++) {
+		r_snapshot.contacts[i] = contacts[i];
+	}
+	r_snapshot.contact_count = contact_count;
+	r_snapshot.collided = collided;
+}
+
+void GodotBodyPair2D::set_snapshot(const Snapshot &p_snapshot) {
+	contact_count = MIN(p_snapshot.contact_count, (int)MAX_CONTACTS);
+	collided = p_snapshot.collided;
+
+	// The broadphase may have paired the bodies in the opposite order after a restore.
+	if (p_snapshot.body_A == A->get_self()) {
+		offset_B = p_snapshot.offset_B;
+		sep_axis = p_snapshot.sep_axis;
+		for (int i = 0; i < contact_count; i++) {
+			contacts[i] = p_snapshot.contacts[i];
+		}
+		return;
+	}
+
+	// The tangent is derived from the normal, so flipping the normal is enough to flip the tangent impulse.
+	offset_B = -p_snapshot.offset_B;
+	sep_axis = -p_snapshot.sep_axis;
+	for (int i = 0; i < contact_count; i++) {
+		Contact &c = contacts[i];
+		c = p_snapshot.contacts[i];
+		SWAP(c.local_A, c.local_B);
+		SWAP(c.rA, c.rB);
+		c.normal = -c.normal;
+	}
+}
+
+void GodotBodyPair2D::clear_contacts() {
+	contact_count = 0;
+	collided = false;
+	sep_axis = Vector2();
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
-		GodotConstraint2D(_arr, 2) {
+		GodotConstraint2D(_arr, 2),
+		pair_list(this) {
 	A = p_A;
 	B = p_B;
 	shape_A = p_shape_A;
@@ -580,9 +627,11 @@ GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p
 	space = A->get_space();
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
+	space->body_pair_add_to_list(&pair_list);
 }
 
 GodotBodyPair2D::~GodotBodyPair2D() {
+	space->body_pair_remove_from_list(&pair_list);
 	A->remove_constraint(this, 0);
 	B->remove_constraint(this, 1);
 }
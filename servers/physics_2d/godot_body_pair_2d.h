@@ -83,12 +83,38 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	bool oneway_disabled = false;
 	bool report_contacts_only = false;
 
+	SelfList<GodotBodyPair2D> pair_list;
+
 	bool _test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2D &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2D &p_xform_B);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
 public:
+	// Persistent contact cache (warm starting impulses), saved field by field by GodotSpace2D snapshots.
+	struct Snapshot {
+		RID body_A;
+		RID body_B;
+		int shape_A = 0;
+		int shape_B = 0;
+		Vector2 offset_B;
+		Vector2 sep_axis;
+		Contact contacts[MAX_CONTACTS];
+		int contact_count = 0;
+		bool collided = false;
+	};
+
+	_FORCE_INLINE_ GodotBody2D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody2D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
+	void get_snapshot(Snapshot &r_snapshot) const;
+	void set_snapshot(const Snapshot &p_snapshot);
+	void clear_contacts();
+
+	virtual uint64_t get_solve_order() const override { return ((uint64_t)shape_A << 32) | (uint32_t)shape_B; }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -1063,6 +1063,14 @@ void GodotSpace2D::body_remove_from_mass_properties_update_list(SelfList<GodotBo
 	mass_properties_update_list.remove(p_body);
 }
 
+void GodotSpace2D::body_pair_add_to_list(SelfList<GodotBodyPair2D> *p_pair) {
+	body_pair_list.add(p_pair);
+}
+
+void GodotSpace2D::body_pair_remove_from_list(SelfList<GodotBodyPair2D> *p_pair) {
+	body_pair_list.remove(p_pair);
+}
+
 GodotBroadPhase2D *GodotSpace2D::get_broadphase() {
 	return broadphase;
 }
@@ -1192,6 +1200,337 @@ real_t GodotSpace2D::get_param(PhysicsServer2D::SpaceParameter p_param) const {
 	return 0;
 }
 
+/* SNAPSHOTS */
+
+// Snapshots are only meant to be restored by the same build, so they are not portable across real_t precision or engine versions.
+// Every field is written on its own, so struct padding never ends up in a snapshot and equal states produce equal bytes.
+static const uint32_t SPACE_SNAPSHOT_MAGIC = 0x32535350; // "PSS2"
+static const uint32_t SPACE_SNAPSHOT_VERSION = 3;
+
+struct SpaceSnapshotWriter2D {
+	LocalVector<uint8_t> data;
+
+	template <class T>
+	void put(T p_value) {
+		uint32_t from = data.size();
+		data.resize(from + sizeof(T));
+		memcpy(data.ptr() + from, &p_value, sizeof(T));
+	}
+
+	void put_bool(bool p_value) {
+		put<uint8_t>(p_value ? 1 : 0);
+	}
+
+	void put_rid(const RID &p_value) {
+		put<uint64_t>(p_value.get_id());
+	}
+
+	void put_vector2(const Vector2 &p_value) {
+		put<real_t>(p_value.x);
+		put<real_t>(p_value.y);
+	}
+
+	void put_transform(const Transform2D &p_value) {
+		for (int i = 0; i < 3; i++) {
+			put_vector2(p_value.elements[i]);
+		}
+	}
+};
+
+struct SpaceSnapshotReader2D {
+	const uint8_t *ptr = nullptr;
+	const uint8_t *end = nullptr;
+	bool error = false;
+
+	template <class T>
+	T get() {
+		T value = T();
+		if (unlikely(error || end - ptr < (int64_t)sizeof(T))) {
+			error = true;
+			return value;
+		}
+		memcpy(&value, ptr, sizeof(T));
+		ptr += sizeof(T);
+		return value;
+	}
+
+	bool get_bool() {
+		return get<uint8_t>() != 0;
+	}
+
+	RID get_rid() {
+		return RID::from_uint64(get<uint64_t>());
+	}
+
+	Vector2 get_vector2() {
+		Vector2 value;
+		value.x = get<real_t>();
+		value.y = get<real_t>();
+		return value;
+	}
+
+	Transform2D get_transform() {
+		Transform2D value;
+		for (int i = 0; i < 3; i++) {
+			value.elements[i] = get_vector2();
+		}
+		return value;
+	}
+};
+
+static void _snapshot_put_body(SpaceSnapshotWriter2D &p_writer, const GodotBody2D::Snapshot &p_snapshot) {
+	p_writer.put_rid(p_snapshot.self);
+	p_writer.put_transform(p_snapshot.transform);
+	p_writer.put_transform(p_snapshot.inv_transform);
+	p_writer.put_transform(p_snapshot.new_transform);
+	p_writer.put_vector2(p_snapshot.linear_velocity);
+	p_writer.put<real_t>(p_snapshot.angular_velocity);
+	p_writer.put_vector2(p_snapshot.prev_linear_velocity);
+	p_writer.put<real_t>(p_snapshot.prev_angular_velocity);
+	p_writer.put_vector2(p_snapshot.constant_linear_velocity);
+	p_writer.put<real_t>(p_snapshot.constant_angular_velocity);
+	p_writer.put_vector2(p_snapshot.applied_force);
+	p_writer.put<real_t>(p_snapshot.applied_torque);
+	p_writer.put<real_t>(p_snapshot.still_time);
+	p_writer.put_bool(p_snapshot.active);
+}
+
+static void _snapshot_get_body(SpaceSnapshotReader2D &p_reader, GodotBody2D::Snapshot &r_snapshot) {
+	r_snapshot.self = p_reader.get_rid();
+	r_snapshot.transform = p_reader.get_transform();
+	r_snapshot.inv_transform = p_reader.get_transform();
+	r_snapshot.new_transform = p_reader.get_transform();
+	r_snapshot.linear_velocity = p_reader.get_vector2();
+	r_snapshot.angular_velocity = p_reader.get<real_t>();
+	r_snapshot.prev_linear_velocity = p_reader.get_vector2();
+	r_snapshot.prev_angular_velocity = p_reader.get<real_t>();
+	r_snapshot.constant_linear_velocity = p_reader.get_vector2();
+	r_snapshot.constant_angular_velocity = p_reader.get<real_t>();
+	r_snapshot.applied_force = p_reader.get_vector2();
+	r_snapshot.applied_torque = p_reader.get<real_t>();
+	r_snapshot.still_time = p_reader.get<real_t>();
+	r_snapshot.active = p_reader.get_bool();
+}
+
+// Contact is private to the pair, so its type is only ever deduced here.
+template <class T>
+static void _snapshot_put_contact(SpaceSnapshotWriter2D &p_writer, const T &p_contact) {
+	p_writer.put_vector2(p_contact.position);
+	p_writer.put_vector2(p_contact.normal);
+	p_writer.put_vector2(p_contact.local_A);
+	p_writer.put_vector2(p_contact.local_B);
+	p_writer.put<real_t>(p_contact.acc_normal_impulse);
+	p_writer.put<real_t>(p_contact.acc_tangent_impulse);
+	p_writer.put<real_t>(p_contact.acc_bias_impulse);
+	p_writer.put<real_t>(p_contact.acc_bias_impulse_center_of_mass);
+	p_writer.put<real_t>(p_contact.mass_normal);
+	p_writer.put<real_t>(p_contact.mass_tangent);
+	p_writer.put<real_t>(p_contact.bias);
+	p_writer.put<real_t>(p_contact.depth);
+	p_writer.put_bool(p_contact.active);
+	p_writer.put_bool(p_contact.used);
+	p_writer.put_vector2(p_contact.rA);
+	p_writer.put_vector2(p_contact.rB);
+	p_writer.put<real_t>(p_contact.bounce);
+}
+
+template <class T>
+static void _snapshot_get_contact(SpaceSnapshotReader2D &p_reader, T &r_contact) {
+	r_contact.position = p_reader.get_vector2();
+	r_contact.normal = p_reader.get_vector2();
+	r_contact.local_A = p_reader.get_vector2();
+	r_contact.local_B = p_reader.get_vector2();
+	r_contact.acc_normal_impulse = p_reader.get<real_t>();
+	r_contact.acc_tangent_impulse = p_reader.get<real_t>();
+	r_contact.acc_bias_impulse = p_reader.get<real_t>();
+	r_contact.acc_bias_impulse_center_of_mass = p_reader.get<real_t>();
+	r_contact.mass_normal = p_reader.get<real_t>();
+	r_contact.mass_tangent = p_reader.get<real_t>();
+	r_contact.bias = p_reader.get<real_t>();
+	r_contact.depth = p_reader.get<real_t>();
+	r_contact.active = p_reader.get_bool();
+	r_contact.used = p_reader.get_bool();
+	r_contact.rA = p_reader.get_vector2();
+	r_contact.rB = p_reader.get_vector2();
+	r_contact.bounce = p_reader.get<real_t>();
+}
+
+static void _snapshot_put_pair(SpaceSnapshotWriter2D &p_writer, const GodotBodyPair2D::Snapshot &p_snapshot) {
+	p_writer.put_rid(p_snapshot.body_A);
+	p_writer.put_rid(p_snapshot.body_B);
+	p_writer.put<int32_t>(p_snapshot.shape_A);
+	p_writer.put<int32_t>(p_snapshot.shape_B);
+	p_writer.put_vector2(p_snapshot.offset_B);
+	p_writer.put_vector2(p_snapshot.sep_axis);
+	p_writer.put_bool(p_snapshot.collided);
+	p_writer.put<int32_t>(p_snapshot.contact_count);
+	for (int i = 0; i < p_snapshot.contact_count; i++) {
+		_snapshot_put_contact(p_writer, p_snapshot.contacts[i]);
+	}
+}
+
+static void _snapshot_get_pair(SpaceSnapshotReader2D &p_reader, GodotBodyPair2D::Snapshot &r_snapshot) {
+	r_snapshot.body_A = p_reader.get_rid();
+	r_snapshot.body_B = p_reader.get_rid();
+	r_snapshot.shape_A = p_reader.get<int32_t>();
+	r_snapshot.shape_B = p_reader.get<int32_t>();
+	r_snapshot.offset_B = p_reader.get_vector2();
+	r_snapshot.sep_axis = p_reader.get_vector2();
+	r_snapshot.collided = p_reader.get_bool();
+	r_snapshot.contact_count = p_reader.get<int32_t>();
+
+	const int max_contacts = sizeof(r_snapshot.contacts) / sizeof(r_snapshot.contacts[0]);
+	if (r_snapshot.contact_count < 0 || r_snapshot.contact_count > max_contacts) {
+		p_reader.error = true;
+		return;
+	}
+	for (int i = 0; i < r_snapshot.contact_count; i++) {
+		_snapshot_get_contact(p_reader, r_snapshot.contacts[i]);
+	}
+}
+
+struct SpaceSnapshotPairKey2D {
+	RID body_A;
+	RID body_B;
+	int shape_A = 0;
+	int shape_B = 0;
+
+	static uint32_t hash(const SpaceSnapshotPairKey2D &p_key) {
+		uint32_t h = hash_one_uint64(p_key.body_A.get_id());
+		h = hash_djb2_one_32(hash_one_uint64(p_key.body_B.get_id()), h);
+		h = hash_djb2_one_32(p_key.shape_A, h);
+		return hash_djb2_one_32(p_key.shape_B, h);
+	}
+
+	bool operator==(const SpaceSnapshotPairKey2D &p_key) const {
+		return body_A == p_key.body_A && body_B == p_key.body_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+	}
+
+	// Pairs may be created in either order, so keys are stored with the lowest RID first.
+	SpaceSnapshotPairKey2D(const RID &p_body_A, int p_shape_A, const RID &p_body_B, int p_shape_B) {
+		if (p_body_B < p_body_A || (p_body_A == p_body_B && p_shape_B < p_shape_A)) {
+			body_A = p_body_B;
+			shape_A = p_shape_B;
+			body_B = p_body_A;
+			shape_B = p_shape_A;
+		} else {
+			body_A = p_body_A;
+			shape_A = p_shape_A;
+			body_B = p_body_B;
+			shape_B = p_shape_B;
+		}
+	}
+	SpaceSnapshotPairKey2D() {}
+};
+
+Vector<uint8_t> GodotSpace2D::create_snapshot() const {
+	uint32_t body_count = 0;
+	for (const GodotCollisionObject2D *E : objects) {
+		if (E->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			body_count++;
+		}
+	}
+
+	uint32_t pair_count = 0;
+	for (const SelfList<GodotBodyPair2D> *E = body_pair_list.first(); E; E = E->next()) {
+		pair_count++;
+	}
+
+	SpaceSnapshotWriter2D writer;
+	writer.put<uint32_t>(SPACE_SNAPSHOT_MAGIC);
+	writer.put<uint32_t>(SPACE_SNAPSHOT_VERSION);
+	writer.put<uint32_t>(sizeof(real_t));
+	writer.put<uint32_t>(body_count);
+	writer.put<uint32_t>(pair_count);
+
+	GodotBody2D::Snapshot body_snapshot;
+	for (const GodotCollisionObject2D *E : objects) {
+		if (E->get_type() != GodotCollisionObject2D::TYPE_BODY) {
+			continue;
+		}
+		static_cast<const GodotBody2D *>(E)->get_snapshot(body_snapshot);
+		_snapshot_put_body(writer, body_snapshot);
+	}
+
+	GodotBodyPair2D::Snapshot pair_snapshot;
+	for (const SelfList<GodotBodyPair2D> *E = body_pair_list.first(); E; E = E->next()) {
+		E->self()->get_snapshot(pair_snapshot);
+		_snapshot_put_pair(writer, pair_snapshot);
+	}
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(writer.data.size());
+	memcpy(snapshot.ptrw(), writer.data.ptr(), writer.data.size());
+	return snapshot;
+}
+
+Error GodotSpace2D::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_COND_V_MSG(locked, ERR_LOCKED, "Can't restore a space snapshot while the space is being stepped.");
+
+	SpaceSnapshotReader2D reader;
+	reader.ptr = p_snapshot.ptr();
+	reader.end = reader.ptr + p_snapshot.size();
+
+	uint32_t magic = reader.get<uint32_t>();
+	uint32_t version = reader.get<uint32_t>();
+	uint32_t real_size = reader.get<uint32_t>();
+	uint32_t body_count = reader.get<uint32_t>();
+	uint32_t pair_count = reader.get<uint32_t>();
+
+	ERR_FAIL_COND_V_MSG(reader.error || magic != SPACE_SNAPSHOT_MAGIC, ERR_INVALID_DATA, "Invalid space snapshot.");
+	ERR_FAIL_COND_V_MSG(version != SPACE_SNAPSHOT_VERSION || real_size != sizeof(real_t), ERR_INVALID_DATA, "Space snapshot was created by an incompatible build.");
+
+	// Decode everything before touching the space, so a truncated snapshot leaves it unchanged.
+	LocalVector<GodotBody2D::Snapshot> body_snapshots;
+	body_snapshots.resize(MIN(body_count, (uint32_t)p_snapshot.size()));
+	for (uint32_t i = 0; i < body_snapshots.size(); i++) {
+		_snapshot_get_body(reader, body_snapshots[i]);
+	}
+
+	LocalVector<GodotBodyPair2D::Snapshot> pair_snapshots;
+	pair_snapshots.resize(MIN(pair_count, (uint32_t)p_snapshot.size()));
+	for (uint32_t i = 0; i < pair_snapshots.size(); i++) {
+		_snapshot_get_pair(reader, pair_snapshots[i]);
+	}
+
+	ERR_FAIL_COND_V(reader.error || reader.ptr != reader.end || body_snapshots.size() != body_count || pair_snapshots.size() != pair_count, ERR_INVALID_DATA);
+
+	HashMap<RID, GodotBody2D *> bodies;
+	for (GodotCollisionObject2D *E : objects) {
+		if (E->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			bodies.set(E->get_self(), static_cast<GodotBody2D *>(E));
+		}
+	}
+
+	// Bodies added after the snapshot was taken are left untouched, removed ones are skipped.
+	for (uint32_t i = 0; i < body_snapshots.size(); i++) {
+		GodotBody2D **body = bodies.getptr(body_snapshots[i].self);
+		if (body) {
+			(*body)->set_snapshot(body_snapshots[i]);
+		}
+	}
+
+	// Create and destroy pairs so they match the restored positions, then restore their contact caches.
+	broadphase->update();
+
+	HashMap<SpaceSnapshotPairKey2D, GodotBodyPair2D *, SpaceSnapshotPairKey2D> pairs;
+	for (SelfList<GodotBodyPair2D> *E = body_pair_list.first(); E; E = E->next()) {
+		GodotBodyPair2D *pair = E->self();
+		pair->clear_contacts();
+		pairs.set(SpaceSnapshotPairKey2D(pair->get_body_A()->get_self(), pair->get_shape_A(), pair->get_body_B()->get_self(), pair->get_shape_B()), pair);
+	}
+
+	for (uint32_t i = 0; i < pair_snapshots.size(); i++) {
+		const GodotBodyPair2D::Snapshot &pair_snapshot = pair_snapshots[i];
+		GodotBodyPair2D **pair = pairs.getptr(SpaceSnapshotPairKey2D(pair_snapshot.body_A, pair_snapshot.shape_A, pair_snapshot.body_B, pair_snapshot.shape_B));
+		if (pair) {
+			(*pair)->set_snapshot(pair_snapshot);
+		}
+	}
+
+	return OK;
+}
+
 void GodotSpace2D::lock() {
 	locked = true;
 }
@@ -88,6 +88,7 @@ private:
 	SelfList<GodotBody2D>::List state_query_list;
 	SelfList<GodotArea2D>::List monitor_query_list;
 	SelfList<GodotArea2D>::List area_moved_list;
+	SelfList<GodotBodyPair2D>::List body_pair_list;
 
 	static void *_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_data, void *p_self);
@@ -152,6 +153,9 @@ public:
 	void area_add_to_monitor_query_list(SelfList<GodotArea2D> *p_area);
 	void area_remove_from_monitor_query_list(SelfList<GodotArea2D> *p_area);
 
+	void body_pair_add_to_list(SelfList<GodotBodyPair2D> *p_pair);
+	void body_pair_remove_from_list(SelfList<GodotBodyPair2D> *p_pair);
+
 	GodotBroadPhase2D *get_broadphase();
 
 	void add_object(GodotCollisionObject2D *p_object);
@@ -192,6 +196,9 @@ public:
 
 	bool test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::MotionParameters &p_parameters, PhysicsServer2D::MotionResult *r_result);
 
+	Vector<uint8_t> create_snapshot() const;
+	Error restore_snapshot(const Vector<uint8_t> &p_snapshot);
+
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
 	_FORCE_INLINE_ bool is_debugging_contacts() const { return !contact_debug.is_empty(); }
 	_FORCE_INLINE_ void add_debug_contact(const Vector2 &p_contact) {
@@ -37,6 +37,29 @@
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+#define ACTIVE_BODY_COUNT_RESERVE 1024
+
+// Islands are solved in an order that only depends on what the constraints link, not on the order the broadphase created
+// the pairs in, so a space stepped again after restoring a snapshot gives exactly the same results.
+struct ConstraintSolveOrder2D {
+	_FORCE_INLINE_ bool operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const {
+		if (p_a->get_body_count() != p_b->get_body_count()) {
+			return p_a->get_body_count() < p_b->get_body_count();
+		}
+		for (int i = 0; i < p_a->get_body_count(); i++) {
+			uint64_t id_a = p_a->get_body_ptr()[i]->get_self().get_id();
+			uint64_t id_b = p_b->get_body_ptr()[i]->get_self().get_id();
+			if (id_a != id_b) {
+				return id_a < id_b;
+			}
+		}
+		return p_a->get_solve_order() < p_b->get_solve_order();
+	}
+};
+
+void GodotStep2D::_integrate_forces(uint32_t p_body_index, void *p_userdata) {
+	active_bodies[p_body_index]->integrate_forces(delta);
+}
 
 void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -77,6 +100,9 @@ void GodotStep2D::_setup_contraint(uint32_t p_constraint_index, void *p_userdata
 }
 
 void GodotStep2D::_pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const {
+	// Pre-solving applies the cached impulses, so it must already run in the solving order.
+	p_constraint_island.sort_custom<ConstraintSolveOrder2D>();
+
 	uint32_t constraint_count = p_constraint_island.size();
 	uint32_t valid_constraint_count = 0;
 	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
@@ -100,26 +126,33 @@ void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) const
 	}
 }
 
-void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) const {
+void GodotStep2D::_sleep_test_island(uint32_t p_island_index, void *p_userdata) {
+	const LocalVector<GodotBody2D *> &body_island = body_islands[p_island_index];
+
 	bool can_sleep = true;
 
-	uint32_t body_count = p_body_island.size();
+	uint32_t body_count = body_island.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
-		GodotBody2D *body = p_body_island[body_index];
+		GodotBody2D *body = body_island[body_index];
 
 		if (!body->sleep_test(delta)) {
 			can_sleep = false;
 		}
 	}
 
+	body_islands_can_sleep[p_island_index] = can_sleep;
+}
+
+void GodotStep2D::_check_suspend(const LocalVector<GodotBody2D *> &p_body_island, bool p_can_sleep) const {
 	// Put all to sleep or wake up everyone.
+	uint32_t body_count = p_body_island.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
 		GodotBody2D *body = p_body_island[body_index];
 
 		bool active = body->is_active();
 
-		if (active == can_sleep) {
-			body->set_active(!can_sleep);
+		if (active == p_can_sleep) {
+			body->set_active(!p_can_sleep);
 		}
 	}
 }
@@ -141,16 +174,21 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	uint64_t profile_begtime = OS::get_singleton()->get_ticks_usec();
 	uint64_t profile_endtime = 0;
 
-	int active_count = 0;
-
 	const SelfList<GodotBody2D> *b = body_list->first();
 	while (b) {
-		b->self()->integrate_forces(p_delta);
+		active_bodies.push_back(b->self());
 		b = b->next();
-		active_count++;
 	}
 
-	p_space->set_active_objects(active_count);
+	uint32_t active_count = active_bodies.size();
+	work_pool.do_work(active_count, this, &GodotStep2D::_integrate_forces, nullptr);
+
+	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
+	for (uint32_t body_index = 0; body_index < active_count; ++body_index) {
+		active_bodies[body_index]->update_motion_shapes();
+	}
+
+	p_space->set_active_objects((int)active_count);
 
 	// Update the broadphase to register collision pairs.
 	p_space->update();
@@ -277,8 +315,14 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
+	if (body_islands_can_sleep.size() < body_island_count) {
+		body_islands_can_sleep.resize(body_island_count);
+	}
+	work_pool.do_work(body_island_count, this, &GodotStep2D::_sleep_test_island, nullptr);
+
+	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
 	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
-		_check_suspend(body_islands[island_index]);
+		_check_suspend(body_islands[island_index], body_islands_can_sleep[island_index]);
 	}
 
 	{ //profile
@@ -287,6 +331,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 		//profile_begtime=profile_endtime;
 	}
 
+	active_bodies.clear();
 	all_constraints.clear();
 
 	p_space->unlock();
@@ -297,6 +342,7 @@ GodotStep2D::GodotStep2D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
+	active_bodies.reserve(ACTIVE_BODY_COUNT_RESERVE);
 
 	work_pool.init();
 }
@@ -44,15 +44,19 @@ class GodotStep2D {
 
 	ThreadWorkPool work_pool;
 
+	LocalVector<GodotBody2D *> active_bodies;
 	LocalVector<LocalVector<GodotBody2D *>> body_islands;
+	LocalVector<bool> body_islands_can_sleep;
 	LocalVector<LocalVector<GodotConstraint2D *>> constraint_islands;
 	LocalVector<GodotConstraint2D *> all_constraints;
 
+	void _integrate_forces(uint32_t p_body_index, void *p_userdata = nullptr);
 	void _populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island);
 	void _setup_contraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr) const;
-	void _check_suspend(LocalVector<GodotBody2D *> &p_body_island) const;
+	void _sleep_test_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _check_suspend(const LocalVector<GodotBody2D *> &p_body_island, bool p_can_sleep) const;
 
 public:
 	void step(GodotSpace2D *p_space, real_t p_delta);
@@ -46,6 +46,8 @@ class GodotAreaPair3D : public GodotConstraint3D {
 	bool has_space_override = false;
 
 public:
+	virtual uint64_t get_solve_order() const override { return area->get_self().get_id(); }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -85,6 +87,8 @@ class GodotAreaSoftBodyPair3D : public GodotConstraint3D {
 	bool has_space_override = false;
 
 public:
+	virtual uint64_t get_solve_order() const override { return area->get_self().get_id(); }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -187,6 +187,8 @@ void GodotBody3D::set_active(bool p_active) {
 	} else if (get_space()) {
 		get_space()->body_remove_from_active_list(&active_list);
 	}
+
+	publish_state();
 }
 
 void GodotBody3D::set_param(PhysicsServer3D::BodyParameter p_param, const Variant &p_value) {
@@ -413,6 +415,8 @@ void GodotBody3D::set_state(PhysicsServer3D::BodyState p_state, const Variant &p
 
 		} break;
 	}
+
+	publish_state();
 }
 
 Variant GodotBody3D::get_state(PhysicsServer3D::BodyState p_state) const {
@@ -792,6 +796,76 @@ bool GodotBody3D::sleep_test(real_t p_step) {
 	}
 }
 
+void GodotBody3D::get_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.self = get_self();
+	r_snapshot.transform = get_transform();
+	r_snapshot.inv_transform = get_inv_transform();
+	r_snapshot.new_transform = new_transform;
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.prev_linear_velocity = prev_linear_velocity;
+	r_snapshot.prev_angular_velocity = prev_angular_velocity;
+	r_snapshot.constant_linear_velocity = constant_linear_velocity;
+	r_snapshot.constant_angular_velocity = constant_angular_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+}
+
+void GodotBody3D::set_snapshot(const Snapshot &p_snapshot) {
+	// Moves the broadphase proxies too, pairs are refreshed by the space afterwards.
+	_set_transform(p_snapshot.transform);
+	// Stepping uses inverse() and setting the state affine_inverse(), so the inverse can't be computed again here.
+	_set_inv_transform(p_snapshot.inv_transform);
+	_update_transform_dependent();
+
+	new_transform = p_snapshot.new_transform;
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	prev_linear_velocity = p_snapshot.prev_linear_velocity;
+	prev_angular_velocity = p_snapshot.prev_angular_velocity;
+	constant_linear_velocity = p_snapshot.constant_linear_velocity;
+	constant_angular_velocity = p_snapshot.constant_angular_velocity;
+	applied_force = p_snapshot.applied_force;
+	applied_torque = p_snapshot.applied_torque;
+	biased_linear_velocity = Vector3();
+	biased_angular_velocity = Vector3();
+	still_time = p_snapshot.still_time;
+	set_active(p_snapshot.active);
+
+	publish_state();
+}
+
+void GodotBody3D::publish_state() {
+	uint32_t version = published_version.get() + 1;
+
+	// Don't let the writes to the buffer pass the publication of the previous version.
+	std::atomic_thread_fence(std::memory_order_release);
+
+	PublishedState &state = published_states[version & 1];
+	state.transform = get_transform();
+	state.linear_velocity = linear_velocity;
+	state.angular_velocity = angular_velocity;
+	state.sleeping = !active;
+	state.can_sleep = can_sleep;
+
+	published_version.set(version);
+}
+
+GodotBody3D::PublishedState GodotBody3D::get_published_state() const {
+	// The buffer being read is only written again after the next version is published,
+	// so the copy is consistent if the version didn't change in the meantime.
+	while (true) {
+		uint32_t version = published_version.get();
+		PublishedState state = published_states[version & 1];
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (published_version.get() == version) {
+			return state;
+		}
+	}
+}
+
 void GodotBody3D::set_state_sync_callback(void *p_instance, PhysicsServer3D::BodyStateCallback p_callback) {
 	body_state_callback_instance = p_instance;
 	body_state_callback = p_callback;
@@ -824,6 +898,7 @@ GodotBody3D::GodotBody3D() :
 		mass_properties_update_list(this),
 		direct_state_query_list(this) {
 	_set_static(false);
+	publish_state();
 }
 
 GodotBody3D::~GodotBody3D() {
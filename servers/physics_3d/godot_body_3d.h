@@ -34,6 +34,7 @@
 #include "godot_area_3d.h"
 #include "godot_collision_object_3d.h"
 
+#include "core/templates/safe_refcount.h"
 #include "core/templates/vset.h"
 
 class GodotConstraint3D;
@@ -145,11 +146,51 @@ class GodotBody3D : public GodotCollisionObject3D {
 
 	uint64_t island_step = 0;
 
+public:
+	// State of the body at the end of the last step, can be read from any thread.
+	struct PublishedState {
+		Transform3D transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		bool sleeping = false;
+		bool can_sleep = true;
+	};
+
+private:
+	// Double buffered: the version is incremented after writing the buffer that isn't being read.
+	PublishedState published_states[2];
+	SafeNumeric<uint32_t> published_version;
+
 	void _update_transform_dependent();
 
 	friend class GodotPhysicsDirectBodyState3D; // i give up, too many functions to expose
 
 public:
+	// Internal simulation state, saved field by field by GodotSpace3D snapshots.
+	struct Snapshot {
+		RID self;
+		Transform3D transform;
+		Transform3D inv_transform;
+		Transform3D new_transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		Vector3 constant_linear_velocity;
+		Vector3 constant_angular_velocity;
+		Vector3 applied_force;
+		Vector3 applied_torque;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void get_snapshot(Snapshot &r_snapshot) const;
+	void set_snapshot(const Snapshot &p_snapshot);
+
+	// Must only be called from the thread that steps the space.
+	void publish_state();
+	PublishedState get_published_state() const;
+
 	void set_state_sync_callback(void *p_instance, PhysicsServer3D::BodyStateCallback p_callback);
 	void set_force_integration_callback(const Callable &p_callable, const Variant &p_udata = Variant());
 
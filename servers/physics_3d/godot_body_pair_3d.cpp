@@ -182,9 +182,28 @@ bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A,
 
 	// Going too fast in that direction.
 
+	const GodotShape3D *shape_A_ptr = p_A->get_shape(p_shape_A);
+	const GodotShape3D *shape_B_ptr = p_B->get_shape(p_shape_B);
+	PhysicsServer3D::ShapeType type_A = shape_A_ptr->get_type();
+	PhysicsServer3D::ShapeType type_B = shape_B_ptr->get_type();
+
+	if (!shape_A_ptr->is_concave() && type_A != PhysicsServer3D::SHAPE_SEPARATION_RAY && type_B != PhysicsServer3D::SHAPE_WORLD_BOUNDARY && type_B != PhysicsServer3D::SHAPE_SEPARATION_RAY) {
+		// Sweep the whole shape along the motion, so it can't skip thin geometry that a single ray would miss.
+		real_t toi;
+		if (!GodotCollisionSolver3D::solve_time_of_impact(shape_A_ptr, p_xform_A, motion, shape_B_ptr, p_xform_B, (max - min) * 0.01, toi)) {
+			return false;
+		}
+
+		// Shorten the linear velocity so it stops at the time of impact,
+		// next frame will hit softly or soft enough.
+		p_A->set_linear_velocity((mnormal * mlen * toi) / p_step);
+
+		return true;
+	}
+
 	// Cast a segment from support in motion normal, in the same direction of motion by motion length.
 	// Support is the worst case collision point, so real collision happened before.
-	Vector3 s = p_A->get_shape(p_shape_A)->get_support(p_xform_A.basis.xform(mnormal).normalized());
+	Vector3 s = shape_A_ptr->get_support(p_xform_A.basis.xform(mnormal).normalized());
 	Vector3 from = p_xform_A.xform(s);
 	Vector3 to = from + motion;
 
@@ -195,7 +214,7 @@ bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A,
 	Vector3 local_to = from_inv.xform(to);
 
 	Vector3 rpos, rnorm;
-	if (!p_B->get_shape(p_shape_B)->intersect_segment(local_from, local_to, rpos, rnorm, true)) {
+	if (!shape_B_ptr->intersect_segment(local_from, local_to, rpos, rnorm, true)) {
 		return false;
 	}
 
@@ -545,8 +564,56 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+void GodotBodyPair3D::get_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.body_A = A->get_self();
+	r_snapshot.body_B = B->get_self();
+	r_snapshot.shape_A = shape_A;
+	r_snapshot.shape_B = shape_B;
+	r_snapshot.offset_B = offset_B;
+	r_snapshot.sep_axis = sep_axis;
+	for (int i = 0; i < contact_count; i++) {
+		r_snapshot.contacts[i] = contacts[i];
+	}
+	r_snapshot.contact_count = contact_count;
+	r_snapshot.collided = collided;
+}
+
+void GodotBodyPair3D::set_snapshot(const Snapshot &p_snapshot) {
+	contact_count = MIN(p_snapshot.contact_count, (int)MAX_CONTACTS);
+	collided = p_snapshot.collided;
+
+	// The broadphase may have paired the bodies in the opposite order after a restore.
+	if (p_snapshot.body_A == A->get_self()) {
+		offset_B = p_snapshot.offset_B;
+		sep_axis = p_snapshot.sep_axis;
+		for (int i = 0; i < contact_count; i++) {
+			contacts[i] = p_snapshot.contacts[i];
+		}
+		return;
+	}
+
+	offset_B = -p_snapshot.offset_B;
+	sep_axis = -p_snapshot.sep_axis;
+	for (int i = 0; i < contact_count; i++) {
+		Contact &c = contacts[i];
+		c = p_snapshot.contacts[i];
+		SWAP(c.index_A, c.index_B);
+		SWAP(c.local_A, c.local_B);
+		SWAP(c.rA, c.rB);
+		c.normal = -c.normal;
+		c.acc_tangent_impulse = -c.acc_tangent_impulse;
+	}
+}
+
+void GodotBodyPair3D::clear_contacts() {
+	contact_count = 0;
+	collided = false;
+	sep_axis = Vector3();
+}
+
 GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B) :
-		GodotBodyContact3D(_arr, 2) {
+		GodotBodyContact3D(_arr, 2),
+		pair_list(this) {
 	A = p_A;
 	B = p_B;
 	shape_A = p_shape_A;
@@ -554,9 +621,11 @@ GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p
 	space = A->get_space();
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
+	space->body_pair_add_to_list(&pair_list);
 }
 
 GodotBodyPair3D::~GodotBodyPair3D() {
+	space->body_pair_remove_from_list(&pair_list);
 	A->remove_constraint(this);
 	B->remove_constraint(this);
 }
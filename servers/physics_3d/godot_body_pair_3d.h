@@ -96,6 +96,8 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	SelfList<GodotBodyPair3D> pair_list;
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B);
@@ -104,6 +106,30 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
 
 public:
+	// Persistent contact cache (warm starting impulses), saved field by field by GodotSpace3D snapshots.
+	struct Snapshot {
+		RID body_A;
+		RID body_B;
+		int shape_A = 0;
+		int shape_B = 0;
+		Vector3 offset_B;
+		Vector3 sep_axis;
+		Contact contacts[MAX_CONTACTS];
+		int contact_count = 0;
+		bool collided = false;
+	};
+
+	_FORCE_INLINE_ GodotBody3D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody3D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
+	void get_snapshot(Snapshot &r_snapshot) const;
+	void set_snapshot(const Snapshot &p_snapshot);
+	void clear_contacts();
+
+	virtual uint64_t get_solve_order() const override { return ((uint64_t)shape_A << 32) | (uint32_t)shape_B; }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -139,6 +165,8 @@ public:
 	virtual GodotSoftBody3D *get_soft_body_ptr(int p_index) const override { return soft_body; }
 	virtual int get_soft_body_count() const override { return 1; }
 
+	virtual uint64_t get_solve_order() const override { return body_shape; }
+
 	GodotBodySoftBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotSoftBody3D *p_B);
 	~GodotBodySoftBodyPair3D();
 };
@@ -37,6 +37,8 @@
 #define collision_solver sat_calculate_penetration
 //#define collision_solver gjk_epa_calculate_penetration
 
+#define TOI_MAX_ITERATIONS 16
+
 bool GodotCollisionSolver3D::solve_static_world_boundary(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, CallbackResult p_result_callback, void *p_userdata, bool p_swap_result) {
 	const GodotWorldBoundaryShape3D *world_boundary = static_cast<const GodotWorldBoundaryShape3D *>(p_shape_A);
 	if (p_shape_B->get_type() == PhysicsServer3D::SHAPE_WORLD_BOUNDARY) {
@@ -570,3 +572,109 @@ bool GodotCollisionSolver3D::solve_distance(const GodotShape3D *p_shape_A, const
 		return gjk_epa_calculate_distance(p_shape_A, p_transform_A, p_shape_B, p_transform_B, r_point_A, r_point_B); //should pass sepaxis..
 	}
 }
+
+bool GodotCollisionSolver3D::solve_time_of_impact_convex(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t p_max_toi, real_t &r_toi) {
+	// Conservative advancement: with a linear motion the distance between two convex shapes is a convex function of time,
+	// so it can't reach zero before the time at which the current distance would be closed along the current separation axis.
+	real_t toi = 0.0;
+	for (int i = 0; i < TOI_MAX_ITERATIONS; i++) {
+		Transform3D transform_A = p_transform_A;
+		transform_A.origin += p_motion * toi;
+
+		Vector3 close_A, close_B;
+		if (!gjk_epa_calculate_distance(p_shape_A, transform_A, p_shape_B, p_transform_B, close_A, close_B)) {
+			if (i == 0) {
+				// Already overlapping, this is a regular contact.
+				return false;
+			}
+			r_toi = toi;
+			return true;
+		}
+
+		Vector3 separation = close_B - close_A;
+		real_t distance = separation.length();
+		if (distance <= p_tolerance) {
+			r_toi = toi;
+			return true;
+		}
+
+		real_t approach = p_motion.dot(separation / distance);
+		if (approach <= CMP_EPSILON) {
+			// Moving away, the distance can only grow from now on.
+			return false;
+		}
+
+		// Stop half the tolerance short of touching, so the result never puts the shapes in contact.
+		toi += (distance - p_tolerance * 0.5) / approach;
+		if (toi > p_max_toi) {
+			return false;
+		}
+	}
+
+	// Not converged within the iteration budget, but the motion is safe up to here.
+	r_toi = toi;
+	return true;
+}
+
+struct _ConcaveTimeOfImpactInfo {
+	const GodotShape3D *shape_A = nullptr;
+	const Transform3D *transform_A = nullptr;
+	const Transform3D *transform_B = nullptr;
+	Vector3 motion;
+	Vector3 local_motion;
+	real_t tolerance = 0.0;
+	real_t toi = 1.0;
+	bool collided = false;
+};
+
+bool GodotCollisionSolver3D::concave_time_of_impact_callback(void *p_userdata, GodotShape3D *p_convex) {
+	_ConcaveTimeOfImpactInfo &tinfo = *(_ConcaveTimeOfImpactInfo *)(p_userdata);
+
+	const GodotFaceShape3D *face = static_cast<const GodotFaceShape3D *>(p_convex);
+	if (!face->backface_collision && tinfo.local_motion.dot(face->normal) > 0) {
+		// Can't hit the front side of this face.
+		return false;
+	}
+
+	// Only look for impacts earlier than the ones found so far.
+	real_t toi;
+	if (solve_time_of_impact_convex(tinfo.shape_A, *tinfo.transform_A, tinfo.motion, p_convex, *tinfo.transform_B, tinfo.tolerance, tinfo.toi, toi)) {
+		tinfo.toi = toi;
+		tinfo.collided = true;
+	}
+
+	return false;
+}
+
+bool GodotCollisionSolver3D::solve_time_of_impact(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi) {
+	ERR_FAIL_COND_V(p_shape_A->is_concave(), false);
+
+	if (!p_shape_B->is_concave()) {
+		return solve_time_of_impact_convex(p_shape_A, p_transform_A, p_motion, p_shape_B, p_transform_B, p_tolerance, 1.0, r_toi);
+	}
+
+	const GodotConcaveShape3D *concave_B = static_cast<const GodotConcaveShape3D *>(p_shape_B);
+
+	_ConcaveTimeOfImpactInfo tinfo;
+	tinfo.shape_A = p_shape_A;
+	tinfo.transform_A = &p_transform_A;
+	tinfo.transform_B = &p_transform_B;
+	tinfo.motion = p_motion;
+	tinfo.tolerance = p_tolerance;
+
+	Transform3D inv_transform_B = p_transform_B.affine_inverse();
+	tinfo.local_motion = inv_transform_B.basis.xform(p_motion);
+
+	// Cull the faces touched by the whole sweep.
+	AABB sweep_aabb = p_transform_A.xform(p_shape_A->get_aabb());
+	sweep_aabb.merge_with(AABB(sweep_aabb.position + p_motion, sweep_aabb.size));
+	AABB local_aabb = inv_transform_B.xform(sweep_aabb.grow(p_tolerance));
+
+	concave_B->cull(local_aabb, concave_time_of_impact_callback, &tinfo, false);
+
+	if (tinfo.collided) {
+		r_toi = tinfo.toi;
+	}
+
+	return tinfo.collided;
+}
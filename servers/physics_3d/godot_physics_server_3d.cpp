@@ -114,6 +114,14 @@ void GodotPhysicsServer3D::shape_set_custom_solver_bias(RID p_shape, real_t p_bi
 	shape->set_custom_bias(p_bias);
 }
 
+void GodotPhysicsServer3D::heightmap_shape_update_region(RID p_shape, const Rect2i &p_region, const Vector<real_t> &p_heights) {
+	GodotShape3D *shape = shape_owner.get_or_null(p_shape);
+	ERR_FAIL_COND(!shape);
+	ERR_FAIL_COND(shape->get_type() != SHAPE_HEIGHTMAP);
+	GodotHeightMapShape3D *heightmap_shape = static_cast<GodotHeightMapShape3D *>(shape);
+	heightmap_shape->set_region(p_region, p_heights);
+}
+
 PhysicsServer3D::ShapeType GodotPhysicsServer3D::shape_get_type(RID p_shape) const {
 	const GodotShape3D *shape = shape_owner.get_or_null(p_shape);
 	ERR_FAIL_COND_V(!shape, SHAPE_CUSTOM);
@@ -214,6 +222,19 @@ int GodotPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> GodotPhysicsServer3D::space_create_snapshot(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+	ERR_FAIL_COND_V_MSG(space->is_locked(), Vector<uint8_t>(), "Can't create a space snapshot while the space is being stepped.");
+	return space->create_snapshot();
+}
+
+void GodotPhysicsServer3D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND(!space);
+	space->restore_snapshot(p_snapshot);
+}
+
 RID GodotPhysicsServer3D::area_create() {
 	GodotArea3D *area = memnew(GodotArea3D);
 	RID rid = area_owner.make_rid(area);
@@ -663,6 +684,33 @@ Variant GodotPhysicsServer3D::body_get_state(RID p_body, BodyState p_state) cons
 	return body->get_state(p_state);
 }
 
+Variant GodotPhysicsServer3D::body_get_published_state(RID p_body, BodyState p_state) const {
+	// Doesn't check for the space being locked or synced, the published state is safe to read at any time.
+	GodotBody3D *body = body_owner.get_or_null(p_body);
+	ERR_FAIL_COND_V(!body, Variant());
+
+	GodotBody3D::PublishedState state = body->get_published_state();
+	switch (p_state) {
+		case BODY_STATE_TRANSFORM: {
+			return state.transform;
+		} break;
+		case BODY_STATE_LINEAR_VELOCITY: {
+			return state.linear_velocity;
+		} break;
+		case BODY_STATE_ANGULAR_VELOCITY: {
+			return state.angular_velocity;
+		} break;
+		case BODY_STATE_SLEEPING: {
+			return state.sleeping;
+		} break;
+		case BODY_STATE_CAN_SLEEP: {
+			return state.can_sleep;
+		} break;
+	}
+
+	return Variant();
+}
+
 void GodotPhysicsServer3D::body_apply_central_impulse(RID p_body, const Vector3 &p_impulse) {
 	GodotBody3D *body = body_owner.get_or_null(p_body);
 	ERR_FAIL_COND(!body);
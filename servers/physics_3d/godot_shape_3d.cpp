@@ -1281,40 +1281,33 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
-
-	if (!bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
+void GodotConcavePolygonShape3D::BVH::quantize(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max) const {
+	for (int i = 0; i < 3; i++) {
+		real_t min = CLAMP((p_aabb.position[i] - origin[i]) * inv_scale[i], (real_t)0.0, (real_t)BVH_QUANTIZE_MAX);
+		real_t max = CLAMP((p_aabb.position[i] + p_aabb.size[i] - origin[i]) * inv_scale[i], (real_t)0.0, (real_t)BVH_QUANTIZE_MAX);
+		// Both values are positive, so truncation floors them.
+		r_min[i] = (uint16_t)min;
+		r_max[i] = (uint16_t)max;
+		r_max[i] += (real_t)r_max[i] < max;
 	}
+}
 
-	if (bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal, true)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->collisions++;
-			}
-		}
-	} else {
-		if (bvh->left >= 0) {
-			_cull_segment(bvh->left, p_params);
-		}
-		if (bvh->right >= 0) {
-			_cull_segment(bvh->right, p_params);
-		}
+uint32_t GodotConcavePolygonShape3D::BVH::overlap_mask(const uint16_t *p_min, const uint16_t *p_max) const {
+	// Branchless so the compiler can test all children at once.
+	uint32_t mask = 0;
+	for (int i = 0; i < BVH_WIDTH; i++) {
+		uint32_t overlap = (min_x[i] <= p_max[0]) & (max_x[i] >= p_min[0]) &
+				(min_y[i] <= p_max[1]) & (max_y[i] >= p_min[1]) &
+				(min_z[i] <= p_max[2]) & (max_z[i] >= p_min[2]);
+		mask |= overlap << i;
 	}
+	return mask;
+}
+
+AABB GodotConcavePolygonShape3D::BVH::get_child_aabb(int p_child) const {
+	Vector3 min = origin + Vector3(min_x[p_child], min_y[p_child], min_z[p_child]) * scale;
+	Vector3 max = origin + Vector3(max_x[p_child], max_y[p_child], max_z[p_child]) * scale;
+	return AABB(min, max - min);
 }
 
 bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, bool p_hit_back_faces) const {
@@ -1322,7 +1315,12 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 		return false;
 	}
 
-	// unlock data
+	AABB segment_aabb(p_begin, Vector3());
+	segment_aabb.expand_to(p_end);
+	if (!get_aabb().intersects_inclusive(segment_aabb)) {
+		return false;
+	}
+
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
 	const BVH *br = bvh.ptr();
@@ -1330,27 +1328,59 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 	GodotFaceShape3D face;
 	face.backface_collision = backface_collision && p_hit_back_faces;
 
-	_SegmentCullParams params;
-	params.from = p_begin;
-	params.to = p_end;
-	params.dir = (p_end - p_begin).normalized();
+	Vector3 dir = (p_end - p_begin).normalized();
+	real_t min_d = 1e20;
+	int collisions = 0;
 
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	uint32_t stack[BVH_STACK_SIZE];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
 
-	params.face = &face;
+	while (stack_size) {
+		const BVH &node = br[stack[--stack_size]];
 
-	// cull
-	_cull_segment(0, &params);
+		uint16_t qmin[3], qmax[3];
+		node.quantize(segment_aabb, qmin, qmax);
+		uint32_t mask = node.overlap_mask(qmin, qmax);
 
-	if (params.collisions > 0) {
-		r_result = params.result;
-		r_normal = params.normal;
-		return true;
-	} else {
-		return false;
+		for (int i = 0; i < BVH_WIDTH && mask; i++, mask >>= 1) {
+			uint32_t child = node.children[i];
+			if (child == BVH_EMPTY) {
+				break;
+			}
+			if (!(mask & 1)) {
+				continue;
+			}
+
+			if (!(child & BVH_LEAF)) {
+				if (node.get_child_aabb(i).intersects_segment(p_begin, p_end)) {
+					ERR_FAIL_COND_V(stack_size >= BVH_STACK_SIZE, false);
+					stack[stack_size++] = child;
+				}
+				continue;
+			}
+
+			const Face *f = &fr[child & ~BVH_LEAF];
+			face.normal = f->normal;
+			face.vertex[0] = vr[f->indices[0]];
+			face.vertex[1] = vr[f->indices[1]];
+			face.vertex[2] = vr[f->indices[2]];
+
+			Vector3 res;
+			Vector3 normal;
+			if (face.intersect_segment(p_begin, p_end, res, normal, true)) {
+				real_t d = dir.dot(res) - dir.dot(p_begin);
+				if ((d > 0) && (d < min_d)) {
+					min_d = d;
+					r_result = res;
+					r_normal = normal;
+					collisions++;
+				}
+			}
+		}
 	}
+
+	return collisions > 0;
 }
 
 bool GodotConcavePolygonShape3D::intersect_point(const Vector3 &p_point) const {
@@ -1361,49 +1391,16 @@ Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point)
 	return Vector3();
 }
 
-bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
-
-	if (!p_params->aabb.intersects(bvh->aabb)) {
-		return false;
-	}
-
-	if (bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		if (p_params->callback(p_params->userdata, face)) {
-			return true;
-		}
-	} else {
-		if (bvh->left >= 0) {
-			if (_cull(bvh->left, p_params)) {
-				return true;
-			}
-		}
-
-		if (bvh->right >= 0) {
-			if (_cull(bvh->right, p_params)) {
-				return true;
-			}
-		}
-	}
-
-	return false;
-}
-
 void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
 	// make matrix local to concave
 	if (faces.size() == 0) {
 		return;
 	}
 
-	AABB local_aabb = p_local_aabb;
+	if (!get_aabb().intersects(p_local_aabb)) {
+		return;
+	}
 
-	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
 	const BVH *br = bvh.ptr();
@@ -1412,17 +1409,45 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 	face.backface_collision = backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
-	_CullParams params;
-	params.aabb = local_aabb;
-	params.face = &face;
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
-	params.callback = p_callback;
-	params.userdata = p_userdata;
+	uint32_t stack[BVH_STACK_SIZE];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
 
-	// cull
-	_cull(0, &params);
+	while (stack_size) {
+		const BVH &node = br[stack[--stack_size]];
+
+		uint16_t qmin[3], qmax[3];
+		node.quantize(p_local_aabb, qmin, qmax);
+		uint32_t mask = node.overlap_mask(qmin, qmax);
+
+		for (int i = 0; i < BVH_WIDTH && mask; i++, mask >>= 1) {
+			uint32_t child = node.children[i];
+			if (child == BVH_EMPTY) {
+				break;
+			}
+			if (!(mask & 1)) {
+				continue;
+			}
+
+			if (!(child & BVH_LEAF)) {
+				ERR_FAIL_COND(stack_size >= BVH_STACK_SIZE);
+				stack[stack_size++] = child;
+				continue;
+			}
+
+			const Face *f = &fr[child & ~BVH_LEAF];
+			face.normal = f->normal;
+			face.vertex[0] = vr[f->indices[0]];
+			face.vertex[1] = vr[f->indices[1]];
+			face.vertex[2] = vr[f->indices[2]];
+
+			// Quantized bounds are conservative, so faces within a step of the query can be reported too.
+			// The narrow phase rejects them, testing their exact bounds here stalls on the vertex loads.
+			if (p_callback(p_userdata, &face)) {
+				return;
+			}
+		}
+	}
 }
 
 Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -1459,92 +1484,257 @@ struct _Volume_BVH_CompareZ {
 	}
 };
 
-struct _Volume_BVH {
+struct _Volume_BVH_Range {
+	_Volume_BVH_Element *elements = nullptr;
+	int count = 0;
 	AABB aabb;
-	_Volume_BVH *left;
-	_Volume_BVH *right;
-
-	int face_index;
 };
 
-_Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int &count) {
-	_Volume_BVH *bvh = memnew(_Volume_BVH);
-
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
-	}
+static _FORCE_INLINE_ real_t _volume_bvh_surface_area(const AABB &p_aabb) {
+	return 2.0 * (p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x);
+}
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
-		}
+static AABB _volume_bvh_get_aabb(const _Volume_BVH_Element *p_elements, int p_count) {
+	AABB aabb = p_elements[0].aabb;
+	for (int i = 1; i < p_count; i++) {
+		aabb.merge_with(p_elements[i].aabb);
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
+	return aabb;
+}
+
+static int _volume_bvh_median_split(_Volume_BVH_Element *p_elements, int p_count, int p_axis) {
+	int split = p_count / 2;
+	switch (p_axis) {
 		case 0: {
 			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
-
+			sort_x.nth_element(0, p_count, split, p_elements);
 		} break;
 		case 1: {
 			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
+			sort_y.nth_element(0, p_count, split, p_elements);
 		} break;
 		case 2: {
 			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
+			sort_z.nth_element(0, p_count, split, p_elements);
 		} break;
 	}
+	return split;
+}
+
+// Binned surface area heuristic split, returns the amount of elements moved to the first half.
+static int _volume_bvh_split(_Volume_BVH_Element *p_elements, int p_count, bool p_use_sah) {
+	const int BIN_COUNT = 16;
+
+	AABB center_aabb(p_elements[0].center, Vector3());
+	for (int i = 1; i < p_count; i++) {
+		center_aabb.expand_to(p_elements[i].center);
+	}
+
+	const Vector3 &center_min = center_aabb.position;
+	const Vector3 &center_extent = center_aabb.size;
+	int axis = center_extent.max_axis_index();
+	if (center_extent[axis] <= 0) {
+		// All centers are the same, any split is as good as another.
+		return p_count / 2;
+	}
+
+	if (!p_use_sah) {
+		return _volume_bvh_median_split(p_elements, p_count, axis);
+	}
+
+	AABB bin_aabb[BIN_COUNT];
+	int bin_count[BIN_COUNT] = {};
+	real_t bin_scale = BIN_COUNT * 0.999 / center_extent[axis];
+
+	for (int i = 0; i < p_count; i++) {
+		int bin = MIN(int((p_elements[i].center[axis] - center_min[axis]) * bin_scale), BIN_COUNT - 1);
+		if (bin_count[bin] == 0) {
+			bin_aabb[bin] = p_elements[i].aabb;
+		} else {
+			bin_aabb[bin].merge_with(p_elements[i].aabb);
+		}
+		bin_count[bin]++;
+	}
+
+	// Sweep from the right to know the cost of every possible right side.
+	real_t right_area[BIN_COUNT];
+	int right_count[BIN_COUNT];
+	{
+		AABB aabb;
+		int count = 0;
+		for (int i = BIN_COUNT - 1; i > 0; i--) {
+			if (bin_count[i]) {
+				if (count == 0) {
+					aabb = bin_aabb[i];
+				} else {
+					aabb.merge_with(bin_aabb[i]);
+				}
+				count += bin_count[i];
+			}
+			right_area[i] = count ? _volume_bvh_surface_area(aabb) : 0.0;
+			right_count[i] = count;
+		}
+	}
+
+	int best_bin = -1;
+	real_t best_cost = 1e20;
+	{
+		AABB aabb;
+		int count = 0;
+		for (int i = 0; i < BIN_COUNT - 1; i++) {
+			if (bin_count[i]) {
+				if (count == 0) {
+					aabb = bin_aabb[i];
+				} else {
+					aabb.merge_with(bin_aabb[i]);
+				}
+				count += bin_count[i];
+			}
+			if (count == 0 || right_count[i + 1] == 0) {
+				continue;
+			}
+			real_t cost = count * _volume_bvh_surface_area(aabb) + right_count[i + 1] * right_area[i + 1];
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_bin = i;
+			}
+		}
+	}
 
-	int split = p_size / 2;
-	bvh->left = _volume_build_bvh(p_elements, split, count);
-	bvh->right = _volume_build_bvh(&p_elements[split], p_size - split, count);
+	if (best_bin == -1) {
+		return _volume_bvh_median_split(p_elements, p_count, axis);
+	}
+
+	int split = 0;
+	for (int i = 0; i < p_count; i++) {
+		int bin = MIN(int((p_elements[i].center[axis] - center_min[axis]) * bin_scale), BIN_COUNT - 1);
+		if (bin <= best_bin) {
+			SWAP(p_elements[i], p_elements[split]);
+			split++;
+		}
+	}
 
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
+	return split;
 }
 
-void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
+// Splits a range in up to BVH_WIDTH children. Children with more elements than fit in a node are split first (largest
+// area first), then small children are expanded into leaves while there are free slots, so nodes stay as full as possible.
+static int _volume_bvh_collect_children(const _Volume_BVH_Range &p_range, int p_depth, _Volume_BVH_Range *r_children) {
+	const int width = GodotConcavePolygonShape3D::BVH_WIDTH;
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+	int child_count = 1;
+	r_children[0] = p_range;
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+	bool use_sah = p_depth < GodotConcavePolygonShape3D::BVH_SAH_MAX_DEPTH;
 
-	} else {
-		p_bvh_array[p_idx].left = -1;
+	while (child_count < width) {
+		int best = -1;
+		real_t best_area = -1.0;
+		for (int i = 0; i < child_count; i++) {
+			if (r_children[i].count > width && _volume_bvh_surface_area(r_children[i].aabb) > best_area) {
+				best = i;
+				best_area = _volume_bvh_surface_area(r_children[i].aabb);
+			}
+		}
+
+		if (best == -1) {
+			break;
+		}
+
+		_Volume_BVH_Range range = r_children[best];
+		int split = _volume_bvh_split(range.elements, range.count, use_sah);
+
+		r_children[best].count = split;
+		r_children[best].aabb = _volume_bvh_get_aabb(range.elements, split);
+
+		r_children[child_count].elements = range.elements + split;
+		r_children[child_count].count = range.count - split;
+		r_children[child_count].aabb = _volume_bvh_get_aabb(range.elements + split, range.count - split);
+		child_count++;
 	}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+	while (child_count < width) {
+		int best = -1;
+		real_t best_area = -1.0;
+		for (int i = 0; i < child_count; i++) {
+			if (r_children[i].count > 1 && r_children[i].count <= width - child_count + 1 && _volume_bvh_surface_area(r_children[i].aabb) > best_area) {
+				best = i;
+				best_area = _volume_bvh_surface_area(r_children[i].aabb);
+			}
+		}
 
-	} else {
-		p_bvh_array[p_idx].right = -1;
+		if (best == -1) {
+			break;
+		}
+
+		_Volume_BVH_Range range = r_children[best];
+		for (int i = 0; i < range.count; i++) {
+			int child = i == 0 ? best : child_count++;
+			r_children[child].elements = range.elements + i;
+			r_children[child].count = 1;
+			r_children[child].aabb = range.elements[i].aabb;
+		}
 	}
 
-	memdelete(p_bvh_tree);
+	return child_count;
+}
+
+static void _volume_bvh_setup_node(GodotConcavePolygonShape3D::BVH &r_node, const AABB &p_aabb, const _Volume_BVH_Range *p_children, int p_child_count) {
+	r_node.origin = p_aabb.position;
+	r_node.scale = p_aabb.size / real_t(GodotConcavePolygonShape3D::BVH_QUANTIZE_MAX);
+	for (int i = 0; i < 3; i++) {
+		r_node.inv_scale[i] = r_node.scale[i] > 0 ? 1.0 / r_node.scale[i] : 0.0;
+	}
+
+	for (int i = 0; i < GodotConcavePolygonShape3D::BVH_WIDTH; i++) {
+		if (i >= p_child_count) {
+			r_node.min_x[i] = r_node.min_y[i] = r_node.min_z[i] = GodotConcavePolygonShape3D::BVH_QUANTIZE_MAX;
+			r_node.max_x[i] = r_node.max_y[i] = r_node.max_z[i] = 0;
+			r_node.children[i] = GodotConcavePolygonShape3D::BVH_EMPTY;
+			continue;
+		}
+
+		uint16_t qmin[3], qmax[3];
+		r_node.quantize(p_children[i].aabb, qmin, qmax);
+
+		// Grow by one step to absorb rounding errors when dequantizing.
+		r_node.min_x[i] = qmin[0] > 0 ? qmin[0] - 1 : 0;
+		r_node.min_y[i] = qmin[1] > 0 ? qmin[1] - 1 : 0;
+		r_node.min_z[i] = qmin[2] > 0 ? qmin[2] - 1 : 0;
+		r_node.max_x[i] = qmax[0] < GodotConcavePolygonShape3D::BVH_QUANTIZE_MAX ? qmax[0] + 1 : qmax[0];
+		r_node.max_y[i] = qmax[1] < GodotConcavePolygonShape3D::BVH_QUANTIZE_MAX ? qmax[1] + 1 : qmax[1];
+		r_node.max_z[i] = qmax[2] < GodotConcavePolygonShape3D::BVH_QUANTIZE_MAX ? qmax[2] + 1 : qmax[2];
+	}
+}
+
+static uint32_t _volume_bvh_build(LocalVector<GodotConcavePolygonShape3D::BVH> &r_nodes, const _Volume_BVH_Range &p_range, int p_depth) {
+	uint32_t index = r_nodes.size();
+	r_nodes.resize(index + 1);
+
+	_Volume_BVH_Range children[GodotConcavePolygonShape3D::BVH_WIDTH];
+	int child_count = _volume_bvh_collect_children(p_range, p_depth, children);
+
+	GodotConcavePolygonShape3D::BVH node;
+	_volume_bvh_setup_node(node, p_range.aabb, children, child_count);
+
+	for (int i = 0; i < child_count; i++) {
+		if (children[i].count == 1) {
+			node.children[i] = GodotConcavePolygonShape3D::BVH_LEAF | uint32_t(children[i].elements->face_index);
+		} else {
+			node.children[i] = _volume_bvh_build(r_nodes, children[i], p_depth + 1);
+		}
+	}
+
+	r_nodes[index] = node;
+	return index;
 }
 
 void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
+		faces.clear();
+		vertices.clear();
+		bvh.clear();
 		configure(AABB());
 		return;
 	}
@@ -1587,15 +1777,16 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 		}
 	}
 
-	int count = 0;
-	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
-
-	bvh.resize(count + 1);
+	_Volume_BVH_Range root;
+	root.elements = bvh_arrayw;
+	root.count = src_face_count;
+	root.aabb = _aabb;
 
-	BVH *bvh_arrayw2 = bvh.ptrw();
+	bvh.clear();
+	// A four-wide tree with one face per leaf has roughly a third as many nodes as faces.
+	bvh.reserve(src_face_count / 3 + 1);
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	_volume_bvh_build(bvh, root, 0);
 
 	backface_collision = p_backface_collision;
 
@@ -1654,6 +1845,8 @@ struct _HeightmapSegmentCullParams {
 
 	const GodotHeightMapShape3D *heightmap = nullptr;
 	GodotFaceShape3D *face = nullptr;
+
+	int level = 0; // Bounds level processed by _heightmap_chunk_cull_segment.
 };
 
 struct _HeightmapGridCullState {
@@ -1701,7 +1894,8 @@ _FORCE_INLINE_ bool _heightmap_cell_cull_segment(_HeightmapSegmentCullParams &p_
 }
 
 _FORCE_INLINE_ bool _heightmap_chunk_cull_segment(_HeightmapSegmentCullParams &p_params, const _HeightmapGridCullState &p_state) {
-	const GodotHeightMapShape3D::Range &chunk = p_params.heightmap->_get_bounds_chunk(p_state.x, p_state.z);
+	const GodotHeightMapShape3D *heightmap = p_params.heightmap;
+	const GodotHeightMapShape3D::Range &chunk = heightmap->_get_bounds_chunk(p_params.level, p_state.x, p_state.z);
 
 	Vector3 enter_pos;
 	Vector3 exit_pos;
@@ -1719,24 +1913,33 @@ _FORCE_INLINE_ bool _heightmap_chunk_cull_segment(_HeightmapSegmentCullParams &p
 		exit_pos = p_params.to;
 	}
 
-	// Transform positions to heightmap space.
-	enter_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
-	exit_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
-
 	// We did enter the flat projection of the AABB,
 	// but we have to check if we intersect it on the vertical axis.
-	if ((enter_pos.y > chunk.max) && (exit_pos.y > chunk.max)) {
+	real_t chunk_size = GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE << p_params.level;
+	if ((enter_pos.y * chunk_size > chunk.max) && (exit_pos.y * chunk_size > chunk.max)) {
 		return false;
 	}
-	if ((enter_pos.y < chunk.min) && (exit_pos.y < chunk.min)) {
+	if ((enter_pos.y * chunk_size < chunk.min) && (exit_pos.y * chunk_size < chunk.min)) {
 		return false;
 	}
 
-	return p_params.heightmap->_intersect_grid_segment(_heightmap_cell_cull_segment, enter_pos, exit_pos, p_params.heightmap->width, p_params.heightmap->depth, p_params.heightmap->local_origin, p_params.result, p_params.normal);
+	if (p_params.level > 0) {
+		// Descend into the 2x2 ranges covered by this one.
+		int child_level = p_params.level - 1;
+		const GodotHeightMapShape3D::BoundsLevel &child = heightmap->bounds_levels[child_level];
+		Vector3 child_offset = heightmap->local_origin / real_t(GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE << child_level);
+		return heightmap->_intersect_grid_segment(_heightmap_chunk_cull_segment, enter_pos * 2.0, exit_pos * 2.0, child.width + 1, child.depth + 1, child_offset, p_params.result, p_params.normal, child_level);
+	}
+
+	// Transform positions to heightmap space.
+	enter_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
+	exit_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
+
+	return heightmap->_intersect_grid_segment(_heightmap_cell_cull_segment, enter_pos, exit_pos, heightmap->width, heightmap->depth, heightmap->local_origin, p_params.result, p_params.normal);
 }
 
 template <typename ProcessFunction>
-bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal) const {
+bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal, int p_level) const {
 	Vector3 delta = (p_end - p_begin);
 	real_t length = delta.length();
 
@@ -1755,6 +1958,7 @@ bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process,
 	params.dir = delta / length;
 	params.heightmap = this;
 	params.face = &face;
+	params.level = p_level;
 
 	_HeightmapGridCullState state;
 
@@ -1805,9 +2009,11 @@ bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process,
 	int z = Math::floor(local_begin.z);
 
 	// Workaround cases where the ray starts at an integer position.
+	// The position can be slightly below the lane, so start from the lane itself rather than from the floored value.
 	if (Math::is_zero_approx(cross_x)) {
 		cross_x += delta_x;
-		// If going backwards, we should ignore the position we would get by the above flooring,
+		x = Math::round(local_begin.x);
+		// If going backwards, we should ignore the position we would get by the above rounding,
 		// because the ray is not heading in that direction.
 		if (x_step == -1) {
 			x -= 1;
@@ -1816,6 +2022,7 @@ bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process,
 
 	if (Math::is_zero_approx(cross_z)) {
 		cross_z += delta_z;
+		z = Math::round(local_begin.z);
 		if (z_step == -1) {
 			z -= 1;
 		}
@@ -1912,7 +2119,7 @@ bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vect
 			r_normal = params.normal;
 			return true;
 		}
-	} else if (bounds_grid.is_empty()) {
+	} else if (bounds_levels.is_empty()) {
 		// Process all cells intersecting the flat projection of the ray.
 		return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin, p_end, width, depth, local_origin, r_point, r_normal);
 	} else {
@@ -1922,11 +2129,23 @@ bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vect
 			// Don't use chunks, the ray is too short in the plane.
 			return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin, p_end, width, depth, local_origin, r_point, r_normal);
 		} else {
-			// The ray is long, run raycast on a higher-level grid.
-			Vector3 bounds_from = p_begin / BOUNDS_CHUNK_SIZE;
-			Vector3 bounds_to = p_end / BOUNDS_CHUNK_SIZE;
-			Vector3 bounds_offset = local_origin / BOUNDS_CHUNK_SIZE;
-			return _intersect_grid_segment(_heightmap_chunk_cull_segment, bounds_from, bounds_to, bounds_grid_width, bounds_grid_depth, bounds_offset, r_point, r_normal);
+			// The ray is long, run raycast on the coarsest level whose chunks are not longer than the ray,
+			// and refine only where the height ranges are crossed.
+			int level = 0;
+			while (level + 1 < (int)bounds_levels.size()) {
+				real_t next_chunk_size = BOUNDS_CHUNK_SIZE << (level + 1);
+				if (next_chunk_size * next_chunk_size > length_flat_sqr) {
+					break;
+				}
+				level++;
+			}
+
+			real_t chunk_size = BOUNDS_CHUNK_SIZE << level;
+			Vector3 bounds_from = p_begin / chunk_size;
+			Vector3 bounds_to = p_end / chunk_size;
+			Vector3 bounds_offset = local_origin / chunk_size;
+			const BoundsLevel &bounds = bounds_levels[level];
+			return _intersect_grid_segment(_heightmap_chunk_cull_segment, bounds_from, bounds_to, bounds.width + 1, bounds.depth + 1, bounds_offset, r_point, r_normal, level);
 		}
 	}
 
@@ -1986,26 +2205,56 @@ void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callb
 	face.backface_collision = !p_invert_backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
-	for (int z = start_z; z < end_z; z++) {
-		for (int x = start_x; x < end_x; x++) {
-			// First triangle.
-			_get_point(x, z, face.vertex[0]);
-			_get_point(x + 1, z, face.vertex[1]);
-			_get_point(x, z + 1, face.vertex[2]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
+	if (bounds_levels.is_empty()) {
+		_cull_cells(start_x, start_z, end_x, end_z, face, p_callback, p_userdata);
+		return;
+	}
+
+	// Skip the chunks whose height range is entirely above or below the aabb.
+	real_t min_y = p_local_aabb.position.y;
+	real_t max_y = p_local_aabb.position.y + p_local_aabb.size.y;
+
+	for (int cz = start_z / BOUNDS_CHUNK_SIZE; cz * BOUNDS_CHUNK_SIZE < end_z; cz++) {
+		for (int cx = start_x / BOUNDS_CHUNK_SIZE; cx * BOUNDS_CHUNK_SIZE < end_x; cx++) {
+			const Range &chunk = _get_bounds_chunk(0, cx, cz);
+			if ((chunk.min > max_y) || (chunk.max < min_y)) {
+				continue;
+			}
+
+			int chunk_start_x = MAX(start_x, cx * BOUNDS_CHUNK_SIZE);
+			int chunk_end_x = MIN(end_x, (cx + 1) * BOUNDS_CHUNK_SIZE);
+			int chunk_start_z = MAX(start_z, cz * BOUNDS_CHUNK_SIZE);
+			int chunk_end_z = MIN(end_z, (cz + 1) * BOUNDS_CHUNK_SIZE);
+			if (_cull_cells(chunk_start_x, chunk_start_z, chunk_end_x, chunk_end_z, face, p_callback, p_userdata)) {
 				return;
 			}
+		}
+	}
+}
+
+bool GodotHeightMapShape3D::_cull_cells(int p_start_x, int p_start_z, int p_end_x, int p_end_z, GodotFaceShape3D &r_face, QueryCallback p_callback, void *p_userdata) const {
+	for (int z = p_start_z; z < p_end_z; z++) {
+		for (int x = p_start_x; x < p_end_x; x++) {
+			// First triangle.
+			_get_point(x, z, r_face.vertex[0]);
+			_get_point(x + 1, z, r_face.vertex[1]);
+			_get_point(x, z + 1, r_face.vertex[2]);
+			r_face.normal = Plane(r_face.vertex[0], r_face.vertex[1], r_face.vertex[2]).normal;
+			if (p_callback(p_userdata, &r_face)) {
+				return true;
+			}
 
 			// Second triangle.
-			face.vertex[0] = face.vertex[1];
-			_get_point(x + 1, z + 1, face.vertex[1]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
-				return;
+			r_face.vertex[0] = r_face.vertex[1];
+			_get_point(x + 1, z + 1, r_face.vertex[1]);
+			r_face.normal = Plane(r_face.vertex[0], r_face.vertex[1], r_face.vertex[2]).normal;
+			if (p_callback(p_userdata, &r_face)) {
+				return true;
 			}
 		}
 	}
+
+	return false;
 }
 
 Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -2018,71 +2267,134 @@ Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
+GodotHeightMapShape3D::Range GodotHeightMapShape3D::_compute_bounds_chunk(int p_x, int p_z) const {
+	int x0 = p_x * BOUNDS_CHUNK_SIZE;
+	int z0 = p_z * BOUNDS_CHUNK_SIZE;
+
+	Range r;
+
+	r.min = _get_height(x0, z0);
+	r.max = r.min;
+
+	// Compute min and max height for this chunk.
+	// We have to include one extra cell to account for neighbors.
+	// Here is why:
+	// Say we have a flat terrain, and a plateau that fits a chunk perfectly.
+	//
+	//   Left        Right
+	// 0---0---0---1---1---1
+	// |   |   |   |   |   |
+	// 0---0---0---1---1---1
+	// |   |   |   |   |   |
+	// 0---0---0---1---1---1
+	//           x
+	//
+	// If the AABB for the Left chunk did not share vertices with the Right,
+	// then we would fail collision tests at x due to a gap.
+	//
+	int z_max = MIN(z0 + BOUNDS_CHUNK_SIZE + 1, depth);
+	int x_max = MIN(x0 + BOUNDS_CHUNK_SIZE + 1, width);
+	for (int z = z0; z < z_max; ++z) {
+		for (int x = x0; x < x_max; ++x) {
+			real_t height = _get_height(x, z);
+			if (height < r.min) {
+				r.min = height;
+			} else if (height > r.max) {
+				r.max = height;
+			}
+		}
+	}
+
+	return r;
+}
+
+GodotHeightMapShape3D::Range GodotHeightMapShape3D::_compute_bounds_parent(int p_level, int p_x, int p_z) const {
+	const BoundsLevel &children = bounds_levels[p_level - 1];
+
+	Range r = _get_bounds_chunk(p_level - 1, p_x * 2, p_z * 2);
+
+	int z_max = MIN(p_z * 2 + 2, children.depth);
+	int x_max = MIN(p_x * 2 + 2, children.width);
+	for (int z = p_z * 2; z < z_max; ++z) {
+		for (int x = p_x * 2; x < x_max; ++x) {
+			const Range &child = _get_bounds_chunk(p_level - 1, x, z);
+			r.min = MIN(r.min, child.min);
+			r.max = MAX(r.max, child.max);
+		}
+	}
+
+	return r;
+}
+
 void GodotHeightMapShape3D::_build_accelerator() {
-	bounds_grid.clear();
+	bounds_levels.clear();
 
-	bounds_grid_width = width / BOUNDS_CHUNK_SIZE;
-	bounds_grid_depth = depth / BOUNDS_CHUNK_SIZE;
+	int bounds_width = width / BOUNDS_CHUNK_SIZE;
+	int bounds_depth = depth / BOUNDS_CHUNK_SIZE;
 
 	if (width % BOUNDS_CHUNK_SIZE > 0) {
-		++bounds_grid_width; // In case terrain size isn't dividable by chunk size.
+		++bounds_width; // In case terrain size isn't dividable by chunk size.
 	}
 
 	if (depth % BOUNDS_CHUNK_SIZE > 0) {
-		++bounds_grid_depth;
+		++bounds_depth;
 	}
 
-	uint32_t bound_grid_size = (uint32_t)(bounds_grid_width * bounds_grid_depth);
-
-	if (bound_grid_size < 2) {
+	if (bounds_width * bounds_depth < 2) {
 		// Grid is empty or just one chunk.
 		return;
 	}
 
-	bounds_grid.resize(bound_grid_size);
+	while (true) {
+		BoundsLevel level;
+		level.width = bounds_width;
+		level.depth = bounds_depth;
+		level.ranges.resize(bounds_width * bounds_depth);
+		bounds_levels.push_back(level);
+
+		if (bounds_width == 1 && bounds_depth == 1) {
+			break;
+		}
+
+		bounds_width = (bounds_width + 1) / 2;
+		bounds_depth = (bounds_depth + 1) / 2;
+	}
 
 	// Compute min and max height for all chunks.
-	for (int cz = 0; cz < bounds_grid_depth; ++cz) {
-		int z0 = cz * BOUNDS_CHUNK_SIZE;
-
-		for (int cx = 0; cx < bounds_grid_width; ++cx) {
-			int x0 = cx * BOUNDS_CHUNK_SIZE;
-
-			Range r;
-
-			r.min = _get_height(x0, z0);
-			r.max = r.min;
-
-			// Compute min and max height for this chunk.
-			// We have to include one extra cell to account for neighbors.
-			// Here is why:
-			// Say we have a flat terrain, and a plateau that fits a chunk perfectly.
-			//
-			//   Left        Right
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			//           x
-			//
-			// If the AABB for the Left chunk did not share vertices with the Right,
-			// then we would fail collision tests at x due to a gap.
-			//
-			int z_max = MIN(z0 + BOUNDS_CHUNK_SIZE + 1, depth);
-			int x_max = MIN(x0 + BOUNDS_CHUNK_SIZE + 1, width);
-			for (int z = z0; z < z_max; ++z) {
-				for (int x = x0; x < x_max; ++x) {
-					real_t height = _get_height(x, z);
-					if (height < r.min) {
-						r.min = height;
-					} else if (height > r.max) {
-						r.max = height;
-					}
-				}
-			}
+	_update_accelerator(Rect2i(0, 0, width, depth));
+}
+
+void GodotHeightMapShape3D::_update_accelerator(const Rect2i &p_region) {
+	if (bounds_levels.is_empty()) {
+		return;
+	}
 
-			bounds_grid[cx + cz * bounds_grid_width] = r;
+	// Find the chunks containing the modified heights, including the ones that
+	// only share their last row or column of vertices with the region.
+	int from_x = MAX(p_region.position.x - 1, 0) / BOUNDS_CHUNK_SIZE;
+	int from_z = MAX(p_region.position.y - 1, 0) / BOUNDS_CHUNK_SIZE;
+	int to_x = MIN((p_region.position.x + p_region.size.x - 1) / BOUNDS_CHUNK_SIZE, bounds_levels[0].width - 1);
+	int to_z = MIN((p_region.position.y + p_region.size.y - 1) / BOUNDS_CHUNK_SIZE, bounds_levels[0].depth - 1);
+
+	BoundsLevel &chunks = bounds_levels[0];
+	for (int z = from_z; z <= to_z; ++z) {
+		for (int x = from_x; x <= to_x; ++x) {
+			chunks.ranges[z * chunks.width + x] = _compute_bounds_chunk(x, z);
+		}
+	}
+
+	// Propagate to the coarser levels.
+	for (uint32_t i = 1; i < bounds_levels.size(); ++i) {
+		from_x /= 2;
+		from_z /= 2;
+		to_x /= 2;
+		to_z /= 2;
+
+		BoundsLevel &level = bounds_levels[i];
+		for (int z = from_z; z <= to_z; ++z) {
+			for (int x = from_x; x <= to_x; ++x) {
+				level.ranges[z * level.width + x] = _compute_bounds_parent(i, x, z);
+			}
 		}
 	}
 }
@@ -2108,6 +2420,44 @@ void GodotHeightMapShape3D::_setup(const Vector<real_t> &p_heights, int p_width,
 	configure(aabb);
 }
 
+void GodotHeightMapShape3D::set_region(const Rect2i &p_region, const Vector<real_t> &p_heights) {
+	ERR_FAIL_COND(heights.is_empty());
+	ERR_FAIL_COND(p_region.size.x <= 0 || p_region.size.y <= 0);
+	ERR_FAIL_COND_MSG(p_region.position.x < 0 || p_region.position.y < 0 || p_region.position.x + p_region.size.x > width || p_region.position.y + p_region.size.y > depth, "Region is outside of the heightmap.");
+	ERR_FAIL_COND(p_heights.size() != p_region.size.x * p_region.size.y);
+
+	// Only the rows of the region are written, the cost doesn't depend on the map size.
+	real_t *w = heights.ptrw();
+	const real_t *r = p_heights.ptr();
+
+	real_t min_height = r[0];
+	real_t max_height = r[0];
+
+	for (int z = 0; z < p_region.size.y; ++z) {
+		real_t *row = &w[(p_region.position.y + z) * width + p_region.position.x];
+		for (int x = 0; x < p_region.size.x; ++x) {
+			real_t height = *r++;
+			row[x] = height;
+			if (height < min_height) {
+				min_height = height;
+			} else if (height > max_height) {
+				max_height = height;
+			}
+		}
+	}
+
+	_update_accelerator(p_region);
+
+	// Only grow the aabb, so owners are notified when the broadphase needs it.
+	AABB aabb = get_aabb();
+	real_t aabb_max = aabb.position.y + aabb.size.y;
+	if (min_height < aabb.position.y || max_height > aabb_max) {
+		aabb.position.y = MIN(aabb.position.y, min_height);
+		aabb.size.y = MAX(aabb_max, max_height) - aabb.position.y;
+		configure(aabb);
+	}
+}
+
 void GodotHeightMapShape3D::set_data(const Variant &p_data) {
 	ERR_FAIL_COND(p_data.get_type() != Variant::DICTIONARY);
 
@@ -300,7 +300,6 @@ public:
 	GodotConvexPolygonShape3D();
 };
 
-struct _Volume_BVH;
 struct GodotFaceShape3D;
 
 struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
@@ -314,48 +313,39 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
-
-		int face_index = 0;
+	enum {
+		BVH_WIDTH = 4,
+		BVH_QUANTIZE_MAX = 65535,
+		BVH_SAH_MAX_DEPTH = 32, // Deeper nodes fall back to median splits, keeping the depth bounded.
+		BVH_STACK_SIZE = 256,
 	};
 
-	Vector<BVH> bvh;
+	static const uint32_t BVH_LEAF = 0x80000000;
+	static const uint32_t BVH_EMPTY = 0xFFFFFFFF;
 
-	struct _CullParams {
-		AABB aabb;
-		QueryCallback callback = nullptr;
-		void *userdata = nullptr;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
+	// Four-wide node. Child bounds are quantized to 16 bits inside the node bounds (rounded outwards),
+	// and stored one array per axis so the four children are tested together.
+	struct BVH {
+		Vector3 origin;
+		Vector3 scale;
+		Vector3 inv_scale;
+		uint16_t min_x[BVH_WIDTH];
+		uint16_t min_y[BVH_WIDTH];
+		uint16_t min_z[BVH_WIDTH];
+		uint16_t max_x[BVH_WIDTH];
+		uint16_t max_y[BVH_WIDTH];
+		uint16_t max_z[BVH_WIDTH];
+		uint32_t children[BVH_WIDTH]; // Node index, face index with BVH_LEAF set, or BVH_EMPTY.
+
+		_FORCE_INLINE_ void quantize(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max) const;
+		_FORCE_INLINE_ uint32_t overlap_mask(const uint16_t *p_min, const uint16_t *p_max) const;
+		_FORCE_INLINE_ AABB get_child_aabb(int p_child) const;
 	};
 
-	struct _SegmentCullParams {
-		Vector3 from;
-		Vector3 to;
-		Vector3 dir;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
-
-		Vector3 result;
-		Vector3 normal;
-		real_t min_d = 1e20;
-		int collisions = 0;
-	};
+	LocalVector<BVH> bvh;
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	bool _cull(int p_idx, _CullParams *p_params) const;
-
-	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
-
 	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
 
 public:
@@ -391,14 +381,21 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 		real_t min = 0.0;
 		real_t max = 0.0;
 	};
-	LocalVector<Range> bounds_grid;
-	int bounds_grid_width = 0;
-	int bounds_grid_depth = 0;
+
+	// Min/max height pyramid. Level 0 has one range per chunk of BOUNDS_CHUNK_SIZE cells,
+	// each following level merges 2x2 ranges of the previous one, down to a single range.
+	struct BoundsLevel {
+		LocalVector<Range> ranges;
+		int width = 0;
+		int depth = 0;
+	};
+	LocalVector<BoundsLevel> bounds_levels;
 
 	static const int BOUNDS_CHUNK_SIZE = 16;
 
-	_FORCE_INLINE_ const Range &_get_bounds_chunk(int p_x, int p_z) const {
-		return bounds_grid[(p_z * bounds_grid_width) + p_x];
+	_FORCE_INLINE_ const Range &_get_bounds_chunk(int p_level, int p_x, int p_z) const {
+		const BoundsLevel &level = bounds_levels[p_level];
+		return level.ranges[(p_z * level.width) + p_x];
 	}
 
 	_FORCE_INLINE_ real_t _get_height(int p_x, int p_z) const {
@@ -413,10 +410,15 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 
 	void _get_cell(const Vector3 &p_point, int &r_x, int &r_y, int &r_z) const;
 
+	Range _compute_bounds_chunk(int p_x, int p_z) const;
+	Range _compute_bounds_parent(int p_level, int p_x, int p_z) const;
 	void _build_accelerator();
+	void _update_accelerator(const Rect2i &p_region);
+
+	bool _cull_cells(int p_start_x, int p_start_z, int p_end_x, int p_end_z, GodotFaceShape3D &r_face, QueryCallback p_callback, void *p_userdata) const;
 
 	template <typename ProcessFunction>
-	bool _intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal) const;
+	bool _intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal, int p_level = 0) const;
 
 	void _setup(const Vector<real_t> &p_heights, int p_width, int p_depth, real_t p_min_height, real_t p_max_height);
 
@@ -425,6 +427,8 @@ public:
 	int get_width() const;
 	int get_depth() const;
 
+	void set_region(const Rect2i &p_region, const Vector<real_t> &p_heights);
+
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_HEIGHTMAP; }
 
 	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override;
@@ -36,6 +36,17 @@
 #include "core/templates/map.h"
 #include "servers/rendering_server.h"
 
+// Links that can't be given one of these colors end up in a serial batch.
+#define LINK_BATCH_MAX_COLORS 64
+// Smaller batches are solved on the calling thread.
+#define LINK_BATCH_PARALLEL_THRESHOLD 1024
+// Links solved by each work item of a parallel batch.
+#define LINK_BATCH_CHUNK_SIZE 256
+// Node and link passes over fewer elements run on the calling thread.
+#define ELEMENT_PASS_PARALLEL_THRESHOLD 1024
+// Nodes or links processed by each work item of a parallel pass.
+#define ELEMENT_PASS_CHUNK_SIZE 256
+
 // Based on Bullet soft body.
 
 /*
@@ -152,17 +163,18 @@ void GodotSoftBody3D::update_rendering_server(RenderingServerHandler *p_renderin
 		return;
 	}
 
+	// Gather positions then normals in visual vertex order, so the handler gets them in one call.
 	const uint32_t vertex_count = map_visual_to_physics.size();
+	rendering_buffer.resize(vertex_count * 2);
+	Vector3 *vertices = rendering_buffer.ptr();
+	Vector3 *normals = vertices + vertex_count;
 	for (uint32_t i = 0; i < vertex_count; ++i) {
-		const uint32_t node_index = map_visual_to_physics[i];
-		const Node &node = nodes[node_index];
-		const Vector3 &vertex_position = node.x;
-		const Vector3 &vertex_normal = node.n;
-
-		p_rendering_server_handler->set_vertex(i, &vertex_position);
-		p_rendering_server_handler->set_normal(i, &vertex_normal);
+		const Node &node = nodes[map_visual_to_physics[i]];
+		vertices[i] = node.x;
+		normals[i] = node.n;
 	}
 
+	p_rendering_server_handler->set_vertices(vertex_count, vertices, normals);
 	p_rendering_server_handler->set_aabb(bounds);
 }
 
@@ -460,6 +472,17 @@ void GodotSoftBody3D::apply_node_bias_impulse(uint32_t p_node_index, const Vecto
 	node.bv += p_impulse * node.im;
 }
 
+uint32_t GodotSoftBody3D::get_link_count() const {
+	return links.size();
+}
+
+void GodotSoftBody3D::get_link_nodes(uint32_t p_link_index, uint32_t &r_node_1, uint32_t &r_node_2) const {
+	ERR_FAIL_COND(p_link_index >= links.size());
+	const Link &link = links[p_link_index];
+	r_node_1 = link.n[0]->index;
+	r_node_2 = link.n[1]->index;
+}
+
 uint32_t GodotSoftBody3D::get_face_count() const {
 	return faces.size();
 }
@@ -588,7 +611,7 @@ bool GodotSoftBody3D::create_from_trimesh(const Vector<int> &p_indices, const Ve
 	}
 
 	generate_bending_constraints(2);
-	reoptimize_link_order();
+	color_links();
 
 	update_constants();
 	update_normals_and_centroids();
@@ -696,135 +719,66 @@ void GodotSoftBody3D::generate_bending_constraints(int p_distance) {
 	}
 }
 
-//===================================================================
-//
-//
-// This function takes in a list of interdependent Links and tries
-// to maximize the distance between calculation
-// of dependent links. This increases the amount of parallelism that can
-// be exploited by out-of-order instruction processors with large but
-// (inevitably) finite instruction windows.
-//
-//===================================================================
-
-// A small structure to track lists of dependent link calculations.
-class LinkDeps {
-public:
-	// A link calculation that is dependent on this one.
-	// Positive values = "input A" while negative values = "input B".
-	int value;
-	// Next dependence in the list.
-	LinkDeps *next;
-};
-typedef LinkDeps *LinkDepsPtr;
-
-void GodotSoftBody3D::reoptimize_link_order() {
-	const int reop_not_dependent = -1;
-	const int reop_node_complete = -2;
-
-	uint32_t i, link_count = links.size(), node_count = nodes.size();
-	Link *lr;
-	int ar, br;
-	Node *node0 = &(nodes[0]);
-	Node *node1 = &(nodes[1]);
-	LinkDepsPtr link_dep;
-	int ready_list_head, ready_list_tail, link_num, link_dep_frees, dep_link;
-
-	// Allocate temporary buffers.
-	int *node_written_at = memnew_arr(int, node_count + 1); // What link calculation produced this node's current values?
-	int *link_dep_A = memnew_arr(int, link_count); // Link calculation input is dependent upon prior calculation #N
-	int *link_dep_B = memnew_arr(int, link_count);
-	int *ready_list = memnew_arr(int, link_count); // List of ready-to-process link calculations (# of links, maximum)
-	LinkDeps *link_dep_free_list = memnew_arr(LinkDeps, 2 * link_count); // Dependent-on-me list elements (2x# of links, maximum)
-	LinkDepsPtr *link_dep_list_starts = memnew_arr(LinkDepsPtr, link_count); // Start nodes of dependent-on-me lists, one for each link
-
-	// Copy the original, unsorted links to a side buffer.
-	Link *link_buffer = memnew_arr(Link, link_count);
-	memcpy(link_buffer, &(links[0]), sizeof(Link) * link_count);
-
-	// Clear out the node setup and ready list.
-	for (i = 0; i < node_count + 1; i++) {
-		node_written_at[i] = reop_not_dependent;
-	}
-	for (i = 0; i < link_count; i++) {
-		link_dep_list_starts[i] = nullptr;
-	}
-	ready_list_head = ready_list_tail = link_dep_frees = 0;
-
-	// Initial link analysis to set up data structures.
-	for (i = 0; i < link_count; i++) {
-		// Note which prior link calculations we are dependent upon & build up dependence lists.
-		lr = &(links[i]);
-		ar = (lr->n[0] - node0) / (node1 - node0);
-		br = (lr->n[1] - node0) / (node1 - node0);
-		if (node_written_at[ar] > reop_not_dependent) {
-			link_dep_A[i] = node_written_at[ar];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = i;
-			link_dep->next = link_dep_list_starts[node_written_at[ar]];
-			link_dep_list_starts[node_written_at[ar]] = link_dep;
-		} else {
-			link_dep_A[i] = reop_not_dependent;
-		}
-		if (node_written_at[br] > reop_not_dependent) {
-			link_dep_B[i] = node_written_at[br];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = -(int)(i + 1);
-			link_dep->next = link_dep_list_starts[node_written_at[br]];
-			link_dep_list_starts[node_written_at[br]] = link_dep;
-		} else {
-			link_dep_B[i] = reop_not_dependent;
-		}
+// Sorts the links into batches in which no two links share a node, so the links of a batch
+// can be solved in any order, or concurrently. Links that don't fit in the first
+// LINK_BATCH_MAX_COLORS batches go to a last batch which is always solved serially.
+void GodotSoftBody3D::color_links() {
+	const uint32_t link_count = links.size();
 
-		// Add this link to the initial ready list, if it is not dependent on any other links.
-		if ((link_dep_A[i] == reop_not_dependent) && (link_dep_B[i] == reop_not_dependent)) {
-			ready_list[ready_list_tail++] = i;
-			link_dep_A[i] = link_dep_B[i] = reop_node_complete; // Probably not needed now.
-		}
+	link_batches.clear();
+	if (link_count == 0) {
+		return;
+	}
 
-		// Update the nodes to mark which ones are calculated by this link.
-		node_written_at[ar] = node_written_at[br] = i;
-	}
-
-	// Process the ready list and create the sorted list of links:
-	// -- By treating the ready list as a queue, we maximize the distance between any
-	//    inter-dependent node calculations.
-	// -- All other (non-related) nodes in the ready list will automatically be inserted
-	//    in between each set of inter-dependent link calculations by this loop.
-	i = 0;
-	while (ready_list_head != ready_list_tail) {
-		// Use ready list to select the next link to process.
-		link_num = ready_list[ready_list_head++];
-		// Copy the next-to-calculate link back into the original link array.
-		links[i++] = link_buffer[link_num];
-
-		// Free up any link inputs that are dependent on this one.
-		link_dep = link_dep_list_starts[link_num];
-		while (link_dep) {
-			dep_link = link_dep->value;
-			if (dep_link >= 0) {
-				link_dep_A[dep_link] = reop_not_dependent;
-			} else {
-				dep_link = -dep_link - 1;
-				link_dep_B[dep_link] = reop_not_dependent;
-			}
-			// Add this dependent link calculation to the ready list if *both* inputs are clear.
-			if ((link_dep_A[dep_link] == reop_not_dependent) && (link_dep_B[dep_link] == reop_not_dependent)) {
-				ready_list[ready_list_tail++] = dep_link;
-				link_dep_A[dep_link] = link_dep_B[dep_link] = reop_node_complete; // Probably not needed now.
+	LocalVector<uint64_t> node_colors;
+	node_colors.resize(nodes.size());
+	memset(node_colors.ptr(), 0, node_colors.size() * sizeof(uint64_t));
+
+	LocalVector<uint32_t> link_colors;
+	link_colors.resize(link_count);
+
+	uint32_t color_sizes[LINK_BATCH_MAX_COLORS + 1] = {};
+	const Node *node0 = &nodes[0];
+	for (uint32_t i = 0; i < link_count; ++i) {
+		const uint32_t index_a = links[i].n[0] - node0;
+		const uint32_t index_b = links[i].n[1] - node0;
+		const uint64_t used_colors = node_colors[index_a] | node_colors[index_b];
+
+		uint32_t color = LINK_BATCH_MAX_COLORS;
+		if (used_colors != UINT64_MAX) {
+			// Lowest color that neither node uses yet.
+			uint64_t free_colors = ~used_colors;
+			color = 0;
+			while (!(free_colors & 1)) {
+				free_colors >>= 1;
+				color++;
 			}
-			link_dep = link_dep->next;
+			node_colors[index_a] |= uint64_t(1) << color;
+			node_colors[index_b] |= uint64_t(1) << color;
 		}
+		link_colors[i] = color;
+		color_sizes[color]++;
 	}
 
-	// Delete the temporary buffers.
-	memdelete_arr(node_written_at);
-	memdelete_arr(link_dep_A);
-	memdelete_arr(link_dep_B);
-	memdelete_arr(ready_list);
-	memdelete_arr(link_dep_free_list);
-	memdelete_arr(link_dep_list_starts);
-	memdelete_arr(link_buffer);
+	// Stable counting sort by color.
+	uint32_t color_offsets[LINK_BATCH_MAX_COLORS + 1];
+	uint32_t offset = 0;
+	for (uint32_t color = 0; color <= LINK_BATCH_MAX_COLORS; ++color) {
+		color_offsets[color] = offset;
+		if (color_sizes[color] > 0) {
+			link_batches.push_back(offset);
+		}
+		offset += color_sizes[color];
+	}
+	link_batches.push_back(link_count);
+	serial_link_batch = color_sizes[LINK_BATCH_MAX_COLORS] > 0;
+
+	LocalVector<Link> sorted_links;
+	sorted_links.resize(link_count);
+	for (uint32_t i = 0; i < link_count; ++i) {
+		sorted_links[color_offsets[link_colors[i]]++] = links[i];
+	}
+	memcpy(links.ptr(), sorted_links.ptr(), sizeof(Link) * link_count);
 }
 
 void GodotSoftBody3D::append_link(uint32_t p_node1, uint32_t p_node2) {
@@ -976,7 +930,7 @@ Vector3 GodotSoftBody3D::_compute_area_windforce(const GodotArea3D *p_area, cons
 	return nodal_force_magnitude * p_face->normal;
 }
 
-void GodotSoftBody3D::predict_motion(real_t p_delta) {
+void GodotSoftBody3D::predict_motion(real_t p_delta, ThreadWorkPool *p_work_pool) {
 	const real_t inv_delta = 1.0 / p_delta;
 
 	ERR_FAIL_COND(!get_space());
@@ -1039,26 +993,19 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	// Avoid soft body from 'exploding' so use some upper threshold of maximum motion
 	// that a node can travel per frame.
 	const real_t max_displacement = 1000.0;
-	real_t clamp_delta_v = max_displacement * inv_delta;
+
+	ElementPassParams params;
+	params.delta = p_delta;
+	params.clamp_delta_v = max_displacement * inv_delta;
 
 	// Integrate.
-	uint32_t i, ni;
-	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		node.q = node.x;
-		Vector3 delta_v = node.f * node.im * p_delta;
-		for (int c = 0; c < 3; c++) {
-			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
-		}
-		node.v += delta_v;
-		node.x += node.v * p_delta;
-		node.f = Vector3();
-	}
+	_run_pass(p_work_pool, nodes.size(), &GodotSoftBody3D::_integrate_node_chunk, &params);
 
 	// Bounds and tree update.
 	update_bounds();
 
-	// Node tree update.
+	// Node tree update, serial as the tree isn't thread safe.
+	uint32_t i, ni;
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
 		const Node &node = nodes[i];
 
@@ -1079,60 +1026,132 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	face_tree.optimize_incremental(1);
 }
 
-void GodotSoftBody3D::solve_constraints(real_t p_delta) {
+void GodotSoftBody3D::solve_constraints(real_t p_delta, ThreadWorkPool *p_work_pool) {
 	const real_t inv_delta = 1.0 / p_delta;
 
-	uint32_t i, ni;
+	ElementPassParams params;
+	params.delta = p_delta;
+	params.velocity_scale = (1.0 - damping_coefficient) * inv_delta;
+
+	_run_pass(p_work_pool, links.size(), &GodotSoftBody3D::_prepare_link_chunk, &params);
+
+	// Solve velocities.
+	_run_pass(p_work_pool, nodes.size(), &GodotSoftBody3D::_predict_node_position_chunk, &params);
+
+	// Solve positions.
+	for (int isolve = 0; isolve < iteration_count; ++isolve) {
+		const real_t ti = isolve / (real_t)iteration_count;
+		solve_links(1.0, ti, p_work_pool);
+	}
+
+	_run_pass(p_work_pool, nodes.size(), &GodotSoftBody3D::_apply_node_position_chunk, &params);
 
-	for (i = 0, ni = links.size(); i < ni; ++i) {
+	update_normals_and_centroids();
+}
+
+void GodotSoftBody3D::_run_pass(ThreadWorkPool *p_work_pool, uint32_t p_element_count, void (GodotSoftBody3D::*p_chunk_method)(uint32_t, void *), ElementPassParams *p_params) {
+	const uint32_t chunk_count = (p_element_count + ELEMENT_PASS_CHUNK_SIZE - 1) / ELEMENT_PASS_CHUNK_SIZE;
+	if (p_work_pool && p_element_count >= ELEMENT_PASS_PARALLEL_THRESHOLD) {
+		p_work_pool->do_work(chunk_count, this, p_chunk_method, (void *)p_params);
+	} else {
+		for (uint32_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+			(this->*p_chunk_method)(chunk_index, p_params);
+		}
+	}
+}
+
+void GodotSoftBody3D::_integrate_node_chunk(uint32_t p_chunk_index, void *p_userdata) {
+	const ElementPassParams &params = *(const ElementPassParams *)p_userdata;
+	const uint32_t chunk_begin = p_chunk_index * ELEMENT_PASS_CHUNK_SIZE;
+	const uint32_t chunk_end = MIN(chunk_begin + ELEMENT_PASS_CHUNK_SIZE, nodes.size());
+	for (uint32_t i = chunk_begin; i < chunk_end; ++i) {
+		Node &node = nodes[i];
+		node.q = node.x;
+		Vector3 delta_v = node.f * node.im * params.delta;
+		for (int c = 0; c < 3; c++) {
+			delta_v[c] = CLAMP(delta_v[c], -params.clamp_delta_v, params.clamp_delta_v);
+		}
+		node.v += delta_v;
+		node.x += node.v * params.delta;
+		node.f = Vector3();
+	}
+}
+
+void GodotSoftBody3D::_prepare_link_chunk(uint32_t p_chunk_index, void *p_userdata) {
+	const uint32_t chunk_begin = p_chunk_index * ELEMENT_PASS_CHUNK_SIZE;
+	const uint32_t chunk_end = MIN(chunk_begin + ELEMENT_PASS_CHUNK_SIZE, links.size());
+	for (uint32_t i = chunk_begin; i < chunk_end; ++i) {
 		Link &link = links[i];
 		link.c3 = link.n[1]->q - link.n[0]->q;
 		link.c2 = 1 / (link.c3.length_squared() * link.c0);
 	}
+}
 
-	// Solve velocities.
-	for (i = 0, ni = nodes.size(); i < ni; ++i) {
+void GodotSoftBody3D::_predict_node_position_chunk(uint32_t p_chunk_index, void *p_userdata) {
+	const ElementPassParams &params = *(const ElementPassParams *)p_userdata;
+	const uint32_t chunk_begin = p_chunk_index * ELEMENT_PASS_CHUNK_SIZE;
+	const uint32_t chunk_end = MIN(chunk_begin + ELEMENT_PASS_CHUNK_SIZE, nodes.size());
+	for (uint32_t i = chunk_begin; i < chunk_end; ++i) {
 		Node &node = nodes[i];
-		node.x = node.q + node.v * p_delta;
+		node.x = node.q + node.v * params.delta;
 	}
+}
 
-	// Solve positions.
-	for (int isolve = 0; isolve < iteration_count; ++isolve) {
-		const real_t ti = isolve / (real_t)iteration_count;
-		solve_links(1.0, ti);
-	}
-	const real_t vc = (1.0 - damping_coefficient) * inv_delta;
-	for (i = 0, ni = nodes.size(); i < ni; ++i) {
+void GodotSoftBody3D::_apply_node_position_chunk(uint32_t p_chunk_index, void *p_userdata) {
+	const ElementPassParams &params = *(const ElementPassParams *)p_userdata;
+	const uint32_t chunk_begin = p_chunk_index * ELEMENT_PASS_CHUNK_SIZE;
+	const uint32_t chunk_end = MIN(chunk_begin + ELEMENT_PASS_CHUNK_SIZE, nodes.size());
+	for (uint32_t i = chunk_begin; i < chunk_end; ++i) {
 		Node &node = nodes[i];
 
-		node.x += node.bv * p_delta;
+		node.x += node.bv * params.delta;
 		node.bv = Vector3();
 
-		node.v = (node.x - node.q) * vc;
+		node.v = (node.x - node.q) * params.velocity_scale;
 
 		node.q = node.x;
 	}
-
-	update_normals_and_centroids();
 }
 
-void GodotSoftBody3D::solve_links(real_t kst, real_t ti) {
-	for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
-		Link &link = links[i];
-		if (link.c0 > 0) {
-			Node &node_a = *link.n[0];
-			Node &node_b = *link.n[1];
-			const Vector3 del = node_b.x - node_a.x;
-			const real_t len = del.length_squared();
-			if (link.c1 + len > CMP_EPSILON) {
-				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * kst;
-				node_a.x -= del * (k * node_a.im);
-				node_b.x += del * (k * node_b.im);
+void GodotSoftBody3D::solve_links(real_t kst, real_t ti, ThreadWorkPool *p_work_pool) {
+	if (link_batches.is_empty()) {
+		for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
+			_solve_link(links[i], kst);
+		}
+		return;
+	}
+
+	link_solve_kst = kst;
+
+	const uint32_t batch_count = link_batches.size() - 1;
+	for (uint32_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+		const uint32_t batch_begin = link_batches[batch_index];
+		const uint32_t batch_end = link_batches[batch_index + 1];
+
+		// The overflow batch has shared nodes, it can't be split across threads.
+		const bool serial_batch = serial_link_batch && (batch_index == batch_count - 1);
+
+		if (p_work_pool && !serial_batch && (batch_end - batch_begin) >= LINK_BATCH_PARALLEL_THRESHOLD) {
+			const uint32_t chunk_count = (batch_end - batch_begin + LINK_BATCH_CHUNK_SIZE - 1) / LINK_BATCH_CHUNK_SIZE;
+			p_work_pool->do_work(chunk_count, this, &GodotSoftBody3D::_solve_link_batch_chunk, (void *)&link_batches[batch_index]);
+		} else {
+			for (uint32_t i = batch_begin; i < batch_end; ++i) {
+				_solve_link(links[i], kst);
 			}
 		}
 	}
 }
 
+void GodotSoftBody3D::_solve_link_batch_chunk(uint32_t p_chunk_index, void *p_userdata) {
+	// Points to the batch offset, followed by the offset of the next batch.
+	const uint32_t *batch = (const uint32_t *)p_userdata;
+	const uint32_t chunk_begin = batch[0] + p_chunk_index * LINK_BATCH_CHUNK_SIZE;
+	const uint32_t chunk_end = MIN(chunk_begin + LINK_BATCH_CHUNK_SIZE, batch[1]);
+	for (uint32_t i = chunk_begin; i < chunk_end; ++i) {
+		_solve_link(links[i], link_solve_kst);
+	}
+}
+
 struct AABBQueryResult {
 	const GodotSoftBody3D *soft_body = nullptr;
 	void *userdata = nullptr;
@@ -1244,6 +1263,9 @@ void GodotSoftBody3D::destroy() {
 
 	nodes.clear();
 	links.clear();
+	link_batches.clear();
+	serial_link_batch = false;
+	rendering_buffer.clear();
 	faces.clear();
 
 	bounds = AABB();
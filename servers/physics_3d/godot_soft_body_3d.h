@@ -39,6 +39,7 @@
 #include "core/math/vector3.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/set.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/templates/vset.h"
 
 class GodotConstraint3D;
@@ -82,6 +83,15 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 	LocalVector<Link> links;
 	LocalVector<Face> faces;
 
+	// Links are sorted into batches of independent links, see color_links().
+	// Offsets into links, the last entry is the total link count.
+	LocalVector<uint32_t> link_batches;
+	// True if the last batch holds links that couldn't be colored.
+	bool serial_link_batch = false;
+	real_t link_solve_kst = 1.0;
+
+	LocalVector<Vector3> rendering_buffer;
+
 	DynamicBVH node_tree;
 	DynamicBVH face_tree;
 
@@ -156,6 +166,7 @@ public:
 	virtual void set_space(GodotSpace3D *p_space);
 
 	void set_mesh(RID p_mesh);
+	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 
 	void update_rendering_server(RenderingServerHandler *p_rendering_server_handler);
 
@@ -175,6 +186,12 @@ public:
 	void apply_node_impulse(uint32_t p_node_index, const Vector3 &p_impulse);
 	void apply_node_bias_impulse(uint32_t p_node_index, const Vector3 &p_impulse);
 
+	uint32_t get_link_count() const;
+	void get_link_nodes(uint32_t p_link_index, uint32_t &r_node_1, uint32_t &r_node_2) const;
+	// Offsets of the batches of independent links in the link order, the last one is the link count.
+	_FORCE_INLINE_ const LocalVector<uint32_t> &get_link_batches() const { return link_batches; }
+	_FORCE_INLINE_ bool has_serial_link_batch() const { return serial_link_batch; }
+
 	uint32_t get_face_count() const;
 	void get_face_points(uint32_t p_face_index, Vector3 &r_point_1, Vector3 &r_point_2, Vector3 &r_point_3) const;
 	Vector3 get_face_normal(uint32_t p_face_index) const;
@@ -201,8 +218,8 @@ public:
 	void set_drag_coefficient(real_t p_val);
 	_FORCE_INLINE_ real_t get_drag_coefficient() const { return drag_coefficient; }
 
-	void predict_motion(real_t p_delta);
-	void solve_constraints(real_t p_delta);
+	void predict_motion(real_t p_delta, ThreadWorkPool *p_work_pool = nullptr);
+	void solve_constraints(real_t p_delta, ThreadWorkPool *p_work_pool = nullptr);
 
 	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return ((Node *)p_node)->index; }
 	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return ((Face *)p_face)->index; }
@@ -231,13 +248,40 @@ private:
 
 	void apply_forces(const LocalVector<GodotArea3D *> &p_wind_areas);
 
-	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
-	void reoptimize_link_order();
+	void color_links();
 	void append_link(uint32_t p_node1, uint32_t p_node2);
 	void append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_node3);
 
-	void solve_links(real_t kst, real_t ti);
+	// Shared by the work items of a node or link pass.
+	struct ElementPassParams {
+		real_t delta = 0.0;
+		real_t clamp_delta_v = 0.0;
+		real_t velocity_scale = 0.0;
+	};
+
+	void _run_pass(ThreadWorkPool *p_work_pool, uint32_t p_element_count, void (GodotSoftBody3D::*p_chunk_method)(uint32_t, void *), ElementPassParams *p_params);
+	void _integrate_node_chunk(uint32_t p_chunk_index, void *p_userdata);
+	void _prepare_link_chunk(uint32_t p_chunk_index, void *p_userdata);
+	void _predict_node_position_chunk(uint32_t p_chunk_index, void *p_userdata);
+	void _apply_node_position_chunk(uint32_t p_chunk_index, void *p_userdata);
+
+	void solve_links(real_t kst, real_t ti, ThreadWorkPool *p_work_pool);
+	void _solve_link_batch_chunk(uint32_t p_chunk_index, void *p_userdata);
+
+	_FORCE_INLINE_ void _solve_link(Link &p_link, real_t p_kst) {
+		if (p_link.c0 > 0) {
+			Node &node_a = *p_link.n[0];
+			Node &node_b = *p_link.n[1];
+			const Vector3 del = node_b.x - node_a.x;
+			const real_t len = del.length_squared();
+			if (p_link.c1 + len > CMP_EPSILON) {
+				const real_t k = ((p_link.c1 - len) / (p_link.c0 * (p_link.c1 + len))) * p_kst;
+				node_a.x -= del * (k * node_a.im);
+				node_b.x += del * (k * node_b.im);
+			}
+		}
+	}
 
 	void initialize_face_tree();
 	void update_face_tree(real_t p_delta);
@@ -40,6 +40,34 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+// Islands are solved in an order that only depends on what the constraints link, not on the order the broadphase created
+// the pairs in, so a space stepped again after restoring a snapshot gives exactly the same results.
+struct ConstraintSolveOrder3D {
+	_FORCE_INLINE_ bool operator()(const GodotConstraint3D *p_a, const GodotConstraint3D *p_b) const {
+		if (p_a->get_body_count() != p_b->get_body_count()) {
+			return p_a->get_body_count() < p_b->get_body_count();
+		}
+		for (int i = 0; i < p_a->get_body_count(); i++) {
+			uint64_t id_a = p_a->get_body_ptr()[i]->get_self().get_id();
+			uint64_t id_b = p_b->get_body_ptr()[i]->get_self().get_id();
+			if (id_a != id_b) {
+				return id_a < id_b;
+			}
+		}
+		if (p_a->get_soft_body_count() != p_b->get_soft_body_count()) {
+			return p_a->get_soft_body_count() < p_b->get_soft_body_count();
+		}
+		for (int i = 0; i < p_a->get_soft_body_count(); i++) {
+			uint64_t id_a = p_a->get_soft_body_ptr(i)->get_self().get_id();
+			uint64_t id_b = p_b->get_soft_body_ptr(i)->get_self().get_id();
+			if (id_a != id_b) {
+				return id_a < id_b;
+			}
+		}
+		return p_a->get_solve_order() < p_b->get_solve_order();
+	}
+};
+
 void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -117,6 +145,9 @@ void GodotStep3D::_setup_contraint(uint32_t p_constraint_index, void *p_userdata
 }
 
 void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const {
+	// Pre-solving applies the cached impulses, so it must already run in the solving order.
+	p_constraint_island.sort_custom<ConstraintSolveOrder3D>();
+
 	uint32_t constraint_count = p_constraint_island.size();
 	uint32_t valid_constraint_count = 0;
 	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
@@ -213,7 +244,7 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	const SelfList<GodotSoftBody3D> *sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->predict_motion(p_delta);
+		sb->self()->predict_motion(p_delta, &work_pool);
 		sb = sb->next();
 		active_count++;
 	}
@@ -385,14 +416,31 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 		_check_suspend(body_islands[island_index]);
 	}
 
+	/* PUBLISH BODY STATE */
+
+	// Bodies that fell asleep published their state when deactivated.
+	b = body_list->first();
+	while (b) {
+		b->self()->publish_state();
+		b = b->next();
+	}
+
 	/* UPDATE SOFT BODY CONSTRAINTS */
 
+	active_soft_bodies.clear();
 	sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->solve_constraints(p_delta);
+		active_soft_bodies.push_back(sb->self());
 		sb = sb->next();
 	}
 
+	if (active_soft_bodies.size() == 1) {
+		// A single soft body spreads its link batches across the workers instead.
+		active_soft_bodies[0]->solve_constraints(p_delta, &work_pool);
+	} else if (active_soft_bodies.size() > 1) {
+		work_pool.do_work(active_soft_bodies.size(), this, &GodotStep3D::_solve_soft_body_constraints, nullptr);
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_VELOCITIES, profile_endtime - profile_begtime);
@@ -405,6 +453,10 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	_step++;
 }
 
+void GodotStep3D::_solve_soft_body_constraints(uint32_t p_soft_body_index, void *p_userdata) {
+	active_soft_bodies[p_soft_body_index]->solve_constraints(delta);
+}
+
 GodotStep3D::GodotStep3D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
@@ -125,6 +125,9 @@ public:
 		return physics_2d_server->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(Vector<uint8_t>, space_create_snapshot, RID);
+	FUNC2(space_restore_snapshot, RID, const Vector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -208,6 +208,15 @@ public:
 	virtual void set_normal(int p_vertex_id, const void *p_vector3) = 0;
 	virtual void set_aabb(const AABB &p_aabb) = 0;
 
+	// Sets the positions and normals of vertices [0, p_vertex_count) in one call.
+	// Handlers can override this to avoid the per-vertex virtual calls.
+	virtual void set_vertices(int p_vertex_count, const Vector3 *p_vertices, const Vector3 *p_normals) {
+		for (int i = 0; i < p_vertex_count; ++i) {
+			set_vertex(i, &p_vertices[i]);
+			set_normal(i, &p_normals[i]);
+		}
+	}
+
 	virtual ~RenderingServerHandler() {}
 };
 
@@ -257,6 +266,8 @@ public:
 	virtual void shape_set_data(RID p_shape, const Variant &p_data) = 0;
 	virtual void shape_set_custom_solver_bias(RID p_shape, real_t p_bias) = 0;
 
+	virtual void heightmap_shape_update_region(RID p_shape, const Rect2i &p_region, const Vector<real_t> &p_heights) = 0;
+
 	virtual ShapeType shape_get_type(RID p_shape) const = 0;
 	virtual Variant shape_get_data(RID p_shape) const = 0;
 
@@ -292,6 +303,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	virtual Vector<uint8_t> space_create_snapshot(RID p_space) const = 0;
+	virtual void space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
@@ -444,6 +458,7 @@ public:
 
 	virtual void body_set_state(RID p_body, BodyState p_state, const Variant &p_variant) = 0;
 	virtual Variant body_get_state(RID p_body, BodyState p_state) const = 0;
+	virtual Variant body_get_published_state(RID p_body, BodyState p_state) const = 0;
 
 	virtual void body_apply_central_impulse(RID p_body, const Vector3 &p_impulse) = 0;
 	virtual void body_apply_impulse(RID p_body, const Vector3 &p_impulse, const Vector3 &p_position = Vector3()) = 0;
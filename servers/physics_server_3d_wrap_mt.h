@@ -90,6 +90,8 @@ public:
 	FUNC2(shape_set_data, RID, const Variant &);
 	FUNC2(shape_set_custom_solver_bias, RID, real_t);
 
+	FUNC3(heightmap_shape_update_region, RID, const Rect2i &, const Vector<real_t> &);
+
 	FUNC2(shape_set_margin, RID, real_t)
 	FUNC1RC(real_t, shape_get_margin, RID)
 
@@ -129,6 +131,9 @@ public:
 		return physics_3d_server->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(Vector<uint8_t>, space_create_snapshot, RID);
+	FUNC2(space_restore_snapshot, RID, const Vector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -213,6 +218,11 @@ public:
 	FUNC3(body_set_state, RID, BodyState, const Variant &);
 	FUNC2RC(Variant, body_get_state, RID, BodyState);
 
+	// this function can be called from any thread, without waiting for the step to finish
+	Variant body_get_published_state(RID p_body, BodyState p_state) const override {
+		return physics_3d_server->body_get_published_state(p_body, p_state);
+	}
+
 	FUNC2(body_apply_torque_impulse, RID, const Vector3 &);
 	FUNC2(body_apply_central_impulse, RID, const Vector3 &);
 	FUNC3(body_apply_impulse, RID, const Vector3 &, const Vector3 &);
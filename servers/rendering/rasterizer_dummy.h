@@ -320,7 +320,17 @@ public:
 
 	/* MESH API */
 
-	RID mesh_allocate() override { return RID(); }
+	// Meshes only keep their custom AABB, so instances of them can be culled by headless servers.
+	struct DummyMesh {
+		AABB custom_aabb;
+	};
+	mutable RID_PtrOwner<DummyMesh> mesh_owner;
+
+	RID mesh_allocate() override {
+		DummyMesh *mesh = memnew(DummyMesh);
+		ERR_FAIL_COND_V(!mesh, RID());
+		return mesh_owner.make_rid(mesh);
+	}
 	void mesh_initialize(RID p_rid) override {}
 	void mesh_set_blend_shape_count(RID p_mesh, int p_blend_shape_count) override {}
 	bool mesh_needs_instance(RID p_mesh, bool p_has_skeleton) override { return false; }
@@ -349,10 +359,22 @@ public:
 	RS::SurfaceData mesh_get_surface(RID p_mesh, int p_surface) const override { return RS::SurfaceData(); }
 	int mesh_get_surface_count(RID p_mesh) const override { return 0; }
 
-	void mesh_set_custom_aabb(RID p_mesh, const AABB &p_aabb) override {}
-	AABB mesh_get_custom_aabb(RID p_mesh) const override { return AABB(); }
+	void mesh_set_custom_aabb(RID p_mesh, const AABB &p_aabb) override {
+		DummyMesh *m = mesh_owner.get_or_null(p_mesh);
+		ERR_FAIL_COND(!m);
+		m->custom_aabb = p_aabb;
+	}
+	AABB mesh_get_custom_aabb(RID p_mesh) const override {
+		DummyMesh *m = mesh_owner.get_or_null(p_mesh);
+		ERR_FAIL_COND_V(!m, AABB());
+		return m->custom_aabb;
+	}
 
-	AABB mesh_get_aabb(RID p_mesh, RID p_skeleton = RID()) override { return AABB(); }
+	AABB mesh_get_aabb(RID p_mesh, RID p_skeleton = RID()) override {
+		DummyMesh *m = mesh_owner.get_or_null(p_mesh);
+		ERR_FAIL_COND_V(!m, AABB());
+		return m->custom_aabb;
+	}
 	void mesh_set_shadow_mesh(RID p_mesh, RID p_shadow_mesh) override {}
 	void mesh_clear(RID p_mesh) override {}
 
@@ -377,6 +399,7 @@ public:
 	Color multimesh_instance_get_color(RID p_multimesh, int p_index) const override { return Color(); }
 	Color multimesh_instance_get_custom_data(RID p_multimesh, int p_index) const override { return Color(); }
 	void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) override {}
+	void multimesh_set_buffer_range(RID p_multimesh, int p_instance_offset, int p_instance_count, const Vector<float> &p_buffer) override {}
 	Vector<float> multimesh_get_buffer(RID p_multimesh) const override { return Vector<float>(); }
 
 	void multimesh_set_visible_instances(RID p_multimesh, int p_visible) override {}
@@ -680,7 +703,12 @@ public:
 	Rect2i render_target_get_sdf_rect(RID p_render_target) const override { return Rect2i(); }
 	void render_target_mark_sdf_enabled(RID p_render_target, bool p_enabled) override {}
 
-	RS::InstanceType get_base_type(RID p_rid) const override { return RS::INSTANCE_NONE; }
+	RS::InstanceType get_base_type(RID p_rid) const override {
+		if (mesh_owner.owns(p_rid)) {
+			return RS::INSTANCE_MESH;
+		}
+		return RS::INSTANCE_NONE;
+	}
 	bool free(RID p_rid) override {
 		if (texture_owner.owns(p_rid)) {
 			// delete the texture
@@ -689,6 +717,12 @@ public:
 			memdelete(texture);
 			return true;
 		}
+		if (mesh_owner.owns(p_rid)) {
+			DummyMesh *mesh = mesh_owner.get_or_null(p_rid);
+			mesh_owner.free(p_rid);
+			memdelete(mesh);
+			return true;
+		}
 		return false;
 	}
 
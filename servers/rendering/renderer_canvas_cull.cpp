@@ -30,7 +30,9 @@
 
 #include "renderer_canvas_cull.h"
 
+#include "core/config/project_settings.h"
 #include "core/math/geometry_2d.h"
+#include "renderer_thread_pool.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -43,8 +45,17 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
-	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true);
+	if (_can_cull_threaded(p_child_item_count)) {
+		LocalVector<Item *> items;
+		items.resize(p_child_item_count);
+		for (int i = 0; i < p_child_item_count; i++) {
+			items[i] = p_child_items[i].item;
+		}
+		_cull_canvas_items_threaded(items.ptr(), items.size(), p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, false);
+	} else {
+		for (int i = 0; i < p_child_item_count; i++) {
+			_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true);
+		}
 	}
 	if (p_canvas_item) {
 		_cull_canvas_item(p_canvas_item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true);
@@ -75,28 +86,92 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	}
 }
 
-void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, Transform2D p_transform, RendererCanvasCull::Item *p_material_owner, RendererCanvasCull::Item **r_items, int &r_index) {
+void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, int p_parent, LocalVector<RendererCanvasCull::Item::YSortChild> &r_children) {
+	if (p_canvas_item->children_order_dirty) {
+		p_canvas_item->child_items.sort_custom<RendererCanvasCull::ItemIndexSort>();
+		p_canvas_item->children_order_dirty = false;
+	}
+
 	int child_item_count = p_canvas_item->child_items.size();
 	RendererCanvasCull::Item **child_items = p_canvas_item->child_items.ptrw();
 	for (int i = 0; i < child_item_count; i++) {
 		if (child_items[i]->visible) {
-			if (r_items) {
-				r_items[r_index] = child_items[i];
-				child_items[i]->ysort_xform = p_transform;
-				child_items[i]->ysort_pos = p_transform.xform(child_items[i]->xform.elements[2]);
-				child_items[i]->material_owner = child_items[i]->use_parent_material ? p_material_owner : nullptr;
-				child_items[i]->ysort_index = r_index;
-			}
-
-			r_index++;
+			RendererCanvasCull::Item::YSortChild child;
+			child.item = child_items[i];
+			child.parent = p_parent;
+			r_children.push_back(child);
 
 			if (child_items[i]->sort_y) {
-				_collect_ysort_children(child_items[i], p_transform * child_items[i]->xform, child_items[i]->use_parent_material ? p_material_owner : child_items[i], r_items, r_index);
+				_collect_ysort_children(child_items[i], r_children.size() - 1, r_children);
 			}
 		}
 	}
 }
 
+void RendererCanvasCull::_update_ysort_children(Item *p_canvas_item, Item *p_material_owner) {
+	bool collected = false;
+	if (p_canvas_item->ysort_children_count == -1) {
+		p_canvas_item->ysort_children.clear();
+		_collect_ysort_children(p_canvas_item, -1, p_canvas_item->ysort_children);
+		p_canvas_item->ysort_children_count = p_canvas_item->ysort_children.size();
+		collected = true;
+	}
+
+	// Transforms change without invalidating the list, so positions are refreshed every frame.
+	// Children are stored in tree order, so their parents are always refreshed first.
+	Item::YSortChild *children = p_canvas_item->ysort_children.ptr();
+	int child_count = p_canvas_item->ysort_children_count;
+	for (int i = 0; i < child_count; i++) {
+		Item *child = children[i].item;
+		Item *material_owner = p_material_owner;
+		if (children[i].parent == -1) {
+			child->ysort_xform = Transform2D();
+		} else {
+			Item *parent = children[children[i].parent].item;
+			child->ysort_xform = parent->ysort_xform * parent->xform;
+			material_owner = parent->use_parent_material ? (Item *)parent->material_owner : parent;
+		}
+		child->ysort_pos = child->ysort_xform.xform(child->xform.elements[2]);
+		child->material_owner = child->use_parent_material ? material_owner : nullptr;
+		child->ysort_index = i + 1;
+	}
+
+	LocalVector<Item *> &sorted = p_canvas_item->ysort_sorted;
+	SortArray<Item *, ItemPtrSort> sorter;
+	if (collected) {
+		sorted.resize(child_count + 1);
+		sorted[0] = p_canvas_item;
+		for (int i = 0; i < child_count; i++) {
+			sorted[i + 1] = children[i].item;
+		}
+		sorter.sort(sorted.ptr(), sorted.size());
+		return;
+	}
+
+	// Most children keep their place between frames, so an insertion sort of the previous
+	// order is close to linear. Fall back to a full sort when too many of them moved.
+	ItemPtrSort compare;
+	Item **items = sorted.ptr();
+	uint32_t item_count = sorted.size();
+	uint32_t moves = 0;
+	uint32_t max_moves = item_count * YSORT_MAX_MOVES_PER_ITEM;
+	for (uint32_t i = 1; i < item_count; i++) {
+		Item *item = items[i];
+		uint32_t j = i;
+		while (j > 0 && compare(item, items[j - 1])) {
+			items[j] = items[j - 1];
+			j--;
+		}
+		items[j] = item;
+
+		moves += i - j;
+		if (moves > max_moves) {
+			sorter.sort(items, item_count);
+			break;
+		}
+	}
+}
+
 void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner, RID_Owner<RendererCanvasCull::Item, true> &canvas_item_owner) {
 	do {
 		ysort_owner->ysort_children_count = -1;
@@ -176,7 +251,9 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 		//something to draw?
 
 		if (ci->update_when_visible) {
+			redraw_request_lock.lock();
 			RenderingServerDefault::redraw_request();
+			redraw_request_lock.unlock();
 		}
 
 		if (ci->commands != nullptr) {
@@ -203,10 +280,13 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 		}
 
 		if (ci->visibility_notifier) {
+			// Adding a notifier to the list changes its neighbors, so the check is done under the lock too.
+			visibility_notifier_list_lock.lock();
 			if (!ci->visibility_notifier->visible_element.in_list()) {
 				visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
 				ci->visibility_notifier->just_visible = true;
 			}
+			visibility_notifier_list_lock.unlock();
 
 			ci->visibility_notifier->visible_in_frame = RSG::rasterizer->get_frame_number();
 		}
@@ -284,24 +364,18 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 
 	if (ci->sort_y) {
 		if (allow_y_sort) {
-			if (ci->ysort_children_count == -1) {
-				ci->ysort_children_count = 0;
-				_collect_ysort_children(ci, Transform2D(), p_material_owner, nullptr, ci->ysort_children_count);
-			}
-
-			child_item_count = ci->ysort_children_count + 1;
-			child_items = (Item **)alloca(child_item_count * sizeof(Item *));
-
-			child_items[0] = ci;
-			int i = 1;
-			_collect_ysort_children(ci, Transform2D(), p_material_owner, child_items, i);
+			_update_ysort_children(ci, p_material_owner);
 			ci->ysort_xform = ci->xform.affine_inverse();
 
-			SortArray<Item *, ItemPtrSort> sorter;
-			sorter.sort(child_items, child_item_count);
+			child_item_count = ci->ysort_sorted.size();
+			child_items = ci->ysort_sorted.ptr();
 
-			for (i = 0; i < child_item_count; i++) {
-				_cull_canvas_item(child_items[i], xform * child_items[i]->ysort_xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false);
+			if (_can_cull_threaded(child_item_count)) {
+				_cull_canvas_items_threaded(child_items, child_item_count, xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, nullptr, true);
+			} else {
+				for (int i = 0; i < child_item_count; i++) {
+					_cull_canvas_item(child_items[i], xform * child_items[i]->ysort_xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false);
+				}
 			}
 		} else {
 			RendererCanvasRender::Item *canvas_group_from = nullptr;
@@ -321,18 +395,99 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			canvas_group_from = z_last_list[zidx];
 		}
 
+		_cull_canvas_item_children(ci, true, use_canvas_group, xform, p_clip_rect, modulate, p_z, z_list, z_last_list, p_material_owner);
+		_attach_canvas_item_for_draw(ci, p_canvas_clip, z_list, z_last_list, xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from, xform);
+		_cull_canvas_item_children(ci, false, use_canvas_group, xform, p_clip_rect, modulate, p_z, z_list, z_last_list, p_material_owner);
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_item_children(Item *p_canvas_item, bool p_behind, bool p_use_canvas_group, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_material_owner) {
+	int child_item_count = p_canvas_item->child_items.size();
+	Item **child_items = p_canvas_item->child_items.ptrw();
+	Item *canvas_clip = (Item *)p_canvas_item->final_clip_owner;
+
+	if (_can_cull_threaded(child_item_count)) {
+		LocalVector<Item *> items;
 		for (int i = 0; i < child_item_count; i++) {
-			if (!child_items[i]->behind && !use_canvas_group) {
-				continue;
+			if ((child_items[i]->behind || p_use_canvas_group) == p_behind) {
+				items.push_back(child_items[i]);
 			}
-			_cull_canvas_item(child_items[i], xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true);
 		}
-		_attach_canvas_item_for_draw(ci, p_canvas_clip, z_list, z_last_list, xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from, xform);
-		for (int i = 0; i < child_item_count; i++) {
-			if (child_items[i]->behind || use_canvas_group) {
+		if (items.size()) {
+			_cull_canvas_items_threaded(items.ptr(), items.size(), p_transform, p_clip_rect, p_modulate, p_z, z_list, z_last_list, canvas_clip, p_material_owner, false);
+		}
+		return;
+	}
+
+	for (int i = 0; i < child_item_count; i++) {
+		if ((child_items[i]->behind || p_use_canvas_group) != p_behind) {
+			continue;
+		}
+		_cull_canvas_item(child_items[i], p_transform, p_clip_rect, p_modulate, p_z, z_list, z_last_list, canvas_clip, p_material_owner, true);
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_items_threaded(Item **p_items, uint32_t p_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_y_sorted) {
+	ThreadWorkPool &thread_pool = RendererThreadPool::singleton->thread_work_pool;
+	uint32_t chunk_count = MIN((uint32_t)thread_pool.get_thread_count() * 2, p_item_count);
+
+	while (cull_chunks.size() < chunk_count) {
+		CullChunk chunk;
+		chunk.z_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+		chunk.z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+		memset(chunk.z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+		memset(chunk.z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+		cull_chunks.push_back(chunk);
+	}
+
+	CullThreadData data;
+	data.items = p_items;
+	data.item_count = p_item_count;
+	data.items_per_chunk = (p_item_count + chunk_count - 1) / chunk_count;
+	data.transform = p_transform;
+	data.clip_rect = p_clip_rect;
+	data.modulate = p_modulate;
+	data.z = p_z;
+	data.canvas_clip = p_canvas_clip;
+	data.material_owner = p_material_owner;
+	data.y_sorted = p_y_sorted;
+
+	culling_threaded = true;
+	thread_pool.do_work(chunk_count, this, &RendererCanvasCull::_cull_canvas_item_chunk, &data);
+	culling_threaded = false;
+
+	// Append the chunks in order, the result is the same as culling the items one by one.
+	for (int i = 0; i < z_range; i++) {
+		for (uint32_t j = 0; j < chunk_count; j++) {
+			CullChunk &chunk = cull_chunks[j];
+			if (!chunk.z_list[i]) {
 				continue;
 			}
-			_cull_canvas_item(child_items[i], xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true);
+
+			if (z_last_list[i]) {
+				z_last_list[i]->next = chunk.z_list[i];
+			} else {
+				z_list[i] = chunk.z_list[i];
+			}
+			z_last_list[i] = chunk.z_last_list[i];
+
+			chunk.z_list[i] = nullptr;
+			chunk.z_last_list[i] = nullptr;
+		}
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_item_chunk(uint32_t p_chunk, CullThreadData *p_data) {
+	uint32_t from = p_chunk * p_data->items_per_chunk;
+	uint32_t to = MIN(from + p_data->items_per_chunk, p_data->item_count);
+	CullChunk &chunk = cull_chunks[p_chunk];
+
+	for (uint32_t i = from; i < to; i++) {
+		Item *item = p_data->items[i];
+		if (p_data->y_sorted) {
+			_cull_canvas_item(item, p_data->transform * item->ysort_xform, p_data->clip_rect, p_data->modulate, p_data->z, chunk.z_list, chunk.z_last_list, p_data->canvas_clip, (Item *)item->material_owner, false);
+		} else {
+			_cull_canvas_item(item, p_data->transform, p_data->clip_rect, p_data->modulate, p_data->z, chunk.z_list, chunk.z_last_list, p_data->canvas_clip, p_data->material_owner, true);
 		}
 	}
 }
@@ -1139,6 +1294,10 @@ void RendererCanvasCull::canvas_item_set_draw_index(RID p_item, int p_index) {
 	if (canvas_item_owner.owns(canvas_item->parent)) {
 		Item *canvas_item_parent = canvas_item_owner.get_or_null(canvas_item->parent);
 		canvas_item_parent->children_order_dirty = true;
+		if (canvas_item_parent->sort_y) {
+			// The child order breaks ties when sorting by y.
+			_mark_ysort_dirty(canvas_item_parent, canvas_item_owner);
+		}
 		return;
 	}
 
@@ -1721,9 +1880,17 @@ RendererCanvasCull::RendererCanvasCull() {
 	z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
 
 	disable_scale = false;
+
+	thread_cull_threshold = GLOBAL_GET("rendering/limits/canvas/threaded_cull_minimum_items");
+	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)RendererThreadPool::singleton->thread_work_pool.get_thread_count());
 }
 
 RendererCanvasCull::~RendererCanvasCull() {
 	memfree(z_list);
 	memfree(z_last_list);
+
+	for (uint32_t i = 0; i < cull_chunks.size(); i++) {
+		memfree(cull_chunks[i].z_list);
+		memfree(cull_chunks[i].z_last_list);
+	}
 }
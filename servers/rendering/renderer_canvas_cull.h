@@ -31,6 +31,8 @@
 #ifndef RENDERING_SERVER_CANVAS_CULL_H
 #define RENDERING_SERVER_CANVAS_CULL_H
 
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
@@ -54,6 +56,16 @@ public:
 		Vector2 ysort_pos;
 		int ysort_index;
 
+		struct YSortChild {
+			Item *item = nullptr;
+			int parent = -1; // Index in ysort_children, or -1 for the children of the sorting item itself.
+		};
+
+		// Collected in tree order when ysort_children_count is invalidated, the sorted
+		// order is kept between frames so moving children only need a cheap re-sort.
+		LocalVector<YSortChild> ysort_children;
+		LocalVector<Item *> ysort_sorted;
+
 		Vector<Item *> child_items;
 
 		struct VisibilityNotifierData {
@@ -173,16 +185,54 @@ public:
 
 	PagedAllocator<Item::VisibilityNotifierData> visibility_notifier_allocator;
 	SelfList<Item::VisibilityNotifierData>::List visibility_notifier_list;
+	SpinLock visibility_notifier_list_lock;
+	SpinLock redraw_request_lock;
 
 	_FORCE_INLINE_ void _attach_canvas_item_for_draw(Item *ci, Item *p_canvas_clip, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, const Transform2D &xform, const Rect2 &p_clip_rect, Rect2 global_rect, const Color &modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool use_canvas_group, RendererCanvasRender::Item *canvas_group_from, const Transform2D &p_xform);
 
 private:
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool allow_y_sort);
+	void _cull_canvas_item_children(Item *p_canvas_item, bool p_behind, bool p_use_canvas_group, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_material_owner);
+	void _update_ysort_children(Item *p_canvas_item, Item *p_material_owner);
+
+	enum {
+		YSORT_MAX_MOVES_PER_ITEM = 4, // Above this, re-sorting the previous order is slower than a full sort.
+	};
 
 	RendererCanvasRender::Item **z_list;
 	RendererCanvasRender::Item **z_last_list;
 
+	// Large lists of sibling items are culled in chunks on the worker threads, each chunk
+	// into its own z lists, which are then appended to the caller's lists in order.
+	struct CullChunk {
+		RendererCanvasRender::Item **z_list = nullptr;
+		RendererCanvasRender::Item **z_last_list = nullptr;
+	};
+
+	struct CullThreadData {
+		Item **items = nullptr;
+		uint32_t item_count = 0;
+		uint32_t items_per_chunk = 0;
+		Transform2D transform;
+		Rect2 clip_rect;
+		Color modulate;
+		int z = 0;
+		Item *canvas_clip = nullptr;
+		Item *material_owner = nullptr;
+		bool y_sorted = false;
+	};
+
+	LocalVector<CullChunk> cull_chunks;
+	uint32_t thread_cull_threshold = 1000;
+	bool culling_threaded = false;
+
+	_FORCE_INLINE_ bool _can_cull_threaded(uint32_t p_item_count) const {
+		return !culling_threaded && p_item_count >= thread_cull_threshold;
+	}
+	void _cull_canvas_items_threaded(Item **p_items, uint32_t p_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_y_sorted);
+	void _cull_canvas_item_chunk(uint32_t p_chunk, CullThreadData *p_data);
+
 public:
 	void render_canvas(RID p_render_target, Canvas *p_canvas, const Transform2D &p_transform, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, const Rect2 &p_clip_rect, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_transforms_to_pixel, bool p_snap_2d_vertices_to_pixel);
 
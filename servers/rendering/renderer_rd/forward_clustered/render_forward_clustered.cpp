@@ -926,37 +926,15 @@ _FORCE_INLINE_ static uint32_t _indices_to_primitives(RS::PrimitiveType p_primit
 	static const uint32_t subtractor[RS::PRIMITIVE_MAX] = { 0, 0, 1, 0, 1 };
 	return (p_indices - subtractor[p_primitive]) / divisor[p_primitive];
 }
-void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_using_sdfgi, bool p_using_opaque_gi, bool p_append) {
-	if (p_render_list == RENDER_LIST_OPAQUE) {
-		scene_state.used_sss = false;
-		scene_state.used_screen_texture = false;
-		scene_state.used_normal_texture = false;
-		scene_state.used_depth_texture = false;
-	}
-	uint32_t lightmap_captures_used = 0;
-
-	Plane near_plane = Plane(-p_render_data->cam_transform.basis.get_axis(Vector3::AXIS_Z), p_render_data->cam_transform.origin);
-	near_plane.d += p_render_data->cam_projection.get_z_near();
-	float z_max = p_render_data->cam_projection.get_z_far() - p_render_data->cam_projection.get_z_near();
+void RenderForwardClustered::_fill_render_list_range(RenderListFillData *p_data, uint32_t p_from, uint32_t p_to, LocalVector<GeometryInstanceSurfaceDataCache *> &r_elements, LocalVector<GeometryInstanceSurfaceDataCache *> &r_alpha_elements, RenderListFillStats &r_stats) {
+	const RenderDataRD *render_data = p_data->render_data;
 
-	RenderList *rl = &render_list[p_render_list];
-	_update_dirty_geometry_instances();
+	for (uint32_t i = p_from; i < p_to; i++) {
+		GeometryInstanceForwardClustered *inst = static_cast<GeometryInstanceForwardClustered *>((*render_data->instances)[i]);
 
-	if (!p_append) {
-		rl->clear();
-		if (p_render_list == RENDER_LIST_OPAQUE) {
-			render_list[RENDER_LIST_ALPHA].clear(); //opaque fills alpha too
-		}
-	}
-
-	//fill list
-
-	for (int i = 0; i < (int)p_render_data->instances->size(); i++) {
-		GeometryInstanceForwardClustered *inst = static_cast<GeometryInstanceForwardClustered *>((*p_render_data->instances)[i]);
-
-		Vector3 support_min = inst->transformed_aabb.get_support(-near_plane.normal);
-		inst->depth = near_plane.distance_to(support_min);
-		uint32_t depth_layer = CLAMP(int(inst->depth * 16 / z_max), 0, 15);
+		Vector3 support_min = inst->transformed_aabb.get_support(-p_data->near_plane.normal);
+		inst->depth = p_data->near_plane.distance_to(support_min);
+		uint32_t depth_layer = CLAMP(int(inst->depth * 16 / p_data->z_max), 0, 15);
 
 		uint32_t flags = inst->base_flags; //fill flags if appropriate
 
@@ -968,7 +946,7 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 		float fade_alpha = 1.0;
 
 		if (inst->fade_near || inst->fade_far) {
-			float fade_dist = inst->transform.origin.distance_to(p_render_data->cam_transform.origin);
+			float fade_dist = inst->transform.origin.distance_to(render_data->cam_transform.origin);
 			// Use `smoothstep()` to make opacity changes more gradual and less noticeable to the player.
 			if (inst->fade_far && fade_dist > inst->fade_far_begin) {
 				fade_alpha = Math::smoothstep(0.0f, 1.0f, 1.0f - (fade_dist - inst->fade_far_begin) / (inst->fade_far_end - inst->fade_far_begin));
@@ -981,7 +959,7 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 
 		flags = (flags & ~INSTANCE_DATA_FLAGS_FADE_MASK) | (uint32_t(fade_alpha * 255.0) << INSTANCE_DATA_FLAGS_FADE_SHIFT);
 
-		if (p_render_list == RENDER_LIST_OPAQUE) {
+		if (p_data->render_list == RENDER_LIST_OPAQUE) {
 			// Setup GI
 			if (inst->lightmap_instance.is_valid()) {
 				int32_t lightmap_cull_index = -1;
@@ -1004,9 +982,10 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 				}
 
 			} else if (inst->lightmap_sh) {
-				if (lightmap_captures_used < scene_state.max_lightmap_captures) {
+				uint32_t capture_index = p_data->lightmap_captures_used.postincrement();
+				if (capture_index < scene_state.max_lightmap_captures) {
 					const Color *src_capture = inst->lightmap_sh->sh;
-					LightmapCaptureData &lcd = scene_state.lightmap_captures[lightmap_captures_used];
+					LightmapCaptureData &lcd = scene_state.lightmap_captures[capture_index];
 					for (int j = 0; j < 9; j++) {
 						lcd.sh[j * 4 + 0] = src_capture[j].r;
 						lcd.sh[j * 4 + 1] = src_capture[j].g;
@@ -1014,13 +993,12 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 						lcd.sh[j * 4 + 3] = src_capture[j].a;
 					}
 					flags |= INSTANCE_DATA_FLAG_USE_LIGHTMAP_CAPTURE;
-					inst->gi_offset_cache = lightmap_captures_used;
-					lightmap_captures_used++;
+					inst->gi_offset_cache = capture_index;
 					uses_lightmap = true;
 				}
 
 			} else {
-				if (p_using_opaque_gi) {
+				if (p_data->using_opaque_gi) {
 					flags |= INSTANCE_DATA_FLAG_USE_GI_BUFFERS;
 				}
 
@@ -1045,7 +1023,7 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 					flags |= INSTANCE_DATA_FLAG_USE_VOXEL_GI;
 					uses_gi = true;
 				} else {
-					if (p_using_sdfgi && inst->can_sdfgi) {
+					if (p_data->using_sdfgi && inst->can_sdfgi) {
 						flags |= INSTANCE_DATA_FLAG_USE_SDFGI;
 						uses_gi = true;
 					}
@@ -1063,13 +1041,13 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 
 			// LOD
 
-			if (p_render_data->screen_mesh_lod_threshold > 0.0 && storage->mesh_surface_has_lod(surf->surface)) {
+			if (render_data->screen_mesh_lod_threshold > 0.0 && storage->mesh_surface_has_lod(surf->surface)) {
 				//lod
-				Vector3 lod_support_min = inst->transformed_aabb.get_support(-p_render_data->lod_camera_plane.normal);
-				Vector3 lod_support_max = inst->transformed_aabb.get_support(p_render_data->lod_camera_plane.normal);
+				Vector3 lod_support_min = inst->transformed_aabb.get_support(-render_data->lod_camera_plane.normal);
+				Vector3 lod_support_max = inst->transformed_aabb.get_support(render_data->lod_camera_plane.normal);
 
-				float distance_min = p_render_data->lod_camera_plane.distance_to(lod_support_min);
-				float distance_max = p_render_data->lod_camera_plane.distance_to(lod_support_max);
+				float distance_min = render_data->lod_camera_plane.distance_to(lod_support_min);
+				float distance_max = render_data->lod_camera_plane.distance_to(lod_support_max);
 
 				float distance = 0.0;
 
@@ -1082,36 +1060,25 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 					distance = -distance_max;
 				}
 
-				if (p_render_data->cam_ortogonal) {
+				if (render_data->cam_ortogonal) {
 					distance = 1.0;
 				}
 
 				uint32_t indices;
-				surf->sort.lod_index = storage->mesh_surface_get_lod(surf->surface, inst->lod_model_scale * inst->lod_bias, distance * p_render_data->lod_distance_multiplier, p_render_data->screen_mesh_lod_threshold, &indices);
-				if (p_render_data->render_info) {
+				surf->sort.lod_index = storage->mesh_surface_get_lod(surf->surface, inst->lod_model_scale * inst->lod_bias, distance * render_data->lod_distance_multiplier, render_data->screen_mesh_lod_threshold, &indices);
+				if (render_data->render_info) {
 					indices = _indices_to_primitives(surf->primitive, indices);
-					if (p_render_list == RENDER_LIST_OPAQUE) { //opaque
-						p_render_data->render_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_VISIBLE][RS::VIEWPORT_RENDER_INFO_PRIMITIVES_IN_FRAME] += indices;
-					} else if (p_render_list == RENDER_LIST_SECONDARY) { //shadow
-						p_render_data->render_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_SHADOW][RS::VIEWPORT_RENDER_INFO_PRIMITIVES_IN_FRAME] += indices;
-					}
+					r_stats.primitives_in_frame += indices;
 				}
 			} else {
 				surf->sort.lod_index = 0;
-				if (p_render_data->render_info) {
-					uint32_t to_draw = storage->mesh_surface_get_vertices_drawn_count(surf->surface);
-					to_draw = _indices_to_primitives(surf->primitive, to_draw);
-					to_draw *= inst->instance_count;
-					if (p_render_list == RENDER_LIST_OPAQUE) { //opaque
-						p_render_data->render_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_VISIBLE][RS::VIEWPORT_RENDER_INFO_PRIMITIVES_IN_FRAME] += storage->mesh_surface_get_vertices_drawn_count(surf->surface);
-					} else if (p_render_list == RENDER_LIST_SECONDARY) { //shadow
-						p_render_data->render_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_SHADOW][RS::VIEWPORT_RENDER_INFO_PRIMITIVES_IN_FRAME] += storage->mesh_surface_get_vertices_drawn_count(surf->surface);
-					}
+				if (render_data->render_info) {
+					r_stats.primitives_in_frame += storage->mesh_surface_get_vertices_drawn_count(surf->surface);
 				}
 			}
 
 			// ADD Element
-			if (p_pass_mode == PASS_MODE_COLOR) {
+			if (p_data->pass_mode == PASS_MODE_COLOR) {
 #ifdef DEBUG_ENABLED
 				bool force_alpha = unlikely(get_debug_draw_mode() == RS::VIEWPORT_DEBUG_DRAW_OVERDRAW);
 #else
@@ -1123,10 +1090,10 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 				}
 
 				if (!force_alpha && (surf->flags & (GeometryInstanceSurfaceDataCache::FLAG_PASS_DEPTH | GeometryInstanceSurfaceDataCache::FLAG_PASS_OPAQUE))) {
-					rl->add_element(surf);
+					r_elements.push_back(surf);
 				}
 				if (force_alpha || (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_PASS_ALPHA)) {
-					render_list[RENDER_LIST_ALPHA].add_element(surf);
+					r_alpha_elements.push_back(surf);
 					if (uses_gi) {
 						surf->sort.uses_forward_gi = 1;
 					}
@@ -1137,25 +1104,25 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 				}
 
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SUBSURFACE_SCATTERING) {
-					scene_state.used_sss = true;
+					r_stats.used_sss = true;
 				}
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SCREEN_TEXTURE) {
-					scene_state.used_screen_texture = true;
+					r_stats.used_screen_texture = true;
 				}
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_NORMAL_TEXTURE) {
-					scene_state.used_normal_texture = true;
+					r_stats.used_normal_texture = true;
 				}
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_DEPTH_TEXTURE) {
-					scene_state.used_depth_texture = true;
+					r_stats.used_depth_texture = true;
 				}
 
-			} else if (p_pass_mode == PASS_MODE_SHADOW || p_pass_mode == PASS_MODE_SHADOW_DP) {
+			} else if (p_data->pass_mode == PASS_MODE_SHADOW || p_data->pass_mode == PASS_MODE_SHADOW_DP) {
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_PASS_SHADOW) {
-					rl->add_element(surf);
+					r_elements.push_back(surf);
 				}
 			} else {
 				if (surf->flags & (GeometryInstanceSurfaceDataCache::FLAG_PASS_DEPTH | GeometryInstanceSurfaceDataCache::FLAG_PASS_OPAQUE)) {
-					rl->add_element(surf);
+					r_elements.push_back(surf);
 				}
 			}
 
@@ -1164,7 +1131,96 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 			surf = surf->next;
 		}
 	}
+}
+
+void RenderForwardClustered::_fill_render_list_thread_function(uint32_t p_thread, RenderListFillData *p_data) {
+	uint32_t fill_total = p_data->render_data->instances->size();
+	uint32_t total_threads = RendererThreadPool::singleton->thread_work_pool.get_thread_count();
+	uint32_t fill_from = p_thread * fill_total / total_threads;
+	uint32_t fill_to = (p_thread + 1 == total_threads) ? fill_total : ((p_thread + 1) * fill_total / total_threads);
+
+	RenderListFillThread &thread = render_list_fill_threads[p_thread];
+	thread.elements.clear();
+	thread.alpha_elements.clear();
+	thread.stats = RenderListFillStats();
+	_fill_render_list_range(p_data, fill_from, fill_to, thread.elements, thread.alpha_elements, thread.stats);
+}
+
+void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_using_sdfgi, bool p_using_opaque_gi, bool p_append) {
+	if (p_render_list == RENDER_LIST_OPAQUE) {
+		scene_state.used_sss = false;
+		scene_state.used_screen_texture = false;
+		scene_state.used_normal_texture = false;
+		scene_state.used_depth_texture = false;
+	}
+
+	RenderListFillData fill_data;
+	fill_data.render_list = p_render_list;
+	fill_data.render_data = p_render_data;
+	fill_data.pass_mode = p_pass_mode;
+	fill_data.using_sdfgi = p_using_sdfgi;
+	fill_data.using_opaque_gi = p_using_opaque_gi;
+	fill_data.near_plane = Plane(-p_render_data->cam_transform.basis.get_axis(Vector3::AXIS_Z), p_render_data->cam_transform.origin);
+	fill_data.near_plane.d += p_render_data->cam_projection.get_z_near();
+	fill_data.z_max = p_render_data->cam_projection.get_z_far() - p_render_data->cam_projection.get_z_near();
+
+	RenderList *rl = &render_list[p_render_list];
+	_update_dirty_geometry_instances();
+
+	if (!p_append) {
+		rl->clear();
+		if (p_render_list == RENDER_LIST_OPAQUE) {
+			render_list[RENDER_LIST_ALPHA].clear(); //opaque fills alpha too
+		}
+	}
+
+	//fill list
+
+	RenderListFillStats stats;
+	uint32_t total_threads = RendererThreadPool::singleton->thread_work_pool.get_thread_count();
+	if (p_render_data->instances->size() >= render_list_fill_thread_threshold && total_threads > 1) {
+		render_list_fill_threads.resize(total_threads);
+		RendererThreadPool::singleton->thread_work_pool.do_work(total_threads, this, &RenderForwardClustered::_fill_render_list_thread_function, &fill_data);
+
+		// Threads got contiguous ranges of instances, so this keeps the single threaded order.
+		for (uint32_t i = 0; i < total_threads; i++) {
+			const RenderListFillThread &thread = render_list_fill_threads[i];
+			rl->add_elements(thread.elements);
+			render_list[RENDER_LIST_ALPHA].add_elements(thread.alpha_elements);
+
+			stats.primitives_in_frame += thread.stats.primitives_in_frame;
+			stats.used_sss = stats.used_sss || thread.stats.used_sss;
+			stats.used_screen_texture = stats.used_screen_texture || thread.stats.used_screen_texture;
+			stats.used_normal_texture = stats.used_normal_texture || thread.stats.used_normal_texture;
+			stats.used_depth_texture = stats.used_depth_texture || thread.stats.used_depth_texture;
+		}
+	} else {
+		_fill_render_list_range(&fill_data, 0, p_render_data->instances->size(), rl->elements, render_list[RENDER_LIST_ALPHA].elements, stats);
+	}
+
+	if (p_render_data->render_info) {
+		if (p_render_list == RENDER_LIST_OPAQUE) { //opaque
+			p_render_data->render_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_VISIBLE][RS::VIEWPORT_RENDER_INFO_PRIMITIVES_IN_FRAME] += stats.primitives_in_frame;
+		} else if (p_render_list == RENDER_LIST_SECONDARY) { //shadow
+			p_render_data->render_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_SHADOW][RS::VIEWPORT_RENDER_INFO_PRIMITIVES_IN_FRAME] += stats.primitives_in_frame;
+		}
+	}
+
+	if (stats.used_sss) {
+		scene_state.used_sss = true;
+	}
+	if (stats.used_screen_texture) {
+		scene_state.used_screen_texture = true;
+	}
+	if (stats.used_normal_texture) {
+		scene_state.used_normal_texture = true;
+	}
+	if (stats.used_depth_texture) {
+		scene_state.used_depth_texture = true;
+	}
 
+	// Instances past the limit got a capture index but no capture.
+	uint32_t lightmap_captures_used = MIN(fill_data.lightmap_captures_used.get(), scene_state.max_lightmap_captures);
 	if (p_render_list == RENDER_LIST_OPAQUE && lightmap_captures_used) {
 		RD::get_singleton()->buffer_update(scene_state.lightmap_capture_buffer, 0, sizeof(LightmapCaptureData) * lightmap_captures_used, scene_state.lightmap_captures, RD::BARRIER_MASK_RASTER);
 	}
@@ -3211,6 +3267,7 @@ RenderForwardClustered::RenderForwardClustered(RendererStorageRD *p_storage) :
 	}
 
 	render_list_thread_threshold = GLOBAL_GET("rendering/limits/forward_renderer/threaded_render_minimum_instances");
+	render_list_fill_thread_threshold = GLOBAL_GET("rendering/limits/forward_renderer/threaded_fill_minimum_instances");
 
 	_update_shader_quality_settings();
 }
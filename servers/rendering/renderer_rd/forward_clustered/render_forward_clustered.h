@@ -32,6 +32,7 @@
 #define RENDERING_SERVER_SCENE_RENDER_FORWARD_CLUSTERED_H
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
 #include "servers/rendering/renderer_rd/forward_clustered/scene_shader_forward_clustered.h"
 #include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
 #include "servers/rendering/renderer_rd/renderer_scene_render_rd.h"
@@ -541,22 +542,21 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 			element_info.clear();
 		}
 
-		//should eventually be replaced by radix
-
-		struct SortByKey {
-			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
-				return (A->sort.sort_key2 == B->sort.sort_key2) ? (A->sort.sort_key1 < B->sort.sort_key1) : (A->sort.sort_key2 < B->sort.sort_key2);
+		struct SortKeyGetter {
+			_FORCE_INLINE_ void operator()(const GeometryInstanceSurfaceDataCache *p_element, uint64_t &r_high, uint64_t &r_low) const {
+				r_high = p_element->sort.sort_key2;
+				r_low = p_element->sort.sort_key1;
 			}
 		};
 
-		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
-		}
+		RadixSort<GeometryInstanceSurfaceDataCache *, SortKeyGetter> key_sorter;
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr() + p_from, p_size);
+			key_sorter.sort(elements.ptr() + p_from, p_size);
+		}
+
+		void sort_by_key() {
+			sort_by_key_range(0, elements.size());
 		}
 
 		struct SortByDepth {
@@ -586,10 +586,48 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 		_FORCE_INLINE_ void add_element(GeometryInstanceSurfaceDataCache *p_element) {
 			elements.push_back(p_element);
 		}
+
+		void add_elements(const LocalVector<GeometryInstanceSurfaceDataCache *> &p_elements) {
+			uint32_t from = elements.size();
+			elements.resize(from + p_elements.size());
+			memcpy(elements.ptr() + from, p_elements.ptr(), p_elements.size() * sizeof(GeometryInstanceSurfaceDataCache *));
+		}
 	};
 
 	RenderList render_list[RENDER_LIST_MAX];
 
+	struct RenderListFillData {
+		RenderListType render_list = RENDER_LIST_OPAQUE;
+		const RenderDataRD *render_data = nullptr;
+		PassMode pass_mode = PASS_MODE_COLOR;
+		bool using_sdfgi = false;
+		bool using_opaque_gi = false;
+		Plane near_plane;
+		float z_max = 0.0;
+		SafeNumeric<uint32_t> lightmap_captures_used;
+	};
+
+	struct RenderListFillStats {
+		uint64_t primitives_in_frame = 0;
+		bool used_sss = false;
+		bool used_screen_texture = false;
+		bool used_normal_texture = false;
+		bool used_depth_texture = false;
+	};
+
+	// Each thread fills its own lists, they are appended in thread order afterwards.
+	struct RenderListFillThread {
+		LocalVector<GeometryInstanceSurfaceDataCache *> elements;
+		LocalVector<GeometryInstanceSurfaceDataCache *> alpha_elements;
+		RenderListFillStats stats;
+	};
+
+	LocalVector<RenderListFillThread> render_list_fill_threads;
+	uint32_t render_list_fill_thread_threshold = 1000;
+
+	void _fill_render_list_range(RenderListFillData *p_data, uint32_t p_from, uint32_t p_to, LocalVector<GeometryInstanceSurfaceDataCache *> &r_elements, LocalVector<GeometryInstanceSurfaceDataCache *> &r_alpha_elements, RenderListFillStats &r_stats);
+	void _fill_render_list_thread_function(uint32_t p_thread, RenderListFillData *p_data);
+
 	virtual void _update_shader_quality_settings() override;
 
 protected:
@@ -270,6 +270,7 @@ RendererCompositorRD::RendererCompositorRD() {
 					ShaderRD::set_shader_cache_save_compressed(compress);
 					ShaderRD::set_shader_cache_save_compressed_zstd(use_zstd);
 					ShaderRD::set_shader_cache_save_debug(!strip_debug);
+					ShaderCompiler::set_shader_cache_dir(shader_cache_dir);
 				}
 			}
 		}
@@ -299,4 +300,5 @@ RendererCompositorRD::RendererCompositorRD() {
 
 RendererCompositorRD::~RendererCompositorRD() {
 	ShaderRD::set_shader_cache_dir(String());
+	ShaderCompiler::set_shader_cache_dir(String());
 }
@@ -4368,6 +4368,43 @@ void RendererStorageRD::multimesh_set_buffer(RID p_multimesh, const Vector<float
 	}
 }
 
+void RendererStorageRD::multimesh_set_buffer_range(RID p_multimesh, int p_instance_offset, int p_instance_count, const Vector<float> &p_buffer) {
+	MultiMesh *multimesh = multimesh_owner.get_or_null(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+	// Checked against the instances left after the offset, `p_instance_offset + p_instance_count` could overflow.
+	ERR_FAIL_COND(p_instance_offset < 0 || p_instance_count < 0 || p_instance_count > multimesh->instances - p_instance_offset);
+	ERR_FAIL_COND(p_buffer.size() != (p_instance_count * (int)multimesh->stride_cache));
+
+	if (p_instance_count == 0) {
+		return;
+	}
+
+	if (multimesh->data_cache.size() || !multimesh->buffer_set) {
+		// Keep the local copy in sync, dirty regions are uploaded (coalesced) when updating multimeshes.
+		_multimesh_make_local(multimesh);
+
+		float *w = multimesh->data_cache.ptrw();
+		memcpy(w + p_instance_offset * multimesh->stride_cache, p_buffer.ptr(), p_buffer.size() * sizeof(float));
+
+		uint32_t region_from = p_instance_offset / MULTIMESH_DIRTY_REGION_SIZE;
+		uint32_t region_to = (p_instance_offset + p_instance_count - 1) / MULTIMESH_DIRTY_REGION_SIZE;
+		for (uint32_t i = region_from; i <= region_to; i++) {
+			_multimesh_mark_dirty(multimesh, i * MULTIMESH_DIRTY_REGION_SIZE, true);
+		}
+	} else {
+		// Data only lives on the GPU, upload the range straight from the buffer instead of reading everything back.
+		RD::get_singleton()->buffer_update(multimesh->buffer, p_instance_offset * multimesh->stride_cache * sizeof(float), p_buffer.size() * sizeof(float), p_buffer.ptr());
+
+		if (multimesh->mesh.is_valid()) {
+			// Without the rest of the data the AABB can only grow.
+			AABB aabb = multimesh->aabb;
+			_multimesh_re_create_aabb(multimesh, p_buffer.ptr(), p_instance_count);
+			multimesh->aabb.merge_with(aabb);
+			multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_AABB);
+		}
+	}
+}
+
 Vector<float> RendererStorageRD::multimesh_get_buffer(RID p_multimesh) const {
 	MultiMesh *multimesh = multimesh_owner.get_or_null(p_multimesh);
 	ERR_FAIL_COND_V(!multimesh, Vector<float>());
@@ -4439,17 +4476,29 @@ void RendererStorageRD::_update_dirty_multimeshes() {
 
 				uint32_t region_size = multimesh->stride_cache * MULTIMESH_DIRTY_REGION_SIZE * sizeof(float);
 
-				if (multimesh->data_cache_used_dirty_regions > 32 || multimesh->data_cache_used_dirty_regions > visible_region_count / 2) {
+				// Adjacent dirty regions are uploaded together, so count the uploads that would be needed.
+				uint32_t dirty_region_runs = 0;
+				for (uint32_t i = 0; i < visible_region_count; i++) {
+					if (multimesh->data_cache_dirty_regions[i] && (i == 0 || !multimesh->data_cache_dirty_regions[i - 1])) {
+						dirty_region_runs++;
+					}
+				}
+
+				if (dirty_region_runs > 32 || multimesh->data_cache_used_dirty_regions > visible_region_count / 2) {
 					//if there too many dirty regions, or represent the majority of regions, just copy all, else transfer cost piles up too much
 					RD::get_singleton()->buffer_update(multimesh->buffer, 0, MIN(visible_region_count * region_size, multimesh->instances * (uint32_t)multimesh->stride_cache * (uint32_t)sizeof(float)), data);
 				} else {
 					//not that many regions? update them all
+					uint32_t size = multimesh->stride_cache * (uint32_t)multimesh->instances * (uint32_t)sizeof(float);
 					for (uint32_t i = 0; i < visible_region_count; i++) {
 						if (multimesh->data_cache_dirty_regions[i]) {
-							uint32_t offset = i * region_size;
-							uint32_t size = multimesh->stride_cache * (uint32_t)multimesh->instances * (uint32_t)sizeof(float);
-							uint32_t region_start_index = multimesh->stride_cache * MULTIMESH_DIRTY_REGION_SIZE * i;
-							RD::get_singleton()->buffer_update(multimesh->buffer, offset, MIN(region_size, size - offset), &data[region_start_index]);
+							uint32_t region_from = i;
+							while (i + 1 < visible_region_count && multimesh->data_cache_dirty_regions[i + 1]) {
+								i++;
+							}
+							uint32_t offset = region_from * region_size;
+							uint32_t region_start_index = multimesh->stride_cache * MULTIMESH_DIRTY_REGION_SIZE * region_from;
+							RD::get_singleton()->buffer_update(multimesh->buffer, offset, MIN((i - region_from + 1) * region_size, size - offset), &data[region_start_index]);
 						}
 					}
 				}
@@ -1722,6 +1722,7 @@ public:
 	Color multimesh_instance_get_custom_data(RID p_multimesh, int p_index) const;
 
 	void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer);
+	void multimesh_set_buffer_range(RID p_multimesh, int p_instance_offset, int p_instance_count, const Vector<float> &p_buffer);
 	Vector<float> multimesh_get_buffer(RID p_multimesh) const;
 
 	void multimesh_set_visible_instances(RID p_multimesh, int p_visible);
@@ -217,6 +217,9 @@ public:
 	virtual void render_probes() = 0;
 	virtual void update_visibility_notifiers() = 0;
 
+	virtual uint64_t get_indexer_updates_in_frame() const = 0;
+	virtual uint64_t get_indexer_update_usec_in_frame() const = 0;
+
 	virtual void decals_set_filter(RS::DecalFilter p_filter) = 0;
 	virtual void light_projectors_set_filter(RS::LightProjectorFilter p_filter) = 0;
 
@@ -32,11 +32,20 @@
 
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
+#include "renderer_scene_occlusion_cull_raster.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
 
 #include <new>
 
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CULL_USE_SSE
+#include <emmintrin.h>
+#elif !defined(REAL_T_IS_DOUBLE) && defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define CULL_USE_NEON
+#include <arm_neon.h>
+#endif
+
 /* CAMERA API */
 
 RID RendererSceneCull::camera_allocate() {
@@ -1703,10 +1712,14 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		p_instance->scenario->instance_aabbs.push_back(InstanceBounds(p_instance->transformed_aabb));
 		_update_instance_visibility_dependencies(p_instance);
 	} else {
+		bool changed;
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-			p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].update(p_instance->indexer_id, bvh_aabb);
+			changed = p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].update_deferred(p_instance->indexer_id, bvh_aabb);
 		} else {
-			p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].update(p_instance->indexer_id, bvh_aabb);
+			changed = p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].update_deferred(p_instance->indexer_id, bvh_aabb);
+		}
+		if (changed) {
+			indexer_updates++;
 		}
 		p_instance->scenario->instance_aabbs[p_instance->array_index] = InstanceBounds(p_instance->transformed_aabb);
 	}
@@ -1715,54 +1728,80 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		p_instance->scenario->instance_visibility[p_instance->visibility_index].position = p_instance->transformed_aabb.get_center();
 	}
 
-	//move instance and repair
-	pair_pass++;
+	p_instance->prev_transformed_aabb = p_instance->transformed_aabb;
 
-	PairInstances pair;
+	// Pairing queries the indexers, so it has to wait until they are refitted.
+	if (p_instance->pair_queue_index == -1) {
+		p_instance->pair_queue_index = instance_pair_queue.size();
+		instance_pair_queue.push_back(p_instance);
+	}
+}
 
-	pair.instance = p_instance;
-	pair.pair_allocator = &pair_allocator;
-	pair.pair_pass = pair_pass;
-	pair.pair_mask = 0;
+void RendererSceneCull::_pair_queued_instances() {
+	uint64_t time_usec = OS::get_singleton()->get_ticks_usec();
 
-	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-		pair.pair_mask |= 1 << RS::INSTANCE_LIGHT;
-		pair.pair_mask |= 1 << RS::INSTANCE_VOXEL_GI;
-		pair.pair_mask |= 1 << RS::INSTANCE_LIGHTMAP;
-		if (p_instance->base_type == RS::INSTANCE_PARTICLES) {
-			pair.pair_mask |= 1 << RS::INSTANCE_PARTICLES_COLLISION;
-		}
+	ThreadWorkPool *thread_pool = &RendererThreadPool::singleton->thread_work_pool;
+	for (uint32_t i = 0; i < instance_pair_queue.size(); i++) {
+		Scenario *scenario = instance_pair_queue[i]->scenario;
+		scenario->indexers[Scenario::INDEXER_GEOMETRY].refit(thread_pool);
+		scenario->indexers[Scenario::INDEXER_VOLUMES].refit(thread_pool);
+	}
+
+	indexer_update_usec += OS::get_singleton()->get_ticks_usec() - time_usec;
 
-		pair.pair_mask |= geometry_instance_pair_mask;
+	for (uint32_t i = 0; i < instance_pair_queue.size(); i++) {
+		Instance *instance = instance_pair_queue[i];
+		instance->pair_queue_index = -1;
 
-		pair.bvh2 = &p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES];
-	} else if (p_instance->base_type == RS::INSTANCE_LIGHT) {
-		pair.pair_mask |= RS::INSTANCE_GEOMETRY_MASK;
-		pair.bvh = &p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
+		//move instance and repair
+		pair_pass++;
 
-		if (RSG::storage->light_get_bake_mode(p_instance->base) == RS::LIGHT_BAKE_DYNAMIC) {
-			pair.pair_mask |= (1 << RS::INSTANCE_VOXEL_GI);
-			pair.bvh2 = &p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES];
+		PairInstances pair;
+
+		pair.instance = instance;
+		pair.pair_allocator = &pair_allocator;
+		pair.pair_pass = pair_pass;
+		pair.pair_mask = 0;
+
+		if ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
+			pair.pair_mask |= 1 << RS::INSTANCE_LIGHT;
+			pair.pair_mask |= 1 << RS::INSTANCE_VOXEL_GI;
+			pair.pair_mask |= 1 << RS::INSTANCE_LIGHTMAP;
+			if (instance->base_type == RS::INSTANCE_PARTICLES) {
+				pair.pair_mask |= 1 << RS::INSTANCE_PARTICLES_COLLISION;
+			}
+
+			pair.pair_mask |= geometry_instance_pair_mask;
+
+			pair.bvh2 = &instance->scenario->indexers[Scenario::INDEXER_VOLUMES];
+		} else if (instance->base_type == RS::INSTANCE_LIGHT) {
+			pair.pair_mask |= RS::INSTANCE_GEOMETRY_MASK;
+			pair.bvh = &instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
+
+			if (RSG::storage->light_get_bake_mode(instance->base) == RS::LIGHT_BAKE_DYNAMIC) {
+				pair.pair_mask |= (1 << RS::INSTANCE_VOXEL_GI);
+				pair.bvh2 = &instance->scenario->indexers[Scenario::INDEXER_VOLUMES];
+			}
+		} else if (geometry_instance_pair_mask & (1 << RS::INSTANCE_REFLECTION_PROBE) && (instance->base_type == RS::INSTANCE_REFLECTION_PROBE)) {
+			pair.pair_mask = RS::INSTANCE_GEOMETRY_MASK;
+			pair.bvh = &instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
+		} else if (geometry_instance_pair_mask & (1 << RS::INSTANCE_DECAL) && (instance->base_type == RS::INSTANCE_DECAL)) {
+			pair.pair_mask = RS::INSTANCE_GEOMETRY_MASK;
+			pair.bvh = &instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
+		} else if (instance->base_type == RS::INSTANCE_PARTICLES_COLLISION) {
+			pair.pair_mask = (1 << RS::INSTANCE_PARTICLES);
+			pair.bvh = &instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
+		} else if (instance->base_type == RS::INSTANCE_VOXEL_GI) {
+			//lights and geometries
+			pair.pair_mask = RS::INSTANCE_GEOMETRY_MASK | (1 << RS::INSTANCE_LIGHT);
+			pair.bvh = &instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
+			pair.bvh2 = &instance->scenario->indexers[Scenario::INDEXER_VOLUMES];
 		}
-	} else if (geometry_instance_pair_mask & (1 << RS::INSTANCE_REFLECTION_PROBE) && (p_instance->base_type == RS::INSTANCE_REFLECTION_PROBE)) {
-		pair.pair_mask = RS::INSTANCE_GEOMETRY_MASK;
-		pair.bvh = &p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
-	} else if (geometry_instance_pair_mask & (1 << RS::INSTANCE_DECAL) && (p_instance->base_type == RS::INSTANCE_DECAL)) {
-		pair.pair_mask = RS::INSTANCE_GEOMETRY_MASK;
-		pair.bvh = &p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
-	} else if (p_instance->base_type == RS::INSTANCE_PARTICLES_COLLISION) {
-		pair.pair_mask = (1 << RS::INSTANCE_PARTICLES);
-		pair.bvh = &p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
-	} else if (p_instance->base_type == RS::INSTANCE_VOXEL_GI) {
-		//lights and geometries
-		pair.pair_mask = RS::INSTANCE_GEOMETRY_MASK | (1 << RS::INSTANCE_LIGHT);
-		pair.bvh = &p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY];
-		pair.bvh2 = &p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES];
-	}
 
-	pair.pair();
+		pair.pair();
+	}
 
-	p_instance->prev_transformed_aabb = p_instance->transformed_aabb;
+	instance_pair_queue.clear();
 }
 
 void RendererSceneCull::_unpair_instance(Instance *p_instance) {
@@ -1770,6 +1809,14 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 		return; //nothing to do
 	}
 
+	if (p_instance->pair_queue_index != -1) {
+		instance_pair_queue.remove_at_unordered(p_instance->pair_queue_index);
+		if ((uint32_t)p_instance->pair_queue_index < instance_pair_queue.size()) {
+			instance_pair_queue[p_instance->pair_queue_index]->pair_queue_index = p_instance->pair_queue_index;
+		}
+		p_instance->pair_queue_index = -1;
+	}
+
 	while (p_instance->pairs.first()) {
 		InstancePair *pair = p_instance->pairs.first()->self();
 		Instance *other_instance = p_instance == pair->a ? pair->b : pair->a;
@@ -2612,6 +2659,152 @@ bool RendererSceneCull::_visibility_parent_check(const CullData &p_cull_data, co
 	return ((parent_flags & InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK) == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE) || (parent_flags & InstanceData::FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN);
 }
 
+void RendererSceneCull::InstanceBoundsBlock::load(const PagedArray<InstanceBounds> &p_instance_aabbs, uint64_t p_from, uint32_t p_count) {
+	count = p_count;
+	const InstanceBounds *first = &p_instance_aabbs[p_from];
+	if (p_count > 0 && &p_instance_aabbs[p_from + p_count - 1] == first + p_count - 1) {
+		// Whole block in the same page.
+		for (uint32_t i = 0; i < p_count; i++) {
+			for (uint32_t j = 0; j < 6; j++) {
+				bounds[j][i] = first[i].bounds[j];
+			}
+		}
+	} else {
+		for (uint32_t i = 0; i < p_count; i++) {
+			const real_t *instance_bounds = p_instance_aabbs[p_from + i].bounds;
+			for (uint32_t j = 0; j < 6; j++) {
+				bounds[j][i] = instance_bounds[j];
+			}
+		}
+	}
+	// Pad up to the SIMD width so the last lanes test valid numbers.
+	for (uint32_t i = p_count; i < ((p_count + 3) & ~3) && i < SIZE; i++) {
+		for (uint32_t j = 0; j < 6; j++) {
+			bounds[j][i] = 0;
+		}
+	}
+}
+
+uint64_t RendererSceneCull::InstanceBoundsBlock::in_frustum(const Frustum &p_frustum, uint64_t p_mask) const {
+	// Same test as InstanceBounds::in_frustum(), one plane at a time for the whole block.
+	const uint64_t count_mask = count == SIZE ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+	const uint64_t mask = p_mask & count_mask;
+	uint64_t outside = 0;
+
+	for (uint32_t i = 0; i < p_frustum.plane_count && (outside & mask) != mask; i++) {
+		const Plane &plane = p_frustum.planes_ptr[i];
+		const real_t *x = bounds[p_frustum.plane_signs_ptr[i].signs[0]];
+		const real_t *y = bounds[p_frustum.plane_signs_ptr[i].signs[1]];
+		const real_t *z = bounds[p_frustum.plane_signs_ptr[i].signs[2]];
+
+#if defined(CULL_USE_SSE)
+		const __m128 nx = _mm_set1_ps(plane.normal.x);
+		const __m128 ny = _mm_set1_ps(plane.normal.y);
+		const __m128 nz = _mm_set1_ps(plane.normal.z);
+		const __m128 d = _mm_set1_ps(plane.d);
+		const __m128 zero = _mm_setzero_ps();
+		for (uint32_t j = 0; j < count; j += 4) {
+			__m128 distance = _mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(x + j)), _mm_mul_ps(ny, _mm_load_ps(y + j)));
+			distance = _mm_sub_ps(_mm_add_ps(distance, _mm_mul_ps(nz, _mm_load_ps(z + j))), d);
+			outside |= uint64_t(_mm_movemask_ps(_mm_cmpge_ps(distance, zero))) << j;
+		}
+#elif defined(CULL_USE_NEON)
+		static const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+		const uint32x4_t lane_bits_v = vld1q_u32(lane_bits);
+		const float32x4_t nx = vdupq_n_f32(plane.normal.x);
+		const float32x4_t ny = vdupq_n_f32(plane.normal.y);
+		const float32x4_t nz = vdupq_n_f32(plane.normal.z);
+		const float32x4_t d = vdupq_n_f32(plane.d);
+		const float32x4_t zero = vdupq_n_f32(0.0f);
+		for (uint32_t j = 0; j < count; j += 4) {
+			float32x4_t distance = vaddq_f32(vmulq_f32(nx, vld1q_f32(x + j)), vmulq_f32(ny, vld1q_f32(y + j)));
+			distance = vsubq_f32(vaddq_f32(distance, vmulq_f32(nz, vld1q_f32(z + j))), d);
+			outside |= uint64_t(vaddvq_u32(vandq_u32(vcgeq_f32(distance, zero), lane_bits_v))) << j;
+		}
+#else
+		for (uint32_t j = 0; j < count; j++) {
+			const real_t distance = plane.normal.x * x[j] + plane.normal.y * y[j] + plane.normal.z * z[j] - plane.d;
+			outside |= uint64_t(distance >= 0.0) << j;
+		}
+#endif
+	}
+
+	return mask & ~outside;
+}
+
+uint64_t RendererSceneCull::InstanceBoundsBlock::in_aabb(const AABB &p_aabb, uint64_t p_mask) const {
+	// Same test as InstanceBounds::in_aabb(), branchless so the compiler can vectorize it.
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	uint64_t inside = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const bool overlaps = (bounds[0][i] < end.x) & (bounds[3][i] > p_aabb.position.x) &
+				(bounds[1][i] < end.y) & (bounds[4][i] > p_aabb.position.y) &
+				(bounds[2][i] < end.z) & (bounds[5][i] > p_aabb.position.z);
+		inside |= uint64_t(overlaps) << i;
+	}
+
+	return p_mask & inside;
+}
+
+uint64_t RendererSceneCull::_scene_cull_block(CullData &cull_data, InstanceBoundsBlock &r_block, uint64_t p_from, uint32_t p_count, uint64_t &r_frustum_mask) {
+	// Find which instances of the block can have any work to do in _scene_cull(),
+	// with a first pass over their flags and a vectorized pass over their bounds.
+	uint64_t camera_mask = 0;
+	uint64_t forced_mask = 0;
+	uint64_t shadow_mask = 0;
+	uint64_t sdfgi_mask = 0;
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		const InstanceData &idata = cull_data.scenario->instance_data[p_from + i];
+		const uint64_t bit = uint64_t(1) << i;
+		const uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
+		const bool is_geometry = ((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) != 0;
+
+		if ((base_type == RS::INSTANCE_LIGHT) || (is_geometry && (idata.flags & InstanceData::FLAG_USES_BAKED_LIGHT))) {
+			sdfgi_mask |= bit;
+		}
+
+		const uint32_t visibility_flags = idata.flags & (InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE | InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN | InstanceData::FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN);
+		if (visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE || visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN) {
+			continue;
+		}
+
+		if (idata.flags & InstanceData::FLAG_IGNORE_ALL_CULLING) {
+			forced_mask |= bit;
+		}
+		if (cull_data.visible_layers & idata.layer_mask) {
+			camera_mask |= bit;
+		}
+		if (is_geometry && (idata.flags & InstanceData::FLAG_CAST_SHADOWS)) {
+			shadow_mask |= bit;
+		}
+	}
+
+	if (!(camera_mask | shadow_mask | sdfgi_mask)) {
+		r_frustum_mask = 0;
+		return forced_mask;
+	}
+
+	r_block.load(cull_data.scenario->instance_aabbs, p_from, p_count);
+
+	r_frustum_mask = camera_mask ? r_block.in_frustum(cull_data.cull->frustum, camera_mask) : 0;
+	uint64_t candidate_mask = forced_mask | r_frustum_mask;
+
+	// Shadows and SDFGI are tested again per instance, this only needs to know if any of them passes.
+	for (uint32_t i = 0; i < cull_data.cull->shadow_count && (shadow_mask & ~candidate_mask); i++) {
+		for (uint32_t j = 0; j < cull_data.cull->shadows[i].cascade_count && (shadow_mask & ~candidate_mask); j++) {
+			candidate_mask |= r_block.in_frustum(cull_data.cull->shadows[i].cascades[j].frustum, shadow_mask & ~candidate_mask);
+		}
+	}
+
+	for (uint32_t i = 0; i < cull_data.cull->sdfgi.region_count && (sdfgi_mask & ~candidate_mask); i++) {
+		candidate_mask |= r_block.in_aabb(cull_data.cull->sdfgi.region_aabb[i], sdfgi_mask & ~candidate_mask);
+	}
+
+	return candidate_mask;
+}
+
 void RendererSceneCull::_scene_cull_threaded(uint32_t p_thread, CullData *cull_data) {
 	uint32_t cull_total = cull_data->scenario->instance_data.size();
 	uint32_t total_threads = RendererThreadPool::singleton->thread_work_pool.get_thread_count();
@@ -2633,7 +2826,25 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 	Transform3D inv_cam_transform = cull_data.cam_transform.inverse();
 	float z_near = cull_data.camera_matrix->get_z_near();
 
+	InstanceBoundsBlock block;
+	uint64_t block_from = p_from;
+	uint64_t block_to = p_from;
+	uint64_t candidate_mask = 0;
+	uint64_t frustum_mask = 0;
+
 	for (uint64_t i = p_from; i < p_to; i++) {
+		if (i == block_to) {
+			block_from = i;
+			block_to = MIN(p_to, i + InstanceBoundsBlock::SIZE);
+			candidate_mask = _scene_cull_block(cull_data, block, block_from, block_to - block_from, frustum_mask);
+		}
+
+		const uint64_t block_bit = uint64_t(1) << (i - block_from);
+		if (!(candidate_mask & block_bit)) {
+			// Outside of everything, or hidden.
+			continue;
+		}
+
 		bool mesh_visible = false;
 
 		InstanceData &idata = cull_data.scenario->instance_data[i];
@@ -2649,7 +2860,7 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 #define OCCLUSION_CULLED (cull_data.occlusion_buffer != nullptr && (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_OCCLUSION_CULLING) == 0 && cull_data.occlusion_buffer->is_occluded(cull_data.scenario->instance_aabbs[i].bounds, cull_data.cam_transform.origin, inv_cam_transform, *cull_data.camera_matrix, z_near))
 
 		if (!HIDDEN_BY_VISIBILITY_CHECKS) {
-			if ((LAYER_CHECK && IN_FRUSTUM(cull_data.cull->frustum) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
+			if ((LAYER_CHECK && (frustum_mask & block_bit) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
 				uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 				if (base_type == RS::INSTANCE_LIGHT) {
 					cull_result.lights.push_back(idata.instance);
@@ -3874,13 +4085,33 @@ void RendererSceneCull::update_dirty_instances() {
 	RSG::storage->update_dirty_resources();
 
 	while (_instance_update_list.first()) {
-		_update_dirty_instance(_instance_update_list.first()->self());
+		while (_instance_update_list.first()) {
+			_update_dirty_instance(_instance_update_list.first()->self());
+		}
+
+		// Pairing can queue more updates.
+		_pair_queued_instances();
 	}
 }
 
+uint64_t RendererSceneCull::get_indexer_updates_in_frame() const {
+	return indexer_updates_in_frame;
+}
+
+uint64_t RendererSceneCull::get_indexer_update_usec_in_frame() const {
+	return indexer_update_usec_in_frame;
+}
+
 void RendererSceneCull::update() {
+	indexer_updates_in_frame = indexer_updates;
+	indexer_update_usec_in_frame = indexer_update_usec;
+	indexer_updates = 0;
+	indexer_update_usec = 0;
+
 	//optimize bvhs
 
+	uint64_t time_usec = OS::get_singleton()->get_ticks_usec();
+
 	uint32_t rid_count = scenario_owner.get_rid_count();
 	RID *rids = (RID *)alloca(sizeof(RID) * rid_count);
 	scenario_owner.fill_owned_buffer(rids);
@@ -3889,6 +4120,9 @@ void RendererSceneCull::update() {
 		s->indexers[Scenario::INDEXER_GEOMETRY].optimize_incremental(indexer_update_iterations);
 		s->indexers[Scenario::INDEXER_VOLUMES].optimize_incremental(indexer_update_iterations);
 	}
+
+	indexer_update_usec += OS::get_singleton()->get_ticks_usec() - time_usec;
+
 	scene_render->update();
 	update_dirty_instances();
 	render_particle_colliders();
@@ -4014,7 +4248,8 @@ RendererSceneCull::RendererSceneCull() {
 	thread_cull_threshold = GLOBAL_GET("rendering/limits/spatial_indexer/threaded_cull_minimum_instances");
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)RendererThreadPool::singleton->thread_work_pool.get_thread_count()); //make sure there is at least one thread per CPU
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	// Rasterizes the occluders on the CPU, modules can replace it with their own implementation.
+	default_occlusion_culling = memnew(RendererSceneOcclusionCullRaster);
 }
 
 RendererSceneCull::~RendererSceneCull() {
@@ -4034,7 +4269,7 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	scene_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (default_occlusion_culling) {
+		memdelete(default_occlusion_culling);
 	}
 }
@@ -115,7 +115,7 @@ public:
 
 	/* VISIBILITY NOTIFIER API */
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling;
+	RendererSceneOcclusionCull *default_occlusion_culling;
 
 	/* SCENARIO API */
 
@@ -240,6 +240,23 @@ public:
 		}
 	};
 
+	struct InstanceBoundsBlock {
+		// Bounds of consecutive instances, stored one component after the other
+		// so the culling tests run on several instances at once (SSE or NEON when available).
+		// The tests return a bit per instance, and only test the instances set in p_mask.
+
+		enum {
+			SIZE = 64
+		};
+
+		alignas(16) real_t bounds[6][SIZE];
+		uint32_t count = 0;
+
+		void load(const PagedArray<InstanceBounds> &p_instance_aabbs, uint64_t p_from, uint32_t p_count);
+		uint64_t in_frustum(const Frustum &p_frustum, uint64_t p_mask) const;
+		uint64_t in_aabb(const AABB &p_aabb, uint64_t p_mask) const;
+	};
+
 	struct InstanceVisibilityNotifierData;
 
 	struct InstanceData {
@@ -343,6 +360,13 @@ public:
 
 	int indexer_update_iterations = 0;
 
+	// Moved instances update their leaves in the indexers, which are refitted all at once before pairing.
+	LocalVector<Instance *> instance_pair_queue;
+	uint64_t indexer_updates = 0;
+	uint64_t indexer_update_usec = 0;
+	uint64_t indexer_updates_in_frame = 0;
+	uint64_t indexer_update_usec_in_frame = 0;
+
 	mutable RID_Owner<Scenario, true> scenario_owner;
 
 	static void _instance_pair(Instance *p_A, Instance *p_B);
@@ -452,6 +476,7 @@ public:
 		//aabb stuff
 		bool update_aabb;
 		bool update_dependencies;
+		int32_t pair_queue_index; // Position in instance_pair_queue, -1 if not queued.
 
 		SelfList<Instance> update_item;
 
@@ -540,6 +565,7 @@ public:
 
 			update_aabb = false;
 			update_dependencies = false;
+			pair_queue_index = -1;
 
 			extra_margin = 0;
 
@@ -974,6 +1000,7 @@ public:
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
+	void _pair_queued_instances();
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 	void _unpair_instance(Instance *p_instance);
 
@@ -1047,6 +1074,7 @@ public:
 	};
 
 	void _scene_cull_threaded(uint32_t p_thread, CullData *cull_data);
+	uint64_t _scene_cull_block(CullData &cull_data, InstanceBoundsBlock &r_block, uint64_t p_from, uint32_t p_count, uint64_t &r_frustum_mask);
 	void _scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to);
 	_FORCE_INLINE_ bool _visibility_parent_check(const CullData &p_cull_data, const InstanceData &p_instance_data);
 
@@ -1057,6 +1085,9 @@ public:
 	void render_camera(RID p_render_buffers, RID p_camera, RID p_scenario, RID p_viewport, Size2 p_viewport_size, float p_screen_mesh_lod_threshold, RID p_shadow_atlas, Ref<XRInterface> &p_xr_interface, RendererScene::RenderInfo *r_render_info = nullptr);
 	void update_dirty_instances();
 
+	virtual uint64_t get_indexer_updates_in_frame() const;
+	virtual uint64_t get_indexer_update_usec_in_frame() const;
+
 	void render_particle_colliders();
 	virtual void render_probes();
 
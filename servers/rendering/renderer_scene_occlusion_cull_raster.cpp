@@ -0,0 +1,566 @@
+/*************************************************************************/
+/*  renderer_scene_occlusion_cull_raster.cpp                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "renderer_scene_occlusion_cull_raster.h"
+
+#include "core/templates/thread_work_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_USE_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define RASTER_USE_NEON
+#include <arm_neon.h>
+#endif
+
+// Triangles are clipped against the near plane, and against a guard band of this many
+// times the screen size, so the edge functions stay precise.
+static const float GUARD_BAND = 4.0f;
+
+static bool _aabb_in_frustum(const AABB &p_aabb, const Vector<Plane> &p_planes) {
+	for (int i = 0; i < p_planes.size(); i++) {
+		const Plane &plane = p_planes[i];
+		if (plane.distance_to(p_aabb.get_support(-plane.normal)) > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Clips a polygon of (x, y, w, depth) clip space vertices, keeping the side where
+// p_plane[0] * x + p_plane[1] * y + p_plane[2] * w + p_plane[3] * depth + p_plane[4] >= 0.
+static uint32_t _clip_polygon(const float (*p_in)[4], uint32_t p_in_count, float (*r_out)[4], const float p_plane[5]) {
+	uint32_t out_count = 0;
+	for (uint32_t i = 0; i < p_in_count; i++) {
+		const float *a = p_in[i];
+		const float *b = p_in[(i + 1) % p_in_count];
+		const float dist_a = p_plane[0] * a[0] + p_plane[1] * a[1] + p_plane[2] * a[2] + p_plane[3] * a[3] + p_plane[4];
+		const float dist_b = p_plane[0] * b[0] + p_plane[1] * b[1] + p_plane[2] * b[2] + p_plane[3] * b[3] + p_plane[4];
+
+		if (dist_a >= 0) {
+			memcpy(r_out[out_count++], a, sizeof(float) * 4);
+		}
+		if ((dist_a >= 0) != (dist_b >= 0)) {
+			const float t = dist_a / (dist_a - dist_b);
+			for (int j = 0; j < 4; j++) {
+				r_out[out_count][j] = a[j] + (b[j] - a[j]) * t;
+			}
+			out_count++;
+		}
+	}
+	return out_count;
+}
+
+////////////////////////////////////////////////////////
+
+bool RendererSceneOcclusionCullRaster::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RendererSceneOcclusionCullRaster::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RendererSceneOcclusionCullRaster::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RendererSceneOcclusionCullRaster::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_COND(!occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	for (Set<InstanceID>::Element *E = occluder->users.front(); E; E = E->next()) {
+		Scenario *scenario = scenarios.getptr(E->get().scenario);
+		ERR_CONTINUE(!scenario);
+		scenario->dirty = true;
+	}
+}
+
+void RendererSceneOcclusionCullRaster::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_COND(!occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionCullRaster::add_scenario(RID p_scenario) {
+	ERR_FAIL_COND(scenarios.has(p_scenario));
+	scenarios[p_scenario] = Scenario();
+}
+
+void RendererSceneOcclusionCullRaster::remove_scenario(RID p_scenario) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_COND(!scenario);
+
+	const RID *instance_rid = nullptr;
+	while ((instance_rid = scenario->instances.next(instance_rid))) {
+		Occluder *occluder = occluder_owner.get_or_null(scenario->instances[*instance_rid].occluder);
+		if (occluder) {
+			occluder->users.erase(InstanceID(p_scenario, *instance_rid));
+		}
+	}
+
+	scenarios.erase(p_scenario);
+}
+
+void RendererSceneOcclusionCullRaster::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_COND(!scenario);
+
+	if (!scenario->instances.has(p_instance)) {
+		scenario->instances[p_instance] = OccluderInstance();
+	}
+
+	OccluderInstance &instance = scenario->instances[p_instance];
+
+	if (instance.occluder != p_occluder) {
+		Occluder *old_occluder = occluder_owner.get_or_null(instance.occluder);
+		if (old_occluder) {
+			old_occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		instance.occluder = p_occluder;
+
+		if (p_occluder.is_valid()) {
+			Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+			ERR_FAIL_COND(!occluder);
+			occluder->users.insert(InstanceID(p_scenario, p_instance));
+		}
+		scenario->dirty = true;
+	}
+
+	if (instance.xform != p_xform) {
+		instance.xform = p_xform;
+		scenario->dirty = true;
+	}
+
+	if (instance.enabled != p_enabled) {
+		instance.enabled = p_enabled;
+		scenario->dirty = true;
+	}
+}
+
+void RendererSceneOcclusionCullRaster::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_COND(!scenario);
+
+	OccluderInstance *instance = scenario->instances.getptr(p_instance);
+	if (instance) {
+		Occluder *occluder = occluder_owner.get_or_null(instance->occluder);
+		if (occluder) {
+			occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		scenario->instances.erase(p_instance);
+		scenario->dirty = true;
+	}
+}
+
+void RendererSceneOcclusionCullRaster::Scenario::update(RID_PtrOwner<Occluder> &p_occluder_owner) {
+	if (!dirty) {
+		return;
+	}
+
+	vertices.clear();
+	indices.clear();
+	meshes.clear();
+
+	const RID *instance_rid = nullptr;
+	while ((instance_rid = instances.next(instance_rid))) {
+		const OccluderInstance &instance = instances[*instance_rid];
+		const Occluder *occluder = p_occluder_owner.get_or_null(instance.occluder);
+
+		if (!occluder || !instance.enabled || occluder->vertices.is_empty()) {
+			continue;
+		}
+
+		const uint32_t vertex_from = vertices.size();
+		const uint32_t vertex_count = occluder->vertices.size();
+		vertices.resize(vertex_from + vertex_count);
+
+		Mesh mesh;
+		mesh.index_from = indices.size();
+
+		const Vector3 *read = occluder->vertices.ptr();
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			vertices[vertex_from + i] = instance.xform.xform(read[i]);
+			if (i == 0) {
+				mesh.aabb.position = vertices[vertex_from];
+			} else {
+				mesh.aabb.expand_to(vertices[vertex_from + i]);
+			}
+		}
+
+		const int32_t *read_indices = occluder->indices.ptr();
+		const uint32_t index_count = occluder->indices.size() - occluder->indices.size() % 3;
+		for (uint32_t i = 0; i < index_count; i += 3) {
+			if (uint32_t(read_indices[i]) >= vertex_count || uint32_t(read_indices[i + 1]) >= vertex_count || uint32_t(read_indices[i + 2]) >= vertex_count) {
+				continue;
+			}
+			indices.push_back(vertex_from + read_indices[i]);
+			indices.push_back(vertex_from + read_indices[i + 1]);
+			indices.push_back(vertex_from + read_indices[i + 2]);
+		}
+
+		mesh.index_count = indices.size() - mesh.index_from;
+		if (mesh.index_count > 0) {
+			meshes.push_back(mesh);
+		}
+	}
+
+	dirty = false;
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionCullRaster::_add_polygon(SetupJob &r_job, const RasterizeData &p_data, const float (*p_vertices)[4], uint32_t p_vertex_count) {
+	float screen[8][3];
+	for (uint32_t i = 0; i < p_vertex_count; i++) {
+		const float *v = p_vertices[i];
+		screen[i][0] = (v[0] / v[2] * 0.5f + 0.5f) * p_data.size.x;
+		screen[i][1] = (v[1] / v[2] * 0.5f + 0.5f) * p_data.size.y;
+		screen[i][2] = p_data.orthogonal ? v[3] : 1.0f / v[3];
+	}
+
+	for (uint32_t i = 2; i < p_vertex_count; i++) {
+		const float *v0 = screen[0];
+		const float *v1 = screen[i - 1];
+		const float *v2 = screen[i];
+
+		float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+		if (Math::absf(area) < 1e-6f) {
+			continue;
+		}
+		if (area < 0) {
+			// Occluders are double-sided, make all the triangles counter-clockwise.
+			SWAP(v1, v2);
+			area = -area;
+		}
+
+		const float min_x = MIN(v0[0], MIN(v1[0], v2[0]));
+		const float max_x = MAX(v0[0], MAX(v1[0], v2[0]));
+		const float min_y = MIN(v0[1], MIN(v1[1], v2[1]));
+		const float max_y = MAX(v0[1], MAX(v1[1], v2[1]));
+
+		// Only the pixels whose center is inside are covered.
+		Triangle triangle;
+		triangle.min_x = MAX(0, int(Math::ceil(min_x - 0.5f)));
+		triangle.min_y = MAX(0, int(Math::ceil(min_y - 0.5f)));
+		triangle.max_x = MIN(p_data.size.x - 1, int(Math::floor(max_x - 0.5f)));
+		triangle.max_y = MIN(p_data.size.y - 1, int(Math::floor(max_y - 0.5f)));
+		if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y) {
+			continue;
+		}
+
+		// Edge k is the one opposite to vertex k, its function is the barycentric weight of vertex k times the area.
+		const float *edge_from[3] = { v1, v2, v0 };
+		const float *edge_to[3] = { v2, v0, v1 };
+		for (int k = 0; k < 3; k++) {
+			triangle.edge_a[k] = edge_from[k][1] - edge_to[k][1];
+			triangle.edge_b[k] = edge_to[k][0] - edge_from[k][0];
+			triangle.edge_c[k] = -(triangle.edge_a[k] * edge_from[k][0] + triangle.edge_b[k] * edge_from[k][1]);
+		}
+
+		const float inv_area = 1.0f / area;
+		triangle.depth_a = (triangle.edge_a[0] * v0[2] + triangle.edge_a[1] * v1[2] + triangle.edge_a[2] * v2[2]) * inv_area;
+		triangle.depth_b = (triangle.edge_b[0] * v0[2] + triangle.edge_b[1] * v1[2] + triangle.edge_b[2] * v2[2]) * inv_area;
+		triangle.depth_c = (triangle.edge_c[0] * v0[2] + triangle.edge_c[1] * v1[2] + triangle.edge_c[2] * v2[2]) * inv_area;
+
+		const uint32_t triangle_index = r_job.triangles.size();
+		r_job.triangles.push_back(triangle);
+
+		for (int y = triangle.min_y / BIN_HEIGHT; y <= triangle.max_y / BIN_HEIGHT; y++) {
+			for (int x = triangle.min_x / BIN_WIDTH; x <= triangle.max_x / BIN_WIDTH; x++) {
+				r_job.bins[y * p_data.bin_grid_size.x + x].push_back(triangle_index);
+			}
+		}
+	}
+}
+
+void RendererSceneOcclusionCullRaster::_setup_triangles(uint32_t p_job, RasterizeData *p_data) {
+	SetupJob &job = setup_jobs[p_job];
+	const Scenario &scenario = *p_data->scenario;
+	const CameraMatrix &m = p_data->clip_matrix;
+
+	const float near_plane[5] = { 0.0f, 0.0f, 0.0f, 1.0f, -p_data->z_near };
+	const float guard_planes[4][5] = {
+		{ -1.0f, 0.0f, GUARD_BAND, 0.0f, 0.0f },
+		{ 1.0f, 0.0f, GUARD_BAND, 0.0f, 0.0f },
+		{ 0.0f, -1.0f, GUARD_BAND, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, GUARD_BAND, 0.0f, 0.0f },
+	};
+
+	const uint32_t triangle_count = scenario.indices.size() / 3;
+	const uint32_t from = uint64_t(p_job) * triangle_count / p_data->job_count;
+	const uint32_t to = uint64_t(p_job + 1) * triangle_count / p_data->job_count;
+
+	for (uint32_t i = 0; i < scenario.meshes.size(); i++) {
+		const Scenario::Mesh &mesh = scenario.meshes[i];
+		const uint32_t mesh_from = MAX(from, mesh.index_from / 3);
+		const uint32_t mesh_to = MIN(to, (mesh.index_from + mesh.index_count) / 3);
+		if (mesh_from >= mesh_to || !_aabb_in_frustum(mesh.aabb, p_data->frustum_planes)) {
+			continue;
+		}
+
+		for (uint32_t j = mesh_from; j < mesh_to; j++) {
+			float polygon[2][8][4];
+			bool inside_guard_band = true;
+			uint32_t behind_near = 0;
+
+			for (int k = 0; k < 3; k++) {
+				const Vector3 &v = scenario.vertices[scenario.indices[j * 3 + k]];
+				float *clip = polygon[0][k];
+				clip[0] = m.matrix[0][0] * v.x + m.matrix[1][0] * v.y + m.matrix[2][0] * v.z + m.matrix[3][0];
+				clip[1] = m.matrix[0][1] * v.x + m.matrix[1][1] * v.y + m.matrix[2][1] * v.z + m.matrix[3][1];
+				clip[2] = m.matrix[0][3] * v.x + m.matrix[1][3] * v.y + m.matrix[2][3] * v.z + m.matrix[3][3];
+				clip[3] = p_data->depth_plane.distance_to(v);
+
+				if (clip[3] < p_data->z_near) {
+					behind_near++;
+					inside_guard_band = false;
+				} else if (Math::absf(clip[0]) > GUARD_BAND * clip[2] || Math::absf(clip[1]) > GUARD_BAND * clip[2]) {
+					inside_guard_band = false;
+				}
+			}
+
+			if (behind_near == 3) {
+				continue;
+			}
+
+			if (inside_guard_band) {
+				_add_polygon(job, *p_data, polygon[0], 3);
+				continue;
+			}
+
+			uint32_t count = _clip_polygon(polygon[0], 3, polygon[1], near_plane);
+			int current = 1;
+			for (int k = 0; k < 4 && count >= 3; k++) {
+				count = _clip_polygon(polygon[current], count, polygon[1 - current], guard_planes[k]);
+				current = 1 - current;
+			}
+			if (count >= 3) {
+				_add_polygon(job, *p_data, polygon[current], count);
+			}
+		}
+	}
+}
+
+void RendererSceneOcclusionCullRaster::_rasterize_bin(uint32_t p_bin, RasterizeData *p_data) {
+	const int bin_x = (p_bin % p_data->bin_grid_size.x) * BIN_WIDTH;
+	const int bin_y = (p_bin / p_data->bin_grid_size.x) * BIN_HEIGHT;
+	const int bin_end_x = MIN(bin_x + BIN_WIDTH, p_data->size.x) - 1;
+	const int bin_end_y = MIN(bin_y + BIN_HEIGHT, p_data->size.y) - 1;
+	const int width = p_data->size.x;
+	float *depth = p_data->buffer->mips[0];
+	const bool orthogonal = p_data->orthogonal;
+
+	for (int y = bin_y; y <= bin_end_y; y++) {
+		for (int x = bin_x; x <= bin_end_x; x++) {
+			depth[y * width + x] = FLT_MAX;
+		}
+	}
+
+	for (uint32_t i = 0; i < p_data->job_count; i++) {
+		const SetupJob &job = setup_jobs[i];
+		const LocalVector<uint32_t> &bin = job.bins[p_bin];
+
+		for (uint32_t j = 0; j < bin.size(); j++) {
+			const Triangle &t = job.triangles[bin[j]];
+			const int min_x = MAX(t.min_x, bin_x);
+			const int max_x = MIN(t.max_x, bin_end_x);
+			const int min_y = MAX(t.min_y, bin_y);
+			const int max_y = MIN(t.max_y, bin_end_y);
+
+			for (int y = min_y; y <= max_y; y++) {
+				const float py = y + 0.5f;
+				const float row_e0 = t.edge_b[0] * py + t.edge_c[0];
+				const float row_e1 = t.edge_b[1] * py + t.edge_c[1];
+				const float row_e2 = t.edge_b[2] * py + t.edge_c[2];
+				const float row_depth = t.depth_b * py + t.depth_c;
+				float *row = &depth[y * width];
+				int x = min_x;
+
+#if defined(RASTER_USE_SSE)
+				const __m128 lane_offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+				const __m128 zero = _mm_setzero_ps();
+				for (; x + 3 <= max_x; x += 4) {
+					const __m128 px = _mm_add_ps(_mm_set1_ps(float(x)), lane_offsets);
+					const __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edge_a[0]), px), _mm_set1_ps(row_e0));
+					const __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edge_a[1]), px), _mm_set1_ps(row_e1));
+					const __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edge_a[2]), px), _mm_set1_ps(row_e2));
+					const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+					if (!_mm_movemask_ps(inside)) {
+						continue;
+					}
+					__m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.depth_a), px), _mm_set1_ps(row_depth));
+					if (!orthogonal) {
+						d = _mm_div_ps(_mm_set1_ps(1.0f), d);
+					}
+					const __m128 current = _mm_loadu_ps(row + x);
+					const __m128 closest = _mm_min_ps(current, d);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest), _mm_andnot_ps(inside, current)));
+				}
+#elif defined(RASTER_USE_NEON)
+				static const float lane_offsets_array[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+				const float32x4_t lane_offsets = vld1q_f32(lane_offsets_array);
+				const float32x4_t zero = vdupq_n_f32(0.0f);
+				for (; x + 3 <= max_x; x += 4) {
+					const float32x4_t px = vaddq_f32(vdupq_n_f32(float(x)), lane_offsets);
+					const float32x4_t e0 = vaddq_f32(vmulq_n_f32(px, t.edge_a[0]), vdupq_n_f32(row_e0));
+					const float32x4_t e1 = vaddq_f32(vmulq_n_f32(px, t.edge_a[1]), vdupq_n_f32(row_e1));
+					const float32x4_t e2 = vaddq_f32(vmulq_n_f32(px, t.edge_a[2]), vdupq_n_f32(row_e2));
+					const uint32x4_t inside = vandq_u32(vandq_u32(vcgeq_f32(e0, zero), vcgeq_f32(e1, zero)), vcgeq_f32(e2, zero));
+					if (!vmaxvq_u32(inside)) {
+						continue;
+					}
+					float32x4_t d = vaddq_f32(vmulq_n_f32(px, t.depth_a), vdupq_n_f32(row_depth));
+					if (!orthogonal) {
+						d = vdivq_f32(vdupq_n_f32(1.0f), d);
+					}
+					const float32x4_t current = vld1q_f32(row + x);
+					vst1q_f32(row + x, vbslq_f32(inside, vminq_f32(current, d), current));
+				}
+#endif
+				// Remaining pixels, which can't be written 4 at a time without touching other bins.
+				for (; x <= max_x; x++) {
+					const float px = x + 0.5f;
+					if (t.edge_a[0] * px + row_e0 >= 0 && t.edge_a[1] * px + row_e1 >= 0 && t.edge_a[2] * px + row_e2 >= 0) {
+						float d = t.depth_a * px + row_depth;
+						if (!orthogonal) {
+							d = 1.0f / d;
+						}
+						row[x] = MIN(row[x], d);
+					}
+				}
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionCullRaster::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RendererSceneOcclusionCullRaster::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+RendererSceneOcclusionCull::HZBuffer *RendererSceneOcclusionCullRaster::buffer_get_ptr(RID p_buffer) {
+	return buffers.getptr(p_buffer);
+}
+
+void RendererSceneOcclusionCullRaster::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RendererSceneOcclusionCullRaster::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RendererSceneOcclusionCullRaster::buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_pool) {
+	RasterHZBuffer *buffer = buffers.getptr(p_buffer);
+	if (!buffer || buffer->is_empty()) {
+		return;
+	}
+
+	Scenario *scenario = scenarios.getptr(buffer->scenario_rid);
+	if (!scenario) {
+		return;
+	}
+
+	scenario->update(occluder_owner);
+
+	const Transform3D view = p_cam_transform.affine_inverse();
+
+	RasterizeData data;
+	data.scenario = scenario;
+	data.buffer = buffer;
+	data.clip_matrix = p_cam_projection * CameraMatrix(view);
+	// The depth stored in the buffer is the distance in front of the camera plane.
+	data.depth_plane = Plane(-view.basis.get_row(2), view.origin.z);
+	data.frustum_planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	data.z_near = p_cam_projection.get_z_near();
+	data.orthogonal = p_cam_orthogonal;
+	data.size = buffer->sizes[0];
+	data.bin_grid_size = Size2i((data.size.x + BIN_WIDTH - 1) / BIN_WIDTH, (data.size.y + BIN_HEIGHT - 1) / BIN_HEIGHT);
+
+	const uint32_t bin_count = data.bin_grid_size.x * data.bin_grid_size.y;
+	const uint32_t triangle_count = scenario->indices.size() / 3;
+	// Split the triangles between the threads, but don't bother below a few hundred per thread.
+	data.job_count = CLAMP(triangle_count / 256, 1u, uint32_t(p_thread_pool.get_thread_count()));
+
+	if (setup_jobs.size() < data.job_count) {
+		setup_jobs.resize(data.job_count);
+	}
+	for (uint32_t i = 0; i < data.job_count; i++) {
+		setup_jobs[i].triangles.clear();
+		setup_jobs[i].bins.resize(bin_count);
+		for (uint32_t j = 0; j < bin_count; j++) {
+			setup_jobs[i].bins[j].clear();
+		}
+	}
+
+	p_thread_pool.do_work(data.job_count, this, &RendererSceneOcclusionCullRaster::_setup_triangles, &data);
+	p_thread_pool.do_work(bin_count, this, &RendererSceneOcclusionCullRaster::_rasterize_bin, &data);
+
+	buffer->debug_tex_range = p_cam_projection.get_z_far();
+	buffer->update_mips();
+}
+
+RID RendererSceneOcclusionCullRaster::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
+
+////////////////////////////////////////////////////////
+
+RendererSceneOcclusionCullRaster::RendererSceneOcclusionCullRaster() {
+}
+
+RendererSceneOcclusionCullRaster::~RendererSceneOcclusionCullRaster() {
+	List<RID> owned;
+	occluder_owner.get_owned_list(&owned);
+	for (const RID &E : owned) {
+		free_occluder(E);
+	}
+}
@@ -0,0 +1,163 @@
+/*************************************************************************/
+/*  renderer_scene_occlusion_cull_raster.h                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RENDERER_SCENE_OCCLUSION_CULL_RASTER_H
+#define RENDERER_SCENE_OCCLUSION_CULL_RASTER_H
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rid_owner.h"
+#include "core/templates/set.h"
+#include "servers/rendering/renderer_scene_occlusion_cull.h"
+
+// Occlusion culling without ray tracing: the occluders are rasterized into the depth buffer,
+// in screen bins on the worker threads. Used when the raycast module is not available.
+class RendererSceneOcclusionCullRaster : public RendererSceneOcclusionCull {
+public:
+	class RasterHZBuffer : public HZBuffer {
+		friend class RendererSceneOcclusionCullRaster;
+
+	public:
+		RID scenario_rid;
+	};
+
+private:
+	enum {
+		BIN_WIDTH = 32,
+		BIN_HEIGHT = 16,
+	};
+
+	struct InstanceID {
+		RID scenario;
+		RID instance;
+
+		bool operator<(const InstanceID &rhs) const {
+			if (instance == rhs.instance) {
+				return rhs.scenario < scenario;
+			}
+			return instance < rhs.instance;
+		}
+
+		InstanceID() {}
+		InstanceID(RID s, RID i) :
+				scenario(s), instance(i) {}
+	};
+
+	struct Occluder {
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		Set<InstanceID> users;
+	};
+
+	struct OccluderInstance {
+		RID occluder;
+		Transform3D xform;
+		bool enabled = true;
+	};
+
+	struct Scenario {
+		// All the enabled occluders, transformed and merged, rebuilt when any of them changes.
+		struct Mesh {
+			uint32_t index_from = 0;
+			uint32_t index_count = 0;
+			AABB aabb;
+		};
+
+		HashMap<RID, OccluderInstance> instances;
+		LocalVector<Vector3> vertices;
+		LocalVector<uint32_t> indices;
+		LocalVector<Mesh> meshes;
+		bool dirty = false;
+
+		void update(RID_PtrOwner<Occluder> &p_occluder_owner);
+	};
+
+	// Occluder triangle ready to rasterize, in pixels. The edge functions are positive inside,
+	// and the depth is interpolated as 1 / depth for perspective cameras, so it stays linear in screen space.
+	struct Triangle {
+		float edge_a[3];
+		float edge_b[3];
+		float edge_c[3];
+		float depth_a, depth_b, depth_c;
+		int min_x, min_y, max_x, max_y;
+	};
+
+	struct SetupJob {
+		LocalVector<Triangle> triangles;
+		LocalVector<LocalVector<uint32_t>> bins; // Indices of the triangles overlapping each bin.
+	};
+
+	struct RasterizeData {
+		const Scenario *scenario = nullptr;
+		RasterHZBuffer *buffer = nullptr;
+		CameraMatrix clip_matrix; // World to clip space.
+		Plane depth_plane; // World to view depth.
+		Vector<Plane> frustum_planes;
+		float z_near = 0.0f;
+		bool orthogonal = false;
+		Size2i size;
+		Size2i bin_grid_size;
+		uint32_t job_count = 0;
+	};
+
+	RID_PtrOwner<Occluder> occluder_owner;
+	HashMap<RID, Scenario> scenarios;
+	HashMap<RID, RasterHZBuffer> buffers;
+	LocalVector<SetupJob> setup_jobs;
+
+	void _setup_triangles(uint32_t p_job, RasterizeData *p_data);
+	void _add_polygon(SetupJob &r_job, const RasterizeData &p_data, const float (*p_vertices)[4], uint32_t p_vertex_count);
+	void _rasterize_bin(uint32_t p_bin, RasterizeData *p_data);
+
+public:
+	virtual bool is_occluder(RID p_rid) override;
+	virtual RID occluder_allocate() override;
+	virtual void occluder_initialize(RID p_occluder) override;
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) override;
+	virtual void free_occluder(RID p_occluder) override;
+
+	virtual void add_scenario(RID p_scenario) override;
+	virtual void remove_scenario(RID p_scenario) override;
+	virtual void scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) override;
+	virtual void scenario_remove_instance(RID p_scenario, RID p_instance) override;
+
+	virtual void add_buffer(RID p_buffer) override;
+	virtual void remove_buffer(RID p_buffer) override;
+	virtual HZBuffer *buffer_get_ptr(RID p_buffer) override;
+	virtual void buffer_set_scenario(RID p_buffer, RID p_scenario) override;
+	virtual void buffer_set_size(RID p_buffer, const Vector2i &p_size) override;
+	virtual void buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_pool) override;
+	virtual RID buffer_get_debug_texture(RID p_buffer) override;
+
+	RendererSceneOcclusionCullRaster();
+	~RendererSceneOcclusionCullRaster();
+};
+
+#endif // RENDERER_SCENE_OCCLUSION_CULL_RASTER_H
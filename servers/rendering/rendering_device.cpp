@@ -985,3 +985,9 @@ RenderingDevice::RenderingDevice() {
 		singleton = this;
 	}
 }
+
+RenderingDevice::~RenderingDevice() {
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
@@ -1209,6 +1209,7 @@ public:
 
 	static RenderingDevice *get_singleton();
 	RenderingDevice();
+	~RenderingDevice();
 
 protected:
 	//binders to script API
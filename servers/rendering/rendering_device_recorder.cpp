@@ -0,0 +1,1755 @@
+/*************************************************************************/
+/*  rendering_device_recorder.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "rendering_device_recorder.h"
+
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+
+static const uint32_t RECORDER_SHADER_MAGIC = 0x43524452; // "RDRC"
+static const uint32_t RECORDER_TRACE_VERSION = 1;
+
+String RenderingDeviceRecorder::trace_path;
+
+void RenderingDeviceRecorder::_add_dependency(RID p_id, RID p_depends_on) {
+	if (!dependency_map.has(p_depends_on)) {
+		dependency_map[p_depends_on] = Set<RID>();
+	}
+
+	dependency_map[p_depends_on].insert(p_id);
+
+	if (!reverse_dependency_map.has(p_id)) {
+		reverse_dependency_map[p_id] = Set<RID>();
+	}
+
+	reverse_dependency_map[p_id].insert(p_depends_on);
+}
+
+void RenderingDeviceRecorder::_free_dependencies(RID p_id) {
+	//direct dependencies must be freed
+
+	Map<RID, Set<RID>>::Element *E = dependency_map.find(p_id);
+	if (E) {
+		while (E->get().size()) {
+			free(E->get().front()->get());
+		}
+		dependency_map.erase(E);
+	}
+
+	//reverse dependencies must be unreferenced
+	E = reverse_dependency_map.find(p_id);
+
+	if (E) {
+		for (Set<RID>::Element *F = E->get().front(); F; F = F->next()) {
+			Map<RID, Set<RID>>::Element *G = dependency_map.find(F->get());
+			ERR_CONTINUE(!G);
+			ERR_CONTINUE(!G->get().has(p_id));
+			G->get().erase(p_id);
+		}
+
+		reverse_dependency_map.erase(E);
+	}
+}
+
+/*****************/
+/**** TEXTURE ****/
+/*****************/
+
+RID RenderingDeviceRecorder::texture_create(const TextureFormat &p_format, const TextureView &p_view, const Vector<Vector<uint8_t>> &p_data) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_format.width < 1 || p_format.height < 1 || p_format.depth < 1, RID());
+	ERR_FAIL_COND_V(p_format.mipmaps < 1, RID());
+	ERR_FAIL_COND_V_MSG(p_data.size() && p_data.size() != (int)p_format.array_layers, RID(),
+			"Default supplied data for image format is of invalid length (" + itos(p_data.size()) + "), should be (" + itos(p_format.array_layers) + ").");
+
+	Texture texture;
+	texture.format = p_format;
+	if (p_view.format_override != DATA_FORMAT_MAX) {
+		texture.format.format = p_view.format_override;
+	}
+	texture.data = p_data;
+	for (int i = 0; i < p_data.size(); i++) {
+		texture_memory += p_data[i].size();
+	}
+
+	return texture_owner.make_rid(texture);
+}
+
+RID RenderingDeviceRecorder::texture_create_shared(const TextureView &p_view, RID p_with_texture) {
+	_THREAD_SAFE_METHOD_
+
+	Texture *src_texture = texture_owner.get_or_null(p_with_texture);
+	ERR_FAIL_COND_V(!src_texture, RID());
+
+	if (src_texture->owner.is_valid()) { //ahh this is a share
+		p_with_texture = src_texture->owner;
+		src_texture = texture_owner.get_or_null(src_texture->owner);
+		ERR_FAIL_COND_V(!src_texture, RID()); //this is a bug
+	}
+
+	Texture texture;
+	texture.format = src_texture->format;
+	texture.owner = p_with_texture;
+	if (p_view.format_override != DATA_FORMAT_MAX) {
+		texture.format.format = p_view.format_override;
+	}
+
+	RID id = texture_owner.make_rid(texture);
+	_add_dependency(id, p_with_texture);
+
+	return id;
+}
+
+RID RenderingDeviceRecorder::texture_create_shared_from_slice(const TextureView &p_view, RID p_with_texture, uint32_t p_layer, uint32_t p_mipmap, uint32_t p_mipmaps, TextureSliceType p_slice_type) {
+	_THREAD_SAFE_METHOD_
+
+	Texture *src_texture = texture_owner.get_or_null(p_with_texture);
+	ERR_FAIL_COND_V(!src_texture, RID());
+
+	if (src_texture->owner.is_valid()) { //ahh this is a share
+		p_with_texture = src_texture->owner;
+		src_texture = texture_owner.get_or_null(src_texture->owner);
+		ERR_FAIL_COND_V(!src_texture, RID()); //this is a bug
+	}
+
+	ERR_FAIL_UNSIGNED_INDEX_V(p_mipmap, src_texture->format.mipmaps, RID());
+	ERR_FAIL_COND_V(p_mipmap + p_mipmaps > src_texture->format.mipmaps, RID());
+
+	Texture texture;
+	texture.format = src_texture->format;
+	texture.owner = p_with_texture;
+	texture.base_mipmap = p_mipmap;
+	texture.format.mipmaps = p_mipmaps;
+	if (p_slice_type == TEXTURE_SLICE_2D) {
+		texture.format.texture_type = TEXTURE_TYPE_2D;
+		texture.format.array_layers = 1;
+	} else if (p_slice_type == TEXTURE_SLICE_CUBEMAP) {
+		texture.format.texture_type = TEXTURE_TYPE_CUBE;
+		texture.format.array_layers = 6;
+	} else if (p_slice_type == TEXTURE_SLICE_3D) {
+		texture.format.texture_type = TEXTURE_TYPE_3D;
+	} else if (p_slice_type == TEXTURE_SLICE_2D_ARRAY) {
+		texture.format.texture_type = TEXTURE_TYPE_2D_ARRAY;
+	}
+	if (p_view.format_override != DATA_FORMAT_MAX) {
+		texture.format.format = p_view.format_override;
+	}
+
+	RID id = texture_owner.make_rid(texture);
+	_add_dependency(id, p_with_texture);
+
+	return id;
+}
+
+Error RenderingDeviceRecorder::texture_update(RID p_texture, uint32_t p_layer, const Vector<uint8_t> &p_data, uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(draw_list_active || compute_list_active, ERR_INVALID_PARAMETER,
+			"Updating textures is forbidden during creation of a draw or compute list");
+
+	Texture *texture = texture_owner.get_or_null(p_texture);
+	ERR_FAIL_COND_V(!texture, ERR_INVALID_PARAMETER);
+
+	if (texture->owner.is_valid()) {
+		p_texture = texture->owner;
+		texture = texture_owner.get_or_null(texture->owner);
+		ERR_FAIL_COND_V(!texture, ERR_BUG); //this is a bug
+	}
+
+	uint32_t layer_count = texture->format.array_layers;
+	ERR_FAIL_COND_V(p_layer >= layer_count, ERR_INVALID_PARAMETER);
+
+	if (texture->data.size() < (int)layer_count) {
+		texture->data.resize(layer_count);
+	}
+	texture_memory -= texture->data[p_layer].size();
+	texture_memory += p_data.size();
+	texture->data.write[p_layer] = p_data;
+
+	_push_command(COMMAND_TEXTURE_UPDATE, p_texture.get_id(), p_data.size(), p_post_barrier);
+
+	return OK;
+}
+
+Vector<uint8_t> RenderingDeviceRecorder::texture_get_data(RID p_texture, uint32_t p_layer) {
+	_THREAD_SAFE_METHOD_
+
+	Texture *texture = texture_owner.get_or_null(p_texture);
+	ERR_FAIL_COND_V(!texture, Vector<uint8_t>());
+
+	if (texture->owner.is_valid()) {
+		texture = texture_owner.get_or_null(texture->owner);
+		ERR_FAIL_COND_V(!texture, Vector<uint8_t>()); //this is a bug
+	}
+
+	// Nothing is rendered, so only uploaded contents can be read back.
+	if ((int)p_layer < texture->data.size()) {
+		return texture->data[p_layer];
+	}
+
+	return Vector<uint8_t>();
+}
+
+bool RenderingDeviceRecorder::texture_is_format_supported_for_usage(DataFormat p_format, uint32_t p_usage) const {
+	ERR_FAIL_INDEX_V(p_format, DATA_FORMAT_MAX, false);
+	return true;
+}
+
+bool RenderingDeviceRecorder::texture_is_shared(RID p_texture) {
+	_THREAD_SAFE_METHOD_
+
+	Texture *texture = texture_owner.get_or_null(p_texture);
+	ERR_FAIL_COND_V(!texture, false);
+	return texture->owner.is_valid();
+}
+
+bool RenderingDeviceRecorder::texture_is_valid(RID p_texture) {
+	return texture_owner.owns(p_texture);
+}
+
+Size2i RenderingDeviceRecorder::texture_size(RID p_texture) {
+	_THREAD_SAFE_METHOD_
+
+	Texture *texture = texture_owner.get_or_null(p_texture);
+	ERR_FAIL_COND_V(!texture, Size2i());
+	return Size2i(MAX(texture->format.width >> texture->base_mipmap, 1u), MAX(texture->format.height >> texture->base_mipmap, 1u));
+}
+
+Error RenderingDeviceRecorder::texture_copy(RID p_from_texture, RID p_to_texture, const Vector3 &p_from, const Vector3 &p_to, const Vector3 &p_size, uint32_t p_src_mipmap, uint32_t p_dst_mipmap, uint32_t p_src_layer, uint32_t p_dst_layer, uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(!texture_owner.owns(p_from_texture), ERR_INVALID_PARAMETER, "Source texture is invalid.");
+	ERR_FAIL_COND_V_MSG(!texture_owner.owns(p_to_texture), ERR_INVALID_PARAMETER, "Destination texture is invalid.");
+
+	_push_command(COMMAND_TEXTURE_COPY, p_to_texture.get_id(), p_from_texture.get_id(), p_post_barrier);
+
+	return OK;
+}
+
+Error RenderingDeviceRecorder::texture_clear(RID p_texture, const Color &p_color, uint32_t p_base_mipmap, uint32_t p_mipmaps, uint32_t p_base_layer, uint32_t p_layers, uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(!texture_owner.owns(p_texture), ERR_INVALID_PARAMETER, "Texture is invalid.");
+
+	_push_command(COMMAND_TEXTURE_CLEAR, p_texture.get_id(), 0, p_post_barrier);
+
+	return OK;
+}
+
+Error RenderingDeviceRecorder::texture_resolve_multisample(RID p_from_texture, RID p_to_texture, uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(!texture_owner.owns(p_from_texture), ERR_INVALID_PARAMETER, "Source texture is invalid.");
+	ERR_FAIL_COND_V_MSG(!texture_owner.owns(p_to_texture), ERR_INVALID_PARAMETER, "Destination texture is invalid.");
+
+	_push_command(COMMAND_TEXTURE_RESOLVE, p_to_texture.get_id(), p_from_texture.get_id(), p_post_barrier);
+
+	return OK;
+}
+
+/*********************/
+/**** FRAMEBUFFER ****/
+/*********************/
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecorder::_framebuffer_format_create(const Vector<AttachmentFormat> &p_attachments, const Vector<FramebufferPass> &p_passes, uint32_t p_view_count) {
+	_THREAD_SAFE_METHOD_
+
+	FormatKey key;
+	key.values.push_back(p_view_count);
+	key.values.push_back(p_attachments.size());
+	for (int i = 0; i < p_attachments.size(); i++) {
+		key.values.push_back(p_attachments[i].format);
+		key.values.push_back(p_attachments[i].samples);
+		key.values.push_back(p_attachments[i].usage_flags);
+	}
+	for (int i = 0; i < p_passes.size(); i++) {
+		const FramebufferPass &pass = p_passes[i];
+		key.values.push_back(pass.depth_attachment);
+		const Vector<int32_t> *lists[4] = { &pass.color_attachments, &pass.input_attachments, &pass.resolve_attachments, &pass.preserve_attachments };
+		for (int j = 0; j < 4; j++) {
+			key.values.push_back(lists[j]->size());
+			for (int k = 0; k < lists[j]->size(); k++) {
+				key.values.push_back((*lists[j])[k]);
+			}
+		}
+	}
+
+	const Map<FormatKey, FramebufferFormatID>::Element *E = framebuffer_format_cache.find(key);
+	if (E) {
+		//exists, return
+		return E->get();
+	}
+
+	FramebufferFormat format;
+	format.pass_count = MAX(p_passes.size(), 1);
+	for (int i = 0; i < p_passes.size(); i++) {
+		const FramebufferPass &pass = p_passes[i];
+		TextureSamples samples = TEXTURE_SAMPLES_1;
+		if (pass.color_attachments.size() && pass.color_attachments[0] != FramebufferPass::ATTACHMENT_UNUSED) {
+			ERR_FAIL_INDEX_V(pass.color_attachments[0], p_attachments.size(), INVALID_ID);
+			samples = p_attachments[pass.color_attachments[0]].samples;
+		} else if (pass.depth_attachment != FramebufferPass::ATTACHMENT_UNUSED) {
+			ERR_FAIL_INDEX_V(pass.depth_attachment, p_attachments.size(), INVALID_ID);
+			samples = p_attachments[pass.depth_attachment].samples;
+		}
+		format.pass_samples.push_back(samples);
+	}
+	if (p_passes.is_empty()) {
+		format.pass_samples.push_back(p_attachments.size() ? p_attachments[0].samples : TEXTURE_SAMPLES_1);
+	}
+
+	FramebufferFormatID id = FramebufferFormatID(framebuffer_formats.size()) | (FramebufferFormatID(ID_TYPE_FRAMEBUFFER_FORMAT) << FramebufferFormatID(ID_BASE_SHIFT));
+	framebuffer_formats.push_back(format);
+	framebuffer_format_cache[key] = id;
+	return id;
+}
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecorder::framebuffer_format_create(const Vector<AttachmentFormat> &p_format, uint32_t p_view_count) {
+	FramebufferPass pass;
+	for (int i = 0; i < p_format.size(); i++) {
+		if (p_format[i].usage_flags & TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+			pass.depth_attachment = i;
+		} else {
+			pass.color_attachments.push_back(i);
+		}
+	}
+
+	Vector<FramebufferPass> passes;
+	passes.push_back(pass);
+	return _framebuffer_format_create(p_format, passes, p_view_count);
+}
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecorder::framebuffer_format_create_multipass(const Vector<AttachmentFormat> &p_attachments, Vector<FramebufferPass> &p_passes, uint32_t p_view_count) {
+	return _framebuffer_format_create(p_attachments, p_passes, p_view_count);
+}
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecorder::framebuffer_format_create_empty(TextureSamples p_samples) {
+	AttachmentFormat attachment;
+	attachment.format = DATA_FORMAT_MAX; // Not a real attachment, only used to tell empty formats apart.
+	attachment.samples = p_samples;
+
+	Vector<AttachmentFormat> attachments;
+	attachments.push_back(attachment);
+	return _framebuffer_format_create(attachments, Vector<FramebufferPass>(), 1);
+}
+
+RenderingDevice::TextureSamples RenderingDeviceRecorder::framebuffer_format_get_texture_samples(FramebufferFormatID p_format, uint32_t p_pass) {
+	_THREAD_SAFE_METHOD_
+
+	uint64_t index = p_format & ((FramebufferFormatID(1) << FramebufferFormatID(ID_BASE_SHIFT)) - 1);
+	ERR_FAIL_COND_V(p_format < 0 || index >= framebuffer_formats.size(), TEXTURE_SAMPLES_1);
+	const FramebufferFormat &format = framebuffer_formats[index];
+	ERR_FAIL_INDEX_V(p_pass, (uint32_t)format.pass_samples.size(), TEXTURE_SAMPLES_1);
+	return format.pass_samples[p_pass];
+}
+
+RID RenderingDeviceRecorder::_framebuffer_create(const Vector<RID> &p_texture_attachments, const Vector<FramebufferPass> &p_passes, FramebufferFormatID p_format_check, uint32_t p_view_count) {
+	_THREAD_SAFE_METHOD_
+
+	Vector<AttachmentFormat> attachments;
+	Size2i size;
+
+	for (int i = 0; i < p_texture_attachments.size(); i++) {
+		Texture *texture = texture_owner.get_or_null(p_texture_attachments[i]);
+		ERR_FAIL_COND_V_MSG(!texture, RID(), "Texture index supplied for framebuffer (" + itos(i) + ") is not a valid texture.");
+
+		ERR_FAIL_COND_V_MSG(texture->format.array_layers != p_view_count, RID(), "Layers of our texture doesn't match view count for this framebuffer");
+
+		Size2i texture_size = Size2i(MAX(texture->format.width >> texture->base_mipmap, 1u), MAX(texture->format.height >> texture->base_mipmap, 1u));
+		if (i == 0) {
+			size = texture_size;
+		} else {
+			ERR_FAIL_COND_V_MSG(size != texture_size, RID(), "All textures in a framebuffer should be the same size.");
+		}
+
+		AttachmentFormat af;
+		af.format = texture->format.format;
+		af.samples = texture->format.samples;
+		af.usage_flags = texture->format.usage_bits;
+		attachments.push_back(af);
+	}
+
+	FramebufferFormatID format_id = _framebuffer_format_create(attachments, p_passes, p_view_count);
+	if (format_id == INVALID_ID) {
+		return RID();
+	}
+
+	ERR_FAIL_COND_V_MSG(p_format_check != INVALID_ID && format_id != p_format_check, RID(),
+			"Format used for creating this framebuffer (" + itos(format_id) + ") is not the same as provided (" + itos(p_format_check) + ").");
+
+	Framebuffer framebuffer;
+	framebuffer.format_id = format_id;
+	framebuffer.size = size;
+
+	RID id = framebuffer_owner.make_rid(framebuffer);
+
+	for (int i = 0; i < p_texture_attachments.size(); i++) {
+		_add_dependency(id, p_texture_attachments[i]);
+	}
+
+	return id;
+}
+
+RID RenderingDeviceRecorder::framebuffer_create(const Vector<RID> &p_texture_attachments, FramebufferFormatID p_format_check, uint32_t p_view_count) {
+	_THREAD_SAFE_METHOD_
+
+	FramebufferPass pass;
+
+	for (int i = 0; i < p_texture_attachments.size(); i++) {
+		Texture *texture = texture_owner.get_or_null(p_texture_attachments[i]);
+		ERR_FAIL_COND_V_MSG(!texture, RID(), "Texture index supplied for framebuffer (" + itos(i) + ") is not a valid texture.");
+
+		if (texture->format.usage_bits & TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+			pass.depth_attachment = i;
+		} else {
+			pass.color_attachments.push_back(i);
+		}
+	}
+
+	Vector<FramebufferPass> passes;
+	passes.push_back(pass);
+	return _framebuffer_create(p_texture_attachments, passes, p_format_check, p_view_count);
+}
+
+RID RenderingDeviceRecorder::framebuffer_create_multipass(const Vector<RID> &p_texture_attachments, Vector<FramebufferPass> &p_passes, FramebufferFormatID p_format_check, uint32_t p_view_count) {
+	return _framebuffer_create(p_texture_attachments, p_passes, p_format_check, p_view_count);
+}
+
+RID RenderingDeviceRecorder::framebuffer_create_empty(const Size2i &p_size, TextureSamples p_samples, FramebufferFormatID p_format_check) {
+	FramebufferFormatID format_id = framebuffer_format_create_empty(p_samples);
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_format_check != INVALID_FORMAT_ID && format_id != p_format_check, RID());
+
+	Framebuffer framebuffer;
+	framebuffer.format_id = format_id;
+	framebuffer.size = p_size;
+
+	return framebuffer_owner.make_rid(framebuffer);
+}
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecorder::framebuffer_get_format(RID p_framebuffer) {
+	_THREAD_SAFE_METHOD_
+
+	Framebuffer *framebuffer = framebuffer_owner.get_or_null(p_framebuffer);
+	ERR_FAIL_COND_V(!framebuffer, INVALID_ID);
+
+	return framebuffer->format_id;
+}
+
+/*****************/
+/**** SAMPLER ****/
+/*****************/
+
+RID RenderingDeviceRecorder::sampler_create(const SamplerState &p_state) {
+	_THREAD_SAFE_METHOD_
+
+	return sampler_owner.make_rid(p_state);
+}
+
+/**********************/
+/**** VERTEX ARRAY ****/
+/**********************/
+
+RID RenderingDeviceRecorder::_buffer_create(uint32_t p_size, const Vector<uint8_t> &p_data) {
+	ERR_FAIL_COND_V(p_data.size() && (uint32_t)p_data.size() != p_size, RID());
+
+	Buffer buffer;
+	buffer.size = p_size;
+	if (p_data.size()) {
+		buffer.data = p_data;
+	} else {
+		buffer.data.resize(p_size);
+		memset(buffer.data.ptrw(), 0, p_size);
+	}
+	buffer_memory += p_size;
+
+	return buffer_owner.make_rid(buffer);
+}
+
+RID RenderingDeviceRecorder::vertex_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data, bool p_use_as_storage) {
+	_THREAD_SAFE_METHOD_
+
+	return _buffer_create(p_size_bytes, p_data);
+}
+
+RenderingDevice::VertexFormatID RenderingDeviceRecorder::vertex_format_create(const Vector<VertexAttribute> &p_vertex_formats) {
+	_THREAD_SAFE_METHOD_
+
+	FormatKey key;
+	for (int i = 0; i < p_vertex_formats.size(); i++) {
+		const VertexAttribute &attribute = p_vertex_formats[i];
+		key.values.push_back(attribute.location);
+		key.values.push_back(attribute.offset);
+		key.values.push_back(attribute.format);
+		key.values.push_back(attribute.stride);
+		key.values.push_back(attribute.frequency);
+	}
+
+	const Map<FormatKey, VertexFormatID>::Element *E = vertex_format_cache.find(key);
+	if (E) {
+		return E->get();
+	}
+
+	VertexFormatID id = VertexFormatID(vertex_format_cache.size()) | (VertexFormatID(ID_TYPE_VERTEX_FORMAT) << ID_BASE_SHIFT);
+	vertex_format_cache[key] = id;
+	return id;
+}
+
+RID RenderingDeviceRecorder::vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_vertex_count == 0, RID());
+
+	for (int i = 0; i < p_src_buffers.size(); i++) {
+		ERR_FAIL_COND_V(!buffer_owner.owns(p_src_buffers[i]), RID());
+	}
+
+	VertexArray vertex_array;
+	vertex_array.vertex_count = p_vertex_count;
+
+	RID id = vertex_array_owner.make_rid(vertex_array);
+	for (int i = 0; i < p_src_buffers.size(); i++) {
+		_add_dependency(id, p_src_buffers[i]);
+	}
+
+	return id;
+}
+
+RID RenderingDeviceRecorder::index_buffer_create(uint32_t p_index_count, IndexBufferFormat p_format, const Vector<uint8_t> &p_data, bool p_use_restart_indices) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_index_count == 0, RID());
+
+	RID id = _buffer_create(p_index_count * (p_format == INDEX_BUFFER_FORMAT_UINT16 ? 2 : 4), p_data);
+	if (id.is_valid()) {
+		buffer_owner.get_or_null(id)->index_count = p_index_count;
+	}
+	return id;
+}
+
+RID RenderingDeviceRecorder::index_array_create(RID p_index_buffer, uint32_t p_index_offset, uint32_t p_index_count) {
+	_THREAD_SAFE_METHOD_
+
+	Buffer *index_buffer = buffer_owner.get_or_null(p_index_buffer);
+	ERR_FAIL_COND_V(!index_buffer, RID());
+	ERR_FAIL_COND_V(p_index_count == 0, RID());
+	ERR_FAIL_COND_V(p_index_offset + p_index_count > index_buffer->index_count, RID());
+
+	IndexArray index_array;
+	index_array.index_count = p_index_count;
+
+	RID id = index_array_owner.make_rid(index_array);
+	_add_dependency(id, p_index_buffer);
+	return id;
+}
+
+/****************/
+/**** SHADER ****/
+/****************/
+
+Vector<uint8_t> RenderingDeviceRecorder::shader_compile_spirv_from_source(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language, String *r_error, bool p_allow_cache) {
+	// Without reflection, find the vertex inputs by looking for their
+	// declarations, which is enough for the renderer's own shaders.
+	uint32_t vertex_input_mask = 0;
+	if (p_stage == SHADER_STAGE_VERTEX) {
+		Vector<String> lines = p_source_code.split("\n");
+		for (int i = 0; i < lines.size(); i++) {
+			String line = lines[i].replace(" ", "").replace("\t", "");
+			if (!line.begins_with("layout(location=") || line.find(")in") == -1) {
+				continue;
+			}
+			int location = line.get_slice("=", 1).get_slice(")", 0).to_int();
+			if (location >= 0 && location < 32) {
+				vertex_input_mask |= 1 << location;
+			}
+		}
+	}
+
+	Vector<uint8_t> spirv;
+	spirv.resize(12);
+	encode_uint32(RECORDER_SHADER_MAGIC, spirv.ptrw());
+	encode_uint32(p_stage, spirv.ptrw() + 4);
+	encode_uint32(vertex_input_mask, spirv.ptrw() + 8);
+	return spirv;
+}
+
+String RenderingDeviceRecorder::shader_get_binary_cache_key() const {
+	return "Recorder-SV" + itos(RECORDER_TRACE_VERSION);
+}
+
+Vector<uint8_t> RenderingDeviceRecorder::shader_compile_binary_from_spirv(const Vector<ShaderStageSPIRVData> &p_spirv, const String &p_shader_name) {
+	uint32_t stages = 0;
+	uint32_t vertex_input_mask = 0;
+
+	for (int i = 0; i < p_spirv.size(); i++) {
+		const Vector<uint8_t> &spirv = p_spirv[i].spir_v;
+		ERR_FAIL_COND_V_MSG(spirv.size() != 12 || decode_uint32(spirv.ptr()) != RECORDER_SHADER_MAGIC, Vector<uint8_t>(),
+				"Stage " + itos(p_spirv[i].shader_stage) + " of shader '" + p_shader_name + "' was not compiled by the recorder.");
+		ERR_FAIL_COND_V_MSG(stages & (1 << p_spirv[i].shader_stage), Vector<uint8_t>(),
+				"Stage " + itos(p_spirv[i].shader_stage) + " submitted more than once.");
+		stages |= 1 << p_spirv[i].shader_stage;
+		vertex_input_mask |= decode_uint32(spirv.ptr() + 8);
+	}
+
+	Vector<uint8_t> binary;
+	binary.resize(12);
+	encode_uint32(RECORDER_SHADER_MAGIC, binary.ptrw());
+	encode_uint32(stages, binary.ptrw() + 4);
+	encode_uint32(vertex_input_mask, binary.ptrw() + 8);
+	return binary;
+}
+
+RID RenderingDeviceRecorder::shader_create_from_bytecode(const Vector<uint8_t> &p_shader_binary) {
+	ERR_FAIL_COND_V(p_shader_binary.size() != 12 || decode_uint32(p_shader_binary.ptr()) != RECORDER_SHADER_MAGIC, RID());
+
+	_THREAD_SAFE_METHOD_
+
+	Shader shader;
+	shader.stages = decode_uint32(p_shader_binary.ptr() + 4);
+	shader.vertex_input_mask = decode_uint32(p_shader_binary.ptr() + 8);
+
+	return shader_owner.make_rid(shader);
+}
+
+uint32_t RenderingDeviceRecorder::shader_get_vertex_input_attribute_mask(RID p_shader) {
+	_THREAD_SAFE_METHOD_
+
+	const Shader *shader = shader_owner.get_or_null(p_shader);
+	ERR_FAIL_COND_V(!shader, 0);
+	return shader->vertex_input_mask;
+}
+
+/******************/
+/**** UNIFORMS ****/
+/******************/
+
+RID RenderingDeviceRecorder::uniform_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data) {
+	_THREAD_SAFE_METHOD_
+
+	return _buffer_create(p_size_bytes, p_data);
+}
+
+RID RenderingDeviceRecorder::storage_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data, uint32_t p_usage) {
+	_THREAD_SAFE_METHOD_
+
+	return _buffer_create(p_size_bytes, p_data);
+}
+
+RID RenderingDeviceRecorder::texture_buffer_create(uint32_t p_size_elements, DataFormat p_format, const Vector<uint8_t> &p_data) {
+	_THREAD_SAFE_METHOD_
+
+	// The element size is not needed for anything but the memory usage, so
+	// trust the data when there is some.
+	return _buffer_create(p_data.size() ? p_data.size() : p_size_elements * 4, p_data);
+}
+
+RID RenderingDeviceRecorder::uniform_set_create(const Vector<Uniform> &p_uniforms, RID p_shader, uint32_t p_shader_set) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_uniforms.size() == 0, RID());
+	ERR_FAIL_COND_V(!shader_owner.owns(p_shader), RID());
+
+	for (int i = 0; i < p_uniforms.size(); i++) {
+		const Uniform &uniform = p_uniforms[i];
+		for (int j = 0; j < uniform.ids.size(); j++) {
+			RID id = uniform.ids[j];
+			ERR_FAIL_COND_V_MSG(!(texture_owner.owns(id) || buffer_owner.owns(id) || sampler_owner.owns(id)), RID(),
+					"Uniform binding " + itos(uniform.binding) + " uses an invalid resource.");
+		}
+	}
+
+	UniformSet uniform_set;
+	uniform_set.shader = p_shader;
+	uniform_set.shader_set = p_shader_set;
+
+	RID id = uniform_set_owner.make_rid(uniform_set);
+	//add dependencies
+	_add_dependency(id, p_shader);
+	for (int i = 0; i < p_uniforms.size(); i++) {
+		const Uniform &uniform = p_uniforms[i];
+		for (int j = 0; j < uniform.ids.size(); j++) {
+			_add_dependency(id, uniform.ids[j]);
+		}
+	}
+
+	return id;
+}
+
+bool RenderingDeviceRecorder::uniform_set_is_valid(RID p_uniform_set) {
+	return uniform_set_owner.owns(p_uniform_set);
+}
+
+void RenderingDeviceRecorder::uniform_set_set_invalidation_callback(RID p_uniform_set, UniformSetInvalidatedCallback p_callback, void *p_userdata) {
+	UniformSet *uniform_set = uniform_set_owner.get_or_null(p_uniform_set);
+	ERR_FAIL_COND(!uniform_set);
+	uniform_set->invalidated_callback = p_callback;
+	uniform_set->invalidated_callback_userdata = p_userdata;
+}
+
+Error RenderingDeviceRecorder::buffer_update(RID p_buffer, uint32_t p_offset, uint32_t p_size, const void *p_data, uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(draw_list_active, ERR_INVALID_PARAMETER,
+			"Updating buffers is forbidden during creation of a draw list");
+	ERR_FAIL_COND_V_MSG(compute_list_active, ERR_INVALID_PARAMETER,
+			"Updating buffers is forbidden during creation of a compute list");
+
+	Buffer *buffer = buffer_owner.get_or_null(p_buffer);
+	ERR_FAIL_COND_V_MSG(!buffer, ERR_INVALID_PARAMETER, "Buffer argument is not a valid buffer of any type.");
+	ERR_FAIL_COND_V_MSG(p_offset + p_size > buffer->size, ERR_INVALID_PARAMETER,
+			"Attempted to write buffer (" + itos((p_offset + p_size) - buffer->size) + " bytes) past the end.");
+
+	memcpy(buffer->data.ptrw() + p_offset, p_data, p_size);
+
+	_push_command(COMMAND_BUFFER_UPDATE, p_buffer.get_id(), p_size, p_post_barrier);
+
+	return OK;
+}
+
+Error RenderingDeviceRecorder::buffer_clear(RID p_buffer, uint32_t p_offset, uint32_t p_size, uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG((p_size % 4) != 0, ERR_INVALID_PARAMETER,
+			"Size must be a multiple of four");
+	ERR_FAIL_COND_V_MSG(draw_list_active, ERR_INVALID_PARAMETER,
+			"Updating buffers in is forbidden during creation of a draw list");
+	ERR_FAIL_COND_V_MSG(compute_list_active, ERR_INVALID_PARAMETER,
+			"Updating buffers is forbidden during creation of a compute list");
+
+	Buffer *buffer = buffer_owner.get_or_null(p_buffer);
+	ERR_FAIL_COND_V_MSG(!buffer, ERR_INVALID_PARAMETER, "Buffer argument is not a valid buffer of any type.");
+	ERR_FAIL_COND_V_MSG(p_offset + p_size > buffer->size, ERR_INVALID_PARAMETER,
+			"Attempted to write buffer (" + itos((p_offset + p_size) - buffer->size) + " bytes) past the end.");
+
+	memset(buffer->data.ptrw() + p_offset, 0, p_size);
+
+	_push_command(COMMAND_BUFFER_CLEAR, p_buffer.get_id(), p_size, p_post_barrier);
+
+	return OK;
+}
+
+Vector<uint8_t> RenderingDeviceRecorder::buffer_get_data(RID p_buffer) {
+	_THREAD_SAFE_METHOD_
+
+	Buffer *buffer = buffer_owner.get_or_null(p_buffer);
+	ERR_FAIL_COND_V_MSG(!buffer, Vector<uint8_t>(), "Buffer is either invalid or this type of buffer can't be retrieved. Only Index and Vertex buffers allow retrieving.");
+
+	return buffer->data;
+}
+
+/*************************/
+/**** RENDER PIPELINE ****/
+/*************************/
+
+RID RenderingDeviceRecorder::render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, int p_dynamic_state_flags, uint32_t p_for_render_pass, const Vector<PipelineSpecializationConstant> &p_specialization_constants) {
+	_THREAD_SAFE_METHOD_
+
+	const Shader *shader = shader_owner.get_or_null(p_shader);
+	ERR_FAIL_COND_V(!shader, RID());
+	ERR_FAIL_COND_V_MSG(shader->stages & SHADER_STAGE_COMPUTE_BIT, RID(),
+			"Compute shaders can't be used in render pipelines");
+
+	uint64_t index = p_framebuffer_format & ((FramebufferFormatID(1) << FramebufferFormatID(ID_BASE_SHIFT)) - 1);
+	ERR_FAIL_COND_V(p_framebuffer_format < 0 || index >= framebuffer_formats.size(), RID());
+	ERR_FAIL_COND_V(p_for_render_pass >= framebuffer_formats[index].pass_count, RID());
+
+	Pipeline pipeline;
+	pipeline.shader = p_shader;
+	pipeline.framebuffer_format = p_framebuffer_format;
+
+	RID id = render_pipeline_owner.make_rid(pipeline);
+	//now add all the dependencies
+	_add_dependency(id, p_shader);
+	return id;
+}
+
+bool RenderingDeviceRecorder::render_pipeline_is_valid(RID p_pipeline) {
+	_THREAD_SAFE_METHOD_
+	return render_pipeline_owner.owns(p_pipeline);
+}
+
+/**************************/
+/**** COMPUTE PIPELINE ****/
+/**************************/
+
+RID RenderingDeviceRecorder::compute_pipeline_create(RID p_shader, const Vector<PipelineSpecializationConstant> &p_specialization_constants) {
+	_THREAD_SAFE_METHOD_
+
+	const Shader *shader = shader_owner.get_or_null(p_shader);
+	ERR_FAIL_COND_V(!shader, RID());
+	ERR_FAIL_COND_V_MSG(!(shader->stages & SHADER_STAGE_COMPUTE_BIT), RID(),
+			"Non-compute shaders can't be used in compute pipelines");
+
+	Pipeline pipeline;
+	pipeline.shader = p_shader;
+
+	RID id = compute_pipeline_owner.make_rid(pipeline);
+	//now add all the dependencies
+	_add_dependency(id, p_shader);
+	return id;
+}
+
+bool RenderingDeviceRecorder::compute_pipeline_is_valid(RID p_pipeline) {
+	return compute_pipeline_owner.owns(p_pipeline);
+}
+
+/****************/
+/**** SCREEN ****/
+/****************/
+
+int RenderingDeviceRecorder::screen_get_width(DisplayServer::WindowID p_screen) const {
+	return screen_size.width;
+}
+
+int RenderingDeviceRecorder::screen_get_height(DisplayServer::WindowID p_screen) const {
+	return screen_size.height;
+}
+
+RenderingDevice::FramebufferFormatID RenderingDeviceRecorder::screen_get_framebuffer_format() const {
+	return screen_format;
+}
+
+/*******************/
+/**** DRAW LIST ****/
+/*******************/
+
+void RenderingDeviceRecorder::_push_command(CommandType p_type, uint64_t p_arg0, uint64_t p_arg1, uint64_t p_arg2) {
+	if (frame_commands.is_empty()) {
+		frame_begin_usec = OS::get_singleton()->get_ticks_usec();
+	}
+
+	Command command;
+	command.type = p_type;
+	command.args[0] = p_arg0;
+	command.args[1] = p_arg1;
+	command.args[2] = p_arg2;
+	frame_commands.push_back(command);
+}
+
+RenderingDeviceRecorder::DrawList *RenderingDeviceRecorder::_get_draw_list_ptr(DrawListID p_id) {
+	if (p_id < 0) {
+		return nullptr;
+	}
+
+	if (!draw_list_active) {
+		return nullptr;
+	} else if (p_id == (int64_t(ID_TYPE_DRAW_LIST) << ID_BASE_SHIFT)) {
+		if (draw_list_split_count) {
+			return nullptr;
+		}
+		return &draw_lists[0];
+	} else if (p_id >> DrawListID(ID_BASE_SHIFT) == ID_TYPE_SPLIT_DRAW_LIST) {
+		if (!draw_list_split_count) {
+			return nullptr;
+		}
+
+		uint64_t index = p_id & ((DrawListID(1) << DrawListID(ID_BASE_SHIFT)) - 1); //mask
+
+		if (index >= draw_list_split_count) {
+			return nullptr;
+		}
+
+		return &draw_lists[index];
+	} else {
+		return nullptr;
+	}
+}
+
+Error RenderingDeviceRecorder::_draw_list_begin(RID p_framebuffer, uint32_t p_splits, DrawListID *r_split_ids) {
+	ERR_FAIL_COND_V_MSG(draw_list_active, ERR_BUSY, "Only one draw list can be active at the same time.");
+	ERR_FAIL_COND_V_MSG(compute_list_active, ERR_BUSY, "Only one draw/compute list can be active at the same time.");
+
+	Framebuffer *framebuffer = framebuffer_owner.get_or_null(p_framebuffer);
+	ERR_FAIL_COND_V(!framebuffer, ERR_INVALID_PARAMETER);
+
+	uint64_t format_index = framebuffer->format_id & ((FramebufferFormatID(1) << FramebufferFormatID(ID_BASE_SHIFT)) - 1);
+	ERR_FAIL_UNSIGNED_INDEX_V(format_index, framebuffer_formats.size(), ERR_BUG);
+
+	_push_command(COMMAND_DRAW_LIST_BEGIN, p_framebuffer.get_id(), p_splits);
+
+	draw_list_active = true;
+	draw_list_begin_usec = OS::get_singleton()->get_ticks_usec();
+	draw_list_current_pass = 0;
+	draw_list_pass_count = framebuffer_formats[format_index].pass_count;
+	draw_list_split_count = p_splits;
+	draw_lists.resize(MAX(p_splits, 1u));
+	for (uint32_t i = 0; i < draw_lists.size(); i++) {
+		draw_lists[i].commands.clear();
+		draw_lists[i].vertex_count = 0;
+		draw_lists[i].index_count = 0;
+	}
+
+	for (uint32_t i = 0; i < p_splits; i++) {
+		r_split_ids[i] = (int64_t(ID_TYPE_SPLIT_DRAW_LIST) << ID_BASE_SHIFT) + i;
+	}
+
+	return OK;
+}
+
+void RenderingDeviceRecorder::_draw_list_flush() {
+	for (uint32_t i = 0; i < draw_lists.size(); i++) {
+		DrawList &draw_list = draw_lists[i];
+		if (draw_list_split_count) {
+			_push_command(COMMAND_DRAW_LIST_SPLIT, i);
+		}
+		for (uint32_t j = 0; j < draw_list.commands.size(); j++) {
+			frame_commands.push_back(draw_list.commands[j]);
+		}
+		draw_list.commands.clear();
+		draw_list.vertex_count = 0;
+		draw_list.index_count = 0;
+	}
+}
+
+RenderingDevice::DrawListID RenderingDeviceRecorder::draw_list_begin_for_screen(DisplayServer::WindowID p_screen, const Color &p_clear_color) {
+	_THREAD_SAFE_METHOD_
+
+	if (_draw_list_begin(screen_framebuffer, 0, nullptr) != OK) {
+		return INVALID_ID;
+	}
+
+	return int64_t(ID_TYPE_DRAW_LIST) << ID_BASE_SHIFT;
+}
+
+RenderingDevice::DrawListID RenderingDeviceRecorder::draw_list_begin(RID p_framebuffer, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values, float p_clear_depth, uint32_t p_clear_stencil, const Rect2 &p_region, const Vector<RID> &p_storage_textures) {
+	_THREAD_SAFE_METHOD_
+
+	if (_draw_list_begin(p_framebuffer, 0, nullptr) != OK) {
+		return INVALID_ID;
+	}
+
+	return int64_t(ID_TYPE_DRAW_LIST) << ID_BASE_SHIFT;
+}
+
+Error RenderingDeviceRecorder::draw_list_begin_split(RID p_framebuffer, uint32_t p_splits, DrawListID *r_split_ids, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values, float p_clear_depth, uint32_t p_clear_stencil, const Rect2 &p_region, const Vector<RID> &p_storage_textures) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(p_splits < 1, ERR_INVALID_DECLARATION);
+	ERR_FAIL_COND_V(!r_split_ids, ERR_INVALID_PARAMETER);
+
+	return _draw_list_begin(p_framebuffer, p_splits, r_split_ids);
+}
+
+void RenderingDeviceRecorder::draw_list_bind_render_pipeline(DrawListID p_list, RID p_render_pipeline) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_BIND_RENDER_PIPELINE, { p_render_pipeline.get_id(), 0, 0 } });
+}
+
+void RenderingDeviceRecorder::draw_list_bind_uniform_set(DrawListID p_list, RID p_uniform_set, uint32_t p_index) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_BIND_UNIFORM_SET, { p_uniform_set.get_id(), p_index, 0 } });
+}
+
+void RenderingDeviceRecorder::draw_list_bind_vertex_array(DrawListID p_list, RID p_vertex_array) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	const VertexArray *vertex_array = vertex_array_owner.get_or_null(p_vertex_array);
+	ERR_FAIL_COND(!vertex_array);
+	dl->vertex_count = vertex_array->vertex_count;
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_BIND_VERTEX_ARRAY, { p_vertex_array.get_id(), 0, 0 } });
+}
+
+void RenderingDeviceRecorder::draw_list_bind_index_array(DrawListID p_list, RID p_index_array) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	const IndexArray *index_array = index_array_owner.get_or_null(p_index_array);
+	ERR_FAIL_COND(!index_array);
+	dl->index_count = index_array->index_count;
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_BIND_INDEX_ARRAY, { p_index_array.get_id(), 0, 0 } });
+}
+
+void RenderingDeviceRecorder::draw_list_set_line_width(DrawListID p_list, float p_width) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_SET_LINE_WIDTH, {} });
+}
+
+void RenderingDeviceRecorder::draw_list_set_push_constant(DrawListID p_list, const void *p_data, uint32_t p_data_size) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_SET_PUSH_CONSTANT, { p_data_size, hash_djb2_buffer((const uint8_t *)p_data, p_data_size), 0 } });
+}
+
+void RenderingDeviceRecorder::draw_list_draw(DrawListID p_list, bool p_use_indices, uint32_t p_instances, uint32_t p_procedural_vertices) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	uint32_t elements;
+	if (p_use_indices) {
+		ERR_FAIL_COND_MSG(p_procedural_vertices > 0,
+				"Procedural vertices can't be used together with indices.");
+		elements = dl->index_count;
+	} else {
+		elements = p_procedural_vertices > 0 ? p_procedural_vertices : dl->vertex_count;
+	}
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_DRAW, { p_use_indices, p_instances, elements } });
+}
+
+void RenderingDeviceRecorder::draw_list_enable_scissor(DrawListID p_list, const Rect2 &p_rect) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_ENABLE_SCISSOR, {} });
+}
+
+void RenderingDeviceRecorder::draw_list_disable_scissor(DrawListID p_list) {
+	DrawList *dl = _get_draw_list_ptr(p_list);
+	ERR_FAIL_COND(!dl);
+
+	dl->commands.push_back({ COMMAND_DRAW_LIST_DISABLE_SCISSOR, {} });
+}
+
+uint32_t RenderingDeviceRecorder::draw_list_get_current_pass() {
+	return draw_list_current_pass;
+}
+
+RenderingDevice::DrawListID RenderingDeviceRecorder::draw_list_switch_to_next_pass() {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(!draw_list_active || draw_list_split_count, INVALID_FORMAT_ID);
+	ERR_FAIL_COND_V(draw_list_current_pass + 1 >= draw_list_pass_count, INVALID_FORMAT_ID);
+
+	_draw_list_flush();
+	_push_command(COMMAND_DRAW_LIST_NEXT_PASS, 0);
+	draw_list_current_pass++;
+
+	return int64_t(ID_TYPE_DRAW_LIST) << ID_BASE_SHIFT;
+}
+
+Error RenderingDeviceRecorder::draw_list_switch_to_next_pass_split(uint32_t p_splits, DrawListID *r_split_ids) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(!draw_list_active || !draw_list_split_count, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(draw_list_current_pass + 1 >= draw_list_pass_count, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_splits < 1 || !r_split_ids, ERR_INVALID_PARAMETER);
+
+	_draw_list_flush();
+	_push_command(COMMAND_DRAW_LIST_NEXT_PASS, p_splits);
+	draw_list_current_pass++;
+
+	draw_list_split_count = p_splits;
+	draw_lists.resize(p_splits);
+	for (uint32_t i = 0; i < p_splits; i++) {
+		r_split_ids[i] = (int64_t(ID_TYPE_SPLIT_DRAW_LIST) << ID_BASE_SHIFT) + i;
+	}
+
+	return OK;
+}
+
+void RenderingDeviceRecorder::draw_list_end(uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_MSG(!draw_list_active, "Immediate draw list is already inactive.");
+
+	_draw_list_flush();
+	_push_command(COMMAND_DRAW_LIST_END, p_post_barrier, OS::get_singleton()->get_ticks_usec() - draw_list_begin_usec);
+
+	draw_list_active = false;
+	draw_list_split_count = 0;
+}
+
+/***********************/
+/**** COMPUTE LISTS ****/
+/***********************/
+
+RenderingDevice::ComputeListID RenderingDeviceRecorder::compute_list_begin(bool p_allow_draw_overlap) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V_MSG(!p_allow_draw_overlap && draw_list_active, INVALID_ID, "Only one draw/compute list can be active at the same time.");
+	ERR_FAIL_COND_V_MSG(compute_list_active, INVALID_ID, "Only one draw/compute list can be active at the same time.");
+
+	_push_command(COMMAND_COMPUTE_LIST_BEGIN);
+	compute_list_active = true;
+	compute_list_begin_usec = OS::get_singleton()->get_ticks_usec();
+
+	return ID_TYPE_COMPUTE_LIST;
+}
+
+void RenderingDeviceRecorder::compute_list_bind_compute_pipeline(ComputeListID p_list, RID p_compute_pipeline) {
+	ERR_FAIL_COND(p_list != ID_TYPE_COMPUTE_LIST);
+	ERR_FAIL_COND(!compute_list_active);
+
+	_push_command(COMMAND_COMPUTE_LIST_BIND_PIPELINE, p_compute_pipeline.get_id());
+}
+
+void RenderingDeviceRecorder::compute_list_bind_uniform_set(ComputeListID p_list, RID p_uniform_set, uint32_t p_index) {
+	ERR_FAIL_COND(p_list != ID_TYPE_COMPUTE_LIST);
+	ERR_FAIL_COND(!compute_list_active);
+
+	_push_command(COMMAND_COMPUTE_LIST_BIND_UNIFORM_SET, p_uniform_set.get_id(), p_index);
+}
+
+void RenderingDeviceRecorder::compute_list_set_push_constant(ComputeListID p_list, const void *p_data, uint32_t p_data_size) {
+	ERR_FAIL_COND(p_list != ID_TYPE_COMPUTE_LIST);
+	ERR_FAIL_COND(!compute_list_active);
+
+	_push_command(COMMAND_COMPUTE_LIST_SET_PUSH_CONSTANT, p_data_size, hash_djb2_buffer((const uint8_t *)p_data, p_data_size));
+}
+
+void RenderingDeviceRecorder::compute_list_dispatch(ComputeListID p_list, uint32_t p_x_groups, uint32_t p_y_groups, uint32_t p_z_groups) {
+	ERR_FAIL_COND(p_list != ID_TYPE_COMPUTE_LIST);
+	ERR_FAIL_COND(!compute_list_active);
+
+	_push_command(COMMAND_COMPUTE_LIST_DISPATCH, p_x_groups, p_y_groups, p_z_groups);
+}
+
+void RenderingDeviceRecorder::compute_list_dispatch_threads(ComputeListID p_list, uint32_t p_x_threads, uint32_t p_y_threads, uint32_t p_z_threads) {
+	// Local group sizes are not known without reflection, assume 8x8x1.
+	compute_list_dispatch(p_list, (p_x_threads + 7) / 8, (p_y_threads + 7) / 8, p_z_threads);
+}
+
+void RenderingDeviceRecorder::compute_list_dispatch_indirect(ComputeListID p_list, RID p_buffer, uint32_t p_offset) {
+	ERR_FAIL_COND(p_list != ID_TYPE_COMPUTE_LIST);
+	ERR_FAIL_COND(!compute_list_active);
+
+	_push_command(COMMAND_COMPUTE_LIST_DISPATCH_INDIRECT, p_buffer.get_id(), p_offset);
+}
+
+void RenderingDeviceRecorder::compute_list_add_barrier(ComputeListID p_list) {
+	ERR_FAIL_COND(p_list != ID_TYPE_COMPUTE_LIST);
+	ERR_FAIL_COND(!compute_list_active);
+
+	_push_command(COMMAND_COMPUTE_LIST_ADD_BARRIER);
+}
+
+void RenderingDeviceRecorder::compute_list_end(uint32_t p_post_barrier) {
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND(!compute_list_active);
+
+	_push_command(COMMAND_COMPUTE_LIST_END, p_post_barrier, OS::get_singleton()->get_ticks_usec() - compute_list_begin_usec);
+	compute_list_active = false;
+}
+
+void RenderingDeviceRecorder::barrier(uint32_t p_from, uint32_t p_to) {
+	_THREAD_SAFE_METHOD_
+
+	_push_command(COMMAND_BARRIER, p_from, p_to);
+}
+
+void RenderingDeviceRecorder::full_barrier() {
+	_THREAD_SAFE_METHOD_
+
+	_push_command(COMMAND_FULL_BARRIER);
+}
+
+/**************************/
+/**** FRAME MANAGEMENT ****/
+/**************************/
+
+void RenderingDeviceRecorder::free(RID p_id) {
+	_THREAD_SAFE_METHOD_
+
+	_free_dependencies(p_id); //recursively erase dependencies first, to avoid potential API problems
+
+	if (texture_owner.owns(p_id)) {
+		Texture *texture = texture_owner.get_or_null(p_id);
+		for (int i = 0; i < texture->data.size(); i++) {
+			texture_memory -= texture->data[i].size();
+		}
+		texture_owner.free(p_id);
+	} else if (framebuffer_owner.owns(p_id)) {
+		framebuffer_owner.free(p_id);
+	} else if (sampler_owner.owns(p_id)) {
+		sampler_owner.free(p_id);
+	} else if (buffer_owner.owns(p_id)) {
+		buffer_memory -= buffer_owner.get_or_null(p_id)->size;
+		buffer_owner.free(p_id);
+	} else if (vertex_array_owner.owns(p_id)) {
+		vertex_array_owner.free(p_id);
+	} else if (index_array_owner.owns(p_id)) {
+		index_array_owner.free(p_id);
+	} else if (shader_owner.owns(p_id)) {
+		shader_owner.free(p_id);
+	} else if (uniform_set_owner.owns(p_id)) {
+		UniformSet *uniform_set = uniform_set_owner.get_or_null(p_id);
+		UniformSetInvalidatedCallback callback = uniform_set->invalidated_callback;
+		void *userdata = uniform_set->invalidated_callback_userdata;
+		uniform_set_owner.free(p_id);
+
+		if (callback != nullptr) {
+			callback(userdata);
+		}
+	} else if (render_pipeline_owner.owns(p_id)) {
+		render_pipeline_owner.free(p_id);
+	} else if (compute_pipeline_owner.owns(p_id)) {
+		compute_pipeline_owner.free(p_id);
+	} else {
+		ERR_PRINT("Attempted to free invalid ID: " + itos(p_id.get_id()));
+	}
+}
+
+void RenderingDeviceRecorder::capture_timestamp(const String &p_name) {
+	Timestamp timestamp;
+	timestamp.name = p_name;
+	timestamp.usec = OS::get_singleton()->get_ticks_usec();
+	timestamps[0].push_back(timestamp);
+}
+
+uint32_t RenderingDeviceRecorder::get_captured_timestamps_count() const {
+	return timestamps[1].size();
+}
+
+uint64_t RenderingDeviceRecorder::get_captured_timestamps_frame() const {
+	return timestamps_frame;
+}
+
+uint64_t RenderingDeviceRecorder::get_captured_timestamp_gpu_time(uint32_t p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, timestamps[1].size(), 0);
+	// Nothing runs on a GPU, so report the CPU time in nanoseconds like drivers do.
+	return timestamps[1][p_index].usec * 1000;
+}
+
+uint64_t RenderingDeviceRecorder::get_captured_timestamp_cpu_time(uint32_t p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, timestamps[1].size(), 0);
+	return timestamps[1][p_index].usec;
+}
+
+String RenderingDeviceRecorder::get_captured_timestamp_name(uint32_t p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, timestamps[1].size(), String());
+	return timestamps[1][p_index].name;
+}
+
+int RenderingDeviceRecorder::limit_get(Limit p_limit) {
+	// Typical values of a desktop GPU, so the renderer picks its usual paths.
+	switch (p_limit) {
+		case LIMIT_MAX_BOUND_UNIFORM_SETS:
+			return 8;
+		case LIMIT_MAX_FRAMEBUFFER_COLOR_ATTACHMENTS:
+			return 8;
+		case LIMIT_MAX_TEXTURES_PER_UNIFORM_SET:
+		case LIMIT_MAX_SAMPLERS_PER_UNIFORM_SET:
+		case LIMIT_MAX_STORAGE_BUFFERS_PER_UNIFORM_SET:
+		case LIMIT_MAX_STORAGE_IMAGES_PER_UNIFORM_SET:
+		case LIMIT_MAX_TEXTURES_PER_SHADER_STAGE:
+		case LIMIT_MAX_SAMPLERS_PER_SHADER_STAGE:
+		case LIMIT_MAX_STORAGE_BUFFERS_PER_SHADER_STAGE:
+		case LIMIT_MAX_STORAGE_IMAGES_PER_SHADER_STAGE:
+			return 1048576;
+		case LIMIT_MAX_UNIFORM_BUFFERS_PER_UNIFORM_SET:
+		case LIMIT_MAX_UNIFORM_BUFFERS_PER_SHADER_STAGE:
+			return 15;
+		case LIMIT_MAX_DRAW_INDEXED_INDEX:
+			return 0x7FFFFFFF;
+		case LIMIT_MAX_FRAMEBUFFER_HEIGHT:
+		case LIMIT_MAX_FRAMEBUFFER_WIDTH:
+		case LIMIT_MAX_TEXTURE_SIZE_1D:
+		case LIMIT_MAX_TEXTURE_SIZE_2D:
+		case LIMIT_MAX_TEXTURE_SIZE_CUBE:
+			return 16384;
+		case LIMIT_MAX_TEXTURE_SIZE_3D:
+			return 2048;
+		case LIMIT_MAX_TEXTURE_ARRAY_LAYERS:
+			return 2048;
+		case LIMIT_MAX_PUSH_CONSTANT_SIZE:
+			return 128;
+		case LIMIT_MAX_UNIFORM_BUFFER_SIZE:
+			return 65536;
+		case LIMIT_MAX_VERTEX_INPUT_ATTRIBUTE_OFFSET:
+			return 2047;
+		case LIMIT_MAX_VERTEX_INPUT_ATTRIBUTES:
+		case LIMIT_MAX_VERTEX_INPUT_BINDINGS:
+			return 32;
+		case LIMIT_MAX_VERTEX_INPUT_BINDING_STRIDE:
+			return 2048;
+		case LIMIT_MIN_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+			return 256;
+		case LIMIT_MAX_COMPUTE_SHARED_MEMORY_SIZE:
+			return 49152;
+		case LIMIT_MAX_COMPUTE_WORKGROUP_COUNT_X:
+		case LIMIT_MAX_COMPUTE_WORKGROUP_COUNT_Y:
+		case LIMIT_MAX_COMPUTE_WORKGROUP_COUNT_Z:
+			return 65535;
+		case LIMIT_MAX_COMPUTE_WORKGROUP_INVOCATIONS:
+		case LIMIT_MAX_COMPUTE_WORKGROUP_SIZE_X:
+		case LIMIT_MAX_COMPUTE_WORKGROUP_SIZE_Y:
+			return 1024;
+		case LIMIT_MAX_COMPUTE_WORKGROUP_SIZE_Z:
+			return 64;
+		default:
+			ERR_FAIL_V(0);
+	}
+
+	return 0;
+}
+
+void RenderingDeviceRecorder::prepare_screen_for_drawing() {
+}
+
+void RenderingDeviceRecorder::_end_frame() {
+	ERR_FAIL_COND_MSG(draw_list_active, "A draw list was left open at the end of the frame.");
+	ERR_FAIL_COND_MSG(compute_list_active, "A compute list was left open at the end of the frame.");
+
+	uint64_t frame_usec = frame_commands.is_empty() ? 0 : OS::get_singleton()->get_ticks_usec() - frame_begin_usec;
+	_push_command(COMMAND_FRAME_END, frame_usec);
+
+	replay_trace(frame_commands, stats);
+	if (keep_trace) {
+		for (uint32_t i = 0; i < frame_commands.size(); i++) {
+			trace.push_back(frame_commands[i]);
+		}
+	}
+	frame_commands.clear();
+
+	timestamps[1] = timestamps[0];
+	timestamps[0].clear();
+	timestamps_frame = frames_drawn;
+	frames_drawn++;
+}
+
+void RenderingDeviceRecorder::swap_buffers() {
+	_THREAD_SAFE_METHOD_
+
+	_end_frame();
+}
+
+uint32_t RenderingDeviceRecorder::get_frame_delay() const {
+	return 1;
+}
+
+void RenderingDeviceRecorder::submit() {
+	_THREAD_SAFE_METHOD_
+
+	_end_frame();
+}
+
+void RenderingDeviceRecorder::sync() {
+}
+
+uint64_t RenderingDeviceRecorder::get_memory_usage(MemoryType p_type) const {
+	switch (p_type) {
+		case MEMORY_TEXTURES:
+			return texture_memory;
+		case MEMORY_BUFFERS:
+			return buffer_memory;
+		case MEMORY_TOTAL:
+			return texture_memory + buffer_memory;
+		default:
+			return 0;
+	}
+}
+
+RenderingDevice *RenderingDeviceRecorder::create_local_device() {
+	RenderingDeviceRecorder *rd = memnew(RenderingDeviceRecorder);
+	rd->initialize(Size2i());
+	return rd;
+}
+
+void RenderingDeviceRecorder::set_resource_name(RID p_id, const String p_name) {
+}
+
+void RenderingDeviceRecorder::draw_command_begin_label(String p_label_name, const Color p_color) {
+}
+
+void RenderingDeviceRecorder::draw_command_insert_label(String p_label_name, const Color p_color) {
+}
+
+void RenderingDeviceRecorder::draw_command_end_label() {
+}
+
+String RenderingDeviceRecorder::get_device_vendor_name() const {
+	return "Godot";
+}
+
+String RenderingDeviceRecorder::get_device_name() const {
+	return "Command Recorder";
+}
+
+RenderingDevice::DeviceType RenderingDeviceRecorder::get_device_type() const {
+	return DEVICE_TYPE_CPU;
+}
+
+String RenderingDeviceRecorder::get_device_pipeline_cache_uuid() const {
+	return "recorder";
+}
+
+uint64_t RenderingDeviceRecorder::get_driver_resource(DriverResource p_resource, RID p_rid, uint64_t p_index) {
+	return 0;
+}
+
+/*******************/
+/**** RECORDING ****/
+/*******************/
+
+void RenderingDeviceRecorder::set_trace_path(const String &p_path) {
+	trace_path = p_path;
+}
+
+void RenderingDeviceRecorder::set_keep_trace(bool p_keep) {
+	keep_trace = p_keep;
+	if (!keep_trace) {
+		trace.clear();
+	}
+}
+
+Error RenderingDeviceRecorder::save_trace(const String &p_path, const LocalVector<Command> &p_trace) {
+	Error err;
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err, err, "Can't save RenderingDevice trace to file '" + p_path + "'.");
+
+	f->store_buffer((const uint8_t *)"RDTR", 4);
+	f->store_32(RECORDER_TRACE_VERSION);
+	f->store_64(p_trace.size());
+	for (uint32_t i = 0; i < p_trace.size(); i++) {
+		const Command &command = p_trace[i];
+		f->store_8(command.type);
+		f->store_64(command.args[0]);
+		f->store_64(command.args[1]);
+		f->store_64(command.args[2]);
+	}
+
+	return OK;
+}
+
+Error RenderingDeviceRecorder::load_trace(const String &p_path, LocalVector<Command> &r_trace) {
+	Error err;
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(err, err, "Can't open RenderingDevice trace file '" + p_path + "'.");
+
+	uint8_t header[4];
+	f->get_buffer(header, 4);
+	ERR_FAIL_COND_V_MSG(header[0] != 'R' || header[1] != 'D' || header[2] != 'T' || header[3] != 'R', ERR_FILE_UNRECOGNIZED,
+			"'" + p_path + "' is not a RenderingDevice trace.");
+	uint32_t version = f->get_32();
+	ERR_FAIL_COND_V_MSG(version != RECORDER_TRACE_VERSION, ERR_FILE_UNRECOGNIZED,
+			"Unsupported RenderingDevice trace version: " + itos(version) + ".");
+
+	uint64_t count = f->get_64();
+	r_trace.clear();
+	r_trace.reserve(count);
+	for (uint64_t i = 0; i < count; i++) {
+		Command command;
+		uint8_t type = f->get_8();
+		ERR_FAIL_COND_V_MSG(type >= COMMAND_MAX || f->eof_reached(), ERR_FILE_CORRUPT,
+				"RenderingDevice trace '" + p_path + "' is corrupt.");
+		command.type = CommandType(type);
+		command.args[0] = f->get_64();
+		command.args[1] = f->get_64();
+		command.args[2] = f->get_64();
+		r_trace.push_back(command);
+	}
+
+	return OK;
+}
+
+void RenderingDeviceRecorder::replay_trace(const LocalVector<Command> &p_trace, Stats &r_stats) {
+	// Bound state, reset whenever a driver would start a new command buffer.
+	static const uint32_t MAX_UNIFORM_SETS = 16;
+	uint64_t pipeline = 0;
+	uint64_t uniform_sets[MAX_UNIFORM_SETS] = {};
+	uint64_t vertex_array = 0;
+	uint64_t index_array = 0;
+	uint64_t push_constant_size = 0;
+	uint64_t push_constant_hash = 0;
+	bool push_constant_set = false;
+
+	// Barrier tracking: a barrier is redundant when nothing was written
+	// since the previous one, and mergeable when it only separates two
+	// transfers that could have been recorded under a single barrier.
+	bool pending_writes = false;
+	bool last_was_transfer_barrier = false;
+
+	r_stats.commands += p_trace.size();
+
+	for (uint32_t i = 0; i < p_trace.size(); i++) {
+		const Command &command = p_trace[i];
+
+		bool is_transfer = false;
+		uint64_t post_barrier = BARRIER_MASK_NO_BARRIER;
+
+		switch (command.type) {
+			case COMMAND_TEXTURE_UPDATE: {
+				r_stats.texture_updates++;
+				r_stats.texture_update_bytes += command.args[1];
+				is_transfer = true;
+				post_barrier = command.args[2];
+			} break;
+			case COMMAND_BUFFER_UPDATE:
+			case COMMAND_BUFFER_CLEAR: {
+				r_stats.buffer_updates++;
+				r_stats.buffer_update_bytes += command.args[1];
+				is_transfer = true;
+				post_barrier = command.args[2];
+			} break;
+			case COMMAND_TEXTURE_COPY:
+			case COMMAND_TEXTURE_CLEAR:
+			case COMMAND_TEXTURE_RESOLVE: {
+				is_transfer = true;
+				post_barrier = command.args[2];
+			} break;
+			case COMMAND_DRAW_LIST_BEGIN:
+			case COMMAND_DRAW_LIST_SPLIT:
+			case COMMAND_DRAW_LIST_NEXT_PASS:
+			case COMMAND_COMPUTE_LIST_BEGIN: {
+				if (command.type == COMMAND_DRAW_LIST_BEGIN) {
+					r_stats.draw_lists++;
+				} else if (command.type == COMMAND_DRAW_LIST_SPLIT) {
+					r_stats.split_draw_lists++;
+				} else if (command.type == COMMAND_COMPUTE_LIST_BEGIN) {
+					r_stats.compute_lists++;
+				}
+				pipeline = 0;
+				for (uint32_t j = 0; j < MAX_UNIFORM_SETS; j++) {
+					uniform_sets[j] = 0;
+				}
+				vertex_array = 0;
+				index_array = 0;
+				push_constant_set = false;
+			} break;
+			case COMMAND_DRAW_LIST_BIND_RENDER_PIPELINE:
+			case COMMAND_COMPUTE_LIST_BIND_PIPELINE: {
+				r_stats.pipeline_binds++;
+				if (pipeline == command.args[0]) {
+					r_stats.redundant_pipeline_binds++;
+				}
+				pipeline = command.args[0];
+			} break;
+			case COMMAND_DRAW_LIST_BIND_UNIFORM_SET:
+			case COMMAND_COMPUTE_LIST_BIND_UNIFORM_SET: {
+				r_stats.uniform_set_binds++;
+				if (command.args[1] < MAX_UNIFORM_SETS) {
+					if (uniform_sets[command.args[1]] == command.args[0]) {
+						r_stats.redundant_uniform_set_binds++;
+					}
+					uniform_sets[command.args[1]] = command.args[0];
+				}
+			} break;
+			case COMMAND_DRAW_LIST_BIND_VERTEX_ARRAY: {
+				r_stats.array_binds++;
+				if (vertex_array == command.args[0]) {
+					r_stats.redundant_array_binds++;
+				}
+				vertex_array = command.args[0];
+			} break;
+			case COMMAND_DRAW_LIST_BIND_INDEX_ARRAY: {
+				r_stats.array_binds++;
+				if (index_array == command.args[0]) {
+					r_stats.redundant_array_binds++;
+				}
+				index_array = command.args[0];
+			} break;
+			case COMMAND_DRAW_LIST_SET_PUSH_CONSTANT:
+			case COMMAND_COMPUTE_LIST_SET_PUSH_CONSTANT: {
+				r_stats.push_constants++;
+				if (push_constant_set && push_constant_size == command.args[0] && push_constant_hash == command.args[1]) {
+					r_stats.redundant_push_constants++;
+				}
+				push_constant_set = true;
+				push_constant_size = command.args[0];
+				push_constant_hash = command.args[1];
+			} break;
+			case COMMAND_DRAW_LIST_DRAW: {
+				r_stats.draws++;
+				r_stats.instances += command.args[1];
+				r_stats.elements += command.args[2] * command.args[1];
+			} break;
+			case COMMAND_DRAW_LIST_END: {
+				r_stats.draw_list_usec += command.args[1];
+				pending_writes = true;
+				post_barrier = command.args[0];
+			} break;
+			case COMMAND_COMPUTE_LIST_DISPATCH:
+			case COMMAND_COMPUTE_LIST_DISPATCH_INDIRECT: {
+				r_stats.dispatches++;
+				pending_writes = true;
+			} break;
+			case COMMAND_COMPUTE_LIST_ADD_BARRIER: {
+				post_barrier = BARRIER_MASK_COMPUTE;
+			} break;
+			case COMMAND_COMPUTE_LIST_END: {
+				r_stats.compute_list_usec += command.args[1];
+				post_barrier = command.args[0];
+			} break;
+			case COMMAND_BARRIER: {
+				post_barrier = command.args[0] | command.args[1];
+			} break;
+			case COMMAND_FULL_BARRIER: {
+				post_barrier = BARRIER_MASK_ALL;
+			} break;
+			case COMMAND_FRAME_END: {
+				r_stats.frames++;
+				r_stats.frame_usec += command.args[0];
+				r_stats.max_frame_usec = MAX(r_stats.max_frame_usec, command.args[0]);
+			} break;
+			default: {
+			}
+		}
+
+		if (is_transfer) {
+			pending_writes = true;
+		}
+
+		if (post_barrier & BARRIER_MASK_NO_BARRIER || !(post_barrier & BARRIER_MASK_ALL)) {
+			if (!is_transfer && command.type != COMMAND_FRAME_END) {
+				last_was_transfer_barrier = false;
+			}
+			continue;
+		}
+
+		r_stats.barriers++;
+		if (!pending_writes) {
+			r_stats.redundant_barriers++;
+		} else if (is_transfer && last_was_transfer_barrier) {
+			r_stats.mergeable_barriers++;
+		}
+		pending_writes = false;
+		last_was_transfer_barrier = is_transfer;
+	}
+}
+
+void RenderingDeviceRecorder::print_stats(const Stats &p_stats) {
+	double frames = MAX(p_stats.frames, 1u);
+#define PER_FRAME(m_value) String::num(double(m_value) / frames, 1)
+
+	print_line(vformat("RenderingDevice trace: %d frames, %d commands (%s per frame).", p_stats.frames, p_stats.commands, PER_FRAME(p_stats.commands)));
+	print_line(vformat("CPU time per frame: %.3f ms (max %.3f ms), building draw lists %.3f ms, compute lists %.3f ms.", p_stats.frame_usec / frames / 1000.0, p_stats.max_frame_usec / 1000.0, p_stats.draw_list_usec / frames / 1000.0, p_stats.compute_list_usec / frames / 1000.0));
+	print_line("Lists per frame: " + PER_FRAME(p_stats.draw_lists) + " draw lists (" + PER_FRAME(p_stats.split_draw_lists) + " splits), " + PER_FRAME(p_stats.compute_lists) + " compute lists.");
+	print_line("Work per frame: " + PER_FRAME(p_stats.draws) + " draws, " + PER_FRAME(p_stats.instances) + " instances, " + PER_FRAME(p_stats.elements) + " elements, " + PER_FRAME(p_stats.dispatches) + " dispatches.");
+	print_line("State changes per frame: " + PER_FRAME(p_stats.pipeline_binds) + " pipelines (" + PER_FRAME(p_stats.redundant_pipeline_binds) + " redundant), " +
+			PER_FRAME(p_stats.uniform_set_binds) + " uniform sets (" + PER_FRAME(p_stats.redundant_uniform_set_binds) + " redundant), " +
+			PER_FRAME(p_stats.array_binds) + " vertex/index arrays (" + PER_FRAME(p_stats.redundant_array_binds) + " redundant), " +
+			PER_FRAME(p_stats.push_constants) + " push constants (" + PER_FRAME(p_stats.redundant_push_constants) + " redundant).");
+	print_line("Uploads per frame: " + PER_FRAME(p_stats.buffer_updates) + " buffer updates (" + String::humanize_size(p_stats.buffer_update_bytes / frames) + "), " +
+			PER_FRAME(p_stats.texture_updates) + " texture updates (" + String::humanize_size(p_stats.texture_update_bytes / frames) + ").");
+	print_line("Barriers per frame: " + PER_FRAME(p_stats.barriers) + " (" + PER_FRAME(p_stats.redundant_barriers) + " redundant, " + PER_FRAME(p_stats.mergeable_barriers) + " mergeable).");
+
+#undef PER_FRAME
+}
+
+void RenderingDeviceRecorder::initialize(const Size2i &p_screen_size) {
+	device_capabilities.device_family = DEVICE_VULKAN;
+	device_capabilities.version_major = 1;
+	device_capabilities.version_minor = 0;
+
+	keep_trace = !trace_path.is_empty();
+
+	screen_size = p_screen_size;
+	if (screen_size.width > 0 && screen_size.height > 0) {
+		TextureFormat tf;
+		tf.format = DATA_FORMAT_B8G8R8A8_UNORM;
+		tf.width = screen_size.width;
+		tf.height = screen_size.height;
+		tf.usage_bits = TEXTURE_USAGE_COLOR_ATTACHMENT_BIT;
+		screen_texture = texture_create(tf, TextureView());
+
+		Vector<RID> attachments;
+		attachments.push_back(screen_texture);
+		screen_framebuffer = framebuffer_create(attachments);
+		screen_format = framebuffer_get_format(screen_framebuffer);
+	}
+}
+
+template <class T>
+void RenderingDeviceRecorder::_free_rids(T &p_owner, const char *p_type) {
+	List<RID> owned;
+	p_owner.get_owned_list(&owned);
+	if (owned.size()) {
+		WARN_PRINT(vformat("%d RIDs of type \"%s\" were leaked.", owned.size(), p_type));
+		for (const RID &E : owned) {
+			if (p_owner.owns(E)) {
+				free(E);
+			}
+		}
+	}
+}
+
+void RenderingDeviceRecorder::finalize() {
+	if (frame_commands.size()) {
+		_end_frame();
+	}
+
+	if (screen_texture.is_valid()) {
+		free(screen_texture); // Frees the framebuffer too.
+		screen_texture = RID();
+		screen_framebuffer = RID();
+	}
+
+	// Dependents first, so freeing them does not touch freed resources.
+	_free_rids(render_pipeline_owner, "Pipeline");
+	_free_rids(compute_pipeline_owner, "Compute");
+	_free_rids(uniform_set_owner, "UniformSet");
+	_free_rids(framebuffer_owner, "Framebuffer");
+	_free_rids(vertex_array_owner, "VertexArray");
+	_free_rids(index_array_owner, "IndexArray");
+	_free_rids(shader_owner, "Shader");
+	_free_rids(buffer_owner, "Buffer");
+	_free_rids(sampler_owner, "Sampler");
+	{
+		// Shared textures are freed with their owner, so free them first.
+		List<RID> owned;
+		texture_owner.get_owned_list(&owned);
+		if (owned.size()) {
+			WARN_PRINT(vformat("%d RIDs of type \"Texture\" were leaked.", owned.size()));
+			for (List<RID>::Element *E = owned.front(); E;) {
+				List<RID>::Element *N = E->next();
+				if (texture_is_shared(E->get())) {
+					free(E->get());
+					owned.erase(E);
+				}
+				E = N;
+			}
+			for (const RID &E : owned) {
+				if (texture_owner.owns(E)) {
+					free(E);
+				}
+			}
+		}
+	}
+
+	// Local devices record their own traces, only the main one is saved.
+	if (keep_trace && !trace_path.is_empty() && this == get_singleton()) {
+		if (save_trace(trace_path, trace) == OK) {
+			print_line("RenderingDevice trace saved to: " + trace_path);
+		}
+	}
+
+	trace.clear();
+}
+
+RenderingDeviceRecorder::RenderingDeviceRecorder() {
+}
+
+RenderingDeviceRecorder::~RenderingDeviceRecorder() {
+}
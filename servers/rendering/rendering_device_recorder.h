@@ -0,0 +1,456 @@
+/*************************************************************************/
+/*  rendering_device_recorder.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RENDERING_DEVICE_RECORDER_H
+#define RENDERING_DEVICE_RECORDER_H
+
+#include "core/os/thread_safe.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rid_owner.h"
+#include "servers/rendering/rendering_device.h"
+
+// A RenderingDevice that does not talk to any GPU. Resources are only
+// book-kept, and every command is recorded into a trace, which can be
+// saved and replayed later to measure how the renderer builds its
+// command lists (draw counts, state changes, redundant barriers and the
+// CPU time spent between list begin and end). This makes it possible to
+// profile the RD renderers headless, e.g. on CI machines.
+
+class RenderingDeviceRecorder : public RenderingDevice {
+	_THREAD_SAFE_CLASS_
+
+public:
+	enum CommandType {
+		COMMAND_TEXTURE_UPDATE, // Texture, bytes, post barrier.
+		COMMAND_TEXTURE_COPY, // Destination, source, post barrier.
+		COMMAND_TEXTURE_CLEAR, // Texture, unused, post barrier.
+		COMMAND_TEXTURE_RESOLVE, // Destination, source, post barrier.
+		COMMAND_BUFFER_UPDATE, // Buffer, bytes, post barrier.
+		COMMAND_BUFFER_CLEAR, // Buffer, bytes, post barrier.
+		COMMAND_DRAW_LIST_BEGIN, // Framebuffer, splits.
+		COMMAND_DRAW_LIST_SPLIT, // Split index.
+		COMMAND_DRAW_LIST_BIND_RENDER_PIPELINE, // Pipeline.
+		COMMAND_DRAW_LIST_BIND_UNIFORM_SET, // Uniform set, set index.
+		COMMAND_DRAW_LIST_BIND_VERTEX_ARRAY, // Vertex array.
+		COMMAND_DRAW_LIST_BIND_INDEX_ARRAY, // Index array.
+		COMMAND_DRAW_LIST_SET_LINE_WIDTH,
+		COMMAND_DRAW_LIST_SET_PUSH_CONSTANT, // Size, data hash.
+		COMMAND_DRAW_LIST_DRAW, // Uses indices, instances, elements.
+		COMMAND_DRAW_LIST_ENABLE_SCISSOR,
+		COMMAND_DRAW_LIST_DISABLE_SCISSOR,
+		COMMAND_DRAW_LIST_NEXT_PASS, // Splits.
+		COMMAND_DRAW_LIST_END, // Post barrier, CPU usec spent since the list began.
+		COMMAND_COMPUTE_LIST_BEGIN,
+		COMMAND_COMPUTE_LIST_BIND_PIPELINE, // Pipeline.
+		COMMAND_COMPUTE_LIST_BIND_UNIFORM_SET, // Uniform set, set index.
+		COMMAND_COMPUTE_LIST_SET_PUSH_CONSTANT, // Size, data hash.
+		COMMAND_COMPUTE_LIST_DISPATCH, // Groups in X, Y and Z.
+		COMMAND_COMPUTE_LIST_DISPATCH_INDIRECT, // Buffer, offset.
+		COMMAND_COMPUTE_LIST_ADD_BARRIER,
+		COMMAND_COMPUTE_LIST_END, // Post barrier, CPU usec spent since the list began.
+		COMMAND_BARRIER, // From, to.
+		COMMAND_FULL_BARRIER,
+		COMMAND_FRAME_END, // CPU usec spent since the first command of the frame.
+		COMMAND_MAX
+	};
+
+	struct Command {
+		CommandType type = COMMAND_MAX;
+		uint64_t args[3] = {};
+	};
+
+	struct Stats {
+		uint64_t frames = 0;
+		uint64_t commands = 0;
+
+		uint64_t frame_usec = 0;
+		uint64_t max_frame_usec = 0;
+		uint64_t draw_list_usec = 0;
+		uint64_t compute_list_usec = 0;
+
+		uint64_t draw_lists = 0;
+		uint64_t split_draw_lists = 0;
+		uint64_t draws = 0;
+		uint64_t instances = 0;
+		uint64_t elements = 0;
+		uint64_t compute_lists = 0;
+		uint64_t dispatches = 0;
+
+		uint64_t pipeline_binds = 0;
+		uint64_t redundant_pipeline_binds = 0;
+		uint64_t uniform_set_binds = 0;
+		uint64_t redundant_uniform_set_binds = 0;
+		uint64_t array_binds = 0;
+		uint64_t redundant_array_binds = 0;
+		uint64_t push_constants = 0;
+		uint64_t redundant_push_constants = 0;
+
+		uint64_t buffer_updates = 0;
+		uint64_t buffer_update_bytes = 0;
+		uint64_t texture_updates = 0;
+		uint64_t texture_update_bytes = 0;
+
+		uint64_t barriers = 0;
+		uint64_t redundant_barriers = 0; // Nothing was written since the previous barrier.
+		uint64_t mergeable_barriers = 0; // Back to back transfers that could share a single barrier.
+	};
+
+private:
+	enum IDType {
+		ID_TYPE_FRAMEBUFFER_FORMAT,
+		ID_TYPE_VERTEX_FORMAT,
+		ID_TYPE_DRAW_LIST,
+		ID_TYPE_SPLIT_DRAW_LIST,
+		ID_TYPE_COMPUTE_LIST,
+		ID_TYPE_MAX,
+		ID_BASE_SHIFT = 58 //5 bits for ID types
+	};
+
+	static String trace_path;
+
+	Map<RID, Set<RID>> dependency_map; //IDs to IDs that depend on it
+	Map<RID, Set<RID>> reverse_dependency_map; //same as above, but in reverse
+
+	void _add_dependency(RID p_id, RID p_depends_on);
+	void _free_dependencies(RID p_id);
+
+	/**** RESOURCES ****/
+
+	struct Texture {
+		TextureFormat format;
+		RID owner;
+		uint32_t base_mipmap = 0;
+		Vector<Vector<uint8_t>> data; // Only what was uploaded, one entry per layer.
+	};
+
+	RID_Owner<Texture, true> texture_owner;
+
+	struct Buffer {
+		uint32_t size = 0;
+		uint32_t index_count = 0; // Index buffers only.
+		Vector<uint8_t> data;
+	};
+
+	RID_Owner<Buffer, true> buffer_owner;
+
+	struct VertexArray {
+		uint32_t vertex_count = 0;
+	};
+
+	RID_Owner<VertexArray, true> vertex_array_owner;
+
+	struct IndexArray {
+		uint32_t index_count = 0;
+	};
+
+	RID_Owner<IndexArray, true> index_array_owner;
+
+	RID_Owner<SamplerState, true> sampler_owner;
+
+	struct Shader {
+		uint32_t stages = 0;
+		uint32_t vertex_input_mask = 0;
+	};
+
+	RID_Owner<Shader, true> shader_owner;
+
+	struct UniformSet {
+		RID shader;
+		uint32_t shader_set = 0;
+		UniformSetInvalidatedCallback invalidated_callback = nullptr;
+		void *invalidated_callback_userdata = nullptr;
+	};
+
+	RID_Owner<UniformSet, true> uniform_set_owner;
+
+	struct Pipeline {
+		RID shader;
+		FramebufferFormatID framebuffer_format = INVALID_FORMAT_ID;
+	};
+
+	RID_Owner<Pipeline, true> render_pipeline_owner;
+	RID_Owner<Pipeline, true> compute_pipeline_owner;
+
+	// Formats are deduplicated so the IDs behave like the ones of a
+	// real device, renderers use them as pipeline cache keys.
+	struct FormatKey {
+		LocalVector<int64_t> values;
+
+		bool operator<(const FormatKey &p_key) const {
+			if (values.size() != p_key.values.size()) {
+				return values.size() < p_key.values.size();
+			}
+			for (uint32_t i = 0; i < values.size(); i++) {
+				if (values[i] != p_key.values[i]) {
+					return values[i] < p_key.values[i];
+				}
+			}
+			return false;
+		}
+	};
+
+	struct FramebufferFormat {
+		Vector<TextureSamples> pass_samples;
+		uint32_t pass_count = 1;
+	};
+
+	Map<FormatKey, FramebufferFormatID> framebuffer_format_cache;
+	LocalVector<FramebufferFormat> framebuffer_formats;
+	Map<FormatKey, VertexFormatID> vertex_format_cache;
+
+	struct Framebuffer {
+		FramebufferFormatID format_id = INVALID_FORMAT_ID;
+		Size2i size;
+	};
+
+	RID_Owner<Framebuffer, true> framebuffer_owner;
+
+	uint64_t buffer_memory = 0;
+	uint64_t texture_memory = 0;
+
+	Size2i screen_size;
+	RID screen_texture;
+	RID screen_framebuffer;
+	FramebufferFormatID screen_format = INVALID_FORMAT_ID;
+
+	/**** COMMANDS ****/
+
+	// Every split of a draw list gets its own command buffer, so worker
+	// threads can record them without locking (like secondary command
+	// buffers). They are appended to the frame when the pass ends.
+	struct DrawList {
+		LocalVector<Command> commands;
+		uint32_t vertex_count = 0;
+		uint32_t index_count = 0;
+	};
+
+	LocalVector<DrawList> draw_lists;
+	uint32_t draw_list_split_count = 0; // 0 when not split.
+	uint32_t draw_list_current_pass = 0;
+	uint32_t draw_list_pass_count = 0;
+	bool draw_list_active = false;
+	uint64_t draw_list_begin_usec = 0;
+
+	bool compute_list_active = false;
+	uint64_t compute_list_begin_usec = 0;
+
+	LocalVector<Command> frame_commands;
+	uint64_t frame_begin_usec = 0;
+	uint64_t frames_drawn = 0;
+
+	bool keep_trace = false;
+	LocalVector<Command> trace;
+	Stats stats;
+
+	struct Timestamp {
+		String name;
+		uint64_t usec = 0;
+	};
+
+	LocalVector<Timestamp> timestamps[2];
+	uint64_t timestamps_frame = 0;
+
+	void _push_command(CommandType p_type, uint64_t p_arg0 = 0, uint64_t p_arg1 = 0, uint64_t p_arg2 = 0);
+	DrawList *_get_draw_list_ptr(DrawListID p_id);
+	Error _draw_list_begin(RID p_framebuffer, uint32_t p_splits, DrawListID *r_split_ids);
+	void _draw_list_flush();
+	void _end_frame();
+
+	template <class T>
+	void _free_rids(T &p_owner, const char *p_type);
+
+	FramebufferFormatID _framebuffer_format_create(const Vector<AttachmentFormat> &p_attachments, const Vector<FramebufferPass> &p_passes, uint32_t p_view_count);
+	RID _framebuffer_create(const Vector<RID> &p_texture_attachments, const Vector<FramebufferPass> &p_passes, FramebufferFormatID p_format_check, uint32_t p_view_count);
+	RID _buffer_create(uint32_t p_size, const Vector<uint8_t> &p_data);
+
+public:
+	virtual RID texture_create(const TextureFormat &p_format, const TextureView &p_view, const Vector<Vector<uint8_t>> &p_data = Vector<Vector<uint8_t>>());
+	virtual RID texture_create_shared(const TextureView &p_view, RID p_with_texture);
+	virtual RID texture_create_shared_from_slice(const TextureView &p_view, RID p_with_texture, uint32_t p_layer, uint32_t p_mipmap, uint32_t p_mipmaps = 1, TextureSliceType p_slice_type = TEXTURE_SLICE_2D);
+	virtual Error texture_update(RID p_texture, uint32_t p_layer, const Vector<uint8_t> &p_data, uint32_t p_post_barrier = BARRIER_MASK_ALL);
+	virtual Vector<uint8_t> texture_get_data(RID p_texture, uint32_t p_layer);
+
+	virtual bool texture_is_format_supported_for_usage(DataFormat p_format, uint32_t p_usage) const;
+	virtual bool texture_is_shared(RID p_texture);
+	virtual bool texture_is_valid(RID p_texture);
+	virtual Size2i texture_size(RID p_texture);
+
+	virtual Error texture_copy(RID p_from_texture, RID p_to_texture, const Vector3 &p_from, const Vector3 &p_to, const Vector3 &p_size, uint32_t p_src_mipmap, uint32_t p_dst_mipmap, uint32_t p_src_layer, uint32_t p_dst_layer, uint32_t p_post_barrier = BARRIER_MASK_ALL);
+	virtual Error texture_clear(RID p_texture, const Color &p_color, uint32_t p_base_mipmap, uint32_t p_mipmaps, uint32_t p_base_layer, uint32_t p_layers, uint32_t p_post_barrier = BARRIER_MASK_ALL);
+	virtual Error texture_resolve_multisample(RID p_from_texture, RID p_to_texture, uint32_t p_post_barrier = BARRIER_MASK_ALL);
+
+	virtual FramebufferFormatID framebuffer_format_create(const Vector<AttachmentFormat> &p_format, uint32_t p_view_count = 1);
+	virtual FramebufferFormatID framebuffer_format_create_multipass(const Vector<AttachmentFormat> &p_attachments, Vector<FramebufferPass> &p_passes, uint32_t p_view_count = 1);
+	virtual FramebufferFormatID framebuffer_format_create_empty(TextureSamples p_samples = TEXTURE_SAMPLES_1);
+	virtual TextureSamples framebuffer_format_get_texture_samples(FramebufferFormatID p_format, uint32_t p_pass = 0);
+
+	virtual RID framebuffer_create(const Vector<RID> &p_texture_attachments, FramebufferFormatID p_format_check = INVALID_ID, uint32_t p_view_count = 1);
+	virtual RID framebuffer_create_multipass(const Vector<RID> &p_texture_attachments, Vector<FramebufferPass> &p_passes, FramebufferFormatID p_format_check = INVALID_ID, uint32_t p_view_count = 1);
+	virtual RID framebuffer_create_empty(const Size2i &p_size, TextureSamples p_samples = TEXTURE_SAMPLES_1, FramebufferFormatID p_format_check = INVALID_ID);
+
+	virtual FramebufferFormatID framebuffer_get_format(RID p_framebuffer);
+
+	virtual RID sampler_create(const SamplerState &p_state);
+
+	virtual RID vertex_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data = Vector<uint8_t>(), bool p_use_as_storage = false);
+	virtual VertexFormatID vertex_format_create(const Vector<VertexAttribute> &p_vertex_formats);
+	virtual RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers);
+
+	virtual RID index_buffer_create(uint32_t p_size_indices, IndexBufferFormat p_format, const Vector<uint8_t> &p_data = Vector<uint8_t>(), bool p_use_restart_indices = false);
+	virtual RID index_array_create(RID p_index_buffer, uint32_t p_index_offset, uint32_t p_index_count);
+
+	// Shaders are not compiled, the "SPIR-V" of a stage only carries what
+	// the recorder needs to know about it (the vertex input mask).
+	virtual Vector<uint8_t> shader_compile_spirv_from_source(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language = SHADER_LANGUAGE_GLSL, String *r_error = nullptr, bool p_allow_cache = true);
+	virtual String shader_get_binary_cache_key() const;
+	virtual Vector<uint8_t> shader_compile_binary_from_spirv(const Vector<ShaderStageSPIRVData> &p_spirv, const String &p_shader_name = "");
+	virtual RID shader_create_from_bytecode(const Vector<uint8_t> &p_shader_binary);
+	virtual uint32_t shader_get_vertex_input_attribute_mask(RID p_shader);
+
+	virtual RID uniform_buffer_create(uint32_t p_size_bytes, const Vector<uint8_t> &p_data = Vector<uint8_t>());
+	virtual RID storage_buffer_create(uint32_t p_size, const Vector<uint8_t> &p_data = Vector<uint8_t>(), uint32_t p_usage = 0);
+	virtual RID texture_buffer_create(uint32_t p_size_elements, DataFormat p_format, const Vector<uint8_t> &p_data = Vector<uint8_t>());
+
+	virtual RID uniform_set_create(const Vector<Uniform> &p_uniforms, RID p_shader, uint32_t p_shader_set);
+	virtual bool uniform_set_is_valid(RID p_uniform_set);
+	virtual void uniform_set_set_invalidation_callback(RID p_uniform_set, UniformSetInvalidatedCallback p_callback, void *p_userdata);
+
+	virtual Error buffer_update(RID p_buffer, uint32_t p_offset, uint32_t p_size, const void *p_data, uint32_t p_post_barrier = BARRIER_MASK_ALL);
+	virtual Error buffer_clear(RID p_buffer, uint32_t p_offset, uint32_t p_size, uint32_t p_post_barrier = BARRIER_MASK_ALL);
+	virtual Vector<uint8_t> buffer_get_data(RID p_buffer);
+
+	virtual RID render_pipeline_create(RID p_shader, FramebufferFormatID p_framebuffer_format, VertexFormatID p_vertex_format, RenderPrimitive p_render_primitive, const PipelineRasterizationState &p_rasterization_state, const PipelineMultisampleState &p_multisample_state, const PipelineDepthStencilState &p_depth_stencil_state, const PipelineColorBlendState &p_blend_state, int p_dynamic_state_flags = 0, uint32_t p_for_render_pass = 0, const Vector<PipelineSpecializationConstant> &p_specialization_constants = Vector<PipelineSpecializationConstant>());
+	virtual bool render_pipeline_is_valid(RID p_pipeline);
+
+	virtual RID compute_pipeline_create(RID p_shader, const Vector<PipelineSpecializationConstant> &p_specialization_constants = Vector<PipelineSpecializationConstant>());
+	virtual bool compute_pipeline_is_valid(RID p_pipeline);
+
+	virtual int screen_get_width(DisplayServer::WindowID p_screen = 0) const;
+	virtual int screen_get_height(DisplayServer::WindowID p_screen = 0) const;
+	virtual FramebufferFormatID screen_get_framebuffer_format() const;
+
+	virtual DrawListID draw_list_begin_for_screen(DisplayServer::WindowID p_screen = 0, const Color &p_clear_color = Color());
+	virtual DrawListID draw_list_begin(RID p_framebuffer, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values = Vector<Color>(), float p_clear_depth = 1.0, uint32_t p_clear_stencil = 0, const Rect2 &p_region = Rect2(), const Vector<RID> &p_storage_textures = Vector<RID>());
+	virtual Error draw_list_begin_split(RID p_framebuffer, uint32_t p_splits, DrawListID *r_split_ids, InitialAction p_initial_color_action, FinalAction p_final_color_action, InitialAction p_initial_depth_action, FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values = Vector<Color>(), float p_clear_depth = 1.0, uint32_t p_clear_stencil = 0, const Rect2 &p_region = Rect2(), const Vector<RID> &p_storage_textures = Vector<RID>());
+
+	virtual void draw_list_bind_render_pipeline(DrawListID p_list, RID p_render_pipeline);
+	virtual void draw_list_bind_uniform_set(DrawListID p_list, RID p_uniform_set, uint32_t p_index);
+	virtual void draw_list_bind_vertex_array(DrawListID p_list, RID p_vertex_array);
+	virtual void draw_list_bind_index_array(DrawListID p_list, RID p_index_array);
+	virtual void draw_list_set_line_width(DrawListID p_list, float p_width);
+	virtual void draw_list_set_push_constant(DrawListID p_list, const void *p_data, uint32_t p_data_size);
+
+	virtual void draw_list_draw(DrawListID p_list, bool p_use_indices, uint32_t p_instances = 1, uint32_t p_procedural_vertices = 0);
+
+	virtual void draw_list_enable_scissor(DrawListID p_list, const Rect2 &p_rect);
+	virtual void draw_list_disable_scissor(DrawListID p_list);
+
+	virtual uint32_t draw_list_get_current_pass();
+	virtual DrawListID draw_list_switch_to_next_pass();
+	virtual Error draw_list_switch_to_next_pass_split(uint32_t p_splits, DrawListID *r_split_ids);
+
+	virtual void draw_list_end(uint32_t p_post_barrier = BARRIER_MASK_ALL);
+
+	virtual ComputeListID compute_list_begin(bool p_allow_draw_overlap = false);
+	virtual void compute_list_bind_compute_pipeline(ComputeListID p_list, RID p_compute_pipeline);
+	virtual void compute_list_bind_uniform_set(ComputeListID p_list, RID p_uniform_set, uint32_t p_index);
+	virtual void compute_list_set_push_constant(ComputeListID p_list, const void *p_data, uint32_t p_data_size);
+	virtual void compute_list_dispatch(ComputeListID p_list, uint32_t p_x_groups, uint32_t p_y_groups, uint32_t p_z_groups);
+	virtual void compute_list_dispatch_threads(ComputeListID p_list, uint32_t p_x_threads, uint32_t p_y_threads, uint32_t p_z_threads);
+	virtual void compute_list_dispatch_indirect(ComputeListID p_list, RID p_buffer, uint32_t p_offset);
+	virtual void compute_list_add_barrier(ComputeListID p_list);
+
+	virtual void compute_list_end(uint32_t p_post_barrier = BARRIER_MASK_ALL);
+
+	virtual void barrier(uint32_t p_from = BARRIER_MASK_ALL, uint32_t p_to = BARRIER_MASK_ALL);
+	virtual void full_barrier();
+
+	virtual void free(RID p_id);
+
+	virtual void capture_timestamp(const String &p_name);
+	virtual uint32_t get_captured_timestamps_count() const;
+	virtual uint64_t get_captured_timestamps_frame() const;
+	virtual uint64_t get_captured_timestamp_gpu_time(uint32_t p_index) const;
+	virtual uint64_t get_captured_timestamp_cpu_time(uint32_t p_index) const;
+	virtual String get_captured_timestamp_name(uint32_t p_index) const;
+
+	virtual int limit_get(Limit p_limit);
+
+	virtual void prepare_screen_for_drawing();
+	virtual void swap_buffers();
+
+	virtual uint32_t get_frame_delay() const;
+
+	virtual void submit();
+	virtual void sync();
+
+	virtual uint64_t get_memory_usage(MemoryType p_type) const;
+
+	virtual RenderingDevice *create_local_device();
+
+	virtual void set_resource_name(RID p_id, const String p_name);
+
+	virtual void draw_command_begin_label(String p_label_name, const Color p_color = Color(1, 1, 1, 1));
+	virtual void draw_command_insert_label(String p_label_name, const Color p_color = Color(1, 1, 1, 1));
+	virtual void draw_command_end_label();
+
+	virtual String get_device_vendor_name() const;
+	virtual String get_device_name() const;
+	virtual RenderingDevice::DeviceType get_device_type() const;
+	virtual String get_device_pipeline_cache_uuid() const;
+
+	virtual uint64_t get_driver_resource(DriverResource p_resource, RID p_rid = RID(), uint64_t p_index = 0);
+
+	/**** RECORDING ****/
+
+	// Set before the device is created (from the command line) to save
+	// the full trace when the device is finalized.
+	static void set_trace_path(const String &p_path);
+
+	void set_keep_trace(bool p_keep);
+	const LocalVector<Command> &get_trace() const { return trace; }
+	const Stats &get_stats() const { return stats; }
+
+	static Error save_trace(const String &p_path, const LocalVector<Command> &p_trace);
+	static Error load_trace(const String &p_path, LocalVector<Command> &r_trace);
+
+	// Walks the trace the way a driver would, tracking the bound state,
+	// and accumulates what it finds into the stats.
+	static void replay_trace(const LocalVector<Command> &p_trace, Stats &r_stats);
+	static void print_stats(const Stats &p_stats);
+
+	void initialize(const Size2i &p_screen_size);
+	void finalize();
+
+	RenderingDeviceRecorder();
+	~RenderingDeviceRecorder();
+};
+
+#endif // RENDERING_DEVICE_RECORDER_H
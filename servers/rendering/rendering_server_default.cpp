@@ -249,6 +249,10 @@ uint64_t RenderingServerDefault::get_rendering_info(RenderingInfo p_info) {
 		return RSG::viewport->get_total_vertices_drawn();
 	} else if (p_info == RENDERING_INFO_TOTAL_DRAW_CALLS_IN_FRAME) {
 		return RSG::viewport->get_total_draw_calls_used();
+	} else if (p_info == RENDERING_INFO_SPATIAL_INDEX_UPDATES_IN_FRAME) {
+		return RSG::scene->get_indexer_updates_in_frame();
+	} else if (p_info == RENDERING_INFO_SPATIAL_INDEX_UPDATE_USEC_IN_FRAME) {
+		return RSG::scene->get_indexer_update_usec_in_frame();
 	}
 	return RSG::storage->get_rendering_info(p_info);
 }
@@ -31,7 +31,14 @@
 #include "shader_compiler.h"
 
 #include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
 #include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_builder.h"
+#include "core/templates/local_vector.h"
+#include "core/version.h"
 #include "servers/rendering/shader_types.h"
 #include "servers/rendering_server.h"
 
@@ -277,7 +284,7 @@ static String get_constant_text(SL::DataType p_type, const Vector<SL::ConstantNo
 	}
 }
 
-String ShaderCompiler::_get_sampler_name(ShaderLanguage::TextureFilter p_filter, ShaderLanguage::TextureRepeat p_repeat) {
+String ShaderCompiler::_get_sampler_name(ShaderLanguage::TextureFilter p_filter, ShaderLanguage::TextureRepeat p_repeat) const {
 	if (p_filter == ShaderLanguage::FILTER_DEFAULT) {
 		ERR_FAIL_COND_V(actions.default_filter == ShaderLanguage::FILTER_DEFAULT, String());
 		p_filter = actions.default_filter;
@@ -289,7 +296,7 @@ String ShaderCompiler::_get_sampler_name(ShaderLanguage::TextureFilter p_filter,
 	return actions.sampler_array_name + "[" + itos(p_filter + (p_repeat == ShaderLanguage::REPEAT_ENABLE ? ShaderLanguage::FILTER_DEFAULT : 0)) + "]";
 }
 
-void ShaderCompiler::_dump_function_deps(const SL::ShaderNode *p_node, const StringName &p_for_func, const Map<StringName, String> &p_func_code, String &r_to_add, Set<StringName> &added) {
+void ShaderCompiler::_dump_function_deps(const SL::ShaderNode *p_node, const StringName &p_for_func, const Map<StringName, String> &p_func_code, String &r_to_add, Set<StringName> &added) const {
 	int fidx = -1;
 
 	for (int i = 0; i < p_node->functions.size(); i++) {
@@ -435,7 +442,7 @@ static String _get_global_variable_from_type_and_index(const String &p_buffer, c
 	}
 }
 
-String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, GeneratedCode &r_gen_code, IdentifierActions &p_actions, const DefaultIdentifierActions &p_default_actions, bool p_assigning, bool p_use_scope) {
+String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, CompileState &r_state, GeneratedCode &r_gen_code, IdentifierActions &p_actions, const DefaultIdentifierActions &p_default_actions, bool p_assigning, bool p_use_scope) const {
 	String code;
 
 	switch (p_node->type) {
@@ -443,9 +450,9 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			SL::ShaderNode *pnode = (SL::ShaderNode *)p_node;
 
 			for (int i = 0; i < pnode->render_modes.size(); i++) {
-				if (p_default_actions.render_mode_defines.has(pnode->render_modes[i]) && !used_rmode_defines.has(pnode->render_modes[i])) {
+				if (p_default_actions.render_mode_defines.has(pnode->render_modes[i]) && !r_state.used_rmode_defines.has(pnode->render_modes[i])) {
 					r_gen_code.defines.push_back(p_default_actions.render_mode_defines[pnode->render_modes[i]]);
-					used_rmode_defines.insert(pnode->render_modes[i]);
+					r_state.used_rmode_defines.insert(pnode->render_modes[i]);
 				}
 
 				if (p_actions.render_mode_flags.has(pnode->render_modes[i])) {
@@ -647,7 +654,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 
 				if (varying.stage == SL::ShaderNode::Varying::STAGE_FRAGMENT_TO_LIGHT || varying.stage == SL::ShaderNode::Varying::STAGE_FRAGMENT) {
 					var_frag_to_light.push_back(Pair<StringName, SL::ShaderNode::Varying>(varying_name, varying));
-					fragment_varyings.insert(varying_name);
+					r_state.fragment_varyings.insert(varying_name);
 					continue;
 				}
 
@@ -720,7 +727,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 					gcode += "]";
 				}
 				gcode += "=";
-				gcode += _dump_node_code(cnode.initializer, p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+				gcode += _dump_node_code(cnode.initializer, p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				gcode += ";\n";
 				for (int j = 0; j < STAGE_MAX; j++) {
 					r_gen_code.stage_globals[j] += gcode;
@@ -732,10 +739,10 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			//code for functions
 			for (int i = 0; i < pnode->functions.size(); i++) {
 				SL::FunctionNode *fnode = pnode->functions[i].function;
-				function = fnode;
-				current_func_name = fnode->name;
-				function_code[fnode->name] = _dump_node_code(fnode->body, p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
-				function = nullptr;
+				r_state.function = fnode;
+				r_state.current_func_name = fnode->name;
+				function_code[fnode->name] = _dump_node_code(fnode->body, p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
+				r_state.function = nullptr;
 			}
 
 			//place functions in actual code
@@ -745,9 +752,9 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			for (int i = 0; i < pnode->functions.size(); i++) {
 				SL::FunctionNode *fnode = pnode->functions[i].function;
 
-				function = fnode;
+				r_state.function = fnode;
 
-				current_func_name = fnode->name;
+				r_state.current_func_name = fnode->name;
 
 				if (p_actions.entry_point_stages.has(fnode->name)) {
 					Stage stage = p_actions.entry_point_stages[fnode->name];
@@ -755,7 +762,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 					r_gen_code.code[fnode->name] = function_code[fnode->name];
 				}
 
-				function = nullptr;
+				r_state.function = nullptr;
 			}
 
 			//code+=dump_node_code(pnode->body,p_level);
@@ -773,7 +780,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			}
 
 			for (int i = 0; i < bnode->statements.size(); i++) {
-				String scode = _dump_node_code(bnode->statements[i], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+				String scode = _dump_node_code(bnode->statements[i], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 
 				if (bnode->statements[i]->type == SL::Node::TYPE_CONTROL_FLOW || bnode->single_statement) {
 					code += scode; //use directly
@@ -809,7 +816,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 				if (is_array) {
 					declaration += "[";
 					if (vdnode->declarations[i].size_expression != nullptr) {
-						declaration += _dump_node_code(vdnode->declarations[i].size_expression, p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+						declaration += _dump_node_code(vdnode->declarations[i].size_expression, p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					} else {
 						declaration += itos(vdnode->declarations[i].size);
 					}
@@ -819,7 +826,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 				if (!is_array || vdnode->declarations[i].single_expression) {
 					if (!vdnode->declarations[i].initializer.is_empty()) {
 						declaration += "=";
-						declaration += _dump_node_code(vdnode->declarations[i].initializer[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+						declaration += _dump_node_code(vdnode->declarations[i].initializer[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					}
 				} else {
 					int size = vdnode->declarations[i].initializer.size();
@@ -838,7 +845,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 							if (j > 0) {
 								declaration += ",";
 							}
-							declaration += _dump_node_code(vdnode->declarations[i].initializer[j], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+							declaration += _dump_node_code(vdnode->declarations[i].initializer[j], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 						}
 						declaration += ")";
 					}
@@ -851,13 +858,13 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			SL::VariableNode *vnode = (SL::VariableNode *)p_node;
 			bool use_fragment_varying = false;
 
-			if (!vnode->is_local && !(p_actions.entry_point_stages.has(current_func_name) && p_actions.entry_point_stages[current_func_name] == STAGE_VERTEX)) {
+			if (!vnode->is_local && !(p_actions.entry_point_stages.has(r_state.current_func_name) && p_actions.entry_point_stages[r_state.current_func_name] == STAGE_VERTEX)) {
 				if (p_assigning) {
-					if (shader->varyings.has(vnode->name)) {
+					if (r_state.shader->varyings.has(vnode->name)) {
 						use_fragment_varying = true;
 					}
 				} else {
-					if (fragment_varyings.has(vnode->name)) {
+					if (r_state.fragment_varyings.has(vnode->name)) {
 						use_fragment_varying = true;
 					}
 				}
@@ -867,26 +874,26 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 				*p_actions.write_flag_pointers[vnode->name] = true;
 			}
 
-			if (p_default_actions.usage_defines.has(vnode->name) && !used_name_defines.has(vnode->name)) {
+			if (p_default_actions.usage_defines.has(vnode->name) && !r_state.used_name_defines.has(vnode->name)) {
 				String define = p_default_actions.usage_defines[vnode->name];
 				if (define.begins_with("@")) {
 					define = p_default_actions.usage_defines[define.substr(1, define.length())];
 				}
 				r_gen_code.defines.push_back(define);
-				used_name_defines.insert(vnode->name);
+				r_state.used_name_defines.insert(vnode->name);
 			}
 
-			if (p_actions.usage_flag_pointers.has(vnode->name) && !used_flag_pointers.has(vnode->name)) {
+			if (p_actions.usage_flag_pointers.has(vnode->name) && !r_state.used_flag_pointers.has(vnode->name)) {
 				*p_actions.usage_flag_pointers[vnode->name] = true;
-				used_flag_pointers.insert(vnode->name);
+				r_state.used_flag_pointers.insert(vnode->name);
 			}
 
 			if (p_default_actions.renames.has(vnode->name)) {
 				code = p_default_actions.renames[vnode->name];
 			} else {
-				if (shader->uniforms.has(vnode->name)) {
+				if (r_state.shader->uniforms.has(vnode->name)) {
 					//its a uniform!
-					const ShaderLanguage::ShaderNode::Uniform &u = shader->uniforms[vnode->name];
+					const ShaderLanguage::ShaderNode::Uniform &u = r_state.shader->uniforms[vnode->name];
 					if (u.texture_order >= 0) {
 						code = _mkid(vnode->name); //texture, use as is
 					} else {
@@ -914,10 +921,10 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			}
 
 			if (vnode->name == time_name) {
-				if (p_actions.entry_point_stages.has(current_func_name) && p_actions.entry_point_stages[current_func_name] == STAGE_VERTEX) {
+				if (p_actions.entry_point_stages.has(r_state.current_func_name) && p_actions.entry_point_stages[r_state.current_func_name] == STAGE_VERTEX) {
 					r_gen_code.uses_vertex_time = true;
 				}
-				if (p_actions.entry_point_stages.has(current_func_name) && p_actions.entry_point_stages[current_func_name] == STAGE_FRAGMENT) {
+				if (p_actions.entry_point_stages.has(r_state.current_func_name) && p_actions.entry_point_stages[r_state.current_func_name] == STAGE_FRAGMENT) {
 					r_gen_code.uses_fragment_time = true;
 				}
 			}
@@ -936,7 +943,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			code += "]";
 			code += "(";
 			for (int i = 0; i < sz; i++) {
-				code += _dump_node_code(acnode->initializer[i], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _dump_node_code(acnode->initializer[i], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				if (i != sz - 1) {
 					code += ", ";
 				}
@@ -947,16 +954,16 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 			SL::ArrayNode *anode = (SL::ArrayNode *)p_node;
 			bool use_fragment_varying = false;
 
-			if (!anode->is_local && !(p_actions.entry_point_stages.has(current_func_name) && p_actions.entry_point_stages[current_func_name] == STAGE_VERTEX)) {
-				if (anode->assign_expression != nullptr && shader->varyings.has(anode->name)) {
+			if (!anode->is_local && !(p_actions.entry_point_stages.has(r_state.current_func_name) && p_actions.entry_point_stages[r_state.current_func_name] == STAGE_VERTEX)) {
+				if (anode->assign_expression != nullptr && r_state.shader->varyings.has(anode->name)) {
 					use_fragment_varying = true;
 				} else {
 					if (p_assigning) {
-						if (shader->varyings.has(anode->name)) {
+						if (r_state.shader->varyings.has(anode->name)) {
 							use_fragment_varying = true;
 						}
 					} else {
-						if (fragment_varyings.has(anode->name)) {
+						if (r_state.fragment_varyings.has(anode->name)) {
 							use_fragment_varying = true;
 						}
 					}
@@ -967,26 +974,26 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 				*p_actions.write_flag_pointers[anode->name] = true;
 			}
 
-			if (p_default_actions.usage_defines.has(anode->name) && !used_name_defines.has(anode->name)) {
+			if (p_default_actions.usage_defines.has(anode->name) && !r_state.used_name_defines.has(anode->name)) {
 				String define = p_default_actions.usage_defines[anode->name];
 				if (define.begins_with("@")) {
 					define = p_default_actions.usage_defines[define.substr(1, define.length())];
 				}
 				r_gen_code.defines.push_back(define);
-				used_name_defines.insert(anode->name);
+				r_state.used_name_defines.insert(anode->name);
 			}
 
-			if (p_actions.usage_flag_pointers.has(anode->name) && !used_flag_pointers.has(anode->name)) {
+			if (p_actions.usage_flag_pointers.has(anode->name) && !r_state.used_flag_pointers.has(anode->name)) {
 				*p_actions.usage_flag_pointers[anode->name] = true;
-				used_flag_pointers.insert(anode->name);
+				r_state.used_flag_pointers.insert(anode->name);
 			}
 
 			if (p_default_actions.renames.has(anode->name)) {
 				code = p_default_actions.renames[anode->name];
 			} else {
-				if (shader->uniforms.has(anode->name)) {
+				if (r_state.shader->uniforms.has(anode->name)) {
 					//its a uniform!
-					const ShaderLanguage::ShaderNode::Uniform &u = shader->uniforms[anode->name];
+					const ShaderLanguage::ShaderNode::Uniform &u = r_state.shader->uniforms[anode->name];
 					if (u.texture_order >= 0) {
 						code = _mkid(anode->name); //texture, use as is
 					} else {
@@ -1014,21 +1021,21 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 
 			if (anode->call_expression != nullptr) {
 				code += ".";
-				code += _dump_node_code(anode->call_expression, p_level, r_gen_code, p_actions, p_default_actions, p_assigning, false);
+				code += _dump_node_code(anode->call_expression, p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning, false);
 			} else if (anode->index_expression != nullptr) {
 				code += "[";
-				code += _dump_node_code(anode->index_expression, p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _dump_node_code(anode->index_expression, p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				code += "]";
 			} else if (anode->assign_expression != nullptr) {
 				code += "=";
-				code += _dump_node_code(anode->assign_expression, p_level, r_gen_code, p_actions, p_default_actions, true, false);
+				code += _dump_node_code(anode->assign_expression, p_level, r_state, r_gen_code, p_actions, p_default_actions, true, false);
 			}
 
 			if (anode->name == time_name) {
-				if (p_actions.entry_point_stages.has(current_func_name) && p_actions.entry_point_stages[current_func_name] == STAGE_VERTEX) {
+				if (p_actions.entry_point_stages.has(r_state.current_func_name) && p_actions.entry_point_stages[r_state.current_func_name] == STAGE_VERTEX) {
 					r_gen_code.uses_vertex_time = true;
 				}
-				if (p_actions.entry_point_stages.has(current_func_name) && p_actions.entry_point_stages[current_func_name] == STAGE_FRAGMENT) {
+				if (p_actions.entry_point_stages.has(r_state.current_func_name) && p_actions.entry_point_stages[r_state.current_func_name] == STAGE_FRAGMENT) {
 					r_gen_code.uses_fragment_time = true;
 				}
 			}
@@ -1055,7 +1062,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 					} else {
 						code += "";
 					}
-					code += _dump_node_code(cnode->array_declarations[0].initializer[i], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(cnode->array_declarations[0].initializer[i], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				}
 				code += ")";
 			}
@@ -1076,18 +1083,18 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 				case SL::OP_ASSIGN_BIT_AND:
 				case SL::OP_ASSIGN_BIT_OR:
 				case SL::OP_ASSIGN_BIT_XOR:
-					code = _dump_node_code(onode->arguments[0], p_level, r_gen_code, p_actions, p_default_actions, true) + _opstr(onode->op) + _dump_node_code(onode->arguments[1], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code = _dump_node_code(onode->arguments[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, true) + _opstr(onode->op) + _dump_node_code(onode->arguments[1], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					break;
 				case SL::OP_BIT_INVERT:
 				case SL::OP_NEGATE:
 				case SL::OP_NOT:
 				case SL::OP_DECREMENT:
 				case SL::OP_INCREMENT:
-					code = _opstr(onode->op) + _dump_node_code(onode->arguments[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code = _opstr(onode->op) + _dump_node_code(onode->arguments[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					break;
 				case SL::OP_POST_DECREMENT:
 				case SL::OP_POST_INCREMENT:
-					code = _dump_node_code(onode->arguments[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + _opstr(onode->op);
+					code = _dump_node_code(onode->arguments[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + _opstr(onode->op);
 					break;
 				case SL::OP_CALL:
 				case SL::OP_STRUCT:
@@ -1103,9 +1110,9 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 					} else if (onode->op == SL::OP_CONSTRUCT) {
 						code += String(vnode->name);
 					} else {
-						if (p_actions.usage_flag_pointers.has(vnode->name) && !used_flag_pointers.has(vnode->name)) {
+						if (p_actions.usage_flag_pointers.has(vnode->name) && !r_state.used_flag_pointers.has(vnode->name)) {
 							*p_actions.usage_flag_pointers[vnode->name] = true;
-							used_flag_pointers.insert(vnode->name);
+							r_state.used_flag_pointers.insert(vnode->name);
 						}
 
 						if (internal_functions.has(vnode->name)) {
@@ -1124,7 +1131,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 						if (i > 1) {
 							code += ", ";
 						}
-						String node_code = _dump_node_code(onode->arguments[i], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+						String node_code = _dump_node_code(onode->arguments[i], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 						if (is_texture_func && i == 1) {
 							//need to map from texture to sampler in order to sample
 							StringName texture_uniform;
@@ -1153,21 +1160,21 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 								if (actions.custom_samplers.has(texture_uniform)) {
 									sampler_name = actions.custom_samplers[texture_uniform];
 								} else {
-									if (shader->uniforms.has(texture_uniform)) {
-										sampler_name = _get_sampler_name(shader->uniforms[texture_uniform].filter, shader->uniforms[texture_uniform].repeat);
+									if (r_state.shader->uniforms.has(texture_uniform)) {
+										sampler_name = _get_sampler_name(r_state.shader->uniforms[texture_uniform].filter, r_state.shader->uniforms[texture_uniform].repeat);
 									} else {
 										bool found = false;
 
-										for (int j = 0; j < function->arguments.size(); j++) {
-											if (function->arguments[j].name == texture_uniform) {
-												if (function->arguments[j].tex_builtin_check) {
-													ERR_CONTINUE(!actions.custom_samplers.has(function->arguments[j].tex_builtin));
-													sampler_name = actions.custom_samplers[function->arguments[j].tex_builtin];
+										for (int j = 0; j < r_state.function->arguments.size(); j++) {
+											if (r_state.function->arguments[j].name == texture_uniform) {
+												if (r_state.function->arguments[j].tex_builtin_check) {
+													ERR_CONTINUE(!actions.custom_samplers.has(r_state.function->arguments[j].tex_builtin));
+													sampler_name = actions.custom_samplers[r_state.function->arguments[j].tex_builtin];
 													found = true;
 													break;
 												}
-												if (function->arguments[j].tex_argument_check) {
-													sampler_name = _get_sampler_name(function->arguments[j].tex_argument_filter, function->arguments[j].tex_argument_repeat);
+												if (r_state.function->arguments[j].tex_argument_check) {
+													sampler_name = _get_sampler_name(r_state.function->arguments[j].tex_argument_filter, r_state.function->arguments[j].tex_argument_repeat);
 													found = true;
 													break;
 												}
@@ -1194,19 +1201,19 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 					}
 				} break;
 				case SL::OP_INDEX: {
-					code += _dump_node_code(onode->arguments[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(onode->arguments[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					code += "[";
-					code += _dump_node_code(onode->arguments[1], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(onode->arguments[1], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					code += "]";
 
 				} break;
 				case SL::OP_SELECT_IF: {
 					code += "(";
-					code += _dump_node_code(onode->arguments[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(onode->arguments[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					code += "?";
-					code += _dump_node_code(onode->arguments[1], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(onode->arguments[1], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					code += ":";
-					code += _dump_node_code(onode->arguments[2], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(onode->arguments[2], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					code += ")";
 
 				} break;
@@ -1218,7 +1225,7 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 					if (p_use_scope) {
 						code += "(";
 					}
-					code += _dump_node_code(onode->arguments[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + _opstr(onode->op) + _dump_node_code(onode->arguments[1], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(onode->arguments[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + _opstr(onode->op) + _dump_node_code(onode->arguments[1], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 					if (p_use_scope) {
 						code += ")";
 					}
@@ -1230,45 +1237,45 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 		case SL::Node::TYPE_CONTROL_FLOW: {
 			SL::ControlFlowNode *cfnode = (SL::ControlFlowNode *)p_node;
 			if (cfnode->flow_op == SL::FLOW_OP_IF) {
-				code += _mktab(p_level) + "if (" + _dump_node_code(cfnode->expressions[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + ")\n";
-				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _mktab(p_level) + "if (" + _dump_node_code(cfnode->expressions[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + ")\n";
+				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				if (cfnode->blocks.size() == 2) {
 					code += _mktab(p_level) + "else\n";
-					code += _dump_node_code(cfnode->blocks[1], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
+					code += _dump_node_code(cfnode->blocks[1], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				}
 			} else if (cfnode->flow_op == SL::FLOW_OP_SWITCH) {
-				code += _mktab(p_level) + "switch (" + _dump_node_code(cfnode->expressions[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + ")\n";
-				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _mktab(p_level) + "switch (" + _dump_node_code(cfnode->expressions[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + ")\n";
+				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 			} else if (cfnode->flow_op == SL::FLOW_OP_CASE) {
-				code += _mktab(p_level) + "case " + _dump_node_code(cfnode->expressions[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + ":\n";
-				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _mktab(p_level) + "case " + _dump_node_code(cfnode->expressions[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + ":\n";
+				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 			} else if (cfnode->flow_op == SL::FLOW_OP_DEFAULT) {
 				code += _mktab(p_level) + "default:\n";
-				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 			} else if (cfnode->flow_op == SL::FLOW_OP_DO) {
 				code += _mktab(p_level) + "do";
-				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
-				code += _mktab(p_level) + "while (" + _dump_node_code(cfnode->expressions[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + ");";
+				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _mktab(p_level) + "while (" + _dump_node_code(cfnode->expressions[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + ");";
 			} else if (cfnode->flow_op == SL::FLOW_OP_WHILE) {
-				code += _mktab(p_level) + "while (" + _dump_node_code(cfnode->expressions[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + ")\n";
-				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _mktab(p_level) + "while (" + _dump_node_code(cfnode->expressions[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + ")\n";
+				code += _dump_node_code(cfnode->blocks[0], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 			} else if (cfnode->flow_op == SL::FLOW_OP_FOR) {
-				String left = _dump_node_code(cfnode->blocks[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
-				String middle = _dump_node_code(cfnode->blocks[1], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
-				String right = _dump_node_code(cfnode->blocks[2], p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+				String left = _dump_node_code(cfnode->blocks[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
+				String middle = _dump_node_code(cfnode->blocks[1], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
+				String right = _dump_node_code(cfnode->blocks[2], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				code += _mktab(p_level) + "for (" + left + ";" + middle + ";" + right + ")\n";
-				code += _dump_node_code(cfnode->blocks[3], p_level + 1, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _dump_node_code(cfnode->blocks[3], p_level + 1, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 
 			} else if (cfnode->flow_op == SL::FLOW_OP_RETURN) {
 				if (cfnode->expressions.size()) {
-					code = "return " + _dump_node_code(cfnode->expressions[0], p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + ";";
+					code = "return " + _dump_node_code(cfnode->expressions[0], p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + ";";
 				} else {
 					code = "return;";
 				}
 			} else if (cfnode->flow_op == SL::FLOW_OP_DISCARD) {
-				if (p_actions.usage_flag_pointers.has("DISCARD") && !used_flag_pointers.has("DISCARD")) {
+				if (p_actions.usage_flag_pointers.has("DISCARD") && !r_state.used_flag_pointers.has("DISCARD")) {
 					*p_actions.usage_flag_pointers["DISCARD"] = true;
-					used_flag_pointers.insert("DISCARD");
+					r_state.used_flag_pointers.insert("DISCARD");
 				}
 
 				code = "discard;";
@@ -1281,17 +1288,17 @@ String ShaderCompiler::_dump_node_code(const SL::Node *p_node, int p_level, Gene
 		} break;
 		case SL::Node::TYPE_MEMBER: {
 			SL::MemberNode *mnode = (SL::MemberNode *)p_node;
-			code = _dump_node_code(mnode->owner, p_level, r_gen_code, p_actions, p_default_actions, p_assigning) + "." + mnode->name;
+			code = _dump_node_code(mnode->owner, p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning) + "." + mnode->name;
 			if (mnode->index_expression != nullptr) {
 				code += "[";
-				code += _dump_node_code(mnode->index_expression, p_level, r_gen_code, p_actions, p_default_actions, p_assigning);
+				code += _dump_node_code(mnode->index_expression, p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning);
 				code += "]";
 			} else if (mnode->assign_expression != nullptr) {
 				code += "=";
-				code += _dump_node_code(mnode->assign_expression, p_level, r_gen_code, p_actions, p_default_actions, true, false);
+				code += _dump_node_code(mnode->assign_expression, p_level, r_state, r_gen_code, p_actions, p_default_actions, true, false);
 			} else if (mnode->call_expression != nullptr) {
 				code += ".";
-				code += _dump_node_code(mnode->call_expression, p_level, r_gen_code, p_actions, p_default_actions, p_assigning, false);
+				code += _dump_node_code(mnode->call_expression, p_level, r_state, r_gen_code, p_actions, p_default_actions, p_assigning, false);
 			}
 		} break;
 	}
@@ -1304,13 +1311,323 @@ ShaderLanguage::DataType ShaderCompiler::_get_variable_type(const StringName &p_
 	return (ShaderLanguage::DataType)RS::global_variable_type_get_shader_datatype(gvt);
 }
 
-Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+static const uint32_t cache_file_version = 1;
+
+// Maps keyed by StringName are ordered by pointer, which changes between runs, so sort before hashing.
+static void _append_sorted(StringBuilder &r_builder, Vector<String> &p_entries) {
+	p_entries.sort();
+	for (int i = 0; i < p_entries.size(); i++) {
+		r_builder.append(p_entries[i]);
+	}
+}
+
+static Array _uniform_to_array(const SL::ShaderNode::Uniform &p_uniform) {
+	PackedInt32Array default_value;
+	for (int i = 0; i < p_uniform.default_value.size(); i++) {
+		default_value.push_back(p_uniform.default_value[i].sint);
+	}
+
+	Array uniform;
+	uniform.push_back(p_uniform.order);
+	uniform.push_back(p_uniform.texture_order);
+	uniform.push_back(p_uniform.texture_binding);
+	uniform.push_back(p_uniform.type);
+	uniform.push_back(p_uniform.precision);
+	uniform.push_back(p_uniform.array_size);
+	uniform.push_back(default_value);
+	uniform.push_back(p_uniform.scope);
+	uniform.push_back(p_uniform.hint);
+	uniform.push_back(p_uniform.filter);
+	uniform.push_back(p_uniform.repeat);
+	uniform.push_back(Vector3(p_uniform.hint_range[0], p_uniform.hint_range[1], p_uniform.hint_range[2]));
+	uniform.push_back(p_uniform.instance_index);
+	return uniform;
+}
+
+static bool _uniform_from_array(const Array &p_array, SL::ShaderNode::Uniform &r_uniform) {
+	if (p_array.size() != 13) {
+		return false;
+	}
+
+	r_uniform.order = p_array[0];
+	r_uniform.texture_order = p_array[1];
+	r_uniform.texture_binding = p_array[2];
+	r_uniform.type = SL::DataType(int(p_array[3]));
+	r_uniform.precision = SL::DataPrecision(int(p_array[4]));
+	r_uniform.array_size = p_array[5];
+
+	PackedInt32Array default_value = p_array[6];
+	r_uniform.default_value.resize(default_value.size());
+	for (int i = 0; i < default_value.size(); i++) {
+		r_uniform.default_value.write[i].sint = default_value[i];
+	}
+
+	r_uniform.scope = SL::ShaderNode::Uniform::Scope(int(p_array[7]));
+	r_uniform.hint = SL::ShaderNode::Uniform::Hint(int(p_array[8]));
+	r_uniform.filter = SL::TextureFilter(int(p_array[9]));
+	r_uniform.repeat = SL::TextureRepeat(int(p_array[10]));
+	Vector3 hint_range = p_array[11];
+	r_uniform.hint_range[0] = hint_range.x;
+	r_uniform.hint_range[1] = hint_range.y;
+	r_uniform.hint_range[2] = hint_range.z;
+	r_uniform.instance_index = p_array[12];
+	return true;
+}
+
+String ShaderCompiler::_get_cache_key(RS::ShaderMode p_mode, const String &p_code, const IdentifierActions *p_actions) const {
+	StringBuilder hash_build;
+
+	hash_build.append("[base_hash]");
+	hash_build.append(base_sha256);
+	hash_build.append("[mode]");
+	hash_build.append(itos(p_mode));
+
+	// Only the names matter, the pointers are set again when loading from the cache.
+	Vector<String> entries;
+	for (const KeyValue<StringName, Stage> &E : p_actions->entry_point_stages) {
+		entries.push_back("[entry_point:" + String(E.key) + "]" + itos(E.value));
+	}
+	for (const KeyValue<StringName, Pair<int *, int>> &E : p_actions->render_mode_values) {
+		entries.push_back("[render_mode_value:" + String(E.key) + "]");
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions->render_mode_flags) {
+		entries.push_back("[render_mode_flag:" + String(E.key) + "]");
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions->usage_flag_pointers) {
+		entries.push_back("[usage_flag:" + String(E.key) + "]");
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions->write_flag_pointers) {
+		entries.push_back("[write_flag:" + String(E.key) + "]");
+	}
+	_append_sorted(hash_build, entries);
+
+	hash_build.append("[code]");
+	hash_build.append(p_code);
+
+	return hash_build.as_string().sha256_text();
+}
+
+bool ShaderCompiler::_load_from_cache(const String &p_key, IdentifierActions *p_actions, GeneratedCode &r_gen_code) const {
+	String path = shader_cache_dir.plus_file("ShaderCompiler").plus_file(base_sha256).plus_file(p_key) + ".cache";
+
+	FileAccessRef f = FileAccess::open(path, FileAccess::READ);
+	if (!f) {
+		return false;
+	}
+
+	uint32_t length = f->get_32();
+	Vector<uint8_t> buffer;
+	buffer.resize(length);
+	if (length == 0 || f->get_buffer(buffer.ptrw(), length) != length) {
+		return false;
+	}
+
+	Variant variant;
+	if (decode_variant(variant, buffer.ptr(), length) != OK || variant.get_type() != Variant::ARRAY) {
+		return false;
+	}
+
+	Array data = variant;
+	if (data.size() != 17 || uint32_t(data[0]) != cache_file_version) {
+		return false; // Wrong version, or not fully written.
+	}
+
+	Map<StringName, SL::ShaderNode::Uniform> uniforms;
+	Dictionary uniform_data = data[4];
+	for (const Variant *key = uniform_data.next(); key; key = uniform_data.next(key)) {
+		SL::ShaderNode::Uniform uniform;
+		ERR_FAIL_COND_V(!_uniform_from_array(uniform_data[*key], uniform), false);
+
+		if (uniform.scope == SL::ShaderNode::Uniform::SCOPE_GLOBAL && _get_variable_type(*key) != uniform.type) {
+			return false; // Global variable changed since, compile to get the right code or error.
+		}
+		uniforms[*key] = uniform;
+	}
+
+	GeneratedCode gen_code;
+	gen_code.defines = PackedStringArray(data[5]);
+
+	Array texture_uniforms = data[6];
+	for (int i = 0; i < texture_uniforms.size(); i++) {
+		Array texture_data = texture_uniforms[i];
+		ERR_FAIL_COND_V(texture_data.size() != 7, false);
+
+		GeneratedCode::Texture texture;
+		texture.name = texture_data[0];
+		texture.type = SL::DataType(int(texture_data[1]));
+		texture.hint = SL::ShaderNode::Uniform::Hint(int(texture_data[2]));
+		texture.filter = SL::TextureFilter(int(texture_data[3]));
+		texture.repeat = SL::TextureRepeat(int(texture_data[4]));
+		texture.global = texture_data[5];
+		texture.array_size = texture_data[6];
+		gen_code.texture_uniforms.push_back(texture);
+	}
+
+	PackedInt32Array uniform_offsets = data[7];
+	for (int i = 0; i < uniform_offsets.size(); i++) {
+		gen_code.uniform_offsets.push_back(uniform_offsets[i]);
+	}
+	gen_code.uniform_total_size = data[8];
+	gen_code.uniforms = data[9];
+
+	PackedStringArray stage_globals = data[10];
+	ERR_FAIL_COND_V(stage_globals.size() != STAGE_MAX, false);
+	for (int i = 0; i < STAGE_MAX; i++) {
+		gen_code.stage_globals[i] = stage_globals[i];
+	}
+
+	Dictionary code = data[11];
+	for (const Variant *key = code.next(); key; key = code.next(key)) {
+		gen_code.code[*key] = code[*key];
+	}
+
+	gen_code.uses_global_textures = data[12];
+	gen_code.uses_fragment_time = data[13];
+	gen_code.uses_vertex_time = data[14];
+
+	// Everything is valid, set what the parser would have set.
+	PackedStringArray render_modes = data[1];
+	for (int i = 0; i < render_modes.size(); i++) {
+		StringName render_mode = render_modes[i];
+		if (p_actions->render_mode_flags.has(render_mode)) {
+			*p_actions->render_mode_flags[render_mode] = true;
+		}
+		if (p_actions->render_mode_values.has(render_mode)) {
+			Pair<int *, int> &p = p_actions->render_mode_values[render_mode];
+			*p.first = p.second;
+		}
+	}
+
+	PackedStringArray usage_flags = data[2];
+	for (int i = 0; i < usage_flags.size(); i++) {
+		ERR_CONTINUE(!p_actions->usage_flag_pointers.has(usage_flags[i]));
+		*p_actions->usage_flag_pointers[usage_flags[i]] = true;
+	}
+
+	PackedStringArray write_flags = data[3];
+	for (int i = 0; i < write_flags.size(); i++) {
+		ERR_CONTINUE(!p_actions->write_flag_pointers.has(write_flags[i]));
+		*p_actions->write_flag_pointers[write_flags[i]] = true;
+	}
+
+	if (p_actions->uniforms) {
+		for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : uniforms) {
+			p_actions->uniforms->insert(E.key, E.value);
+		}
+	}
+
+	r_gen_code = gen_code;
+	return true;
+}
+
+void ShaderCompiler::_save_to_cache(const String &p_key, const Vector<StringName> &p_render_modes, const Vector<StringName> &p_usage_flags, const Vector<StringName> &p_write_flags, const Map<StringName, SL::ShaderNode::Uniform> &p_uniforms, const GeneratedCode &p_gen_code) const {
+	String path = shader_cache_dir.plus_file("ShaderCompiler").plus_file(base_sha256).plus_file(p_key) + ".cache";
+
+	PackedStringArray render_modes;
+	for (int i = 0; i < p_render_modes.size(); i++) {
+		render_modes.push_back(p_render_modes[i]);
+	}
+	PackedStringArray usage_flags;
+	for (int i = 0; i < p_usage_flags.size(); i++) {
+		usage_flags.push_back(p_usage_flags[i]);
+	}
+	PackedStringArray write_flags;
+	for (int i = 0; i < p_write_flags.size(); i++) {
+		write_flags.push_back(p_write_flags[i]);
+	}
+
+	Dictionary uniforms;
+	for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : p_uniforms) {
+		uniforms[String(E.key)] = _uniform_to_array(E.value);
+	}
+
+	Array texture_uniforms;
+	for (int i = 0; i < p_gen_code.texture_uniforms.size(); i++) {
+		const GeneratedCode::Texture &texture = p_gen_code.texture_uniforms[i];
+		Array texture_data;
+		texture_data.push_back(String(texture.name));
+		texture_data.push_back(texture.type);
+		texture_data.push_back(texture.hint);
+		texture_data.push_back(texture.filter);
+		texture_data.push_back(texture.repeat);
+		texture_data.push_back(texture.global);
+		texture_data.push_back(texture.array_size);
+		texture_uniforms.push_back(texture_data);
+	}
+
+	PackedInt32Array uniform_offsets;
+	for (int i = 0; i < p_gen_code.uniform_offsets.size(); i++) {
+		uniform_offsets.push_back(p_gen_code.uniform_offsets[i]);
+	}
+
+	PackedStringArray stage_globals;
+	for (int i = 0; i < STAGE_MAX; i++) {
+		stage_globals.push_back(p_gen_code.stage_globals[i]);
+	}
+
+	Dictionary code;
+	for (const KeyValue<String, String> &E : p_gen_code.code) {
+		code[E.key] = E.value;
+	}
+
+	Array data;
+	data.push_back(cache_file_version);
+	data.push_back(render_modes);
+	data.push_back(usage_flags);
+	data.push_back(write_flags);
+	data.push_back(uniforms);
+	data.push_back(PackedStringArray(p_gen_code.defines));
+	data.push_back(texture_uniforms);
+	data.push_back(uniform_offsets);
+	data.push_back(p_gen_code.uniform_total_size);
+	data.push_back(p_gen_code.uniforms);
+	data.push_back(stage_globals);
+	data.push_back(code);
+	data.push_back(p_gen_code.uses_global_textures);
+	data.push_back(p_gen_code.uses_fragment_time);
+	data.push_back(p_gen_code.uses_vertex_time);
+	data.push_back(String(VERSION_FULL_BUILD));
+	data.push_back(p_key);
+
+	int length = 0;
+	Error err = encode_variant(data, nullptr, length);
+	ERR_FAIL_COND(err != OK);
+	Vector<uint8_t> buffer;
+	buffer.resize(length);
+	encode_variant(data, buffer.ptrw(), length);
+
+	// Write to a file of this thread first and move it in place once complete, so a crash or another thread
+	// compiling the same shader never leaves a truncated cache file behind.
+	String temp_path = path + "." + itos(Thread::get_caller_id()) + ".tmp";
+	FileAccessRef f = FileAccess::open(temp_path, FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+	f->store_32(length);
+	f->store_buffer(buffer.ptr(), length);
+	f->close();
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->rename(temp_path, path) != OK) {
+		// Another thread may have saved the same shader meanwhile, either way the code is compiled again next time.
+		da->remove(temp_path);
+	}
+}
+
+Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) const {
+	String cache_key;
+	if (shader_cache_dir_valid) {
+		cache_key = _get_cache_key(p_mode, p_code, p_actions);
+		if (_load_from_cache(cache_key, p_actions, r_gen_code)) {
+			return OK;
+		}
+	}
+
 	SL::ShaderCompileInfo info;
 	info.functions = ShaderTypes::get_singleton()->get_functions(p_mode);
 	info.render_modes = ShaderTypes::get_singleton()->get_modes(p_mode);
 	info.shader_types = ShaderTypes::get_singleton()->get_types();
 	info.global_variable_type_func = _get_variable_type;
 
+	ShaderLanguage parser;
 	Error err = parser.compile(p_code, info);
 
 	if (err != OK) {
@@ -1338,14 +1655,47 @@ Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, Ident
 	r_gen_code.uses_vertex_time = false;
 	r_gen_code.uses_global_textures = false;
 
-	used_name_defines.clear();
-	used_rmode_defines.clear();
-	used_flag_pointers.clear();
-	fragment_varyings.clear();
+	CompileState state;
+	state.shader = parser.get_shader();
+
+	if (cache_key.is_empty()) {
+		_dump_node_code(state.shader, 1, state, r_gen_code, *p_actions, actions, false);
+		return OK;
+	}
+
+	// Usage and write flags can share the same pointer, so let them point to separate flags
+	// to find out which names the code uses, which is what the cache stores.
+	IdentifierActions recording_actions = *p_actions;
+	LocalVector<bool> flags;
+	flags.resize(p_actions->usage_flag_pointers.size() + p_actions->write_flag_pointers.size());
+	uint32_t flag_index = 0;
+	for (KeyValue<StringName, bool *> &E : recording_actions.usage_flag_pointers) {
+		flags[flag_index] = false;
+		E.value = &flags[flag_index++];
+	}
+	for (KeyValue<StringName, bool *> &E : recording_actions.write_flag_pointers) {
+		flags[flag_index] = false;
+		E.value = &flags[flag_index++];
+	}
+
+	_dump_node_code(state.shader, 1, state, r_gen_code, recording_actions, actions, false);
+
+	Vector<StringName> usage_flags;
+	for (const KeyValue<StringName, bool *> &E : recording_actions.usage_flag_pointers) {
+		if (*E.value) {
+			*p_actions->usage_flag_pointers[E.key] = true;
+			usage_flags.push_back(E.key);
+		}
+	}
+	Vector<StringName> write_flags;
+	for (const KeyValue<StringName, bool *> &E : recording_actions.write_flag_pointers) {
+		if (*E.value) {
+			*p_actions->write_flag_pointers[E.key] = true;
+			write_flags.push_back(E.key);
+		}
+	}
 
-	shader = parser.get_shader();
-	function = nullptr;
-	_dump_node_code(shader, 1, r_gen_code, *p_actions, actions, false);
+	_save_to_cache(cache_key, state.shader->render_modes, usage_flags, write_flags, p_actions->uniforms ? *p_actions->uniforms : Map<StringName, SL::ShaderNode::Uniform>(), r_gen_code);
 
 	return OK;
 }
@@ -1370,8 +1720,64 @@ void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	texture_functions.insert("textureGather");
 	texture_functions.insert("textureSize");
 	texture_functions.insert("texelFetch");
+
+	if (!shader_cache_dir.is_empty()) {
+		StringBuilder hash_build;
+
+		hash_build.append("[cache_version]");
+		hash_build.append(itos(cache_file_version));
+		hash_build.append("[engine_version]");
+		hash_build.append(VERSION_FULL_BUILD);
+
+		Vector<String> entries;
+		for (const KeyValue<StringName, String> &E : actions.renames) {
+			entries.push_back("[rename:" + String(E.key) + "]" + E.value);
+		}
+		for (const KeyValue<StringName, String> &E : actions.render_mode_defines) {
+			entries.push_back("[render_mode_define:" + String(E.key) + "]" + E.value);
+		}
+		for (const KeyValue<StringName, String> &E : actions.usage_defines) {
+			entries.push_back("[usage_define:" + String(E.key) + "]" + E.value);
+		}
+		for (const KeyValue<StringName, String> &E : actions.custom_samplers) {
+			entries.push_back("[custom_sampler:" + String(E.key) + "]" + E.value);
+		}
+		_append_sorted(hash_build, entries);
+
+		hash_build.append("[defaults]");
+		hash_build.append(itos(actions.default_filter) + "," + itos(actions.default_repeat) + "," + itos(actions.base_texture_binding_index) + "," + itos(actions.texture_layout_set) + "," + itos(actions.base_varying_index) + "," + itos(actions.apply_luminance_multiplier));
+		hash_build.append("[sampler_array_name]");
+		hash_build.append(actions.sampler_array_name);
+		hash_build.append("[base_uniform_string]");
+		hash_build.append(actions.base_uniform_string);
+		hash_build.append("[global_buffer_array_variable]");
+		hash_build.append(actions.global_buffer_array_variable);
+		hash_build.append("[instance_uniform_index_variable]");
+		hash_build.append(actions.instance_uniform_index_variable);
+
+		base_sha256 = hash_build.as_string().sha256_text();
+
+		DirAccessRef d = DirAccess::open(shader_cache_dir);
+		ERR_FAIL_COND(!d);
+		if (d->change_dir("ShaderCompiler") != OK) {
+			Error err = d->make_dir("ShaderCompiler");
+			ERR_FAIL_COND(err != OK);
+			d->change_dir("ShaderCompiler");
+		}
+		if (d->change_dir(base_sha256) != OK) {
+			Error err = d->make_dir(base_sha256);
+			ERR_FAIL_COND(err != OK);
+		}
+		shader_cache_dir_valid = true;
+	}
 }
 
+void ShaderCompiler::set_shader_cache_dir(const String &p_dir) {
+	shader_cache_dir = p_dir;
+}
+
+String ShaderCompiler::shader_cache_dir;
+
 ShaderCompiler::ShaderCompiler() {
 #if 0
 
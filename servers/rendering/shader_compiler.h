@@ -99,33 +99,48 @@ public:
 	};
 
 private:
-	ShaderLanguage parser;
+	// State of a single compilation, compile() can run on several threads at once.
+	struct CompileState {
+		const ShaderLanguage::ShaderNode *shader = nullptr;
+		const ShaderLanguage::FunctionNode *function = nullptr;
+		StringName current_func_name;
+
+		Set<StringName> used_name_defines;
+		Set<StringName> used_flag_pointers;
+		Set<StringName> used_rmode_defines;
+		Set<StringName> fragment_varyings;
+	};
 
-	String _get_sampler_name(ShaderLanguage::TextureFilter p_filter, ShaderLanguage::TextureRepeat p_repeat);
+	String _get_sampler_name(ShaderLanguage::TextureFilter p_filter, ShaderLanguage::TextureRepeat p_repeat) const;
 
-	void _dump_function_deps(const ShaderLanguage::ShaderNode *p_node, const StringName &p_for_func, const Map<StringName, String> &p_func_code, String &r_to_add, Set<StringName> &added);
-	String _dump_node_code(const ShaderLanguage::Node *p_node, int p_level, GeneratedCode &r_gen_code, IdentifierActions &p_actions, const DefaultIdentifierActions &p_default_actions, bool p_assigning, bool p_scope = true);
+	void _dump_function_deps(const ShaderLanguage::ShaderNode *p_node, const StringName &p_for_func, const Map<StringName, String> &p_func_code, String &r_to_add, Set<StringName> &added) const;
+	String _dump_node_code(const ShaderLanguage::Node *p_node, int p_level, CompileState &r_state, GeneratedCode &r_gen_code, IdentifierActions &p_actions, const DefaultIdentifierActions &p_default_actions, bool p_assigning, bool p_scope = true) const;
 
-	const ShaderLanguage::ShaderNode *shader;
-	const ShaderLanguage::FunctionNode *function;
-	StringName current_func_name;
 	StringName time_name;
 	Set<StringName> texture_functions;
-
-	Set<StringName> used_name_defines;
-	Set<StringName> used_flag_pointers;
-	Set<StringName> used_rmode_defines;
 	Set<StringName> internal_functions;
-	Set<StringName> fragment_varyings;
 
 	DefaultIdentifierActions actions;
 
 	static ShaderLanguage::DataType _get_variable_type(const StringName &p_type);
 
+	// Generated code is cached next to the SPIR-V cache of ShaderRD, keyed by the shader code and everything
+	// that changes the result, so shaders that did not change are not parsed again.
+	static String shader_cache_dir;
+	String base_sha256;
+	bool shader_cache_dir_valid = false;
+
+	String _get_cache_key(RS::ShaderMode p_mode, const String &p_code, const IdentifierActions *p_actions) const;
+	bool _load_from_cache(const String &p_key, IdentifierActions *p_actions, GeneratedCode &r_gen_code) const;
+	void _save_to_cache(const String &p_key, const Vector<StringName> &p_render_modes, const Vector<StringName> &p_usage_flags, const Vector<StringName> &p_write_flags, const Map<StringName, ShaderLanguage::ShaderNode::Uniform> &p_uniforms, const GeneratedCode &p_gen_code) const;
+
 public:
-	Error compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
+	// Can be called from multiple threads, as long as the actions of each call are not shared.
+	Error compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) const;
 
 	void initialize(DefaultIdentifierActions p_actions);
+
+	static void set_shader_cache_dir(const String &p_dir);
 	ShaderCompiler();
 };
 
@@ -32,6 +32,9 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/thread_work_pool.h"
 
 #include "tests/test_macros.h"
 
@@ -213,6 +216,181 @@ TEST_CASE("[AStar] Add/Remove") {
 	// It's been great work, cheers. \(^ ^)/
 }
 
+TEST_CASE("[AStar] Bulk add and connect") {
+	AStar a;
+
+	// A row of points where the middle one is expensive to cross.
+	PackedInt32Array ids = { 10, 11, 12, 13 };
+	PackedVector3Array positions = { Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(2, 0, 0), Vector3(1, 1, 0) };
+	PackedFloat32Array weight_scales = { 1, 100, 1, 1 };
+	a.add_points(ids, positions, weight_scales);
+	CHECK(a.get_point_count() == 4);
+	CHECK(a.get_point_position(12) == Vector3(2, 0, 0));
+	CHECK(a.get_point_weight_scale(11) == 100);
+
+	a.connect_point_pairs({ 10, 11, 11, 12, 10, 13, 13, 12 });
+	CHECK(a.are_points_connected(10, 11));
+	CHECK(a.are_points_connected(12, 13));
+	CHECK_FALSE(a.are_points_connected(10, 12));
+
+	Vector<int> path = a.get_id_path(10, 12);
+	REQUIRE(path.size() == 3);
+	CHECK(path[1] == 13);
+
+	// Changes after a search apply to the next one.
+	a.set_point_weight_scale(11, 1);
+	a.set_point_disabled(13);
+	path = a.get_id_path(10, 12);
+	REQUIRE(path.size() == 3);
+	CHECK(path[1] == 11);
+
+	a.set_point_disabled(11);
+	CHECK(a.get_id_path(10, 12).size() == 0);
+
+	a.set_point_disabled(13, false);
+	a.disconnect_points(13, 12);
+	CHECK(a.get_id_path(10, 12).size() == 0);
+	a.connect_point_pairs({ 13, 12 }, false);
+	CHECK(a.get_id_path(10, 12).size() == 3);
+}
+
+TEST_CASE("[AStarGrid2D] Paths with and without jumps") {
+	Math::seed(0);
+
+	for (int mode = 0; mode < AStarGrid2D::DIAGONAL_MODE_MAX; mode++) {
+		bool match = true;
+		for (int test = 0; test < 100 && match; test++) {
+			AStarGrid2D grid;
+			const Size2i size = Size2i(5 + Math::rand() % 30, 5 + Math::rand() % 30);
+			grid.set_size(size);
+			grid.set_diagonal_mode(AStarGrid2D::DiagonalMode(mode));
+			for (int y = 0; y < size.y; y++) {
+				for (int x = 0; x < size.x; x++) {
+					grid.set_point_solid(Vector2i(x, y), Math::rand() % 4 == 0);
+				}
+			}
+
+			for (int query = 0; query < 10; query++) {
+				const Vector2i from = Vector2i(Math::rand() % size.x, Math::rand() % size.y);
+				const Vector2i to = Vector2i(Math::rand() % size.x, Math::rand() % size.y);
+
+				grid.set_jumping_enabled(false);
+				Vector<Vector2> path = grid.get_point_path(from, to);
+				grid.set_jumping_enabled(true);
+				Vector<Vector2> jump_path = grid.get_point_path(from, to);
+
+				// Both are shortest paths made of moves to the next cells.
+				real_t length = 0;
+				for (int i = 1; i < path.size(); i++) {
+					length += path[i - 1].distance_to(path[i]);
+				}
+				real_t jump_length = 0;
+				for (int i = 1; i < jump_path.size(); i++) {
+					Vector2 move = (jump_path[i] - jump_path[i - 1]).abs();
+					if (move.x > 1 || move.y > 1 || grid.is_point_solid(Vector2i(jump_path[i]))) {
+						match = false;
+					}
+					jump_length += jump_path[i - 1].distance_to(jump_path[i]);
+				}
+				if (path.size() != 0 && (jump_path[0] != Vector2(from) || jump_path[jump_path.size() - 1] != Vector2(to))) {
+					match = false;
+				}
+				if ((path.size() == 0) != (jump_path.size() == 0) || !Math::is_equal_approx(length, jump_length)) {
+					match = false;
+				}
+			}
+		}
+		CHECK_MESSAGE(match, vformat("Jumps find the shortest paths with diagonal mode %d.", mode));
+	}
+}
+
+// Grid with random weights, a few disabled points and some long connections.
+void make_grid_graph(AStar &r_astar, int p_size) {
+	RandomPCG rng(5);
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			const int id = y * p_size + x;
+			r_astar.add_point(id, Vector3(x, y, 0), rng.random(1.0, 4.0));
+			if (x > 0) {
+				r_astar.connect_points(id, id - 1);
+			}
+			if (y > 0) {
+				r_astar.connect_points(id, id - p_size, rng.randf() < 0.8);
+			}
+		}
+	}
+	for (int i = 0; i < p_size; i++) {
+		r_astar.set_point_disabled(rng.rand() % (p_size * p_size));
+		const int from_id = rng.rand() % (p_size * p_size);
+		const int to_id = rng.rand() % (p_size * p_size);
+		if (from_id != to_id) {
+			r_astar.connect_points(from_id, to_id);
+		}
+	}
+}
+
+struct ConcurrentPathQueries {
+	AStar *astar = nullptr;
+	LocalVector<int> from_ids;
+	LocalVector<int> to_ids;
+	LocalVector<Vector<int>> id_paths;
+	LocalVector<Vector<Vector3>> point_paths;
+
+	void find_path(uint32_t p_index, void *p_userdata) {
+		id_paths[p_index] = astar->get_id_path(from_ids[p_index], to_ids[p_index]);
+		point_paths[p_index] = astar->get_point_path(from_ids[p_index], to_ids[p_index]);
+	}
+};
+
+TEST_CASE("[AStar] Concurrent searches match single-threaded ones") {
+	const int size = 32;
+	const uint32_t query_count = 512;
+
+	ConcurrentPathQueries reference;
+	ConcurrentPathQueries concurrent;
+	AStar reference_astar;
+	AStar shared_astar;
+	make_grid_graph(reference_astar, size);
+	make_grid_graph(shared_astar, size);
+	reference.astar = &reference_astar;
+	concurrent.astar = &shared_astar;
+
+	RandomPCG rng(9);
+	for (uint32_t i = 0; i < query_count; i++) {
+		const int from_id = rng.rand() % (size * size);
+		const int to_id = rng.rand() % (size * size);
+		reference.from_ids.push_back(from_id);
+		reference.to_ids.push_back(to_id);
+		concurrent.from_ids.push_back(from_id);
+		concurrent.to_ids.push_back(to_id);
+	}
+	reference.id_paths.resize(query_count);
+	reference.point_paths.resize(query_count);
+	concurrent.id_paths.resize(query_count);
+	concurrent.point_paths.resize(query_count);
+
+	for (uint32_t i = 0; i < query_count; i++) {
+		reference.find_path(i, nullptr);
+	}
+
+	// The shared graph was never searched, so the threads also race to build its compact copy.
+	ThreadWorkPool thread_pool;
+	thread_pool.init(4);
+	thread_pool.do_work(query_count, &concurrent, &ConcurrentPathQueries::find_path, nullptr);
+	thread_pool.finish();
+
+	int found = 0;
+	int mismatches = 0;
+	for (uint32_t i = 0; i < query_count; i++) {
+		found += reference.id_paths[i].size() > 0 ? 1 : 0;
+		if (concurrent.id_paths[i] != reference.id_paths[i] || concurrent.point_paths[i] != reference.point_paths[i]) {
+			mismatches++;
+		}
+	}
+	CHECK(found > (int)query_count / 2);
+	CHECK(mismatches == 0);
+}
+
 TEST_CASE("[Stress][AStar] Find paths") {
 	// Random stress tests with Floyd-Warshall.
 	const int N = 30;
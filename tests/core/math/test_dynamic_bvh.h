@@ -0,0 +1,140 @@
+/*************************************************************************/
+/*  test_dynamic_bvh.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_DYNAMIC_BVH_H
+#define TEST_DYNAMIC_BVH_H
+
+#include "core/math/dynamic_bvh.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/thread_work_pool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDynamicBVH {
+
+struct CollectQueryResult {
+	LocalVector<uint64_t> found;
+
+	bool operator()(void *p_data) {
+		found.push_back((uint64_t)p_data);
+		return false;
+	}
+};
+
+AABB random_box(RandomPCG &r_rng, const Vector3 &p_around, real_t p_range) {
+	Vector3 position = p_around + Vector3(r_rng.random(-p_range, p_range), r_rng.random(-p_range, p_range), r_rng.random(-p_range, p_range));
+	return AABB(position, Vector3(r_rng.random(0.1, 2.0), r_rng.random(0.1, 2.0), r_rng.random(0.1, 2.0)));
+}
+
+bool queries_match(DynamicBVH &p_bvh, const LocalVector<AABB> &p_boxes, const LocalVector<bool> &p_removed, RandomPCG &r_rng) {
+	for (int i = 0; i < 50; i++) {
+		AABB query = random_box(r_rng, Vector3(), 50);
+		query.size *= 5;
+
+		CollectQueryResult result;
+		p_bvh.aabb_query(query, result);
+		result.found.sort();
+
+		LocalVector<uint64_t> expected;
+		for (uint32_t j = 0; j < p_boxes.size(); j++) {
+			if (!p_removed[j] && p_boxes[j].intersects_inclusive(query)) {
+				expected.push_back(j);
+			}
+		}
+
+		if (result.found.size() != expected.size()) {
+			return false;
+		}
+		for (uint32_t j = 0; j < expected.size(); j++) {
+			if (result.found[j] != expected[j]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void test_deferred_updates(ThreadWorkPool *p_thread_pool) {
+	RandomPCG rng(13);
+	DynamicBVH bvh;
+
+	const int leaf_count = 4000;
+	LocalVector<AABB> boxes;
+	LocalVector<bool> removed;
+	LocalVector<DynamicBVH::ID> ids;
+	for (int i = 0; i < leaf_count; i++) {
+		boxes.push_back(random_box(rng, Vector3(), 50));
+		removed.push_back(false);
+		ids.push_back(bvh.insert(boxes[i], (void *)(uint64_t)i));
+	}
+	REQUIRE(queries_match(bvh, boxes, removed, rng));
+
+	for (int frame = 0; frame < 10; frame++) {
+		for (int i = 0; i < leaf_count; i++) {
+			if (removed[i]) {
+				continue;
+			}
+			if (rng.randf() < 0.01) {
+				// Teleport.
+				boxes[i] = random_box(rng, Vector3(), 50);
+			} else {
+				boxes[i].position += Vector3(rng.random(-0.5, 0.5), rng.random(-0.5, 0.5), rng.random(-0.5, 0.5));
+			}
+			bvh.update_deferred(ids[i], boxes[i]);
+		}
+
+		// Removing leaves that are waiting for the refit.
+		for (int i = frame; i < leaf_count; i += 97) {
+			if (!removed[i]) {
+				bvh.remove(ids[i]);
+				removed[i] = true;
+			}
+		}
+
+		bvh.refit(p_thread_pool);
+		CHECK(bvh.get_refit_pending_count() == 0);
+		CHECK_MESSAGE(queries_match(bvh, boxes, removed, rng), "Queries after refitting should find the same boxes as a brute force search.");
+	}
+}
+
+TEST_CASE("[DynamicBVH] Deferred updates and refit") {
+	test_deferred_updates(nullptr);
+}
+
+TEST_CASE("[DynamicBVH] Deferred updates and threaded refit") {
+	ThreadWorkPool thread_pool;
+	thread_pool.init(4);
+	test_deferred_updates(&thread_pool);
+	thread_pool.finish();
+}
+
+} // namespace TestDynamicBVH
+
+#endif // TEST_DYNAMIC_BVH_H
@@ -0,0 +1,134 @@
+/*************************************************************************/
+/*  test_radix_sort.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RADIX_SORT_H
+#define TEST_RADIX_SORT_H
+
+#include "core/math/random_pcg.h"
+#include "core/templates/radix_sort.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRadixSort {
+
+struct Item {
+	uint64_t high = 0;
+	uint64_t low = 0;
+	uint32_t index = 0;
+};
+
+struct ItemKey {
+	_FORCE_INLINE_ void operator()(const Item &p_item, uint64_t &r_high, uint64_t &r_low) const {
+		r_high = p_item.high;
+		r_low = p_item.low;
+	}
+};
+
+// Equal keys keep their original order, which the index breaks ties with.
+struct ItemCompare {
+	_FORCE_INLINE_ bool operator()(const Item &p_a, const Item &p_b) const {
+		if (p_a.high != p_b.high) {
+			return p_a.high < p_b.high;
+		}
+		if (p_a.low != p_b.low) {
+			return p_a.low < p_b.low;
+		}
+		return p_a.index < p_b.index;
+	}
+};
+
+LocalVector<Item> make_items(uint32_t p_size, bool p_few_values, RandomPCG &r_rng) {
+	LocalVector<Item> items;
+	items.resize(p_size);
+	for (uint32_t i = 0; i < p_size; i++) {
+		Item &item = items[i];
+		if (p_few_values) {
+			// Only a few values in some of the bytes, so many items share a key.
+			item.low = uint64_t(r_rng.rand(3)) | (uint64_t(r_rng.rand(3)) << 8) | (uint64_t(r_rng.rand(3)) << 40);
+			item.high = uint64_t(r_rng.rand(2)) | (uint64_t(r_rng.rand(3)) << 60);
+		} else {
+			item.low = (uint64_t(r_rng.rand()) << 32) | r_rng.rand();
+			item.high = (uint64_t(r_rng.rand()) << 32) | r_rng.rand();
+		}
+		item.index = i;
+	}
+	return items;
+}
+
+bool sorts_like_stable_sort(uint32_t p_size, bool p_few_values) {
+	RandomPCG rng(p_size);
+	LocalVector<Item> items = make_items(p_size, p_few_values, rng);
+
+	LocalVector<Item> expected = items;
+	SortArray<Item, ItemCompare> sorter;
+	sorter.sort(expected.ptr(), expected.size());
+
+	RadixSort<Item, ItemKey> radix_sort;
+	radix_sort.sort(items.ptr(), items.size());
+
+	for (uint32_t i = 0; i < p_size; i++) {
+		if (items[i].index != expected[i].index) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[RadixSort] Sorts like a stable sort by key") {
+	const uint32_t sizes[] = { 0, 1, 2, 17, RadixSort<Item, ItemKey>::INSERTION_SORT_THRESHOLD - 1, RadixSort<Item, ItemKey>::INSERTION_SORT_THRESHOLD, 1000, 20000 };
+	for (uint32_t size : sizes) {
+		CHECK_MESSAGE(sorts_like_stable_sort(size, false), vformat("Random keys, %d items.", size));
+		CHECK_MESSAGE(sorts_like_stable_sort(size, true), vformat("Repeated keys, %d items.", size));
+	}
+}
+
+TEST_CASE("[RadixSort] Sorts a range of a larger array") {
+	RandomPCG rng(7);
+	LocalVector<Item> items = make_items(1000, true, rng);
+	LocalVector<Item> expected = items;
+
+	RadixSort<Item, ItemKey> radix_sort;
+	SortArray<Item, ItemCompare> sorter;
+	// On both sides of the insertion sort threshold, reusing the sort buffers.
+	radix_sort.sort(items.ptr() + 100, 500);
+	sorter.sort(expected.ptr() + 100, 500);
+	radix_sort.sort(items.ptr() + 700, 50);
+	sorter.sort(expected.ptr() + 700, 50);
+
+	bool matches = true;
+	for (uint32_t i = 0; i < items.size(); i++) {
+		matches = matches && items[i].index == expected[i].index;
+	}
+	CHECK(matches);
+}
+
+} // namespace TestRadixSort
+
+#endif // TEST_RADIX_SORT_H
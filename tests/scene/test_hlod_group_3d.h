@@ -0,0 +1,204 @@
+/*************************************************************************/
+/*  test_hlod_group_3d.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_HLOD_GROUP_3D_H
+#define TEST_HLOD_GROUP_3D_H
+
+#include "scene/3d/hlod_group_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestHLODGroup3D {
+
+// A unit quad facing +Z, with an extra vertex no triangle uses.
+static Array create_quad_arrays() {
+	PackedVector3Array vertices;
+	vertices.push_back(Vector3(0, 0, 0));
+	vertices.push_back(Vector3(1, 0, 0));
+	vertices.push_back(Vector3(1, 1, 0));
+	vertices.push_back(Vector3(0, 1, 0));
+	vertices.push_back(Vector3(5, 5, 5));
+
+	PackedVector3Array normals;
+	PackedVector2Array uvs;
+	for (int i = 0; i < vertices.size(); i++) {
+		normals.push_back(Vector3(0, 0, 1));
+		uvs.push_back(Vector2(vertices[i].x, vertices[i].y));
+	}
+
+	// Clockwise seen from the front, like the rest of the engine.
+	PackedInt32Array indices;
+	indices.push_back(0);
+	indices.push_back(2);
+	indices.push_back(1);
+	indices.push_back(0);
+	indices.push_back(3);
+	indices.push_back(2);
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_NORMAL] = normals;
+	arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+	return arrays;
+}
+
+static HLODGroup3D::SourceSurface create_source(const Array &p_arrays, const Transform3D &p_transform) {
+	HLODGroup3D::SourceSurface source;
+	source.arrays = p_arrays;
+	source.transform = p_transform;
+	return source;
+}
+
+// The sorted triangles of a surface, each described by the positions and UVs of its corners.
+static Vector<String> get_triangle_keys(const Array &p_arrays) {
+	const PackedVector3Array vertices = p_arrays[Mesh::ARRAY_VERTEX];
+	const PackedVector2Array uvs = p_arrays[Mesh::ARRAY_TEX_UV];
+	const PackedInt32Array indices = p_arrays[Mesh::ARRAY_INDEX];
+	Vector<String> keys;
+	for (int i = 0; i < indices.size(); i += 3) {
+		String key;
+		for (int j = 0; j < 3; j++) {
+			key += String(vertices[indices[i + j]]) + String(uvs[indices[i + j]]);
+		}
+		keys.push_back(key);
+	}
+	keys.sort();
+	return keys;
+}
+
+TEST_CASE("[HLODGroup3D] Merging remaps indices and drops unused vertices") {
+	LocalVector<HLODGroup3D::SourceSurface> sources;
+	sources.push_back(create_source(create_quad_arrays(), Transform3D()));
+	sources.push_back(create_source(create_quad_arrays(), Transform3D(Basis(), Vector3(3, 0, 0))));
+
+	const Array merged = HLODGroup3D::merge_surfaces(sources, 1.0, 0.0);
+	REQUIRE(merged.size() == Mesh::ARRAY_MAX);
+
+	const PackedVector3Array vertices = merged[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array indices = merged[Mesh::ARRAY_INDEX];
+	CHECK_MESSAGE(vertices.size() == 8, "The vertices no triangle uses should be dropped.");
+	CHECK(indices.size() == 12);
+
+	// Vertices are stored in the order the triangles use them.
+	int next_vertex = 0;
+	for (int i = 0; i < indices.size(); i++) {
+		CHECK(indices[i] >= 0);
+		CHECK(indices[i] <= next_vertex);
+		if (indices[i] == next_vertex) {
+			next_vertex++;
+		}
+	}
+
+	// Same triangles as the transformed sources.
+	Array expected = create_quad_arrays();
+	PackedVector3Array expected_vertices = expected[Mesh::ARRAY_VERTEX];
+	PackedVector2Array expected_uvs = expected[Mesh::ARRAY_TEX_UV];
+	PackedInt32Array expected_indices = expected[Mesh::ARRAY_INDEX];
+	for (int i = 0; i < 5; i++) {
+		expected_vertices.push_back(expected_vertices[i] + Vector3(3, 0, 0));
+		expected_uvs.push_back(expected_uvs[i]);
+	}
+	for (int i = 0; i < 6; i++) {
+		expected_indices.push_back(expected_indices[i] + 5);
+	}
+	expected[Mesh::ARRAY_VERTEX] = expected_vertices;
+	expected[Mesh::ARRAY_TEX_UV] = expected_uvs;
+	expected[Mesh::ARRAY_INDEX] = expected_indices;
+	CHECK(get_triangle_keys(merged) == get_triangle_keys(expected));
+}
+
+TEST_CASE("[HLODGroup3D] Merging keeps the winding of mirrored instances") {
+	const Transform3D transforms[] = {
+		Transform3D(),
+		Transform3D(Basis().scaled(Vector3(-1, 1, 1)), Vector3(0, 0, 2)),
+		Transform3D(Basis(Vector3(0, 1, 0), Math_PI / 3.0).scaled(Vector3(2, -1, 0.5)), Vector3()),
+	};
+
+	for (int i = 0; i < 3; i++) {
+		LocalVector<HLODGroup3D::SourceSurface> sources;
+		sources.push_back(create_source(create_quad_arrays(), transforms[i]));
+		const Array merged = HLODGroup3D::merge_surfaces(sources, 1.0, 0.0);
+		REQUIRE(merged.size() == Mesh::ARRAY_MAX);
+
+		const PackedVector3Array vertices = merged[Mesh::ARRAY_VERTEX];
+		const PackedVector3Array normals = merged[Mesh::ARRAY_NORMAL];
+		const PackedInt32Array indices = merged[Mesh::ARRAY_INDEX];
+		REQUIRE(indices.size() == 6);
+		for (int j = 0; j < indices.size(); j += 3) {
+			// Front faces are clockwise, so their normal points away from this cross product.
+			const Vector3 &v0 = vertices[indices[j + 0]];
+			const Vector3 &v1 = vertices[indices[j + 1]];
+			const Vector3 &v2 = vertices[indices[j + 2]];
+			const Vector3 face_normal = (v2 - v0).cross(v1 - v0).normalized();
+			CHECK_MESSAGE(face_normal.dot(normals[indices[j]]) == doctest::Approx(1.0), vformat("Transform %d, triangle %d.", i, j / 3));
+		}
+	}
+}
+
+TEST_CASE("[HLODGroup3D] Merging keeps the attributes all sources have") {
+	Array with_colors = create_quad_arrays();
+	PackedColorArray colors;
+	colors.resize(5);
+	colors.fill(Color(1, 0, 0));
+	with_colors[Mesh::ARRAY_COLOR] = colors;
+
+	Array without_uvs = create_quad_arrays();
+	without_uvs[Mesh::ARRAY_TEX_UV] = Variant();
+	PackedVector2Array uv2s;
+	uv2s.resize(5);
+	without_uvs[Mesh::ARRAY_TEX_UV2] = uv2s;
+
+	LocalVector<HLODGroup3D::SourceSurface> sources;
+	sources.push_back(create_source(with_colors, Transform3D()));
+	sources.push_back(create_source(without_uvs, Transform3D(Basis(), Vector3(0, 2, 0))));
+
+	const Array merged = HLODGroup3D::merge_surfaces(sources, 1.0, 0.0);
+	REQUIRE(merged.size() == Mesh::ARRAY_MAX);
+	CHECK(PackedVector3Array(merged[Mesh::ARRAY_VERTEX]).size() == 8);
+	CHECK(PackedVector3Array(merged[Mesh::ARRAY_NORMAL]).size() == 8);
+	CHECK(merged[Mesh::ARRAY_TANGENT].get_type() == Variant::NIL);
+	CHECK(merged[Mesh::ARRAY_COLOR].get_type() == Variant::NIL);
+	CHECK(merged[Mesh::ARRAY_TEX_UV].get_type() == Variant::NIL);
+	CHECK(merged[Mesh::ARRAY_TEX_UV2].get_type() == Variant::NIL);
+
+	sources.clear();
+	sources.push_back(create_source(with_colors, Transform3D()));
+	sources.push_back(create_source(with_colors, Transform3D(Basis(), Vector3(0, 2, 0))));
+	const Array merged_colors = HLODGroup3D::merge_surfaces(sources, 1.0, 0.0);
+	REQUIRE(merged_colors.size() == Mesh::ARRAY_MAX);
+	CHECK(PackedColorArray(merged_colors[Mesh::ARRAY_COLOR]).size() == 8);
+	CHECK(PackedVector2Array(merged_colors[Mesh::ARRAY_TEX_UV]).size() == 8);
+}
+
+} // namespace TestHLODGroup3D
+
+#endif // TEST_HLOD_GROUP_3D_H
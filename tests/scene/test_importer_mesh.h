@@ -0,0 +1,246 @@
+/*************************************************************************/
+/*  test_importer_mesh.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_IMPORTER_MESH_H
+#define TEST_IMPORTER_MESH_H
+
+#include "core/templates/thread_work_pool.h"
+#include "scene/resources/importer_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestImporterMesh {
+
+// A bumpy UV sphere with a seam, so simplification has to weigh positions, normals and UVs.
+static Array create_sphere_arrays(int p_segments) {
+	PackedVector3Array vertices;
+	PackedVector3Array normals;
+	PackedVector2Array uvs;
+	PackedInt32Array indices;
+
+	for (int y = 0; y <= p_segments; y++) {
+		for (int x = 0; x <= p_segments; x++) {
+			const float theta = Math_PI * y / p_segments;
+			const float phi = Math_TAU * x / p_segments;
+			const Vector3 normal = Vector3(Math::sin(theta) * Math::cos(phi), Math::cos(theta), Math::sin(theta) * Math::sin(phi));
+			vertices.push_back(normal * (1.0 + 0.05 * Math::sin(7.0 * phi) * Math::sin(5.0 * theta)));
+			normals.push_back(normal);
+			uvs.push_back(Vector2(float(x) / p_segments, float(y) / p_segments));
+		}
+	}
+
+	for (int y = 0; y < p_segments; y++) {
+		for (int x = 0; x < p_segments; x++) {
+			const int a = y * (p_segments + 1) + x;
+			const int c = a + p_segments + 1;
+			indices.push_back(a);
+			indices.push_back(a + 1);
+			indices.push_back(c);
+			indices.push_back(a + 1);
+			indices.push_back(c + 1);
+			indices.push_back(c);
+		}
+	}
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_NORMAL] = normals;
+	arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+	return arrays;
+}
+
+// All the attributes of a vertex, elements per vertex are derived from the array size like the importer does.
+static String get_vertex_key(const Array &p_arrays, int p_vertex, int p_vertex_count) {
+	String key;
+	for (int i = 0; i < p_arrays.size(); i++) {
+		if (i == Mesh::ARRAY_INDEX || p_arrays[i].get_type() == Variant::NIL) {
+			continue;
+		}
+		const Array values = p_arrays[i];
+		const int stride = values.size() / p_vertex_count;
+		for (int j = 0; j < stride; j++) {
+			key += String(values[p_vertex * stride + j]) + ",";
+		}
+		key += ";";
+	}
+	return key;
+}
+
+// The sorted triangles of a surface, each described by the attributes of its corners.
+static Vector<String> get_triangle_keys(const Array &p_arrays, const Array &p_blend_shape_arrays, const Vector<int> &p_indices) {
+	const int vertex_count = PackedVector3Array(p_arrays[Mesh::ARRAY_VERTEX]).size();
+	Vector<String> keys;
+	for (int i = 0; i < p_indices.size(); i += 3) {
+		String key;
+		for (int j = 0; j < 3; j++) {
+			key += get_vertex_key(p_arrays, p_indices[i + j], vertex_count) + get_vertex_key(p_blend_shape_arrays, p_indices[i + j], vertex_count) + "|";
+		}
+		keys.push_back(key);
+	}
+	keys.sort();
+	return keys;
+}
+
+TEST_CASE("[ImporterMesh] LOD generation matches the reference levels") {
+	// Index counts and error thresholds of the LODs generated for the reference mesh before LOD generation was threaded.
+	const int expected_index_counts[] = { 3357, 1680, 837, 417, 210, 105 };
+	const float expected_sizes[] = { 0.0199108, 0.0432841, 0.0922096, 0.173063, 0.477578, 1.341879 };
+	const int expected_lod_count = sizeof(expected_index_counts) / sizeof(expected_index_counts[0]);
+
+	Ref<ImporterMesh> mesh;
+	mesh.instantiate();
+	mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, create_sphere_arrays(32));
+	mesh->generate_lods(60, 25);
+
+	REQUIRE(mesh->get_surface_lod_count(0) == expected_lod_count);
+	for (int i = 0; i < expected_lod_count; i++) {
+		CHECK_MESSAGE(mesh->get_surface_lod_indices(0, i).size() == expected_index_counts[i], vformat("LOD %d.", i));
+		CHECK_MESSAGE(mesh->get_surface_lod_size(0, i) == doctest::Approx(expected_sizes[i]), vformat("LOD %d.", i));
+	}
+
+	SUBCASE("Generating LODs on a thread pool gives the same levels") {
+		Ref<ImporterMesh> threaded_mesh;
+		threaded_mesh.instantiate();
+		threaded_mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, create_sphere_arrays(32));
+		threaded_mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, create_sphere_arrays(32));
+
+		ThreadWorkPool thread_pool;
+		thread_pool.init(4);
+		threaded_mesh->generate_lods(60, 25, &thread_pool);
+		thread_pool.finish();
+
+		for (int i = 0; i < threaded_mesh->get_surface_count(); i++) {
+			REQUIRE(threaded_mesh->get_surface_lod_count(i) == expected_lod_count);
+			for (int j = 0; j < expected_lod_count; j++) {
+				CHECK(threaded_mesh->get_surface_lod_indices(i, j) == mesh->get_surface_lod_indices(0, j));
+				CHECK(threaded_mesh->get_surface_lod_size(i, j) == mesh->get_surface_lod_size(0, j));
+			}
+		}
+	}
+}
+
+TEST_CASE("[ImporterMesh] Optimizing surfaces keeps all vertex attributes") {
+	Array arrays = create_sphere_arrays(16);
+	const PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+	const int vertex_count = vertices.size();
+
+	// Every array type the importer can store per vertex, with several elements per vertex where the format allows it.
+	PackedFloat32Array tangents;
+	PackedColorArray colors;
+	PackedVector2Array uv2s;
+	PackedByteArray custom0;
+	PackedFloat64Array custom1;
+	PackedInt32Array bones;
+	PackedFloat32Array weights;
+	for (int i = 0; i < vertex_count; i++) {
+		tangents.push_back(i);
+		tangents.push_back(0.0);
+		tangents.push_back(-i);
+		tangents.push_back(1.0);
+		colors.push_back(Color(i / 255.0, 0.5, 1.0 - i / 255.0));
+		uv2s.push_back(Vector2(i, -i));
+		for (int j = 0; j < 4; j++) {
+			custom0.push_back((i + j) % 256);
+			bones.push_back(i * 4 + j);
+			weights.push_back(j * 0.25 + i);
+		}
+		custom1.push_back(i * 0.5);
+	}
+	arrays[Mesh::ARRAY_TANGENT] = tangents;
+	arrays[Mesh::ARRAY_COLOR] = colors;
+	arrays[Mesh::ARRAY_TEX_UV2] = uv2s;
+	arrays[Mesh::ARRAY_CUSTOM0] = custom0;
+	arrays[Mesh::ARRAY_CUSTOM1] = custom1;
+	arrays[Mesh::ARRAY_BONES] = bones;
+	arrays[Mesh::ARRAY_WEIGHTS] = weights;
+
+	// Reverse the triangle order, so the optimizer has to reorder the vertices.
+	PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+	PackedInt32Array reversed_indices;
+	for (int i = indices.size() - 3; i >= 0; i -= 3) {
+		reversed_indices.push_back(indices[i]);
+		reversed_indices.push_back(indices[i + 1]);
+		reversed_indices.push_back(indices[i + 2]);
+	}
+	arrays[Mesh::ARRAY_INDEX] = reversed_indices;
+
+	Array blend_shape_arrays;
+	blend_shape_arrays.resize(Mesh::ARRAY_MAX);
+	PackedVector3Array blend_shape_vertices = vertices;
+	for (int i = 0; i < vertex_count; i++) {
+		blend_shape_vertices.write[i] *= 2.0;
+	}
+	blend_shape_arrays[Mesh::ARRAY_VERTEX] = blend_shape_vertices;
+	Array blend_shapes;
+	blend_shapes.push_back(blend_shape_arrays);
+
+	// An imported LOD keeping every other triangle.
+	PackedInt32Array lod_indices;
+	for (int i = 0; i < reversed_indices.size(); i += 6) {
+		lod_indices.push_back(reversed_indices[i]);
+		lod_indices.push_back(reversed_indices[i + 1]);
+		lod_indices.push_back(reversed_indices[i + 2]);
+	}
+	Dictionary lods;
+	lods[0.5] = lod_indices;
+
+	Ref<ImporterMesh> mesh;
+	mesh.instantiate();
+	mesh->add_blend_shape("Scaled");
+	// The mesh keeps the arrays it is given, so they are copied to compare against later.
+	mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, arrays.duplicate(), blend_shapes.duplicate(true), lods);
+	mesh->optimize_surfaces();
+
+	const Array optimized_arrays = mesh->get_surface_arrays(0);
+	const Array optimized_blend_shape_arrays = mesh->get_surface_blend_shape_arrays(0, 0);
+	for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+		CHECK_MESSAGE(optimized_arrays[i].get_type() == arrays[i].get_type(), vformat("Array %d.", i));
+		if (i != Mesh::ARRAY_INDEX && arrays[i].get_type() != Variant::NIL) {
+			CHECK_MESSAGE(Array(optimized_arrays[i]).size() == Array(arrays[i]).size(), vformat("Array %d.", i));
+		}
+	}
+	CHECK_MESSAGE(
+			!(PackedInt32Array(optimized_arrays[Mesh::ARRAY_INDEX]) == reversed_indices),
+			"The optimizer should reorder the triangles of the reference mesh.");
+
+	CHECK_MESSAGE(
+			get_triangle_keys(optimized_arrays, optimized_blend_shape_arrays, optimized_arrays[Mesh::ARRAY_INDEX]) == get_triangle_keys(arrays, blend_shape_arrays, reversed_indices),
+			"Every triangle should keep the attributes and blend shape of its vertices.");
+	REQUIRE(mesh->get_surface_lod_count(0) == 1);
+	CHECK_MESSAGE(
+			get_triangle_keys(optimized_arrays, optimized_blend_shape_arrays, mesh->get_surface_lod_indices(0, 0)) == get_triangle_keys(arrays, blend_shape_arrays, lod_indices),
+			"Imported LODs should follow the vertex reordering.");
+}
+
+} // namespace TestImporterMesh
+
+#endif // TEST_IMPORTER_MESH_H
@@ -0,0 +1,100 @@
+/*************************************************************************/
+/*  test_body_3d.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_BODY_3D_H
+#define TEST_BODY_3D_H
+
+#include "core/os/thread.h"
+#include "core/templates/safe_refcount.h"
+#include "servers/physics_3d/godot_body_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBody3D {
+
+TEST_CASE("[Body3D] Published state") {
+	GodotBody3D body;
+
+	Transform3D transform(Basis(Vector3(0, 1, 0), 0.5), Vector3(1, 2, 3));
+	body.set_state(PhysicsServer3D::BODY_STATE_TRANSFORM, transform);
+	body.set_state(PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(4, 5, 6));
+	body.set_state(PhysicsServer3D::BODY_STATE_CAN_SLEEP, false);
+
+	GodotBody3D::PublishedState state = body.get_published_state();
+	CHECK(state.transform.is_equal_approx(transform));
+	CHECK(state.linear_velocity == Vector3(4, 5, 6));
+	CHECK(state.angular_velocity == Vector3());
+	CHECK_FALSE(state.can_sleep);
+}
+
+struct PublishedStateReader {
+	GodotBody3D *body = nullptr;
+	SafeFlag exit;
+	SafeNumeric<uint32_t> reads;
+	SafeNumeric<uint32_t> torn_reads;
+
+	static void read_loop(void *p_userdata) {
+		PublishedStateReader *reader = static_cast<PublishedStateReader *>(p_userdata);
+		while (!reader->exit.is_set()) {
+			GodotBody3D::PublishedState state = reader->body->get_published_state();
+			// The writer always sets the same value in every component.
+			const Vector3 &origin = state.transform.origin;
+			const Vector3 &velocity = state.linear_velocity;
+			if (origin.y != origin.x || origin.z != origin.x || velocity.y != velocity.x || velocity.z != velocity.x) {
+				reader->torn_reads.increment();
+			}
+			reader->reads.increment();
+		}
+	}
+};
+
+TEST_CASE("[Body3D] Published state is consistent while being written") {
+	GodotBody3D body;
+
+	PublishedStateReader reader;
+	reader.body = &body;
+
+	Thread thread;
+	thread.start(&PublishedStateReader::read_loop, &reader);
+
+	for (int i = 0; i < 100000 || reader.reads.get() < 1000; i++) {
+		real_t value = i;
+		body.set_state(PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(value, value, value)));
+		body.set_state(PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(value, value, value));
+	}
+
+	reader.exit.set();
+	thread.wait_to_finish();
+
+	CHECK(reader.torn_reads.get() == 0);
+}
+} // namespace TestBody3D
+
+#endif // TEST_BODY_3D_H
@@ -0,0 +1,128 @@
+/*************************************************************************/
+/*  test_collision_solver_3d.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_COLLISION_SOLVER_3D_H
+#define TEST_COLLISION_SOLVER_3D_H
+
+#include "servers/physics_3d/godot_collision_solver_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCollisionSolver3D {
+
+TEST_CASE("[CollisionSolver3D] Time of impact between convex shapes") {
+	GodotSphereShape3D sphere;
+	sphere.set_data(0.5);
+
+	// Thin wall, much thinner than the motion of a single step.
+	GodotBoxShape3D wall;
+	wall.set_data(Vector3(0.01, 5.0, 5.0));
+
+	const real_t tolerance = 0.01;
+	Transform3D sphere_transform(Basis(), Vector3(-10.0, 0.0, 0.0));
+	real_t toi = -1.0;
+
+	SUBCASE("Hits the wall") {
+		CHECK(GodotCollisionSolver3D::solve_time_of_impact(&sphere, sphere_transform, Vector3(20.0, 0.0, 0.0), &wall, Transform3D(), tolerance, toi));
+		// The sphere touches the wall after moving 9.49 units.
+		CHECK(toi <= 9.49 / 20.0);
+		CHECK(toi >= (9.49 - tolerance) / 20.0);
+	}
+
+	SUBCASE("Moving away") {
+		CHECK_FALSE(GodotCollisionSolver3D::solve_time_of_impact(&sphere, sphere_transform, Vector3(-20.0, 0.0, 0.0), &wall, Transform3D(), tolerance, toi));
+	}
+
+	SUBCASE("Passing by") {
+		sphere_transform.origin.y = 8.0;
+		CHECK_FALSE(GodotCollisionSolver3D::solve_time_of_impact(&sphere, sphere_transform, Vector3(20.0, 0.0, 0.0), &wall, Transform3D(), tolerance, toi));
+	}
+
+	SUBCASE("Stopping short") {
+		CHECK_FALSE(GodotCollisionSolver3D::solve_time_of_impact(&sphere, sphere_transform, Vector3(5.0, 0.0, 0.0), &wall, Transform3D(), tolerance, toi));
+	}
+
+	SUBCASE("Rotated box") {
+		GodotBoxShape3D box;
+		box.set_data(Vector3(0.25, 0.25, 0.25));
+		Transform3D box_transform(Basis(Vector3(0.0, 1.0, 0.0), Math_PI / 4.0), Vector3(-10.0, 0.0, 0.0));
+		CHECK(GodotCollisionSolver3D::solve_time_of_impact(&box, box_transform, Vector3(20.0, 0.0, 0.0), &wall, Transform3D(), tolerance, toi));
+		// The box corner is at 0.25 * sqrt(2) from its center.
+		real_t distance = 10.0 - 0.01 - 0.25 * Math_SQRT2;
+		CHECK(toi <= distance / 20.0);
+		CHECK(toi >= (distance - tolerance) / 20.0);
+	}
+}
+
+TEST_CASE("[CollisionSolver3D] Time of impact against concave shapes") {
+	GodotSphereShape3D sphere;
+	sphere.set_data(0.25);
+
+	// Single sided quad in the YZ plane.
+	Vector<Vector3> faces;
+	faces.push_back(Vector3(0.0, -5.0, -5.0));
+	faces.push_back(Vector3(0.0, 5.0, -5.0));
+	faces.push_back(Vector3(0.0, 5.0, 5.0));
+	faces.push_back(Vector3(0.0, -5.0, -5.0));
+	faces.push_back(Vector3(0.0, 5.0, 5.0));
+	faces.push_back(Vector3(0.0, -5.0, 5.0));
+
+	const real_t tolerance = 0.01;
+	const Transform3D left(Basis(), Vector3(-10.0, 1.0, 2.0));
+	const Transform3D right(Basis(), Vector3(10.0, 1.0, 2.0));
+	real_t toi_from_left = -1.0;
+	real_t toi_from_right = -1.0;
+
+	GodotConcavePolygonShape3D mesh;
+	Dictionary data;
+	data["faces"] = faces;
+
+	SUBCASE("Back faces are ignored") {
+		data["backface_collision"] = false;
+		mesh.set_data(data);
+		bool hit_from_left = GodotCollisionSolver3D::solve_time_of_impact(&sphere, left, Vector3(20.0, 0.0, 0.0), &mesh, Transform3D(), tolerance, toi_from_left);
+		bool hit_from_right = GodotCollisionSolver3D::solve_time_of_impact(&sphere, right, Vector3(-20.0, 0.0, 0.0), &mesh, Transform3D(), tolerance, toi_from_right);
+		CHECK(hit_from_left != hit_from_right);
+	}
+
+	SUBCASE("Back faces collide") {
+		data["backface_collision"] = true;
+		mesh.set_data(data);
+		CHECK(GodotCollisionSolver3D::solve_time_of_impact(&sphere, left, Vector3(20.0, 0.0, 0.0), &mesh, Transform3D(), tolerance, toi_from_left));
+		CHECK(GodotCollisionSolver3D::solve_time_of_impact(&sphere, right, Vector3(-20.0, 0.0, 0.0), &mesh, Transform3D(), tolerance, toi_from_right));
+		CHECK(toi_from_left <= 9.75 / 20.0);
+		CHECK(toi_from_left >= (9.75 - tolerance) / 20.0);
+		CHECK(Math::is_equal_approx(toi_from_right, toi_from_left));
+	}
+}
+
+} // namespace TestCollisionSolver3D
+
+#endif // TEST_COLLISION_SOLVER_3D_H
@@ -0,0 +1,162 @@
+/*************************************************************************/
+/*  test_concave_polygon_shape_3d.h                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CONCAVE_POLYGON_SHAPE_3D_H
+#define TEST_CONCAVE_POLYGON_SHAPE_3D_H
+
+#include "core/templates/set.h"
+#include "servers/physics_3d/godot_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestConcavePolygonShape3D {
+
+// Bumpy terrain-like grid, two faces per cell.
+Vector<Vector3> make_grid_faces(int p_size) {
+	Vector<Vector3> faces;
+	faces.resize(p_size * p_size * 6);
+	Vector3 *w = faces.ptrw();
+	int idx = 0;
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector3 v[4];
+			for (int i = 0; i < 4; i++) {
+				real_t vx = x + (i & 1);
+				real_t vz = z + (i >> 1);
+				v[i] = Vector3(vx, Math::sin(vx * 0.3) * Math::cos(vz * 0.2) * 4.0, vz);
+			}
+			w[idx++] = v[0];
+			w[idx++] = v[1];
+			w[idx++] = v[2];
+			w[idx++] = v[1];
+			w[idx++] = v[3];
+			w[idx++] = v[2];
+		}
+	}
+	return faces;
+}
+
+struct CullResult {
+	Set<Vector3> centers;
+	int count = 0;
+};
+
+bool cull_callback(void *p_userdata, GodotShape3D *p_convex) {
+	GodotFaceShape3D *face = static_cast<GodotFaceShape3D *>(p_convex);
+	CullResult *result = static_cast<CullResult *>(p_userdata);
+	result->centers.insert((face->vertex[0] + face->vertex[1] + face->vertex[2]) / 3.0);
+	result->count++;
+	return false;
+}
+
+void check_shape(int p_grid_size) {
+	Vector<Vector3> faces = make_grid_faces(p_grid_size);
+
+	GodotConcavePolygonShape3D shape;
+	Dictionary data;
+	data["faces"] = faces;
+	data["backface_collision"] = false;
+	shape.set_data(data);
+
+	REQUIRE(shape.get_faces().size() == faces.size());
+
+	const AABB queries[] = {
+		AABB(Vector3(3.5, -1, 4.5), Vector3(2, 2, 2)),
+		AABB(Vector3(-10, -10, -10), Vector3(5, 5, 5)),
+		AABB(Vector3(p_grid_size * 0.5, -5, 0), Vector3(0.1, 10, p_grid_size)),
+		AABB(Vector3(-1, -10, -1), Vector3(p_grid_size + 2, 20, p_grid_size + 2)),
+	};
+
+	for (const AABB &query : queries) {
+		CullResult result;
+		shape.cull(query, cull_callback, &result, false);
+
+		// Quantized bounds are conservative, so every overlapping face must be reported.
+		int expected = 0;
+		bool all_found = true;
+		for (int i = 0; i < faces.size(); i += 3) {
+			Face3 face(faces[i], faces[i + 1], faces[i + 2]);
+			if (!face.get_aabb().intersects(query)) {
+				continue;
+			}
+			expected++;
+			Vector3 center = (face.vertex[0] + face.vertex[1] + face.vertex[2]) / 3.0;
+			all_found = all_found && result.centers.has(center);
+		}
+		CHECK(result.count >= expected);
+		CHECK(all_found);
+	}
+
+	GodotFaceShape3D face;
+	for (int i = 0; i < 16; i++) {
+		Vector3 from = Vector3(i * p_grid_size / 16.0 + 0.3, 20, i * 0.7 + 0.2);
+		Vector3 to = Vector3(p_grid_size - i * 0.9, -20, p_grid_size * 0.5 + i);
+
+		Vector3 result, normal;
+		bool hit = shape.intersect_segment(from, to, result, normal, false);
+
+		bool expected_hit = false;
+		real_t expected_d = 1e20;
+		Vector3 expected_result;
+		for (int j = 0; j < faces.size(); j += 3) {
+			face.vertex[0] = faces[j];
+			face.vertex[1] = faces[j + 1];
+			face.vertex[2] = faces[j + 2];
+			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+			Vector3 res, n;
+			if (face.intersect_segment(from, to, res, n, true)) {
+				real_t d = from.distance_to(res);
+				if (d < expected_d) {
+					expected_d = d;
+					expected_result = res;
+					expected_hit = true;
+				}
+			}
+		}
+
+		CHECK(hit == expected_hit);
+		if (hit && expected_hit) {
+			CHECK(result.is_equal_approx(expected_result));
+		}
+	}
+}
+
+TEST_CASE("[ConcavePolygonShape3D] BVH queries match brute force") {
+	check_shape(24);
+}
+
+TEST_CASE("[ConcavePolygonShape3D] BVH queries match brute force on a large mesh") {
+	// Deep tree, where upper nodes quantize bounds much coarser than a single face.
+	check_shape(190);
+}
+
+} // namespace TestConcavePolygonShape3D
+
+#endif // TEST_CONCAVE_POLYGON_SHAPE_3D_H
@@ -0,0 +1,180 @@
+/*************************************************************************/
+/*  test_heightmap_shape_3d.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_HEIGHTMAP_SHAPE_3D_H
+#define TEST_HEIGHTMAP_SHAPE_3D_H
+
+#include "servers/physics_3d/godot_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestHeightMapShape3D {
+
+real_t get_test_height(int p_x, int p_z, real_t p_phase) {
+	return Math::sin(p_x * 0.05 + p_phase) * Math::cos(p_z * 0.07) * 20.0 + Math::sin(p_x * 0.9 + p_z * 1.3) * 2.0;
+}
+
+void setup_shape(GodotHeightMapShape3D &r_shape, const Vector<real_t> &p_heights, int p_size, real_t p_min_height, real_t p_max_height) {
+	Dictionary data;
+	data["width"] = p_size;
+	data["depth"] = p_size;
+	data["heights"] = p_heights;
+	data["min_height"] = p_min_height;
+	data["max_height"] = p_max_height;
+	r_shape.set_data(data);
+}
+
+bool intersect_segment_brute_force(const GodotHeightMapShape3D &p_shape, const Vector3 &p_from, const Vector3 &p_to, Vector3 &r_result) {
+	GodotFaceShape3D face;
+	real_t min_d = 1e20;
+	for (int z = 0; z < p_shape.get_depth() - 1; z++) {
+		for (int x = 0; x < p_shape.get_width() - 1; x++) {
+			for (int i = 0; i < 2; i++) {
+				p_shape._get_point(x + i, z, face.vertex[0]);
+				p_shape._get_point(x + 1, z + i, face.vertex[1]);
+				p_shape._get_point(x, z + 1, face.vertex[2]);
+				face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+
+				Vector3 res, normal;
+				if (face.intersect_segment(p_from, p_to, res, normal, false)) {
+					real_t d = p_from.distance_to(res);
+					if (d < min_d) {
+						min_d = d;
+						r_result = res;
+					}
+				}
+			}
+		}
+	}
+	return min_d < 1e20;
+}
+
+void check_segments(const GodotHeightMapShape3D &p_shape, int p_size) {
+	// Offset from grid coordinates to shape coordinates.
+	real_t offset = (p_size - 1) * 0.5;
+	for (int i = 0; i < 32; i++) {
+		// Long rays crossing several chunks, some of them starting exactly on chunk boundaries.
+		Vector3 from = Vector3((i % 8) * GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE - offset, 30, (i / 8) * 20.0 - offset + 0.5);
+		Vector3 to = Vector3(offset - i * 1.7, -30, offset - (i % 5) * 13.0);
+
+		Vector3 result, normal, expected_result;
+		bool hit = p_shape.intersect_segment(from, to, result, normal, false);
+		bool expected_hit = intersect_segment_brute_force(p_shape, from, to, expected_result);
+
+		CHECK(hit == expected_hit);
+		if (hit && expected_hit) {
+			CHECK(result.is_equal_approx(expected_result));
+		}
+	}
+}
+
+TEST_CASE("[HeightMapShape3D] Segment queries match brute force") {
+	const int size = 100;
+	Vector<real_t> heights;
+	heights.resize(size * size);
+	for (int z = 0; z < size; z++) {
+		for (int x = 0; x < size; x++) {
+			heights.write[z * size + x] = get_test_height(x, z, 0.0);
+		}
+	}
+
+	GodotHeightMapShape3D shape;
+	setup_shape(shape, heights, size, -25.0, 25.0);
+	REQUIRE(shape.bounds_levels.size() > 1);
+
+	check_segments(shape, size);
+}
+
+TEST_CASE("[HeightMapShape3D] Region updates match a full rebuild") {
+	const int size = 100;
+	Vector<real_t> heights;
+	heights.resize(size * size);
+	for (int z = 0; z < size; z++) {
+		for (int x = 0; x < size; x++) {
+			heights.write[z * size + x] = get_test_height(x, z, 0.0);
+		}
+	}
+
+	GodotHeightMapShape3D shape;
+	setup_shape(shape, heights, size, -25.0, 25.0);
+
+	const Rect2i regions[] = {
+		Rect2i(0, 0, 1, 1),
+		Rect2i(10, 20, 16, 16),
+		Rect2i(15, 31, 33, 2),
+		Rect2i(70, 60, 30, 40),
+		Rect2i(0, 95, 100, 5),
+	};
+
+	for (int i = 0; i < 5; i++) {
+		const Rect2i &region = regions[i];
+		Vector<real_t> region_heights;
+		region_heights.resize(region.size.x * region.size.y);
+		for (int z = 0; z < region.size.y; z++) {
+			for (int x = 0; x < region.size.x; x++) {
+				// Higher than the initial range, so the aabb has to grow.
+				real_t height = get_test_height(region.position.x + x, region.position.y + z, i + 1.0) * 1.5;
+				region_heights.write[z * region.size.x + x] = height;
+				heights.write[(region.position.y + z) * size + region.position.x + x] = height;
+			}
+		}
+		shape.set_region(region, region_heights);
+	}
+
+	CHECK(shape.get_heights() == heights);
+
+	const AABB &aabb = shape.get_aabb();
+	GodotHeightMapShape3D expected_shape;
+	setup_shape(expected_shape, heights, size, aabb.position.y, aabb.position.y + aabb.size.y);
+
+	REQUIRE(shape.bounds_levels.size() == expected_shape.bounds_levels.size());
+	for (uint32_t i = 0; i < shape.bounds_levels.size(); i++) {
+		const GodotHeightMapShape3D::BoundsLevel &level = shape.bounds_levels[i];
+		const GodotHeightMapShape3D::BoundsLevel &expected_level = expected_shape.bounds_levels[i];
+		REQUIRE(level.ranges.size() == expected_level.ranges.size());
+		bool ranges_match = true;
+		for (uint32_t j = 0; j < level.ranges.size(); j++) {
+			ranges_match = ranges_match && level.ranges[j].min == expected_level.ranges[j].min && level.ranges[j].max == expected_level.ranges[j].max;
+		}
+		CHECK(ranges_match);
+	}
+
+	for (int i = 0; i < size * size; i++) {
+		if (heights[i] < aabb.position.y || heights[i] > aabb.position.y + aabb.size.y) {
+			FAIL("Height outside of the shape aabb.");
+		}
+	}
+
+	check_segments(shape, size);
+}
+
+} // namespace TestHeightMapShape3D
+
+#endif // TEST_HEIGHTMAP_SHAPE_3D_H
@@ -0,0 +1,141 @@
+/*************************************************************************/
+/*  test_navigation_3d.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_navigation_3d.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "scene/resources/navigation_mesh.h"
+#include "servers/navigation_server_3d.h"
+
+namespace TestNavigation3D {
+
+// Builds a square tile of unit quads, with some cells left out so the paths have to go around them.
+static Ref<NavigationMesh> create_tile_navmesh(int p_tile_x, int p_tile_z, int p_tile_size, RandomPCG &p_rng) {
+	const int row_size = p_tile_size + 1;
+
+	Vector<Vector3> vertices;
+	vertices.resize(row_size * row_size);
+	Vector3 *vertices_w = vertices.ptrw();
+	for (int z = 0; z < row_size; z++) {
+		for (int x = 0; x < row_size; x++) {
+			vertices_w[z * row_size + x] = Vector3(p_tile_x * p_tile_size + x, 0, p_tile_z * p_tile_size + z);
+		}
+	}
+
+	Ref<NavigationMesh> navmesh;
+	navmesh.instantiate();
+	navmesh->set_vertices(vertices);
+
+	for (int z = 0; z < p_tile_size; z++) {
+		for (int x = 0; x < p_tile_size; x++) {
+			// Keep the tile borders so all the tiles connect.
+			const bool border = x == 0 || z == 0 || x == p_tile_size - 1 || z == p_tile_size - 1;
+			if (!border && p_rng.randf() < 0.2) {
+				continue;
+			}
+
+			Vector<int> polygon;
+			polygon.push_back(z * row_size + x);
+			polygon.push_back((z + 1) * row_size + x);
+			polygon.push_back((z + 1) * row_size + x + 1);
+			polygon.push_back(z * row_size + x + 1);
+			navmesh->add_polygon(polygon);
+		}
+	}
+
+	return navmesh;
+}
+
+void benchmark() {
+	// Maps of about 10k, 100k and 1M polygons, made of 100x100 tiles.
+	const int tile_size = 100;
+	const int tile_counts[] = { 1, 3, 10 };
+	const int query_count = 100;
+
+	print_line("3D navigation path query benchmark.");
+
+	for (int tiles : tile_counts) {
+		NavigationServer3D *ns = NavigationServer3DManager::new_default_server();
+		ns->set_active(true);
+
+		RandomPCG rng(1234);
+
+		RID map = ns->map_create();
+		ns->map_set_active(map, true);
+		ns->map_set_cell_size(map, 0.25);
+
+		int polygon_count = 0;
+		Vector<RID> regions;
+		for (int tile_z = 0; tile_z < tiles; tile_z++) {
+			for (int tile_x = 0; tile_x < tiles; tile_x++) {
+				Ref<NavigationMesh> navmesh = create_tile_navmesh(tile_x, tile_z, tile_size, rng);
+				polygon_count += navmesh->get_polygon_count();
+
+				RID region = ns->region_create();
+				ns->region_set_map(region, map);
+				ns->region_set_navmesh(region, navmesh);
+				regions.push_back(region);
+			}
+		}
+
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		ns->process(1.0 / 60.0);
+		const uint64_t sync_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		const real_t map_size = tiles * tile_size;
+		uint64_t max_query_usec = 0;
+		int total_points = 0;
+
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < query_count; i++) {
+			const Vector3 from(rng.random(real_t(0.0), map_size), 0, rng.random(real_t(0.0), map_size));
+			const Vector3 to(rng.random(real_t(0.0), map_size), 0, rng.random(real_t(0.0), map_size));
+
+			const uint64_t query_begin_usec = OS::get_singleton()->get_ticks_usec();
+			total_points += ns->map_get_path(map, from, to, true).size();
+			max_query_usec = MAX(max_query_usec, OS::get_singleton()->get_ticks_usec() - query_begin_usec);
+		}
+		const uint64_t elapsed_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		print_line(vformat("%d polygons: sync %.1f ms, %.3f ms per path query (max %.3f ms), %.1f points per path.", polygon_count, sync_usec / 1000.0,
+				elapsed_usec / 1000.0 / query_count, max_query_usec / 1000.0, total_points / double(query_count)));
+
+		for (int i = 0; i < regions.size(); i++) {
+			ns->free(regions[i]);
+		}
+		ns->free(map);
+		ns->process(0.0);
+
+		memdelete(ns);
+	}
+}
+
+} // namespace TestNavigation3D
@@ -0,0 +1,127 @@
+/*************************************************************************/
+/*  test_occlusion_cull_raster.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_OCCLUSION_CULL_RASTER_H
+#define TEST_OCCLUSION_CULL_RASTER_H
+
+#include "core/templates/thread_work_pool.h"
+#include "servers/rendering/renderer_scene_occlusion_cull_raster.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOcclusionCullRaster {
+
+void add_quad(PackedVector3Array &r_vertices, PackedInt32Array &r_indices, const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c, const Vector3 &p_d) {
+	int from = r_vertices.size();
+	r_vertices.push_back(p_a);
+	r_vertices.push_back(p_b);
+	r_vertices.push_back(p_c);
+	r_vertices.push_back(p_d);
+
+	const int quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int i = 0; i < 6; i++) {
+		r_indices.push_back(from + quad_indices[i]);
+	}
+}
+
+bool is_box_occluded(const RendererSceneOcclusionCull::HZBuffer *p_buffer, const AABB &p_box, const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection) {
+	const Vector3 end = p_box.position + p_box.size;
+	const real_t bounds[6] = { p_box.position.x, p_box.position.y, p_box.position.z, end.x, end.y, end.z };
+	return p_buffer->is_occluded(bounds, p_cam_transform.origin, p_cam_transform.affine_inverse(), p_cam_projection, p_cam_projection.get_z_near());
+}
+
+TEST_CASE("[OcclusionCullRaster] Rasterized occluders hide the boxes behind them") {
+	ThreadWorkPool thread_pool;
+	thread_pool.init(4);
+
+	RendererSceneOcclusionCullRaster occlusion_cull;
+
+	RID scenario = RID::from_uint64(1);
+	RID instance = RID::from_uint64(2);
+	RID viewport = RID::from_uint64(3);
+
+	RID occluder = occlusion_cull.occluder_allocate();
+	occlusion_cull.occluder_initialize(occluder);
+	CHECK(occlusion_cull.is_occluder(occluder));
+
+	// A wall in front of the camera, and a floor that extends behind it so it has to be clipped.
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+	add_quad(vertices, indices, Vector3(-2, -2, -5), Vector3(2, -2, -5), Vector3(2, 2, -5), Vector3(-2, 2, -5));
+	add_quad(vertices, indices, Vector3(-50, -1, 50), Vector3(50, -1, 50), Vector3(50, -1, -50), Vector3(-50, -1, -50));
+	occlusion_cull.occluder_set_mesh(occluder, vertices, indices);
+
+	occlusion_cull.add_scenario(scenario);
+	occlusion_cull.scenario_set_instance(scenario, instance, occluder, Transform3D(), true);
+
+	occlusion_cull.add_buffer(viewport);
+	occlusion_cull.buffer_set_scenario(viewport, scenario);
+	occlusion_cull.buffer_set_size(viewport, Vector2i(64, 48));
+
+	Transform3D cam_transform;
+	CameraMatrix cam_projection;
+	cam_projection.set_perspective(60, 64.0 / 48.0, 0.1, 100);
+
+	occlusion_cull.buffer_update(viewport, cam_transform, cam_projection, false, thread_pool);
+	const RendererSceneOcclusionCull::HZBuffer *buffer = occlusion_cull.buffer_get_ptr(viewport);
+	REQUIRE(buffer);
+
+	CHECK_MESSAGE(is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -10.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Box behind the wall should be occluded.");
+	CHECK_MESSAGE(is_box_occluded(buffer, AABB(Vector3(5.5, -3.5, -10.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Box under the floor should be occluded.");
+	CHECK_MESSAGE(!is_box_occluded(buffer, AABB(Vector3(7.5, 0.5, -10.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Box beside the wall should be visible.");
+	CHECK_MESSAGE(!is_box_occluded(buffer, AABB(Vector3(-0.25, -0.25, -3.25), Vector3(0.5, 0.5, 0.5)), cam_transform, cam_projection), "Box in front of the wall should be visible.");
+
+	// Looking from behind, the occluders are double-sided.
+	cam_transform = Transform3D(Basis(Vector3(0, 1, 0), Math_PI), Vector3(0, 0, -15));
+	occlusion_cull.buffer_update(viewport, cam_transform, cam_projection, false, thread_pool);
+	CHECK_MESSAGE(is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Box behind the back of the wall should be occluded.");
+
+	cam_transform = Transform3D();
+	occlusion_cull.scenario_set_instance(scenario, instance, occluder, Transform3D(), false);
+	occlusion_cull.buffer_update(viewport, cam_transform, cam_projection, false, thread_pool);
+	CHECK_MESSAGE(!is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -10.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Disabled occluders should not hide anything.");
+
+	occlusion_cull.scenario_set_instance(scenario, instance, occluder, Transform3D(Basis(), Vector3(20, 0, 0)), true);
+	occlusion_cull.buffer_update(viewport, cam_transform, cam_projection, false, thread_pool);
+	CHECK_MESSAGE(!is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -10.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Moved occluders should not hide the box anymore.");
+	CHECK_MESSAGE(is_box_occluded(buffer, AABB(Vector3(5.5, -3.5, -10.5), Vector3(1, 1, 1)), cam_transform, cam_projection), "Moved floor should still hide the box under it.");
+
+	occlusion_cull.scenario_remove_instance(scenario, instance);
+	occlusion_cull.remove_buffer(viewport);
+	occlusion_cull.remove_scenario(scenario);
+	occlusion_cull.free_occluder(occluder);
+	CHECK(!occlusion_cull.is_occluder(occluder));
+
+	thread_pool.finish();
+}
+
+} // namespace TestOcclusionCullRaster
+
+#endif // TEST_OCCLUSION_CULL_RASTER_H
@@ -31,6 +31,7 @@
 #include "test_physics_2d.h"
 
 #include "core/os/main_loop.h"
+#include "core/os/os.h"
 #include "servers/physics_server_2d.h"
 #include "servers/rendering_server.h"
 
@@ -371,4 +372,159 @@ namespace TestPhysics2D {
 MainLoop *test() {
 	return memnew(TestPhysics2DMainLoop);
 }
+
+// Steps piles of boxes resting on the ground, each pile being a separate island,
+// and reports the average step time for increasing body counts.
+void benchmark() {
+	const int body_counts[] = { 1000, 5000, 10000, 30000 };
+	const int pile_height = 10;
+	const int settle_steps = 60;
+	const int measured_steps = 120;
+	const real_t step = 1.0 / 60.0;
+
+	print_line(vformat("2D physics step benchmark, %d processors.", OS::get_singleton()->get_processor_count()));
+
+	for (int body_count : body_counts) {
+		PhysicsServer2D *ps = PhysicsServer2DManager::new_default_server();
+		ps->init();
+
+		RID space = ps->space_create();
+		ps->space_set_active(space, true);
+		ps->set_active(true);
+		ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+		ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 980);
+
+		Array boundary_data;
+		boundary_data.push_back(Vector2(0, -1));
+		boundary_data.push_back(0.0);
+		RID world_boundary = ps->world_boundary_shape_create();
+		ps->shape_set_data(world_boundary, boundary_data);
+
+		RID ground = ps->body_create();
+		ps->body_set_mode(ground, PhysicsServer2D::BODY_MODE_STATIC);
+		ps->body_set_space(ground, space);
+		ps->body_add_shape(ground, world_boundary);
+
+		RID box = ps->rectangle_shape_create();
+		ps->shape_set_data(box, Vector2(8, 8));
+
+		Vector<RID> bodies;
+		for (int i = 0; i < body_count; i++) {
+			int pile = i / pile_height;
+			int level = i % pile_height;
+
+			RID body = ps->body_create();
+			ps->body_add_shape(body, box);
+			ps->body_set_space(body, space);
+			ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0.0, Vector2(pile * 32, -8 - level * 16)));
+			bodies.push_back(body);
+		}
+
+		for (int i = 0; i < settle_steps; i++) {
+			ps->step(step);
+		}
+
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < measured_steps; i++) {
+			ps->step(step);
+		}
+		uint64_t elapsed_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		print_line(vformat("%d bodies: %.3f ms per step, %d islands, %d collision pairs.", body_count, elapsed_usec / 1000.0 / measured_steps,
+				ps->get_process_info(PhysicsServer2D::INFO_ISLAND_COUNT), ps->get_process_info(PhysicsServer2D::INFO_COLLISION_PAIRS)));
+
+		for (int i = 0; i < bodies.size(); i++) {
+			ps->free(bodies[i]);
+		}
+		ps->free(ground);
+		ps->free(box);
+		ps->free(world_boundary);
+		ps->free(space);
+
+		ps->finish();
+		memdelete(ps);
+	}
+}
+
+void snapshot_benchmark() {
+	const int body_count = 300;
+	const int rollback_count = 10;
+	const int resimulated_steps = 8;
+	const real_t step = 1.0 / 60.0;
+
+	PhysicsServer2D *ps = PhysicsServer2DManager::new_default_server();
+	ps->init();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->set_active(true);
+	ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+	ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 980);
+
+	Array boundary_data;
+	boundary_data.push_back(Vector2(0, -1));
+	boundary_data.push_back(0.0);
+	RID world_boundary = ps->world_boundary_shape_create();
+	ps->shape_set_data(world_boundary, boundary_data);
+
+	RID ground = ps->body_create();
+	ps->body_set_mode(ground, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_set_space(ground, space);
+	ps->body_add_shape(ground, world_boundary);
+
+	RID box = ps->rectangle_shape_create();
+	ps->shape_set_data(box, Vector2(8, 8));
+
+	Vector<RID> bodies;
+	for (int i = 0; i < body_count; i++) {
+		RID body = ps->body_create();
+		ps->body_add_shape(body, box);
+		ps->body_set_space(body, space);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0.0, Vector2((i / 10) * 32, -8 - (i % 10) * 16)));
+		bodies.push_back(body);
+	}
+
+	for (int i = 0; i < 60; i++) {
+		ps->step(step);
+	}
+
+	uint64_t create_usec = 0;
+	uint64_t restore_usec = 0;
+	uint64_t step_usec = 0;
+	int snapshot_size = 0;
+
+	for (int i = 0; i < rollback_count; i++) {
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		Vector<uint8_t> snapshot = ps->space_create_snapshot(space);
+		create_usec += OS::get_singleton()->get_ticks_usec() - begin_usec;
+		snapshot_size = snapshot.size();
+
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int j = 0; j < resimulated_steps; j++) {
+			ps->step(step);
+		}
+		step_usec += OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+		ps->space_restore_snapshot(space, snapshot);
+		restore_usec += OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		ps->step(step);
+	}
+
+	print_line(vformat("2D space snapshot benchmark, %d bodies, %d collision pairs, %d bytes per snapshot.", body_count, ps->get_process_info(PhysicsServer2D::INFO_COLLISION_PAIRS), snapshot_size));
+	print_line(vformat("%d rollbacks: %.3f ms per snapshot, %.3f ms per restore, %.3f ms per resimulated step.", rollback_count,
+			create_usec / 1000.0 / rollback_count, restore_usec / 1000.0 / rollback_count, step_usec / 1000.0 / (rollback_count * resimulated_steps)));
+
+	for (int i = 0; i < bodies.size(); i++) {
+		ps->free(bodies[i]);
+	}
+	ps->free(ground);
+	ps->free(box);
+	ps->free(world_boundary);
+	ps->free(space);
+
+	ps->finish();
+	memdelete(ps);
+}
 } // namespace TestPhysics2D
@@ -36,6 +36,8 @@ class MainLoop;
 namespace TestPhysics2D {
 
 MainLoop *test();
-}
+void benchmark();
+void snapshot_benchmark();
+} // namespace TestPhysics2D
 
 #endif // TEST_PHYSICS_2D_H
@@ -31,7 +31,12 @@
 #include "test_render.h"
 
 #include "core/math/convex_hull.h"
+#include "core/math/random_pcg.h"
 #include "core/os/main_loop.h"
+#include "core/os/os.h"
+#include "servers/display_server.h"
+#include "servers/rendering/rendering_server_default.h"
+#include "servers/rendering/rendering_server_globals.h"
 #include "servers/rendering_server.h"
 
 #define OBJECT_COUNT 50
@@ -229,4 +234,167 @@ public:
 MainLoop *test() {
 	return memnew(TestMainLoop);
 }
+
+void benchmark() {
+	// Unit cubes scattered over a square, a bit more than one per 16 square meters.
+	const int instance_counts[] = { 10000, 100000, 500000 };
+	const int frame_count = 120;
+	const Size2 viewport_size(1920, 1080);
+
+	print_line(vformat("3D scene culling benchmark, %d processors.", OS::get_singleton()->get_processor_count()));
+
+	// The headless display server uses the dummy rasterizer, so only the culling is measured.
+	Error err = OK;
+	for (int i = 0; i < DisplayServer::get_create_function_count(); i++) {
+		if (String("headless") == DisplayServer::get_create_function_name(i)) {
+			DisplayServer::create(i, "", DisplayServer::WindowMode::WINDOW_MODE_MINIMIZED, DisplayServer::VSyncMode::VSYNC_ENABLED, 0, Vector2i(0, 0), err);
+			break;
+		}
+	}
+	ERR_FAIL_COND(!DisplayServer::get_singleton());
+
+	RenderingServerDefault *rs = memnew(RenderingServerDefault);
+	rs->init();
+	rs->set_render_loop_enabled(false);
+
+	RID mesh = rs->mesh_create();
+	rs->mesh_set_custom_aabb(mesh, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+
+	for (int instance_count : instance_counts) {
+		RandomPCG rng(1234);
+
+		RID scenario = rs->scenario_create();
+		const real_t extent = Math::sqrt(real_t(instance_count)) * 2.0;
+
+		Vector<RID> instances;
+		instances.resize(instance_count);
+		RID *instances_w = instances.ptrw();
+		for (int i = 0; i < instance_count; i++) {
+			instances_w[i] = rs->instance_create2(mesh, scenario);
+			rs->instance_set_transform(instances_w[i], Transform3D(Basis(), Vector3(rng.random(-extent, extent), rng.random(real_t(-5.0), real_t(5.0)), rng.random(-extent, extent))));
+		}
+
+		RID camera = rs->camera_create();
+		rs->camera_set_perspective(camera, 75, 0.05, 500);
+
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		RSG::scene->update();
+		const uint64_t update_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		Ref<XRInterface> xr_interface;
+		uint64_t max_frame_usec = 0;
+
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < frame_count; i++) {
+			// Turn around, so every frame sees a different part of the scenario.
+			rs->camera_set_transform(camera, Transform3D(Basis(Vector3(0, 1, 0), Math_TAU * i / frame_count), Vector3(0, 2, 0)));
+
+			const uint64_t frame_begin_usec = OS::get_singleton()->get_ticks_usec();
+			RSG::scene->render_camera(RID(), camera, scenario, RID(), viewport_size, 0.0, RID(), xr_interface);
+			max_frame_usec = MAX(max_frame_usec, OS::get_singleton()->get_ticks_usec() - frame_begin_usec);
+		}
+		const uint64_t elapsed_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		print_line(vformat("%d instances: first update %.1f ms, %.3f ms per frame (max %.3f ms).", instance_count, update_usec / 1000.0,
+				elapsed_usec / 1000.0 / frame_count, max_frame_usec / 1000.0));
+
+		for (int i = 0; i < instance_count; i++) {
+			rs->free(instances[i]);
+		}
+		rs->free(camera);
+		rs->free(scenario);
+		RSG::scene->update();
+	}
+
+	rs->free(mesh);
+
+	rs->sync();
+	rs->finish();
+	memdelete(rs);
+	memdelete(DisplayServer::get_singleton());
+}
+
+void canvas_benchmark() {
+	// Sprites moving around on a large map, either y-sorted or in a plain list.
+	const int item_counts[] = { 10000, 100000 };
+	const int frame_count = 120;
+	const Rect2 clip_rect(0, 0, 1920, 1080);
+
+	print_line(vformat("2D canvas culling benchmark, %d processors.", OS::get_singleton()->get_processor_count()));
+
+	// The headless display server uses the dummy rasterizer, so only the culling is measured.
+	Error err = OK;
+	for (int i = 0; i < DisplayServer::get_create_function_count(); i++) {
+		if (String("headless") == DisplayServer::get_create_function_name(i)) {
+			DisplayServer::create(i, "", DisplayServer::WindowMode::WINDOW_MODE_MINIMIZED, DisplayServer::VSyncMode::VSYNC_ENABLED, 0, Vector2i(0, 0), err);
+			break;
+		}
+	}
+	ERR_FAIL_COND(!DisplayServer::get_singleton());
+
+	RenderingServerDefault *rs = memnew(RenderingServerDefault);
+	rs->init();
+	rs->set_render_loop_enabled(false);
+
+	for (int item_count : item_counts) {
+		for (int y_sort = 0; y_sort < 2; y_sort++) {
+			RandomPCG rng(1234);
+
+			RID canvas = rs->canvas_create();
+			RID root = rs->canvas_item_create();
+			rs->canvas_item_set_parent(root, canvas);
+			rs->canvas_item_set_sort_children_by_y(root, y_sort);
+
+			// About a fifth of the map is on screen.
+			const Size2 map_size = clip_rect.size * 2.2;
+
+			Vector<RID> items;
+			Vector<Vector2> positions;
+			Vector<Vector2> velocities;
+			items.resize(item_count);
+			positions.resize(item_count);
+			velocities.resize(item_count);
+			for (int i = 0; i < item_count; i++) {
+				items.write[i] = rs->canvas_item_create();
+				rs->canvas_item_set_parent(items[i], root);
+				rs->canvas_item_add_rect(items[i], Rect2(-8, -16, 16, 16), Color(1, 1, 1));
+				positions.write[i] = Vector2(rng.random(real_t(0.0), map_size.x), rng.random(real_t(0.0), map_size.y));
+				velocities.write[i] = Vector2(rng.random(real_t(-1.0), real_t(1.0)), rng.random(real_t(-1.0), real_t(1.0)));
+			}
+
+			RendererCanvasCull::Canvas *canvas_ptr = RSG::canvas->canvas_owner.get_or_null(canvas);
+			uint64_t elapsed_usec = 0;
+			uint64_t max_frame_usec = 0;
+
+			for (int i = 0; i < frame_count; i++) {
+				for (int j = 0; j < item_count; j++) {
+					positions.write[j] += velocities[j];
+					rs->canvas_item_set_transform(items[j], Transform2D(0, positions[j]));
+				}
+
+				// Scroll, so every frame sees a different part of the map.
+				const Transform2D view(0, -Vector2(map_size.x - clip_rect.size.x, 0) * i / frame_count);
+
+				const uint64_t frame_begin_usec = OS::get_singleton()->get_ticks_usec();
+				RSG::canvas->render_canvas(RID(), canvas_ptr, view, nullptr, nullptr, clip_rect, RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false);
+				const uint64_t frame_usec = OS::get_singleton()->get_ticks_usec() - frame_begin_usec;
+				elapsed_usec += frame_usec;
+				max_frame_usec = MAX(max_frame_usec, frame_usec);
+			}
+
+			print_line(vformat("%d items%s: %.3f ms per frame (max %.3f ms).", item_count, y_sort ? " (y-sorted)" : "", elapsed_usec / 1000.0 / frame_count, max_frame_usec / 1000.0));
+
+			for (int i = 0; i < item_count; i++) {
+				rs->free(items[i]);
+			}
+			rs->free(root);
+			rs->free(canvas);
+		}
+	}
+
+	rs->sync();
+	rs->finish();
+	memdelete(rs);
+	memdelete(DisplayServer::get_singleton());
+}
 } // namespace TestRender
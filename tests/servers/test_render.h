@@ -36,6 +36,8 @@ class MainLoop;
 namespace TestRender {
 
 MainLoop *test();
-}
+void benchmark();
+void canvas_benchmark();
+} // namespace TestRender
 
 #endif // TEST_RENDER_H
@@ -0,0 +1,180 @@
+/*************************************************************************/
+/*  test_renderer_canvas_cull.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERER_CANVAS_CULL_H
+#define TEST_RENDERER_CANVAS_CULL_H
+
+#include "core/config/project_settings.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/map.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererCanvasCull {
+
+// Same tree in every instance: plain children with z indices and notifiers, and a y-sorted item with nested children.
+struct CanvasTree {
+	RendererCanvasCull *cull = nullptr;
+	RID canvas;
+	LocalVector<RID> items;
+
+	CanvasTree(uint32_t p_thread_cull_threshold) {
+		// The threshold is read when the culler is created.
+		const Variant previous_threshold = ProjectSettings::get_singleton()->get_setting("rendering/limits/canvas/threaded_cull_minimum_items");
+		ProjectSettings::get_singleton()->set_setting("rendering/limits/canvas/threaded_cull_minimum_items", p_thread_cull_threshold);
+		cull = memnew(RendererCanvasCull);
+		ProjectSettings::get_singleton()->set_setting("rendering/limits/canvas/threaded_cull_minimum_items", previous_threshold);
+
+		canvas = cull->canvas_allocate();
+		cull->canvas_initialize(canvas);
+
+		RandomPCG rng(42);
+		const RID plain_root = create_item(canvas);
+		const RID ysort_root = create_item(canvas);
+		cull->canvas_item_set_sort_children_by_y(ysort_root, true);
+
+		for (int i = 0; i < 3000; i++) {
+			const bool y_sorted = i % 2 == 1;
+			RID parent = y_sorted ? ysort_root : plain_root;
+			if (y_sorted && i % 10 == 1) {
+				// Nested items are sorted with the children of the y-sorted item.
+				parent = items[items.size() - 2];
+			}
+
+			const RID item = create_item(parent);
+			cull->canvas_item_add_rect(item, Rect2(-8, -16, 16, 16), Color(1, 1, 1));
+			cull->canvas_item_set_transform(item, Transform2D(0, Vector2(rng.random(-200.0f, 2200.0f), rng.random(-200.0f, 1300.0f))));
+			if (!y_sorted) {
+				cull->canvas_item_set_z_index(item, rng.random(-2, 2));
+			}
+			if (i % 7 == 0) {
+				cull->canvas_item_set_visibility_notifier(item, true, Rect2(-8, -16, 16, 16), Callable(), Callable());
+			}
+			if (i % 11 == 0) {
+				cull->canvas_item_set_update_when_visible(item, true);
+			}
+		}
+	}
+
+	RID create_item(RID p_parent) {
+		const RID item = cull->canvas_item_allocate();
+		cull->canvas_item_initialize(item);
+		cull->canvas_item_set_parent(item, p_parent);
+		items.push_back(item);
+		return item;
+	}
+
+	RendererCanvasCull::Item *get_item(uint32_t p_index) const {
+		return cull->canvas_item_owner.get_or_null(items[p_index]);
+	}
+
+	void move_items(int p_frame) {
+		for (uint32_t i = 0; i < items.size(); i++) {
+			RendererCanvasCull::Item *item = get_item(i);
+			const Vector2 offset = Vector2(Math::sin(float(i + p_frame)), Math::cos(float(i * 3 + p_frame))) * 40.0;
+			cull->canvas_item_set_transform(items[i], Transform2D(0, item->xform.get_origin() + offset));
+		}
+	}
+
+	void render(const Rect2 &p_clip_rect) {
+		for (uint32_t i = 0; i < items.size(); i++) {
+			get_item(i)->next = nullptr;
+			get_item(i)->z_final = RS::CANVAS_ITEM_Z_MIN - 1;
+		}
+		RendererCanvasCull::Canvas *canvas_ptr = cull->canvas_owner.get_or_null(canvas);
+		cull->render_canvas(RID(), canvas_ptr, Transform2D(), nullptr, nullptr, p_clip_rect, RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false);
+	}
+
+	// The culled items as "next item index, z" per item, the notifiers as "just visible, visible frame, in list".
+	Vector<String> get_state() const {
+		Map<const RendererCanvasRender::Item *, int> indices;
+		for (uint32_t i = 0; i < items.size(); i++) {
+			indices[get_item(i)] = i;
+		}
+
+		Vector<String> state;
+		for (uint32_t i = 0; i < items.size(); i++) {
+			const RendererCanvasCull::Item *item = get_item(i);
+			const int next = item->next ? indices[item->next] : -1;
+			String item_state = vformat("%d %d", next, item->z_final);
+			if (item->visibility_notifier) {
+				item_state += vformat(" %s %d %s", item->visibility_notifier->just_visible, item->visibility_notifier->visible_in_frame, item->visibility_notifier->visible_element.in_list());
+			}
+			state.push_back(item_state);
+		}
+		return state;
+	}
+
+	~CanvasTree() {
+		for (int i = items.size() - 1; i >= 0; i--) {
+			cull->free(items[i]);
+		}
+		cull->free(canvas);
+		memdelete(cull);
+	}
+};
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Threaded culling matches serial culling") {
+	CanvasTree serial(UINT32_MAX);
+	CanvasTree threaded(64);
+
+	const Rect2 clip_rect(0, 0, 1920, 1080);
+	int culled_items = 0;
+	for (int frame = 0; frame < 4; frame++) {
+		serial.move_items(frame);
+		threaded.move_items(frame);
+		serial.render(clip_rect);
+		threaded.render(clip_rect);
+
+		const Vector<String> serial_state = serial.get_state();
+		const Vector<String> threaded_state = threaded.get_state();
+		REQUIRE(serial_state.size() == threaded_state.size());
+		int mismatches = 0;
+		for (int i = 0; i < serial_state.size(); i++) {
+			if (serial_state[i] != threaded_state[i]) {
+				mismatches++;
+			}
+			if (!serial_state[i].begins_with("-1 " + itos(RS::CANVAS_ITEM_Z_MIN - 1))) {
+				culled_items++;
+			}
+		}
+		CHECK_MESSAGE(mismatches == 0, vformat("Frame %d.", frame));
+
+		// Clears `just_visible` and removes the notifiers that left the screen.
+		serial.cull->update_visibility_notifiers();
+		threaded.cull->update_visibility_notifiers();
+	}
+	CHECK(culled_items > 0);
+}
+
+} // namespace TestRendererCanvasCull
+
+#endif // TEST_RENDERER_CANVAS_CULL_H
@@ -0,0 +1,146 @@
+/*************************************************************************/
+/*  test_renderer_storage_rd.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERER_STORAGE_RD_H
+#define TEST_RENDERER_STORAGE_RD_H
+
+#include "servers/rendering/renderer_rd/renderer_storage_rd.h"
+#include "servers/rendering/rendering_device_recorder.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererStorageRD {
+
+const int MULTIMESH_INSTANCES = 4096;
+const int MULTIMESH_STRIDE = 12; // 3D transforms, no colors or custom data.
+const uint32_t MULTIMESH_REGION_BYTES = 512 * MULTIMESH_STRIDE * sizeof(float); // Dirty regions are 512 instances.
+
+Vector<float> make_instances(int p_count, float p_value) {
+	Vector<float> buffer;
+	buffer.resize(p_count * MULTIMESH_STRIDE);
+	buffer.fill(p_value);
+	return buffer;
+}
+
+// Ends the frame and returns the sizes of the buffer updates recorded since p_from.
+LocalVector<uint64_t> end_frame(RenderingDeviceRecorder &p_rd, uint32_t p_from) {
+	p_rd.swap_buffers();
+
+	LocalVector<uint64_t> sizes;
+	const LocalVector<RenderingDeviceRecorder::Command> &trace = p_rd.get_trace();
+	for (uint32_t i = p_from; i < trace.size(); i++) {
+		if (trace[i].type == RenderingDeviceRecorder::COMMAND_BUFFER_UPDATE) {
+			sizes.push_back(trace[i].args[1]);
+		}
+	}
+	return sizes;
+}
+
+TEST_CASE("[SceneTree][RendererStorageRD] Multimesh buffer range updates") {
+	RenderingDeviceRecorder rd;
+	rd.initialize(Size2i());
+	rd.set_keep_trace(true);
+	RendererStorageRD *storage = memnew(RendererStorageRD);
+
+	RID multimesh = storage->multimesh_allocate();
+	storage->multimesh_initialize(multimesh);
+	storage->multimesh_allocate_data(multimesh, MULTIMESH_INSTANCES, RS::MULTIMESH_TRANSFORM_3D);
+	RID mesh = storage->mesh_allocate();
+	storage->mesh_initialize(mesh);
+	storage->multimesh_set_mesh(multimesh, mesh);
+
+	SUBCASE("Ranges of a local copy upload the coalesced dirty regions") {
+		// Setting an instance keeps a copy of the data on the CPU from now on.
+		storage->multimesh_instance_set_transform(multimesh, 0, Transform3D());
+		storage->update_dirty_resources();
+		end_frame(rd, 0);
+		uint32_t from = rd.get_trace().size();
+
+		// Touches regions 1 to 3, then region 5.
+		storage->multimesh_set_buffer_range(multimesh, 600, 1000, make_instances(1000, 1.0));
+		storage->multimesh_set_buffer_range(multimesh, 3000, 10, make_instances(10, 2.0));
+		storage->update_dirty_resources();
+
+		LocalVector<uint64_t> sizes = end_frame(rd, from);
+		REQUIRE(sizes.size() == 2);
+		CHECK(sizes[0] == 3 * MULTIMESH_REGION_BYTES);
+		CHECK(sizes[1] == MULTIMESH_REGION_BYTES);
+
+		Vector<float> buffer = storage->multimesh_get_buffer(multimesh);
+		CHECK(buffer[599 * MULTIMESH_STRIDE] == 0.0);
+		CHECK(buffer[600 * MULTIMESH_STRIDE] == 1.0);
+		CHECK(buffer[3009 * MULTIMESH_STRIDE] == 2.0);
+		CHECK(buffer[3010 * MULTIMESH_STRIDE] == 0.0);
+	}
+
+	SUBCASE("Ranges of data that only lives on the GPU are uploaded directly") {
+		storage->multimesh_set_buffer(multimesh, make_instances(MULTIMESH_INSTANCES, 0.0));
+		end_frame(rd, 0);
+		uint32_t from = rd.get_trace().size();
+
+		storage->multimesh_set_buffer_range(multimesh, 100, 10, make_instances(10, 1.0));
+		storage->update_dirty_resources();
+
+		LocalVector<uint64_t> sizes = end_frame(rd, from);
+		REQUIRE(sizes.size() == 1);
+		CHECK(sizes[0] == 10 * MULTIMESH_STRIDE * sizeof(float));
+
+		Vector<float> buffer = storage->multimesh_get_buffer(multimesh);
+		CHECK(buffer[99 * MULTIMESH_STRIDE] == 0.0);
+		CHECK(buffer[100 * MULTIMESH_STRIDE] == 1.0);
+		CHECK(buffer[110 * MULTIMESH_STRIDE] == 0.0);
+	}
+
+	SUBCASE("Ranges past the last instance are rejected") {
+		storage->multimesh_instance_set_transform(multimesh, 0, Transform3D());
+		storage->update_dirty_resources();
+		end_frame(rd, 0);
+		uint32_t from = rd.get_trace().size();
+
+		ERR_PRINT_OFF;
+		storage->multimesh_set_buffer_range(multimesh, MULTIMESH_INSTANCES - 5, 10, make_instances(10, 1.0));
+		// The end of the range doesn't fit in an int.
+		storage->multimesh_set_buffer_range(multimesh, INT32_MAX, 1, make_instances(1, 1.0));
+		ERR_PRINT_ON;
+		storage->update_dirty_resources();
+
+		CHECK(end_frame(rd, from).is_empty());
+		CHECK(storage->multimesh_get_buffer(multimesh)[(MULTIMESH_INSTANCES - 1) * MULTIMESH_STRIDE] == 0.0);
+	}
+
+	storage->free(multimesh);
+	storage->free(mesh);
+	memdelete(storage);
+	rd.finalize();
+}
+
+} // namespace TestRendererStorageRD
+
+#endif // TEST_RENDERER_STORAGE_RD_H
@@ -0,0 +1,297 @@
+/*************************************************************************/
+/*  test_rendering_device_recorder.h                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERING_DEVICE_RECORDER_H
+#define TEST_RENDERING_DEVICE_RECORDER_H
+
+#include "servers/rendering/rendering_device_recorder.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingDeviceRecorder {
+
+const char *vertex_shader_code = R"(
+#version 450
+
+layout(location = 0) in vec3 vertex_attrib;
+layout(location = 3) in vec4 color_attrib;
+
+layout(location = 0) out vec4 color_interp;
+
+void main() {
+	color_interp = color_attrib;
+	gl_Position = vec4(vertex_attrib, 1.0);
+}
+)";
+
+const char *fragment_shader_code = R"(
+#version 450
+
+layout(location = 0) in vec4 color_interp;
+layout(location = 0) out vec4 frag_color;
+
+void main() {
+	frag_color = color_interp;
+}
+)";
+
+struct Resources {
+	RID texture;
+	RID framebuffer;
+	RID shader;
+	RID pipeline;
+	RID uniform_buffer;
+	RID uniform_set;
+	RID vertex_buffer;
+	RID vertex_array;
+	RID index_buffer;
+	RID index_array;
+};
+
+Resources create_resources(RenderingDeviceRecorder &p_rd) {
+	Resources resources;
+
+	RD::TextureFormat tf;
+	tf.width = 64;
+	tf.height = 64;
+	tf.format = RD::DATA_FORMAT_R8G8B8A8_UNORM;
+	tf.usage_bits = RD::TEXTURE_USAGE_COLOR_ATTACHMENT_BIT | RD::TEXTURE_USAGE_SAMPLING_BIT;
+	resources.texture = p_rd.texture_create(tf, RD::TextureView());
+
+	Vector<RID> attachments;
+	attachments.push_back(resources.texture);
+	resources.framebuffer = p_rd.framebuffer_create(attachments);
+
+	Vector<RD::ShaderStageSPIRVData> stages;
+	stages.resize(2);
+	stages.write[0].shader_stage = RD::SHADER_STAGE_VERTEX;
+	stages.write[0].spir_v = p_rd.shader_compile_spirv_from_source(RD::SHADER_STAGE_VERTEX, vertex_shader_code);
+	stages.write[1].shader_stage = RD::SHADER_STAGE_FRAGMENT;
+	stages.write[1].spir_v = p_rd.shader_compile_spirv_from_source(RD::SHADER_STAGE_FRAGMENT, fragment_shader_code);
+	resources.shader = p_rd.shader_create_from_spirv(stages);
+
+	Vector<RD::VertexAttribute> attributes;
+	attributes.resize(1);
+	attributes.write[0].format = RD::DATA_FORMAT_R32G32B32_SFLOAT;
+	attributes.write[0].stride = 12;
+	RD::VertexFormatID vertex_format = p_rd.vertex_format_create(attributes);
+
+	resources.pipeline = p_rd.render_pipeline_create(resources.shader, p_rd.framebuffer_get_format(resources.framebuffer), vertex_format, RD::RENDER_PRIMITIVE_TRIANGLES, RD::PipelineRasterizationState(), RD::PipelineMultisampleState(), RD::PipelineDepthStencilState(), RD::PipelineColorBlendState::create_disabled(), 0);
+
+	resources.uniform_buffer = p_rd.uniform_buffer_create(64);
+	Vector<RD::Uniform> uniforms;
+	RD::Uniform u;
+	u.uniform_type = RD::UNIFORM_TYPE_UNIFORM_BUFFER;
+	u.binding = 0;
+	u.ids.push_back(resources.uniform_buffer);
+	uniforms.push_back(u);
+	resources.uniform_set = p_rd.uniform_set_create(uniforms, resources.shader, 0);
+
+	resources.vertex_buffer = p_rd.vertex_buffer_create(12 * 4);
+	Vector<RID> buffers;
+	buffers.push_back(resources.vertex_buffer);
+	resources.vertex_array = p_rd.vertex_array_create(4, vertex_format, buffers);
+
+	resources.index_buffer = p_rd.index_buffer_create(6, RD::INDEX_BUFFER_FORMAT_UINT16);
+	resources.index_array = p_rd.index_array_create(resources.index_buffer, 0, 6);
+
+	return resources;
+}
+
+// Everything else depends on these, so it is freed with them.
+void free_resources(RenderingDeviceRecorder &p_rd, const Resources &p_resources) {
+	p_rd.free(p_resources.texture);
+	p_rd.free(p_resources.shader);
+	p_rd.free(p_resources.uniform_buffer);
+	p_rd.free(p_resources.vertex_buffer);
+	p_rd.free(p_resources.index_buffer);
+}
+
+void draw_quad(RenderingDeviceRecorder &p_rd, RD::DrawListID p_list, const Resources &p_resources, uint32_t p_instances) {
+	const uint32_t push_constant[4] = { 1, 2, 3, 4 };
+	p_rd.draw_list_bind_render_pipeline(p_list, p_resources.pipeline);
+	p_rd.draw_list_bind_uniform_set(p_list, p_resources.uniform_set, 0);
+	p_rd.draw_list_bind_vertex_array(p_list, p_resources.vertex_array);
+	p_rd.draw_list_bind_index_array(p_list, p_resources.index_array);
+	p_rd.draw_list_set_push_constant(p_list, push_constant, sizeof(push_constant));
+	p_rd.draw_list_draw(p_list, true, p_instances);
+}
+
+TEST_CASE("[RenderingDeviceRecorder] Shaders are reflected from their source") {
+	RenderingDeviceRecorder rd;
+	rd.initialize(Size2i());
+	Resources resources = create_resources(rd);
+
+	REQUIRE(resources.shader.is_valid());
+	CHECK_MESSAGE(rd.shader_get_vertex_input_attribute_mask(resources.shader) == ((1 << 0) | (1 << 3)),
+			"Only the vertex inputs should be in the mask, not the outputs.");
+	CHECK(rd.render_pipeline_is_valid(resources.pipeline));
+	CHECK(rd.uniform_set_is_valid(resources.uniform_set));
+
+	free_resources(rd, resources);
+	rd.finalize();
+}
+
+TEST_CASE("[RenderingDeviceRecorder] Draw lists count draws and redundant state changes") {
+	RenderingDeviceRecorder rd;
+	rd.initialize(Size2i());
+	Resources resources = create_resources(rd);
+
+	RD::DrawListID list = rd.draw_list_begin(resources.framebuffer, RD::INITIAL_ACTION_CLEAR, RD::FINAL_ACTION_READ, RD::INITIAL_ACTION_CLEAR, RD::FINAL_ACTION_DISCARD);
+	draw_quad(rd, list, resources, 1);
+	// Everything is bound already, so all but the draw is redundant.
+	draw_quad(rd, list, resources, 3);
+	rd.draw_list_end();
+	rd.swap_buffers();
+
+	const RenderingDeviceRecorder::Stats &stats = rd.get_stats();
+	CHECK(stats.frames == 1);
+	CHECK(stats.draw_lists == 1);
+	CHECK(stats.draws == 2);
+	CHECK(stats.instances == 4);
+	CHECK(stats.elements == 6 * 4);
+	CHECK(stats.pipeline_binds == 2);
+	CHECK(stats.redundant_pipeline_binds == 1);
+	CHECK(stats.uniform_set_binds == 2);
+	CHECK(stats.redundant_uniform_set_binds == 1);
+	CHECK(stats.array_binds == 4);
+	CHECK(stats.redundant_array_binds == 2);
+	CHECK(stats.push_constants == 2);
+	CHECK(stats.redundant_push_constants == 1);
+
+	free_resources(rd, resources);
+	rd.finalize();
+}
+
+TEST_CASE("[RenderingDeviceRecorder] Redundant and mergeable barriers") {
+	RenderingDeviceRecorder rd;
+	rd.initialize(Size2i());
+	Resources resources = create_resources(rd);
+
+	const uint8_t data[16] = {};
+	rd.buffer_update(resources.uniform_buffer, 0, 16, data);
+	// Nothing was written since the barrier of the update.
+	rd.barrier();
+	// These two updates could have shared a single barrier.
+	rd.buffer_update(resources.uniform_buffer, 16, 16, data);
+	rd.buffer_update(resources.uniform_buffer, 32, 16, data);
+	// No barrier requested, so it's up to the next one.
+	rd.buffer_update(resources.uniform_buffer, 48, 16, data, RD::BARRIER_MASK_NO_BARRIER);
+	rd.full_barrier();
+	rd.swap_buffers();
+
+	const RenderingDeviceRecorder::Stats &stats = rd.get_stats();
+	CHECK(stats.buffer_updates == 4);
+	CHECK(stats.buffer_update_bytes == 64);
+	CHECK(stats.barriers == 5);
+	CHECK(stats.redundant_barriers == 1);
+	CHECK(stats.mergeable_barriers == 1);
+
+	free_resources(rd, resources);
+	rd.finalize();
+}
+
+TEST_CASE("[RenderingDeviceRecorder] Split draw lists are replayed in order") {
+	RenderingDeviceRecorder rd;
+	rd.initialize(Size2i());
+	rd.set_keep_trace(true);
+	Resources resources = create_resources(rd);
+
+	RD::DrawListID splits[3];
+	REQUIRE(rd.draw_list_begin_split(resources.framebuffer, 3, splits, RD::INITIAL_ACTION_CLEAR, RD::FINAL_ACTION_READ, RD::INITIAL_ACTION_CLEAR, RD::FINAL_ACTION_DISCARD) == OK);
+	// Recorded out of order, like worker threads would.
+	for (int i = 2; i >= 0; i--) {
+		draw_quad(rd, splits[i], resources, i + 1);
+	}
+	rd.draw_list_end();
+	rd.swap_buffers();
+
+	const RenderingDeviceRecorder::Stats &stats = rd.get_stats();
+	CHECK(stats.split_draw_lists == 3);
+	CHECK(stats.draws == 3);
+	CHECK_MESSAGE(stats.redundant_pipeline_binds == 0, "Every split starts with no state bound.");
+
+	const LocalVector<RenderingDeviceRecorder::Command> &trace = rd.get_trace();
+	uint32_t split = 0;
+	for (uint32_t i = 0; i < trace.size(); i++) {
+		const RenderingDeviceRecorder::Command &command = trace[i];
+		if (command.type == RenderingDeviceRecorder::COMMAND_DRAW_LIST_SPLIT) {
+			split = command.args[0];
+		} else if (command.type == RenderingDeviceRecorder::COMMAND_DRAW_LIST_DRAW) {
+			CHECK(command.args[1] == split + 1);
+		}
+	}
+
+	// Replaying the kept trace gives the same results as the live stats.
+	RenderingDeviceRecorder::Stats replayed;
+	RenderingDeviceRecorder::replay_trace(rd.get_trace(), replayed);
+	CHECK(replayed.draws == stats.draws);
+	CHECK(replayed.split_draw_lists == stats.split_draw_lists);
+	CHECK(replayed.frames == 1);
+
+	free_resources(rd, resources);
+	rd.finalize();
+}
+
+int invalidated_count = 0;
+
+void uniform_set_invalidated(void *p_userdata) {
+	invalidated_count++;
+}
+
+TEST_CASE("[RenderingDeviceRecorder] Freeing a resource frees what depends on it") {
+	RenderingDeviceRecorder rd;
+	rd.initialize(Size2i());
+	Resources resources = create_resources(rd);
+
+	invalidated_count = 0;
+	rd.uniform_set_set_invalidation_callback(resources.uniform_set, uniform_set_invalidated, nullptr);
+	rd.free(resources.uniform_buffer);
+	CHECK_FALSE(rd.uniform_set_is_valid(resources.uniform_set));
+	CHECK(invalidated_count == 1);
+
+	rd.free(resources.texture);
+	CHECK_FALSE(rd.texture_is_valid(resources.texture));
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(rd.framebuffer_get_format(resources.framebuffer) == RD::INVALID_ID, "The framebuffer should be freed with its attachment.");
+	ERR_PRINT_ON;
+
+	rd.free(resources.shader);
+	CHECK_FALSE(rd.render_pipeline_is_valid(resources.pipeline));
+
+	rd.free(resources.vertex_buffer);
+	rd.free(resources.index_buffer);
+
+	rd.finalize();
+}
+
+} // namespace TestRenderingDeviceRecorder
+
+#endif // TEST_RENDERING_DEVICE_RECORDER_H
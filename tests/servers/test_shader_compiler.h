@@ -0,0 +1,272 @@
+/*************************************************************************/
+/*  test_shader_compiler.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SHADER_COMPILER_H
+#define TEST_SHADER_COMPILER_H
+
+#include "core/io/dir_access.h"
+#include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
+#include "servers/rendering/shader_compiler.h"
+
+#include "tests/test_macros.h"
+
+namespace TestShaderCompiler {
+
+struct CompileResult {
+	Error error = FAILED;
+	ShaderCompiler::GeneratedCode gen_code;
+	Map<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+	int blend_mode = 0;
+	bool uses_time = false;
+	bool uses_screen_texture = false;
+};
+
+String make_canvas_item_code(int p_index) {
+	String code = "shader_type canvas_item;\n";
+	if (p_index % 3 == 1) {
+		code += "render_mode blend_add;\n";
+	}
+	code += "uniform float amount : hint_range(0.0, 1.0) = 0.5;\n";
+	code += "uniform vec4 tint : hint_color = vec4(1.0, 0.5, 0.25, 1.0);\n";
+	code += "uniform sampler2D mask : hint_white;\n";
+	code += "float wave(float p_x) {\n\treturn sin(p_x * " + itos(p_index + 1) + ".0);\n}\n";
+	code += "void fragment() {\n";
+	code += "\tCOLOR = texture(TEXTURE, UV) * tint * texture(mask, UV).r;\n";
+	if (p_index % 2 == 0) {
+		code += "\tCOLOR.a *= wave(TIME) * amount;\n";
+	} else {
+		code += "\tCOLOR.rgb = mix(COLOR.rgb, texture(SCREEN_TEXTURE, SCREEN_UV).rgb, amount);\n";
+	}
+	code += "}\n";
+	return code;
+}
+
+void compile_canvas_item(const ShaderCompiler &p_compiler, const String &p_code, CompileResult &r_result) {
+	ShaderCompiler::IdentifierActions actions;
+	actions.entry_point_stages["vertex"] = ShaderCompiler::STAGE_VERTEX;
+	actions.entry_point_stages["fragment"] = ShaderCompiler::STAGE_FRAGMENT;
+	actions.entry_point_stages["light"] = ShaderCompiler::STAGE_FRAGMENT;
+	actions.render_mode_values["blend_add"] = Pair<int *, int>(&r_result.blend_mode, 1);
+	actions.render_mode_values["blend_mix"] = Pair<int *, int>(&r_result.blend_mode, 0);
+	actions.usage_flag_pointers["TIME"] = &r_result.uses_time;
+	actions.usage_flag_pointers["SCREEN_TEXTURE"] = &r_result.uses_screen_texture;
+	actions.uniforms = &r_result.uniforms;
+
+	r_result.error = p_compiler.compile(RS::SHADER_CANVAS_ITEM, p_code, &actions, "res://test.gdshader", r_result.gen_code);
+}
+
+void initialize_compiler(ShaderCompiler &r_compiler) {
+	ShaderCompiler::DefaultIdentifierActions actions;
+	actions.renames["COLOR"] = "color";
+	actions.renames["UV"] = "uv";
+	actions.renames["TIME"] = "canvas_data.time";
+	actions.renames["TEXTURE"] = "color_texture";
+	actions.renames["SCREEN_TEXTURE"] = "screen_texture";
+	actions.renames["SCREEN_UV"] = "screen_uv";
+	actions.usage_defines["COLOR"] = "#define COLOR_USED\n";
+	actions.usage_defines["SCREEN_TEXTURE"] = "#define SCREEN_TEXTURE_USED\n";
+	actions.custom_samplers["TEXTURE"] = "texture_sampler";
+	actions.custom_samplers["SCREEN_TEXTURE"] = "material_samplers[3]";
+	actions.sampler_array_name = "material_samplers";
+	actions.base_texture_binding_index = 1;
+	actions.texture_layout_set = 1;
+	actions.base_uniform_string = "material.";
+	actions.default_filter = ShaderLanguage::FILTER_LINEAR;
+	actions.default_repeat = ShaderLanguage::REPEAT_DISABLE;
+	actions.base_varying_index = 4;
+	r_compiler.initialize(actions);
+}
+
+bool results_match(const CompileResult &p_a, const CompileResult &p_b) {
+	if (p_a.error != p_b.error || p_a.blend_mode != p_b.blend_mode || p_a.uses_time != p_b.uses_time || p_a.uses_screen_texture != p_b.uses_screen_texture) {
+		return false;
+	}
+
+	const ShaderCompiler::GeneratedCode &a = p_a.gen_code;
+	const ShaderCompiler::GeneratedCode &b = p_b.gen_code;
+	if (a.defines != b.defines || a.uniforms != b.uniforms || a.uniform_offsets != b.uniform_offsets || a.uniform_total_size != b.uniform_total_size) {
+		return false;
+	}
+	if (a.uses_global_textures != b.uses_global_textures || a.uses_fragment_time != b.uses_fragment_time || a.uses_vertex_time != b.uses_vertex_time) {
+		return false;
+	}
+	for (int i = 0; i < ShaderCompiler::STAGE_MAX; i++) {
+		if (a.stage_globals[i] != b.stage_globals[i]) {
+			return false;
+		}
+	}
+	if (a.code.size() != b.code.size()) {
+		return false;
+	}
+	for (const KeyValue<String, String> &E : a.code) {
+		if (!b.code.has(E.key) || b.code[E.key] != E.value) {
+			return false;
+		}
+	}
+	if (a.texture_uniforms.size() != b.texture_uniforms.size()) {
+		return false;
+	}
+	for (int i = 0; i < a.texture_uniforms.size(); i++) {
+		if (a.texture_uniforms[i].name != b.texture_uniforms[i].name || a.texture_uniforms[i].hint != b.texture_uniforms[i].hint || a.texture_uniforms[i].filter != b.texture_uniforms[i].filter) {
+			return false;
+		}
+	}
+
+	if (p_a.uniforms.size() != p_b.uniforms.size()) {
+		return false;
+	}
+	for (const KeyValue<StringName, ShaderLanguage::ShaderNode::Uniform> &E : p_a.uniforms) {
+		if (!p_b.uniforms.has(E.key)) {
+			return false;
+		}
+		const ShaderLanguage::ShaderNode::Uniform &u = p_b.uniforms[E.key];
+		if (u.order != E.value.order || u.texture_order != E.value.texture_order || u.type != E.value.type || u.hint != E.value.hint || u.default_value.size() != E.value.default_value.size()) {
+			return false;
+		}
+		for (int i = 0; i < u.default_value.size(); i++) {
+			if (u.default_value[i].uint != E.value.default_value[i].uint) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+struct ParallelCompile {
+	const ShaderCompiler *compiler = nullptr;
+	Vector<String> codes;
+	Vector<CompileResult> results;
+
+	void compile(uint32_t p_index, void *p_userdata) {
+		compile_canvas_item(*compiler, codes[p_index], results.write[p_index]);
+	}
+};
+
+TEST_CASE("[SceneTree][ShaderCompiler] Compiling on several threads gives the same code as compiling serially") {
+	ShaderCompiler compiler;
+	initialize_compiler(compiler);
+
+	const int shader_count = 24;
+	ParallelCompile parallel;
+	parallel.compiler = &compiler;
+	Vector<CompileResult> serial_results;
+	serial_results.resize(shader_count);
+	for (int i = 0; i < shader_count; i++) {
+		parallel.codes.push_back(make_canvas_item_code(i));
+		compile_canvas_item(compiler, parallel.codes[i], serial_results.write[i]);
+		REQUIRE(serial_results[i].error == OK);
+	}
+	CHECK(serial_results[0].uses_time);
+	CHECK(!serial_results[0].uses_screen_texture);
+	CHECK(serial_results[1].uses_screen_texture);
+	CHECK(serial_results[1].blend_mode == 1);
+	CHECK(serial_results[0].uniforms.size() == 3);
+
+	parallel.results.resize(shader_count);
+	ThreadWorkPool thread_pool;
+	thread_pool.init(4);
+	thread_pool.do_work(shader_count, &parallel, &ParallelCompile::compile, nullptr);
+	thread_pool.finish();
+
+	for (int i = 0; i < shader_count; i++) {
+		CHECK_MESSAGE(results_match(serial_results[i], parallel.results[i]), vformat("Shader %d should compile to the same code on a worker thread.", i).utf8().ptr());
+	}
+}
+
+int count_files(const String &p_dir, const String &p_extension) {
+	DirAccessRef da = DirAccess::open(p_dir);
+	if (!da) {
+		return 0;
+	}
+
+	int count = 0;
+	da->list_dir_begin();
+	for (String name = da->get_next(); !name.is_empty(); name = da->get_next()) {
+		if (name == "." || name == "..") {
+			continue;
+		}
+		if (da->current_is_dir()) {
+			count += count_files(p_dir.plus_file(name), p_extension);
+		} else if (name.get_extension() == p_extension) {
+			count++;
+		}
+	}
+	da->list_dir_end();
+	return count;
+}
+
+TEST_CASE("[SceneTree][ShaderCompiler] Generated code cache") {
+	const String cache_dir = OS::get_singleton()->get_cache_path().plus_file("shader_compiler_cache_test");
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->change_dir(cache_dir) == OK) {
+		da->erase_contents_recursive();
+	} else {
+		REQUIRE(da->make_dir_recursive(cache_dir) == OK);
+	}
+
+	Vector<CompileResult> uncached_results;
+	{
+		ShaderCompiler compiler;
+		initialize_compiler(compiler);
+		for (int i = 0; i < 3; i++) {
+			CompileResult result;
+			compile_canvas_item(compiler, make_canvas_item_code(i), result);
+			REQUIRE(result.error == OK);
+			uncached_results.push_back(result);
+		}
+	}
+
+	ShaderCompiler::set_shader_cache_dir(cache_dir);
+	ShaderCompiler compiler;
+	initialize_compiler(compiler);
+
+	for (int pass = 0; pass < 2; pass++) {
+		// The first pass parses and fills the cache, the second one loads from it.
+		for (int i = 0; i < 3; i++) {
+			CompileResult result;
+			compile_canvas_item(compiler, make_canvas_item_code(i), result);
+			CHECK_MESSAGE(results_match(uncached_results[i], result), vformat("Shader %d should give the same result in pass %d.", i, pass).utf8().ptr());
+		}
+
+		CHECK_MESSAGE(count_files(cache_dir, "cache") == 3, "Each shader should have its own cache file.");
+		CHECK_MESSAGE(count_files(cache_dir, "tmp") == 0, "Cache files should be moved in place once written.");
+	}
+
+	ShaderCompiler::set_shader_cache_dir(String());
+	REQUIRE(da->change_dir(cache_dir) == OK);
+	da->erase_contents_recursive();
+	da->change_dir("..");
+	da->remove(cache_dir);
+}
+
+} // namespace TestShaderCompiler
+
+#endif // TEST_SHADER_COMPILER_H
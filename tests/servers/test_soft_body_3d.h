@@ -0,0 +1,143 @@
+/*************************************************************************/
+/*  test_soft_body_3d.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SOFT_BODY_3D_H
+#define TEST_SOFT_BODY_3D_H
+
+#include "core/templates/thread_work_pool.h"
+#include "servers/physics_3d/godot_soft_body_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSoftBody3D {
+
+// Flat cloth, two triangles per cell.
+void create_cloth(GodotSoftBody3D &r_body, int p_size) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Vector<int> indices;
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			const int a = z * (p_size + 1) + x;
+			const int b = a + 1;
+			const int c = a + p_size + 1;
+			const int d = c + 1;
+			indices.push_back(a);
+			indices.push_back(b);
+			indices.push_back(c);
+			indices.push_back(b);
+			indices.push_back(d);
+			indices.push_back(c);
+		}
+	}
+
+	REQUIRE(r_body.create_from_trimesh(indices, vertices));
+}
+
+// Pushes the nodes around so the link solve has work to do.
+void disturb(GodotSoftBody3D &r_body) {
+	for (uint32_t i = 0; i < r_body.get_node_count(); i++) {
+		r_body.apply_node_impulse(i, Vector3(Math::sin(i * 0.7), Math::cos(i * 1.3), Math::sin(i * 0.1)) * 0.01);
+	}
+}
+
+TEST_CASE("[SoftBody3D] Links in a batch share no node") {
+	GodotSoftBody3D body;
+	create_cloth(body, 48);
+
+	const LocalVector<uint32_t> &batches = body.get_link_batches();
+	REQUIRE(batches.size() >= 2);
+	CHECK(batches[0] == 0);
+	CHECK(batches[batches.size() - 1] == body.get_link_count());
+
+	// The last batch may hold links that couldn't be colored, those are solved serially.
+	const uint32_t colored_batch_count = batches.size() - 1 - (body.has_serial_link_batch() ? 1 : 0);
+
+	LocalVector<uint32_t> node_batches;
+	node_batches.resize(body.get_node_count());
+	for (uint32_t i = 0; i < node_batches.size(); i++) {
+		node_batches[i] = UINT32_MAX;
+	}
+
+	bool shared = false;
+	for (uint32_t batch = 0; batch < colored_batch_count; batch++) {
+		CHECK(batches[batch] < batches[batch + 1]);
+		for (uint32_t i = batches[batch]; i < batches[batch + 1]; i++) {
+			uint32_t node_1, node_2;
+			body.get_link_nodes(i, node_1, node_2);
+			shared = shared || node_batches[node_1] == batch || node_batches[node_2] == batch;
+			node_batches[node_1] = batch;
+			node_batches[node_2] = batch;
+		}
+	}
+	CHECK_FALSE(shared);
+}
+
+TEST_CASE("[SoftBody3D] Solving constraints on a work pool matches the serial solve") {
+	GodotSoftBody3D serial_body;
+	GodotSoftBody3D threaded_body;
+	// Large enough for the node passes and the first link batches to be split across the pool.
+	create_cloth(serial_body, 48);
+	create_cloth(threaded_body, 48);
+	disturb(serial_body);
+	disturb(threaded_body);
+
+	LocalVector<Vector3> start_positions;
+	for (uint32_t i = 0; i < serial_body.get_node_count(); i++) {
+		start_positions.push_back(serial_body.get_node_position(i));
+	}
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	for (int step = 0; step < 4; step++) {
+		serial_body.solve_constraints(1.0 / 60.0);
+		threaded_body.solve_constraints(1.0 / 60.0, &work_pool);
+	}
+	work_pool.finish();
+
+	bool moved = false;
+	bool matches = true;
+	for (uint32_t i = 0; i < serial_body.get_node_count(); i++) {
+		moved = moved || serial_body.get_node_position(i) != start_positions[i];
+		// Links of a batch are independent, so the order they are solved in doesn't change the result.
+		matches = matches && serial_body.get_node_position(i) == threaded_body.get_node_position(i);
+	}
+	CHECK(moved);
+	CHECK(matches);
+}
+
+} // namespace TestSoftBody3D
+
+#endif // TEST_SOFT_BODY_3D_H
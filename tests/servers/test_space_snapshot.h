@@ -0,0 +1,281 @@
+/*************************************************************************/
+/*  test_space_snapshot.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SPACE_SNAPSHOT_H
+#define TEST_SPACE_SNAPSHOT_H
+
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSpaceSnapshot {
+
+const int body_count = 300;
+const int rollback_count = 10;
+const int settle_steps = 10;
+const int replay_steps = 6;
+const int max_contacts = 4;
+const real_t step = 1.0 / 60.0;
+
+struct BodyState2D {
+	Transform2D transform;
+	Vector2 linear_velocity;
+	real_t angular_velocity = 0.0;
+	bool sleeping = false;
+	Vector<Vector2> contacts;
+
+	bool operator==(const BodyState2D &p_other) const {
+		return transform == p_other.transform && linear_velocity == p_other.linear_velocity && angular_velocity == p_other.angular_velocity && sleeping == p_other.sleeping && contacts == p_other.contacts;
+	}
+};
+
+struct BodyState3D {
+	Transform3D transform;
+	Vector3 linear_velocity;
+	Vector3 angular_velocity;
+	bool sleeping = false;
+	Vector<Vector3> contacts;
+
+	bool operator==(const BodyState3D &p_other) const {
+		return transform == p_other.transform && linear_velocity == p_other.linear_velocity && angular_velocity == p_other.angular_velocity && sleeping == p_other.sleeping && contacts == p_other.contacts;
+	}
+};
+
+void get_body_states(PhysicsServer2D *p_server, const Vector<RID> &p_bodies, Vector<BodyState2D> &r_states) {
+	for (int i = 0; i < p_bodies.size(); i++) {
+		PhysicsDirectBodyState2D *direct_state = p_server->body_get_direct_state(p_bodies[i]);
+		BodyState2D state;
+		state.transform = direct_state->get_transform();
+		state.linear_velocity = direct_state->get_linear_velocity();
+		state.angular_velocity = direct_state->get_angular_velocity();
+		state.sleeping = direct_state->is_sleeping();
+		for (int j = 0; j < direct_state->get_contact_count(); j++) {
+			state.contacts.push_back(direct_state->get_contact_local_position(j));
+		}
+		r_states.push_back(state);
+	}
+}
+
+void get_body_states(PhysicsServer3D *p_server, const Vector<RID> &p_bodies, Vector<BodyState3D> &r_states) {
+	for (int i = 0; i < p_bodies.size(); i++) {
+		PhysicsDirectBodyState3D *direct_state = p_server->body_get_direct_state(p_bodies[i]);
+		BodyState3D state;
+		state.transform = direct_state->get_transform();
+		state.linear_velocity = direct_state->get_linear_velocity();
+		state.angular_velocity = direct_state->get_angular_velocity();
+		state.sleeping = direct_state->is_sleeping();
+		for (int j = 0; j < direct_state->get_contact_count(); j++) {
+			state.contacts.push_back(direct_state->get_contact_local_position(j));
+		}
+		r_states.push_back(state);
+	}
+}
+
+// Steps the space from the snapshot, then restores it and steps again, comparing every body with the first run frame by frame.
+template <class T, class S>
+int count_replay_mismatches(T *p_server, RID p_space, const Vector<RID> &p_bodies, const Vector<uint8_t> &p_snapshot) {
+	Vector<S> reference;
+	for (int i = 0; i < replay_steps; i++) {
+		p_server->step(step);
+		get_body_states(p_server, p_bodies, reference);
+	}
+
+	p_server->space_restore_snapshot(p_space, p_snapshot);
+
+	int mismatches = 0;
+	for (int i = 0; i < replay_steps; i++) {
+		p_server->step(step);
+		Vector<S> states;
+		get_body_states(p_server, p_bodies, states);
+		for (int j = 0; j < p_bodies.size(); j++) {
+			if (!(states[j] == reference[i * p_bodies.size() + j])) {
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+TEST_CASE("[PhysicsServer2D] Space snapshot rollback") {
+	PhysicsServer2D *ps = PhysicsServer2DManager::new_default_server();
+	ps->init();
+	ps->set_active(true);
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+	ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 980);
+
+	Array boundary_data;
+	boundary_data.push_back(Vector2(0, -1));
+	boundary_data.push_back(0.0);
+	RID world_boundary = ps->world_boundary_shape_create();
+	ps->shape_set_data(world_boundary, boundary_data);
+
+	RID ground = ps->body_create();
+	ps->body_set_mode(ground, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_set_space(ground, space);
+	ps->body_add_shape(ground, world_boundary);
+
+	RID box = ps->rectangle_shape_create();
+	ps->shape_set_data(box, Vector2(8, 8));
+
+	// Staggered piles, so bodies keep colliding and the contact caches are not empty.
+	Vector<RID> bodies;
+	for (int i = 0; i < body_count; i++) {
+		RID body = ps->body_create();
+		ps->body_add_shape(body, box);
+		ps->body_set_space(body, space);
+		ps->body_set_max_contacts_reported(body, max_contacts);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0.1 * i, Vector2((i / 10) * 24 + (i % 2) * 6, -8 - (i % 10) * 17)));
+		bodies.push_back(body);
+	}
+
+	for (int i = 0; i < settle_steps; i++) {
+		ps->step(step);
+	}
+
+	// Each rollback starts where the previous replay ended.
+	for (int rollback = 0; rollback < rollback_count; rollback++) {
+		Vector<uint8_t> snapshot = ps->space_create_snapshot(space);
+		REQUIRE(snapshot.size() > 0);
+		// Padding isn't serialized, so the same state always gives the same bytes.
+		CHECK(ps->space_create_snapshot(space) == snapshot);
+
+		int mismatches = count_replay_mismatches<PhysicsServer2D, BodyState2D>(ps, space, bodies, snapshot);
+		CHECK(mismatches == 0);
+	}
+
+	for (int i = 0; i < bodies.size(); i++) {
+		ps->free(bodies[i]);
+	}
+	ps->free(ground);
+	ps->free(box);
+	ps->free(world_boundary);
+	ps->free(space);
+
+	ps->finish();
+	memdelete(ps);
+}
+
+TEST_CASE("[PhysicsServer3D] Space snapshot rollback") {
+	PhysicsServer3D *ps = PhysicsServer3DManager::new_default_server();
+	ps->init();
+	ps->set_active(true);
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->area_set_param(space, PhysicsServer3D::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+	ps->area_set_param(space, PhysicsServer3D::AREA_PARAM_GRAVITY, 9.8);
+
+	RID world_boundary = ps->world_boundary_shape_create();
+	ps->shape_set_data(world_boundary, Plane(Vector3(0, 1, 0), 0));
+
+	RID ground = ps->body_create();
+	ps->body_set_mode(ground, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_set_space(ground, space);
+	ps->body_add_shape(ground, world_boundary);
+
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+
+	Vector<RID> bodies;
+	for (int i = 0; i < body_count; i++) {
+		RID body = ps->body_create();
+		ps->body_add_shape(body, box);
+		ps->body_set_space(body, space);
+		ps->body_set_max_contacts_reported(body, max_contacts);
+		Vector3 origin((i / 10) % 6 * 1.5 + (i % 2) * 0.3, 0.5 + (i % 10) * 1.1, (i / 60) * 1.5);
+		ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(Vector3(0, 1, 0), 0.1 * i), origin));
+		bodies.push_back(body);
+	}
+
+	for (int i = 0; i < settle_steps; i++) {
+		ps->step(step);
+	}
+
+	for (int rollback = 0; rollback < rollback_count; rollback++) {
+		Vector<uint8_t> snapshot = ps->space_create_snapshot(space);
+		REQUIRE(snapshot.size() > 0);
+		CHECK(ps->space_create_snapshot(space) == snapshot);
+
+		int mismatches = count_replay_mismatches<PhysicsServer3D, BodyState3D>(ps, space, bodies, snapshot);
+		CHECK(mismatches == 0);
+	}
+
+	for (int i = 0; i < bodies.size(); i++) {
+		ps->free(bodies[i]);
+	}
+	ps->free(ground);
+	ps->free(box);
+	ps->free(world_boundary);
+	ps->free(space);
+
+	ps->finish();
+	memdelete(ps);
+}
+
+TEST_CASE("[PhysicsServer2D] Truncated space snapshots are rejected") {
+	PhysicsServer2D *ps = PhysicsServer2DManager::new_default_server();
+	ps->init();
+
+	RID space = ps->space_create();
+	RID box = ps->rectangle_shape_create();
+	ps->shape_set_data(box, Vector2(8, 8));
+	RID body = ps->body_create();
+	ps->body_add_shape(body, box);
+	ps->body_set_space(body, space);
+	ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0.0, Vector2(1, 2)));
+
+	Vector<uint8_t> snapshot = ps->space_create_snapshot(space);
+	ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0.0, Vector2(3, 4)));
+
+	ERR_PRINT_OFF;
+	Vector<uint8_t> truncated = snapshot;
+	truncated.resize(snapshot.size() - 1);
+	ps->space_restore_snapshot(space, truncated);
+	ERR_PRINT_ON;
+
+	CHECK(Transform2D(ps->body_get_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM)).get_origin() == Vector2(3, 4));
+
+	ps->space_restore_snapshot(space, snapshot);
+	CHECK(Transform2D(ps->body_get_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM)).get_origin() == Vector2(1, 2));
+
+	ps->free(body);
+	ps->free(box);
+	ps->free(space);
+
+	ps->finish();
+	memdelete(ps);
+}
+} // namespace TestSpaceSnapshot
+
+#endif // TEST_SPACE_SNAPSHOT_H
@@ -42,6 +42,7 @@
 #include "tests/core/math/test_astar.h"
 #include "tests/core/math/test_basis.h"
 #include "tests/core/math/test_color.h"
+#include "tests/core/math/test_dynamic_bvh.h"
 #include "tests/core/math/test_expression.h"
 #include "tests/core/math/test_geometry_2d.h"
 #include "tests/core/math/test_geometry_3d.h"
@@ -66,6 +67,7 @@
 #include "tests/core/templates/test_oa_hash_map.h"
 #include "tests/core/templates/test_ordered_hash_map.h"
 #include "tests/core/templates/test_paged_array.h"
+#include "tests/core/templates/test_radix_sort.h"
 #include "tests/core/templates/test_vector.h"
 #include "tests/core/test_crypto.h"
 #include "tests/core/test_hashing_context.h"
@@ -78,11 +80,25 @@
 #include "tests/scene/test_curve.h"
 #include "tests/scene/test_gradient.h"
 #include "tests/scene/test_gui.h"
+#include "tests/scene/test_hlod_group_3d.h"
+#include "tests/scene/test_importer_mesh.h"
 #include "tests/scene/test_path_3d.h"
+#include "tests/servers/test_body_3d.h"
+#include "tests/servers/test_collision_solver_3d.h"
+#include "tests/servers/test_concave_polygon_shape_3d.h"
+#include "tests/servers/test_heightmap_shape_3d.h"
+#include "tests/servers/test_navigation_3d.h"
+#include "tests/servers/test_occlusion_cull_raster.h"
 #include "tests/servers/test_physics_2d.h"
 #include "tests/servers/test_physics_3d.h"
 #include "tests/servers/test_render.h"
+#include "tests/servers/test_renderer_canvas_cull.h"
+#include "tests/servers/test_renderer_storage_rd.h"
+#include "tests/servers/test_rendering_device_recorder.h"
+#include "tests/servers/test_shader_compiler.h"
 #include "tests/servers/test_shader_lang.h"
+#include "tests/servers/test_soft_body_3d.h"
+#include "tests/servers/test_space_snapshot.h"
 #include "tests/servers/test_text_server.h"
 #include "tests/test_validate_testing.h"
 
@@ -97,6 +113,12 @@
 #include "servers/physics_server_3d.h"
 #include "servers/rendering/rendering_server_default.h"
 
+REGISTER_TEST_COMMAND("navigation-3d-benchmark", &TestNavigation3D::benchmark);
+REGISTER_TEST_COMMAND("physics-2d-benchmark", &TestPhysics2D::benchmark);
+REGISTER_TEST_COMMAND("physics-2d-snapshot-benchmark", &TestPhysics2D::snapshot_benchmark);
+REGISTER_TEST_COMMAND("render-canvas-benchmark", &TestRender::canvas_benchmark);
+REGISTER_TEST_COMMAND("render-cull-benchmark", &TestRender::benchmark);
+
 int test_main(int argc, char *argv[]) {
 	bool run_tests = true;
 